@@ -28,6 +28,9 @@ namespace ManasPDF.Internal
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Unicode)]
         internal static extern IntPtr Pdf_OpenDocument(string path);
 
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl, CharSet = CharSet.Unicode)]
+        internal static extern IntPtr Pdf_OpenDocumentMapped(string path);
+
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
         internal static extern void Pdf_CloseDocument(IntPtr doc);
 
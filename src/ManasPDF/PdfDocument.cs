@@ -46,6 +46,26 @@ namespace ManasPDF
             return new PdfDocument(handle);
         }
 
+        /// <summary>
+        /// Opens a PDF document by memory-mapping the file instead of copying it.
+        /// Lower memory use for large documents; the file must not be modified
+        /// while the document is open.
+        /// </summary>
+        /// <param name="path">Full path to the PDF file.</param>
+        /// <returns>A new PdfDocument instance.</returns>
+        /// <exception cref="PdfException">Thrown when the file cannot be opened.</exception>
+        public static PdfDocument OpenMapped(string path)
+        {
+            if (string.IsNullOrEmpty(path))
+                throw new ArgumentException("Path cannot be null or empty.", nameof(path));
+
+            IntPtr handle = NativeApi.Pdf_OpenDocumentMapped(path);
+            if (handle == IntPtr.Zero)
+                throw new PdfException($"Failed to open PDF: {path}");
+
+            return new PdfDocument(handle);
+        }
+
         /// <summary>
         /// Gets the native library version.
         /// </summary>
@@ -17,6 +17,46 @@ namespace pdf
     // Solution: Font program hash ile cache, ayn font iin ayn FT_Face kullan
     // ============================================
 
+    // ============================================
+    // FREETYPE LOCKS
+    //
+    // FT_Library: face creation and destruction must not run concurrently.
+    // FT_Face: size, transform and charmap are per-face state and glyph
+    // loads go through the face's single glyph slot, so a face shared
+    // through FontCache is used by one text run at a time. Faces hash onto
+    // a fixed set of recursive mutexes: different fonts render in
+    // parallel, and a run may take a second face (fallback) safely.
+    // ============================================
+    inline std::mutex& freeTypeLibraryMutex()
+    {
+        static std::mutex m;
+        return m;
+    }
+
+    inline std::recursive_mutex& freeTypeFaceMutex(FT_Face face)
+    {
+        static std::recursive_mutex stripes[64];
+        return stripes[(reinterpret_cast<uintptr_t>(face) >> 6) % 64];
+    }
+
+    inline FT_Error ftNewMemoryFace(FT_Library lib, const uint8_t* data, FT_Long size, FT_Face* face)
+    {
+        std::lock_guard<std::mutex> lock(freeTypeLibraryMutex());
+        return FT_New_Memory_Face(lib, data, size, 0, face);
+    }
+
+    inline FT_Error ftNewFace(FT_Library lib, const char* path, FT_Face* face)
+    {
+        std::lock_guard<std::mutex> lock(freeTypeLibraryMutex());
+        return FT_New_Face(lib, path, 0, face);
+    }
+
+    inline void ftDoneFace(FT_Face face)
+    {
+        std::lock_guard<std::mutex> lock(freeTypeLibraryMutex());
+        FT_Done_Face(face);
+    }
+
     // Hash font program data
     inline size_t hashFontProgram(const std::vector<uint8_t>& data)
     {
@@ -34,6 +74,9 @@ namespace pdf
         return h;
     }
 
+    // Shared by the cache and every PdfFontInfo (parser fonts, display
+    // lists) that uses the face: eviction only drops the cache's
+    // reference, the face is freed when the last user lets go
     struct CachedFont
     {
         FT_Face face = nullptr;
@@ -44,7 +87,7 @@ namespace pdf
         {
             if (face)
             {
-                FT_Done_Face(face);
+                ftDoneFace(face);
                 face = nullptr;
             }
         }
@@ -59,61 +102,62 @@ namespace pdf
             return inst;
         }
 
-        // Get or create FT_Face for font program
-        FT_Face getOrCreate(FT_Library ftLib, const std::vector<uint8_t>& fontProgram)
+        // Get or create the face for font program. Creation runs under the
+        // cache lock so two threads never build (and then drop) the same face.
+        // Callers keep the returned reference as long as they use ->face.
+        std::shared_ptr<CachedFont> getOrCreate(FT_Library ftLib, const std::vector<uint8_t>& fontProgram)
         {
             if (fontProgram.empty() || !ftLib)
                 return nullptr;
 
             size_t hash = hashFontProgram(fontProgram);
 
+            std::lock_guard<std::mutex> lock(_mutex);
+
             // Check cache
+            auto it = _cache.find(hash);
+            if (it != _cache.end())
             {
-                std::lock_guard<std::mutex> lock(_mutex);
-                auto it = _cache.find(hash);
-                if (it != _cache.end())
-                {
-                    ++_hits;
-                    return it->second->face;
-                }
+                ++_hits;
+                return it->second;
             }
 
             // Cache miss - create new FT_Face
             ++_misses;
 
-            auto cached = std::make_unique<CachedFont>();
+            auto cached = std::make_shared<CachedFont>();
             cached->fontData = fontProgram;  // Copy to keep alive
             cached->hash = hash;
 
-            FT_Error err = FT_New_Memory_Face(
+            FT_Error err = ftNewMemoryFace(
                 ftLib,
                 cached->fontData.data(),
                 (FT_Long)cached->fontData.size(),
-                0,
                 &cached->face
             );
 
             if (err != 0 || !cached->face)
                 return nullptr;
 
-            FT_Face face = cached->face;
-
-            // Add to cache
+            // Evict if too large: a face nobody else holds first; one still
+            // in use stays alive through its other owners
+            if (_cache.size() >= MAX_CACHE_SIZE)
             {
-                std::lock_guard<std::mutex> lock(_mutex);
-
-                // Evict if too large
-                if (_cache.size() >= MAX_CACHE_SIZE)
+                auto victim = _cache.begin();
+                for (auto jt = _cache.begin(); jt != _cache.end(); ++jt)
                 {
-                    auto it = _cache.begin();
-                    if (it != _cache.end())
-                        _cache.erase(it);
+                    if (jt->second.use_count() == 1)
+                    {
+                        victim = jt;
+                        break;
+                    }
                 }
-
-                _cache[hash] = std::move(cached);
+                if (victim != _cache.end())
+                    _cache.erase(victim);
             }
 
-            return face;
+            _cache[hash] = cached;
+            return cached;
         }
 
         // Get font hash for use in GlyphCache
@@ -140,7 +184,7 @@ namespace pdf
         FontCache(const FontCache&) = delete;
         FontCache& operator=(const FontCache&) = delete;
 
-        std::unordered_map<size_t, std::unique_ptr<CachedFont>> _cache;
+        std::unordered_map<size_t, std::shared_ptr<CachedFont>> _cache;
         std::mutex _mutex;
         size_t _hits = 0;
         size_t _misses = 0;
@@ -6,7 +6,7 @@
 
 namespace pdf
 {
-    const CachedGlyph* GlyphCache::getOrRender(FT_Face face, size_t fontHash, FT_UInt glyphId, int pixelSize)
+    std::shared_ptr<const CachedGlyph> GlyphCache::getOrRender(FT_Face face, size_t fontHash, FT_UInt glyphId, int pixelSize)
     {
         if (!face || glyphId == 0 || pixelSize <= 0)
             return nullptr;
@@ -29,12 +29,12 @@ namespace pdf
             if (it != _cache.end())
             {
                 ++_hits;
-                return &it->second;
+                return it->second;
             }
-        }
 
-        // Cache miss - render the glyph
-        ++_misses;
+            // Cache miss - render the glyph
+            ++_misses;
+        }
 
         // Render at higher resolution for better anti-aliasing at small sizes
         int renderSize = std::max(effectivePixelSize, MIN_QUALITY_SIZE);
@@ -64,7 +64,8 @@ namespace pdf
             return nullptr;
 
         // Create cached glyph
-        CachedGlyph cached;
+        auto glyph = std::make_shared<CachedGlyph>();
+        CachedGlyph& cached = *glyph;
 
         if (needsDownsample && bm.buffer && bm.rows > 0 && bm.width > 0)
         {
@@ -214,17 +215,18 @@ namespace pdf
                 size_t toRemove = std::max(size_t(1), _cache.size() / 4);
                 for (size_t i = 0; i < toRemove && it != _cache.end(); ++i)
                 {
-                    _totalMemory -= (it->second.bitmap.size() + sizeof(CachedGlyph));
+                    _totalMemory -= (it->second->bitmap.size() + sizeof(CachedGlyph));
                     it = _cache.erase(it);
                 }
             }
 
-            auto [insertIt, inserted] = _cache.emplace(key, std::move(cached));
+            // Another thread may have rendered the same glyph meanwhile
+            auto [insertIt, inserted] = _cache.emplace(key, std::move(glyph));
             if (inserted)
             {
                 _totalMemory += glyphMemory;
             }
-            return &insertIt->second;
+            return insertIt->second;
         }
     }
 
@@ -1,6 +1,7 @@
 #pragma once
 #include <cstdint>
 #include <vector>
+#include <memory>
 #include <unordered_map>
 #include <mutex>
 #include <ft2build.h>
@@ -62,10 +63,13 @@ namespace pdf
 
         // Get cached glyph or render and cache it
         // fontHash: hash of font program (from FontCache::getFontHash)
-        const CachedGlyph* getOrRender(FT_Face face, size_t fontHash, FT_UInt glyphId, int pixelSize);
+        // A miss renders through the face, so the caller must hold
+        // freeTypeFaceMutex(face). The returned glyph stays valid after
+        // eviction by another thread.
+        std::shared_ptr<const CachedGlyph> getOrRender(FT_Face face, size_t fontHash, FT_UInt glyphId, int pixelSize);
 
         // Legacy API (computes hash from face pointer - less effective)
-        const CachedGlyph* getOrRender(FT_Face face, FT_UInt glyphId, int pixelSize)
+        std::shared_ptr<const CachedGlyph> getOrRender(FT_Face face, FT_UInt glyphId, int pixelSize)
         {
             // Fallback: use face pointer as hash (not ideal)
             return getOrRender(face, reinterpret_cast<size_t>(face), glyphId, pixelSize);
@@ -83,7 +87,7 @@ namespace pdf
         GlyphCache(const GlyphCache&) = delete;
         GlyphCache& operator=(const GlyphCache&) = delete;
 
-        std::unordered_map<GlyphCacheKey, CachedGlyph, GlyphCacheKeyHash> _cache;
+        std::unordered_map<GlyphCacheKey, std::shared_ptr<const CachedGlyph>, GlyphCacheKeyHash> _cache;
         std::mutex _mutex;
 
         size_t _totalMemory = 0;  // Track total memory usage
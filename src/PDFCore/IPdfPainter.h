@@ -4,6 +4,7 @@
 // =====================================================
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
 #include "PdfPath.h"
@@ -26,6 +27,10 @@ namespace pdf
         virtual double scaleX() const = 0;
         virtual double scaleY() const = 0;
 
+        // Device rows of the whole page; a band painter holds height()
+        // of them (see PdfPainter::setBandOrigin)
+        virtual int pageHeight() const { return height(); }
+
         // Basic
         virtual void clear(uint32_t bgraColor) = 0;
 
@@ -94,6 +99,25 @@ namespace pdf
             int clipMaxX, int clipMaxY,
             float alpha = 1.0f) = 0;
 
+        // Rect clip given in page space (points). Resolves to device pixels
+        // at draw time, so recorded calls replay correctly at another zoom.
+        virtual void drawImageWithPageClipRect(
+            const std::vector<uint8_t>& argb,
+            int imgW, int imgH,
+            const PdfMatrix& ctm,
+            double clipMinX, double clipMinY,
+            double clipMaxX, double clipMaxY,
+            float alpha = 1.0f)
+        {
+            // Page Y grows upwards, device Y downwards
+            double minX = clipMinX * scaleX();
+            double maxX = clipMaxX * scaleX();
+            double minY = (double)height() - clipMaxY * scaleY();
+            double maxY = (double)height() - clipMinY * scaleY();
+            drawImageWithClipRect(argb, imgW, imgH, ctm,
+                (int)minX, (int)minY, (int)maxX, (int)maxY, alpha);
+        }
+
         virtual void drawImageClipped(
             const std::vector<uint8_t>& argb,
             int imgW, int imgH,
@@ -105,6 +129,11 @@ namespace pdf
             double rectMaxX = 0, double rectMaxY = 0,
             float alpha = 1.0f) = 0;
 
+        // Announces the buffer the next drawImage* call receives. Painters
+        // that keep images past the call (display list recording) hold
+        // this reference instead of copying the pixels.
+        virtual void shareImage(const std::shared_ptr<const std::vector<uint8_t>>& argb) {}
+
         // State
         virtual void setPageRotation(int degrees, double pageWPt, double pageHPt) = 0;
 
@@ -133,18 +162,38 @@ namespace pdf
 
         // ==================== SOFT MASK (SMask) ====================
         // Push a luminosity-based soft mask. The mask buffer is a grayscale alpha map
-        // (0=fully transparent, 255=fully opaque) at the render target's resolution.
-        virtual void pushSoftMask(const std::vector<uint8_t>& maskAlpha, int maskW, int maskH) {
+        // (0=fully transparent, 255=fully opaque) of maskW x maskH device pixels
+        // placed at (maskX, maskY), rows counted from the top of the page.
+        // Outside that rect the mask is 0: nothing drawn there shows.
+        // Masks nest; each pop removes the innermost one.
+        virtual void pushSoftMask(const std::vector<uint8_t>& maskAlpha,
+            int maskX, int maskY, int maskW, int maskH) {
             _smaskWasRequested = true;
         }
         virtual void popSoftMask() {}
 
+        // ==================== TRANSPARENCY GROUP ====================
+        // Form XObject with /Group /S /Transparency painted at ca < 1 or
+        // with a blend mode: what is drawn until endTransparencyGroup goes
+        // to an offscreen layer bounded by the page-space rect, which is
+        // then composited as one object at opacity alpha with the blend
+        // mode current at begin. Groups and soft masks nest.
+        virtual void beginTransparencyGroup(double minX, double minY, double maxX, double maxY, float alpha) {}
+        virtual void endTransparencyGroup() {}
+
+        // ==================== BLEND MODE ====================
+        // ExtGState /BM for the draws that follow. The parser calls it
+        // only when the graphics state's mode differs from blendMode().
+        virtual void setBlendMode(PdfBlendMode mode) { _blendMode = mode; }
+        PdfBlendMode blendMode() const { return _blendMode; }
+
         // SMask kullanılıp kullanılmadığını takip eder.
         // CPU painter SMask desteklemez → tile rendering sonrası bu flag kontrol edilir.
         bool smaskWasRequested() const { return _smaskWasRequested; }
 
     protected:
         bool _smaskWasRequested = false;
+        PdfBlendMode _blendMode = PdfBlendMode::Normal;
     };
 
 } // namespace pdf
\ No newline at end of file
@@ -1713,8 +1713,8 @@ namespace pdf
     // Main JBIG2 Decoder
     // =====================================================
     bool Jbig2Decoder::decode(
-        const std::vector<uint8_t>& data,
-        const std::vector<uint8_t>& globals,
+        PdfByteView data,
+        PdfByteView globals,
         std::vector<uint8_t>& output,
         int& outW, int& outH)
     {
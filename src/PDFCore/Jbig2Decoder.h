@@ -2,6 +2,7 @@
 #include <vector>
 #include <cstdint>
 #include <memory>
+#include "PdfBytes.h"
 
 namespace pdf
 {
@@ -27,8 +28,8 @@ namespace pdf
         // globals: optional JBIG2Globals stream
         // Returns packed 1-bit bitmap (MSB first), sets outW/outH
         static bool decode(
-            const std::vector<uint8_t>& data,
-            const std::vector<uint8_t>& globals,
+            PdfByteView data,
+            PdfByteView globals,
             std::vector<uint8_t>& output,
             int& outW, int& outH);
     };
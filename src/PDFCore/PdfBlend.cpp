@@ -0,0 +1,566 @@
+// =====================================================
+// PdfBlend.cpp - Blend mode compositors
+// =====================================================
+
+#include "pch.h"
+#include "PdfBlend.h"
+#include "PdfPlatform.h"
+#include "PdfSpan.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// SSE2 kernels, AVX2 when the CPU has it (x86/x64 only)
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PDF_BLEND_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define PDF_SSE2_TARGET
+#define PDF_AVX2_TARGET
+#else
+#define PDF_SSE2_TARGET __attribute__((target("sse2")))
+#define PDF_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#else
+#define PDF_BLEND_SIMD 0
+#endif
+
+namespace pdf
+{
+    // =====================================================
+    // Names
+    // =====================================================
+    static const struct { const char* name; PdfBlendMode mode; } kBlendNames[] = {
+        { "Normal", PdfBlendMode::Normal },
+        { "Multiply", PdfBlendMode::Multiply },
+        { "Screen", PdfBlendMode::Screen },
+        { "Overlay", PdfBlendMode::Overlay },
+        { "Darken", PdfBlendMode::Darken },
+        { "Lighten", PdfBlendMode::Lighten },
+        { "ColorDodge", PdfBlendMode::ColorDodge },
+        { "ColorBurn", PdfBlendMode::ColorBurn },
+        { "HardLight", PdfBlendMode::HardLight },
+        { "SoftLight", PdfBlendMode::SoftLight },
+        { "Difference", PdfBlendMode::Difference },
+        { "Exclusion", PdfBlendMode::Exclusion },
+        { "Hue", PdfBlendMode::Hue },
+        { "Saturation", PdfBlendMode::Saturation },
+        { "Color", PdfBlendMode::Color },
+        { "Luminosity", PdfBlendMode::Luminosity },
+        { "Compatible", PdfBlendMode::Normal },     // PDF 1.3, same as Normal
+    };
+
+    bool blendModeFromName(std::string_view name, PdfBlendMode& mode)
+    {
+        if (!name.empty() && name[0] == '/')
+            name.remove_prefix(1);
+        for (const auto& n : kBlendNames)
+        {
+            if (name == n.name)
+            {
+                mode = n.mode;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char* blendModeName(PdfBlendMode mode)
+    {
+        for (const auto& n : kBlendNames)
+            if (n.mode == mode)
+                return n.name;
+        return "Normal";
+    }
+
+    // =====================================================
+    // Integer blend terms
+    // Written once for int and for the SIMD lane types below, so every
+    // path gives the same bytes. Inputs are premultiplied 0..255;
+    // intermediate values stay within int16.
+    // =====================================================
+
+    // round(a * b / 255) for a, b in [0, 255]
+    static inline int mul255(int a, int b)
+    {
+        const int t = a * b + 128;
+        return (t + (t >> 8)) >> 8;
+    }
+
+    static inline int konst(int, int k) { return k; }
+    static inline int vmin(int a, int b) { return a < b ? a : b; }
+    static inline int vmax(int a, int b) { return a > b ? a : b; }
+    static inline int lessEq(int a, int b) { return a <= b ? -1 : 0; }
+    static inline int select(int mask, int a, int b) { return mask ? a : b; }
+
+    static inline uint8_t clampByte(int v)
+    {
+        return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+    }
+
+    template <PdfBlendMode M>
+    static constexpr bool integerBlend()
+    {
+        return M == PdfBlendMode::Multiply || M == PdfBlendMode::Screen
+            || M == PdfBlendMode::Overlay || M == PdfBlendMode::Darken
+            || M == PdfBlendMode::Lighten || M == PdfBlendMode::HardLight
+            || M == PdfBlendMode::Difference || M == PdfBlendMode::Exclusion;
+    }
+
+    // as * ab * B(Cb, Cs), rewritten on the premultiplied values so no
+    // division by an alpha is needed
+    template <PdfBlendMode M, class V>
+    static inline V blendTerm(V cs, V cb, V as, V ab)
+    {
+        if constexpr (M == PdfBlendMode::Multiply)
+            return mul255(cs, cb);
+        else if constexpr (M == PdfBlendMode::Screen)
+            return mul255(cs, ab) + mul255(cb, as) - mul255(cs, cb);
+        else if constexpr (M == PdfBlendMode::Overlay || M == PdfBlendMode::HardLight)
+        {
+            // HardLight multiplies where 2 Cs <= 1 and screens with
+            // 2 Cs - 1 above; Overlay is HardLight with Cs and Cb swapped
+            const V zero = konst(cs, 0);
+            const V product = mul255(cs, cb);
+            const V low = product + product;
+            const V rest = mul255(vmax(ab - cb, zero), vmax(as - cs, zero));
+            const V high = mul255(as, ab) - rest - rest;
+            const V useLow = (M == PdfBlendMode::HardLight) ? lessEq(cs + cs, as) : lessEq(cb + cb, ab);
+            return select(useLow, low, high);
+        }
+        else if constexpr (M == PdfBlendMode::Darken)
+            return vmin(mul255(cs, ab), mul255(cb, as));
+        else if constexpr (M == PdfBlendMode::Lighten)
+            return vmax(mul255(cs, ab), mul255(cb, as));
+        else if constexpr (M == PdfBlendMode::Difference)
+        {
+            const V s = mul255(cs, ab), b = mul255(cb, as);
+            return vmax(s, b) - vmin(s, b);
+        }
+        else
+        {
+            static_assert(M == PdfBlendMode::Exclusion, "not an integer blend mode");
+            const V product = mul255(cs, cb);
+            return mul255(cs, ab) + mul255(cb, as) - product - product;
+        }
+    }
+
+    template <PdfBlendMode M, class V>
+    static inline V blendColor(V cs, V cb, V as, V ab)
+    {
+        const V full = konst(cs, 255);
+        return mul255(cs, full - ab) + mul255(cb, full - as) + blendTerm<M>(cs, cb, as, ab);
+    }
+
+    template <PdfBlendMode M>
+    static void rowIntScalar(uint8_t* dst, const uint8_t* src, int count, uint32_t alpha)
+    {
+        for (int i = 0; i < count; i++, dst += 4, src += 4)
+        {
+            int s[4] = { src[0], src[1], src[2], src[3] };
+            if (alpha != 255)
+                for (int c = 0; c < 4; c++)
+                    s[c] = mul255(s[c], (int)alpha);
+            const int as = s[3];
+            if (as == 0) continue;
+            const int ab = dst[3];
+            for (int c = 0; c < 3; c++)
+                dst[c] = clampByte(blendColor<M>(s[c], (int)dst[c], as, ab));
+            dst[3] = clampByte(as + ab - mul255(as, ab));
+        }
+    }
+
+    // =====================================================
+    // Float blend functions (PDF 32000-1, 11.3.5.2 / 11.3.5.3)
+    // Colours are RGB in [0, 1]
+    // =====================================================
+    static inline float lum(const float c[3])
+    {
+        return 0.3f * c[0] + 0.59f * c[1] + 0.11f * c[2];
+    }
+
+    static void clipColor(float c[3])
+    {
+        const float l = lum(c);
+        const float n = std::min({ c[0], c[1], c[2] });
+        const float x = std::max({ c[0], c[1], c[2] });
+        for (int i = 0; i < 3; i++)
+        {
+            if (n < 0.0f && l - n > 1e-6f)
+                c[i] = l + (c[i] - l) * l / (l - n);
+            if (x > 1.0f && x - l > 1e-6f)
+                c[i] = l + (c[i] - l) * (1.0f - l) / (x - l);
+        }
+    }
+
+    static void setLum(const float c[3], float l, float out[3])
+    {
+        const float d = l - lum(c);
+        for (int i = 0; i < 3; i++)
+            out[i] = c[i] + d;
+        clipColor(out);
+    }
+
+    static inline float sat(const float c[3])
+    {
+        return std::max({ c[0], c[1], c[2] }) - std::min({ c[0], c[1], c[2] });
+    }
+
+    static void setSat(const float c[3], float s, float out[3])
+    {
+        int mx = 0, mn = 0;
+        for (int i = 1; i < 3; i++)
+        {
+            if (c[i] > c[mx]) mx = i;
+            if (c[i] < c[mn]) mn = i;
+        }
+        if (mx == mn)
+        {
+            out[0] = out[1] = out[2] = 0.0f;
+            return;
+        }
+        const int mid = 3 - mx - mn;
+        out[mid] = (c[mid] - c[mn]) * s / (c[mx] - c[mn]);
+        out[mx] = s;
+        out[mn] = 0.0f;
+    }
+
+    static inline float softLightD(float cb)
+    {
+        return cb <= 0.25f ? ((16.0f * cb - 12.0f) * cb + 4.0f) * cb : std::sqrt(cb);
+    }
+
+    template <PdfBlendMode M>
+    static void blendFloat(const float cb[3], const float cs[3], float out[3])
+    {
+        if constexpr (M == PdfBlendMode::Hue)
+        {
+            float t[3];
+            setSat(cs, sat(cb), t);
+            setLum(t, lum(cb), out);
+        }
+        else if constexpr (M == PdfBlendMode::Saturation)
+        {
+            float t[3];
+            setSat(cb, sat(cs), t);
+            setLum(t, lum(cb), out);
+        }
+        else if constexpr (M == PdfBlendMode::Color)
+            setLum(cs, lum(cb), out);
+        else if constexpr (M == PdfBlendMode::Luminosity)
+            setLum(cb, lum(cs), out);
+        else
+        {
+            for (int i = 0; i < 3; i++)
+            {
+                const float b = cb[i], s = cs[i];
+                if constexpr (M == PdfBlendMode::ColorDodge)
+                    out[i] = b <= 0.0f ? 0.0f : (s >= 1.0f ? 1.0f : std::min(1.0f, b / (1.0f - s)));
+                else if constexpr (M == PdfBlendMode::ColorBurn)
+                    out[i] = b >= 1.0f ? 1.0f : (s <= 0.0f ? 0.0f : 1.0f - std::min(1.0f, (1.0f - b) / s));
+                else
+                {
+                    static_assert(M == PdfBlendMode::SoftLight, "not a float blend mode");
+                    out[i] = s <= 0.5f
+                        ? b - (1.0f - 2.0f * s) * b * (1.0f - b)
+                        : b + (2.0f * s - 1.0f) * (softLightD(b) - b);
+                }
+            }
+        }
+    }
+
+    template <PdfBlendMode M>
+    static void rowFloat(uint8_t* dst, const uint8_t* src, int count, uint32_t alpha)
+    {
+        for (int i = 0; i < count; i++, dst += 4, src += 4)
+        {
+            int s[4] = { src[0], src[1], src[2], src[3] };
+            if (alpha != 255)
+                for (int c = 0; c < 4; c++)
+                    s[c] = mul255(s[c], (int)alpha);
+            const int as = s[3];
+            if (as == 0) continue;
+            const int ab = dst[3];
+
+            // BGRA -> RGB, unpremultiplied
+            float cs[3], cb[3], b[3];
+            for (int c = 0; c < 3; c++)
+            {
+                cs[c] = std::min(1.0f, s[2 - c] / (float)as);
+                cb[c] = ab ? std::min(1.0f, dst[2 - c] / (float)ab) : 0.0f;
+            }
+            blendFloat<M>(cb, cs, b);
+
+            const float asab = as * ab / 255.0f;
+            for (int c = 0; c < 3; c++)
+            {
+                const int k = 2 - c;
+                const int term = (int)(asab * std::clamp(b[c], 0.0f, 1.0f) + 0.5f);
+                dst[k] = clampByte(mul255(s[k], 255 - ab) + mul255(dst[k], 255 - as) + term);
+            }
+            dst[3] = clampByte(as + ab - mul255(as, ab));
+        }
+    }
+
+#if PDF_BLEND_SIMD
+    // =====================================================
+    // SSE2 integer kernels, 4 pixels per step (2 per 16-bit half)
+    // =====================================================
+    struct V128 { __m128i v; };
+
+    PDF_SSE2_TARGET static inline V128 operator+(V128 a, V128 b) { return { _mm_add_epi16(a.v, b.v) }; }
+    PDF_SSE2_TARGET static inline V128 operator-(V128 a, V128 b) { return { _mm_sub_epi16(a.v, b.v) }; }
+    PDF_SSE2_TARGET static inline V128 konst(V128, int k) { return { _mm_set1_epi16((short)k) }; }
+    PDF_SSE2_TARGET static inline V128 vmin(V128 a, V128 b) { return { _mm_min_epi16(a.v, b.v) }; }
+    PDF_SSE2_TARGET static inline V128 vmax(V128 a, V128 b) { return { _mm_max_epi16(a.v, b.v) }; }
+
+    PDF_SSE2_TARGET
+    static inline V128 mul255(V128 a, V128 b)
+    {
+        const __m128i t = _mm_add_epi16(_mm_mullo_epi16(a.v, b.v), _mm_set1_epi16(128));
+        return { _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8) };
+    }
+
+    PDF_SSE2_TARGET
+    static inline V128 lessEq(V128 a, V128 b)
+    {
+        return { _mm_xor_si128(_mm_cmpgt_epi16(a.v, b.v), _mm_set1_epi16(-1)) };
+    }
+
+    PDF_SSE2_TARGET
+    static inline V128 select(V128 mask, V128 a, V128 b)
+    {
+        return { _mm_or_si128(_mm_and_si128(mask.v, a.v), _mm_andnot_si128(mask.v, b.v)) };
+    }
+
+    // Two pixels in 16-bit lanes
+    template <PdfBlendMode M>
+    PDF_SSE2_TARGET
+    static inline __m128i compositeSse2(__m128i s, __m128i d)
+    {
+        const V128 cs{ s }, cb{ d };
+        const V128 as{ _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xFF), 0xFF) };
+        const V128 ab{ _mm_shufflehi_epi16(_mm_shufflelo_epi16(d, 0xFF), 0xFF) };
+        const V128 color = blendColor<M>(cs, cb, as, ab);
+        const V128 alphaOut = as + ab - mul255(as, ab);
+        const V128 alphaLanes{ _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0) };
+        return select(alphaLanes, alphaOut, color).v;
+    }
+
+    template <PdfBlendMode M>
+    PDF_SSE2_TARGET
+    static void rowIntSse2(uint8_t* dst, const uint8_t* src, int count, uint32_t alpha)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i alphaBytes = _mm_set1_epi32((int)0xFF000000u);
+        const V128 av{ _mm_set1_epi16((short)alpha) };
+
+        int i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128i s = _mm_loadu_si128((const __m128i*)(src + i * 4));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, alphaBytes), zero)) == 0xFFFF)
+                continue;
+
+            V128 sLo{ _mm_unpacklo_epi8(s, zero) };
+            V128 sHi{ _mm_unpackhi_epi8(s, zero) };
+            if (alpha != 255)
+            {
+                sLo = mul255(sLo, av);
+                sHi = mul255(sHi, av);
+            }
+            const __m128i d = _mm_loadu_si128((const __m128i*)(dst + i * 4));
+            const __m128i lo = compositeSse2<M>(sLo.v, _mm_unpacklo_epi8(d, zero));
+            const __m128i hi = compositeSse2<M>(sHi.v, _mm_unpackhi_epi8(d, zero));
+            _mm_storeu_si128((__m128i*)(dst + i * 4), _mm_packus_epi16(lo, hi));
+        }
+        rowIntScalar<M>(dst + i * 4, src + i * 4, count - i, alpha);
+    }
+
+    // =====================================================
+    // AVX2 integer kernels, 8 pixels per step
+    // =====================================================
+    struct V256 { __m256i v; };
+
+    PDF_AVX2_TARGET static inline V256 operator+(V256 a, V256 b) { return { _mm256_add_epi16(a.v, b.v) }; }
+    PDF_AVX2_TARGET static inline V256 operator-(V256 a, V256 b) { return { _mm256_sub_epi16(a.v, b.v) }; }
+    PDF_AVX2_TARGET static inline V256 konst(V256, int k) { return { _mm256_set1_epi16((short)k) }; }
+    PDF_AVX2_TARGET static inline V256 vmin(V256 a, V256 b) { return { _mm256_min_epi16(a.v, b.v) }; }
+    PDF_AVX2_TARGET static inline V256 vmax(V256 a, V256 b) { return { _mm256_max_epi16(a.v, b.v) }; }
+
+    PDF_AVX2_TARGET
+    static inline V256 mul255(V256 a, V256 b)
+    {
+        const __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(a.v, b.v), _mm256_set1_epi16(128));
+        return { _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8) };
+    }
+
+    PDF_AVX2_TARGET
+    static inline V256 lessEq(V256 a, V256 b)
+    {
+        return { _mm256_xor_si256(_mm256_cmpgt_epi16(a.v, b.v), _mm256_set1_epi16(-1)) };
+    }
+
+    PDF_AVX2_TARGET
+    static inline V256 select(V256 mask, V256 a, V256 b)
+    {
+        return { _mm256_blendv_epi8(b.v, a.v, mask.v) };
+    }
+
+    template <PdfBlendMode M>
+    PDF_AVX2_TARGET
+    static inline __m256i compositeAvx2(__m256i s, __m256i d)
+    {
+        const V256 cs{ s }, cb{ d };
+        const V256 as{ _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, 0xFF), 0xFF) };
+        const V256 ab{ _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(d, 0xFF), 0xFF) };
+        const V256 color = blendColor<M>(cs, cb, as, ab);
+        const V256 alphaOut = as + ab - mul255(as, ab);
+        return _mm256_blend_epi16(color.v, alphaOut.v, 0x88);
+    }
+
+    template <PdfBlendMode M>
+    PDF_AVX2_TARGET
+    static void rowIntAvx2(uint8_t* dst, const uint8_t* src, int count, uint32_t alpha)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i alphaBytes = _mm256_set1_epi32((int)0xFF000000u);
+        const V256 av{ _mm256_set1_epi16((short)alpha) };
+
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256i s = _mm256_loadu_si256((const __m256i*)(src + i * 4));
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(s, alphaBytes), zero)) == -1)
+                continue;
+
+            V256 sLo{ _mm256_unpacklo_epi8(s, zero) };
+            V256 sHi{ _mm256_unpackhi_epi8(s, zero) };
+            if (alpha != 255)
+            {
+                sLo = mul255(sLo, av);
+                sHi = mul255(sHi, av);
+            }
+            const __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i * 4));
+            const __m256i lo = compositeAvx2<M>(sLo.v, _mm256_unpacklo_epi8(d, zero));
+            const __m256i hi = compositeAvx2<M>(sHi.v, _mm256_unpackhi_epi8(d, zero));
+            _mm256_storeu_si256((__m256i*)(dst + i * 4), _mm256_packus_epi16(lo, hi));
+        }
+        rowIntSse2<M>(dst + i * 4, src + i * 4, count - i, alpha);
+    }
+#endif
+
+    // =====================================================
+    // Dispatch
+    // =====================================================
+    using RowKernel = void(*)(uint8_t*, const uint8_t*, int, uint32_t);
+    struct RowKernels { RowKernel narrow, wide; };
+
+    // Same split as the PdfSpan kernels: short spans stay on SSE2
+    static constexpr int WIDE_SPAN_PIXELS = 64;
+
+    template <PdfBlendMode M>
+    static RowKernel rowKernel(int count)
+    {
+        static const RowKernels kernels = []()
+            {
+                if constexpr (integerBlend<M>())
+                {
+#if PDF_BLEND_SIMD
+                    if (platform::cpuHasAvx2())
+                        return RowKernels{ rowIntSse2<M>, rowIntAvx2<M> };
+                    return RowKernels{ rowIntSse2<M>, rowIntSse2<M> };
+#else
+                    return RowKernels{ rowIntScalar<M>, rowIntScalar<M> };
+#endif
+                }
+                else
+                    return RowKernels{ rowFloat<M>, rowFloat<M> };
+            }();
+        return count >= WIDE_SPAN_PIXELS ? kernels.wide : kernels.narrow;
+    }
+
+    // Colour at opacity a as one premultiplied BGRA pixel
+    static inline uint32_t premultiply(uint32_t argb, int a)
+    {
+        const int r = mul255((argb >> 16) & 0xFF, a);
+        const int g = mul255((argb >> 8) & 0xFF, a);
+        const int b = mul255(argb & 0xFF, a);
+        return ((uint32_t)a << 24) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
+    }
+
+    // Solid and coverage spans are turned into source rows a chunk at
+    // a time and go through the row kernel
+    static constexpr int CHUNK_PIXELS = 256;
+
+    template <PdfBlendMode M>
+    static void solidBlend(uint8_t* dst, int count, uint32_t argb, uint8_t alpha)
+    {
+        const int a = mul255((argb >> 24) & 0xFF, alpha);
+        if (count <= 0 || a == 0) return;
+
+        uint32_t chunk[CHUNK_PIXELS];
+        std::fill(chunk, chunk + std::min(count, CHUNK_PIXELS), premultiply(argb, a));
+
+        const RowKernel row = rowKernel<M>(count);
+        for (int i = 0; i < count; i += CHUNK_PIXELS)
+            row(dst + i * 4, (const uint8_t*)chunk, std::min(CHUNK_PIXELS, count - i), 255);
+    }
+
+    template <PdfBlendMode M>
+    static void coverageBlend(uint8_t* dst, int count, uint32_t argb, const uint8_t* coverage)
+    {
+        const int alpha = (argb >> 24) & 0xFF;
+        if (count <= 0 || alpha == 0) return;
+
+        uint32_t chunk[CHUNK_PIXELS];
+        const RowKernel row = rowKernel<M>(count);
+        for (int i = 0; i < count; i += CHUNK_PIXELS)
+        {
+            const int n = std::min(CHUNK_PIXELS, count - i);
+            for (int j = 0; j < n; j++)
+                chunk[j] = premultiply(argb, mul255(alpha, coverage[i + j]));
+            row(dst + i * 4, (const uint8_t*)chunk, n, 255);
+        }
+    }
+
+    template <PdfBlendMode M>
+    static void rowBlend(uint8_t* dst, const uint8_t* src, int count, uint8_t alpha)
+    {
+        if (count <= 0 || alpha == 0) return;
+        rowKernel<M>(count)(dst, src, count, alpha);
+    }
+
+    template <PdfBlendMode M>
+    static constexpr PdfCompositor blendCompositor()
+    {
+        return PdfCompositor{ solidBlend<M>, coverageBlend<M>, rowBlend<M> };
+    }
+
+    const PdfCompositor& compositor(PdfBlendMode mode)
+    {
+        // Indexed by PdfBlendMode
+        static const PdfCompositor table[] = {
+            { fillSpanSolid, fillSpanCoverage, fillSpanRow },
+            blendCompositor<PdfBlendMode::Multiply>(),
+            blendCompositor<PdfBlendMode::Screen>(),
+            blendCompositor<PdfBlendMode::Overlay>(),
+            blendCompositor<PdfBlendMode::Darken>(),
+            blendCompositor<PdfBlendMode::Lighten>(),
+            blendCompositor<PdfBlendMode::ColorDodge>(),
+            blendCompositor<PdfBlendMode::ColorBurn>(),
+            blendCompositor<PdfBlendMode::HardLight>(),
+            blendCompositor<PdfBlendMode::SoftLight>(),
+            blendCompositor<PdfBlendMode::Difference>(),
+            blendCompositor<PdfBlendMode::Exclusion>(),
+            blendCompositor<PdfBlendMode::Hue>(),
+            blendCompositor<PdfBlendMode::Saturation>(),
+            blendCompositor<PdfBlendMode::Color>(),
+            blendCompositor<PdfBlendMode::Luminosity>(),
+        };
+        const size_t i = (size_t)mode;
+        return i < sizeof(table) / sizeof(table[0]) ? table[i] : table[0];
+    }
+
+} // namespace pdf
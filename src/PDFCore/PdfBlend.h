@@ -0,0 +1,65 @@
+#pragma once
+// =====================================================
+// PdfBlend.h - Blend modes, premultiplied BGRA compositors
+// =====================================================
+
+#include <cstdint>
+#include <string_view>
+
+namespace pdf
+{
+    // ExtGState /BM (PDF 32000-1, 11.3.5). Separable modes first,
+    // Hue..Luminosity are the non-separable ones.
+    enum class PdfBlendMode : uint8_t
+    {
+        Normal,
+        Multiply,
+        Screen,
+        Overlay,
+        Darken,
+        Lighten,
+        ColorDodge,
+        ColorBurn,
+        HardLight,
+        SoftLight,
+        Difference,
+        Exclusion,
+        Hue,
+        Saturation,
+        Color,
+        Luminosity
+    };
+
+    // "/Multiply" or "Multiply"; /Compatible is Normal. False if unknown.
+    bool blendModeFromName(std::string_view name, PdfBlendMode& mode);
+    const char* blendModeName(PdfBlendMode mode);
+
+    // =====================================================
+    // Compositors
+    // The CPU painter's buffer is premultiplied BGRA. A compositor
+    // draws count pixels of one row with a fixed blend mode
+    //     co = cs * (1 - ab) + cb * (1 - as) + as * ab * B(Cb, Cs)
+    //     ao = as + ab - as * ab
+    // (cs, cb premultiplied; Cs, Cb the same colours unpremultiplied)
+    // in 8-bit integer math, products rounded /255. Normal is the
+    // PdfSpan source-over kernels. Multiply, Screen, Overlay, Darken,
+    // Lighten, HardLight, Difference and Exclusion are SIMD without
+    // branches or divisions; the modes that need a division or a square
+    // root (dodge, burn, soft light, the non-separable ones) are scalar.
+    // The painter looks the compositor up when the blend mode changes.
+    // =====================================================
+    struct PdfCompositor
+    {
+        // Solid colour (0xAARRGGBB, not premultiplied) at its alpha times alpha
+        void (*solid)(uint8_t* dst, int count, uint32_t argb, uint8_t alpha);
+
+        // Same, with the opacity of pixel i scaled by coverage[i]
+        void (*coverage)(uint8_t* dst, int count, uint32_t argb, const uint8_t* coverage);
+
+        // Premultiplied BGRA source row at the extra opacity alpha
+        void (*row)(uint8_t* dst, const uint8_t* src, int count, uint8_t alpha);
+    };
+
+    const PdfCompositor& compositor(PdfBlendMode mode);
+
+} // namespace pdf
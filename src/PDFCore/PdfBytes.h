@@ -0,0 +1,111 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pdf
+{
+    // ============================================
+    // BYTE VIEW
+    // Non-owning [ptr, ptr+len) range. Lexer/parser read through this so
+    // the same code works on an owned buffer or a memory-mapped file.
+    // The caller keeps the underlying bytes alive.
+    // ============================================
+    class PdfByteView
+    {
+    public:
+        PdfByteView() = default;
+        PdfByteView(const uint8_t* p, size_t n) : _ptr(p), _size(n) {}
+        PdfByteView(const std::vector<uint8_t>& v) : _ptr(v.data()), _size(v.size()) {}
+
+        const uint8_t* data() const { return _ptr; }
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+        const uint8_t& operator[](size_t i) const { return _ptr[i]; }
+        const uint8_t* begin() const { return _ptr; }
+        const uint8_t* end() const { return _ptr + _size; }
+
+    private:
+        const uint8_t* _ptr = nullptr;
+        size_t _size = 0;
+    };
+
+    // ============================================
+    // STREAM BYTES
+    // Either an owned buffer (decoded/decrypted data) or a slice of the
+    // document bytes. Slices keep the document storage (vector or file
+    // mapping) alive through a shared owner, so no copy is made at parse time.
+    // ============================================
+    class PdfBytes
+    {
+    public:
+        PdfBytes() = default;
+        PdfBytes(std::vector<uint8_t> v) : _own(std::move(v)) { _ptr = _own.data(); _size = _own.size(); }
+
+        // Slice of shared storage (no copy)
+        static PdfBytes slice(std::shared_ptr<const uint8_t> owner, const uint8_t* p, size_t n)
+        {
+            PdfBytes b;
+            b._owner = std::move(owner);
+            b._ptr = p;
+            b._size = n;
+            return b;
+        }
+
+        PdfBytes(const PdfBytes& o) { *this = o; }
+        PdfBytes(PdfBytes&& o) noexcept { *this = std::move(o); }
+
+        PdfBytes& operator=(const PdfBytes& o)
+        {
+            if (this == &o) return *this;
+            _owner = o._owner;
+            _own = o._own;
+            _ptr = o._owner ? o._ptr : _own.data();
+            _size = o._size;
+            return *this;
+        }
+
+        PdfBytes& operator=(PdfBytes&& o) noexcept
+        {
+            if (this == &o) return *this;
+            _owner = std::move(o._owner);
+            _own = std::move(o._own);
+            _ptr = _owner ? o._ptr : _own.data();
+            _size = o._size;
+            o._ptr = nullptr;
+            o._size = 0;
+            return *this;
+        }
+
+        PdfBytes& operator=(std::vector<uint8_t>&& v)
+        {
+            _owner.reset();
+            _own = std::move(v);
+            _ptr = _own.data();
+            _size = _own.size();
+            return *this;
+        }
+
+        PdfBytes& operator=(const std::vector<uint8_t>& v) { return *this = std::vector<uint8_t>(v); }
+
+        const uint8_t* data() const { return _ptr; }
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        bool isSlice() const { return _owner != nullptr; }
+
+        const uint8_t& operator[](size_t i) const { return _ptr[i]; }
+        const uint8_t* begin() const { return _ptr; }
+        const uint8_t* end() const { return _ptr + _size; }
+
+        operator PdfByteView() const { return PdfByteView(_ptr, _size); }
+        std::vector<uint8_t> toVector() const { return std::vector<uint8_t>(begin(), end()); }
+
+    private:
+        std::shared_ptr<const uint8_t> _owner;
+        std::vector<uint8_t> _own;
+        const uint8_t* _ptr = nullptr;
+        size_t _size = 0;
+    };
+}
@@ -10,12 +10,14 @@
 #include "PdfPainter.h"  // For PdfPattern
 #include "PdfDocument.h"
 #include "PdfDebug.h"
+#include "PdfTrace.h"
 #include "PdfGradient.h"
-#include <windows.h>
+#include "PdfLexer.h"
 #include <cctype>
 #include <cmath>
 #include <algorithm>
 #include <cstring>
+#include <string_view>
 
 namespace pdf
 {
@@ -130,20 +132,7 @@ namespace pdf
     }
 
 
-    static uint32_t rgbToArgb(const double rgb[3])
-    {
-        int r = (int)(rgb[0] * 255.0);
-        int g = (int)(rgb[1] * 255.0);
-        int b = (int)(rgb[2] * 255.0);
-
-        r = std::clamp(r, 0, 255);
-        g = std::clamp(g, 0, 255);
-        b = std::clamp(b, 0, 255);
-
-        return 0xFF000000u | (r << 16) | (g << 8) | b;
-    }
-
-    // Alpha destekli versiyon
+    // ARGB (alpha = ExtGState ca/CA)
     static uint32_t rgbToArgbWithAlpha(const double rgb[3], double alpha)
     {
         int a = (int)(alpha * 255.0);
@@ -315,46 +304,72 @@ namespace pdf
     // Token Readers
     // =========================================================
 
+    // Sayı metni buffer üzerinde taranır ve yerinde parse edilir (string yok).
+    // Tek başına "+", "-" veya "." 0 olur (eskiden std::stod exception atıyordu).
     double PdfContentParser::readNumber()
     {
-        std::string s;
+        const size_t start = _pos;
 
         uint8_t c = peek();
         if (c == '+' || c == '-')
-            s.push_back((char)get());
+            _pos++;
 
         while (!eof())
         {
-            c = peek();
+            c = _data[_pos];
             if (std::isdigit((unsigned char)c) || c == '.')
-                s.push_back((char)get());
+                _pos++;
             else
                 break;
         }
 
-        if (s.empty())
-            return 0.0;
-        return std::stod(s);
+        return pdfParseNumber(reinterpret_cast<const char*>(_data.data()) + start, _pos - start);
     }
 
-
-
-    std::string PdfContentParser::readName()
+    // Çağıran '/' karakterini tüketmiş olmalı: dönen view onu da içerir ("/F1")
+    std::string_view PdfContentParser::readName()
     {
-        std::string out;
+        const size_t start = _pos - 1;
 
         while (!eof())
         {
-            uint8_t c = peek();
+            uint8_t c = _data[_pos];
             if (std::isspace(c) ||
                 c == '/' || c == '(' || c == ')' ||
                 c == '<' || c == '>' || c == '[' || c == ']')
                 break;
 
-            out.push_back((char)get());
+            _pos++;
         }
 
-        return "/" + out;
+        return std::string_view(reinterpret_cast<const char*>(_data.data()) + start, _pos - start);
+    }
+
+    // Escape içermeyen literal string: içerik buffer'daki byte'ların aynısı,
+    // kopyalamadan view olarak döner. '\\' görülürse ya da string kapanmazsa
+    // pozisyon geri alınır ve readString() (unescape) kullanılır.
+    bool PdfContentParser::readPlainString(std::string_view& out)
+    {
+        const size_t start = _pos;
+        const size_t MAX_STRING_LEN = 65535;
+        const size_t end = std::min(_data.size(), start + MAX_STRING_LEN);
+        int depth = 1;
+
+        for (size_t p = start; p < end; p++)
+        {
+            uint8_t c = _data[p];
+            if (c == '\\')
+                return false;
+            if (c == '(')
+                depth++;
+            else if (c == ')' && --depth == 0)
+            {
+                out = std::string_view(reinterpret_cast<const char*>(_data.data()) + start, p - start);
+                _pos = p + 1;
+                return true;
+            }
+        }
+        return false;
     }
     std::string PdfContentParser::readString()
     {
@@ -465,15 +480,16 @@ namespace pdf
         return out;
     }
 
-    std::string PdfContentParser::readWord()
+    // Operatör kelimesi content buffer'ı üzerinde bir view olarak döner (kopya yok)
+    std::string_view PdfContentParser::readOperator()
     {
-        std::string s;
-        size_t limit = 0;
+        const size_t start = _pos;
         const size_t MAX_WORD_LEN = 1000;
+        const size_t end = std::min(_data.size(), start + MAX_WORD_LEN);
 
-        while (!eof() && limit++ < MAX_WORD_LEN)
+        while (_pos < end)
         {
-            uint8_t c = peek();
+            uint8_t c = _data[_pos];
             // PDF delimiter ve whitespace karakterlerinde dur
             if (std::isspace(c) ||
                 c == '[' || c == ']' ||
@@ -482,28 +498,73 @@ namespace pdf
                 c == '/' || c == '%' ||
                 c == '{' || c == '}')
                 break;
+            _pos++;
+        }
+
+        return std::string_view(reinterpret_cast<const char*>(_data.data()) + start, _pos - start);
+    }
+
+    // =========================================================
+    // Compiled Content
+    // =========================================================
+
+    // Stack slots keep stale string capacity around; only copy what the
+    // operand actually uses
+    static void copyOperand(const PdfOperand& src, PdfOperand& dst)
+    {
+        dst.kind = src.kind;
+        dst.owned = src.owned;
+        dst.number = src.number;
+        dst.view = src.view;
+        if (src.owned)
+            dst.storage.assign(src.storage);
+        dst.object = src.object;
+    }
 
-            s.push_back((char)get());
+    size_t PdfCompiledContent::byteSize() const
+    {
+        size_t bytes = sizeof(*this) + data.capacity()
+            + operands.capacity() * sizeof(PdfOperand) + ops.capacity() * sizeof(Op);
+        for (const auto& op : operands)
+        {
+            bytes += op.storage.capacity();
+            if (op.object) bytes += 64; // arrays (TJ, d) and inline dicts, roughly
         }
+        return bytes;
+    }
 
-        return s;
+    size_t PdfCompiledForm::byteSize() const
+    {
+        size_t bytes = content.byteSize();
+        for (const auto& kv : fonts)
+            bytes += sizeof(kv) + kv.second.fontProgram.capacity();
+        return bytes;
     }
 
     // =========================================================
     // Stack Helpers
     // =========================================================
 
+    std::shared_ptr<PdfObject> PdfOperand::toObject() const
+    {
+        switch (kind)
+        {
+        case Kind::Number: return pdfNumberObject(number);
+        case Kind::Name:   return std::make_shared<PdfName>(std::string(view));
+        case Kind::String: return std::make_shared<PdfString>(std::string(text()));
+        case Kind::Object: return object;
+        }
+        return nullptr;
+    }
+
     double PdfContentParser::popNumber(double def)
     {
         if (_stack.empty()) return def;
 
-        auto obj = _stack.back();
+        const PdfOperand& op = _stack.back();
+        double v = (op.kind == PdfOperand::Kind::Number) ? op.number : def;
         _stack.pop_back();
-
-        if (auto n = std::dynamic_pointer_cast<PdfNumber>(obj))
-            return n->value;
-
-        return def;
+        return v;
     }
 
     std::string PdfContentParser::popString()
@@ -511,16 +572,12 @@ namespace pdf
         if (_stack.empty())
             return "";
 
-        auto obj = _stack.back();
+        const PdfOperand& op = _stack.back();
+        std::string s;
+        if (op.kind == PdfOperand::Kind::String || op.kind == PdfOperand::Kind::Name)
+            s.assign(op.text());
         _stack.pop_back();
-
-        if (auto s = std::dynamic_pointer_cast<PdfString>(obj))
-            return s->value;
-
-        if (auto n = std::dynamic_pointer_cast<PdfName>(obj))
-            return n->value;
-
-        return "";
+        return s;
     }
 
     std::string PdfContentParser::popName()
@@ -528,13 +585,55 @@ namespace pdf
         if (_stack.empty())
             return "";
 
-        auto obj = _stack.back();
+        const PdfOperand& op = _stack.back();
+        std::string s;
+        if (op.kind == PdfOperand::Kind::Name)
+            s.assign(op.view);
+        _stack.pop_back();
+        return s;
+    }
+
+    std::shared_ptr<PdfArray> PdfContentParser::popArray()
+    {
+        if (_stack.empty())
+            return nullptr;
+
+        auto arr = pdfCast<PdfArray>(_stack.back().object);
         _stack.pop_back();
+        return arr;
+    }
+
+    void PdfContentParser::pushNumber(double v)
+    {
+        PdfOperand& op = _stack.push();
+        op.kind = PdfOperand::Kind::Number;
+        op.number = v;
+    }
+
+    void PdfContentParser::pushName(std::string_view name)
+    {
+        PdfOperand& op = _stack.push();
+        op.kind = PdfOperand::Kind::Name;
+        op.view = name;
+    }
 
-        if (auto n = std::dynamic_pointer_cast<PdfName>(obj))
-            return n->value;
+    // owned=true: bytes are copied into the slot (unescaped / decoded text)
+    void PdfContentParser::pushString(std::string_view bytes, bool owned)
+    {
+        PdfOperand& op = _stack.push();
+        op.kind = PdfOperand::Kind::String;
+        op.owned = owned;
+        if (owned)
+            op.storage.assign(bytes.data(), bytes.size());
+        else
+            op.view = bytes;
+    }
 
-        return "";
+    void PdfContentParser::pushObject(std::shared_ptr<PdfObject> obj)
+    {
+        PdfOperand& op = _stack.push();
+        op.kind = PdfOperand::Kind::Object;
+        op.object = std::move(obj);
     }
 
     // =========================================================
@@ -556,7 +655,7 @@ namespace pdf
         if (c == '/')
         {
             get();
-            _stack.push_back(std::make_shared<PdfName>(readName()));
+            pushName(readName());
             return;
         }
 
@@ -602,7 +701,7 @@ namespace pdf
                     }
 
                     get(); // / karakterini atla
-                    std::string key = "/" + readName();
+                    std::string key = "/" + std::string(readName());
 
                     skipSpaces();
 
@@ -618,59 +717,54 @@ namespace pdf
 
                     if (!_stack.empty())
                     {
-                        dict->entries[key] = _stack.back();
+                        dict->entries[key] = _stack.back().toObject();
                         _stack.pop_back();
                     }
                 }
 
-                _stack.push_back(dict);
+                pushObject(dict);
                 return;
             }
 
             // ============ HEX STRING PARSING ============
             // <XXXX> formatindaki hex string'leri parse et
+            // Binary doğrudan slot'un kendi buffer'ına yazılır (kapasite tekrar kullanılır)
             get(); // < karakterini atla
-            std::string hexStr;
+            PdfOperand& op = _stack.push();
+            op.kind = PdfOperand::Kind::String;
+            op.owned = true;
+            std::string& binary = op.storage;
+            binary.clear();
+
+            int hi = -1;
             while (!eof() && peek() != '>')
             {
                 uint8_t ch = get();
                 // Sadece hex karakterleri al, whitespace'leri atla
-                if ((ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'F') || (ch >= 'a' && ch <= 'f'))
-                    hexStr += (char)ch;
+                int v = (ch >= '0' && ch <= '9') ? (ch - '0') :
+                    (ch >= 'A' && ch <= 'F') ? (10 + ch - 'A') :
+                    (ch >= 'a' && ch <= 'f') ? (10 + ch - 'a') : -1;
+                if (v < 0) continue;
+                if (hi < 0) hi = v;
+                else { binary += (char)((hi << 4) | v); hi = -1; }
             }
             if (!eof())
                 get(); // > karakterini atla
 
-            // Hex string'i binary'ye cevir
-            std::string binary;
-            for (size_t i = 0; i + 1 < hexStr.size(); i += 2)
-            {
-                char c1 = hexStr[i];
-                char c2 = hexStr[i + 1];
-                int hi = (c1 >= '0' && c1 <= '9') ? (c1 - '0') :
-                    (c1 >= 'A' && c1 <= 'F') ? (10 + c1 - 'A') : (10 + c1 - 'a');
-                int lo = (c2 >= '0' && c2 <= '9') ? (c2 - '0') :
-                    (c2 >= 'A' && c2 <= 'F') ? (10 + c2 - 'A') : (10 + c2 - 'a');
-                binary += (char)((hi << 4) | lo);
-            }
             // Tek haneli kalan varsa (PDF spec: sondaki 0 ile tamamla)
-            if (hexStr.size() % 2 == 1)
-            {
-                char c1 = hexStr.back();
-                int hi = (c1 >= '0' && c1 <= '9') ? (c1 - '0') :
-                    (c1 >= 'A' && c1 <= 'F') ? (10 + c1 - 'A') : (10 + c1 - 'a');
+            if (hi >= 0)
                 binary += (char)(hi << 4);
-            }
-
-            _stack.push_back(std::make_shared<PdfString>(binary));
             return;
         }
 
         if (c == '(')
         {
             get();
-            std::string str = readString();
-            _stack.push_back(std::make_shared<PdfString>(str));
+            std::string_view plain;
+            if (readPlainString(plain))
+                pushString(plain, false);
+            else
+                pushString(readString(), true);
 
             if (_pos > _data.size())
             {
@@ -714,12 +808,12 @@ namespace pdf
 
                 if (!_stack.empty())
                 {
-                    arr->items.push_back(_stack.back());
+                    arr->items.push_back(_stack.back().toObject());
                     _stack.pop_back();
                 }
             }
 
-            _stack.push_back(arr);
+            pushObject(arr);
             return;
         }
         if (c == ']')
@@ -729,31 +823,28 @@ namespace pdf
         }
         if (c == '+' || c == '-' || c == '.' || std::isdigit(c))
         {
-            _stack.push_back(std::make_shared<PdfNumber>(readNumber()));
-            return;
-        }
-
-        size_t posBefore = _pos;
-        std::string op = readWord();
-
-        if (_pos == posBefore && !op.empty())
-        {
-            LogDebug("ERROR: readWord did not advance position, op='%s'", op.c_str());
-            _pos++;
+            pushNumber(readNumber());
             return;
         }
 
+        std::string_view op = readOperator();
         if (!op.empty())
+        {
+            if (_record)
+                recordOperator(op);
             handleOperator(op);
+        }
     }
 
-    void PdfContentParser::parse()
+    void PdfContentParser::parse(PdfCompiledContent* record)
     {
         _pos = 0;
         _stack.clear();
         while (!_gsStack.empty()) _gsStack.pop();
 
         _currentFont = nullptr;
+        _record = record;
+        syncBlendMode();
 
         // ✅ Dinamik limit: Her byte için ~1 iterasyon (güvenli üst sınır)
         // Büyük content stream'ler (örn. 500KB+) çok fazla operatör içerebilir
@@ -786,6 +877,59 @@ namespace pdf
             parseToken();
         }
 
+        _record = nullptr;
+        LogDebug("PdfContentParser::parse() FINISHED - %zu iterations, %zu bytes",
+            iterCount, _data.size());
+        finishParse();
+    }
+
+    void PdfContentParser::replay(const PdfCompiledContent& compiled)
+    {
+        _stack.clear();
+        while (!_gsStack.empty()) _gsStack.pop();
+
+        _currentFont = nullptr;
+        syncBlendMode();
+
+        for (const auto& op : compiled.ops)
+        {
+            _stack.clear();
+            for (uint32_t i = 0; i < op.operandCount; i++)
+            {
+                copyOperand(compiled.operands[op.firstOperand + i], _stack.push());
+            }
+            handleOperator(op.name);
+        }
+
+        LogDebug("PdfContentParser::replay() FINISHED - %zu operators", compiled.ops.size());
+        finishParse();
+    }
+
+    // Snapshot of the operand stack the operator is about to see. Leftover
+    // operands from earlier operators are part of it, so replay() can
+    // start every operator from a cleared stack.
+    void PdfContentParser::recordOperator(std::string_view op)
+    {
+        PdfCompiledContent::Op rec;
+        rec.name = op;
+        rec.firstOperand = (uint32_t)_record->operands.size();
+        rec.operandCount = (uint32_t)_stack.size();
+        for (size_t i = 0; i < _stack.size(); i++)
+        {
+            _record->operands.emplace_back();
+            copyOperand(_stack[i], _record->operands.back());
+        }
+        _record->ops.push_back(rec);
+    }
+
+    void PdfContentParser::syncBlendMode()
+    {
+        if (_painter && _painter->blendMode() != _gs.blendMode)
+            _painter->setBlendMode(_gs.blendMode);
+    }
+
+    void PdfContentParser::finishParse()
+    {
         // ★ Cleanup: Pop any remaining D2D clip/SMask layers
         // Without this, D2D EndDraw() fails with D2DERR_INVALIDCALL due to unpaired PushLayer/PopLayer
         // This happens when W operators exist outside any q/Q pair (common in many PDFs)
@@ -816,9 +960,6 @@ namespace pdf
             _clipLayerCount = 0;
             _smaskLayerCount = 0;
         }
-
-        LogDebug("PdfContentParser::parse() FINISHED - %zu iterations, %zu bytes",
-            iterCount, _data.size());
     }
 
 
@@ -922,41 +1063,8 @@ namespace pdf
 
     void PdfContentParser::op_f()
     {
-        // ========== DEBUG DISABLED FOR PERFORMANCE ==========
-        // Uncomment for debugging fill operations
-        /*
-        static FILE* fillDebug = nullptr;
-        static int fillCallCount = 0;
-        if (!fillDebug) {
-            char tempPath[MAX_PATH];
-            GetTempPathA(MAX_PATH, tempPath);
-            strcat(tempPath, "fill_debug.txt");
-            fillDebug = fopen(tempPath, "w");
-            if (fillDebug) {
-                fprintf(fillDebug, "=== FILL DEBUG ===\n");
-                fprintf(fillDebug, "Log file: %s\n", tempPath);
-                fflush(fillDebug);
-            }
-        }
-        fillCallCount++;
-
-        int curveCount = 0, lineCount = 0, moveCount = 0;
-        for (const auto& seg : _currentPath) {
-            if (seg.type == PdfPathSegment::CurveTo) curveCount++;
-            else if (seg.type == PdfPathSegment::LineTo) lineCount++;
-            else if (seg.type == PdfPathSegment::MoveTo) moveCount++;
-        }
-
-        if (fillDebug) {
-            fprintf(fillDebug, "\n[op_f #%d] _currentPath.size=%zu, moves=%d, lines=%d, CURVES=%d\n",
-                fillCallCount, _currentPath.size(), moveCount, lineCount, curveCount);
-            fprintf(fillDebug, "  fillPatternName='%s'\n", _gs.fillPatternName.c_str());
-            fprintf(fillDebug, "  CTM=[%.4f %.4f %.4f %.4f %.4f %.4f]\n",
-                _gs.ctm.a, _gs.ctm.b, _gs.ctm.c, _gs.ctm.d, _gs.ctm.e, _gs.ctm.f);
-            fflush(fillDebug);
-        }
-        */
-        // ========== END DEBUG ==========
+        PDF_TRACE(Parse, "f", "%zu segments, pattern='%s'",
+            _currentPath.size(), _gs.fillPatternName.c_str());
 
         // ✅ FIX: Skip completely transparent fills (alpha = 0)
         if (_gs.fillAlpha <= 0.001)
@@ -1102,7 +1210,7 @@ namespace pdf
         LogDebug("resolvePatternToGradient: _resStack size = %zu", _resStack.size());
 
         // Resources'tan Pattern dictionary'yi bul
-        std::set<int> visited;
+        PdfVisitedRefs visited;
 
         int resIndex = 0;
         for (auto it = _resStack.rbegin(); it != _resStack.rend(); ++it, ++resIndex)
@@ -1115,8 +1223,7 @@ namespace pdf
 
             LogDebug("  resStack[%d]: checking for Pattern dict...", resIndex);
 
-            auto patternsRaw = res->get("Pattern");
-            if (!patternsRaw) patternsRaw = res->get("/Pattern");
+            auto patternsRaw = res->get(PdfKeys::Pattern);
             if (!patternsRaw) {
                 LogDebug("  resStack[%d]: No Pattern dict found", resIndex);
                 continue;
@@ -1125,7 +1232,7 @@ namespace pdf
             LogDebug("  resStack[%d]: Found Pattern dict, resolving...", resIndex);
 
             auto patternsObj = _doc->resolve(patternsRaw, visited);
-            auto patternsDict = std::dynamic_pointer_cast<PdfDictionary>(patternsObj);
+            auto patternsDict = pdfCast<PdfDictionary>(patternsObj);
             if (!patternsDict) {
                 LogDebug("  resStack[%d]: Pattern is not a dictionary!", resIndex);
                 continue;
@@ -1139,7 +1246,6 @@ namespace pdf
             }
 
             auto patternRaw = patternsDict->get(name);
-            if (!patternRaw) patternRaw = patternsDict->get("/" + name);
             if (!patternRaw) {
                 LogDebug("  resStack[%d]: Pattern '%s' not found in dict", resIndex, name.c_str());
                 continue;
@@ -1148,10 +1254,10 @@ namespace pdf
             LogDebug("  resStack[%d]: Found pattern '%s', resolving...", resIndex, name.c_str());
 
             auto patternObj = _doc->resolve(patternRaw, visited);
-            auto patternDict = std::dynamic_pointer_cast<PdfDictionary>(patternObj);
+            auto patternDict = pdfCast<PdfDictionary>(patternObj);
             if (!patternDict) {
                 // Tiling patterns are PdfStream objects (PdfStream is NOT a PdfDictionary subclass)
-                auto patternStream = std::dynamic_pointer_cast<PdfStream>(patternObj);
+                auto patternStream = pdfCast<PdfStream>(patternObj);
                 if (patternStream && patternStream->dict)
                     patternDict = patternStream->dict;
                 else {
@@ -1161,14 +1267,13 @@ namespace pdf
             }
 
             // PatternType kontrol et
-            auto ptRaw = patternDict->get("PatternType");
-            if (!ptRaw) ptRaw = patternDict->get("/PatternType");
+            auto ptRaw = patternDict->get(PdfKeys::PatternType);
             if (!ptRaw) {
                 LogDebug("  Pattern '%s' has no PatternType!", name.c_str());
                 continue;
             }
 
-            auto ptNum = std::dynamic_pointer_cast<PdfNumber>(ptRaw);
+            auto ptNum = pdfCast<PdfNumber>(ptRaw);
             int patternType = ptNum ? (int)ptNum->value : 0;
             LogDebug("  Pattern '%s' PatternType = %d", name.c_str(), patternType);
 
@@ -1179,8 +1284,7 @@ namespace pdf
 
             // Pattern Matrix
             patternMatrix = PdfMatrix(); // identity default
-            auto matrixRaw = patternDict->get("Matrix");
-            if (!matrixRaw) matrixRaw = patternDict->get("/Matrix");
+            auto matrixRaw = patternDict->get(PdfKeys::Matrix);
             if (matrixRaw) {
                 patternMatrix = readMatrix6(matrixRaw);
                 LogDebug("  Pattern matrix: [%.3f %.3f %.3f %.3f %.3f %.3f]",
@@ -1192,29 +1296,27 @@ namespace pdf
             }
 
             // Shading dictionary
-            auto shadingRaw = patternDict->get("Shading");
-            if (!shadingRaw) shadingRaw = patternDict->get("/Shading");
+            auto shadingRaw = patternDict->get(PdfKeys::Shading);
             if (!shadingRaw) {
                 LogDebug("  Pattern '%s' has no Shading dict!", name.c_str());
                 continue;
             }
 
             auto shadingObj = _doc->resolve(shadingRaw, visited);
-            auto shadingDict = std::dynamic_pointer_cast<PdfDictionary>(shadingObj);
+            auto shadingDict = pdfCast<PdfDictionary>(shadingObj);
             if (!shadingDict) {
                 LogDebug("  Shading is not a dictionary!");
                 continue;
             }
 
             // ShadingType
-            auto stRaw = shadingDict->get("ShadingType");
-            if (!stRaw) stRaw = shadingDict->get("/ShadingType");
+            auto stRaw = shadingDict->get(PdfKeys::ShadingType);
             if (!stRaw) {
                 LogDebug("  Shading has no ShadingType!");
                 continue;
             }
 
-            auto stNum = std::dynamic_pointer_cast<PdfNumber>(stRaw);
+            auto stNum = pdfCast<PdfNumber>(stRaw);
             int shadingType = stNum ? (int)stNum->value : 0;
             LogDebug("  ShadingType = %d", shadingType);
 
@@ -1226,15 +1328,14 @@ namespace pdf
             gradient.type = shadingType;
 
             // Coords
-            auto coordsRaw = shadingDict->get("Coords");
-            if (!coordsRaw) coordsRaw = shadingDict->get("/Coords");
+            auto coordsRaw = shadingDict->get(PdfKeys::Coords);
             if (!coordsRaw) {
                 LogDebug("  Shading has no Coords!");
                 continue;
             }
 
             auto coordsObj = _doc->resolve(coordsRaw, visited);
-            auto coordsArr = std::dynamic_pointer_cast<PdfArray>(coordsObj);
+            auto coordsArr = pdfCast<PdfArray>(coordsObj);
             if (!coordsArr || coordsArr->items.size() < 4) {
                 LogDebug("  Coords is not a valid array!");
                 continue;
@@ -1242,7 +1343,7 @@ namespace pdf
 
             std::vector<double> coords(6, 0.0);
             for (size_t i = 0; i < coordsArr->items.size() && i < 6; ++i) {
-                auto n = std::dynamic_pointer_cast<PdfNumber>(_doc->resolve(coordsArr->items[i], visited));
+                auto n = pdfCast<PdfNumber>(_doc->resolve(coordsArr->items[i], visited));
                 if (n) coords[i] = n->value;
             }
 
@@ -1270,48 +1371,47 @@ namespace pdf
 
             // ColorSpace
             int numComponents = 3;
-            auto csRaw = shadingDict->get("ColorSpace");
-            if (!csRaw) csRaw = shadingDict->get("/ColorSpace");
+            auto csRaw = shadingDict->get(PdfKeys::ColorSpace);
             if (csRaw) {
                 auto csObj = _doc->resolve(csRaw, visited);
-                if (auto csName = std::dynamic_pointer_cast<PdfName>(csObj)) {
+                if (auto csName = pdfCast<PdfName>(csObj)) {
                     std::string cs = csName->value;
                     LogDebug("  ColorSpace = '%s'", cs.c_str());
-                    if (cs == "/DeviceGray" || cs == "DeviceGray") numComponents = 1;
-                    else if (cs == "/DeviceCMYK" || cs == "DeviceCMYK") numComponents = 4;
+                    if (cs == "/DeviceGray") numComponents = 1;
+                    else if (cs == "/DeviceCMYK") numComponents = 4;
                 }
-                else if (auto csArr = std::dynamic_pointer_cast<PdfArray>(csObj)) {
+                else if (auto csArr = pdfCast<PdfArray>(csObj)) {
                     if (!csArr->items.empty()) {
-                        auto first = std::dynamic_pointer_cast<PdfName>(
+                        auto first = pdfCast<PdfName>(
                             _doc->resolve(csArr->items[0], visited));
                         if (first) {
                             std::string csType = first->value;
                             LogDebug("  ColorSpace array type = '%s'", csType.c_str());
-                            if (csType == "/ICCBased" || csType == "ICCBased") {
+                            if (csType == "/ICCBased") {
                                 if (csArr->items.size() >= 2) {
-                                    auto iccStream = std::dynamic_pointer_cast<PdfStream>(
+                                    auto iccStream = pdfCast<PdfStream>(
                                         _doc->resolve(csArr->items[1], visited));
                                     if (iccStream && iccStream->dict) {
-                                        auto nObj = std::dynamic_pointer_cast<PdfNumber>(
-                                            _doc->resolve(iccStream->dict->get("/N"), visited));
+                                        auto nObj = pdfCast<PdfNumber>(
+                                            _doc->resolve(iccStream->dict->get(PdfKeys::N), visited));
                                         if (nObj) numComponents = (int)nObj->value;
                                     }
                                 }
                             }
-                            else if (csType == "/Separation" || csType == "Separation") {
+                            else if (csType == "/Separation") {
                                 numComponents = 1;
                             }
-                            else if (csType == "/DeviceN" || csType == "DeviceN") {
+                            else if (csType == "/DeviceN") {
                                 LogDebug("  DeviceN color space in pattern shading");
                                 // Check alternate space
                                 if (csArr->items.size() >= 3) {
                                     auto altCS = _doc->resolve(csArr->items[2], visited);
-                                    if (auto altName = std::dynamic_pointer_cast<PdfName>(altCS)) {
+                                    if (auto altName = pdfCast<PdfName>(altCS)) {
                                         std::string alt = altName->value;
                                         LogDebug("  DeviceN alternate: %s", alt.c_str());
-                                        if (alt == "/DeviceCMYK" || alt == "DeviceCMYK")
+                                        if (alt == "/DeviceCMYK")
                                             numComponents = 4;
-                                        else if (alt == "/DeviceGray" || alt == "DeviceGray")
+                                        else if (alt == "/DeviceGray")
                                             numComponents = 1;
                                     }
                                 }
@@ -1322,8 +1422,7 @@ namespace pdf
             }
 
             // Function
-            auto funcRaw = shadingDict->get("Function");
-            if (!funcRaw) funcRaw = shadingDict->get("/Function");
+            auto funcRaw = shadingDict->get(PdfKeys::Function);
             if (funcRaw) {
                 auto funcObj = _doc->resolve(funcRaw, visited);
                 LogDebug("  Parsing Function...");
@@ -1375,16 +1474,15 @@ namespace pdf
         {
             auto res = *it;
             if (!res) continue;
-            auto patternsRaw = res->get("/Pattern");
+            auto patternsRaw = res->get(PdfKeys::Pattern);
             if (!patternsRaw) continue;
 
-            std::set<int> visited;
+            PdfVisitedRefs visited;
             auto patternsObj = _doc->resolve(patternsRaw, visited);
-            auto patternsDict = std::dynamic_pointer_cast<PdfDictionary>(patternsObj);
+            auto patternsDict = pdfCast<PdfDictionary>(patternsObj);
             if (!patternsDict) continue;
 
             auto patternRaw = patternsDict->get(name);
-            if (!patternRaw) patternRaw = patternsDict->get("/" + name);
             if (patternRaw) {
                 patternObj = _doc->resolve(patternRaw, visited);
                 if (patternObj) break;
@@ -1396,10 +1494,10 @@ namespace pdf
             return false;
         }
 
-        auto patternDict = std::dynamic_pointer_cast<PdfDictionary>(patternObj);
+        auto patternDict = pdfCast<PdfDictionary>(patternObj);
         if (!patternDict) {
             // Tiling patterns are PdfStream objects (PdfStream is NOT a PdfDictionary subclass)
-            auto patternStream = std::dynamic_pointer_cast<PdfStream>(patternObj);
+            auto patternStream = pdfCast<PdfStream>(patternObj);
             if (patternStream && patternStream->dict)
                 patternDict = patternStream->dict;
             else
@@ -1407,14 +1505,14 @@ namespace pdf
         }
 
         // PatternType
-        auto ptNum = std::dynamic_pointer_cast<PdfNumber>(resolveObj(patternDict->get("/PatternType")));
+        auto ptNum = pdfCast<PdfNumber>(resolveObj(patternDict->get(PdfKeys::PatternType)));
         int type = ptNum ? (int)ptNum->value : 0;
 
         pattern.type = type;
 
         // Matrix
         pattern.matrix = PdfMatrix(); // identity
-        auto matrixRaw = patternDict->get("/Matrix");
+        auto matrixRaw = patternDict->get(PdfKeys::Matrix);
         if (matrixRaw) pattern.matrix = readMatrix6(matrixRaw);
         pattern.defaultCtm = _defaultCtm;  // Parent's initial CTM for brush mapping
 
@@ -1423,15 +1521,15 @@ namespace pdf
             // Tiling Pattern
             LogDebug("Resolving Tiling Pattern (Type 1): %s", name.c_str());
 
-            auto ptRaw = patternDict->get("/PaintType");
-            auto tmRaw = patternDict->get("/TilingType");
-            auto xsRaw = patternDict->get("/XStep");
-            auto ysRaw = patternDict->get("/YStep");
+            auto ptRaw = patternDict->get(PdfKeys::PaintType);
+            auto tmRaw = patternDict->get(PdfKeys::TilingType);
+            auto xsRaw = patternDict->get(PdfKeys::XStep);
+            auto ysRaw = patternDict->get(PdfKeys::YStep);
 
-            auto ptN = std::dynamic_pointer_cast<PdfNumber>(resolveObj(ptRaw));
-            auto tmN = std::dynamic_pointer_cast<PdfNumber>(resolveObj(tmRaw));
-            auto xsN = std::dynamic_pointer_cast<PdfNumber>(resolveObj(xsRaw));
-            auto ysN = std::dynamic_pointer_cast<PdfNumber>(resolveObj(ysRaw));
+            auto ptN = pdfCast<PdfNumber>(resolveObj(ptRaw));
+            auto tmN = pdfCast<PdfNumber>(resolveObj(tmRaw));
+            auto xsN = pdfCast<PdfNumber>(resolveObj(xsRaw));
+            auto ysN = pdfCast<PdfNumber>(resolveObj(ysRaw));
 
             pattern.isUncolored = (ptN && (int)ptN->value == 2);
             pattern.tilingType = tmN ? (int)tmN->value : 1;
@@ -1442,7 +1540,7 @@ namespace pdf
 
             // Render Tile
             // Tip dönüşümü: Type 1 Pattern bir Stream olmalıdır.
-            auto stream = std::dynamic_pointer_cast<PdfStream>(patternObj);
+            auto stream = pdfCast<PdfStream>(patternObj);
             if (!stream) {
                 LogDebug("Error: Type 1 Pattern is not a Stream!");
                 return false;
@@ -1474,13 +1572,13 @@ namespace pdf
                 // ÇÖZÜM: renderPatternTile metodunu KULLANMADAN direkt buraya yazalım (Inline).
 
                 // 1. BBox
-                auto bboxArr = std::dynamic_pointer_cast<PdfArray>(resolveObj(patternDict->get("/BBox")));
+                auto bboxArr = pdfCast<PdfArray>(resolveObj(patternDict->get(PdfKeys::BBox)));
                 if (!bboxArr || bboxArr->items.size() < 4) return false;
 
-                double bx = std::dynamic_pointer_cast<PdfNumber>(resolveObj(bboxArr->items[0]))->value;
-                double by = std::dynamic_pointer_cast<PdfNumber>(resolveObj(bboxArr->items[1]))->value;
-                double bw = std::dynamic_pointer_cast<PdfNumber>(resolveObj(bboxArr->items[2]))->value;
-                double bh = std::dynamic_pointer_cast<PdfNumber>(resolveObj(bboxArr->items[3]))->value;
+                double bx = pdfCast<PdfNumber>(resolveObj(bboxArr->items[0]))->value;
+                double by = pdfCast<PdfNumber>(resolveObj(bboxArr->items[1]))->value;
+                double bw = pdfCast<PdfNumber>(resolveObj(bboxArr->items[2]))->value;
+                double bh = pdfCast<PdfNumber>(resolveObj(bboxArr->items[3]))->value;
                 double width = bw - bx;
                 double height = bh - by;
                 if (width <= 0 || height <= 0) return false;
@@ -1531,7 +1629,7 @@ namespace pdf
 
                 // Resources
                 std::vector<std::shared_ptr<PdfDictionary>> childResStack = _resStack;
-                auto rObj = patternDict->get("/Resources");
+                auto rObj = patternDict->get(PdfKeys::Resources);
                 auto patRes = resolveDict(rObj);
                 if (patRes) {
                     childResStack.push_back(patRes);
@@ -1551,33 +1649,8 @@ namespace pdf
 
                 child.parse();
 
-                // DEBUG: tile içeriğini analiz et
-                {
-                    FILE* tdbg = fopen("C:\\temp\\tile_debug.txt", "a");
-                    if (tdbg) {
-                        fprintf(tdbg, "\n=== TILE RENDER: %s (%dx%d) ===\n",
-                            name.c_str(), bufW, bufH);
-                        fprintf(tdbg, "childResStack size: %zu\n", childResStack.size());
-                        // Check buffer for non-transparent pixels
-                        const auto& rawBuf2 = tilePainter.getRawBuffer();
-                        int nonZero = 0, total = bufW * bufH;
-                        for (int i = 0; i < total && i < 100000; i++) {
-                            if (rawBuf2[i * 4 + 3] != 0) nonZero++;
-                        }
-                        fprintf(tdbg, "Non-transparent pixels (first 100k): %d / %d\n",
-                            nonZero, std::min(total, 100000));
-                        // Sample some pixels
-                        for (int sy = 0; sy < bufH; sy += bufH/5) {
-                            int sx = bufW / 2;
-                            int idx = (sy * bufW + sx) * 4;
-                            fprintf(tdbg, "  pixel(%d,%d): B=%d G=%d R=%d A=%d\n",
-                                sx, sy, rawBuf2[idx], rawBuf2[idx+1], rawBuf2[idx+2], rawBuf2[idx+3]);
-                        }
-                        fprintf(tdbg, "tilePainter.smaskWasRequested=%d\n",
-                            tilePainter.smaskWasRequested() ? 1 : 0);
-                        fclose(tdbg);
-                    }
-                }
+                PDF_TRACE(Fill, "tilePattern", "%s: %dx%d cell, smask=%d",
+                    name.c_str(), bufW, bufH, tilePainter.smaskWasRequested() ? 1 : 0);
 
                 // 4. Capture Buffer
                 pattern.buffer.resize(bufW * bufH);
@@ -1738,6 +1811,8 @@ namespace pdf
             _hasRectClipping = _hasRectClippingStack.top();
             _hasRectClippingStack.pop();
         }
+
+        syncBlendMode();
     }
 
     // =========================================================
@@ -1785,20 +1860,7 @@ namespace pdf
         _gs.fontSize = size;
         _currentFont = nullptr;
 
-        // DEBUG: Font secimi
-        {
-            static FILE* tfDbg = nullptr; // fopen("C:\\temp\\tf_debug.txt", "a");
-            if (tfDbg) {
-                fprintf(tfDbg, "Tf: fontName='%s', size=%.2f\n", fontName.c_str(), size);
-                if (_fonts) {
-                    fprintf(tfDbg, "  _fonts has %zu entries\n", _fonts->size());
-                    for (auto& kv : *_fonts) {
-                        fprintf(tfDbg, "    '%s' -> '%s'\n", kv.first.c_str(), kv.second.baseFont.c_str());
-                    }
-                }
-                fflush(tfDbg);
-            }
-        }
+        PDF_TRACE(Parse, "Tf", "%s %.2f", fontName.c_str(), size);
 
         if (_fonts)
         {
@@ -2107,7 +2169,7 @@ namespace pdf
             raw,
             effectiveFontSize,
             effectiveAdvanceSize,
-            rgbToArgb(_gs.fillColor),
+            rgbToArgbWithAlpha(_gs.fillColor, _gs.fillAlpha),
             _currentFont,
             effectiveCharSpacing,
             effectiveWordSpacing,
@@ -2143,35 +2205,14 @@ namespace pdf
 
     void PdfContentParser::op_TJ()
     {
-        auto arr = std::dynamic_pointer_cast<PdfArray>(_stack.back());
-        _stack.pop_back();
+        auto arr = popArray();
 
         if (!arr || !_painter || !_currentFont)
             return;
 
-        // ========== TJ DEBUG ==========
-        static FILE* tjDebug = nullptr;
-        if (!tjDebug) {
-            tjDebug = nullptr; // fopen("C:\\temp\\tj_debug.txt", "w");
-            if (tjDebug) {
-                fprintf(tjDebug, "=== TJ OPERATOR DEBUG ===\n");
-                fflush(tjDebug);
-            }
-        }
-        if (tjDebug) {
-            fprintf(tjDebug, "\n--- TJ Array: %zu items ---\n", arr->items.size());
-            fprintf(tjDebug, "Font: %s, encoding: %s\n",
-                _currentFont->baseFont.c_str(), _currentFont->encoding.c_str());
-            fprintf(tjDebug, "hasCodeToGid: %d, hasSimpleMap: %d\n",
-                _currentFont->hasCodeToGid ? 1 : 0, _currentFont->hasSimpleMap ? 1 : 0);
-            fprintf(tjDebug, "fontSize: %.2f, Tc: %.4f, Tw: %.4f\n",
-                _gs.fontSize, _gs.charSpacing, _gs.wordSpacing);
-            fprintf(tjDebug, "TextMatrix: [%.4f %.4f %.4f %.4f %.4f %.4f]\n",
-                _gs.textMatrix.a, _gs.textMatrix.b, _gs.textMatrix.c,
-                _gs.textMatrix.d, _gs.textMatrix.e, _gs.textMatrix.f);
-            fflush(tjDebug);
-        }
-        // ========== END DEBUG ==========
+        PDF_TRACE(Parse, "TJ", "%zu items, %s %.2f, Tc=%.4f Tw=%.4f",
+            arr->items.size(), _currentFont->baseFont.c_str(), _gs.fontSize,
+            _gs.charSpacing, _gs.wordSpacing);
 
         // Effective font size hesapla (text matrix + CTM scale dahil)
         double tmScaleY = std::sqrt(_gs.textMatrix.c * _gs.textMatrix.c +
@@ -2202,7 +2243,7 @@ namespace pdf
 
         for (auto& it : arr->items)
         {
-            if (auto s = std::dynamic_pointer_cast<PdfString>(it))
+            if (auto s = pdfCast<PdfString>(it))
             {
                 std::string raw = s->value;
                 if (raw.empty()) continue;
@@ -2228,7 +2269,7 @@ namespace pdf
                     x, y, raw,
                     effectiveFontSize,
                     effectiveAdvanceSize,
-                    rgbToArgb(_gs.fillColor),
+                    rgbToArgbWithAlpha(_gs.fillColor, _gs.fillAlpha),
                     _currentFont,
                     effectiveCharSpacing,
                     effectiveWordSpacing,
@@ -2251,7 +2292,7 @@ namespace pdf
 
                 textAdvance(_gs, adv, 0.0);
             }
-            else if (auto n = std::dynamic_pointer_cast<PdfNumber>(it))
+            else if (auto n = pdfCast<PdfNumber>(it))
             {
                 // TJ array'deki sayılar: kerning/positioning
                 // Negatif sayı: sağa ilerle, pozitif: sola geri gel
@@ -2276,42 +2317,8 @@ namespace pdf
         double y1 = popNumber();
         double x1 = popNumber();
 
-        // ========== DEBUG: op_c çağrıldı mı? ==========
-        static FILE* curveDebug = nullptr;
-        static int curveCallCount = 0;
-        if (!curveDebug) {
-            char tempPath[MAX_PATH];
-            GetTempPathA(MAX_PATH, tempPath);
-            strcat(tempPath, "curve_parse_debug.txt");
-            curveDebug = fopen(tempPath, "w");
-            if (curveDebug) {
-                fprintf(curveDebug, "=== CURVE PARSE DEBUG ===\n");
-                fprintf(curveDebug, "Log file: %s\n", tempPath);
-                fflush(curveDebug);
-            }
-        }
-        curveCallCount++;
-        if (curveDebug && curveCallCount <= 100) {
-            fprintf(curveDebug, "[op_c #%d] (%.2f,%.2f)->(%.2f,%.2f)->(%.2f,%.2f)->(%.2f,%.2f)\n",
-                curveCallCount, _cpX, _cpY, x1, y1, x2, y2, x3, y3);
-            fprintf(curveDebug, "  _currentPath.size before=%zu\n", _currentPath.size());
-            fflush(curveDebug);
-        }
-        // ========== END DEBUG ==========
-
         _currentPath.emplace_back(x1, y1, x2, y2, x3, y3);
 
-        // ========== DEBUG: Eklendi mi? ==========
-        if (curveDebug && curveCallCount <= 100) {
-            fprintf(curveDebug, "  _currentPath.size after=%zu\n", _currentPath.size());
-            if (!_currentPath.empty()) {
-                const auto& last = _currentPath.back();
-                fprintf(curveDebug, "  last segment type=%d\n", (int)last.type);
-            }
-            fflush(curveDebug);
-        }
-        // ========== END DEBUG ==========
-
         // ⚠️ KRİTİK
         _cpX = x3;
         _cpY = y3;
@@ -2336,16 +2343,8 @@ namespace pdf
             {
                 LogDebug("Pattern fill (even-odd) detected: '%s'", _gs.fillPatternName.c_str());
 
-                // DEBUG: pattern fill trace
-                {
-                    FILE* tdbg = fopen("C:\\temp\\tile_debug.txt", "a");
-                    if (tdbg) {
-                        fprintf(tdbg, "op_f_evenodd: fillPatternName='%s', path.size=%zu, fillAlpha=%.3f\n",
-                            _gs.fillPatternName.c_str(), _currentPath.size(), _gs.fillAlpha);
-                        fprintf(tdbg, "  painter=%p, isGPU=%d\n", (void*)_painter, _painter ? _painter->isGPU() : -1);
-                        fclose(tdbg);
-                    }
-                }
+                PDF_TRACE(Parse, "f*", "pattern '%s', %zu segments, alpha=%.3f",
+                    _gs.fillPatternName.c_str(), _currentPath.size(), _gs.fillAlpha);
 
                 // 1. Try Resolving Tiling Pattern (Type 1)
                 PdfPattern pattern;
@@ -2388,15 +2387,7 @@ namespace pdf
                 }
                 else
                 {
-                    // DEBUG
-                    {
-                        FILE* tdbg = fopen("C:\\temp\\tile_debug.txt", "a");
-                        if (tdbg) {
-                            fprintf(tdbg, "  resolvePatternToGradient FAILED: '%s'\n",
-                                _gs.fillPatternName.c_str());
-                            fclose(tdbg);
-                        }
-                    }
+                    PDF_TRACE(Parse, "f*", "pattern '%s' not resolved", _gs.fillPatternName.c_str());
                     LogDebug("Pattern (even-odd) could not be resolved, skipping fill");
                     _currentPath.clear();
                     return;
@@ -2420,34 +2411,7 @@ namespace pdf
 
     void PdfContentParser::op_fill_stroke()
     {
-        // ========== DEBUG: B operator tracking ==========
-        static FILE* bDebug = nullptr;
-        static int bCallCount = 0;
-        if (!bDebug) {
-            char tempPath[MAX_PATH];
-            GetTempPathA(MAX_PATH, tempPath);
-            strcat(tempPath, "b_operator_debug.txt");
-            bDebug = fopen(tempPath, "w");
-            if (bDebug) {
-                fprintf(bDebug, "=== B OPERATOR (FILL+STROKE) DEBUG ===\n");
-                fflush(bDebug);
-            }
-        }
-        bCallCount++;
-
-        if (bDebug && (bCallCount <= 50 || bCallCount % 100 == 0)) {
-            fprintf(bDebug, "[B #%d] path.size=%zu, CTM=[%.2f %.2f %.2f %.2f %.2f %.2f]\n",
-                bCallCount, _currentPath.size(),
-                _gs.ctm.a, _gs.ctm.b, _gs.ctm.c, _gs.ctm.d, _gs.ctm.e, _gs.ctm.f);
-
-            // First point if path not empty
-            if (!_currentPath.empty()) {
-                fprintf(bDebug, "  first pt: (%.2f, %.2f), painter=%p\n",
-                    _currentPath[0].x, _currentPath[0].y, (void*)_painter);
-            }
-            fflush(bDebug);
-        }
-        // ========== END DEBUG ==========
+        PDF_TRACE(Parse, "B", "%zu segments", _currentPath.size());
 
         if (_painter)
         {
@@ -2546,12 +2510,7 @@ namespace pdf
         double phase = popNumber(0.0);
 
         // Array’i popla
-        std::shared_ptr<PdfArray> arr;
-        if (!_stack.empty())
-        {
-            arr = std::dynamic_pointer_cast<PdfArray>(_stack.back());
-            _stack.pop_back();
-        }
+        std::shared_ptr<PdfArray> arr = popArray();
 
         // Render etmiyorsan bile burada bitirmen yeterli.
         // İstersen _gs içine dash pattern saklayabilirsin.
@@ -2584,882 +2543,655 @@ namespace pdf
     // Operator dispatch
     // =========================================================
 
-    void PdfContentParser::handleOperator(const std::string& op)
+    // İçerik operatörleri en fazla 3 byte ("SCN", "scn", "BDC"...). Byte'lar
+    // tek bir uint32'ye paketlenir; dispatch string karşılaştırma zinciri
+    // yerine bu anahtar üzerinde tek bir switch olur. Daha uzun kelimeler
+    // (true/false/null, bozuk içerik) 0'a düşer ve bilinmeyen sayılır.
+    static constexpr uint32_t opKey(const char* s)
     {
-        // ============ PATH OPERATORS ============
+        uint32_t key = 0;
+        for (int i = 0; i < 3 && s[i]; i++)
+            key |= (uint32_t)(uint8_t)s[i] << (8 * i);
+        return key;
+    }
+
+    static inline uint32_t packOperator(std::string_view op)
+    {
+        if (op.empty() || op.size() > 3) return 0;
+        uint32_t key = (uint8_t)op[0];
+        if (op.size() > 1) key |= (uint32_t)(uint8_t)op[1] << 8;
+        if (op.size() > 2) key |= (uint32_t)(uint8_t)op[2] << 16;
+        return key;
+    }
 
-        if (op == "BX")
+    void PdfContentParser::handleOperator(std::string_view op)
+    {
+        switch (packOperator(op))
         {
+        // ============ PATH OPERATORS ============
+
+        case opKey("BX"):
             LogDebug("BEGIN compatibility section (ignoring)");
             return; // BX başlangıcını görmezden gel
-        }
 
-        if (op == "EX")
-        {
+        case opKey("EX"):
             LogDebug("END compatibility section (ignoring)");
             return; // EX bitişini görmezden gel
-        }
 
-
-        if (op == "m")
-        {
+        case opKey("m"):
             LogDebug("PATH MoveTo");
             return op_m();
-        }
-        if (op == "l")
-        {
+        case opKey("l"):
             LogDebug("PATH LineTo");
             return op_l();
-        }
-        if (op == "c")
-        {
+        case opKey("c"):
             LogDebug("PATH CurveTo (cubic bezier)");
             return op_c();
-        }
-        if (op == "v")
-        {
+        case opKey("v"):
             LogDebug("PATH CurveTo-v (cubic variant)");
             return op_v();
-        }
-        if (op == "y")
-        {
+        case opKey("y"):
             LogDebug("PATH CurveTo-y (cubic variant)");
             return op_y();
-        }
-        if (op == "h")
-        {
+        case opKey("h"):
             LogDebug("PATH ClosePath");
             return op_h();
-        }
-        if (op == "re")
-        {
+        case opKey("re"):
             LogDebug("PATH Rectangle");
             return op_re();
-        }
 
-        if (op == "f")
-        {
+        case opKey("f"):
             LogDebug("FILL: %zu segments, color=[%.2f,%.2f,%.2f]",
                 _currentPath.size(), _gs.fillColor[0], _gs.fillColor[1], _gs.fillColor[2]);
             return op_f();
-        }
-        if (op == "f*")
-        {
+        case opKey("f*"):
             LogDebug("FILL EvenOdd: %zu segments", _currentPath.size());
             return op_f_evenodd();
-        }
-        if (op == "S")
-        {
+        case opKey("S"):
             LogDebug("STROKE: %zu segments, lw=%.2f, color=[%.2f,%.2f,%.2f]",
                 _currentPath.size(), _gs.lineWidth,
                 _gs.strokeColor[0], _gs.strokeColor[1], _gs.strokeColor[2]);
             return op_S();
-        }
-        if (op == "s")
-        {
+        case opKey("s"):
             // s = close path + stroke (equivalent to h S)
             LogDebug("CLOSE+STROKE: %zu segments", _currentPath.size());
             op_h();
             return op_S();
-        }
-        if (op == "B")
-        {
+        case opKey("B"):
             LogDebug("FILL+STROKE: %zu segments", _currentPath.size());
             return op_fill_stroke();
-        }
-        if (op == "B*")
-        {
+        case opKey("B*"):
             LogDebug("FILL+STROKE EvenOdd: %zu segments", _currentPath.size());
             return op_fill_stroke_evenodd();
-        }
-        if (op == "b")
-        {
+        case opKey("b"):
             // b = close path + fill + stroke (equivalent to h B)
             LogDebug("CLOSE+FILL+STROKE: %zu segments", _currentPath.size());
             op_h();
             return op_fill_stroke();
-        }
-        if (op == "b*")
-        {
+        case opKey("b*"):
             // b* = close path + fill (even-odd) + stroke (equivalent to h B*)
             LogDebug("CLOSE+FILL+STROKE EvenOdd: %zu segments", _currentPath.size());
             op_h();
             return op_fill_stroke_evenodd();
-        }
-        if (op == "F")
-        {
+        case opKey("F"):
             // F is equivalent to f (obsolete operator kept for compatibility)
             LogDebug("FILL (F): %zu segments", _currentPath.size());
             return op_f();
-        }
-        if (op == "W")
+
+        case opKey("W"):
+        case opKey("W*"):
         {
-            LogDebug("CLIP W: %zu segments (winding)", _currentPath.size());
-            // PDF spec: W intersects current path with existing clip (cumulative)
+            const bool evenOdd = (op.size() == 2);
+            LogDebug("CLIP %s: %zu segments (%s)", evenOdd ? "W*" : "W",
+                _currentPath.size(), evenOdd ? "even-odd" : "winding");
+            // PDF spec: W / W* intersects current path with existing clip (cumulative)
             _clippingPath = _currentPath;
             _clippingPathCTM = _gs.ctm;
             _hasClippingPath = true;
-            _clippingEvenOdd = false;
+            _clippingEvenOdd = evenOdd;
             // Push D2D clip layer for cumulative clipping (nested W operators)
             if (_painter && !_currentPath.empty()) {
-                _painter->pushClipPath(_currentPath, _gs.ctm, false);
+                _painter->pushClipPath(_currentPath, _gs.ctm, evenOdd);
                 _clipLayerCount++;
                 LogDebug("  -> Pushed clip layer #%d", _clipLayerCount);
             }
             return;
         }
 
-        // Color & Shading
-        if (op == "CS") return op_CS();
-        if (op == "cs") return op_cs();
-        if (op == "SC") return op_SC();
-        if (op == "sc") return op_sc();
-        if (op == "SCN") return op_SCN();
-        if (op == "scn") return op_scn();
-        if (op == "G") return op_G();
-        if (op == "g") return op_g();
-        if (op == "RG") return op_RG();
-        if (op == "rg") return op_rg();
-        if (op == "K") return op_K();
-        if (op == "k") return op_k();
-        // sh operator handled below with full implementation
-
-        if (op == "n")
-        {
+        case opKey("n"):
             LogDebug("PATH n (no-paint, clipping=%d, path=%zu segs)", _hasClippingPath ? 1 : 0, _currentPath.size());
             // End path without painting (used for clipping)
             _currentPath.clear();
             return;
-        }
 
-        if (op == "W*")
+        // ============ COLOR & SHADING ============
+        case opKey("CS"):  return op_CS();
+        case opKey("cs"):  return op_cs();
+        case opKey("SC"):  return op_SC();
+        case opKey("sc"):  return op_sc();
+        case opKey("SCN"): return op_SCN();
+        case opKey("scn"): return op_scn();
+        case opKey("G"):   return op_G();
+        case opKey("g"):   return op_g();
+        case opKey("RG"):  return op_RG();
+        case opKey("rg"):  return op_rg();
+        case opKey("K"):   return op_K();
+        case opKey("k"):   return op_k();
+        case opKey("sh"):  return op_sh_clip();
+
+        // ============ GRAPHICS STATE ============
+        case opKey("q"):  return op_q();
+        case opKey("Q"):  return op_Q();
+        case opKey("cm"): return op_cm();
+        case opKey("w"):  return op_w();
+        case opKey("J"):  return op_J();
+        case opKey("j"):  return op_j();
+        case opKey("M"):  return op_M();
+        case opKey("d"):  return op_d();
+        case opKey("gs"): return op_gs();
+
+        // ============ TEXT OPERATORS ============
+        case opKey("BT"): return op_BT();
+        case opKey("ET"): return op_ET();
+        case opKey("Tf"): return op_Tf();
+        case opKey("TL"): return op_TL();
+        case opKey("Tm"): return op_Tm();
+        case opKey("Td"): return op_Td();
+        case opKey("TD"):
         {
-            LogDebug("CLIP W*: %zu segments (even-odd)", _currentPath.size());
-            // PDF spec: W* intersects current path with existing clip using even-odd rule
-            _clippingPath = _currentPath;
-            _clippingPathCTM = _gs.ctm;
-            _hasClippingPath = true;
-            _clippingEvenOdd = true;
-            // Push D2D clip layer for cumulative clipping (nested W* operators)
-            if (_painter && !_currentPath.empty()) {
-                _painter->pushClipPath(_currentPath, _gs.ctm, true);
-                _clipLayerCount++;
-                LogDebug("  -> Pushed clip layer #%d (even-odd)", _clipLayerCount);
-            }
+            // TD is same as Td but also sets TL = -ty
+            double ty = popNumber();
+            double tx = popNumber();
+            _gs.leading = -ty;
+            _gs.textLineMatrix.e += tx * _gs.textLineMatrix.a + ty * _gs.textLineMatrix.c;
+            _gs.textLineMatrix.f += tx * _gs.textLineMatrix.b + ty * _gs.textLineMatrix.d;
+            _gs.textMatrix = _gs.textLineMatrix;
+            _gs.textPosX = _gs.textMatrix.e;
+            _gs.textPosY = _gs.textMatrix.f;
             return;
         }
-
-        // PdfContentParser.cpp - sh operatörü için düzeltme
- // handleOperator fonksiyonundaki if (op == "sh") bloğunu bu kodla değiştir
-
-        if (op == "sh")
+        case opKey("T*"): return op_Tstar();
+        case opKey("Tj"): return op_Tj();
+        case opKey("TJ"): return op_TJ();
+        case opKey("'"):
         {
-            std::string shadingName = popName();
-            LogDebug("========== SHADING OPERATOR: '%s' ==========", shadingName.c_str());
-
-            // ========== DEBUG: sh operatörü path durumu ==========
-            static FILE* shDebug = nullptr;
-            static int shCallCount = 0;
-            if (!shDebug) {
-                char tempPath[MAX_PATH];
-                GetTempPathA(MAX_PATH, tempPath);
-                strcat(tempPath, "sh_debug.txt");
-                shDebug = fopen(tempPath, "w");
-                if (shDebug) {
-                    fprintf(shDebug, "=== SH OPERATOR DEBUG ===\n");
-                    fflush(shDebug);
-                }
-            }
-            shCallCount++;
-
-            // _clippingPath segment sayıları
-            int clipCurves = 0, clipLines = 0, clipMoves = 0;
-            for (const auto& seg : _clippingPath) {
-                if (seg.type == PdfPathSegment::CurveTo) clipCurves++;
-                else if (seg.type == PdfPathSegment::LineTo) clipLines++;
-                else if (seg.type == PdfPathSegment::MoveTo) clipMoves++;
-            }
-
-            // _currentPath segment sayıları
-            int curCurves = 0, curLines = 0, curMoves = 0;
-            for (const auto& seg : _currentPath) {
-                if (seg.type == PdfPathSegment::CurveTo) curCurves++;
-                else if (seg.type == PdfPathSegment::LineTo) curLines++;
-                else if (seg.type == PdfPathSegment::MoveTo) curMoves++;
-            }
-
-            if (shDebug) {
-                fprintf(shDebug, "\n[sh #%d] shadingName='%s'\n", shCallCount, shadingName.c_str());
-                fprintf(shDebug, "  _hasClippingPath=%d\n", _hasClippingPath ? 1 : 0);
-                fprintf(shDebug, "  _clippingPath: size=%zu, moves=%d, lines=%d, CURVES=%d\n",
-                    _clippingPath.size(), clipMoves, clipLines, clipCurves);
-                fprintf(shDebug, "  _currentPath:  size=%zu, moves=%d, lines=%d, CURVES=%d\n",
-                    _currentPath.size(), curMoves, curLines, curCurves);
-                fprintf(shDebug, "  _clippingPathCTM=[%.4f %.4f %.4f %.4f %.4f %.4f]\n",
-                    _clippingPathCTM.a, _clippingPathCTM.b, _clippingPathCTM.c,
-                    _clippingPathCTM.d, _clippingPathCTM.e, _clippingPathCTM.f);
-                fprintf(shDebug, "  _gs.ctm=[%.4f %.4f %.4f %.4f %.4f %.4f]\n",
-                    _gs.ctm.a, _gs.ctm.b, _gs.ctm.c, _gs.ctm.d, _gs.ctm.e, _gs.ctm.f);
-                fflush(shDebug);
-            }
-            // ========== END DEBUG ==========
-
-            PdfMatrix shadingCTM = _gs.ctm;
-
-            if (!_painter)
-            {
-                _currentPath.clear();
-                return;
-            }
-
-            // Clipping path kontrolü
-            if (!_hasClippingPath || _clippingPath.empty())
-            {
-                if (shDebug) {
-                    fprintf(shDebug, "  -> Using _currentPath as clipping (hasClip=%d, clipEmpty=%d)\n",
-                        _hasClippingPath ? 1 : 0, _clippingPath.empty() ? 1 : 0);
-                    fflush(shDebug);
-                }
-                if (_currentPath.empty()) return;
-                _clippingPath = _currentPath;
-                _clippingPathCTM = _gs.ctm;
-                _hasClippingPath = true;
-            }
-
-            // ===== SHADING DICTIONARY BUL =====
-            std::shared_ptr<PdfDictionary> shadingDict;
-
-            for (auto it = _resStack.rbegin(); it != _resStack.rend(); ++it)
-            {
-                auto res = *it;
-                if (!res) continue;
-
-                auto shDict = resolveDict(res->get("/Shading"));
-                if (!shDict) continue;
-
-                auto shObj = resolveObj(shDict->get(shadingName));
-                shadingDict = std::dynamic_pointer_cast<PdfDictionary>(shObj);
-
-                if (shadingDict) break;
-            }
-
-            if (!shadingDict)
-            {
-                _currentPath.clear();
-                return;
-            }
-
-            // ===== SHADING TYPE =====
-            auto typeObj = std::dynamic_pointer_cast<PdfNumber>(
-                resolveObj(shadingDict->get("/ShadingType")));
+            // ' (single quote): Move to next line and show text
+            // Equivalent to: T*  string Tj
+            double tx = 0.0;
+            double ty = -_gs.leading;
+            _gs.textLineMatrix.e += tx * _gs.textLineMatrix.a + ty * _gs.textLineMatrix.c;
+            _gs.textLineMatrix.f += tx * _gs.textLineMatrix.b + ty * _gs.textLineMatrix.d;
+            _gs.textMatrix = _gs.textLineMatrix;
+            _gs.textPosX = _gs.textMatrix.e;
+            _gs.textPosY = _gs.textMatrix.f;
+            op_Tj();
+            return;
+        }
+        case opKey("\""):
+        {
+            // " (double quote): Set word/char spacing, move to next line, show text
+            // Equivalent to: aw Tw  ac Tc  string '
+            std::string raw = popString();
+            double ac = popNumber();
+            double aw = popNumber();
+            _gs.wordSpacing = aw;
+            _gs.charSpacing = ac;
+            double tx = 0.0;
+            double ty = -_gs.leading;
+            _gs.textLineMatrix.e += tx * _gs.textLineMatrix.a + ty * _gs.textLineMatrix.c;
+            _gs.textLineMatrix.f += tx * _gs.textLineMatrix.b + ty * _gs.textLineMatrix.d;
+            _gs.textMatrix = _gs.textLineMatrix;
+            _gs.textPosX = _gs.textMatrix.e;
+            _gs.textPosY = _gs.textMatrix.f;
+            pushString(raw, true);
+            op_Tj();
+            return;
+        }
+        case opKey("Tc"): _gs.charSpacing = popNumber(0.0); return;
+        case opKey("Tw"): _gs.wordSpacing = popNumber(0.0); return;
+        case opKey("Tz"): _gs.horizontalScale = popNumber(100.0); return;
+        case opKey("Ts"): _gs.textRise = popNumber(0.0); return;
 
-            int shadingType = typeObj ? (int)typeObj->value : 0;
+        // ============ TYPE3 GLYPH OPERATORS ============
+        case opKey("d0"):
+            // d0: wx wy - set glyph width (Type3 CharProc)
+            popNumber(); // wy
+            popNumber(); // wx
+            return;
+        case opKey("d1"):
+            // d1: wx wy llx lly urx ury - set glyph width and bbox (Type3 CharProc)
+            popNumber(); // ury
+            popNumber(); // urx
+            popNumber(); // lly
+            popNumber(); // llx
+            popNumber(); // wy
+            popNumber(); // wx
+            return;
 
-            if (shadingType != 2 && shadingType != 3)
+        // ============ XOBJECT ============
+        case opKey("Do"):
+        {
+            if (_stack.empty())
             {
-                _currentPath.clear();
+                LogDebug("ERROR: 'Do' with empty stack!");
                 return;
             }
 
-            // ===== COLOR SPACE =====
-            auto csObj = resolveObj(shadingDict->get("/ColorSpace"));
-            int numComponents = 3;
-            bool isDeviceN = false;
-            std::vector<std::string> deviceNNames;
-
-            if (csObj)
-            {
-                if (auto csName = std::dynamic_pointer_cast<PdfName>(csObj))
-                {
-                    std::string cs = csName->value;
-                    if (cs == "/DeviceGray" || cs == "DeviceGray")
-                        numComponents = 1;
-                    else if (cs == "/DeviceCMYK" || cs == "DeviceCMYK")
-                        numComponents = 4;
-                }
-                else if (auto csArr = std::dynamic_pointer_cast<PdfArray>(csObj))
-                {
-                    if (!csArr->items.empty())
-                    {
-                        auto first = std::dynamic_pointer_cast<PdfName>(
-                            resolveObj(csArr->items[0]));
-                        if (first)
-                        {
-                            std::string csType = first->value;
-                            if (csType == "/ICCBased" || csType == "ICCBased")
-                            {
-                                if (csArr->items.size() >= 2)
-                                {
-                                    auto iccStream = std::dynamic_pointer_cast<PdfStream>(
-                                        resolveObj(csArr->items[1]));
-                                    if (iccStream && iccStream->dict)
-                                    {
-                                        auto nObj = std::dynamic_pointer_cast<PdfNumber>(
-                                            resolveObj(iccStream->dict->get("/N")));
-                                        if (nObj)
-                                            numComponents = (int)nObj->value;
-                                    }
-                                }
-                            }
-                            else if (csType == "/Separation" || csType == "Separation")
-                            {
-                                numComponents = 1;
-                            }
-                            // DeviceN: [/DeviceN names alternateSpace tintTransform]
-                            else if (csType == "/DeviceN" || csType == "DeviceN")
-                            {
-                                LogDebug("  DeviceN color space detected");
-                                isDeviceN = true;
-
-                                // Get names array (2nd element, index 1)
-                                if (csArr->items.size() >= 2)
-                                {
-                                    auto namesArr = std::dynamic_pointer_cast<PdfArray>(
-                                        resolveObj(csArr->items[1]));
-                                    if (namesArr)
-                                    {
-                                        for (auto& item : namesArr->items)
-                                        {
-                                            if (auto nameObj = std::dynamic_pointer_cast<PdfName>(
-                                                resolveObj(item)))
-                                            {
-                                                deviceNNames.push_back(nameObj->value);
-                                                LogDebug("    DeviceN name: %s", nameObj->value.c_str());
-                                            }
-                                        }
-                                        numComponents = (int)deviceNNames.size();
-                                        LogDebug("  DeviceN has %zu color names, numComponents=%d",
-                                            deviceNNames.size(), numComponents);
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-
-            // ===== COORDS (6 elemanlı - radial için) =====
-            auto coordsArr = std::dynamic_pointer_cast<PdfArray>(
-                resolveObj(shadingDict->get("/Coords")));
-
-            if (!coordsArr || coordsArr->items.size() < 4)
+            if (_stack.back().kind != PdfOperand::Kind::Name)
             {
-                _currentPath.clear();
+                _stack.pop_back();
+                LogDebug("ERROR: 'Do' with non-name object!");
                 return;
             }
 
-            std::vector<double> coords(6, 0.0);
-            for (size_t i = 0; i < coordsArr->items.size() && i < 6; ++i)
-            {
-                if (auto n = std::dynamic_pointer_cast<PdfNumber>(
-                    resolveObj(coordsArr->items[i])))
-                {
-                    coords[i] = n->value;
-                }
-            }
-
-            // ===== GRADIENT OLUŞTUR (YENİ API - LUT dahil) =====
-            PdfGradient gradient;
-            gradient.type = shadingType;
+            std::string xName = popName();
+            LogDebug("XObject Do: '%s'", xName.c_str());
+            renderXObjectDo(xName);
+            return;
+        }
 
-            if (shadingType == 2)
-            {
-                // Axial: x0, y0, x1, y1
-                gradient.x0 = coords[0];
-                gradient.y0 = coords[1];
-                gradient.x1 = coords[2];
-                gradient.y1 = coords[3];
-            }
-            else if (shadingType == 3)
-            {
-                // Radial: x0, y0, r0, x1, y1, r1
-                gradient.x0 = coords[0];
-                gradient.y0 = coords[1];
-                gradient.r0 = coords[2];
-                gradient.x1 = coords[3];
-                gradient.y1 = coords[4];
-                gradient.r1 = coords[5];
-            }
+        default:
+            break;
+        }
 
-            // ===== FUNCTION PARSE (LUT oluşturulacak) =====
-            auto funcObj = resolveObj(shadingDict->get("/Function"));
+        // ============ UNSUPPORTED ============
+        static thread_local std::map<std::string, int> unsupported;
+        if (unsupported[std::string(op)]++ < 2)
+        {
+            LogDebug("UNSUPPORTED: '%.*s'", (int)op.size(), op.data());
+        }
+    }
 
-            bool parseSuccess = false;
-            if (isDeviceN && !deviceNNames.empty())
-            {
-                // Use DeviceN-specific parsing
-                LogDebug("Using DeviceN gradient parsing for %zu components", deviceNNames.size());
-                parseSuccess = PdfGradient::parseFunctionToGradientDeviceN(funcObj, _doc, gradient, deviceNNames);
-            }
-            else
-            {
-                // Standard parsing
-                parseSuccess = PdfGradient::parseFunctionToGradient(funcObj, _doc, gradient, numComponents);
-            }
+    // sh: aktif clip bölgesini shading ile doldurur
+    void PdfContentParser::op_sh_clip()
+    {
+        std::string shadingName = popName();
+        LogDebug("========== SHADING OPERATOR: '%s' ==========", shadingName.c_str());
 
-            if (!parseSuccess)
-            {
-                // Fallback
-                GradientStop s0, s1;
-                s0.position = 0.0;
-                s0.rgb[0] = s0.rgb[1] = s0.rgb[2] = 1.0;
-                s1.position = 1.0;
-                s1.rgb[0] = s1.rgb[1] = s1.rgb[2] = 0.0;
-                gradient.stops.push_back(s0);
-                gradient.stops.push_back(s1);
-            }
+        PDF_TRACE_SCOPE(Shading, "sh", "%s, clip %zu segments, path %zu segments",
+            shadingName.c_str(), _hasClippingPath ? _clippingPath.size() : (size_t)0, _currentPath.size());
 
-            LogDebug("Gradient parsed: type=%d, stops=%zu, hasLUT=%d",
-                gradient.type, gradient.stops.size(), gradient.hasLUT ? 1 : 0);
-
-            // ===== RENDER =====
-            // sh fills the entire clip region with the shading
-            // D2D clip layers handle the clipping, so use _clippingPath as fill region
-            // (it's the most recent clip path, defining the area to fill)
-            _painter->fillPathWithGradient(
-                _clippingPath,
-                gradient,
-                _clippingPathCTM,
-                shadingCTM,
-                false,
-                (float)_gs.fillAlpha
-            );
+        PdfMatrix shadingCTM = _gs.ctm;
 
+        if (!_painter)
+        {
             _currentPath.clear();
             return;
         }
 
-        // ============ GRAPHICS STATE ============
-        if (op == "q")  return op_q();
-        if (op == "Q")  return op_Q();
-        if (op == "cm") return op_cm();
-        if (op == "w")  return op_w();
-        if (op == "J")  return op_J();
-        if (op == "j")  return op_j();
-        if (op == "M")  return op_M();
-        if (op == "d")  return op_d();
-
-        // ExtGState operator: /GS0 gs
-        if (op == "gs")
+        // Clipping path kontrolü
+        if (!_hasClippingPath || _clippingPath.empty())
         {
-            std::string gsName = popName();
-            LogDebug("EXTGSTATE: '%s'", gsName.c_str());
+            if (_currentPath.empty()) return;
+            _clippingPath = _currentPath;
+            _clippingPathCTM = _gs.ctm;
+            _hasClippingPath = true;
+        }
 
-            // Find ExtGState in resources
-            for (auto it = _resStack.rbegin(); it != _resStack.rend(); ++it)
-            {
-                auto res = *it;
-                if (!res) continue;
+        // ===== SHADING DICTIONARY BUL =====
+        std::shared_ptr<PdfDictionary> shadingDict;
 
-                auto extGStateDict = resolveDict(res->get("/ExtGState"));
-                if (!extGStateDict) continue;
+        for (auto it = _resStack.rbegin(); it != _resStack.rend(); ++it)
+        {
+            auto res = *it;
+            if (!res) continue;
 
-                auto gsObj = resolveDict(extGStateDict->get(gsName));
-                if (!gsObj) continue;
+            auto shDict = resolveDict(res->get(PdfKeys::Shading));
+            if (!shDict) continue;
 
-                // Parse ExtGState parameters
-                // CA - stroke alpha
-                if (auto caStroke = std::dynamic_pointer_cast<PdfNumber>(resolveObj(gsObj->get("/CA"))))
-                {
-                    _gs.strokeAlpha = std::clamp(caStroke->value, 0.0, 1.0);
-                    LogDebug("  Stroke alpha (CA): %.2f", _gs.strokeAlpha);
-                }
+            auto shObj = resolveObj(shDict->get(shadingName));
+            shadingDict = pdfCast<PdfDictionary>(shObj);
 
-                // ca - fill alpha
-                if (auto caFill = std::dynamic_pointer_cast<PdfNumber>(resolveObj(gsObj->get("/ca"))))
-                {
-                    _gs.fillAlpha = std::clamp(caFill->value, 0.0, 1.0);
-                    LogDebug("  Fill alpha (ca): %.2f", _gs.fillAlpha);
-                }
+            if (shadingDict) break;
+        }
 
-                // BM - blend mode (log only for now)
-                if (auto bmName = std::dynamic_pointer_cast<PdfName>(resolveObj(gsObj->get("/BM"))))
-                {
-                    std::string bm = bmName->value;
-                    LogDebug("  Blend mode (BM): %s", bm.c_str());
-                    // Store for future use
-                    _gs.blendMode = bm;
-                }
+        if (!shadingDict)
+        {
+            _currentPath.clear();
+            return;
+        }
 
-                // LW - line width
-                if (auto lwNum = std::dynamic_pointer_cast<PdfNumber>(resolveObj(gsObj->get("/LW"))))
-                {
-                    _gs.lineWidth = lwNum->value;
-                    LogDebug("  Line width (LW): %.2f", _gs.lineWidth);
-                }
+        // ===== SHADING TYPE =====
+        auto typeObj = pdfCast<PdfNumber>(
+            resolveObj(shadingDict->get(PdfKeys::ShadingType)));
 
-                // LC - line cap
-                if (auto lcNum = std::dynamic_pointer_cast<PdfNumber>(resolveObj(gsObj->get("/LC"))))
-                {
-                    _gs.lineCap = (int)lcNum->value;
-                }
+        int shadingType = typeObj ? (int)typeObj->value : 0;
 
-                // LJ - line join
-                if (auto ljNum = std::dynamic_pointer_cast<PdfNumber>(resolveObj(gsObj->get("/LJ"))))
-                {
-                    _gs.lineJoin = (int)ljNum->value;
-                }
+        if (shadingType != 2 && shadingType != 3)
+        {
+            _currentPath.clear();
+            return;
+        }
 
-                // ML - miter limit
-                if (auto mlNum = std::dynamic_pointer_cast<PdfNumber>(resolveObj(gsObj->get("/ML"))))
-                {
-                    _gs.miterLimit = mlNum->value;
-                }
+        // ===== COLOR SPACE =====
+        auto csObj = resolveObj(shadingDict->get(PdfKeys::ColorSpace));
+        int numComponents = 3;
+        bool isDeviceN = false;
+        std::vector<std::string> deviceNNames;
 
-                // ===== SMask - Soft Mask =====
+        if (csObj)
+        {
+            if (auto csName = pdfCast<PdfName>(csObj))
+            {
+                std::string cs = csName->value;
+                if (cs == "/DeviceGray")
+                    numComponents = 1;
+                else if (cs == "/DeviceCMYK")
+                    numComponents = 4;
+            }
+            else if (auto csArr = pdfCast<PdfArray>(csObj))
+            {
+                if (!csArr->items.empty())
                 {
-                    auto smaskObj = resolveObj(gsObj->get("/SMask"));
-                    if (smaskObj)
+                    auto first = pdfCast<PdfName>(
+                        resolveObj(csArr->items[0]));
+                    if (first)
                     {
-                        // Check for /SMask /None - this removes the current soft mask
-                        auto smaskName = std::dynamic_pointer_cast<PdfName>(smaskObj);
-                        if (smaskName && (smaskName->value == "/None" || smaskName->value == "None"))
+                        std::string csType = first->value;
+                        if (csType == "/ICCBased")
                         {
-                            LogDebug("  SMask: /None - popping soft mask");
-                            if (_gs.hasSMask && _painter)
+                            if (csArr->items.size() >= 2)
                             {
-                                _painter->popSoftMask();
-                                if (_smaskLayerCount > 0) _smaskLayerCount--;
-                                _gs.hasSMask = false;
+                                auto iccStream = pdfCast<PdfStream>(
+                                    resolveObj(csArr->items[1]));
+                                if (iccStream && iccStream->dict)
+                                {
+                                    auto nObj = pdfCast<PdfNumber>(
+                                        resolveObj(iccStream->dict->get(PdfKeys::N)));
+                                    if (nObj)
+                                        numComponents = (int)nObj->value;
+                                }
                             }
                         }
-                        else
+                        else if (csType == "/Separation")
                         {
-                            // SMask is a dictionary: << /Type /Mask /S /Luminosity /G <ref> >>
-                            auto smaskDict = std::dynamic_pointer_cast<PdfDictionary>(smaskObj);
-                            if (smaskDict)
-                            {
-                                // Get subtype (S): /Luminosity or /Alpha
-                                auto sType = std::dynamic_pointer_cast<PdfName>(resolveObj(smaskDict->get("/S")));
-                                std::string maskType = sType ? sType->value : "";
-                                LogDebug("  SMask type: %s", maskType.c_str());
-
-                                // Get the Form XObject reference (/G)
-                                auto gObj = resolveObj(smaskDict->get("/G"));
-                                auto gStream = std::dynamic_pointer_cast<PdfStream>(gObj);
+                            numComponents = 1;
+                        }
+                        // DeviceN: [/DeviceN names alternateSpace tintTransform]
+                        else if (csType == "/DeviceN")
+                        {
+                            LogDebug("  DeviceN color space detected");
+                            isDeviceN = true;
 
-                                if (gStream && gStream->dict)
+                            // Get names array (2nd element, index 1)
+                            if (csArr->items.size() >= 2)
+                            {
+                                auto namesArr = pdfCast<PdfArray>(
+                                    resolveObj(csArr->items[1]));
+                                if (namesArr)
                                 {
-                                    LogDebug("  SMask /G: Form XObject found");
-
-                                    // Render the Form XObject to a luminosity mask bitmap
-                                    std::vector<uint8_t> maskAlpha;
-                                    int maskW = 0, maskH = 0;
-
-                                    if (renderFormToLuminosityMask(gStream, maskAlpha, maskW, maskH))
+                                    for (auto& item : namesArr->items)
                                     {
-                                        LogDebug("  SMask: Rendered mask %dx%d", maskW, maskH);
-
-                                        // Pop previous mask if one was active (SMask replaces, not stacks)
-                                        if (_gs.hasSMask && _painter)
-                                        {
-                                            _painter->popSoftMask();
-                                            if (_smaskLayerCount > 0) _smaskLayerCount--;
-                                        }
-
-                                        // Push the new soft mask
-                                        if (_painter)
+                                        if (auto nameObj = pdfCast<PdfName>(
+                                            resolveObj(item)))
                                         {
-                                            _painter->pushSoftMask(maskAlpha, maskW, maskH);
-                                            _smaskLayerCount++;
-                                            _gs.hasSMask = true;
+                                            deviceNNames.push_back(nameObj->value);
+                                            LogDebug("    DeviceN name: %s", nameObj->value.c_str());
                                         }
                                     }
-                                    else
-                                    {
-                                        LogDebug("  SMask: Failed to render mask Form XObject");
-                                    }
-                                }
-                                else
-                                {
-                                    LogDebug("  SMask: /G is not a valid Form XObject");
+                                    numComponents = (int)deviceNNames.size();
+                                    LogDebug("  DeviceN has %zu color names, numComponents=%d",
+                                        deviceNNames.size(), numComponents);
                                 }
                             }
                         }
                     }
                 }
-
-                break;
             }
-            return;
         }
 
-        // ============ COLOR OPERATORS ============
-        if (op == "g")
+        // ===== COORDS (6 elemanlı - radial için) =====
+        auto coordsArr = pdfCast<PdfArray>(
+            resolveObj(shadingDict->get(PdfKeys::Coords)));
+
+        if (!coordsArr || coordsArr->items.size() < 4)
         {
-            double gray = popNumber(0.0);
-            gray = std::clamp(gray, 0.0, 1.0);
-            _gs.fillColor[0] = gray;
-            _gs.fillColor[1] = gray;
-            _gs.fillColor[2] = gray;
+            _currentPath.clear();
             return;
         }
-        if (op == "G")
+
+        std::vector<double> coords(6, 0.0);
+        for (size_t i = 0; i < coordsArr->items.size() && i < 6; ++i)
         {
-            double gray = popNumber(0.0);
-            gray = std::clamp(gray, 0.0, 1.0);
-            _gs.strokeColor[0] = gray;
-            _gs.strokeColor[1] = gray;
-            _gs.strokeColor[2] = gray;
-            return;
+            if (auto n = pdfCast<PdfNumber>(
+                resolveObj(coordsArr->items[i])))
+            {
+                coords[i] = n->value;
+            }
         }
-        if (op == "rg")
+
+        // ===== GRADIENT OLUŞTUR (YENİ API - LUT dahil) =====
+        PdfGradient gradient;
+        gradient.type = shadingType;
+
+        if (shadingType == 2)
         {
-            double b = popNumber();
-            double g = popNumber();
-            double r = popNumber();
-            _gs.fillColor[0] = r;
-            _gs.fillColor[1] = g;
-            _gs.fillColor[2] = b;
-            return;
+            // Axial: x0, y0, x1, y1
+            gradient.x0 = coords[0];
+            gradient.y0 = coords[1];
+            gradient.x1 = coords[2];
+            gradient.y1 = coords[3];
         }
-        if (op == "RG")
+        else if (shadingType == 3)
         {
-            double b = popNumber();
-            double g = popNumber();
-            double r = popNumber();
-            _gs.strokeColor[0] = r;
-            _gs.strokeColor[1] = g;
-            _gs.strokeColor[2] = b;
-            return;
+            // Radial: x0, y0, r0, x1, y1, r1
+            gradient.x0 = coords[0];
+            gradient.y0 = coords[1];
+            gradient.r0 = coords[2];
+            gradient.x1 = coords[3];
+            gradient.y1 = coords[4];
+            gradient.r1 = coords[5];
         }
-        if (op == "k")
+
+        // ===== FUNCTION PARSE (LUT oluşturulacak) =====
+        auto funcObj = resolveObj(shadingDict->get(PdfKeys::Function));
+
+        bool parseSuccess = false;
+        if (isDeviceN && !deviceNNames.empty())
         {
-            double k = popNumber();
-            double y = popNumber();
-            double m = popNumber();
-            double c = popNumber();
-            cmykToRgb(c, m, y, k, _gs.fillColor);
-            return;
+            // Use DeviceN-specific parsing
+            LogDebug("Using DeviceN gradient parsing for %zu components", deviceNNames.size());
+            parseSuccess = PdfGradient::parseFunctionToGradientDeviceN(funcObj, _doc, gradient, deviceNNames);
         }
-        if (op == "K")
+        else
         {
-            double k = popNumber();
-            double y = popNumber();
-            double m = popNumber();
-            double c = popNumber();
-            cmykToRgb(c, m, y, k, _gs.strokeColor);
-            return;
+            // Standard parsing
+            parseSuccess = PdfGradient::parseFunctionToGradient(funcObj, _doc, gradient, numComponents);
         }
-        if (op == "cs" || op == "CS")
+
+        if (!parseSuccess)
         {
-            std::string csName = popName();
-            bool isFill = (op == "cs");
+            // Fallback
+            GradientStop s0, s1;
+            s0.position = 0.0;
+            s0.rgb[0] = s0.rgb[1] = s0.rgb[2] = 1.0;
+            s1.position = 1.0;
+            s1.rgb[0] = s1.rgb[1] = s1.rgb[2] = 0.0;
+            gradient.stops.push_back(s0);
+            gradient.stops.push_back(s1);
+        }
+
+        LogDebug("Gradient parsed: type=%d, stops=%zu, hasLUT=%d",
+            gradient.type, gradient.stops.size(), gradient.hasLUT ? 1 : 0);
+
+        // ===== RENDER =====
+        // sh fills the entire clip region with the shading
+        // D2D clip layers handle the clipping, so use _clippingPath as fill region
+        // (it's the most recent clip path, defining the area to fill)
+        _painter->fillPathWithGradient(
+            _clippingPath,
+            gradient,
+            _clippingPathCTM,
+            shadingCTM,
+            false,
+            (float)_gs.fillAlpha
+        );
 
-            LogDebug("ColorSpace %s: '%s'", isFill ? "fill" : "stroke", csName.c_str());
+        _currentPath.clear();
+    }
 
-            if (isFill) {
-                _gs.fillColorSpace = csName;
-            }
-            else {
-                _gs.strokeColorSpace = csName;
-            }
-            return;
-        }
+    // ExtGState operator: /GS0 gs
+    void PdfContentParser::op_gs()
+    {
+        std::string gsName = popName();
+        LogDebug("EXTGSTATE: '%s'", gsName.c_str());
 
-        // SC, SCN, sc, scn (color with colorspace)
-        bool isStroke = (op == "SC" || op == "SCN");
-        bool isFill = (op == "sc" || op == "scn");
-        if (isStroke || isFill)
+        // Find ExtGState in resources
+        for (auto it = _resStack.rbegin(); it != _resStack.rend(); ++it)
         {
-            // ✅ Pattern kontrolü - stack'te Name varsa Pattern olabilir
-            if (!_stack.empty()) {
-                auto nameObj = std::dynamic_pointer_cast<PdfName>(_stack.back());
-                if (nameObj) {
-                    std::string patternName = nameObj->value;
-                    _stack.pop_back();
+            auto res = *it;
+            if (!res) continue;
 
-                    LogDebug("Pattern %s: '%s'", isFill ? "fill" : "stroke", patternName.c_str());
+            auto extGStateDict = resolveDict(res->get(PdfKeys::ExtGState));
+            if (!extGStateDict) continue;
 
-                    if (isFill) {
-                        _gs.fillPatternName = patternName;
-                    }
-                    else {
-                        _gs.strokePatternName = patternName;
-                    }
-                    return;
-                }
+            auto gsObj = resolveDict(extGStateDict->get(gsName));
+            if (!gsObj) continue;
+
+            // Parse ExtGState parameters
+            // CA - stroke alpha
+            if (auto caStroke = pdfCast<PdfNumber>(resolveObj(gsObj->get(PdfKeys::CA))))
+            {
+                _gs.strokeAlpha = std::clamp(caStroke->value, 0.0, 1.0);
+                LogDebug("  Stroke alpha (CA): %.2f", _gs.strokeAlpha);
             }
 
-            int numArgs = 0;
-            for (int i = (int)_stack.size() - 1; i >= 0; --i)
+            // ca - fill alpha
+            if (auto caFill = pdfCast<PdfNumber>(resolveObj(gsObj->get(PdfKeys::ca))))
             {
-                if (std::dynamic_pointer_cast<PdfNumber>(_stack[i]))
-                    numArgs++;
-                else
-                    break;
+                _gs.fillAlpha = std::clamp(caFill->value, 0.0, 1.0);
+                LogDebug("  Fill alpha (ca): %.2f", _gs.fillAlpha);
             }
 
-            if (numArgs == 1) // Gray
+            // BM - blend mode: a name, or an array to take the first
+            // known mode from (unknown names leave the mode as it is)
             {
-                double val = popNumber(0.0);
-                val = std::clamp(val, 0.0, 1.0);
-                if (isFill) {
-                    _gs.fillColor[0] = val; _gs.fillColor[1] = val; _gs.fillColor[2] = val;
-                    _gs.fillPatternName.clear();  // Pattern temizle
+                auto bmObj = resolveObj(gsObj->get(PdfKeys::BM));
+                if (auto bmName = pdfCast<PdfName>(bmObj))
+                {
+                    blendModeFromName(bmName->value, _gs.blendMode);
                 }
-                else {
-                    _gs.strokeColor[0] = val; _gs.strokeColor[1] = val; _gs.strokeColor[2] = val;
-                    _gs.strokePatternName.clear();
+                else if (auto bmArr = pdfCast<PdfArray>(bmObj))
+                {
+                    for (const auto& item : bmArr->items)
+                    {
+                        auto n = pdfCast<PdfName>(resolveObj(item));
+                        if (n && blendModeFromName(n->value, _gs.blendMode))
+                            break;
+                    }
                 }
+                if (bmObj)
+                    LogDebug("  Blend mode (BM): %s", blendModeName(_gs.blendMode));
             }
-            else if (numArgs == 3) // RGB
+
+            // LW - line width
+            if (auto lwNum = pdfCast<PdfNumber>(resolveObj(gsObj->get(PdfKeys::LW))))
             {
-                double b = popNumber(0.0);
-                double g = popNumber(0.0);
-                double r = popNumber(0.0);
+                _gs.lineWidth = lwNum->value;
+                LogDebug("  Line width (LW): %.2f", _gs.lineWidth);
+            }
 
-                // DEBUG: Log gold color detection
-                if (r > 0.7 && g > 0.5 && b < 0.2) {
-                    LogDebug("*** GOLD COLOR DETECTED: R=%.3f G=%.3f B=%.3f (stroke=%d) ***", r, g, b, isStroke ? 1 : 0);
-                }
+            // LC - line cap
+            if (auto lcNum = pdfCast<PdfNumber>(resolveObj(gsObj->get(PdfKeys::LC))))
+            {
+                _gs.lineCap = (int)lcNum->value;
+            }
 
-                if (isFill) {
-                    _gs.fillColor[0] = r; _gs.fillColor[1] = g; _gs.fillColor[2] = b;
-                    _gs.fillPatternName.clear();
-                }
-                else {
-                    _gs.strokeColor[0] = r; _gs.strokeColor[1] = g; _gs.strokeColor[2] = b;
-                    _gs.strokePatternName.clear();
-                    LogDebug("Stroke color set: R=%.3f G=%.3f B=%.3f", r, g, b);
-                }
+            // LJ - line join
+            if (auto ljNum = pdfCast<PdfNumber>(resolveObj(gsObj->get(PdfKeys::LJ))))
+            {
+                _gs.lineJoin = (int)ljNum->value;
             }
-            else if (numArgs == 4) // CMYK
+
+            // ML - miter limit
+            if (auto mlNum = pdfCast<PdfNumber>(resolveObj(gsObj->get(PdfKeys::ML))))
             {
-                double k = popNumber(0.0);
-                double y = popNumber(0.0);
-                double m = popNumber(0.0);
-                double c = popNumber(0.0);
-                double rgb[3];
-                cmykToRgb(c, m, y, k, rgb);
-                if (isFill) {
-                    _gs.fillColor[0] = rgb[0]; _gs.fillColor[1] = rgb[1]; _gs.fillColor[2] = rgb[2];
-                    _gs.fillPatternName.clear();
-                }
-                else {
-                    _gs.strokeColor[0] = rgb[0]; _gs.strokeColor[1] = rgb[1]; _gs.strokeColor[2] = rgb[2];
-                    _gs.strokePatternName.clear();
-                }
+                _gs.miterLimit = mlNum->value;
             }
-            return;
-        }
 
-        // ============ SHADING (GRADIENT) ============
+            // ===== SMask - Soft Mask =====
+            {
+                auto smaskObj = resolveObj(gsObj->get(PdfKeys::SMask));
+                if (smaskObj)
+                {
+                    // Check for /SMask /None - this removes the current soft mask
+                    auto smaskName = pdfCast<PdfName>(smaskObj);
+                    if (smaskName && (smaskName->value == "/None"))
+                    {
+                        LogDebug("  SMask: /None - popping soft mask");
+                        if (_gs.hasSMask && _painter)
+                        {
+                            _painter->popSoftMask();
+                            if (_smaskLayerCount > 0) _smaskLayerCount--;
+                            _gs.hasSMask = false;
+                        }
+                    }
+                    else
+                    {
+                        // SMask is a dictionary: << /Type /Mask /S /Luminosity /G <ref> >>
+                        auto smaskDict = pdfCast<PdfDictionary>(smaskObj);
+                        if (smaskDict)
+                        {
+                            // Get subtype (S): /Luminosity or /Alpha
+                            auto sType = pdfCast<PdfName>(resolveObj(smaskDict->get(PdfKeys::S)));
+                            std::string maskType = sType ? sType->value : "";
+                            LogDebug("  SMask type: %s", maskType.c_str());
 
+                            // Get the Form XObject reference (/G)
+                            auto gObj = resolveObj(smaskDict->get(PdfKeys::G));
+                            auto gStream = pdfCast<PdfStream>(gObj);
 
-        // ============ TEXT OPERATORS ============
-        if (op == "BT") return op_BT();
-        if (op == "ET") return op_ET();
-        if (op == "Tf") return op_Tf();
-        if (op == "TL") return op_TL();
-        if (op == "Tm") return op_Tm();
-        if (op == "Td") return op_Td();
-        if (op == "TD") {
-            // TD is same as Td but also sets TL = -ty
-            double ty = popNumber();
-            double tx = popNumber();
-            _gs.leading = -ty;
-            _gs.textLineMatrix.e += tx * _gs.textLineMatrix.a + ty * _gs.textLineMatrix.c;
-            _gs.textLineMatrix.f += tx * _gs.textLineMatrix.b + ty * _gs.textLineMatrix.d;
-            _gs.textMatrix = _gs.textLineMatrix;
-            _gs.textPosX = _gs.textMatrix.e;
-            _gs.textPosY = _gs.textMatrix.f;
-            return;
-        }
-        if (op == "T*") return op_Tstar();
-        if (op == "Tj") return op_Tj();
-        if (op == "TJ") return op_TJ();
-        if (op == "'") {
-            // ' (single quote): Move to next line and show text
-            // Equivalent to: T*  string Tj
-            double tx = 0.0;
-            double ty = -_gs.leading;
-            _gs.textLineMatrix.e += tx * _gs.textLineMatrix.a + ty * _gs.textLineMatrix.c;
-            _gs.textLineMatrix.f += tx * _gs.textLineMatrix.b + ty * _gs.textLineMatrix.d;
-            _gs.textMatrix = _gs.textLineMatrix;
-            _gs.textPosX = _gs.textMatrix.e;
-            _gs.textPosY = _gs.textMatrix.f;
-            op_Tj();
-            return;
-        }
-        if (op == "\"") {
-            // " (double quote): Set word/char spacing, move to next line, show text
-            // Equivalent to: aw Tw  ac Tc  string '
-            std::string raw = popString();
-            double ac = popNumber();
-            double aw = popNumber();
-            _gs.wordSpacing = aw;
-            _gs.charSpacing = ac;
-            double tx = 0.0;
-            double ty = -_gs.leading;
-            _gs.textLineMatrix.e += tx * _gs.textLineMatrix.a + ty * _gs.textLineMatrix.c;
-            _gs.textLineMatrix.f += tx * _gs.textLineMatrix.b + ty * _gs.textLineMatrix.d;
-            _gs.textMatrix = _gs.textLineMatrix;
-            _gs.textPosX = _gs.textMatrix.e;
-            _gs.textPosY = _gs.textMatrix.f;
-            _stack.push_back(std::make_shared<PdfString>(raw));
-            op_Tj();
-            return;
-        }
-        if (op == "Tc") { _gs.charSpacing = popNumber(0.0); return; }
-        if (op == "Tw") { _gs.wordSpacing = popNumber(0.0); return; }
-        if (op == "Tz") { _gs.horizontalScale = popNumber(100.0); return; }
-        if (op == "Ts") { _gs.textRise = popNumber(0.0); return; }
+                            if (gStream && gStream->dict)
+                            {
+                                LogDebug("  SMask /G: Form XObject found");
 
-        // ============ TYPE3 GLYPH OPERATORS ============
-        if (op == "d0")
-        {
-            // d0: wx wy - set glyph width (Type3 CharProc)
-            popNumber(); // wy
-            popNumber(); // wx
-            return;
-        }
-        if (op == "d1")
-        {
-            // d1: wx wy llx lly urx ury - set glyph width and bbox (Type3 CharProc)
-            popNumber(); // ury
-            popNumber(); // urx
-            popNumber(); // lly
-            popNumber(); // llx
-            popNumber(); // wy
-            popNumber(); // wx
-            return;
-        }
+                                // Render the Form XObject to a luminosity mask bitmap
+                                std::vector<uint8_t> maskAlpha;
+                                int maskX = 0, maskY = 0, maskW = 0, maskH = 0;
 
-        // ============ XOBJECT ============
-        if (op == "Do")
-        {
-            if (_stack.empty())
-            {
-                LogDebug("ERROR: 'Do' with empty stack!");
-                return;
-            }
+                                if (renderFormToLuminosityMask(gStream, maskAlpha, maskX, maskY, maskW, maskH))
+                                {
+                                    LogDebug("  SMask: Rendered mask %dx%d at %d,%d", maskW, maskH, maskX, maskY);
 
-            auto nameObj = std::dynamic_pointer_cast<PdfName>(_stack.back());
-            _stack.pop_back();
+                                    // Pop previous mask if one was active (SMask replaces, not stacks)
+                                    if (_gs.hasSMask && _painter)
+                                    {
+                                        _painter->popSoftMask();
+                                        if (_smaskLayerCount > 0) _smaskLayerCount--;
+                                    }
 
-            if (!nameObj)
-            {
-                LogDebug("ERROR: 'Do' with non-name object!");
-                return;
+                                    // Push the new soft mask
+                                    if (_painter)
+                                    {
+                                        _painter->pushSoftMask(maskAlpha, maskX, maskY, maskW, maskH);
+                                        _smaskLayerCount++;
+                                        _gs.hasSMask = true;
+                                    }
+                                }
+                                else
+                                {
+                                    LogDebug("  SMask: Failed to render mask Form XObject");
+                                }
+                            }
+                            else
+                            {
+                                LogDebug("  SMask: /G is not a valid Form XObject");
+                            }
+                        }
+                    }
+                }
             }
 
-            LogDebug("XObject Do: '%s'", nameObj->value.c_str());
-            renderXObjectDo(nameObj->value);
-            return;
+            break;
         }
 
-        // ============ UNSUPPORTED ============
-        static std::map<std::string, int> unsupported;
-        if (unsupported[op]++ < 2)
-        {
-            LogDebug("UNSUPPORTED: '%s'", op.c_str());
-        }
+        syncBlendMode();
     }
 
     void PdfContentParser::renderXObjectDo(const std::string& xNameRaw)
     {
         LogDebug("renderXObjectDo START: '%s'", xNameRaw.c_str());
+        PDF_TRACE_SCOPE(Image, "Do", "%s", xNameRaw.c_str());
 
         if (!_doc || !_painter)
         {
@@ -3486,6 +3218,7 @@ namespace pdf
         LogDebug("Normalized XObject name: '%s'", xName.c_str());
 
         std::shared_ptr<PdfStream> xoStream;
+        int xoObjNum = 0; // Form / image cache key
 
         LogDebug("XObject lookup: _resStack.size=%zu", _resStack.size());
         int resIdx = 0;
@@ -3500,14 +3233,13 @@ namespace pdf
             LogDebug("  resStack[%d]: %zu entries", resIdx, res->entries.size());
 
             // Try both /XObject and XObject key formats
-            auto xoObj = res->get("/XObject");
-            if (!xoObj) xoObj = res->get("XObject");
+            auto xoObj = res->get(PdfKeys::XObject);
 
             if (!xoObj) {
                 // Debug: List all keys in this resource dict
                 std::string keys;
                 for (auto& kv : res->entries) {
-                    keys += kv.first + " ";
+                    keys += kv.first.str() + " ";
                 }
                 LogDebug("  resStack[%d]: No /XObject found. Keys: %s", resIdx, keys.c_str());
                 continue;
@@ -3521,25 +3253,23 @@ namespace pdf
 
             LogDebug("  resStack[%d]: XObject dict has %zu entries", resIdx, xoDict->entries.size());
 
-            auto itX = xoDict->entries.find("/" + xName);
-            if (itX == xoDict->entries.end()) {
-                // Try without leading /
-                itX = xoDict->entries.find(xName);
-            }
+            auto itX = xoDict->entries.find(xName);
             if (itX == xoDict->entries.end()) {
                 // Debug: List XObject keys
                 std::string xkeys;
                 for (auto& kv : xoDict->entries) {
-                    xkeys += kv.first + " ";
+                    xkeys += kv.first.str() + " ";
                 }
                 LogDebug("  resStack[%d]: XObject '%s' not found. Available: %s", resIdx, xName.c_str(), xkeys.c_str());
                 continue;
             }
 
-            xoStream = std::dynamic_pointer_cast<PdfStream>(resolveObj(itX->second));
+            xoStream = pdfCast<PdfStream>(resolveObj(itX->second));
             if (xoStream)
             {
                 LogDebug("Found XObject stream for '%s'", xName.c_str());
+                if (auto ref = pdfCast<PdfIndirectRef>(itX->second))
+                    xoObjNum = ref->objNum;
                 break;
             }
             else {
@@ -3554,8 +3284,8 @@ namespace pdf
             return;
         }
 
-        auto subtype = std::dynamic_pointer_cast<PdfName>(
-            resolveObj(xoStream->dict->get("/Subtype")));
+        auto subtype = pdfCast<PdfName>(
+            resolveObj(xoStream->dict->get(PdfKeys::Subtype)));
 
         if (!subtype)
         {
@@ -3567,7 +3297,7 @@ namespace pdf
         LogDebug("XObject subtype: '%s'", subtype->value.c_str());
 
         // IMAGE XOBJECT
-        if (subtype->value == "/Image" || subtype->value == "Image")
+        if (subtype->value == "/Image")
         {
             LogDebug("Processing Image XObject");
 
@@ -3577,9 +3307,9 @@ namespace pdf
             auto logName = [&](const char* key)
                 {
                     auto o = resolveObj(dict->get(key));
-                    if (auto n = std::dynamic_pointer_cast<PdfName>(o))
+                    if (auto n = pdfCast<PdfName>(o))
                         LogDebug("  %s = %s", key, n->value.c_str());
-                    else if (auto num = std::dynamic_pointer_cast<PdfNumber>(o))
+                    else if (auto num = pdfCast<PdfNumber>(o))
                         LogDebug("  %s = %.2f", key, num->value);
                     else if (o)
                         LogDebug("  %s = (object type)", key);
@@ -3599,58 +3329,26 @@ namespace pdf
 
 
 
-            std::vector<uint8_t> argb;
+            // Referenced images come from the document's decoded-image
+            // cache; direct (unnumbered) streams are decoded every time
+            std::shared_ptr<const std::vector<uint8_t>> argbShared;
             int iw = 0, ih = 0;
-            if (_doc->decodeImageXObject(xoStream, argb, iw, ih))
+            bool decoded = false;
+            if (xoObjNum > 0)
+                decoded = _doc->getDecodedImage(xoObjNum, xoStream, argbShared, iw, ih);
+            else
+            {
+                auto fresh = std::make_shared<std::vector<uint8_t>>();
+                decoded = _doc->decodeImageXObject(xoStream, *fresh, iw, ih);
+                argbShared = std::move(fresh);
+            }
+            if (decoded)
             {
+                const std::vector<uint8_t>& argb = *argbShared;
                 LogDebug("Decoded image: %dx%d", iw, ih);
 
-                // ========== DEBUG: İlk birkaç image'ı BMP olarak kaydet ==========
-                static int savedImageCount = 0;
-                if (savedImageCount < 5 && iw > 10 && ih > 10) {
-                    char bmpPath[MAX_PATH];
-                    GetTempPathA(MAX_PATH, bmpPath);
-                    char filename[32];
-                    sprintf(filename, "debug_image_%d.bmp", savedImageCount);
-                    strcat(bmpPath, filename);
-
-                    FILE* bmpFile = fopen(bmpPath, "wb");
-                    if (bmpFile) {
-                        // BMP Header
-                        int rowSize = ((iw * 3 + 3) / 4) * 4;
-                        int dataSize = rowSize * ih;
-                        int fileSize = 54 + dataSize;
-
-                        uint8_t header[54] = { 0 };
-                        header[0] = 'B'; header[1] = 'M';
-                        *(int*)&header[2] = fileSize;
-                        *(int*)&header[10] = 54;
-                        *(int*)&header[14] = 40;
-                        *(int*)&header[18] = iw;
-                        *(int*)&header[22] = ih;
-                        *(short*)&header[26] = 1;
-                        *(short*)&header[28] = 24;
-                        *(int*)&header[34] = dataSize;
-
-                        fwrite(header, 1, 54, bmpFile);
-
-                        // BMP pixels (bottom-up, BGR)
-                        std::vector<uint8_t> row(rowSize, 0);
-                        for (int y = ih - 1; y >= 0; y--) {
-                            for (int x = 0; x < iw; x++) {
-                                int srcIdx = (y * iw + x) * 4;
-                                row[x * 3 + 0] = argb[srcIdx + 2]; // B
-                                row[x * 3 + 1] = argb[srcIdx + 1]; // G
-                                row[x * 3 + 2] = argb[srcIdx + 0]; // R
-                            }
-                            fwrite(row.data(), 1, rowSize, bmpFile);
-                        }
-                        fclose(bmpFile);
-                        LogDebug("Saved debug image to: %s (%dx%d)", bmpPath, iw, ih);
-                    }
-                    savedImageCount++;
-                }
-                // ========== END DEBUG ==========
+                PDF_TRACE(Image, "image", "obj %d: %dx%d%s", xoObjNum, iw, ih,
+                    xoObjNum > 0 ? "" : " (inline stream)");
 
                 if (iw == 1 && ih == 1)
                 {
@@ -3710,43 +3408,10 @@ namespace pdf
                     image_ctm.a, image_ctm.b, image_ctm.c, image_ctm.d, image_ctm.e, image_ctm.f);
 
                 // ✅ Clipping path varsa drawImageClipped kullan
-                // ========== DEBUG: Image clipping durumu ==========
-                static FILE* imgClipDebug = nullptr;
-                static int imgClipCount = 0;
-                if (!imgClipDebug) {
-                    char tempPath[MAX_PATH];
-                    GetTempPathA(MAX_PATH, tempPath);
-                    strcat(tempPath, "image_clip_debug.txt");
-                    imgClipDebug = fopen(tempPath, "w");
-                    if (imgClipDebug) {
-                        fprintf(imgClipDebug, "=== IMAGE CLIPPING DEBUG ===\n");
-                        fflush(imgClipDebug);
-                    }
-                }
-                imgClipCount++;
+                PDF_TRACE(Image, "imageClip", "clip=%d, %zu segments",
+                    _hasClippingPath ? 1 : 0, _clippingPath.size());
 
-                if (imgClipDebug) {
-                    fprintf(imgClipDebug, "\n[Image #%d] size=%dx%d\n", imgClipCount, iw, ih);
-                    fprintf(imgClipDebug, "  _hasClippingPath=%d\n", _hasClippingPath ? 1 : 0);
-                    fprintf(imgClipDebug, "  _clippingPath.size=%zu\n", _clippingPath.size());
-
-                    if (!_clippingPath.empty()) {
-                        int curves = 0, lines = 0, moves = 0;
-                        for (const auto& seg : _clippingPath) {
-                            if (seg.type == PdfPathSegment::CurveTo) curves++;
-                            else if (seg.type == PdfPathSegment::LineTo) lines++;
-                            else if (seg.type == PdfPathSegment::MoveTo) moves++;
-                        }
-                        fprintf(imgClipDebug, "  clippingPath: moves=%d, lines=%d, CURVES=%d\n", moves, lines, curves);
-                    }
-                    fprintf(imgClipDebug, "  image_ctm=[%.2f %.2f %.2f %.2f %.2f %.2f]\n",
-                        image_ctm.a, image_ctm.b, image_ctm.c, image_ctm.d, image_ctm.e, image_ctm.f);
-                    fprintf(imgClipDebug, "  _clippingPathCTM=[%.2f %.2f %.2f %.2f %.2f %.2f]\n",
-                        _clippingPathCTM.a, _clippingPathCTM.b, _clippingPathCTM.c,
-                        _clippingPathCTM.d, _clippingPathCTM.e, _clippingPathCTM.f);
-                    fflush(imgClipDebug);
-                }
-                // ========== END DEBUG ==========
+                _painter->shareImage(argbShared);
 
                 // Apply clipping if needed
                 if (_hasClippingPath && !_clippingPath.empty()) {
@@ -3764,21 +3429,20 @@ namespace pdf
                     bool hasRotation = (std::abs(image_ctm.b) > 0.001 || std::abs(image_ctm.c) > 0.001);
 
                     if (isRect && _clippingPath.size() <= 6 && !hasRotation) {
-                        // Simple rect clip, no rotation - use drawImageWithClipRect
+                        // Simple rect clip, no rotation - page-space bounds, the
+                        // painter maps them to device pixels
                         double minX = 1e30, minY = 1e30, maxX = -1e30, maxY = -1e30;
                         for (const auto& seg : _clippingPath) {
                             double tx = _clippingPathCTM.a * seg.x + _clippingPathCTM.c * seg.y + _clippingPathCTM.e;
                             double ty = _clippingPathCTM.b * seg.x + _clippingPathCTM.d * seg.y + _clippingPathCTM.f;
-                            double sx = tx * _painter->scaleX();
-                            double sy = (double)_painter->height() - ty * _painter->scaleY();
-                            if (sx < minX) minX = sx;
-                            if (sx > maxX) maxX = sx;
-                            if (sy < minY) minY = sy;
-                            if (sy > maxY) maxY = sy;
+                            if (tx < minX) minX = tx;
+                            if (tx > maxX) maxX = tx;
+                            if (ty < minY) minY = ty;
+                            if (ty > maxY) maxY = ty;
                         }
                         LogDebug("Drawing image with rect clip (%zu segs)", _clippingPath.size());
-                        _painter->drawImageWithClipRect(argb, iw, ih, image_ctm,
-                            (int)minX, (int)minY, (int)maxX, (int)maxY, (float)_gs.fillAlpha);
+                        _painter->drawImageWithPageClipRect(argb, iw, ih, image_ctm,
+                            minX, minY, maxX, maxY, (float)_gs.fillAlpha);
                     } else {
                         // Complex clip path - use drawImageClipped
                         LogDebug("Drawing image with complex clip (%zu segs)", _clippingPath.size());
@@ -3800,23 +3464,31 @@ namespace pdf
         }
 
         // FORM XOBJECT
-        if (subtype->value == "/Form" || subtype->value == "Form")
+        if (subtype->value == "/Form")
         {
             LogDebug("Processing Form XObject");
 
-            std::vector<uint8_t> decoded;
-            if (!_doc->decodeStream(xoStream, decoded))
+            // Letterheads and page templates: decode, tokenize and load
+            // fonts once per document, replay on every other page
+            auto form = (xoObjNum > 0) ? _doc->findCompiledForm(xoObjNum) : nullptr;
+            const bool compiled = (form != nullptr);
+            if (!form)
             {
-                LogDebug("ERROR: Failed to decode Form stream");
-                recursionDepth--;
-                return;
+                form = std::make_shared<PdfCompiledForm>();
+                if (!_doc->decodeStream(xoStream, form->content.data))
+                {
+                    LogDebug("ERROR: Failed to decode Form stream");
+                    recursionDepth--;
+                    return;
+                }
             }
+            const std::vector<uint8_t>& decoded = form->content.data;
 
-            LogDebug("Decoded Form stream: %zu bytes", decoded.size());
+            LogDebug("%s Form stream: %zu bytes", compiled ? "Compiled" : "Decoded", decoded.size());
 
             // Form Matrix
             PdfMatrix formM;
-            auto mObj = xoStream->dict->get("/Matrix");
+            auto mObj = xoStream->dict->get(PdfKeys::Matrix);
             if (mObj)
             {
                 formM = readMatrix6(mObj);
@@ -3831,7 +3503,7 @@ namespace pdf
 
             // Resources
             std::vector<std::shared_ptr<PdfDictionary>> childResStack = _resStack;
-            auto rObj = xoStream->dict->get("/Resources");
+            auto rObj = xoStream->dict->get(PdfKeys::Resources);
             auto formRes = resolveDict(rObj);
             if (formRes)
             {
@@ -3840,8 +3512,14 @@ namespace pdf
                 childResStack.push_back(formRes);
 
                 // Form XObject fontlarını yükle (encoding, codeToGid dahil)
+                // Sayfada aynı isimde font varsa sayfanınki kalır
                 if (_fonts && _doc)
-                    _doc->loadFontsFromResourceDict(formRes, *_fonts);
+                {
+                    if (!compiled)
+                        _doc->loadFontsFromResourceDict(formRes, form->fonts);
+                    for (const auto& kv : form->fonts)
+                        _fonts->try_emplace(kv.first, kv.second);
+                }
             }
             else
             {
@@ -3854,15 +3532,14 @@ namespace pdf
 
             // ★ Form XObject /BBox clipping (PDF spec: BBox defines clipping boundary)
             bool pushedBBoxClip = false;
-            auto bboxObj = xoStream->dict->get("/BBox");
-            if (!bboxObj) bboxObj = xoStream->dict->get("BBox");
+            auto bboxObj = xoStream->dict->get(PdfKeys::BBox);
             if (bboxObj && _painter)
             {
-                auto bboxArr = std::dynamic_pointer_cast<PdfArray>(resolveObj(bboxObj));
+                auto bboxArr = pdfCast<PdfArray>(resolveObj(bboxObj));
                 if (bboxArr && bboxArr->items.size() >= 4)
                 {
                     auto getNum = [&](int i) -> double {
-                        auto n = std::dynamic_pointer_cast<PdfNumber>(resolveObj(bboxArr->items[i]));
+                        auto n = pdfCast<PdfNumber>(resolveObj(bboxArr->items[i]));
                         return n ? n->value : 0;
                     };
                     double bx1 = getNum(0), by1 = getNum(1);
@@ -3883,6 +3560,26 @@ namespace pdf
                 }
             }
 
+            // ★ Transparency group painted at ca < 1 or with a blend mode:
+            // composited as one object, its content starts at ca = 1, Normal
+            bool pushedGroup = false;
+            if (_painter && (_gs.fillAlpha < 1.0 || _gs.blendMode != PdfBlendMode::Normal))
+            {
+                auto groupDict = resolveDict(xoStream->dict->get(PdfKeys::Group));
+                auto groupType = groupDict ? pdfCast<PdfName>(resolveObj(groupDict->get(PdfKeys::S))) : nullptr;
+                if (groupType && (groupType->value == "/Transparency"))
+                {
+                    double gx0 = -1e30, gy0 = -1e30, gx1 = 1e30, gy1 = 1e30;
+                    formBBoxOnPage(xoStream, childGs.ctm, gx0, gy0, gx1, gy1);
+                    _painter->beginTransparencyGroup(gx0, gy0, gx1, gy1, (float)_gs.fillAlpha);
+                    childGs.fillAlpha = 1.0;
+                    childGs.strokeAlpha = 1.0;
+                    childGs.blendMode = PdfBlendMode::Normal;
+                    pushedGroup = true;
+                    LogDebug("Form transparency group: ca=%.2f BM=%s", _gs.fillAlpha, blendModeName(_gs.blendMode));
+                }
+            }
+
             LogDebug("Parsing child Form content...");
 
             PdfContentParser child(
@@ -3899,7 +3596,23 @@ namespace pdf
             if (_hasClippingPath && !_clippingPath.empty()) {
                 child.setInheritedClipping(_clippingPath, _clippingPathCTM, _clippingEvenOdd);
             }
-            child.parse();
+            if (compiled)
+                child.replay(form->content);
+            else if (xoObjNum > 0)
+            {
+                child.parse(&form->content);
+                _doc->storeCompiledForm(xoObjNum, form);
+            }
+            else
+                child.parse();
+
+            // The form may have left its own blend mode on the painter
+            syncBlendMode();
+
+            // The group was begun inside the BBox clip: end it first so the
+            // two nest (both are layers on the GPU painter)
+            if (pushedGroup)
+                _painter->endTransparencyGroup();
 
             // Pop BBox clip if we pushed one
             if (pushedBBoxClip && _painter) {
@@ -3920,22 +3633,50 @@ namespace pdf
     // ============================================
     // SMask: Render Form XObject to luminosity mask
     // ============================================
+    bool PdfContentParser::formBBoxOnPage(const std::shared_ptr<PdfStream>& formStream, const PdfMatrix& m,
+        double& minX, double& minY, double& maxX, double& maxY) const
+    {
+        auto bboxArr = pdfCast<PdfArray>(resolveObj(formStream->dict->get(PdfKeys::BBox)));
+        if (!bboxArr || bboxArr->items.size() < 4) return false;
+
+        double v[4];
+        for (int i = 0; i < 4; i++)
+        {
+            auto n = pdfCast<PdfNumber>(resolveObj(bboxArr->items[i]));
+            v[i] = n ? n->value : 0;
+        }
+
+        minX = minY = 1e30;
+        maxX = maxY = -1e30;
+        for (int i = 0; i < 4; i++)
+        {
+            const double x = v[(i & 1) ? 2 : 0];
+            const double y = v[(i & 2) ? 3 : 1];
+            const double px = m.a * x + m.c * y + m.e;
+            const double py = m.b * x + m.d * y + m.f;
+            minX = std::min(minX, px); maxX = std::max(maxX, px);
+            minY = std::min(minY, py); maxY = std::max(maxY, py);
+        }
+        return true;
+    }
+
     bool PdfContentParser::renderFormToLuminosityMask(
         const std::shared_ptr<PdfStream>& formStream,
         std::vector<uint8_t>& outAlpha,
-        int& outW, int& outH)
+        int& outX, int& outY, int& outW, int& outH)
     {
         if (!formStream || !formStream->dict || !_doc || !_painter) return false;
 
-        // Get the render target dimensions from the current painter
-        outW = _painter->width();
-        outH = _painter->height();
-
-        if (outW <= 0 || outH <= 0) return false;
+        // Render target in device pixels; band painters count rows
+        // from the top of the page
+        const double sx = _painter->scaleX();
+        const double sy = _painter->scaleY();
+        const int pageW = _painter->width();
+        const int pageH = _painter->pageHeight();
 
-        LogDebug("renderFormToLuminosityMask: Rendering %dx%d mask", outW, outH);
+        if (pageW <= 0 || pageH <= 0) return false;
 
-        // Decode the Form XObject stream
+        // Get Form Matrix
         std::vector<uint8_t> decoded;
         if (!_doc->decodeStream(formStream, decoded))
         {
@@ -3943,19 +3684,42 @@ namespace pdf
             return false;
         }
 
-        // Get Form Matrix
         PdfMatrix formM;
-        auto mObj = formStream->dict->get("/Matrix");
+        auto mObj = formStream->dict->get(PdfKeys::Matrix);
         if (mObj)
         {
             formM = readMatrix6(mObj);
             LogDebug("  SMask Form Matrix: [%.2f %.2f %.2f %.2f %.2f %.2f]",
                 formM.a, formM.b, formM.c, formM.d, formM.e, formM.f);
         }
+        const PdfMatrix formCtm = PdfMul(formM, _gs.ctm);
 
+        // Only the BBox is rendered: outside it the mask is 0 (black
+        // backdrop), so the painter drops whatever is drawn there
+        int x0 = 0, y0 = 0, x1 = pageW, y1 = pageH;
+        double bx0, by0, bx1, by1;
+        if (formBBoxOnPage(formStream, formCtm, bx0, by0, bx1, by1))
+        {
+            auto clampPx = [](double v) { return (int)std::max(-1e9, std::min(1e9, v)); };
+            x0 = std::max(x0, clampPx(std::floor(bx0 * sx)));
+            x1 = std::min(x1, clampPx(std::ceil(bx1 * sx)));
+            y0 = std::max(y0, clampPx(std::floor(pageH - by1 * sy)));
+            y1 = std::min(y1, clampPx(std::ceil(pageH - by0 * sy)));
+        }
+        outX = x0;
+        outY = y0;
+        outW = std::max(0, x1 - x0);
+        outH = std::max(0, y1 - y0);
+        outAlpha.clear();
+
+        LogDebug("renderFormToLuminosityMask: Rendering %dx%d mask at %d,%d", outW, outH, outX, outY);
+        if (outW == 0 || outH == 0)
+            return true;
+
+        // Decode the Form XObject stream
         // Get Form Resources
         std::vector<std::shared_ptr<PdfDictionary>> childResStack = _resStack;
-        auto rObj = formStream->dict->get("/Resources");
+        auto rObj = formStream->dict->get(PdfKeys::Resources);
         auto formRes = resolveDict(rObj);
         if (formRes)
         {
@@ -3965,8 +3729,10 @@ namespace pdf
                 _doc->loadFontsFromResourceDict(formRes, *_fonts);
         }
 
-        // Create a CPU painter for the mask rendering (same size as render target)
-        PdfPainter cpuPainter(outW, outH, _painter->scaleX(), _painter->scaleY());
+        // CPU painter over the mask rect: rows via the band origin,
+        // columns by shifting the CTM left by outX pixels
+        PdfPainter cpuPainter(outW, outH, sx, sy);
+        cpuPainter.setBandOrigin(outY, pageH);
 
         // Start with white background (luminosity mask: white = opaque, black = transparent)
         // Actually, per PDF spec for luminosity masks, the backdrop is black (transparent)
@@ -3974,7 +3740,9 @@ namespace pdf
 
         // Set up child graphics state
         PdfGraphicsState childGs = _gs;
-        childGs.ctm = PdfMul(formM, _gs.ctm);
+        PdfMatrix shift;
+        shift.e = -outX / sx;
+        childGs.ctm = PdfMul(formCtm, shift);
         // Reset SMask state for child to prevent infinite recursion
         childGs.hasSMask = false;
 
@@ -4016,28 +3784,28 @@ namespace pdf
     std::shared_ptr<PdfObject> PdfContentParser::resolveObj(const std::shared_ptr<PdfObject>& o) const
     {
         if (!_doc) return o;
-        std::set<int> v;
+        PdfVisitedRefs v;
         return _doc->resolve(o, v);
     }
 
     std::shared_ptr<PdfDictionary> PdfContentParser::resolveDict(const std::shared_ptr<PdfObject>& o) const
     {
         auto ro = resolveObj(o);
-        return std::dynamic_pointer_cast<PdfDictionary>(ro);
+        return pdfCast<PdfDictionary>(ro);
     }
 
     PdfMatrix PdfContentParser::readMatrix6(const std::shared_ptr<PdfObject>& obj) const
     {
         PdfMatrix m;
-        auto arr = std::dynamic_pointer_cast<PdfArray>(resolveObj(obj));
+        auto arr = pdfCast<PdfArray>(resolveObj(obj));
         if (!arr || arr->items.size() < 6) return m;
 
-        auto n0 = std::dynamic_pointer_cast<PdfNumber>(resolveObj(arr->items[0]));
-        auto n1 = std::dynamic_pointer_cast<PdfNumber>(resolveObj(arr->items[1]));
-        auto n2 = std::dynamic_pointer_cast<PdfNumber>(resolveObj(arr->items[2]));
-        auto n3 = std::dynamic_pointer_cast<PdfNumber>(resolveObj(arr->items[3]));
-        auto n4 = std::dynamic_pointer_cast<PdfNumber>(resolveObj(arr->items[4]));
-        auto n5 = std::dynamic_pointer_cast<PdfNumber>(resolveObj(arr->items[5]));
+        auto n0 = pdfCast<PdfNumber>(resolveObj(arr->items[0]));
+        auto n1 = pdfCast<PdfNumber>(resolveObj(arr->items[1]));
+        auto n2 = pdfCast<PdfNumber>(resolveObj(arr->items[2]));
+        auto n3 = pdfCast<PdfNumber>(resolveObj(arr->items[3]));
+        auto n4 = pdfCast<PdfNumber>(resolveObj(arr->items[4]));
+        auto n5 = pdfCast<PdfNumber>(resolveObj(arr->items[5]));
 
         if (!n0 || !n1 || !n2 || !n3 || !n4 || !n5) return m;
 
@@ -4057,9 +3825,9 @@ namespace pdf
     int PdfContentParser::resolveColorSpaceType(const std::string& csName)
     {
         // Standard device color spaces
-        if (csName == "/DeviceGray" || csName == "DeviceGray") return 1;
-        if (csName == "/DeviceRGB" || csName == "DeviceRGB") return 2;
-        if (csName == "/DeviceCMYK" || csName == "DeviceCMYK") return 3;
+        if (csName == "/DeviceGray") return 1;
+        if (csName == "/DeviceRGB") return 2;
+        if (csName == "/DeviceCMYK") return 3;
 
         // Look up in resources
         auto res = currentResources();
@@ -4072,8 +3840,7 @@ namespace pdf
         if (!csDict) return 0;
 
         // Dictionary keys include '/' prefix
-        auto colorSpaces = csDict->get("/ColorSpace");
-        if (!colorSpaces) colorSpaces = csDict->get("ColorSpace");
+        auto colorSpaces = csDict->get(PdfKeys::ColorSpace);
         if (!colorSpaces) {
             LogDebug("resolveColorSpaceType(%s): no ColorSpace in resources", csName.c_str());
             return 0;
@@ -4081,20 +3848,10 @@ namespace pdf
         auto csResolved = resolveObj(colorSpaces);
         if (!csResolved || csResolved->type() != PdfObjectType::Dictionary) return 0;
 
-        auto csDictObj = std::dynamic_pointer_cast<PdfDictionary>(csResolved);
+        auto csDictObj = pdfCast<PdfDictionary>(csResolved);
         if (!csDictObj) return 0;
 
-        // Ensure lookup name has '/' prefix (dictionary keys have '/' prefix)
-        std::string lookupName = csName;
-        if (!lookupName.empty() && lookupName[0] != '/') lookupName = "/" + lookupName;
-
-        auto csEntry = csDictObj->get(lookupName);
-        if (!csEntry) {
-            // Try without '/' prefix as fallback
-            std::string noSlash = csName;
-            if (!noSlash.empty() && noSlash[0] == '/') noSlash = noSlash.substr(1);
-            csEntry = csDictObj->get(noSlash);
-        }
+        auto csEntry = csDictObj->get(csName);
         if (!csEntry) {
             LogDebug("resolveColorSpaceType(%s): not found in ColorSpace dict", csName.c_str());
             return 0;
@@ -4102,34 +3859,29 @@ namespace pdf
         auto csArray = resolveObj(csEntry);
         if (!csArray || csArray->type() != PdfObjectType::Array) return 0;
 
-        auto arr = std::dynamic_pointer_cast<PdfArray>(csArray);
+        auto arr = pdfCast<PdfArray>(csArray);
         if (!arr || arr->items.empty()) return 0;
 
         auto typeObj = resolveObj(arr->items[0]);
         if (!typeObj) return 0;
 
         std::string csTypeName;
-        if (typeObj->type() == PdfObjectType::Name) {
+        if (typeObj->type() == PdfObjectType::Name)
             csTypeName = static_cast<PdfName*>(typeObj.get())->value;
-            // Strip '/' prefix for comparison
-            if (!csTypeName.empty() && csTypeName[0] == '/') csTypeName = csTypeName.substr(1);
-        }
 
         LogDebug("resolveColorSpaceType(%s): csTypeName='%s', items=%zu",
                  csName.c_str(), csTypeName.c_str(), arr->items.size());
 
         // Separation or DeviceN with alternate space
-        if (csTypeName == "Separation" || csTypeName == "DeviceN") {
+        if (csTypeName == "/Separation" || csTypeName == "/DeviceN") {
             // arr[0] = type, arr[1] = colorant names, arr[2] = alternate CS, arr[3] = tint transform
             if (arr->items.size() >= 3) {
                 auto altCS = resolveObj(arr->items[2]);
                 if (altCS && altCS->type() == PdfObjectType::Name) {
-                    std::string altName = static_cast<PdfName*>(altCS.get())->value;
-                    // Strip '/' prefix for comparison
-                    if (!altName.empty() && altName[0] == '/') altName = altName.substr(1);
+                    const std::string& altName = static_cast<PdfName*>(altCS.get())->value;
                     LogDebug("  alternate CS: '%s'", altName.c_str());
-                    if (altName == "DeviceCMYK") return 4; // Separation/DeviceN -> CMYK
-                    if (altName == "DeviceGray") return 5; // Separation/DeviceN -> Gray
+                    if (altName == "/DeviceCMYK") return 4; // Separation/DeviceN -> CMYK
+                    if (altName == "/DeviceGray") return 5; // Separation/DeviceN -> Gray
                 }
             }
             // Default: assume CMYK alternate (most common)
@@ -4137,20 +3889,19 @@ namespace pdf
         }
 
         // ICCBased - check number of components
-        if (csTypeName == "ICCBased") {
+        if (csTypeName == "/ICCBased") {
             if (arr->items.size() >= 2) {
                 auto iccStream = resolveObj(arr->items[1]);
                 // ICCBased profile is a stream - check both Stream and Dictionary types
                 std::shared_ptr<PdfDictionary> iccDict;
                 if (iccStream && iccStream->type() == PdfObjectType::Stream) {
-                    auto stm = std::dynamic_pointer_cast<PdfStream>(iccStream);
+                    auto stm = pdfCast<PdfStream>(iccStream);
                     if (stm) iccDict = stm->dict;
                 } else if (iccStream && iccStream->type() == PdfObjectType::Dictionary) {
-                    iccDict = std::dynamic_pointer_cast<PdfDictionary>(iccStream);
+                    iccDict = pdfCast<PdfDictionary>(iccStream);
                 }
                 if (iccDict) {
-                    auto nObj = iccDict->get("/N");
-                    if (!nObj) nObj = iccDict->get("N");
+                    auto nObj = iccDict->get(PdfKeys::N);
                     if (nObj && nObj->type() == PdfObjectType::Number) {
                         int n = (int)static_cast<PdfNumber*>(nObj.get())->value;
                         if (n == 1) return 1; // Gray
@@ -4223,7 +3974,7 @@ namespace pdf
     void PdfContentParser::op_SC()
     {
         // Stroke Color
-        if (_currentStrokeCS == "/Pattern" || _currentStrokeCS == "Pattern") {
+        if (_currentStrokeCS == "/Pattern") {
             std::string name = popName();
             // Stroke Pattern Name (not supported in GS yet, maybe ignored)
 
@@ -4241,7 +3992,7 @@ namespace pdf
     void PdfContentParser::op_sc()
     {
         // Fill Color
-        if (_currentFillCS == "/Pattern" || _currentFillCS == "Pattern") {
+        if (_currentFillCS == "/Pattern") {
             // Pattern
             std::string name = popName(); // Last arg is pattern name
             _gs.fillPatternName = name;
@@ -4286,26 +4037,24 @@ namespace pdf
 
         // Find Shading resource from resource stack
         std::shared_ptr<PdfDictionary> shadingDict;
-        std::set<int> visited;
+        PdfVisitedRefs visited;
 
         for (auto it = _resStack.rbegin(); it != _resStack.rend(); ++it) {
             auto res = *it;
             if (!res) continue;
 
-            auto shadingsRaw = res->get("Shading");
-            if (!shadingsRaw) shadingsRaw = res->get("/Shading");
+            auto shadingsRaw = res->get(PdfKeys::Shading);
             if (!shadingsRaw) continue;
 
             auto shadingsObj = _doc->resolve(shadingsRaw, visited);
-            auto shadingsDict = std::dynamic_pointer_cast<PdfDictionary>(shadingsObj);
+            auto shadingsDict = pdfCast<PdfDictionary>(shadingsObj);
             if (!shadingsDict) continue;
 
             auto shRaw = shadingsDict->get(name);
-            if (!shRaw) shRaw = shadingsDict->get("/" + name);
             if (!shRaw) continue;
 
             auto shObj = _doc->resolve(shRaw, visited);
-            shadingDict = std::dynamic_pointer_cast<PdfDictionary>(shObj);
+            shadingDict = pdfCast<PdfDictionary>(shObj);
             if (shadingDict) break;
         }
 
@@ -4315,9 +4064,8 @@ namespace pdf
         }
 
         // Parse ShadingType
-        auto stRaw = shadingDict->get("ShadingType");
-        if (!stRaw) stRaw = shadingDict->get("/ShadingType");
-        auto stNum = std::dynamic_pointer_cast<PdfNumber>(stRaw);
+        auto stRaw = shadingDict->get(PdfKeys::ShadingType);
+        auto stNum = pdfCast<PdfNumber>(stRaw);
         int shadingType = stNum ? (int)stNum->value : 0;
 
         if (shadingType != 2 && shadingType != 3) {
@@ -4329,10 +4077,9 @@ namespace pdf
         gradient.type = shadingType;
 
         // Coords
-        auto coordsRaw = shadingDict->get("Coords");
-        if (!coordsRaw) coordsRaw = shadingDict->get("/Coords");
+        auto coordsRaw = shadingDict->get(PdfKeys::Coords);
         auto coordsObj = _doc->resolve(coordsRaw, visited);
-        auto coordsArr = std::dynamic_pointer_cast<PdfArray>(coordsObj);
+        auto coordsArr = pdfCast<PdfArray>(coordsObj);
         if (!coordsArr || coordsArr->items.size() < 4) {
             LogDebug("  sh: Invalid Coords");
             return;
@@ -4340,7 +4087,7 @@ namespace pdf
 
         std::vector<double> coords(6, 0.0);
         for (size_t i = 0; i < coordsArr->items.size() && i < 6; ++i) {
-            auto n = std::dynamic_pointer_cast<PdfNumber>(_doc->resolve(coordsArr->items[i], visited));
+            auto n = pdfCast<PdfNumber>(_doc->resolve(coordsArr->items[i], visited));
             if (n) coords[i] = n->value;
         }
 
@@ -4354,39 +4101,38 @@ namespace pdf
 
         // ColorSpace
         int numComponents = 3;
-        auto csRaw = shadingDict->get("ColorSpace");
-        if (!csRaw) csRaw = shadingDict->get("/ColorSpace");
+        auto csRaw = shadingDict->get(PdfKeys::ColorSpace);
         if (csRaw) {
             auto csObj = _doc->resolve(csRaw, visited);
-            if (auto csName = std::dynamic_pointer_cast<PdfName>(csObj)) {
+            if (auto csName = pdfCast<PdfName>(csObj)) {
                 std::string cs = csName->value;
-                if (cs == "/DeviceGray" || cs == "DeviceGray") numComponents = 1;
-                else if (cs == "/DeviceCMYK" || cs == "DeviceCMYK") numComponents = 4;
+                if (cs == "/DeviceGray") numComponents = 1;
+                else if (cs == "/DeviceCMYK") numComponents = 4;
             }
-            else if (auto csArr = std::dynamic_pointer_cast<PdfArray>(csObj)) {
+            else if (auto csArr = pdfCast<PdfArray>(csObj)) {
                 if (!csArr->items.empty()) {
-                    auto first = std::dynamic_pointer_cast<PdfName>(_doc->resolve(csArr->items[0], visited));
+                    auto first = pdfCast<PdfName>(_doc->resolve(csArr->items[0], visited));
                     if (first) {
                         std::string csType = first->value;
-                        if (csType == "/ICCBased" || csType == "ICCBased") {
+                        if (csType == "/ICCBased") {
                             if (csArr->items.size() >= 2) {
-                                auto iccStream = std::dynamic_pointer_cast<PdfStream>(
+                                auto iccStream = pdfCast<PdfStream>(
                                     _doc->resolve(csArr->items[1], visited));
                                 if (iccStream && iccStream->dict) {
-                                    auto nObj = std::dynamic_pointer_cast<PdfNumber>(
-                                        _doc->resolve(iccStream->dict->get("/N"), visited));
+                                    auto nObj = pdfCast<PdfNumber>(
+                                        _doc->resolve(iccStream->dict->get(PdfKeys::N), visited));
                                     if (nObj) numComponents = (int)nObj->value;
                                 }
                             }
                         }
-                        else if (csType == "/Separation" || csType == "Separation") numComponents = 1;
-                        else if (csType == "/DeviceN" || csType == "DeviceN") {
+                        else if (csType == "/Separation") numComponents = 1;
+                        else if (csType == "/DeviceN") {
                             if (csArr->items.size() >= 3) {
                                 auto altCS = _doc->resolve(csArr->items[2], visited);
-                                if (auto altName = std::dynamic_pointer_cast<PdfName>(altCS)) {
+                                if (auto altName = pdfCast<PdfName>(altCS)) {
                                     std::string alt = altName->value;
-                                    if (alt == "/DeviceCMYK" || alt == "DeviceCMYK") numComponents = 4;
-                                    else if (alt == "/DeviceGray" || alt == "DeviceGray") numComponents = 1;
+                                    if (alt == "/DeviceCMYK") numComponents = 4;
+                                    else if (alt == "/DeviceGray") numComponents = 1;
                                 }
                             }
                         }
@@ -4396,8 +4142,7 @@ namespace pdf
         }
 
         // Function
-        auto funcRaw = shadingDict->get("Function");
-        if (!funcRaw) funcRaw = shadingDict->get("/Function");
+        auto funcRaw = shadingDict->get(PdfKeys::Function);
         if (funcRaw) {
             auto funcObj = _doc->resolve(funcRaw, visited);
             if (!PdfGradient::parseFunctionToGradient(funcObj, _doc, gradient, numComponents)) {
@@ -2,9 +2,11 @@
 #include "PdfPath.h"
 #include <vector>
 #include <string>
+#include <string_view>
 #include <map>
 #include <memory>
 #include <stack>
+#include <algorithm>
 #include <cstdint>
 
 #include "PdfGraphicsState.h"
@@ -18,6 +20,103 @@ namespace pdf
 
     class IPdfPainter;  // Use interface instead of concrete class
 
+    // =========================================================
+    // Content stream operand
+    // Numbers are stored inline; names and strings are views into the
+    // content buffer. Only strings that had to be unescaped keep their
+    // bytes in the slot, and only arrays / inline dictionaries are heap
+    // PdfObjects.
+    // =========================================================
+    struct PdfOperand
+    {
+        enum class Kind : uint8_t { Number, Name, String, Object };
+
+        Kind kind = Kind::Number;
+        bool owned = false;                 // String bytes are in storage, not the buffer
+        double number = 0.0;
+        std::string_view view;              // Name ("/F1") or String bytes
+        std::string storage;                // unescaped String bytes (capacity is reused)
+        std::shared_ptr<PdfObject> object;  // Array / Dictionary
+
+        std::string_view text() const { return owned ? std::string_view(storage) : view; }
+
+        // Heap object for array items and dictionary values
+        std::shared_ptr<PdfObject> toObject() const;
+    };
+
+    // Fixed-capacity operand stack. Slots are reused, so pushing a number
+    // or a name never allocates. Operators take at most a few dozen
+    // operands (scn with DeviceN); past CAPACITY the oldest one is dropped.
+    class PdfOperandStack
+    {
+    public:
+        static constexpr size_t CAPACITY = 64;
+
+        bool empty() const { return _size == 0; }
+        size_t size() const { return _size; }
+        PdfOperand& back() { return _items[_size - 1]; }
+        const PdfOperand& operator[](size_t i) const { return _items[i]; }
+
+        PdfOperand& push()
+        {
+            if (_size == CAPACITY)
+            {
+                std::move(_items + 1, _items + CAPACITY, _items);
+                _size--;
+            }
+            PdfOperand& op = _items[_size++];
+            op.owned = false;
+            return op;
+        }
+
+        void pop_back()
+        {
+            PdfOperand& op = _items[--_size];
+            if (op.object) op.object.reset();
+        }
+
+        void clear()
+        {
+            while (_size) pop_back();
+        }
+
+    private:
+        PdfOperand _items[CAPACITY];
+        size_t _size = 0;
+    };
+
+    // =========================================================
+    // Compiled content stream
+    // The operators a parse dispatched, each with the operand stack it
+    // saw. Replaying runs the same handlers without lexing the bytes
+    // again; names and plain strings still view into `data`.
+    // =========================================================
+    struct PdfCompiledContent
+    {
+        struct Op
+        {
+            std::string_view name;
+            uint32_t firstOperand = 0;
+            uint32_t operandCount = 0;
+        };
+
+        std::vector<uint8_t> data;
+        std::vector<PdfOperand> operands;
+        std::vector<Op> ops;
+
+        size_t byteSize() const;
+    };
+
+    // Form XObject shared by every page that draws it: the compiled
+    // content plus the fonts its /Resources load
+    struct PdfCompiledForm
+    {
+        PdfCompiledContent content;
+        std::map<std::string, PdfFontInfo> fonts;
+
+        size_t byteSize() const;
+    };
+
     class PdfContentParser
     {
     public:
@@ -31,7 +130,12 @@ namespace pdf
             const std::vector<std::shared_ptr<PdfDictionary>>& resourceStack
         );
 
-        void parse();
+        // record: also collect the dispatched operators for replay()
+        void parse(PdfCompiledContent* record = nullptr);
+
+        // Runs a compiled operator list; the parser must have been built
+        // over compiled.data
+        void replay(const PdfCompiledContent& compiled);
 
         // ✅ Set inherited clipping state from parent (for Form XObjects)
         void setInheritedClipping(const PdfPath& clipPath, const PdfMatrix& clipCTM, bool evenOdd = false)
@@ -50,16 +154,28 @@ namespace pdf
         void skipComment();
 
         double      readNumber();
-        std::string readName();
+        std::string_view readName();
         std::string readString();
-        std::string readWord();
+        bool        readPlainString(std::string_view& out);
+        std::string_view readOperator();
 
         double      popNumber(double def = 0.0);
         std::string popString();
         std::string popName();
+        std::shared_ptr<PdfArray> popArray();
+
+        void pushNumber(double v);
+        void pushName(std::string_view name);
+        void pushString(std::string_view bytes, bool owned);
+        void pushObject(std::shared_ptr<PdfObject> obj);
 
         void parseToken();
-        void handleOperator(const std::string& op);
+        void handleOperator(std::string_view op);
+        void recordOperator(std::string_view op);
+        void finishParse();
+
+        // Tells the painter about _gs.blendMode if it has another mode
+        void syncBlendMode();
 
         // path operators
         void op_m();
@@ -73,6 +189,7 @@ namespace pdf
         void op_cm();
         void op_q();
         void op_Q();
+        void op_gs();
 
         // text state
         void op_BT();
@@ -109,6 +226,7 @@ namespace pdf
         void op_RG(); void op_rg();
         void op_K(); void op_k();
         void op_sh();
+        void op_sh_clip();
 
         // Color space resolution helpers
         int resolveColorSpaceType(const std::string& csName);
@@ -150,6 +268,7 @@ namespace pdf
 
         const std::vector<uint8_t>& _data;
         size_t _pos = 0;
+        PdfCompiledContent* _record = nullptr;
 
         double _cpX = 0.0;
         double _cpY = 0.0;
@@ -167,7 +286,7 @@ namespace pdf
         PdfMatrix _defaultCtm;  // CTM at the start of this content stream (for pattern brush mapping)
         std::stack<PdfGraphicsState> _gsStack;
 
-        std::vector<std::shared_ptr<PdfObject>> _stack;
+        PdfOperandStack _stack;
 
         PdfFontInfo* _currentFont = nullptr;
 
@@ -184,11 +303,16 @@ namespace pdf
         void renderXObjectDo(const std::string& xName);
         PdfMatrix readMatrix6(const std::shared_ptr<PdfObject>& obj) const;
 
-        // SMask: Render a Form XObject to luminosity bitmap
+        // Page-space bounds of a form's /BBox under m; false without a BBox
+        bool formBBoxOnPage(const std::shared_ptr<PdfStream>& formStream, const PdfMatrix& m,
+            double& minX, double& minY, double& maxX, double& maxY) const;
+
+        // SMask: Render a Form XObject to luminosity bitmap covering
+        // only its BBox: outW x outH device pixels at (outX, outY)
         bool renderFormToLuminosityMask(
             const std::shared_ptr<PdfStream>& formStream,
             std::vector<uint8_t>& outAlpha,
-            int& outW, int& outH);
+            int& outX, int& outY, int& outW, int& outH);
 
         bool resolvePatternToGradient(
             const std::string& patternName,
@@ -4,19 +4,25 @@
 #include "PdfDocument.h"
 #include "IPdfPainter.h"
 #include "PdfPainter.h"
+#ifndef PDFCORE_HEADLESS
 #include "PdfPainterGPU.h"
+#endif
 #include "PdfContentParser.h"
 #include "PdfDebug.h"
+#include "PdfTrace.h"
 #include "PdfTextExtractor.h"
+#include "PdfTileRenderer.h"
 #include "PageRenderCache.h"
 #include "FontCache.h"
 #include "GlyphCache.h"
+#include "PdfPlatform.h"
 #include <fstream>
 #include <vector>
 #include <cstdint>
 #include <cstring>
 #include <functional>
 #include <mutex>
+#include <atomic>
 #include <chrono>
 
 // ---------------------------------------------
@@ -25,16 +31,25 @@
 
 static bool ReadAllBytes(const wchar_t* path, std::vector<uint8_t>& out)
 {
+#ifdef _WIN32
     std::ifstream ifs(path, std::ios::binary);
+#else
+    std::ifstream ifs(pdf::platform::narrowPath(path), std::ios::binary);
+#endif
     if (!ifs) return false;
 
-    out.assign(std::istreambuf_iterator<char>(ifs),
-        std::istreambuf_iterator<char>());
+    // Boyutu al, tek read() ile oku (istreambuf_iterator byte byte okur)
+    ifs.seekg(0, std::ios::end);
+    std::streamoff len = ifs.tellg();
+    if (len <= 0) return false;
+    ifs.seekg(0, std::ios::beg);
 
-    return !out.empty();
+    out.resize((size_t)len);
+    ifs.read(reinterpret_cast<char*>(out.data()), len);
+    return ifs.gcount() == len;
 }
 
-static int g_lastStage = 0;
+static std::atomic<int> g_lastStage{ 0 };
 static FT_Library g_ftLib = nullptr;
 
 // =====================================================
@@ -48,7 +63,9 @@ static bool g_useActiveDocumentFilter = true;  // Enable/disable filtering
 // =====================================================
 // RENDER MUTEX - Prevent concurrent renders crashing D2D/WIC
 // Multiple threads can request renders simultaneously during zoom;
-// serialize them to prevent resource conflicts
+// serialize GPU renders to prevent resource conflicts. CPU renders
+// only touch per-call painters and the document's own locked state,
+// so they run concurrently (also with a GPU render).
 // =====================================================
 static std::mutex g_renderMutex;
 
@@ -163,6 +180,27 @@ PDF_API void Pdf_SetZoomState(PDF_DOCUMENT ptr, int isZooming)
         g_renderQuality.endZoom();
 }
 
+PDF_API void Pdf_SetRenderThreads(int threads)
+{
+    g_renderQuality.bandThreads = std::max(1, threads);
+}
+
+PDF_API void Pdf_SetAntiAlias(int enabled)
+{
+    g_renderQuality.antiAlias = (enabled != 0);
+}
+
+// ---------------------------------------------
+PDF_API void Pdf_SetTraceCategories(unsigned int mask)
+{
+    pdf::trace::setCategories(mask);
+}
+
+PDF_API int Pdf_WriteTrace(const char* path)
+{
+    return (path && pdf::trace::writeChromeTrace(path)) ? 1 : 0;
+}
+
 // ---------------------------------------------
 PDF_API int Pdf_GetRealPageCountFromFile(const wchar_t* path)
 {
@@ -179,8 +217,7 @@ PDF_API int Pdf_GetRealPageCountFromFile(const wchar_t* path)
 // ---------------------------------------------
 struct PdfDocumentHandle
 {
-    std::vector<uint8_t> data;
-    pdf::PdfDocument doc;
+    pdf::PdfDocument doc;   // dosya baytlarının tek sahibi (kopya veya mapping)
     pdf::PdfTextExtractor textExtractor;
 };
 
@@ -195,16 +232,17 @@ PDF_API PDF_DOCUMENT Pdf_OpenDocument(const wchar_t* path)
     LogDebug("Step 1: DONE");
 
     LogDebug("Step 2: Reading file bytes...");
-    if (!ReadAllBytes(path, h->data))
+    std::vector<uint8_t> data;
+    if (!ReadAllBytes(path, data))
     {
         LogDebug("ERROR: Failed to read file");
         delete h;
         return nullptr;
     }
-    LogDebug("Step 2: DONE - File size: %zu bytes", h->data.size());
+    LogDebug("Step 2: DONE - File size: %zu bytes", data.size());
 
     LogDebug("Step 3: Starting loadFromBytes...");
-    if (!h->doc.loadFromBytes(h->data))
+    if (!h->doc.loadFromBytes(std::move(data)))
     {
         LogDebug("ERROR: loadFromBytes failed");
         delete h;
@@ -216,6 +254,35 @@ PDF_API PDF_DOCUMENT Pdf_OpenDocument(const wchar_t* path)
     return (PDF_DOCUMENT)h;
 }
 
+// Dosyayı kopyalamadan açar: PdfDocument, lexer ve stream'ler doğrudan
+// read-only mapping üzerinden okur. Bellek sayfaları OS page cache'inden
+// paylaşılır; çok sayıda açık büyük doküman için private RSS düşer.
+PDF_API PDF_DOCUMENT Pdf_OpenDocumentMapped(const wchar_t* path)
+{
+    pdf::PdfDebug::Init();
+    LogDebug("=== Opening PDF (mapped): %ls ===", path);
+
+    if (!path) return nullptr;
+
+    size_t size = 0;
+    auto mapped = pdf::platform::mapFile(path, size);
+    if (!mapped)
+    {
+        LogDebug("ERROR: Failed to map file");
+        return nullptr;
+    }
+
+    auto h = new PdfDocumentHandle();
+    if (!h->doc.loadFromMemory(std::move(mapped), size))
+    {
+        LogDebug("ERROR: loadFromMemory failed");
+        delete h;
+        return nullptr;
+    }
+
+    return (PDF_DOCUMENT)h;
+}
+
 PDF_API void Pdf_CloseDocument(PDF_DOCUMENT ptr)
 {
     if (!ptr) return;
@@ -293,6 +360,10 @@ PDF_API int Pdf_DecompressStream(
     return s.total_out;
 }
 
+// Below this many output pixels a page renders faster on one painter
+// than replayed once per band
+static const long long BANDED_RENDER_MIN_PIXELS = 2LL * 1024 * 1024;
+
 static int RenderImpl(
     PDF_DOCUMENT ptr,
     int pageIndex,
@@ -404,28 +475,29 @@ static int RenderImpl(
     }
     LogDebug("Cache MISS for page %d", pageIndex);
 
-    // =====================================================
-    // RENDER MUTEX - Serialize actual rendering to prevent
-    // concurrent D2D/WIC resource conflicts that cause crashes
-    // Size queries and cache hits above don't need this lock
-    // =====================================================
-    std::lock_guard<std::mutex> renderLock(g_renderMutex);
-
-    // Double-check cache after acquiring lock (another thread may have rendered it)
-    if (pdf::PageRenderCache::instance().getDirect(h, pageIndex, wPx, hPx, outBuffer, required))
-    {
-        LogDebug("Cache HIT (after lock) for page %d", pageIndex);
-        g_lastStage = 150;
-        return required;
-    }
-
     g_lastStage = 50;
     LogDebug("Stage 50: Starting painter initialization");
 
     std::vector<uint8_t> resultBuffer;
 
+#ifndef PDFCORE_HEADLESS
     if (useGPU)
     {
+        // =====================================================
+        // RENDER MUTEX - Serialize GPU rendering to prevent
+        // concurrent D2D/WIC resource conflicts that cause crashes
+        // Size queries and cache hits above don't need this lock
+        // =====================================================
+        std::lock_guard<std::mutex> renderLock(g_renderMutex);
+
+        // Double-check cache after acquiring lock (another thread may have rendered it)
+        if (pdf::PageRenderCache::instance().getDirect(h, pageIndex, wPx, hPx, outBuffer, required))
+        {
+            LogDebug("Cache HIT (after lock) for page %d", pageIndex);
+            g_lastStage = 150;
+            return required;
+        }
+
         pdf::PdfPainterGPU painter(wPx, hPx, scale, scale);
 
         if (!painter.initialize())
@@ -477,15 +549,37 @@ static int RenderImpl(
     }
 
 CPU_RENDERING:
+#endif
     {
         const int ssaa = g_renderQuality.getCurrentSSAA();
         LogDebug("CPU rendering with SSAA=%d", ssaa);
 
+        // Large pages: rasterize horizontal bands on the render pool
+        const int bandThreads = g_renderQuality.bandThreads;
+        if (bandThreads > 1 && (long long)wPx * hPx >= BANDED_RENDER_MIN_PIXELS)
+        {
+            g_lastStage = 70;
+            resultBuffer.resize(required);
+            if (pdf::renderPageBanded(doc, pageIndex, wPx, hPx, scale, ssaa, bandThreads, resultBuffer.data(), g_renderQuality.antiAlias))
+            {
+                g_lastStage = 140;
+
+                std::memcpy(outBuffer, resultBuffer.data(), required);
+                pdf::PageRenderCache::instance().store(h, pageIndex, wPx, hPx, zoom, resultBuffer);
+
+                g_lastStage = 150;
+                LogDebug("Stage 150: banded CPU rendering finished successfully");
+                return required;
+            }
+            resultBuffer.clear();
+        }
+
         pdf::PdfPainter painter(wPx, hPx, scale, scale, ssaa);
 
         g_lastStage = 60;
 
         painter.setPageRotation(0, wPt, hPt);
+        painter.setAntiAlias(g_renderQuality.antiAlias);
         painter.clear(0xFFFFFFFF);
 
         g_lastStage = 70;
@@ -530,6 +624,7 @@ PDF_API int PDF_CALL Pdf_RenderPageToRgba(
     int* outW,
     int* outH)
 {
+#ifdef _MSC_VER
     __try
     {
         return RenderImpl(ptr, pageIndex, zoom, outBuffer, outBufferSize, outW, outH, true);
@@ -538,6 +633,9 @@ PDF_API int PDF_CALL Pdf_RenderPageToRgba(
     {
         return -999;
     }
+#else
+    return RenderImpl(ptr, pageIndex, zoom, outBuffer, outBufferSize, outW, outH, true);
+#endif
 }
 
 PDF_API int PDF_CALL Pdf_RenderPageToRgba_CPU(
@@ -549,6 +647,7 @@ PDF_API int PDF_CALL Pdf_RenderPageToRgba_CPU(
     int* outW,
     int* outH)
 {
+#ifdef _MSC_VER
     __try
     {
         return RenderImpl(ptr, pageIndex, zoom, outBuffer, outBufferSize, outW, outH, false);
@@ -557,6 +656,9 @@ PDF_API int PDF_CALL Pdf_RenderPageToRgba_CPU(
     {
         return -999;
     }
+#else
+    return RenderImpl(ptr, pageIndex, zoom, outBuffer, outBufferSize, outW, outH, false);
+#endif
 }
 
 // =====================================================
@@ -622,6 +724,44 @@ PDF_API void PDF_CALL Pdf_GetCacheStats(
     if (outMemoryMB) *outMemoryMB = pdf::PageRenderCache::instance().memoryUsage() / (1024 * 1024);
 }
 
+// Get compiled Form XObject cache statistics of a document
+PDF_API void PDF_CALL Pdf_GetFormCacheStats(
+    PDF_DOCUMENT ptr,
+    size_t* outHits,
+    size_t* outMisses,
+    size_t* outForms,
+    size_t* outMemoryKB)
+{
+    size_t hits = 0, misses = 0, forms = 0, bytes = 0;
+    if (ptr)
+    {
+        reinterpret_cast<PdfDocumentHandle*>(ptr)->doc.getFormCacheStats(hits, misses, forms, bytes);
+    }
+    if (outHits) *outHits = hits;
+    if (outMisses) *outMisses = misses;
+    if (outForms) *outForms = forms;
+    if (outMemoryKB) *outMemoryKB = bytes / 1024;
+}
+
+// Get decoded image cache statistics of a document
+PDF_API void PDF_CALL Pdf_GetImageCacheStats(
+    PDF_DOCUMENT ptr,
+    size_t* outHits,
+    size_t* outMisses,
+    size_t* outImages,
+    size_t* outMemoryKB)
+{
+    size_t hits = 0, misses = 0, images = 0, bytes = 0;
+    if (ptr)
+    {
+        reinterpret_cast<PdfDocumentHandle*>(ptr)->doc.getImageCacheStats(hits, misses, images, bytes);
+    }
+    if (outHits) *outHits = hits;
+    if (outMisses) *outMisses = misses;
+    if (outImages) *outImages = images;
+    if (outMemoryKB) *outMemoryKB = bytes / 1024;
+}
+
 // =============================================
 // ENCRYPTION API
 // =============================================
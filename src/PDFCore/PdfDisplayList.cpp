@@ -0,0 +1,482 @@
+// =====================================================
+// PdfDisplayList.cpp - Record / replay of page painter calls
+// =====================================================
+
+#include "pch.h"
+#include "PdfDisplayList.h"
+#include "PdfDebug.h"
+#include "PdfTrace.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pdf
+{
+    // =====================================================
+    // Replay
+    // =====================================================
+    void PdfDisplayList::replay(IPdfPainter& painter, double minY, double maxY) const
+    {
+        PDF_TRACE_SCOPE(Page, "replay", "%zu commands, y %.1f..%.1f", _cmds.size(), minY, maxY);
+        static const std::vector<PdfPathSegment> kNoPath;
+
+        for (const Cmd& c : _cmds)
+        {
+            if (c.maxY < minY || c.minY > maxY)
+                continue;
+
+            const std::vector<PdfPathSegment>& path = (c.path >= 0) ? _paths[c.path] : kNoPath;
+
+            switch (c.op)
+            {
+            case Op::Fill:
+                if (c.clip >= 0)
+                    painter.fillPath(path, c.color, c.ctm, c.evenOdd, &_paths[c.clip], &c.ctm2, c.clipEvenOdd);
+                else
+                    painter.fillPath(path, c.color, c.ctm, c.evenOdd);
+                break;
+
+            case Op::Stroke:
+                painter.strokePath(path, c.color, c.v[0], c.ctm, c.lineCap, c.lineJoin, c.v[1]);
+                break;
+
+            case Op::FillGradient:
+                painter.fillPathWithGradient(path, _gradients[c.res], c.ctm, c.ctm2, c.evenOdd, c.alpha);
+                break;
+
+            case Op::FillPattern:
+                painter.fillPathWithPattern(path, _patterns[c.res], c.ctm, c.evenOdd, c.alpha);
+                break;
+
+            case Op::Text:
+                painter.drawTextFreeTypeRaw(c.v[0], c.v[1], _strings[c.res], c.v[2], c.v[3],
+                    c.color, c.font, c.v[4], c.v[5], c.v[6], c.v[7]);
+                break;
+
+            case Op::Image:
+                painter.shareImage(_images[c.res]);
+                painter.drawImage(*_images[c.res], c.imgW, c.imgH, c.ctm, c.alpha);
+                break;
+
+            case Op::ImagePageClipRect:
+                painter.shareImage(_images[c.res]);
+                painter.drawImageWithPageClipRect(*_images[c.res], c.imgW, c.imgH, c.ctm,
+                    c.v[0], c.v[1], c.v[2], c.v[3], c.alpha);
+                break;
+
+            case Op::ImageClipped:
+                painter.shareImage(_images[c.res]);
+                painter.drawImageClipped(*_images[c.res], c.imgW, c.imgH, c.ctm,
+                    _paths[c.clip], c.ctm2, c.hasRectClip, c.v[0], c.v[1], c.v[2], c.v[3], c.alpha);
+                break;
+
+            case Op::BeginTextBlock:
+                painter.beginTextBlock();
+                break;
+
+            case Op::EndTextBlock:
+                painter.endTextBlock();
+                break;
+
+            case Op::PushClip:
+                painter.pushClipPath(path, c.ctm, c.evenOdd);
+                break;
+
+            case Op::PopClip:
+                painter.popClipPath();
+                break;
+
+            case Op::SetBlendMode:
+                painter.setBlendMode(c.blendMode);
+                break;
+
+            case Op::BeginGroup:
+                painter.beginTransparencyGroup(c.v[0], c.v[1], c.v[2], c.v[3], c.alpha);
+                break;
+
+            case Op::EndGroup:
+                painter.endTransparencyGroup();
+                break;
+            }
+        }
+    }
+
+    // =====================================================
+    // Recorder
+    // =====================================================
+    PdfDisplayListRecorder::PdfDisplayListRecorder(IPdfPainter& target)
+        : _target(target), _list(std::make_shared<PdfDisplayList>())
+    {
+    }
+
+    std::shared_ptr<PdfDisplayList> PdfDisplayListRecorder::finish(std::map<std::string, PdfFontInfo>&& fonts)
+    {
+        PdfDisplayList& l = *_list;
+        l._fonts = std::move(fonts);
+
+        size_t bytes = sizeof(PdfDisplayList) + l._cmds.capacity() * sizeof(PdfDisplayList::Cmd);
+        for (const auto& p : l._paths) bytes += sizeof(p) + p.capacity() * sizeof(PdfPathSegment);
+        for (const auto& img : l._images) bytes += sizeof(img) + img->capacity();
+        for (const auto& g : l._gradients)
+            bytes += sizeof(g) + g.stops.capacity() * sizeof(g.stops[0])
+                + (g.lutR.capacity() + g.lutG.capacity() + g.lutB.capacity()) * sizeof(float);
+        for (const auto& p : l._patterns) bytes += sizeof(p) + p.buffer.capacity() * sizeof(uint32_t);
+        for (const auto& s : l._strings) bytes += sizeof(s) + s.capacity();
+        for (const auto& kv : l._fonts) bytes += sizeof(kv) + kv.second.fontProgram.capacity();
+        l._bytes = bytes;
+
+        LogDebug("PdfDisplayList: %zu commands, %zu bytes, replayable=%d",
+            l._cmds.size(), l._bytes, l._replayable ? 1 : 0);
+        return std::move(_list);
+    }
+
+    PdfDisplayList::Cmd& PdfDisplayListRecorder::add(PdfDisplayList::Op op)
+    {
+        _list->_cmds.emplace_back();
+        PdfDisplayList::Cmd& c = _list->_cmds.back();
+        c.op = op;
+        return c;
+    }
+
+    int PdfDisplayListRecorder::addPath(const std::vector<PdfPathSegment>& path)
+    {
+        _list->_paths.push_back(path);
+        return (int)_list->_paths.size() - 1;
+    }
+
+    int PdfDisplayListRecorder::addImage(const std::vector<uint8_t>& argb)
+    {
+        auto& images = _list->_images;
+        if (!images.empty() && images.back().get() == &argb)
+            return (int)images.size() - 1;
+
+        // The parser shares its decoded buffer; anything else is copied
+        if (_sharedImage.get() == &argb)
+            images.push_back(std::move(_sharedImage));
+        else
+            images.push_back(std::make_shared<const std::vector<uint8_t>>(argb));
+        _sharedImage.reset();
+        return (int)images.size() - 1;
+    }
+
+    // Vertical extent of the path's control points (a Bezier stays inside
+    // their hull) after ctm, widened by pad page units
+    void PdfDisplayListRecorder::boundPath(PdfDisplayList::Cmd& c,
+        const std::vector<PdfPathSegment>& path, const PdfMatrix& ctm, double pad)
+    {
+        double lo = 1e30, hi = -1e30;
+        auto add = [&](double x, double y)
+            {
+                double py = ctm.b * x + ctm.d * y + ctm.f;
+                if (py < lo) lo = py;
+                if (py > hi) hi = py;
+            };
+
+        for (const auto& seg : path)
+        {
+            if (seg.type == PdfPathSegment::CurveTo)
+            {
+                add(seg.x1, seg.y1);
+                add(seg.x2, seg.y2);
+                add(seg.x3, seg.y3);
+            }
+            else if (seg.type != PdfPathSegment::Close)
+                add(seg.x, seg.y);
+        }
+
+        if (lo > hi) return;
+        c.minY = lo - pad;
+        c.maxY = hi + pad;
+    }
+
+    void PdfDisplayListRecorder::fillPath(
+        const std::vector<PdfPathSegment>& path,
+        uint32_t color,
+        const PdfMatrix& ctm,
+        bool evenOdd,
+        const std::vector<PdfPathSegment>* clipPath,
+        const PdfMatrix* clipCTM,
+        bool clipEvenOdd)
+    {
+        auto& c = add(PdfDisplayList::Op::Fill);
+        c.path = addPath(path);
+        c.color = color;
+        c.ctm = ctm;
+        c.evenOdd = evenOdd;
+        boundPath(c, path, ctm, 0.0);
+        if (clipPath && clipCTM)
+        {
+            c.clip = addPath(*clipPath);
+            c.ctm2 = *clipCTM;
+            c.clipEvenOdd = clipEvenOdd;
+        }
+
+        if (reachesTarget(c))
+            _target.fillPath(path, color, ctm, evenOdd, clipPath, clipCTM, clipEvenOdd);
+    }
+
+    void PdfDisplayListRecorder::strokePath(
+        const std::vector<PdfPathSegment>& path,
+        uint32_t color,
+        double lineWidth,
+        const PdfMatrix& ctm,
+        int lineCap,
+        int lineJoin,
+        double miterLimit)
+    {
+        auto& c = add(PdfDisplayList::Op::Stroke);
+        c.path = addPath(path);
+        c.color = color;
+        c.ctm = ctm;
+        c.lineCap = lineCap;
+        c.lineJoin = lineJoin;
+        c.v[0] = lineWidth;
+        c.v[1] = miterLimit;
+
+        // Half the width, stretched by the longest CTM axis, as far out as
+        // a miter join may reach
+        double axis = std::max(std::hypot(ctm.a, ctm.b), std::hypot(ctm.c, ctm.d));
+        double miter = std::max(miterLimit > 0 ? miterLimit : 10.0, 1.5);
+        boundPath(c, path, ctm, 0.5 * std::abs(lineWidth) * axis * miter);
+
+        if (reachesTarget(c))
+            _target.strokePath(path, color, lineWidth, ctm, lineCap, lineJoin, miterLimit);
+    }
+
+    void PdfDisplayListRecorder::fillPathWithGradient(
+        const std::vector<PdfPathSegment>& path,
+        const PdfGradient& gradient,
+        const PdfMatrix& ctm,
+        const PdfMatrix& gradientCTM,
+        bool evenOdd,
+        float alpha)
+    {
+        auto& c = add(PdfDisplayList::Op::FillGradient);
+        c.path = addPath(path);
+        _list->_gradients.push_back(gradient);
+        c.res = (int)_list->_gradients.size() - 1;
+        c.ctm = ctm;
+        c.ctm2 = gradientCTM;
+        c.evenOdd = evenOdd;
+        c.alpha = alpha;
+        boundPath(c, path, ctm, 0.0);
+
+        if (reachesTarget(c))
+            _target.fillPathWithGradient(path, gradient, ctm, gradientCTM, evenOdd, alpha);
+    }
+
+    void PdfDisplayListRecorder::fillPathWithPattern(
+        const std::vector<PdfPathSegment>& path,
+        const PdfPattern& pattern,
+        const PdfMatrix& ctm,
+        bool evenOdd,
+        float alpha)
+    {
+        auto& c = add(PdfDisplayList::Op::FillPattern);
+        c.path = addPath(path);
+        _list->_patterns.push_back(pattern);
+        c.res = (int)_list->_patterns.size() - 1;
+        c.ctm = ctm;
+        c.evenOdd = evenOdd;
+        c.alpha = alpha;
+        boundPath(c, path, ctm, 0.0);
+
+        if (reachesTarget(c))
+            _target.fillPathWithPattern(path, pattern, ctm, evenOdd, alpha);
+    }
+
+    double PdfDisplayListRecorder::drawTextFreeTypeRaw(
+        double x, double y,
+        const std::string& raw,
+        double fontSizePt,
+        double advanceSizePt,
+        uint32_t color,
+        const PdfFontInfo* font,
+        double charSpacing,
+        double wordSpacing,
+        double horizScale,
+        double textAngle)
+    {
+        // The parser advances the text matrix by what the target reports,
+        // so glyph positions are fixed by the recording render
+        double advance = _target.drawTextFreeTypeRaw(x, y, raw, fontSizePt, advanceSizePt,
+            color, font, charSpacing, wordSpacing, horizScale, textAngle);
+
+        auto& c = add(PdfDisplayList::Op::Text);
+        _list->_strings.push_back(raw);
+        c.res = (int)_list->_strings.size() - 1;
+        c.color = color;
+        c.font = font;
+        c.v[0] = x;
+        c.v[1] = y;
+        c.v[2] = fontSizePt;
+        c.v[3] = advanceSizePt;
+        c.v[4] = charSpacing;
+        c.v[5] = wordSpacing;
+        c.v[6] = horizScale;
+        c.v[7] = textAngle;
+
+        // Horizontal runs stay within a few ems of the baseline; rotated
+        // runs may cross any band
+        if (std::abs(std::sin(textAngle)) < 1e-6)
+        {
+            double em = std::max(std::abs(fontSizePt), std::abs(advanceSizePt));
+            c.minY = y - 4.0 * em;
+            c.maxY = y + 4.0 * em;
+        }
+        return advance;
+    }
+
+    void PdfDisplayListRecorder::drawImage(
+        const std::vector<uint8_t>& argb,
+        int imgW, int imgH,
+        const PdfMatrix& ctm,
+        float alpha)
+    {
+        _target.drawImage(argb, imgW, imgH, ctm, alpha);
+
+        auto& c = add(PdfDisplayList::Op::Image);
+        c.res = addImage(argb);
+        c.imgW = imgW;
+        c.imgH = imgH;
+        c.ctm = ctm;
+        c.alpha = alpha;
+    }
+
+    void PdfDisplayListRecorder::drawImageWithClipRect(
+        const std::vector<uint8_t>& argb,
+        int imgW, int imgH,
+        const PdfMatrix& ctm,
+        int clipMinX, int clipMinY,
+        int clipMaxX, int clipMaxY,
+        float alpha)
+    {
+        // Device-pixel clip: only valid at the recording resolution
+        _target.drawImageWithClipRect(argb, imgW, imgH, ctm,
+            clipMinX, clipMinY, clipMaxX, clipMaxY, alpha);
+        _list->_replayable = false;
+    }
+
+    void PdfDisplayListRecorder::drawImageWithPageClipRect(
+        const std::vector<uint8_t>& argb,
+        int imgW, int imgH,
+        const PdfMatrix& ctm,
+        double clipMinX, double clipMinY,
+        double clipMaxX, double clipMaxY,
+        float alpha)
+    {
+        auto& c = add(PdfDisplayList::Op::ImagePageClipRect);
+        c.res = addImage(argb);
+        c.imgW = imgW;
+        c.imgH = imgH;
+        c.ctm = ctm;
+        c.alpha = alpha;
+        c.v[0] = clipMinX;
+        c.v[1] = clipMinY;
+        c.v[2] = clipMaxX;
+        c.v[3] = clipMaxY;
+        c.minY = std::min(clipMinY, clipMaxY);
+        c.maxY = std::max(clipMinY, clipMaxY);
+
+        if (reachesTarget(c))
+            _target.drawImageWithPageClipRect(argb, imgW, imgH, ctm,
+                clipMinX, clipMinY, clipMaxX, clipMaxY, alpha);
+    }
+
+    void PdfDisplayListRecorder::drawImageClipped(
+        const std::vector<uint8_t>& argb,
+        int imgW, int imgH,
+        const PdfMatrix& ctm,
+        const std::vector<PdfPathSegment>& clipPath,
+        const PdfMatrix& clipCTM,
+        bool hasRectClip,
+        double rectMinX, double rectMinY,
+        double rectMaxX, double rectMaxY,
+        float alpha)
+    {
+        auto& c = add(PdfDisplayList::Op::ImageClipped);
+        c.res = addImage(argb);
+        c.clip = addPath(clipPath);
+        c.imgW = imgW;
+        c.imgH = imgH;
+        c.ctm = ctm;
+        c.ctm2 = clipCTM;
+        c.hasRectClip = hasRectClip;
+        c.alpha = alpha;
+        c.v[0] = rectMinX;
+        c.v[1] = rectMinY;
+        c.v[2] = rectMaxX;
+        c.v[3] = rectMaxY;
+        boundPath(c, clipPath, clipCTM, 0.0);
+
+        if (reachesTarget(c))
+            _target.drawImageClipped(argb, imgW, imgH, ctm, clipPath, clipCTM,
+                hasRectClip, rectMinX, rectMinY, rectMaxX, rectMaxY, alpha);
+    }
+
+    void PdfDisplayListRecorder::beginTextBlock()
+    {
+        _target.beginTextBlock();
+        add(PdfDisplayList::Op::BeginTextBlock);
+    }
+
+    void PdfDisplayListRecorder::endTextBlock()
+    {
+        _target.endTextBlock();
+        add(PdfDisplayList::Op::EndTextBlock);
+    }
+
+    void PdfDisplayListRecorder::pushClipPath(const std::vector<PdfPathSegment>& clipPath, const PdfMatrix& clipCTM, bool evenOdd)
+    {
+        _target.pushClipPath(clipPath, clipCTM, evenOdd);
+
+        auto& c = add(PdfDisplayList::Op::PushClip);
+        c.path = addPath(clipPath);
+        c.ctm = clipCTM;
+        c.evenOdd = evenOdd;
+    }
+
+    void PdfDisplayListRecorder::popClipPath()
+    {
+        _target.popClipPath();
+        add(PdfDisplayList::Op::PopClip);
+    }
+
+    void PdfDisplayListRecorder::pushSoftMask(const std::vector<uint8_t>& maskAlpha,
+        int maskX, int maskY, int maskW, int maskH)
+    {
+        // The mask was rasterized at the target's resolution
+        _target.pushSoftMask(maskAlpha, maskX, maskY, maskW, maskH);
+        _smaskWasRequested = true;
+        _list->_replayable = false;
+    }
+
+    // State change: keeps the whole-page extent, so every band replays it
+    void PdfDisplayListRecorder::setBlendMode(PdfBlendMode mode)
+    {
+        _target.setBlendMode(mode);
+        _blendMode = mode;
+
+        auto& c = add(PdfDisplayList::Op::SetBlendMode);
+        c.blendMode = mode;
+    }
+
+    // Begin and end keep the whole-page extent too: a band outside the
+    // group's rect still pushes and pops its (empty) layer
+    void PdfDisplayListRecorder::beginTransparencyGroup(double minX, double minY, double maxX, double maxY, float alpha)
+    {
+        _target.beginTransparencyGroup(minX, minY, maxX, maxY, alpha);
+
+        auto& c = add(PdfDisplayList::Op::BeginGroup);
+        c.v[0] = minX; c.v[1] = minY;
+        c.v[2] = maxX; c.v[3] = maxY;
+        c.alpha = alpha;
+    }
+
+    void PdfDisplayListRecorder::endTransparencyGroup()
+    {
+        _target.endTransparencyGroup();
+        add(PdfDisplayList::Op::EndGroup);
+    }
+
+} // namespace pdf
@@ -0,0 +1,254 @@
+#pragma once
+// =====================================================
+// PdfDisplayList.h - Recorded page drawing commands
+// =====================================================
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "IPdfPainter.h"
+#include "PdfPainter.h"
+
+namespace pdf
+{
+    // =====================================================
+    // PdfDisplayList
+    // The painter calls one content stream pass produced for a page:
+    // paths with their CTMs, resolved ARGB colors, glyph runs with their
+    // font, decoded images, clip push/pop. Everything is in page space,
+    // so a page parsed once replays into a painter of any size or zoom
+    // without touching the content stream again.
+    // =====================================================
+    class PdfDisplayList
+    {
+    public:
+        // Replays every command; beginPage/endPage stay with the caller.
+        // With a page-space y range only commands that can reach it are
+        // replayed (band painters skip what lies outside their rows).
+        void replay(IPdfPainter& painter, double minY = -1e30, double maxY = 1e30) const;
+
+        // False when the page drew something tied to the recording
+        // resolution (soft masks are rendered at device size). Such
+        // pages are interpreted again on every render.
+        bool replayable() const { return _replayable; }
+
+        size_t byteSize() const { return _bytes; }
+        size_t commandCount() const { return _cmds.size(); }
+
+    private:
+        friend class PdfDisplayListRecorder;
+
+        enum class Op : uint8_t
+        {
+            Fill,
+            Stroke,
+            FillGradient,
+            FillPattern,
+            Text,
+            Image,
+            ImagePageClipRect,
+            ImageClipped,
+            BeginTextBlock,
+            EndTextBlock,
+            PushClip,
+            PopClip,
+            SetBlendMode,
+            BeginGroup,
+            EndGroup
+        };
+
+        struct Cmd
+        {
+            Op op = Op::Fill;
+            bool evenOdd = false;
+            bool clipEvenOdd = false;
+            bool hasRectClip = false;
+            PdfBlendMode blendMode = PdfBlendMode::Normal;
+            uint32_t color = 0;
+            float alpha = 1.0f;
+            int lineCap = 0;
+            int lineJoin = 0;
+            int path = -1;          // index into _paths
+            int clip = -1;          // index into _paths (fill / image clip)
+            int res = -1;           // _images, _gradients, _patterns or _strings
+            int imgW = 0, imgH = 0;
+            PdfMatrix ctm;
+            PdfMatrix ctm2;         // clip or gradient CTM
+            double v[8] = {};       // op-specific scalars
+            const PdfFontInfo* font = nullptr;
+            double minY = -1e30;    // page-space vertical extent, for
+            double maxY = 1e30;     // band culling (unknown = whole page)
+        };
+
+        std::vector<Cmd> _cmds;
+        std::vector<std::vector<PdfPathSegment>> _paths;
+        std::vector<std::shared_ptr<const std::vector<uint8_t>>> _images;
+        std::vector<PdfGradient> _gradients;
+        std::vector<PdfPattern> _patterns;
+        std::vector<std::string> _strings;
+
+        // Glyph runs point into this map; nodes keep their address when
+        // the map is moved in from the render that recorded the list
+        std::map<std::string, PdfFontInfo> _fonts;
+
+        bool _replayable = true;
+        size_t _bytes = 0;
+    };
+
+    // =====================================================
+    // PdfDisplayListRecorder
+    // Painter that forwards every call to the real target and records
+    // it at the same time, so the recording render costs one pass.
+    // Queries (size, scale, text advance) are answered by the target.
+    // =====================================================
+    class PdfDisplayListRecorder : public IPdfPainter
+    {
+    public:
+        explicit PdfDisplayListRecorder(IPdfPainter& target);
+
+        // Ends recording; the fonts the page was parsed with move into the list
+        std::shared_ptr<PdfDisplayList> finish(std::map<std::string, PdfFontInfo>&& fonts);
+
+        // Band targets: paths and clipped images that cannot reach this
+        // page-space y range are recorded but not drawn. Text is always
+        // drawn, the parser needs its advance.
+        void setTargetRange(double minY, double maxY) { _targetMinY = minY; _targetMaxY = maxY; }
+
+        int width() const override { return _target.width(); }
+        int height() const override { return _target.height(); }
+        double scaleX() const override { return _target.scaleX(); }
+        double scaleY() const override { return _target.scaleY(); }
+        int pageHeight() const override { return _target.pageHeight(); }
+
+        void clear(uint32_t bgraColor) override { _target.clear(bgraColor); }
+
+        void fillPath(
+            const std::vector<PdfPathSegment>& path,
+            uint32_t color,
+            const PdfMatrix& ctm,
+            bool evenOdd = false,
+            const std::vector<PdfPathSegment>* clipPath = nullptr,
+            const PdfMatrix* clipCTM = nullptr,
+            bool clipEvenOdd = false) override;
+
+        void strokePath(
+            const std::vector<PdfPathSegment>& path,
+            uint32_t color,
+            double lineWidth,
+            const PdfMatrix& ctm,
+            int lineCap = 0,
+            int lineJoin = 0,
+            double miterLimit = 10.0) override;
+
+        void fillPathWithGradient(
+            const std::vector<PdfPathSegment>& path,
+            const PdfGradient& gradient,
+            const PdfMatrix& ctm,
+            const PdfMatrix& gradientCTM,
+            bool evenOdd = false,
+            float alpha = 1.0f) override;
+
+        void fillPathWithPattern(
+            const std::vector<PdfPathSegment>& path,
+            const PdfPattern& pattern,
+            const PdfMatrix& ctm,
+            bool evenOdd = false,
+            float alpha = 1.0f) override;
+
+        double drawTextFreeTypeRaw(
+            double x, double y,
+            const std::string& raw,
+            double fontSizePt,
+            double advanceSizePt,
+            uint32_t color,
+            const PdfFontInfo* font,
+            double charSpacing,
+            double wordSpacing,
+            double horizScale,
+            double textAngle = 0.0) override;
+
+        void drawImage(
+            const std::vector<uint8_t>& argb,
+            int imgW, int imgH,
+            const PdfMatrix& ctm,
+            float alpha = 1.0f) override;
+
+        void drawImageWithClipRect(
+            const std::vector<uint8_t>& argb,
+            int imgW, int imgH,
+            const PdfMatrix& ctm,
+            int clipMinX, int clipMinY,
+            int clipMaxX, int clipMaxY,
+            float alpha = 1.0f) override;
+
+        void drawImageWithPageClipRect(
+            const std::vector<uint8_t>& argb,
+            int imgW, int imgH,
+            const PdfMatrix& ctm,
+            double clipMinX, double clipMinY,
+            double clipMaxX, double clipMaxY,
+            float alpha = 1.0f) override;
+
+        void drawImageClipped(
+            const std::vector<uint8_t>& argb,
+            int imgW, int imgH,
+            const PdfMatrix& ctm,
+            const std::vector<PdfPathSegment>& clipPath,
+            const PdfMatrix& clipCTM,
+            bool hasRectClip = false,
+            double rectMinX = 0, double rectMinY = 0,
+            double rectMaxX = 0, double rectMaxY = 0,
+            float alpha = 1.0f) override;
+
+        void setPageRotation(int degrees, double pageWPt, double pageHPt) override
+        {
+            _target.setPageRotation(degrees, pageWPt, pageHPt);
+        }
+
+        std::vector<uint8_t> getBuffer() override { return _target.getBuffer(); }
+        bool isGPU() const override { return _target.isGPU(); }
+
+        void beginPage() override { _target.beginPage(); }
+        void endPage() override { _target.endPage(); }
+        void beginTextBlock() override;
+        void endTextBlock() override;
+
+        void pushClipPath(const std::vector<PdfPathSegment>& clipPath, const PdfMatrix& clipCTM, bool evenOdd = false) override;
+        void popClipPath() override;
+
+        void pushSoftMask(const std::vector<uint8_t>& maskAlpha,
+            int maskX, int maskY, int maskW, int maskH) override;
+        void popSoftMask() override { _target.popSoftMask(); }
+
+        void beginTransparencyGroup(double minX, double minY, double maxX, double maxY, float alpha) override;
+        void endTransparencyGroup() override;
+
+        void setBlendMode(PdfBlendMode mode) override;
+
+        void shareImage(const std::shared_ptr<const std::vector<uint8_t>>& argb) override
+        {
+            _target.shareImage(argb);
+            _sharedImage = argb;
+        }
+
+    private:
+        PdfDisplayList::Cmd& add(PdfDisplayList::Op op);
+        int addPath(const std::vector<PdfPathSegment>& path);
+        int addImage(const std::vector<uint8_t>& argb);
+        static void boundPath(PdfDisplayList::Cmd& c, const std::vector<PdfPathSegment>& path,
+            const PdfMatrix& ctm, double pad);
+        bool reachesTarget(const PdfDisplayList::Cmd& c) const
+        {
+            return !(c.maxY < _targetMinY || c.minY > _targetMaxY);
+        }
+
+        IPdfPainter& _target;
+        std::shared_ptr<PdfDisplayList> _list;
+        std::shared_ptr<const std::vector<uint8_t>> _sharedImage;
+        double _targetMinY = -1e30;
+        double _targetMaxY = 1e30;
+    };
+
+} // namespace pdf
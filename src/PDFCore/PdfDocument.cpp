@@ -7,11 +7,16 @@
 #include "PdfDocument.h"
 #include "IPdfPainter.h"
 #include "PdfPainter.h"
+#ifndef PDFCORE_HEADLESS
 #include "PdfPainterGPU.h"
+#endif
 #include "PdfContentParser.h"
+#include "PdfDisplayList.h"
 #include "PdfEngine.h"
 #include "PdfDebug.h"
+#include "PdfTrace.h"
 #include "FontCache.h"
+#include "PdfPlatform.h"
 #include "zlib.h"
 #include "PdfFilters.h"
 #include "Jbig2Decoder.h"
@@ -24,6 +29,21 @@
 #include <fstream>
 #include <iterator>
 #include <mutex>
+
+// AES-NI for bulk stream decryption (runtime-detected, x86/x64 only)
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PDF_AES_NI 1
+#include <wmmintrin.h>
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define PDF_AES_NI_TARGET
+#else
+#define PDF_AES_NI_TARGET __attribute__((target("aes,sse2")))
+#endif
+#else
+#define PDF_AES_NI 0
+#endif
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_ADVANCES_H
@@ -35,7 +55,8 @@ namespace pdf
 
     // ============================================
     // SYSTEM FONT RESOLVER
-    // Maps PDF base font names to Windows system font paths
+    // Maps PDF base font names to system font paths
+    // (Windows font names; see platform::systemFontPath for substitutes)
     // Handles: Standard 14 PDF fonts, Times, Arial, Courier, etc.
     // ============================================
     static std::string resolveSystemFontPath(const std::string& baseFont)
@@ -55,13 +76,13 @@ namespace pdf
             bool isItalic = (name.find("Italic") != std::string::npos ||
                 name.find("Oblique") != std::string::npos);
             if (isBold && isItalic)
-                return "C:\\Windows\\Fonts\\timesbi.ttf";
+                return platform::systemFontPath("timesbi.ttf");
             else if (isBold)
-                return "C:\\Windows\\Fonts\\timesbd.ttf";
+                return platform::systemFontPath("timesbd.ttf");
             else if (isItalic)
-                return "C:\\Windows\\Fonts\\timesi.ttf";
+                return platform::systemFontPath("timesi.ttf");
             else
-                return "C:\\Windows\\Fonts\\times.ttf";
+                return platform::systemFontPath("times.ttf");
         }
 
         // --- Arial / Helvetica family ---
@@ -72,13 +93,13 @@ namespace pdf
             bool isItalic = (name.find("Italic") != std::string::npos ||
                 name.find("Oblique") != std::string::npos);
             if (isBold && isItalic)
-                return "C:\\Windows\\Fonts\\arialbi.ttf";
+                return platform::systemFontPath("arialbi.ttf");
             else if (isBold)
-                return "C:\\Windows\\Fonts\\arialbd.ttf";
+                return platform::systemFontPath("arialbd.ttf");
             else if (isItalic)
-                return "C:\\Windows\\Fonts\\ariali.ttf";
+                return platform::systemFontPath("ariali.ttf");
             else
-                return "C:\\Windows\\Fonts\\arial.ttf";
+                return platform::systemFontPath("arial.ttf");
         }
 
         // --- Courier family ---
@@ -88,64 +109,64 @@ namespace pdf
             bool isItalic = (name.find("Italic") != std::string::npos ||
                 name.find("Oblique") != std::string::npos);
             if (isBold && isItalic)
-                return "C:\\Windows\\Fonts\\courbi.ttf";
+                return platform::systemFontPath("courbi.ttf");
             else if (isBold)
-                return "C:\\Windows\\Fonts\\courbd.ttf";
+                return platform::systemFontPath("courbd.ttf");
             else if (isItalic)
-                return "C:\\Windows\\Fonts\\couri.ttf";
+                return platform::systemFontPath("couri.ttf");
             else
-                return "C:\\Windows\\Fonts\\cour.ttf";
+                return platform::systemFontPath("cour.ttf");
         }
 
         // --- Symbol ---
         if (name.find("Symbol") != std::string::npos) {
-            return "C:\\Windows\\Fonts\\symbol.ttf";
+            return platform::systemFontPath("symbol.ttf");
         }
 
         // --- ZapfDingbats ---
         if (name.find("ZapfDingbats") != std::string::npos ||
             name.find("Dingbats") != std::string::npos) {
-            return "C:\\Windows\\Fonts\\wingding.ttf";
+            return platform::systemFontPath("wingding.ttf");
         }
 
         // --- Georgia ---
         if (name.find("Georgia") != std::string::npos) {
             if (name.find("Bold") != std::string::npos && name.find("Italic") != std::string::npos)
-                return "C:\\Windows\\Fonts\\georgiaz.ttf";
+                return platform::systemFontPath("georgiaz.ttf");
             else if (name.find("Bold") != std::string::npos)
-                return "C:\\Windows\\Fonts\\georgiab.ttf";
+                return platform::systemFontPath("georgiab.ttf");
             else if (name.find("Italic") != std::string::npos)
-                return "C:\\Windows\\Fonts\\georgiai.ttf";
+                return platform::systemFontPath("georgiai.ttf");
             else
-                return "C:\\Windows\\Fonts\\georgia.ttf";
+                return platform::systemFontPath("georgia.ttf");
         }
 
         // --- Verdana ---
         if (name.find("Verdana") != std::string::npos) {
             if (name.find("Bold") != std::string::npos && name.find("Italic") != std::string::npos)
-                return "C:\\Windows\\Fonts\\verdanaz.ttf";
+                return platform::systemFontPath("verdanaz.ttf");
             else if (name.find("Bold") != std::string::npos)
-                return "C:\\Windows\\Fonts\\verdanab.ttf";
+                return platform::systemFontPath("verdanab.ttf");
             else if (name.find("Italic") != std::string::npos)
-                return "C:\\Windows\\Fonts\\verdanai.ttf";
+                return platform::systemFontPath("verdanai.ttf");
             else
-                return "C:\\Windows\\Fonts\\verdana.ttf";
+                return platform::systemFontPath("verdana.ttf");
         }
 
         // --- Calibri ---
         if (name.find("Calibri") != std::string::npos) {
             if (name.find("Bold") != std::string::npos && name.find("Italic") != std::string::npos)
-                return "C:\\Windows\\Fonts\\calibriz.ttf";
+                return platform::systemFontPath("calibriz.ttf");
             else if (name.find("Bold") != std::string::npos)
-                return "C:\\Windows\\Fonts\\calibrib.ttf";
+                return platform::systemFontPath("calibrib.ttf");
             else if (name.find("Italic") != std::string::npos)
-                return "C:\\Windows\\Fonts\\calibrii.ttf";
+                return platform::systemFontPath("calibrii.ttf");
             else
-                return "C:\\Windows\\Fonts\\calibri.ttf";
+                return platform::systemFontPath("calibri.ttf");
         }
 
         // --- Default fallback: Arial ---
-        return "C:\\Windows\\Fonts\\arial.ttf";
+        return platform::systemFontPath("arial.ttf");
     }
 
     // ============================================
@@ -168,15 +189,12 @@ namespace pdf
         return v;
     }
 
-    static std::shared_ptr<PdfObject> dictGetAny(
+    // Null-safe lookup; keys are normalized, so "/X" and "X" match alike
+    static std::shared_ptr<PdfObject> dictGet(
         const std::shared_ptr<PdfDictionary>& d,
-        const char* keyWithSlash,
-        const char* keyNoSlash)
+        PdfAtom key)
     {
-        if (!d) return nullptr;
-        auto o = d->get(keyWithSlash);
-        if (!o) o = d->get(keyNoSlash);
-        return o;
+        return d ? d->get(key) : nullptr;
     }
 
 
@@ -227,7 +245,7 @@ namespace pdf
     // 👇 EKLEDİĞİMİZ ToUnicode CMap PARSER
     // =========================================================
     static void parseToUnicodeCMap(
-        const std::vector<uint8_t>& data,
+        PdfByteView data,
         PdfFontInfo& info)
     {
         std::string s(data.begin(), data.end());
@@ -617,6 +635,7 @@ namespace pdf
 
     PdfDocument::PdfDocument()
     {
+        std::lock_guard<std::mutex> ftLock(freeTypeLibraryMutex());
         if (!g_ftLib)
             FT_Init_FreeType(&g_ftLib);
     }
@@ -661,17 +680,17 @@ namespace pdf
         auto page = getPageDictionary(pageIndex);
         if (!page) return false;
 
-        std::set<int> v;
+        PdfVisitedRefs v;
 
         // -------- Resources --------
-        auto resObj = resolveIndirect(dictGetAny(page, "/Resources", "Resources"), v);
-        auto res = std::dynamic_pointer_cast<PdfDictionary>(resObj);
+        auto resObj = resolveIndirect(dictGet(page, PdfKeys::Resources), v);
+        auto res = pdfCast<PdfDictionary>(resObj);
         if (!res) return true; // fonts yoksa "true" dönebilir
 
         // -------- Font dict --------
         v.clear();
-        auto fontObj = resolveIndirect(dictGetAny(res, "/Font", "Font"), v);
-        auto fontDict = std::dynamic_pointer_cast<PdfDictionary>(fontObj);
+        auto fontObj = resolveIndirect(dictGet(res, PdfKeys::Font), v);
+        auto fontDict = pdfCast<PdfDictionary>(fontObj);
         if (!fontDict) return true;
 
         // -------- Iterate fonts (/F1, /F2...) --------
@@ -681,7 +700,7 @@ namespace pdf
 
             // resourceName normalize: "/F1"
             {
-                std::string rn = kv.first;          // bazen "F1" bazen "/F1"
+                std::string rn = kv.first.str();          // bazen "F1" bazen "/F1"
                 if (!rn.empty() && rn[0] != '/')
                     rn = "/" + rn;
                 info.resourceName = rn;
@@ -690,31 +709,31 @@ namespace pdf
             // Resolve font dictionary
             v.clear();
             auto fdictObj = resolveIndirect(kv.second, v);
-            auto fdict = std::dynamic_pointer_cast<PdfDictionary>(fdictObj);
+            auto fdict = pdfCast<PdfDictionary>(fdictObj);
             if (!fdict) continue;
 
             // Subtype / BaseFont / Encoding
-            if (auto s = std::dynamic_pointer_cast<PdfName>(dictGetAny(fdict, "/Subtype", "Subtype")))
+            if (auto s = pdfCast<PdfName>(dictGet(fdict, PdfKeys::Subtype)))
                 info.subtype = s->value;
 
-            if (auto b = std::dynamic_pointer_cast<PdfName>(dictGetAny(fdict, "/BaseFont", "BaseFont")))
+            if (auto b = pdfCast<PdfName>(dictGet(fdict, PdfKeys::BaseFont)))
                 info.baseFont = b->value;
 
             // ===== TYPE3 FONT DETECTION =====
-            if (info.subtype == "/Type3" || info.subtype == "Type3")
+            if (info.subtype == "/Type3")
             {
                 info.isType3 = true;
                 LogDebug("    Type3 font detected: '%s'", info.resourceName.c_str());
 
                 // Parse FontMatrix
                 {
-                    auto fmObj = dictGetAny(fdict, "/FontMatrix", "FontMatrix");
+                    auto fmObj = dictGet(fdict, PdfKeys::FontMatrix);
                     if (fmObj) {
-                        std::set<int> vfm;
-                        auto fmArr = std::dynamic_pointer_cast<PdfArray>(resolveIndirect(fmObj, vfm));
+                        PdfVisitedRefs vfm;
+                        auto fmArr = pdfCast<PdfArray>(resolveIndirect(fmObj, vfm));
                         if (fmArr && fmArr->items.size() >= 6) {
                             auto getN = [](const std::shared_ptr<PdfObject>& o) -> double {
-                                auto n = std::dynamic_pointer_cast<PdfNumber>(o);
+                                auto n = pdfCast<PdfNumber>(o);
                                 return n ? n->value : 0.0;
                             };
                             info.type3FontMatrix.a = getN(fmArr->items[0]);
@@ -733,24 +752,24 @@ namespace pdf
 
                 // Parse CharProcs dictionary
                 {
-                    std::set<int> vcp;
-                    auto cpObj = resolveIndirect(dictGetAny(fdict, "/CharProcs", "CharProcs"), vcp);
-                    auto cpDict = std::dynamic_pointer_cast<PdfDictionary>(cpObj);
+                    PdfVisitedRefs vcp;
+                    auto cpObj = resolveIndirect(dictGet(fdict, PdfKeys::CharProcs), vcp);
+                    auto cpDict = pdfCast<PdfDictionary>(cpObj);
                     if (cpDict) {
                         for (auto& cpKv : cpDict->entries) {
-                            std::string glyphName = cpKv.first;
+                            std::string glyphName = cpKv.first.str();
                             if (!glyphName.empty() && glyphName[0] == '/')
                                 glyphName.erase(0, 1);
 
-                            std::set<int> vcps;
+                            PdfVisitedRefs vcps;
                             auto streamObj = resolveIndirect(cpKv.second, vcps);
-                            auto stream = std::dynamic_pointer_cast<PdfStream>(streamObj);
+                            auto stream = pdfCast<PdfStream>(streamObj);
                             if (stream) {
                                 std::vector<uint8_t> decoded;
                                 if (decodeStream(stream, decoded))
                                     info.type3CharProcs[glyphName] = std::move(decoded);
                                 else
-                                    info.type3CharProcs[glyphName] = stream->data;
+                                    info.type3CharProcs[glyphName] = stream->data.toVector();
                             }
                         }
                         LogDebug("    CharProcs: %zu glyphs loaded", info.type3CharProcs.size());
@@ -759,9 +778,9 @@ namespace pdf
 
                 // Parse Type3 Resources
                 {
-                    std::set<int> vres;
-                    auto resObj2 = resolveIndirect(dictGetAny(fdict, "/Resources", "Resources"), vres);
-                    info.type3Resources = std::dynamic_pointer_cast<PdfDictionary>(resObj2);
+                    PdfVisitedRefs vres;
+                    auto resObj2 = resolveIndirect(dictGet(fdict, PdfKeys::Resources), vres);
+                    info.type3Resources = pdfCast<PdfDictionary>(resObj2);
                 }
 
                 // Compute fontHash for caching
@@ -772,40 +791,40 @@ namespace pdf
 
             // ---- Encoding ----
             {
-                auto encObj = dictGetAny(fdict, "/Encoding", "Encoding");
+                auto encObj = dictGet(fdict, PdfKeys::Encoding);
                 if (encObj)
                 {
                     // Encoding bir /Name olabilir (örn. /WinAnsiEncoding)
-                    if (auto e = std::dynamic_pointer_cast<PdfName>(encObj))
+                    if (auto e = pdfCast<PdfName>(encObj))
                     {
                         info.encoding = e->value;
                     }
                     // Veya bir Dictionary olabilir (içinde /Differences var)
                     else
                     {
-                        std::set<int> venc;
+                        PdfVisitedRefs venc;
                         auto encDictObj = resolveIndirect(encObj, venc);
-                        auto encDict = std::dynamic_pointer_cast<PdfDictionary>(encDictObj);
+                        auto encDict = pdfCast<PdfDictionary>(encDictObj);
                         if (encDict)
                         {
                             // BaseEncoding varsa oku
-                            if (auto be = std::dynamic_pointer_cast<PdfName>(dictGetAny(encDict, "/BaseEncoding", "BaseEncoding")))
+                            if (auto be = pdfCast<PdfName>(dictGet(encDict, PdfKeys::BaseEncoding)))
                                 info.encoding = be->value;
 
                             // /Differences array'ini parse et
-                            auto diffObj = dictGetAny(encDict, "/Differences", "Differences");
-                            auto diffArr = std::dynamic_pointer_cast<PdfArray>(diffObj);
+                            auto diffObj = dictGet(encDict, PdfKeys::Differences);
+                            auto diffArr = pdfCast<PdfArray>(diffObj);
                             if (diffArr && !diffArr->items.empty())
                             {
                                 int currentCode = 0;
                                 for (auto& item : diffArr->items)
                                 {
-                                    if (auto num = std::dynamic_pointer_cast<PdfNumber>(item))
+                                    if (auto num = pdfCast<PdfNumber>(item))
                                     {
                                         // Yeni başlangıç kodu
                                         currentCode = (int)num->value;
                                     }
-                                    else if (auto name = std::dynamic_pointer_cast<PdfName>(item))
+                                    else if (auto name = pdfCast<PdfName>(item))
                                     {
                                         // Glyph ismi -> Unicode dönüşümü
                                         std::string glyphName = name->value;
@@ -833,9 +852,9 @@ namespace pdf
 
             // ---- ToUnicode (decode ederek) ----
             {
-                std::set<int> vt;
-                auto tuObj = resolveIndirect(dictGetAny(fdict, "/ToUnicode", "ToUnicode"), vt);
-                auto tu = std::dynamic_pointer_cast<PdfStream>(tuObj);
+                PdfVisitedRefs vt;
+                auto tuObj = resolveIndirect(dictGet(fdict, PdfKeys::ToUnicode), vt);
+                auto tu = pdfCast<PdfStream>(tuObj);
 
                 LogDebug("[Font] %s (baseFont=%s): ToUnicode stream %s",
                     info.resourceName.c_str(), info.baseFont.c_str(),
@@ -860,26 +879,26 @@ namespace pdf
 
             // ---- Embedded font program (FontDescriptor -> FontFile2/FontFile3) ----
             {
-                std::set<int> vfdesc;
-                auto fdObj = resolveIndirect(dictGetAny(fdict, "/FontDescriptor", "FontDescriptor"), vfdesc);
-                auto fd = std::dynamic_pointer_cast<PdfDictionary>(fdObj);
+                PdfVisitedRefs vfdesc;
+                auto fdObj = resolveIndirect(dictGet(fdict, PdfKeys::FontDescriptor), vfdesc);
+                auto fd = pdfCast<PdfDictionary>(fdObj);
 
                 // Type0 (CID) ise descriptor descendant font içinde olabilir
                 if (!fd && info.subtype == "/Type0")
                 {
-                    std::set<int> vd2;
-                    auto descObj2 = resolveIndirect(dictGetAny(fdict, "/DescendantFonts", "DescendantFonts"), vd2);
-                    auto descArr2 = std::dynamic_pointer_cast<PdfArray>(descObj2);
+                    PdfVisitedRefs vd2;
+                    auto descObj2 = resolveIndirect(dictGet(fdict, PdfKeys::DescendantFonts), vd2);
+                    auto descArr2 = pdfCast<PdfArray>(descObj2);
                     if (descArr2 && !descArr2->items.empty())
                     {
                         vd2.clear();
                         auto cidObj2 = resolveIndirect(descArr2->items[0], vd2);
-                        auto cidDict2 = std::dynamic_pointer_cast<PdfDictionary>(cidObj2);
+                        auto cidDict2 = pdfCast<PdfDictionary>(cidObj2);
                         if (cidDict2)
                         {
                             vfdesc.clear();
-                            auto fdObj2 = resolveIndirect(dictGetAny(cidDict2, "/FontDescriptor", "FontDescriptor"), vfdesc);
-                            fd = std::dynamic_pointer_cast<PdfDictionary>(fdObj2);
+                            auto fdObj2 = resolveIndirect(dictGet(cidDict2, PdfKeys::FontDescriptor), vfdesc);
+                            fd = pdfCast<PdfDictionary>(fdObj2);
                         }
                     }
                 }
@@ -890,9 +909,9 @@ namespace pdf
 
                     // FontFile (Type 1 PFA/PFB) - en önce bu denen
                     {
-                        std::set<int> vff;
-                        auto ffObj = resolveIndirect(dictGetAny(fd, "/FontFile", "FontFile"), vff);
-                        ff = std::dynamic_pointer_cast<PdfStream>(ffObj);
+                        PdfVisitedRefs vff;
+                        auto ffObj = resolveIndirect(dictGet(fd, PdfKeys::FontFile), vff);
+                        ff = pdfCast<PdfStream>(ffObj);
                         if (ff)
                             info.fontProgramSubtype = "Type1";
                     }
@@ -900,9 +919,9 @@ namespace pdf
                     // FontFile2 (TrueType)
                     if (!ff)
                     {
-                        std::set<int> vff;
-                        auto ffObj = resolveIndirect(dictGetAny(fd, "/FontFile2", "FontFile2"), vff);
-                        ff = std::dynamic_pointer_cast<PdfStream>(ffObj);
+                        PdfVisitedRefs vff;
+                        auto ffObj = resolveIndirect(dictGet(fd, PdfKeys::FontFile2), vff);
+                        ff = pdfCast<PdfStream>(ffObj);
                         if (ff)
                             info.fontProgramSubtype = "TrueType";
                     }
@@ -910,14 +929,14 @@ namespace pdf
                     // FontFile3 (Type1C/CFF/OpenType)
                     if (!ff)
                     {
-                        std::set<int> vff;
-                        auto ffObj = resolveIndirect(dictGetAny(fd, "/FontFile3", "FontFile3"), vff);
-                        ff = std::dynamic_pointer_cast<PdfStream>(ffObj);
+                        PdfVisitedRefs vff;
+                        auto ffObj = resolveIndirect(dictGet(fd, PdfKeys::FontFile3), vff);
+                        ff = pdfCast<PdfStream>(ffObj);
 
                         if (ff && ff->dict)
                         {
                             // /Subtype in FontFile3 stream
-                            if (auto st = std::dynamic_pointer_cast<PdfName>(dictGetAny(ff->dict, "/Subtype", "Subtype")))
+                            if (auto st = pdfCast<PdfName>(dictGet(ff->dict, PdfKeys::Subtype)))
                                 info.fontProgramSubtype = st->value;
                             else
                                 info.fontProgramSubtype = "FontFile3";
@@ -930,7 +949,7 @@ namespace pdf
                         if (decodeStream(ff, decoded))
                             info.fontProgram = std::move(decoded);
                         else
-                            info.fontProgram = ff->data; // fallback
+                            info.fontProgram = ff->data.toVector(); // fallback
 
                         LogDebug("  Font '%s': Loaded %s font program (%zu bytes)",
                             info.resourceName.c_str(), info.fontProgramSubtype.c_str(), info.fontProgram.size());
@@ -942,17 +961,17 @@ namespace pdf
             if (info.subtype != "/Type0")
             {
                 // /FirstChar
-                if (auto fc = std::dynamic_pointer_cast<PdfNumber>(dictGetAny(fdict, "/FirstChar", "FirstChar")))
+                if (auto fc = pdfCast<PdfNumber>(dictGet(fdict, PdfKeys::FirstChar)))
                     info.firstChar = (int)fc->value;
 
                 // /MissingWidth (opsiyonel)
-                if (auto mw = std::dynamic_pointer_cast<PdfNumber>(dictGetAny(fdict, "/MissingWidth", "MissingWidth")))
+                if (auto mw = pdfCast<PdfNumber>(dictGet(fdict, PdfKeys::MissingWidth)))
                     info.missingWidth = (int)mw->value;
 
                 // /Widths
-                std::set<int> vw;
-                auto wObj = resolveIndirect(dictGetAny(fdict, "/Widths", "Widths"), vw);
-                auto wArr = std::dynamic_pointer_cast<PdfArray>(wObj);
+                PdfVisitedRefs vw;
+                auto wObj = resolveIndirect(dictGet(fdict, PdfKeys::Widths), vw);
+                auto wArr = pdfCast<PdfArray>(wObj);
 
                 info.widths.clear();
                 if (wArr && !wArr->items.empty())
@@ -960,7 +979,7 @@ namespace pdf
                     info.widths.reserve(wArr->items.size());
                     for (auto& itW : wArr->items)
                     {
-                        auto n = std::dynamic_pointer_cast<PdfNumber>(itW);
+                        auto n = pdfCast<PdfNumber>(itW);
                         info.widths.push_back(n ? (int)n->value : info.missingWidth);
                     }
                     info.hasWidths = true;
@@ -1021,7 +1040,7 @@ namespace pdf
                         "eth","ntilde","ograve","oacute","ocircumflex","otilde","odieresis","divide",
                         "oslash","ugrave","uacute","ucircumflex","udieresis","yacute","thorn","ydieresis"
                     };
-                    bool isWinAnsi = (info.encoding == "/WinAnsiEncoding" || info.encoding == "WinAnsiEncoding");
+                    bool isWinAnsi = (info.encoding == "/WinAnsiEncoding");
                     // WinAnsi glyph isimlerini doldur:
                     // - Açıkça WinAnsiEncoding ise: her zaman doldur
                     // - Encoding boşsa VE ToUnicode yoksa: CFF fontlar için doldur
@@ -1040,11 +1059,10 @@ namespace pdf
                 if (!info.fontProgram.empty())
                 {
                     FT_Face tempFace = nullptr;
-                    FT_Error err = FT_New_Memory_Face(
+                    FT_Error err = ftNewMemoryFace(
                         g_ftLib,
                         info.fontProgram.data(),
                         (FT_Long)info.fontProgram.size(),
-                        0,
                         &tempFace
                     );
 
@@ -1276,7 +1294,7 @@ namespace pdf
                             info.hasWidths = true;
                         }
 
-                        FT_Done_Face(tempFace);
+                        ftDoneFace(tempFace);
                     }
                 }
             }
@@ -1287,35 +1305,35 @@ namespace pdf
                 info.isCidFont = true;
 
                 // DescendantFonts[0] = CIDFontType0/2
-                std::set<int> vd;
-                auto descObj = resolveIndirect(dictGetAny(fdict, "/DescendantFonts", "DescendantFonts"), vd);
-                auto descArr = std::dynamic_pointer_cast<PdfArray>(descObj);
+                PdfVisitedRefs vd;
+                auto descObj = resolveIndirect(dictGet(fdict, PdfKeys::DescendantFonts), vd);
+                auto descArr = pdfCast<PdfArray>(descObj);
 
                 std::shared_ptr<PdfDictionary> cidFontDict;
                 if (descArr && !descArr->items.empty())
                 {
                     vd.clear();
                     auto cidObj = resolveIndirect(descArr->items[0], vd);
-                    cidFontDict = std::dynamic_pointer_cast<PdfDictionary>(cidObj);
+                    cidFontDict = pdfCast<PdfDictionary>(cidObj);
                 }
 
                 // Default width (DW) ve Width array (W)
                 if (cidFontDict)
                 {
                     // /DW - CID default width
-                    if (auto dw = std::dynamic_pointer_cast<PdfNumber>(dictGetAny(cidFontDict, "/DW", "DW"))) {
+                    if (auto dw = pdfCast<PdfNumber>(dictGet(cidFontDict, PdfKeys::DW))) {
                         info.cidDefaultWidth = (int)dw->value;
                         info.missingWidth = (int)dw->value;
                     }
 
                     // /W - CID width array
                     // Format: [ cid [w1 w2 ...] ] veya [ cid1 cid2 w ]
-                    if (auto wArr = std::dynamic_pointer_cast<PdfArray>(dictGetAny(cidFontDict, "/W", "W")))
+                    if (auto wArr = pdfCast<PdfArray>(dictGet(cidFontDict, PdfKeys::W)))
                     {
                         size_t idx = 0;
                         while (idx < wArr->items.size())
                         {
-                            auto cidStart = std::dynamic_pointer_cast<PdfNumber>(wArr->items[idx]);
+                            auto cidStart = pdfCast<PdfNumber>(wArr->items[idx]);
                             if (!cidStart) { idx++; continue; }
 
                             int startCid = (int)cidStart->value;
@@ -1324,19 +1342,19 @@ namespace pdf
                             if (idx >= wArr->items.size()) break;
 
                             // Sonraki eleman array mi yoksa number mi?
-                            if (auto widthArr = std::dynamic_pointer_cast<PdfArray>(wArr->items[idx]))
+                            if (auto widthArr = pdfCast<PdfArray>(wArr->items[idx]))
                             {
                                 // Format: cid [w1 w2 w3 ...]
                                 int cid = startCid;
                                 for (auto& wItem : widthArr->items)
                                 {
-                                    if (auto wNum = std::dynamic_pointer_cast<PdfNumber>(wItem))
+                                    if (auto wNum = pdfCast<PdfNumber>(wItem))
                                         info.cidWidths[(uint16_t)cid] = (int)wNum->value;
                                     cid++;
                                 }
                                 idx++;
                             }
-                            else if (auto cidEnd = std::dynamic_pointer_cast<PdfNumber>(wArr->items[idx]))
+                            else if (auto cidEnd = pdfCast<PdfNumber>(wArr->items[idx]))
                             {
                                 // Format: cid1 cid2 w (aralik)
                                 int endCid = (int)cidEnd->value;
@@ -1344,7 +1362,7 @@ namespace pdf
 
                                 if (idx < wArr->items.size())
                                 {
-                                    if (auto wNum = std::dynamic_pointer_cast<PdfNumber>(wArr->items[idx]))
+                                    if (auto wNum = pdfCast<PdfNumber>(wArr->items[idx]))
                                     {
                                         int w = (int)wNum->value;
                                         for (int c = startCid; c <= endCid; c++)
@@ -1360,23 +1378,23 @@ namespace pdf
                     // ✅ CIDToGIDMap (Type0 -> DescendantFonts[0])
                     // -------------------------------------------------
                     {
-                        std::set<int> vis;
-                        auto mapObj = resolveIndirect(dictGetAny(cidFontDict, "/CIDToGIDMap", "CIDToGIDMap"), vis);
+                        PdfVisitedRefs vis;
+                        auto mapObj = resolveIndirect(dictGet(cidFontDict, PdfKeys::CIDToGIDMap), vis);
 
                         // Yoksa default Identity kabul et
                         info.hasCidToGidMap = false;
                         info.cidToGidIdentity = true;
                         info.cidToGid.clear();
 
-                        if (auto nm = std::dynamic_pointer_cast<PdfName>(mapObj))
+                        if (auto nm = pdfCast<PdfName>(mapObj))
                         {
-                            if (nm->value == "/Identity" || nm->value == "Identity")
+                            if (nm->value == "/Identity")
                             {
                                 info.hasCidToGidMap = true;
                                 info.cidToGidIdentity = true;
                             }
                         }
-                        else if (auto st = std::dynamic_pointer_cast<PdfStream>(mapObj))
+                        else if (auto st = pdfCast<PdfStream>(mapObj))
                         {
                             std::vector<uint8_t> bytes;
                             if (decodeStream(st, bytes))
@@ -1402,7 +1420,7 @@ namespace pdf
                 else
                 {
                     // bazı PDF'lerde DW Type0'ın kendisinde de olabiliyor
-                    if (auto dw = std::dynamic_pointer_cast<PdfNumber>(dictGetAny(fdict, "/DW", "DW")))
+                    if (auto dw = pdfCast<PdfNumber>(dictGet(fdict, PdfKeys::DW)))
                         info.missingWidth = (int)dw->value;
 
                     // CIDToGIDMap yok → identity varsay
@@ -1419,11 +1437,10 @@ namespace pdf
             if (info.isCidFont && !info.fontProgram.empty())
             {
                 FT_Face widthFace = nullptr;
-                FT_Error err = FT_New_Memory_Face(
+                FT_Error err = ftNewMemoryFace(
                     g_ftLib,
                     info.fontProgram.data(),
                     (FT_Long)info.fontProgram.size(),
-                    0,
                     &widthFace
                 );
 
@@ -1510,33 +1527,16 @@ namespace pdf
                     LogDebug("  CID Font '%s': cidWidths populated: %zu entries (from /W + FreeType)",
                         info.resourceName.c_str(), info.cidWidths.size());
 
-                    FT_Done_Face(widthFace);
+                    ftDoneFace(widthFace);
                 }
             }
 
             // MUTLAKA MAP'E KOY
             out[info.resourceName] = info;
 
-            // DEBUG: Her font icin log
-            {
-                static FILE* gpfDbg = nullptr; // fopen("C:\\temp\\getpagefonts_debug.txt", "a");
-                if (gpfDbg) {
-                    fprintf(gpfDbg, "  FONT: '%s' -> baseFont='%s', subtype='%s', encoding='%s'\n",
-                        info.resourceName.c_str(), info.baseFont.c_str(),
-                        info.subtype.c_str(), info.encoding.c_str());
-                    fprintf(gpfDbg, "    isCidFont=%d, cidToUnicode.size=%zu, fontProgram.size=%zu\n",
-                        info.isCidFont ? 1 : 0, info.cidToUnicode.size(), info.fontProgram.size());
-                    fprintf(gpfDbg, "    cidDefaultWidth=%d, cidWidths.size=%zu\n",
-                        info.cidDefaultWidth, info.cidWidths.size());
-                    // Ilk 10 cidWidth'i goster
-                    int cnt = 0;
-                    for (auto& kv : info.cidWidths) {
-                        if (cnt++ < 10)
-                            fprintf(gpfDbg, "      CID 0x%04X -> width=%d\n", kv.first, kv.second);
-                    }
-                    fflush(gpfDbg);
-                }
-            }
+            PDF_TRACE(Text, "pageFont", "%s: %s %s %s, cid=%d, embedded %zu bytes",
+                info.resourceName.c_str(), info.baseFont.c_str(), info.subtype.c_str(),
+                info.encoding.c_str(), info.isCidFont ? 1 : 0, info.fontProgram.size());
         }
 
         // ============================================
@@ -1560,33 +1560,22 @@ namespace pdf
     {
         if (!resDict) return false;
 
-        std::set<int> v;
+        PdfVisitedRefs v;
 
         // Font dictionary'yi bul
-        auto fontObj = resolveIndirect(dictGetAny(resDict, "/Font", "Font"), v);
-        auto fontDict = std::dynamic_pointer_cast<PdfDictionary>(fontObj);
+        auto fontObj = resolveIndirect(dictGet(resDict, PdfKeys::Font), v);
+        auto fontDict = pdfCast<PdfDictionary>(fontObj);
         if (!fontDict) return false;
 
         LogDebug("loadFontsFromResourceDict: Found %zu fonts", fontDict->entries.size());
 
-        // DEBUG: Dosyaya yaz
-        {
-            static FILE* fontDbg = nullptr; // fopen("C:\\temp\\font_load_debug.txt", "w");
-            if (fontDbg) {
-                fprintf(fontDbg, "=== loadFontsFromResourceDict ===\n");
-                fprintf(fontDbg, "Found %zu fonts in resource dict\n", fontDict->entries.size());
-                for (auto& kv : fontDict->entries) {
-                    fprintf(fontDbg, "  Font entry: '%s'\n", kv.first.c_str());
-                }
-                fflush(fontDbg);
-            }
-        }
+        PDF_TRACE(Text, "resourceFonts", "%zu fonts", fontDict->entries.size());
 
         // Her font için
         for (auto& kv : fontDict->entries)
         {
             // Bu font zaten yüklü mü?
-            std::string rn = kv.first;
+            std::string rn = kv.first.str();
             if (!rn.empty() && rn[0] != '/')
                 rn = "/" + rn;
 
@@ -1602,34 +1591,34 @@ namespace pdf
             // Font dictionary'yi resolve et
             v.clear();
             auto fdictObj = resolveIndirect(kv.second, v);
-            auto fdict = std::dynamic_pointer_cast<PdfDictionary>(fdictObj);
+            auto fdict = pdfCast<PdfDictionary>(fdictObj);
             if (!fdict) continue;
 
             // Subtype / BaseFont / Encoding
-            if (auto s = std::dynamic_pointer_cast<PdfName>(dictGetAny(fdict, "/Subtype", "Subtype")))
+            if (auto s = pdfCast<PdfName>(dictGet(fdict, PdfKeys::Subtype)))
                 info.subtype = s->value;
 
-            if (auto b = std::dynamic_pointer_cast<PdfName>(dictGetAny(fdict, "/BaseFont", "BaseFont")))
+            if (auto b = pdfCast<PdfName>(dictGet(fdict, PdfKeys::BaseFont)))
                 info.baseFont = b->value;
 
             LogDebug("  Loading font '%s' (BaseFont: %s, Subtype: %s)",
                 rn.c_str(), info.baseFont.c_str(), info.subtype.c_str());
 
             // ===== TYPE3 FONT DETECTION =====
-            if (info.subtype == "/Type3" || info.subtype == "Type3")
+            if (info.subtype == "/Type3")
             {
                 info.isType3 = true;
                 LogDebug("    Type3 font detected!");
 
                 // Parse FontMatrix
                 {
-                    auto fmObj = dictGetAny(fdict, "/FontMatrix", "FontMatrix");
+                    auto fmObj = dictGet(fdict, PdfKeys::FontMatrix);
                     if (fmObj) {
-                        std::set<int> vfm;
-                        auto fmArr = std::dynamic_pointer_cast<PdfArray>(resolveIndirect(fmObj, vfm));
+                        PdfVisitedRefs vfm;
+                        auto fmArr = pdfCast<PdfArray>(resolveIndirect(fmObj, vfm));
                         if (fmArr && fmArr->items.size() >= 6) {
                             auto getN = [](const std::shared_ptr<PdfObject>& o) -> double {
-                                auto n = std::dynamic_pointer_cast<PdfNumber>(o);
+                                auto n = pdfCast<PdfNumber>(o);
                                 return n ? n->value : 0.0;
                             };
                             info.type3FontMatrix.a = getN(fmArr->items[0]);
@@ -1648,24 +1637,24 @@ namespace pdf
 
                 // Parse CharProcs dictionary
                 {
-                    std::set<int> vcp;
-                    auto cpObj = resolveIndirect(dictGetAny(fdict, "/CharProcs", "CharProcs"), vcp);
-                    auto cpDict = std::dynamic_pointer_cast<PdfDictionary>(cpObj);
+                    PdfVisitedRefs vcp;
+                    auto cpObj = resolveIndirect(dictGet(fdict, PdfKeys::CharProcs), vcp);
+                    auto cpDict = pdfCast<PdfDictionary>(cpObj);
                     if (cpDict) {
                         for (auto& cpKv : cpDict->entries) {
-                            std::string glyphName = cpKv.first;
+                            std::string glyphName = cpKv.first.str();
                             if (!glyphName.empty() && glyphName[0] == '/')
                                 glyphName.erase(0, 1);
 
-                            std::set<int> vcps;
+                            PdfVisitedRefs vcps;
                             auto streamObj = resolveIndirect(cpKv.second, vcps);
-                            auto stream = std::dynamic_pointer_cast<PdfStream>(streamObj);
+                            auto stream = pdfCast<PdfStream>(streamObj);
                             if (stream) {
                                 std::vector<uint8_t> decoded;
                                 if (decodeStream(stream, decoded))
                                     info.type3CharProcs[glyphName] = std::move(decoded);
                                 else
-                                    info.type3CharProcs[glyphName] = stream->data;
+                                    info.type3CharProcs[glyphName] = stream->data.toVector();
                             }
                         }
                         LogDebug("    CharProcs: %zu glyphs loaded", info.type3CharProcs.size());
@@ -1674,9 +1663,9 @@ namespace pdf
 
                 // Parse Type3 Resources (optional, for CharProc execution)
                 {
-                    std::set<int> vres;
-                    auto resObj = resolveIndirect(dictGetAny(fdict, "/Resources", "Resources"), vres);
-                    info.type3Resources = std::dynamic_pointer_cast<PdfDictionary>(resObj);
+                    PdfVisitedRefs vres;
+                    auto resObj = resolveIndirect(dictGet(fdict, PdfKeys::Resources), vres);
+                    info.type3Resources = pdfCast<PdfDictionary>(resObj);
                 }
 
                 // Compute fontHash for caching
@@ -1686,12 +1675,12 @@ namespace pdf
 
             // Encoding
             {
-                auto encObj = dictGetAny(fdict, "/Encoding", "Encoding");
+                auto encObj = dictGet(fdict, PdfKeys::Encoding);
                 LogDebug("  Font '%s': encObj=%p", rn.c_str(), (void*)encObj.get());
 
                 if (encObj)
                 {
-                    if (auto e = std::dynamic_pointer_cast<PdfName>(encObj))
+                    if (auto e = pdfCast<PdfName>(encObj))
                     {
                         info.encoding = e->value;
                         LogDebug("    Encoding (Name): '%s'", info.encoding.c_str());
@@ -1699,24 +1688,24 @@ namespace pdf
                     else
                     {
                         // Encoding bir IndirectRef veya Dictionary olabilir
-                        std::set<int> venc;
+                        PdfVisitedRefs venc;
                         auto encDictObj = resolveIndirect(encObj, venc);
                         LogDebug("    Encoding encDictObj=%p (type after resolve)", (void*)encDictObj.get());
 
-                        auto encDict = std::dynamic_pointer_cast<PdfDictionary>(encDictObj);
+                        auto encDict = pdfCast<PdfDictionary>(encDictObj);
                         if (encDict)
                         {
                             LogDebug("    Encoding is Dictionary with %zu entries", encDict->entries.size());
 
-                            if (auto be = std::dynamic_pointer_cast<PdfName>(dictGetAny(encDict, "/BaseEncoding", "BaseEncoding")))
+                            if (auto be = pdfCast<PdfName>(dictGet(encDict, PdfKeys::BaseEncoding)))
                             {
                                 info.encoding = be->value;
                                 LogDebug("    BaseEncoding: '%s'", info.encoding.c_str());
                             }
 
                             // ✅ /Differences array'ini parse et
-                            auto diffObj = dictGetAny(encDict, "/Differences", "Differences");
-                            auto diffArr = std::dynamic_pointer_cast<PdfArray>(diffObj);
+                            auto diffObj = dictGet(encDict, PdfKeys::Differences);
+                            auto diffArr = pdfCast<PdfArray>(diffObj);
 
                             if (diffArr && !diffArr->items.empty())
                             {
@@ -1726,11 +1715,11 @@ namespace pdf
 
                                 for (auto& item : diffArr->items)
                                 {
-                                    if (auto num = std::dynamic_pointer_cast<PdfNumber>(item))
+                                    if (auto num = pdfCast<PdfNumber>(item))
                                     {
                                         currentCode = (int)num->value;
                                     }
-                                    else if (auto name = std::dynamic_pointer_cast<PdfName>(item))
+                                    else if (auto name = pdfCast<PdfName>(item))
                                     {
                                         std::string glyphName = name->value;
                                         if (!glyphName.empty() && glyphName[0] == '/')
@@ -1769,9 +1758,9 @@ namespace pdf
 
             // ToUnicode - parseToUnicodeCMap fonksiyonunu kullan (tam destek)
             {
-                std::set<int> vt;
-                auto tuObj = resolveIndirect(dictGetAny(fdict, "/ToUnicode", "ToUnicode"), vt);
-                auto tu = std::dynamic_pointer_cast<PdfStream>(tuObj);
+                PdfVisitedRefs vt;
+                auto tuObj = resolveIndirect(dictGet(fdict, PdfKeys::ToUnicode), vt);
+                auto tu = pdfCast<PdfStream>(tuObj);
                 if (tu)
                 {
                     std::vector<uint8_t> tuDecoded;
@@ -1791,26 +1780,26 @@ namespace pdf
             // Embedded font program (FontDescriptor) - skip for Type3
             if (!info.isType3)
             {
-                std::set<int> vfdesc;
-                auto fdObj = resolveIndirect(dictGetAny(fdict, "/FontDescriptor", "FontDescriptor"), vfdesc);
-                auto fd = std::dynamic_pointer_cast<PdfDictionary>(fdObj);
+                PdfVisitedRefs vfdesc;
+                auto fdObj = resolveIndirect(dictGet(fdict, PdfKeys::FontDescriptor), vfdesc);
+                auto fd = pdfCast<PdfDictionary>(fdObj);
 
                 // Type0 için DescendantFonts'ta olabilir
                 if (!fd && info.subtype == "/Type0")
                 {
-                    std::set<int> vd2;
-                    auto descObj2 = resolveIndirect(dictGetAny(fdict, "/DescendantFonts", "DescendantFonts"), vd2);
-                    auto descArr2 = std::dynamic_pointer_cast<PdfArray>(descObj2);
+                    PdfVisitedRefs vd2;
+                    auto descObj2 = resolveIndirect(dictGet(fdict, PdfKeys::DescendantFonts), vd2);
+                    auto descArr2 = pdfCast<PdfArray>(descObj2);
                     if (descArr2 && !descArr2->items.empty())
                     {
                         vd2.clear();
                         auto cidObj2 = resolveIndirect(descArr2->items[0], vd2);
-                        auto cidDict2 = std::dynamic_pointer_cast<PdfDictionary>(cidObj2);
+                        auto cidDict2 = pdfCast<PdfDictionary>(cidObj2);
                         if (cidDict2)
                         {
                             vfdesc.clear();
-                            auto fdObj2 = resolveIndirect(dictGetAny(cidDict2, "/FontDescriptor", "FontDescriptor"), vfdesc);
-                            fd = std::dynamic_pointer_cast<PdfDictionary>(fdObj2);
+                            auto fdObj2 = resolveIndirect(dictGet(cidDict2, PdfKeys::FontDescriptor), vfdesc);
+                            fd = pdfCast<PdfDictionary>(fdObj2);
                         }
                     }
                 }
@@ -1821,9 +1810,9 @@ namespace pdf
 
                     // FontFile (Type 1 PFA/PFB) - en önce bu denen
                     {
-                        std::set<int> vff;
-                        auto ffObj = resolveIndirect(dictGetAny(fd, "/FontFile", "FontFile"), vff);
-                        ff = std::dynamic_pointer_cast<PdfStream>(ffObj);
+                        PdfVisitedRefs vff;
+                        auto ffObj = resolveIndirect(dictGet(fd, PdfKeys::FontFile), vff);
+                        ff = pdfCast<PdfStream>(ffObj);
                         if (ff)
                             info.fontProgramSubtype = "Type1";
                     }
@@ -1831,9 +1820,9 @@ namespace pdf
                     // FontFile2 (TrueType)
                     if (!ff)
                     {
-                        std::set<int> vff;
-                        auto ffObj = resolveIndirect(dictGetAny(fd, "/FontFile2", "FontFile2"), vff);
-                        ff = std::dynamic_pointer_cast<PdfStream>(ffObj);
+                        PdfVisitedRefs vff;
+                        auto ffObj = resolveIndirect(dictGet(fd, PdfKeys::FontFile2), vff);
+                        ff = pdfCast<PdfStream>(ffObj);
                         if (ff)
                             info.fontProgramSubtype = "TrueType";
                     }
@@ -1841,13 +1830,13 @@ namespace pdf
                     // FontFile3 (Type1C/CFF/OpenType)
                     if (!ff)
                     {
-                        std::set<int> vff;
-                        auto ffObj = resolveIndirect(dictGetAny(fd, "/FontFile3", "FontFile3"), vff);
-                        ff = std::dynamic_pointer_cast<PdfStream>(ffObj);
+                        PdfVisitedRefs vff;
+                        auto ffObj = resolveIndirect(dictGet(fd, PdfKeys::FontFile3), vff);
+                        ff = pdfCast<PdfStream>(ffObj);
 
                         if (ff && ff->dict)
                         {
-                            if (auto st = std::dynamic_pointer_cast<PdfName>(dictGetAny(ff->dict, "/Subtype", "Subtype")))
+                            if (auto st = pdfCast<PdfName>(dictGet(ff->dict, PdfKeys::Subtype)))
                                 info.fontProgramSubtype = st->value;
                             else
                                 info.fontProgramSubtype = "FontFile3";
@@ -1860,7 +1849,7 @@ namespace pdf
                         if (decodeStream(ff, decoded))
                             info.fontProgram = std::move(decoded);
                         else
-                            info.fontProgram = ff->data;
+                            info.fontProgram = ff->data.toVector();
 
                         LogDebug("    Font program loaded: %s, %zu bytes",
                             info.fontProgramSubtype.c_str(), info.fontProgram.size());
@@ -1871,22 +1860,22 @@ namespace pdf
             // Widths (simple fonts)
             if (info.subtype != "/Type0")
             {
-                if (auto fc = std::dynamic_pointer_cast<PdfNumber>(dictGetAny(fdict, "/FirstChar", "FirstChar")))
+                if (auto fc = pdfCast<PdfNumber>(dictGet(fdict, PdfKeys::FirstChar)))
                     info.firstChar = (int)fc->value;
 
-                if (auto mw = std::dynamic_pointer_cast<PdfNumber>(dictGetAny(fdict, "/MissingWidth", "MissingWidth")))
+                if (auto mw = pdfCast<PdfNumber>(dictGet(fdict, PdfKeys::MissingWidth)))
                     info.missingWidth = (int)mw->value;
 
-                std::set<int> vw;
-                auto wObj = resolveIndirect(dictGetAny(fdict, "/Widths", "Widths"), vw);
-                auto wArr = std::dynamic_pointer_cast<PdfArray>(wObj);
+                PdfVisitedRefs vw;
+                auto wObj = resolveIndirect(dictGet(fdict, PdfKeys::Widths), vw);
+                auto wArr = pdfCast<PdfArray>(wObj);
 
                 if (wArr && !wArr->items.empty())
                 {
                     info.widths.reserve(wArr->items.size());
                     for (auto& itW : wArr->items)
                     {
-                        auto n = std::dynamic_pointer_cast<PdfNumber>(itW);
+                        auto n = pdfCast<PdfNumber>(itW);
                         info.widths.push_back(n ? (int)n->value : info.missingWidth);
                     }
                     info.hasWidths = true;
@@ -1947,7 +1936,7 @@ namespace pdf
                         "eth","ntilde","ograve","oacute","ocircumflex","otilde","odieresis","divide",
                         "oslash","ugrave","uacute","ucircumflex","udieresis","yacute","thorn","ydieresis"
                     };
-                    bool isWinAnsi = (info.encoding == "/WinAnsiEncoding" || info.encoding == "WinAnsiEncoding");
+                    bool isWinAnsi = (info.encoding == "/WinAnsiEncoding");
                     // WinAnsi glyph isimlerini doldur:
                     // - Açıkça WinAnsiEncoding ise: her zaman doldur
                     // - Encoding boşsa VE ToUnicode yoksa: CFF fontlar için doldur
@@ -1966,11 +1955,10 @@ namespace pdf
                 if (!info.fontProgram.empty())
                 {
                     FT_Face tempFace = nullptr;
-                    FT_Error err = FT_New_Memory_Face(
+                    FT_Error err = ftNewMemoryFace(
                         g_ftLib,
                         info.fontProgram.data(),
                         (FT_Long)info.fontProgram.size(),
-                        0,
                         &tempFace
                     );
 
@@ -2151,7 +2139,7 @@ namespace pdf
                             LogDebug("    Extracted widths from FreeType for font '%s'", rn.c_str());
                         }
 
-                        FT_Done_Face(tempFace);
+                        ftDoneFace(tempFace);
                     }
                 }
             }
@@ -2161,33 +2149,33 @@ namespace pdf
             {
                 info.isCidFont = true;
 
-                std::set<int> vd;
-                auto descObj = resolveIndirect(dictGetAny(fdict, "/DescendantFonts", "DescendantFonts"), vd);
-                auto descArr = std::dynamic_pointer_cast<PdfArray>(descObj);
+                PdfVisitedRefs vd;
+                auto descObj = resolveIndirect(dictGet(fdict, PdfKeys::DescendantFonts), vd);
+                auto descArr = pdfCast<PdfArray>(descObj);
 
                 std::shared_ptr<PdfDictionary> cidFontDict;
                 if (descArr && !descArr->items.empty())
                 {
                     vd.clear();
                     auto cidObj = resolveIndirect(descArr->items[0], vd);
-                    cidFontDict = std::dynamic_pointer_cast<PdfDictionary>(cidObj);
+                    cidFontDict = pdfCast<PdfDictionary>(cidObj);
                 }
 
                 if (cidFontDict)
                 {
                     // /DW - CID default width
-                    if (auto dw = std::dynamic_pointer_cast<PdfNumber>(dictGetAny(cidFontDict, "/DW", "DW"))) {
+                    if (auto dw = pdfCast<PdfNumber>(dictGet(cidFontDict, PdfKeys::DW))) {
                         info.cidDefaultWidth = (int)dw->value;
                         info.missingWidth = (int)dw->value;
                     }
 
                     // /W - CID width array (same parsing as main font path)
-                    if (auto wArr = std::dynamic_pointer_cast<PdfArray>(dictGetAny(cidFontDict, "/W", "W")))
+                    if (auto wArr = pdfCast<PdfArray>(dictGet(cidFontDict, PdfKeys::W)))
                     {
                         size_t idx = 0;
                         while (idx < wArr->items.size())
                         {
-                            auto cidStart = std::dynamic_pointer_cast<PdfNumber>(wArr->items[idx]);
+                            auto cidStart = pdfCast<PdfNumber>(wArr->items[idx]);
                             if (!cidStart) { idx++; continue; }
 
                             int startCid = (int)cidStart->value;
@@ -2195,19 +2183,19 @@ namespace pdf
 
                             if (idx >= wArr->items.size()) break;
 
-                            if (auto widthArr = std::dynamic_pointer_cast<PdfArray>(wArr->items[idx]))
+                            if (auto widthArr = pdfCast<PdfArray>(wArr->items[idx]))
                             {
                                 // Format: cid [w1 w2 w3 ...]
                                 int cid = startCid;
                                 for (auto& wItem : widthArr->items)
                                 {
-                                    if (auto wNum = std::dynamic_pointer_cast<PdfNumber>(wItem))
+                                    if (auto wNum = pdfCast<PdfNumber>(wItem))
                                         info.cidWidths[(uint16_t)cid] = (int)wNum->value;
                                     cid++;
                                 }
                                 idx++;
                             }
-                            else if (auto cidEnd = std::dynamic_pointer_cast<PdfNumber>(wArr->items[idx]))
+                            else if (auto cidEnd = pdfCast<PdfNumber>(wArr->items[idx]))
                             {
                                 // Format: cid1 cid2 w (range)
                                 int endCid = (int)cidEnd->value;
@@ -2215,7 +2203,7 @@ namespace pdf
 
                                 if (idx < wArr->items.size())
                                 {
-                                    if (auto wNum = std::dynamic_pointer_cast<PdfNumber>(wArr->items[idx]))
+                                    if (auto wNum = pdfCast<PdfNumber>(wArr->items[idx]))
                                     {
                                         int w = (int)wNum->value;
                                         for (int c = startCid; c <= endCid; c++)
@@ -2230,22 +2218,22 @@ namespace pdf
                     }
 
                     // CIDToGIDMap
-                    std::set<int> vis;
-                    auto mapObj = resolveIndirect(dictGetAny(cidFontDict, "/CIDToGIDMap", "CIDToGIDMap"), vis);
+                    PdfVisitedRefs vis;
+                    auto mapObj = resolveIndirect(dictGet(cidFontDict, PdfKeys::CIDToGIDMap), vis);
 
                     info.hasCidToGidMap = false;
                     info.cidToGidIdentity = true;
                     info.cidToGid.clear();
 
-                    if (auto nm = std::dynamic_pointer_cast<PdfName>(mapObj))
+                    if (auto nm = pdfCast<PdfName>(mapObj))
                     {
-                        if (nm->value == "/Identity" || nm->value == "Identity")
+                        if (nm->value == "/Identity")
                         {
                             info.hasCidToGidMap = true;
                             info.cidToGidIdentity = true;
                         }
                     }
-                    else if (auto st = std::dynamic_pointer_cast<PdfStream>(mapObj))
+                    else if (auto st = pdfCast<PdfStream>(mapObj))
                     {
                         std::vector<uint8_t> bytes;
                         if (decodeStream(st, bytes))
@@ -2266,17 +2254,6 @@ namespace pdf
             // CID font icin: cidWidths bossa, FreeType'tan width hesapla
             // Embedded font veya sistem fontu olabilir
             // ================================================================
-            {
-                static FILE* cwDbg = nullptr; // fopen("C:\\temp\\cidwidth_debug.txt", "a");
-                if (cwDbg) {
-                    fprintf(cwDbg, "CID width check: font='%s' isCidFont=%d, cidWidths.empty=%d, cidToUnicode.size=%zu, fontProgram.size=%zu\n",
-                        info.resourceName.c_str(),
-                        info.isCidFont ? 1 : 0, info.cidWidths.empty() ? 1 : 0,
-                        info.cidToUnicode.size(), info.fontProgram.size());
-                    fflush(cwDbg);
-                }
-            }
-
             if (info.isCidFont && !info.fontProgram.empty())
             {
 
@@ -2285,26 +2262,15 @@ namespace pdf
 
                 if (!info.fontProgram.empty())
                 {
-                    static FILE* cwDbg = nullptr; // fopen("C:\\temp\\cidwidth_debug.txt", "a");
-                    if (cwDbg) {
-                        fprintf(cwDbg, "  -> Using embedded font (size=%zu)\n", info.fontProgram.size());
-                        fflush(cwDbg);
-                    }
                     // Embedded font
-                    FT_Error err = FT_New_Memory_Face(
+                    FT_Error err = ftNewMemoryFace(
                         g_ftLib,
                         info.fontProgram.data(),
                         (FT_Long)info.fontProgram.size(),
-                        0,
                         &widthFace
                     );
-                    {
-                        static FILE* cwDbg = nullptr; // fopen("C:\\temp\\cidwidth_debug.txt", "a");
-                        if (cwDbg) {
-                            fprintf(cwDbg, "  -> FT_New_Memory_Face result: err=%d, widthFace=%p\n", (int)err, (void*)widthFace);
-                            fflush(cwDbg);
-                        }
-                    }
+                    PDF_TRACE(Text, "cidWidthFace", "%s: embedded face, FT error %d",
+                        info.resourceName.c_str(), (int)err);
                     if (err != 0) widthFace = nullptr;
                     needCleanup = true;
                 }
@@ -2317,30 +2283,15 @@ namespace pdf
                     std::string pathA = resolveSystemFontPath(info.baseFont);
 
                     LogDebug("    -> Loading system font from: %s", pathA.c_str());
-                    FT_Error err = FT_New_Face(g_ftLib, pathA.c_str(), 0, &widthFace);
+                    FT_Error err = ftNewFace(g_ftLib, pathA.c_str(), &widthFace);
                     LogDebug("    -> FT_New_Face result: err=%d, widthFace=%p", (int)err, (void*)widthFace);
                     if (err != 0) widthFace = nullptr;
                     needCleanup = true;
                 }
 
-                {
-                    static FILE* cwDbg = nullptr; // fopen("C:\\temp\\cidwidth_debug.txt", "a");
-                    if (cwDbg) {
-                        fprintf(cwDbg, "  -> widthFace after all loads: %p\n", (void*)widthFace);
-                        fflush(cwDbg);
-                    }
-                }
                 if (widthFace)
                 {
                     FT_UShort unitsPerEM = widthFace->units_per_EM;
-                    {
-                        static FILE* cwDbg = nullptr; // fopen("C:\\temp\\cidwidth_debug.txt", "a");
-                        if (cwDbg) {
-                            fprintf(cwDbg, "  -> unitsPerEM=%d, num_charmaps=%d, cidToUnicode.size=%zu\n",
-                                (int)unitsPerEM, widthFace->num_charmaps, info.cidToUnicode.size());
-                            fflush(cwDbg);
-                        }
-                    }
                     if (unitsPerEM == 0) unitsPerEM = 1000;
 
                     // Unicode charmap sec
@@ -2416,36 +2367,24 @@ namespace pdf
                     }
 
                     if (needCleanup)
-                        FT_Done_Face(widthFace);
+                        ftDoneFace(widthFace);
 
                     LogDebug("  CID Font '%s' (XObj): cidWidths populated: %zu entries (from /W + FreeType)",
                         info.resourceName.c_str(), info.cidWidths.size());
                 }
                 else
                 {
-                    static FILE* cwDbg = nullptr; // fopen("C:\\temp\\cidwidth_debug.txt", "a");
-                    if (cwDbg) {
-                        fprintf(cwDbg, "  -> FAILED: widthFace is NULL\n");
-                        fflush(cwDbg);
-                    }
+                    PDF_TRACE(Text, "cidWidthFace", "%s: no face, widths from /W only",
+                        info.resourceName.c_str());
                 }
             }
 
             // Map'e ekle
             fonts[info.resourceName] = info;
 
-            // DEBUG: Dosyaya font detaylarini yaz
-            {
-                static FILE* fontDbg = nullptr; // fopen("C:\\temp\\font_load_debug.txt", "a");
-                if (fontDbg) {
-                    fprintf(fontDbg, "  ADDED: '%s' -> BaseFont='%s', Subtype='%s', Encoding='%s', isCidFont=%d\n",
-                        info.resourceName.c_str(), info.baseFont.c_str(),
-                        info.subtype.c_str(), info.encoding.c_str(), info.isCidFont ? 1 : 0);
-                    fprintf(fontDbg, "    fontProgram.size=%zu, cidToUnicode.size=%zu\n",
-                        info.fontProgram.size(), info.cidToUnicode.size());
-                    fflush(fontDbg);
-                }
-            }
+            PDF_TRACE(Text, "resourceFont", "%s: %s %s %s, cid=%d, embedded %zu bytes",
+                info.resourceName.c_str(), info.baseFont.c_str(), info.subtype.c_str(),
+                info.encoding.c_str(), info.isCidFont ? 1 : 0, info.fontProgram.size());
             LogDebug("    Font '%s' added to map", rn.c_str());
         }
 
@@ -2461,12 +2400,13 @@ namespace pdf
 
 
         if (!stream || !stream->dict) return false;
+        decryptStream(stream);
 
-        std::set<int> visited;
+        PdfVisitedRefs visited;
 
         // Filter ve DecodeParms al
-        auto fObj = dictGetAny(stream->dict, "/Filter", "Filter");
-        auto pObj = dictGetAny(stream->dict, "/DecodeParms", "DecodeParms");
+        auto fObj = dictGet(stream->dict, PdfKeys::Filter);
+        auto pObj = dictGet(stream->dict, PdfKeys::DecodeParms);
 
         // Log dict entries for debugging
         LogDebug("decodeStream: dict has %zu entries, data=%zu bytes",
@@ -2488,7 +2428,7 @@ namespace pdf
         if (!fObj)
         {
             LogDebug("decodeStream: NO FILTER - returning raw data");
-            outDecoded = stream->data;
+            outDecoded = stream->data.toVector();
             return true;
         }
 
@@ -2504,10 +2444,10 @@ namespace pdf
 
                 if (!parmsObj) return mp;
 
-                std::set<int> v;
+                PdfVisitedRefs v;
                 auto resolved = resolveIndirect(parmsObj, v);
 
-                auto d = std::dynamic_pointer_cast<PdfDictionary>(resolved);
+                auto d = pdfCast<PdfDictionary>(resolved);
                 if (!d) return mp;
 
                 // Tüm numeric değerleri oku
@@ -2516,11 +2456,11 @@ namespace pdf
                     if (!kv.second) continue;
 
                     v.clear();
-                    auto numObj = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(kv.second, v));
+                    auto numObj = pdfCast<PdfNumber>(resolveIndirect(kv.second, v));
                     if (numObj)
                     {
                         // Key'i normalize et (hem "/Predictor" hem "Predictor" çalışsın)
-                        std::string key = kv.first;
+                        std::string key = kv.first.str();
                         if (!key.empty() && key[0] == '/')
                             key = key.substr(1);
 
@@ -2539,7 +2479,7 @@ namespace pdf
         // ================================================================
         if (fObj->type() == PdfObjectType::Name)
         {
-            auto nm = std::dynamic_pointer_cast<PdfName>(fObj);
+            auto nm = pdfCast<PdfName>(fObj);
             std::string filterName = nm ? nm->value : "";
             filters.push_back(filterName);
             LogDebug("decodeStream: Single filter = '%s'", filterName.c_str());
@@ -2552,8 +2492,8 @@ namespace pdf
         // ================================================================
         else if (fObj->type() == PdfObjectType::Array)
         {
-            auto arr = std::dynamic_pointer_cast<PdfArray>(fObj);
-            auto parr = std::dynamic_pointer_cast<PdfArray>(pObj);
+            auto arr = pdfCast<PdfArray>(fObj);
+            auto parr = pdfCast<PdfArray>(pObj);
 
             if (arr)
             {
@@ -2561,7 +2501,7 @@ namespace pdf
                 for (size_t i = 0; i < arr->items.size(); i++)
                 {
                     visited.clear();
-                    auto n = std::dynamic_pointer_cast<PdfName>(resolveIndirect(arr->items[i], visited));
+                    auto n = pdfCast<PdfName>(resolveIndirect(arr->items[i], visited));
                     if (n) {
                         filters.push_back(n->value);
                         LogDebug("decodeStream:   filter[%zu] = '%s'", i, n->value.c_str());
@@ -2590,7 +2530,7 @@ namespace pdf
         {
             // beklenmeyen tip → raw
             LogDebug("decodeStream: Unexpected filter type %d - returning raw", (int)fObj->type());
-            outDecoded = stream->data;
+            outDecoded = stream->data.toVector();
             return true;
         }
 
@@ -2678,23 +2618,24 @@ namespace pdf
         w = h = 0;
         if (!st || !st->dict) return false;
 
+        // JPX/JBIG2/CCITT/DCT yolları ham st->data okur
+        decryptStream(st);
+
         auto dict = st->dict;
-        std::set<int> v;
+        PdfVisitedRefs v;
 
         // ================================================================
         // Width ve Height al - indirect reference'ları resolve et!
         // ================================================================
-        auto wObj = dict->get("/Width");
-        if (!wObj) wObj = dict->get("Width");
+        auto wObj = dict->get(PdfKeys::Width);
         v.clear();
         wObj = resolveIndirect(wObj, v);
-        auto wNum = std::dynamic_pointer_cast<PdfNumber>(wObj);
+        auto wNum = pdfCast<PdfNumber>(wObj);
 
-        auto hObj = dict->get("/Height");
-        if (!hObj) hObj = dict->get("Height");
+        auto hObj = dict->get(PdfKeys::Height);
         v.clear();
         hObj = resolveIndirect(hObj, v);
-        auto hNum = std::dynamic_pointer_cast<PdfNumber>(hObj);
+        auto hNum = pdfCast<PdfNumber>(hObj);
 
         if (!wNum || !hNum) return false;
 
@@ -2706,8 +2647,7 @@ namespace pdf
         // ================================================================
         // Filter'ı analiz et
         // ================================================================
-        auto fObj = dict->get("/Filter");
-        if (!fObj) fObj = dict->get("Filter");
+        auto fObj = dict->get(PdfKeys::Filter);
         v.clear();
         fObj = resolveIndirect(fObj, v);
 
@@ -2715,16 +2655,16 @@ namespace pdf
 
         if (fObj)
         {
-            if (auto fName = std::dynamic_pointer_cast<PdfName>(fObj))
+            if (auto fName = pdfCast<PdfName>(fObj))
             {
                 filters.push_back(fName->value);
             }
-            else if (auto fArr = std::dynamic_pointer_cast<PdfArray>(fObj))
+            else if (auto fArr = pdfCast<PdfArray>(fObj))
             {
                 for (auto& item : fArr->items)
                 {
                     v.clear();
-                    auto nm = std::dynamic_pointer_cast<PdfName>(resolveIndirect(item, v));
+                    auto nm = pdfCast<PdfName>(resolveIndirect(item, v));
                     if (nm) filters.push_back(nm->value);
                 }
             }
@@ -2740,10 +2680,10 @@ namespace pdf
 
         for (const auto& f : filters)
         {
-            if (f == "/DCTDecode" || f == "DCTDecode") isDCT = true;
-            if (f == "/JPXDecode" || f == "JPXDecode") isJPX = true;
-            if (f == "/CCITTFaxDecode" || f == "CCITTFaxDecode") isCCITT = true;
-            if (f == "/JBIG2Decode" || f == "JBIG2Decode") isJBIG2 = true;
+            if (f == "/DCTDecode") isDCT = true;
+            if (f == "/JPXDecode") isJPX = true;
+            if (f == "/CCITTFaxDecode") isCCITT = true;
+            if (f == "/JBIG2Decode") isJBIG2 = true;
         }
 
         // ================================================================
@@ -2776,19 +2716,18 @@ namespace pdf
         {
             // Check for JBIG2Globals in DecodeParms
             std::vector<uint8_t> globals;
-            auto dpObj = dict->get("/DecodeParms");
-            if (!dpObj) dpObj = dict->get("DecodeParms");
+            auto dpObj = dict->get(PdfKeys::DecodeParms);
             if (dpObj) {
                 v.clear();
-                auto dp = std::dynamic_pointer_cast<PdfDictionary>(resolveIndirect(dpObj, v));
+                auto dp = pdfCast<PdfDictionary>(resolveIndirect(dpObj, v));
                 if (dp) {
-                    auto globalsRef = dp->get("/JBIG2Globals");
-                    if (!globalsRef) globalsRef = dp->get("JBIG2Globals");
+                    auto globalsRef = dp->get(PdfKeys::JBIG2Globals);
                     if (globalsRef) {
                         v.clear();
-                        auto globalsStream = std::dynamic_pointer_cast<PdfStream>(resolveIndirect(globalsRef, v));
+                        auto globalsStream = pdfCast<PdfStream>(resolveIndirect(globalsRef, v));
                         if (globalsStream) {
-                            globals = globalsStream->data;
+                            decryptStream(globalsStream);
+                            globals = globalsStream->data.toVector();
                         }
                     }
                 }
@@ -2838,8 +2777,7 @@ namespace pdf
         if (isCCITT)
         {
             // DecodeParms'tan parametreleri al
-            auto dpObj = dict->get("/DecodeParms");
-            if (!dpObj) dpObj = dict->get("DecodeParms");
+            auto dpObj = dict->get(PdfKeys::DecodeParms);
 
             int k = 0;  // Default: Group 3 1D
             bool blackIs1 = false;
@@ -2848,33 +2786,29 @@ namespace pdf
 
             if (dpObj) {
                 v.clear();
-                auto dp = std::dynamic_pointer_cast<PdfDictionary>(resolveIndirect(dpObj, v));
+                auto dp = pdfCast<PdfDictionary>(resolveIndirect(dpObj, v));
                 if (dp) {
                     // K parameter
-                    auto kObj = dp->get("/K");
-                    if (!kObj) kObj = dp->get("K");
-                    if (auto kNum = std::dynamic_pointer_cast<PdfNumber>(kObj)) {
+                    auto kObj = dp->get(PdfKeys::K);
+                    if (auto kNum = pdfCast<PdfNumber>(kObj)) {
                         k = (int)kNum->value;
                     }
 
                     // BlackIs1 parameter
-                    auto bi1Obj = dp->get("/BlackIs1");
-                    if (!bi1Obj) bi1Obj = dp->get("BlackIs1");
-                    if (auto bi1Boolean = std::dynamic_pointer_cast<PdfBoolean>(bi1Obj)) {
+                    auto bi1Obj = dp->get(PdfKeys::BlackIs1);
+                    if (auto bi1Boolean = pdfCast<PdfBoolean>(bi1Obj)) {
                         blackIs1 = bi1Boolean->value;
                     }
 
                     // EndOfLine parameter
-                    auto eolObj = dp->get("/EndOfLine");
-                    if (!eolObj) eolObj = dp->get("EndOfLine");
-                    if (auto eolBoolean = std::dynamic_pointer_cast<PdfBoolean>(eolObj)) {
+                    auto eolObj = dp->get(PdfKeys::EndOfLine);
+                    if (auto eolBoolean = pdfCast<PdfBoolean>(eolObj)) {
                         endOfLine = eolBoolean->value;
                     }
 
                     // EncodedByteAlign parameter
-                    auto ebaObj = dp->get("/EncodedByteAlign");
-                    if (!ebaObj) ebaObj = dp->get("EncodedByteAlign");
-                    if (auto ebaBoolean = std::dynamic_pointer_cast<PdfBoolean>(ebaObj)) {
+                    auto ebaObj = dp->get(PdfKeys::EncodedByteAlign);
+                    if (auto ebaBoolean = pdfCast<PdfBoolean>(ebaObj)) {
                         encodedByteAlign = ebaBoolean->value;
                     }
                 }
@@ -2927,13 +2861,13 @@ namespace pdf
             else
             {
                 // Birden fazla filtre - DCT'den önceki filtreleri uygula
-                std::vector<uint8_t> preDecoded = st->data;
+                std::vector<uint8_t> preDecoded = st->data.toVector();
 
                 for (size_t i = 0; i < filters.size(); i++)
                 {
                     const std::string& f = filters[i];
 
-                    if (f == "/DCTDecode" || f == "DCTDecode")
+                    if (f == "/DCTDecode")
                     {
                         jpegSuccess = PdfFilters::JPEGDecode(preDecoded, argb, w, h);
                         break;
@@ -2941,20 +2875,20 @@ namespace pdf
 
                     std::vector<uint8_t> temp;
 
-                    if (f == "/FlateDecode" || f == "FlateDecode")
+                    if (f == "/FlateDecode")
                     {
                         if (!PdfFilters::FlateDecode(preDecoded, temp))
                             return false;
                     }
-                    else if (f == "/ASCII85Decode" || f == "ASCII85Decode")
+                    else if (f == "/ASCII85Decode")
                     {
                         PdfFilters::ASCII85Decode(preDecoded, temp);
                     }
-                    else if (f == "/LZWDecode" || f == "LZWDecode")
+                    else if (f == "/LZWDecode")
                     {
                         PdfFilters::LZWDecode(preDecoded, temp);
                     }
-                    else if (f == "/RunLengthDecode" || f == "RunLengthDecode")
+                    else if (f == "/RunLengthDecode")
                     {
                         PdfFilters::RunLengthDecode(preDecoded, temp);
                     }
@@ -2972,41 +2906,37 @@ namespace pdf
 
             // ✅ FIX: JPEG decode sonrası SMask işle!
             {
-                auto smaskObj = dict->get("/SMask");
-                if (!smaskObj) smaskObj = dict->get("SMask");
-                std::set<int> smaskVisited;
-                auto smaskStream = std::dynamic_pointer_cast<PdfStream>(resolveIndirect(smaskObj, smaskVisited));
+                auto smaskObj = dict->get(PdfKeys::SMask);
+                PdfVisitedRefs smaskVisited;
+                auto smaskStream = pdfCast<PdfStream>(resolveIndirect(smaskObj, smaskVisited));
 
                 if (smaskStream && smaskStream->dict)
                 {
                     int smW = 0, smH = 0;
 
-                    auto smWObj = smaskStream->dict->get("/Width");
-                    if (!smWObj) smWObj = smaskStream->dict->get("Width");
+                    auto smWObj = smaskStream->dict->get(PdfKeys::Width);
                     smaskVisited.clear();
-                    if (auto smWNum = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(smWObj, smaskVisited)))
+                    if (auto smWNum = pdfCast<PdfNumber>(resolveIndirect(smWObj, smaskVisited)))
                         smW = (int)smWNum->value;
 
-                    auto smHObj = smaskStream->dict->get("/Height");
-                    if (!smHObj) smHObj = smaskStream->dict->get("Height");
+                    auto smHObj = smaskStream->dict->get(PdfKeys::Height);
                     smaskVisited.clear();
-                    if (auto smHNum = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(smHObj, smaskVisited)))
+                    if (auto smHNum = pdfCast<PdfNumber>(resolveIndirect(smHObj, smaskVisited)))
                         smH = (int)smHNum->value;
 
                     // Check for /Decode array in SMask
                     bool invertAlpha = false;
-                    auto decodeObj = smaskStream->dict->get("/Decode");
-                    if (!decodeObj) decodeObj = smaskStream->dict->get("Decode");
+                    auto decodeObj = smaskStream->dict->get(PdfKeys::Decode);
                     if (decodeObj)
                     {
                         smaskVisited.clear();
-                        auto decodeArr = std::dynamic_pointer_cast<PdfArray>(resolveIndirect(decodeObj, smaskVisited));
+                        auto decodeArr = pdfCast<PdfArray>(resolveIndirect(decodeObj, smaskVisited));
                         if (decodeArr && decodeArr->items.size() >= 2)
                         {
                             double d0 = 0.0, d1 = 1.0;
-                            if (auto n0 = std::dynamic_pointer_cast<PdfNumber>(decodeArr->items[0]))
+                            if (auto n0 = pdfCast<PdfNumber>(decodeArr->items[0]))
                                 d0 = n0->value;
-                            if (auto n1 = std::dynamic_pointer_cast<PdfNumber>(decodeArr->items[1]))
+                            if (auto n1 = pdfCast<PdfNumber>(decodeArr->items[1]))
                                 d1 = n1->value;
 
                             if (d0 > d1)
@@ -3049,17 +2979,15 @@ namespace pdf
         // BitsPerComponent
         // ================================================================
         int bpc = 8;
-        auto bpcObj = dict->get("/BitsPerComponent");
-        if (!bpcObj) bpcObj = dict->get("BitsPerComponent");
+        auto bpcObj = dict->get(PdfKeys::BitsPerComponent);
         v.clear();
-        if (auto bpcNum = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(bpcObj, v)))
+        if (auto bpcNum = pdfCast<PdfNumber>(resolveIndirect(bpcObj, v)))
             bpc = (int)bpcNum->value;
 
         // ImageMask kontrolü (1-bit mask)
         bool isImageMask = false;
-        auto imObj = dict->get("/ImageMask");
-        if (!imObj) imObj = dict->get("ImageMask");
-        if (auto imBool = std::dynamic_pointer_cast<PdfBoolean>(imObj))
+        auto imObj = dict->get(PdfKeys::ImageMask);
+        if (auto imBool = pdfCast<PdfBoolean>(imObj))
             isImageMask = imBool->value;
 
         if (isImageMask)
@@ -3068,8 +2996,7 @@ namespace pdf
         // ================================================================
         // ColorSpace analizi - ÖNEMLİ DÜZELTME!
         // ================================================================
-        auto csObj = dict->get("/ColorSpace");
-        if (!csObj) csObj = dict->get("ColorSpace");
+        auto csObj = dict->get(PdfKeys::ColorSpace);
         v.clear();
         csObj = resolveIndirect(csObj, v);
 
@@ -3082,17 +3009,16 @@ namespace pdf
         if (isImageMask)
         {
             // Predictor varsa mutlaka width kullanılmalı
-            auto dpObj = dict->get("/DecodeParms");
-            if (!dpObj) dpObj = dict->get("DecodeParms");
+            auto dpObj = dict->get(PdfKeys::DecodeParms);
 
-            std::set<int> vdp;
-            auto dp = std::dynamic_pointer_cast<PdfDictionary>(
+            PdfVisitedRefs vdp;
+            auto dp = pdfCast<PdfDictionary>(
                 resolveIndirect(dpObj, vdp));
 
             if (dp)
             {
                 int predictor = 1;
-                if (auto p = std::dynamic_pointer_cast<PdfNumber>(dp->get("/Predictor")))
+                if (auto p = pdfCast<PdfNumber>(dp->get(PdfKeys::Predictor)))
                     predictor = (int)p->value;
 
                 if (predictor > 1)
@@ -3107,18 +3033,18 @@ namespace pdf
                 }
             }
         }
-        else if (auto csName = std::dynamic_pointer_cast<PdfName>(csObj))
+        else if (auto csName = pdfCast<PdfName>(csObj))
         {
             // Basit ColorSpace: /DeviceRGB, /DeviceGray, /DeviceCMYK
             colorSpace = csName->value;
         }
-        else if (auto csArr = std::dynamic_pointer_cast<PdfArray>(csObj))
+        else if (auto csArr = pdfCast<PdfArray>(csObj))
         {
             // Array formatında ColorSpace: [/ICCBased stream] veya [/Indexed base max palette]
             if (!csArr->items.empty())
             {
                 v.clear();
-                auto first = std::dynamic_pointer_cast<PdfName>(resolveIndirect(csArr->items[0], v));
+                auto first = pdfCast<PdfName>(resolveIndirect(csArr->items[0], v));
                 if (first)
                 {
                     colorSpace = first->value;
@@ -3126,21 +3052,20 @@ namespace pdf
                     // ====================================================
                     // ICCBased ColorSpace - ÇOK ÖNEMLİ!
                     // ====================================================
-                    if (colorSpace == "/ICCBased" || colorSpace == "ICCBased")
+                    if (colorSpace == "/ICCBased")
                     {
                         // ICCBased stream'den /N (component sayısı) al
                         if (csArr->items.size() >= 2)
                         {
                             v.clear();
-                            auto iccStream = std::dynamic_pointer_cast<PdfStream>(
+                            auto iccStream = pdfCast<PdfStream>(
                                 resolveIndirect(csArr->items[1], v));
 
                             if (iccStream && iccStream->dict)
                             {
-                                auto nObj = iccStream->dict->get("/N");
-                                if (!nObj) nObj = iccStream->dict->get("N");
+                                auto nObj = iccStream->dict->get(PdfKeys::N);
                                 v.clear();
-                                auto nNum = std::dynamic_pointer_cast<PdfNumber>(
+                                auto nNum = pdfCast<PdfNumber>(
                                     resolveIndirect(nObj, v));
 
                                 if (nNum)
@@ -3150,17 +3075,16 @@ namespace pdf
                                 else
                                 {
                                     // /N bulunamadı, /Alternate'e bak
-                                    auto altObj = iccStream->dict->get("/Alternate");
-                                    if (!altObj) altObj = iccStream->dict->get("Alternate");
+                                    auto altObj = iccStream->dict->get(PdfKeys::Alternate);
                                     v.clear();
-                                    auto altName = std::dynamic_pointer_cast<PdfName>(
+                                    auto altName = pdfCast<PdfName>(
                                         resolveIndirect(altObj, v));
 
                                     if (altName)
                                     {
-                                        if (altName->value == "/DeviceRGB" || altName->value == "DeviceRGB")
+                                        if (altName->value == "/DeviceRGB")
                                             comps = 3;
-                                        else if (altName->value == "/DeviceCMYK" || altName->value == "DeviceCMYK")
+                                        else if (altName->value == "/DeviceCMYK")
                                             comps = 4;
                                         else
                                             comps = 1;
@@ -3184,16 +3108,16 @@ namespace pdf
                     // ====================================================
                     // Indexed ColorSpace
                     // ====================================================
-                    else if ((colorSpace == "/Indexed" || colorSpace == "Indexed") && csArr->items.size() >= 4)
+                    else if ((colorSpace == "/Indexed") && csArr->items.size() >= 4)
                     {
                         v.clear();
-                        auto baseName = std::dynamic_pointer_cast<PdfName>(
+                        auto baseName = pdfCast<PdfName>(
                             resolveIndirect(csArr->items[1], v));
                         if (baseName)
                             baseColorSpace = baseName->value;
 
                         v.clear();
-                        auto maxIdx = std::dynamic_pointer_cast<PdfNumber>(
+                        auto maxIdx = pdfCast<PdfNumber>(
                             resolveIndirect(csArr->items[2], v));
                         if (maxIdx)
                             paletteColors = (int)maxIdx->value + 1;
@@ -3201,11 +3125,11 @@ namespace pdf
                         // Palette verisi
                         v.clear();
                         auto palObj = resolveIndirect(csArr->items[3], v);
-                        if (auto palStr = std::dynamic_pointer_cast<PdfString>(palObj))
+                        if (auto palStr = pdfCast<PdfString>(palObj))
                         {
                             palette.assign(palStr->value.begin(), palStr->value.end());
                         }
-                        else if (auto palStream = std::dynamic_pointer_cast<PdfStream>(palObj))
+                        else if (auto palStream = pdfCast<PdfStream>(palObj))
                         {
                             decodeStream(palStream, palette);
                         }
@@ -3215,13 +3139,13 @@ namespace pdf
         }
 
         // Component sayısını belirle (ICCBased dışındaki durumlar için)
-        if (colorSpace == "/DeviceRGB" || colorSpace == "DeviceRGB")
+        if (colorSpace == "/DeviceRGB")
             comps = 3;
-        else if (colorSpace == "/DeviceCMYK" || colorSpace == "DeviceCMYK")
+        else if (colorSpace == "/DeviceCMYK")
             comps = 4;
-        else if (colorSpace == "/DeviceGray" || colorSpace == "DeviceGray")
+        else if (colorSpace == "/DeviceGray")
             comps = 1;
-        else if (colorSpace == "/Indexed" || colorSpace == "Indexed")
+        else if (colorSpace == "/Indexed")
             comps = 1; // index değerleri 1 byte
         // ICCBased için comps yukarıda ayarlandı, değiştirme!
 
@@ -3231,12 +3155,12 @@ namespace pdf
         argb.resize((size_t)w * (size_t)h * 4);
 
         // Indexed ColorSpace
-        if (colorSpace == "/Indexed" || colorSpace == "Indexed")
+        if (colorSpace == "/Indexed")
         {
             int baseComps = 3;
-            if (baseColorSpace == "/DeviceGray" || baseColorSpace == "DeviceGray")
+            if (baseColorSpace == "/DeviceGray")
                 baseComps = 1;
-            else if (baseColorSpace == "/DeviceCMYK" || baseColorSpace == "DeviceCMYK")
+            else if (baseColorSpace == "/DeviceCMYK")
                 baseComps = 4;
 
             for (int i = 0; i < w * h; i++)
@@ -3370,44 +3294,40 @@ namespace pdf
         // ================================================================
         // SMask (Soft Mask / Alpha Channel) İŞLEME
         // ================================================================
-        auto smaskObj = dict->get("/SMask");
-        if (!smaskObj) smaskObj = dict->get("SMask");
+        auto smaskObj = dict->get(PdfKeys::SMask);
         v.clear();
-        auto smaskStream = std::dynamic_pointer_cast<PdfStream>(resolveIndirect(smaskObj, v));
+        auto smaskStream = pdfCast<PdfStream>(resolveIndirect(smaskObj, v));
 
         if (smaskStream && smaskStream->dict)
         {
             // SMask boyutlarını al
             int smW = 0, smH = 0;
 
-            auto smWObj = smaskStream->dict->get("/Width");
-            if (!smWObj) smWObj = smaskStream->dict->get("Width");
+            auto smWObj = smaskStream->dict->get(PdfKeys::Width);
             v.clear();
-            if (auto smWNum = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(smWObj, v)))
+            if (auto smWNum = pdfCast<PdfNumber>(resolveIndirect(smWObj, v)))
                 smW = (int)smWNum->value;
 
-            auto smHObj = smaskStream->dict->get("/Height");
-            if (!smHObj) smHObj = smaskStream->dict->get("Height");
+            auto smHObj = smaskStream->dict->get(PdfKeys::Height);
             v.clear();
-            if (auto smHNum = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(smHObj, v)))
+            if (auto smHNum = pdfCast<PdfNumber>(resolveIndirect(smHObj, v)))
                 smH = (int)smHNum->value;
 
             // ✅ FIX: Check for /Decode array in SMask
             // /Decode [1 0] means values should be inverted (1=transparent, 0=opaque)
             // /Decode [0 1] or no Decode means normal (0=transparent, 1=opaque)
             bool invertAlpha = false;
-            auto decodeObj = smaskStream->dict->get("/Decode");
-            if (!decodeObj) decodeObj = smaskStream->dict->get("Decode");
+            auto decodeObj = smaskStream->dict->get(PdfKeys::Decode);
             if (decodeObj)
             {
                 v.clear();
-                auto decodeArr = std::dynamic_pointer_cast<PdfArray>(resolveIndirect(decodeObj, v));
+                auto decodeArr = pdfCast<PdfArray>(resolveIndirect(decodeObj, v));
                 if (decodeArr && decodeArr->items.size() >= 2)
                 {
                     double d0 = 0.0, d1 = 1.0;
-                    if (auto n0 = std::dynamic_pointer_cast<PdfNumber>(decodeArr->items[0]))
+                    if (auto n0 = pdfCast<PdfNumber>(decodeArr->items[0]))
                         d0 = n0->value;
-                    if (auto n1 = std::dynamic_pointer_cast<PdfNumber>(decodeArr->items[1]))
+                    if (auto n1 = pdfCast<PdfNumber>(decodeArr->items[1]))
                         d1 = n1->value;
 
                     // If Decode is [1 0], we need to invert alpha values
@@ -3460,7 +3380,8 @@ namespace pdf
 
         // 🚀 USE FONT CACHE - Same font = same FT_Face
         fi.fontHash = FontCache::instance().getFontHash(fi.fontProgram);
-        fi.ftFace = FontCache::instance().getOrCreate(g_ftLib, fi.fontProgram);
+        fi.ftFont = FontCache::instance().getOrCreate(g_ftLib, fi.fontProgram);
+        fi.ftFace = fi.ftFont ? fi.ftFont->face : nullptr;
 
         if (!fi.ftFace)
             return false;
@@ -3472,7 +3393,8 @@ namespace pdf
 
     bool PdfDocument::loadFallbackFont(PdfFontInfo& fi)
     {
-        std::wstring path = L"C:\\Windows\\Fonts\\arial.ttf";
+        std::string path = platform::systemFontPath("arial.ttf");
+        if (path.empty()) return false;
 
         std::ifstream f(path, std::ios::binary);
         if (!f) return false;
@@ -3489,9 +3411,27 @@ namespace pdf
 
     bool PdfDocument::loadFromBytes(const std::vector<uint8_t>& data)
     {
-        _data = data;
+        return loadFromBytes(std::vector<uint8_t>(data));
+    }
+
+    bool PdfDocument::loadFromBytes(std::vector<uint8_t>&& data)
+    {
+        auto owned = std::make_shared<std::vector<uint8_t>>(std::move(data));
+        const uint8_t* p = owned->data();
+        size_t size = owned->size();
+        return loadFromMemory(std::shared_ptr<const uint8_t>(owned, p), size);
+    }
+
+    bool PdfDocument::loadFromMemory(std::shared_ptr<const uint8_t> data, size_t size)
+    {
+        _dataOwner = std::move(data);
+        _data = PdfByteView(_dataOwner.get(), size);
         _objects.clear();
         _xrefTable.clear();
+        _objStmEntries.clear();
+        clearObjStmCache();
+        _repairScanned = false;
+        invalidatePageIndex();
         _trailer.reset();
         _root.reset();
         _pages.reset();
@@ -3499,29 +3439,26 @@ namespace pdf
         if (_data.size() < 4)
             return false;
 
-        // 1. Load XRef table first (for correct object positions with incremental updates)
+        // 1. Load XRef table first (for correct object positions with incremental updates).
+        //    Objects are NOT parsed here; loadIndirectObject() materializes them on demand.
         if (loadXRefTable())
         {
-            LogDebug("PDF: XRef table loaded with %zu entries", _xrefTable.size());
+            LogDebug("PDF: XRef table loaded with %zu entries (lazy object loading)", _xrefTable.size());
         }
         else
         {
-            LogDebug("PDF: XRef table not found or invalid, using linear scan only");
+            // 2. XRef yok/bozuk -> repair: tüm dosyayı lineer tara
+            LogDebug("PDF: XRef table not found or invalid, using linear scan");
+            repairScan();
+            if (_objects.empty())
+                return false;
         }
 
-        // 2. Linear scan parser (fallback for objects not in XRef)
-        PdfParser parser(_data);
-        if (!parser.parse())
-            return false;
-
-        _objects = parser.objects();
-
         // 2.5. Check for encryption and initialize decryption if needed
         LogDebug("PDF: Checking encryption, _trailer=%s", _trailer ? "YES" : "NULL");
         if (_trailer)
         {
-            auto encryptRef = _trailer->get("/Encrypt");
-            if (!encryptRef) encryptRef = _trailer->get("Encrypt");
+            auto encryptRef = _trailer->get(PdfKeys::Encrypt);
             LogDebug("PDF: /Encrypt ref = %s", encryptRef ? "FOUND" : "NOT FOUND");
             if (encryptRef)
             {
@@ -3536,6 +3473,8 @@ namespace pdf
                     {
                         LogDebug("PDF: Certificate encryption detected - waiting for certificate/seed");
                         // Don't decrypt streams yet - need seed from C# RSA decrypt
+                        for (const auto& kv : _objects)
+                            markStreamEncrypted(kv.second, kv.first, 0);
                     }
                     else
                     {
@@ -3549,26 +3488,10 @@ namespace pdf
                         }
                         LogDebug("PDF: Encryption key computed: %s (%d bytes)", keyHex.c_str(), (int)_encryptKey.size());
 
-                        // Decrypt all stream objects
-                        int decryptCount = 0;
-                        for (auto& kv : _objects)
-                        {
-                            auto stream = std::dynamic_pointer_cast<PdfStream>(kv.second);
-                            if (stream)
-                            {
-                                size_t beforeSize = stream->data.size();
-                                decryptStream(stream);
-                                decryptCount++;
-                                // Log first 4 bytes after decrypt for key streams
-                                if (!stream->data.empty() && stream->data.size() >= 2)
-                                {
-                                    LogDebug("PDF: Decrypted obj %d: %zu bytes, first2=0x%02x%02x",
-                                        kv.first, stream->data.size(),
-                                        stream->data[0], stream->data[1]);
-                                }
-                            }
-                        }
-                        LogDebug("PDF: Decrypted %d streams total", decryptCount);
+                        // Streams are decrypted on first use (decryptStream);
+                        // anything loaded before /Encrypt was seen is still raw
+                        for (const auto& kv : _objects)
+                            markStreamEncrypted(kv.second, kv.first, 0);
                     } // end else (password encryption)
                 }
                 else
@@ -3578,107 +3501,11 @@ namespace pdf
             }
         }
 
-        // 3. XRef tablosundan eksik objeleri yükle (Linearized PDF desteği için kritik)
-        if (!_xrefTable.empty())
-        {
-            LogDebug("PDF: Loading objects from XRef table...");
-            int loadedFromXref = 0;
-            for (const auto& kv : _xrefTable)
-            {
-                int objNum = kv.first;
-                size_t offset = kv.second;
-
-                // Eğer bu obje zaten linear scan ile yüklenmişse atla
-                if (_objects.find(objNum) != _objects.end())
-                    continue;
-
-                // XRef'ten objeyi yükle
-                auto obj = loadObjectAtOffset(offset);
-                if (obj)
-                {
-                    // Decrypt stream if encryption is active
-                    if (_encryptionReady)
-                    {
-                        auto stream = std::dynamic_pointer_cast<PdfStream>(obj);
-                        if (stream) decryptStream(stream);
-                    }
-                    _objects[objNum] = obj;
-                    loadedFromXref++;
-                }
-            }
-            LogDebug("PDF: Loaded %d additional objects from XRef", loadedFromXref);
-        }
-
-        // 4. Object Stream (ObjStm) içindeki objeleri yükle (type 2 xref girdileri)
-        if (!_objStmEntries.empty())
-        {
-            LogDebug("PDF: Loading %zu objects from Object Streams...", _objStmEntries.size());
-            int loadedFromObjStm = 0;
-            for (const auto& kv : _objStmEntries)
-            {
-                int objNum = kv.first;
-                if (_objects.find(objNum) != _objects.end())
-                    continue;
-
-                auto obj = loadFromObjStm(objNum, kv.second.objStmNum, kv.second.indexInStream);
-                if (obj)
-                {
-                    _objects[objNum] = obj;
-                    loadedFromObjStm++;
-                }
-            }
-            LogDebug("PDF: Loaded %d objects from Object Streams", loadedFromObjStm);
-        }
-
-        if (_objects.empty() && _xrefTable.empty())
+        if (_objects.empty() && _xrefTable.empty() && _objStmEntries.empty())
             return false;
 
-        // /Root (Catalog) bul
-        for (const auto& kv : _objects)
-        {
-            auto dict = std::dynamic_pointer_cast<PdfDictionary>(kv.second);
-            if (!dict) continue;
-
-            std::set<int> v;
-            auto typeObj = resolveIndirect(dict->get("/Type"), v);
-            auto typeName = std::dynamic_pointer_cast<PdfName>(typeObj);
-            if (!typeName) continue;
-
-            if (typeName->value == "/Catalog" || typeName->value == "Catalog")
-            {
-                _root = dict;
-                break;
-            }
-        }
-
-        // /Pages bul
-        if (_root)
-        {
-            std::set<int> v;
-            auto pagesObj = resolveIndirect(_root->get("/Pages"), v);
-            _pages = std::dynamic_pointer_cast<PdfDictionary>(pagesObj);
-        }
-
-        if (!_pages)
-        {
-            // Yine de fail yapmıyoruz; fallback olarak tüm objeleri tarayıp sayfa bulacağız
-            for (const auto& kv : _objects)
-            {
-                auto dict = std::dynamic_pointer_cast<PdfDictionary>(kv.second);
-                if (!dict) continue;
-
-                std::set<int> v;
-                auto typeObj = resolveIndirect(dict->get("/Type"), v);
-                auto typeName = std::dynamic_pointer_cast<PdfName>(typeObj);
-                if (!typeName) continue;
-
-                if (typeName->value == "/Pages" || typeName->value == "Pages")
-                {
-                    _pages = dict;
-                    break;
-                }
-            }
-        }
+        // 3. /Root (Catalog) ve /Pages
+        loadRootAndPages();
 
         // Burada _pages bulamasak bile SUCCESS kabul ediyoruz
         // Sayfa sayımı ve boyut hesapları fallback ile çalışacak.
@@ -3690,7 +3517,7 @@ namespace pdf
     // =====================================================
 
     // Helper: Find last occurrence of a string in data
-    static size_t rfind_string(const std::vector<uint8_t>& data, const char* str)
+    static size_t rfind_string(PdfByteView data, const char* str)
     {
         size_t len = strlen(str);
         if (data.size() < len) return std::string::npos;
@@ -3709,7 +3536,7 @@ namespace pdf
     }
 
     // Helper: Skip whitespace
-    static size_t skipWhitespaceXRef(const std::vector<uint8_t>& data, size_t pos)
+    static size_t skipWhitespaceXRef(PdfByteView data, size_t pos)
     {
         while (pos < data.size() &&
             (data[pos] == ' ' || data[pos] == '\t' ||
@@ -3721,7 +3548,7 @@ namespace pdf
     }
 
     // Helper: Read integer from data
-    static size_t readIntegerXRef(const std::vector<uint8_t>& data, size_t pos, int64_t& value)
+    static size_t readIntegerXRef(PdfByteView data, size_t pos, int64_t& value)
     {
         pos = skipWhitespaceXRef(data, pos);
         value = 0;
@@ -3751,7 +3578,7 @@ namespace pdf
     }
 
     // Parse traditional XRef table at given offset
-    bool PdfDocument::parseXRefTableAt(size_t offset, std::map<int, size_t>& xrefEntries)
+    bool PdfDocument::parseXRefTableAt(size_t offset, PdfObjTable<size_t>& xrefEntries)
     {
         if (offset >= _data.size()) return false;
 
@@ -3813,7 +3640,7 @@ namespace pdf
                 if (flag == 'n' && entryOffset > 0)
                 {
                     // Only add if not already present (newer entries take precedence)
-                    if (xrefEntries.find(objNum) == xrefEntries.end())
+                    if (!xrefEntries.count(objNum))
                     {
                         xrefEntries[objNum] = (size_t)entryOffset;
                     }
@@ -3825,59 +3652,55 @@ namespace pdf
     }
 
     // Parse XRef stream at given offset (PDF 1.5+)
-    bool PdfDocument::parseXRefStreamAt(size_t offset, std::map<int, size_t>& xrefEntries)
+    bool PdfDocument::parseXRefStreamAt(size_t offset, PdfObjTable<size_t>& xrefEntries)
     {
         // XRef stream is an object: "N 0 obj << ... >> stream ... endstream endobj"
         if (offset >= _data.size()) return false;
 
         // Parse the object
-        PdfParser parser(_data);
+        PdfParser parser(_data, _dataOwner);
         auto obj = parser.parseObjectAt(offset);
         if (!obj) return false;
 
-        auto stream = std::dynamic_pointer_cast<PdfStream>(obj);
+        auto stream = pdfCast<PdfStream>(obj);
         if (!stream || !stream->dict) return false;
 
         // Check /Type /XRef
-        auto typeObj = stream->dict->get("/Type");
-        if (!typeObj) typeObj = stream->dict->get("Type");
-        auto typeName = std::dynamic_pointer_cast<PdfName>(typeObj);
-        if (!typeName || (typeName->value != "/XRef" && typeName->value != "XRef"))
+        auto typeObj = stream->dict->get(PdfKeys::Type);
+        auto typeName = pdfCast<PdfName>(typeObj);
+        if (!typeName || (typeName->value != "/XRef"))
             return false;
 
         // Get /Size
-        auto sizeObj = stream->dict->get("/Size");
-        if (!sizeObj) sizeObj = stream->dict->get("Size");
-        auto sizeNum = std::dynamic_pointer_cast<PdfNumber>(sizeObj);
+        auto sizeObj = stream->dict->get(PdfKeys::Size);
+        auto sizeNum = pdfCast<PdfNumber>(sizeObj);
         if (!sizeNum) return false;
         int xrefSize = (int)sizeNum->value;
 
         // Get /W array (field widths)
-        auto wObj = stream->dict->get("/W");
-        if (!wObj) wObj = stream->dict->get("W");
-        auto wArr = std::dynamic_pointer_cast<PdfArray>(wObj);
+        auto wObj = stream->dict->get(PdfKeys::W);
+        auto wArr = pdfCast<PdfArray>(wObj);
         if (!wArr || wArr->items.size() < 3) return false;
 
         int w1 = 0, w2 = 0, w3 = 0;
-        if (auto n = std::dynamic_pointer_cast<PdfNumber>(wArr->items[0])) w1 = (int)n->value;
-        if (auto n = std::dynamic_pointer_cast<PdfNumber>(wArr->items[1])) w2 = (int)n->value;
-        if (auto n = std::dynamic_pointer_cast<PdfNumber>(wArr->items[2])) w3 = (int)n->value;
+        if (auto n = pdfCast<PdfNumber>(wArr->items[0])) w1 = (int)n->value;
+        if (auto n = pdfCast<PdfNumber>(wArr->items[1])) w2 = (int)n->value;
+        if (auto n = pdfCast<PdfNumber>(wArr->items[2])) w3 = (int)n->value;
 
         int entrySize = w1 + w2 + w3;
         if (entrySize == 0) return false;
 
         // Get /Index array (optional, defaults to [0 Size])
         std::vector<std::pair<int, int>> subsections;
-        auto indexObj = stream->dict->get("/Index");
-        if (!indexObj) indexObj = stream->dict->get("Index");
-        auto indexArr = std::dynamic_pointer_cast<PdfArray>(indexObj);
+        auto indexObj = stream->dict->get(PdfKeys::Index);
+        auto indexArr = pdfCast<PdfArray>(indexObj);
 
         if (indexArr && indexArr->items.size() >= 2)
         {
             for (size_t i = 0; i + 1 < indexArr->items.size(); i += 2)
             {
-                auto startNum = std::dynamic_pointer_cast<PdfNumber>(indexArr->items[i]);
-                auto countNum = std::dynamic_pointer_cast<PdfNumber>(indexArr->items[i + 1]);
+                auto startNum = pdfCast<PdfNumber>(indexArr->items[i]);
+                auto countNum = pdfCast<PdfNumber>(indexArr->items[i + 1]);
                 if (startNum && countNum)
                 {
                     subsections.push_back({ (int)startNum->value, (int)countNum->value });
@@ -3930,7 +3753,7 @@ namespace pdf
                 if (type == 1) // In-use object
                 {
                     // field2 = offset, field3 = generation
-                    if (xrefEntries.find(objNum) == xrefEntries.end())
+                    if (!xrefEntries.count(objNum))
                     {
                         xrefEntries[objNum] = (size_t)field2;
                     }
@@ -3938,7 +3761,7 @@ namespace pdf
                 else if (type == 2) // Compressed object (in object stream)
                 {
                     // field2 = object stream number, field3 = index within stream
-                    if (_objStmEntries.find(objNum) == _objStmEntries.end())
+                    if (!_objStmEntries.count(objNum))
                     {
                         _objStmEntries[objNum] = { (int)field2, (int)field3 };
                     }
@@ -3974,9 +3797,9 @@ namespace pdf
                 // Parse trailer dictionary
                 if (pos < _data.size() && _data[pos] == '<' && pos + 1 < _data.size() && _data[pos + 1] == '<')
                 {
-                    PdfParser parser(_data);
+                    PdfParser parser(_data, _dataOwner);
                     auto obj = parser.parseObjectAt(pos);
-                    return std::dynamic_pointer_cast<PdfDictionary>(obj);
+                    return pdfCast<PdfDictionary>(obj);
                 }
                 break;
             }
@@ -4012,8 +3835,9 @@ namespace pdf
         LogDebug("XRef: startxref points to offset %lld", (long long)xrefOffset);
 
         // 3. Process XRef chain (handle incremental updates via /Prev)
+        // Entries go straight into _xrefTable: sections are visited newest
+        // first and only the first entry seen for an object number is kept
         std::set<size_t> visitedOffsets; // Prevent infinite loops
-        std::map<int, size_t> allEntries;
 
         while (xrefOffset > 0 && xrefOffset < (int64_t)_data.size())
         {
@@ -4037,18 +3861,7 @@ namespace pdf
                 // Traditional xref table
                 LogDebug("XRef: Parsing traditional xref at %lld", (long long)xrefOffset);
 
-                std::map<int, size_t> entries;
-                if (parseXRefTableAt(checkPos, entries))
-                {
-                    // Merge entries (newer entries take precedence)
-                    for (const auto& kv : entries)
-                    {
-                        if (allEntries.find(kv.first) == allEntries.end())
-                        {
-                            allEntries[kv.first] = kv.second;
-                        }
-                    }
-                }
+                parseXRefTableAt(checkPos, _xrefTable);
 
                 // Parse trailer
                 currentTrailer = parseTrailerAt(checkPos);
@@ -4058,16 +3871,8 @@ namespace pdf
                 // XRef stream (PDF 1.5+)
                 LogDebug("XRef: Parsing xref stream at %lld", (long long)xrefOffset);
 
-                std::map<int, size_t> entries;
-                if (parseXRefStreamAt(checkPos, entries))
+                if (parseXRefStreamAt(checkPos, _xrefTable))
                 {
-                    for (const auto& kv : entries)
-                    {
-                        if (allEntries.find(kv.first) == allEntries.end())
-                        {
-                            allEntries[kv.first] = kv.second;
-                        }
-                    }
                     currentTrailer = _trailer; // parseXRefStreamAt sets _trailer
                 }
             }
@@ -4078,13 +3883,24 @@ namespace pdf
                 _trailer = currentTrailer;
             }
 
+            // /Size bounds the object numbers: size the dense tables once
+            if (currentTrailer)
+            {
+                if (auto sizeNum = pdfCast<PdfNumber>(currentTrailer->get(PdfKeys::Size)))
+                {
+                    int size = (int)sizeNum->value;
+                    _xrefTable.reserve(size);
+                    _objStmEntries.reserve(size);
+                    _objects.reserve(size);
+                }
+            }
+
             // Follow /Prev chain for incremental updates
             xrefOffset = -1;
             if (currentTrailer)
             {
-                auto prevObj = currentTrailer->get("/Prev");
-                if (!prevObj) prevObj = currentTrailer->get("Prev");
-                auto prevNum = std::dynamic_pointer_cast<PdfNumber>(prevObj);
+                auto prevObj = currentTrailer->get(PdfKeys::Prev);
+                auto prevNum = pdfCast<PdfNumber>(prevObj);
                 if (prevNum)
                 {
                     xrefOffset = (int64_t)prevNum->value;
@@ -4093,9 +3909,6 @@ namespace pdf
             }
         }
 
-        // 4. Store results
-        _xrefTable = std::move(allEntries);
-
         LogDebug("XRef: Loaded %zu entries", _xrefTable.size());
 
         return !_xrefTable.empty();
@@ -4107,56 +3920,83 @@ namespace pdf
         return _trailer != nullptr;
     }
 
-    bool PdfDocument::loadRootAndPages() { return false; }
-    int  PdfDocument::getPageCountByScan() const { return 0; }
-    int PdfDocument::countPagesRecursive(
-        const std::shared_ptr<PdfDictionary>& node,
-        std::set<const PdfDictionary*>& visited) const
+    // =====================================================
+    // /Root (Catalog) ve /Pages
+    // Önce trailer /Root; bulunamazsa repair scan ile Catalog aranır.
+    // =====================================================
+
+    static bool hasTypeName(const std::shared_ptr<PdfDictionary>& dict, const char* name)
     {
-        if (!node) return 0;
-        if (visited.count(node.get())) return 0;
-        visited.insert(node.get());
+        auto typeName = pdfCast<PdfName>(dictGet(dict, PdfKeys::Type));
+        if (!typeName) return false;
+        return typeName->value.compare(1, std::string::npos, name) == 0;
+    }
 
-        std::set<int> v;
-        auto typeObj = resolveIndirect(node->get("/Type"), v);
-        if (!typeObj) { v.clear(); typeObj = resolveIndirect(node->get("Type"), v); }
-        auto typeName = std::dynamic_pointer_cast<PdfName>(typeObj);
-        std::string t = typeName ? typeName->value : "";
+    bool PdfDocument::loadRootAndPages()
+    {
+        _root.reset();
+        _pages.reset();
+        invalidatePageIndex();
 
-        // Yaprak düğüm: /Page
-        if (t == "/Page" || t == "Page")
-            return isPageObject(node) ? 1 : 0;
+        // 1. Trailer /Root (xref yolu - tam tarama gerekmez)
+        if (_trailer)
+        {
+            PdfVisitedRefs v;
+            _root = pdfCast<PdfDictionary>(
+                resolveIndirect(dictGet(_trailer, PdfKeys::Root), v));
+        }
 
-        // Ara düğüm: /Pages
-        if (t == "/Pages" || t == "Pages")
+        // 2. Repair: Catalog objesini tara
+        if (!_root)
         {
-            v.clear();
-            auto kidsObj = resolveIndirect(node->get("/Kids"), v);
-            auto kidsArr = std::dynamic_pointer_cast<PdfArray>(kidsObj);
-            if (!kidsArr) return 0;
+            LogDebug("PDF: trailer /Root not usable, scanning for /Catalog");
+            repairScan();
+            for (const auto& kv : _objects)
+            {
+                auto dict = pdfCast<PdfDictionary>(kv.second);
+                if (dict && hasTypeName(dict, "Catalog"))
+                {
+                    _root = dict;
+                    break;
+                }
+            }
+        }
+
+        // /Pages bul
+        if (_root)
+        {
+            PdfVisitedRefs v;
+            auto pagesObj = resolveIndirect(_root->get(PdfKeys::Pages), v);
+            _pages = pdfCast<PdfDictionary>(pagesObj);
+        }
 
-            int total = 0;
-            for (auto& item : kidsArr->items)
+        if (!_pages)
+        {
+            // Yine de fail yapmıyoruz; fallback olarak tüm objeleri tarayıp sayfa bulacağız
+            repairScan();
+            for (const auto& kv : _objects)
             {
-                v.clear();
-                auto childDict = std::dynamic_pointer_cast<PdfDictionary>(
-                    resolveIndirect(item, v));
-                if (childDict)
-                    total += countPagesRecursive(childDict, visited);
+                auto dict = pdfCast<PdfDictionary>(kv.second);
+                if (dict && hasTypeName(dict, "Pages"))
+                {
+                    _pages = dict;
+                    break;
+                }
             }
-            return total;
         }
 
-        return 0;
+        return _root || _pages;
     }
 
+    int  PdfDocument::getPageCountByScan() const { return 0; }
+
     // =====================================================
     // Indirect Referans Çözücü
     // =====================================================
 
     std::shared_ptr<PdfObject> PdfDocument::resolveIndirect(
         const std::shared_ptr<PdfObject>& obj,
-        std::set<int>& visitedIds
+        PdfVisitedRefs& visitedIds
     ) const
     {
         if (!obj) return nullptr;
@@ -4164,7 +4004,7 @@ namespace pdf
         if (obj->type() != PdfObjectType::IndirectRef)
             return obj;
 
-        auto ref = std::dynamic_pointer_cast<PdfIndirectRef>(obj);
+        auto ref = pdfCast<PdfIndirectRef>(obj);
         if (!ref) return nullptr;
 
         // ✅ Circular reference kontrolü
@@ -4183,265 +4023,564 @@ namespace pdf
 
         visitedIds.insert(ref->objNum);
 
-        // FIRST: Check _objects (already parsed and possibly decrypted)
-        auto it = _objects.find(ref->objNum);
-        if (it != _objects.end())
-            return resolveIndirect(it->second, visitedIds);
+        auto loaded = loadIndirectObject(ref->objNum, ref->genNum);
+        if (!loaded)
+            return nullptr;
+
+        return resolveIndirect(loaded, visitedIds);
+    }
+
+    // =====================================================
+    // Lazy Object Loading
+    // =====================================================
 
-        // FALLBACK: Load from XRef table if not in _objects
-        auto itX = _xrefTable.find(ref->objNum);
-        if (itX != _xrefTable.end())
+    // ObjStm başlığı: ilk /N çift integer "objNum offset" (0..first arası)
+    static void parseObjStmHeader(const std::vector<uint8_t>& decoded, int n, int first,
+        std::vector<std::pair<int, int>>& entries)
+    {
+        size_t pos = 0;
+        for (int i = 0; i < n && pos < (size_t)first; i++)
         {
-            auto loaded = const_cast<PdfDocument*>(this)->loadObjectAtOffset(itX->second);
-            if (loaded)
+            // whitespace atla
+            while (pos < decoded.size() && (decoded[pos] == ' ' || decoded[pos] == '\n' || decoded[pos] == '\r' || decoded[pos] == '\t'))
+                pos++;
+
+            // objNum oku
+            int oNum = 0;
+            while (pos < decoded.size() && decoded[pos] >= '0' && decoded[pos] <= '9')
             {
-                // Decrypt if needed
-                if (_encryptionReady)
-                {
-                    auto stream = std::dynamic_pointer_cast<PdfStream>(loaded);
-                    if (stream && !stream->data.empty())
-                    {
-                        auto objKey = computeObjectKey(ref->objNum, ref->genNum);
-                        if (_useAES)
-                        {
-                            std::vector<uint8_t> decrypted;
-                            if (aesDecryptCBC(objKey, stream->data.data(), stream->data.size(), decrypted))
-                                stream->data = std::move(decrypted);
-                        }
-                        else
-                        {
-                            std::vector<uint8_t> decrypted;
-                            rc4Crypt(objKey, stream->data.data(), stream->data.size(), decrypted);
-                            stream->data = std::move(decrypted);
-                        }
-                    }
-                }
-                // Cache in _objects so we don't reload again
-                const_cast<PdfDocument*>(this)->_objects[ref->objNum] = loaded;
-                return resolveIndirect(loaded, visitedIds);
+                oNum = oNum * 10 + (decoded[pos] - '0');
+                pos++;
             }
-        }
 
-        // FALLBACK 2: Object Stream (ObjStm) — type 2 xref entries
-        auto itObjStm = _objStmEntries.find(ref->objNum);
-        if (itObjStm != _objStmEntries.end())
-        {
-            auto loaded = const_cast<PdfDocument*>(this)->loadFromObjStm(
-                ref->objNum, itObjStm->second.objStmNum, itObjStm->second.indexInStream);
-            if (loaded)
+            // whitespace atla
+            while (pos < decoded.size() && (decoded[pos] == ' ' || decoded[pos] == '\n' || decoded[pos] == '\r' || decoded[pos] == '\t'))
+                pos++;
+
+            // offset oku
+            int off = 0;
+            while (pos < decoded.size() && decoded[pos] >= '0' && decoded[pos] <= '9')
             {
-                const_cast<PdfDocument*>(this)->_objects[ref->objNum] = loaded;
-                return resolveIndirect(loaded, visitedIds);
+                off = off * 10 + (decoded[pos] - '0');
+                pos++;
             }
-        }
 
-        return nullptr;
+            entries.push_back({ oNum, off });
+        }
     }
 
-    // =====================================================
-    // Object Stream (ObjStm) Parse & Load
-    // =====================================================
-
-    std::shared_ptr<PdfObject> PdfDocument::loadFromObjStm(int objNum, int objStmNum, int indexInStream)
+    // Tek giriş noktası: cache -> xref (type 1) -> ObjStm (type 2) -> repair scan.
+    // Yüklenen obje decrypt edilip _objects'e cache'lenir.
+    std::shared_ptr<PdfObject> PdfDocument::loadIndirectObject(int objNum, int genNum) const
     {
-        // 1. ObjStm objesini yükle (kendisi type 1 veya zaten _objects'te olmalı)
-        auto itObj = _objects.find(objStmNum);
-        std::shared_ptr<PdfStream> objStmStream;
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+
+        auto* self = const_cast<PdfDocument*>(this);
 
-        if (itObj != _objects.end())
+        if (const PdfObjectPtr* cached = _objects.find(objNum))
+            return *cached;
+
+        // 1. XRef type 1: dosya offset'i
+        if (const size_t* offset = _xrefTable.find(objNum))
         {
-            objStmStream = std::dynamic_pointer_cast<PdfStream>(itObj->second);
-        }
+            int headerObjNum = -1;
+            PdfParser parser(_data, _dataOwner);
+            auto loaded = parser.parseObjectAt(*offset, &headerObjNum);
+
+            if (loaded && headerObjNum == objNum)
+            {
+                // Stream şifreli kalır; ilk decode'da çözülür (decryptStream)
+                markStreamEncrypted(loaded, objNum, genNum);
+
+                self->_objects[objNum] = loaded;
+                return loaded;
+            }
 
-        // _objects'te yoksa xrefTable'dan yükle
-        if (!objStmStream)
+            // Offset "objNum G obj" başlığına işaret etmiyor -> xref bozuk
+            LogDebug("PDF: xref offset %zu for obj %d is stale, repairing", *offset, objNum);
+        }
+        else
         {
-            auto itX = _xrefTable.find(objStmNum);
-            if (itX != _xrefTable.end())
+            // 2. XRef type 2: Object Stream içinde
+            if (const ObjStmEntry* entry = _objStmEntries.find(objNum))
             {
-                auto loaded = loadObjectAtOffset(itX->second);
+                auto loaded = self->loadFromObjStm(objNum, entry->objStmNum, entry->indexInStream);
                 if (loaded)
                 {
-                    _objects[objStmNum] = loaded;
-                    objStmStream = std::dynamic_pointer_cast<PdfStream>(loaded);
+                    self->_objects[objNum] = loaded;
+                    return loaded;
                 }
+                return nullptr;
             }
+
+            // XRef hiç yoksa repair scan zaten yapıldı; bu obje gerçekten yok.
+            if (_xrefTable.empty() && _objStmEntries.empty())
+                return nullptr;
         }
 
-        if (!objStmStream || !objStmStream->dict) return nullptr;
+        // 3. Repair: xref'te olmayan / yanlış offset'li referans -> tek seferlik lineer tarama
+        repairScan();
+        const PdfObjectPtr* repaired = _objects.find(objNum);
+        return repaired ? *repaired : nullptr;
+    }
 
-        // 2. /N (obje sayısı) ve /First (ilk obje verisi offset) oku
-        int n = 0, first = 0;
-        if (auto nObj = std::dynamic_pointer_cast<PdfNumber>(objStmStream->dict->get("/N")))
-            n = (int)nObj->value;
-        else if (auto nObj2 = std::dynamic_pointer_cast<PdfNumber>(objStmStream->dict->get("N")))
-            n = (int)nObj2->value;
+    void PdfDocument::repairScan() const
+    {
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        if (_repairScanned)
+            return;
 
-        if (auto fObj = std::dynamic_pointer_cast<PdfNumber>(objStmStream->dict->get("/First")))
-            first = (int)fObj->value;
-        else if (auto fObj2 = std::dynamic_pointer_cast<PdfNumber>(objStmStream->dict->get("First")))
-            first = (int)fObj2->value;
+        auto* self = const_cast<PdfDocument*>(this);
+        self->_repairScanned = true;
 
-        if (n <= 0 || first <= 0 || indexInStream >= n) return nullptr;
+        PdfParser parser(_data, _dataOwner);
+        parser.parse();
 
-        // 3. Stream verisini decode et
-        std::vector<uint8_t> decoded;
-        if (!decodeStream(objStmStream, decoded) || decoded.empty())
+        int added = 0;
+        for (const auto& kv : parser.objects())
         {
-            decoded = objStmStream->data; // fallback raw
-        }
+            // xref'ten yüklenmiş objeler önceliklidir
+            if (_objects.count(kv.first))
+                continue;
 
-        if (decoded.empty()) return nullptr;
+            markStreamEncrypted(kv.second, kv.first, 0);
+            self->_objects[kv.first] = kv.second;
+            added++;
+        }
 
-        // 4. İlk /N çift integer'ı parse et: objNum1 offset1 objNum2 offset2 ...
-        //    Bu header kısmı 0'dan first'e kadar
-        std::vector<std::pair<int, int>> entries; // (objNum, relativeOffset)
+        // Tarama ObjStm içini göremez: bulunan Object Stream'leri açıp üyelerini ekle
+        for (const auto& kv : parser.objects())
         {
-            size_t pos = 0;
-            for (int i = 0; i < n && pos < (size_t)first; i++)
-            {
-                // whitespace atla
-                while (pos < decoded.size() && (decoded[pos] == ' ' || decoded[pos] == '\n' || decoded[pos] == '\r' || decoded[pos] == '\t'))
-                    pos++;
-
-                // objNum oku
-                int oNum = 0;
-                while (pos < decoded.size() && decoded[pos] >= '0' && decoded[pos] <= '9')
-                {
-                    oNum = oNum * 10 + (decoded[pos] - '0');
-                    pos++;
-                }
-
-                // whitespace atla
-                while (pos < decoded.size() && (decoded[pos] == ' ' || decoded[pos] == '\n' || decoded[pos] == '\r' || decoded[pos] == '\t'))
-                    pos++;
+            // _objects'teki kopya kullanılır: decrypt durumu onda tutuluyor
+            const PdfObjectPtr* own = _objects.find(kv.first);
+            auto stm = pdfCast<PdfStream>(own ? *own : kv.second);
+            if (!stm || !stm->dict || !hasTypeName(stm->dict, "ObjStm"))
+                continue;
 
-                // offset oku
-                int off = 0;
-                while (pos < decoded.size() && decoded[pos] >= '0' && decoded[pos] <= '9')
-                {
-                    off = off * 10 + (decoded[pos] - '0');
-                    pos++;
-                }
+            auto nObj = pdfCast<PdfNumber>(dictGet(stm->dict, PdfKeys::N));
+            auto fObj = pdfCast<PdfNumber>(dictGet(stm->dict, PdfKeys::First));
+            int n = nObj ? (int)nObj->value : 0;
+            int first = fObj ? (int)fObj->value : 0;
+            if (n <= 0 || first <= 0) continue;
 
-                entries.push_back({ oNum, off });
-            }
-        }
+            std::vector<uint8_t> decoded;
+            if (!decodeStream(stm, decoded) || (int)decoded.size() <= first)
+                continue;
 
-        if (indexInStream >= (int)entries.size()) return nullptr;
+            std::vector<std::pair<int, int>> entries;
+            parseObjStmHeader(decoded, n, first, entries);
 
-        // 5. İstenen objeyi parse et
-        int targetOffset = first + entries[indexInStream].second;
-        if (targetOffset >= (int)decoded.size()) return nullptr;
+            PdfParser stmParser(decoded);
+            for (int i = 0; i < (int)entries.size(); i++)
+            {
+                int objNum = entries[i].first;
+                size_t offset = (size_t)first + entries[i].second;
+                if (_objects.count(objNum) || offset >= decoded.size())
+                    continue;
 
-        // PdfParser ile objeyi parse et
-        PdfParser parser(decoded);
-        auto result = parser.parseObjectAt((size_t)targetOffset);
+                auto obj = stmParser.parseObjectAt(offset);
+                if (!obj) continue;
 
-        if (result)
-        {
-            LogDebug("[ObjStm] Loaded obj %d from ObjStm %d (index %d, offset %d)",
-                objNum, objStmNum, indexInStream, targetOffset);
+                self->_objects[objNum] = obj;
+                if (!_xrefTable.count(objNum))
+                    self->_objStmEntries[objNum] = { kv.first, i };
+                added++;
+            }
         }
 
-        return result;
+        LogDebug("PDF: Repair scan added %d objects (%zu total)", added, _objects.size());
     }
 
     // =====================================================
-    // Obje GERÇEK sayfa mı?
+    // Object Stream (ObjStm) Parse & Load
     // =====================================================
 
-    bool PdfDocument::isPageObject(const std::shared_ptr<PdfDictionary>& dict) const
+    // Bir ObjStm bir kez inflate edilir ve başlığı bir kez parse edilir.
+    // Decode edilmiş buffer'lar bütçeli LRU'da tutulur; üyeler ihtiyaç oldukça
+    // parse edilip _objects'e cache'lenir.
+    std::shared_ptr<PdfDocument::DecodedObjStm> PdfDocument::getDecodedObjStm(int objStmNum)
     {
-        if (!dict) return false;
+        if (auto* cached = _objStmCache.find(objStmNum))
+            return *cached;
 
-        std::set<int> v;
-        auto typeObj = resolveIndirect(dict->get("/Type"), v);
-        if (!typeObj)
-        {
-            v.clear();
-            typeObj = resolveIndirect(dict->get("Type"), v);
-        }
+        // 1. ObjStm objesini yükle (kendisi type 1 olmalı; gerekirse decrypt edilir)
+        if (_objStmEntries.count(objStmNum)) return nullptr; // ObjStm kendisi sıkıştırılamaz
+        auto objStmStream = pdfCast<PdfStream>(loadIndirectObject(objStmNum, 0));
 
-        auto typeName = std::dynamic_pointer_cast<PdfName>(typeObj);
-        if (typeName)
-        {
-            if (typeName->value != "/Page" && typeName->value != "Page")
-                return false;
-        }
-        else
-        {
-            // Tam Type yoksa ama MediaBox/Parent varsa yine sayfa kabul edelim
-            if (!dict->get("/MediaBox") && !dict->get("MediaBox") && !dict->get("/Parent"))
-                return false;
-        }
+        if (!objStmStream || !objStmStream->dict) return nullptr;
 
-        // Ghost page filtresi (çok dar sayfaları ele)
-        v.clear();
-        auto mbObj = resolveIndirect(dict->get("/MediaBox"), v);
-        if (!mbObj)
+        // 2. /N (obje sayısı) ve /First (ilk obje verisi offset) oku
+        auto nObj = pdfCast<PdfNumber>(dictGet(objStmStream->dict, PdfKeys::N));
+        auto fObj = pdfCast<PdfNumber>(dictGet(objStmStream->dict, PdfKeys::First));
+        int n = nObj ? (int)nObj->value : 0;
+        int first = fObj ? (int)fObj->value : 0;
+
+        if (n <= 0 || first <= 0) return nullptr;
+
+        // 3. Stream verisini decode et
+        auto stm = std::make_shared<DecodedObjStm>();
+        if (!decodeStream(objStmStream, stm->data) || stm->data.empty())
         {
-            v.clear();
-            mbObj = resolveIndirect(dict->get("MediaBox"), v);
+            stm->data = objStmStream->data.toVector(); // fallback raw
         }
 
-        auto mbArr = std::dynamic_pointer_cast<PdfArray>(mbObj);
-        if (mbArr && mbArr->items.size() >= 4)
-        {
-            v.clear();
-            auto x1 = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(mbArr->items[0], v));
-            v.clear();
-            auto x2 = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(mbArr->items[2], v));
+        if (stm->data.empty()) return nullptr;
 
-            if (x1 && x2)
-            {
-                double w = std::abs(x2->value - x1->value);
-                if (w > 0.0 && w < 5.0) // 5 pt altı saçma
-                    return false;
-            }
-        }
+        // 4. İlk /N çift integer'ı parse et: objNum1 offset1 objNum2 offset2 ...
+        //    Bu header kısmı 0'dan first'e kadar
+        stm->first = first;
+        parseObjStmHeader(stm->data, n, first, stm->entries);
 
-        return true;
+        // 5. Cache'e koy, bütçeyi aşan en eski buffer'ları at
+        _objStmCache.put(objStmNum, stm, stm->data.size());
+        _objStmCache.trim(OBJSTM_CACHE_BUDGET, OBJSTM_CACHE_MAX, 1);
+
+        LogDebug("[ObjStm] Decoded ObjStm %d: %d objects, %zu bytes (cache %zu streams, %zu bytes)",
+            objStmNum, (int)stm->entries.size(), stm->data.size(), _objStmCache.size(), _objStmCache.bytes());
+        return stm;
+    }
+
+    void PdfDocument::clearObjStmCache()
+    {
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        _objStmCache.clear();
     }
 
     // =====================================================
-    // Sayfa Sayısı
-    // =====================================================
+    // Page display lists
+    // =====================================================
+    void PdfDocument::setDisplayListBudget(size_t bytes)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        _displayListBudget = bytes;
+        storeDisplayList(-1, nullptr); // trim to the new budget
+    }
 
-    int PdfDocument::getPageCountFromPageTree() const
+    void PdfDocument::clearDisplayLists()
     {
-        // BİRİNCİL: Sayfa ağacını yürü (getPageDictionary ile tutarlı)
-        if (_pages)
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        _displayLists.clear();
+        _nonReplayablePages.clear();
+    }
+
+    std::shared_ptr<PdfDisplayList> PdfDocument::findDisplayList(int pageIndex)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        auto* list = _displayLists.find(pageIndex);
+        return list ? *list : nullptr;
+    }
+
+    bool PdfDocument::isPageReplayable(int pageIndex) const
+    {
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        return _nonReplayablePages.count(pageIndex) == 0;
+    }
+
+    void PdfDocument::storeDisplayList(int pageIndex, std::shared_ptr<PdfDisplayList> list)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        // Remember the page so later renders skip recording and banding
+        if (list && !list->replayable())
+            _nonReplayablePages.insert(pageIndex);
+
+        // A single page larger than the whole budget is not worth keeping
+        if (list && list->replayable() && list->byteSize() <= _displayListBudget)
+            _displayLists.put(pageIndex, list, list->byteSize());
+        _displayLists.trim(_displayListBudget);
+
+        if (list)
+            LogDebug("[DisplayList] page %d: %zu commands, %zu bytes%s (cache %zu pages, %zu bytes)",
+                pageIndex, list->commandCount(), list->byteSize(),
+                list->replayable() ? "" : ", not replayable",
+                _displayLists.size(), _displayLists.bytes());
+    }
+
+    // =====================================================
+    // Compiled Form XObjects
+    // =====================================================
+    std::shared_ptr<PdfCompiledForm> PdfDocument::findCompiledForm(int objNum)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        auto* form = _formCache.find(objNum);
+        if (!form)
         {
-            std::set<const PdfDictionary*> visited;
-            int treeCount = countPagesRecursive(_pages, visited);
-            if (treeCount > 0)
-                return treeCount;
+            _formCacheMisses++;
+            return nullptr;
         }
+        _formCacheHits++;
+        return *form;
+    }
 
-        // YEDEK: Bozuk/eksik sayfa ağacı için tüm objeleri tara
-        int manualCount = 0;
-        for (const auto& kv : _objects)
+    void PdfDocument::storeCompiledForm(int objNum, std::shared_ptr<PdfCompiledForm> form)
+    {
+        if (!form) return;
+
+        const size_t bytes = form->byteSize();
+        if (bytes > FORM_CACHE_BUDGET) return;
+
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+
+        _formCache.put(objNum, std::move(form), bytes);
+        _formCache.trim(FORM_CACHE_BUDGET, SIZE_MAX, 1);
+
+        LogDebug("[FormCache] Compiled Form %d: %zu bytes (cache %zu forms, %zu bytes)",
+            objNum, bytes, _formCache.size(), _formCache.bytes());
+    }
+
+    void PdfDocument::getFormCacheStats(size_t& hits, size_t& misses, size_t& entries, size_t& bytes) const
+    {
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        hits = _formCacheHits;
+        misses = _formCacheMisses;
+        entries = _formCache.size();
+        bytes = _formCache.bytes();
+    }
+
+    void PdfDocument::clearFormCache()
+    {
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        _formCache.clear();
+    }
+
+    // =====================================================
+    // Decoded images
+    // =====================================================
+    bool PdfDocument::getDecodedImage(
+        int objNum,
+        const std::shared_ptr<PdfStream>& st,
+        std::shared_ptr<const std::vector<uint8_t>>& argb, int& w, int& h)
+    {
+        {
+            std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+            if (auto* cached = _imageCache.find(objNum))
+            {
+                _imageCacheHits++;
+                argb = cached->argb;
+                w = cached->w;
+                h = cached->h;
+                return true;
+            }
+            _imageCacheMisses++;
+        }
+
+        // Decode without the lock: other pages keep rendering meanwhile
+        auto decoded = std::make_shared<std::vector<uint8_t>>();
+        if (!decodeImageXObject(st, *decoded, w, h))
+        {
+            argb.reset();
+            return false;
+        }
+        argb = decoded;
+
+        const size_t bytes = decoded->size();
+
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        if (bytes > _imageCacheBudget || _imageCache.contains(objNum))
+            return true; // too large, or another thread stored it first
+
+        _imageCache.put(objNum, { argb, w, h }, bytes);
+        _imageCache.trim(_imageCacheBudget);
+
+        LogDebug("[ImageCache] Image %d: %dx%d, %zu bytes (cache %zu images, %zu bytes)",
+            objNum, w, h, bytes, _imageCache.size(), _imageCache.bytes());
+        return true;
+    }
+
+    void PdfDocument::setImageCacheBudget(size_t bytes)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        _imageCacheBudget = bytes;
+        _imageCache.trim(_imageCacheBudget);
+    }
+
+    void PdfDocument::getImageCacheStats(size_t& hits, size_t& misses, size_t& entries, size_t& bytes) const
+    {
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        hits = _imageCacheHits;
+        misses = _imageCacheMisses;
+        entries = _imageCache.size();
+        bytes = _imageCache.bytes();
+    }
+
+    void PdfDocument::clearImageCache()
+    {
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        _imageCache.clear();
+    }
+
+    std::shared_ptr<PdfObject> PdfDocument::loadFromObjStm(int objNum, int objStmNum, int indexInStream)
+    {
+        auto stm = getDecodedObjStm(objStmNum);
+        if (!stm || indexInStream < 0) return nullptr;
+
+        // Index yanlışsa (bozuk xref) objNum ile ara
+        int idx = indexInStream;
+        if (idx >= (int)stm->entries.size() || stm->entries[idx].first != objNum)
+        {
+            idx = -1;
+            for (int i = 0; i < (int)stm->entries.size(); i++)
+            {
+                if (stm->entries[i].first == objNum) { idx = i; break; }
+            }
+            if (idx < 0) return nullptr;
+        }
+
+        // İstenen objeyi parse et
+        size_t targetOffset = (size_t)stm->first + (size_t)stm->entries[idx].second;
+        if (targetOffset >= stm->data.size()) return nullptr;
+
+        PdfParser parser(stm->data);
+        return parser.parseObjectAt(targetOffset);
+    }
+
+    // =====================================================
+    // Obje GERÇEK sayfa mı?
+    // =====================================================
+
+    bool PdfDocument::isPageObject(const std::shared_ptr<PdfDictionary>& dict) const
+    {
+        if (!dict) return false;
+
+        PdfVisitedRefs v;
+        auto typeObj = resolveIndirect(dict->get(PdfKeys::Type), v);
+
+        auto typeName = pdfCast<PdfName>(typeObj);
+        if (typeName)
+        {
+            if (typeName->value != "/Page")
+                return false;
+        }
+        else
+        {
+            // Tam Type yoksa ama MediaBox/Parent varsa yine sayfa kabul edelim
+            if (!dict->get(PdfKeys::MediaBox) && !dict->get(PdfKeys::Parent))
+                return false;
+        }
+
+        // Ghost page filtresi (çok dar sayfaları ele)
+        v.clear();
+        auto mbObj = resolveIndirect(dict->get(PdfKeys::MediaBox), v);
+
+        auto mbArr = pdfCast<PdfArray>(mbObj);
+        if (mbArr && mbArr->items.size() >= 4)
         {
-            auto dict = std::dynamic_pointer_cast<PdfDictionary>(kv.second);
-            if (dict && isPageObject(dict))
-                manualCount++;
+            v.clear();
+            auto x1 = pdfCast<PdfNumber>(resolveIndirect(mbArr->items[0], v));
+            v.clear();
+            auto x2 = pdfCast<PdfNumber>(resolveIndirect(mbArr->items[2], v));
+
+            if (x1 && x2)
+            {
+                double w = std::abs(x2->value - x1->value);
+                if (w > 0.0 && w < 5.0) // 5 pt altı saçma
+                    return false;
+            }
         }
 
-        if (manualCount > 0)
-            return manualCount;
+        return true;
+    }
+
+    // =====================================================
+    // Sayfa Sayısı
+    // =====================================================
+
+    int PdfDocument::getPageCountFromPageTree() const
+    {
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        buildPageIndex();
+        if (!_pageIndex.empty())
+            return (int)_pageIndex.size();
 
         return _objects.empty() ? -1 : 0;
     }
 
     // =====================================================
-    // Page Dictionary – 0 based
+    // Page Index - sayfa ağacı düzleştirilir
+    // Eskiden her getPageDictionary çağrısı tüm /Kids ağacını yürüyordu
+    // (sayfa başına O(N), thumbnail'larda O(N²)).
+    //
+    // Kök /Count tutarlıysa index yalnızca boyutlanır; bir sayfa ilk
+    // istendiğinde ağaçta /Count'lara bakarak ona giden yol inilir ve
+    // yol üstündeki yapraklar doldurulur (ilk sayfa O(derinlik x Kids)).
+    // /Count eksik ya da tutarsızsa eskisi gibi tüm ağaç yürünür
+    // (repair scan yalnızca orada). Ghost page filtresi (isPageObject)
+    // tembel yolda da uygulanır: süzülen bir yaprak görülürse /Count onu
+    // saydığı için indexler tutmaz, yine tam yürüyüşe düşülür.
     // =====================================================
 
-    std::shared_ptr<PdfDictionary> PdfDocument::getPageDictionary(int pageIndex) const
+    // 1 = /Page, 2 = /Pages, 0 = ne o ne bu
+    int PdfDocument::pageTreeNodeType(const std::shared_ptr<PdfDictionary>& node) const
     {
-        if (pageIndex < 0)
-            return nullptr;
+        PdfVisitedRefs v;
+        auto typeName = pdfCast<PdfName>(resolveIndirect(node->get(PdfKeys::Type), v));
+        const std::string t = typeName ? typeName->value : "";
+        if (t == "/Page") return 1;
+        if (t == "/Pages") return 2;
+        return 0;
+    }
+
+    // /Count of a /Pages node; -1 when missing or not a sane number
+    int PdfDocument::pageTreeNodeCount(const std::shared_ptr<PdfDictionary>& node) const
+    {
+        PdfVisitedRefs v;
+        auto countNum = pdfCast<PdfNumber>(resolveIndirect(node->get(PdfKeys::Count), v));
+        if (!countNum || countNum->value < 0 || countNum->value > 10000000.0)
+            return -1;
+        return (int)countNum->value;
+    }
+
+    std::shared_ptr<PdfArray> PdfDocument::pageTreeKids(const std::shared_ptr<PdfDictionary>& node) const
+    {
+        PdfVisitedRefs v;
+        return pdfCast<PdfArray>(resolveIndirect(node->get(PdfKeys::Kids), v));
+    }
+
+    void PdfDocument::buildPageIndex() const
+    {
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        if (_pageIndexReady)
+            return;
+
+        auto* self = const_cast<PdfDocument*>(this);
+        self->_pageIndexReady = true;
+        self->_pageIndex.clear();
+        self->_pageIndexByDict.clear();
+        self->_pageIndexLazy = false;
+
+        // Kök /Count, kökün Kids'lerinin toplamıyla tutuyorsa ona güven
+        if (_pages && pageTreeNodeType(_pages) == 2)
+        {
+            const int count = pageTreeNodeCount(_pages);
+            auto kids = pageTreeKids(_pages);
+            int sum = kids ? 0 : -1;
+            for (size_t k = 0; kids && k < kids->items.size() && sum >= 0; k++)
+            {
+                PdfVisitedRefs v;
+                auto kid = pdfCast<PdfDictionary>(resolveIndirect(kids->items[k], v));
+                if (!kid) continue;
+                const int type = pageTreeNodeType(kid);
+                if (type == 1) sum = isPageObject(kid) ? sum + 1 : -1;    // ghost page: full walk
+                else if (type == 2) { const int n = pageTreeNodeCount(kid); sum = n < 0 ? -1 : sum + n; }
+            }
+
+            if (count > 0 && sum == count)
+            {
+                self->_pageIndex.resize(count);
+                self->_pageIndexLazy = true;
+                LogDebug("PageIndex: %d pages (lazy)", count);
+                return;
+            }
+        }
+
+        buildFullPageIndex();
+    }
+
+    void PdfDocument::buildFullPageIndex() const
+    {
+        auto* self = const_cast<PdfDocument*>(this);
+        self->_pageIndex.clear();
+        self->_pageIndexByDict.clear();
+        self->_pageIndexLazy = false;
 
         std::vector<std::shared_ptr<PdfDictionary>> pages;
 
@@ -4456,34 +4595,23 @@ namespace pdf
                     if (!node || visited.count(node.get())) return;
                     visited.insert(node.get());
 
-                    std::set<int> v;
-                    auto typeObj = resolveIndirect(node->get("/Type"), v);
-                    if (!typeObj)
-                    {
-                        v.clear();
-                        typeObj = resolveIndirect(node->get("Type"), v);
-                    }
-                    auto typeName = std::dynamic_pointer_cast<PdfName>(typeObj);
-                    std::string t = typeName ? typeName->value : "";
-
-                    if (t == "/Page" || t == "Page")
+                    const int type = pageTreeNodeType(node);
+                    if (type == 1)
                     {
                         if (isPageObject(node))
                             pages.push_back(node);
                         return;
                     }
 
-                    if (t == "/Pages" || t == "Pages")
+                    if (type == 2)
                     {
-                        v.clear();
-                        auto kidsObj = resolveIndirect(node->get("/Kids"), v);
-                        auto kidsArr = std::dynamic_pointer_cast<PdfArray>(kidsObj);
+                        auto kidsArr = pageTreeKids(node);
                         if (!kidsArr) return;
 
                         for (auto& k : kidsArr->items)
                         {
-                            v.clear();
-                            auto d = std::dynamic_pointer_cast<PdfDictionary>(resolveIndirect(k, v));
+                            PdfVisitedRefs v;
+                            auto d = pdfCast<PdfDictionary>(resolveIndirect(k, v));
                             if (d) walk(d);
                         }
                     }
@@ -4495,18 +4623,252 @@ namespace pdf
         // 2) Tree işe yaramazsa → tüm objeleri tara
         if (pages.empty())
         {
+            repairScan();
+
+            // isPageObject resolves MediaBox, which can load objects into
+            // _objects: collect the dictionaries before filtering them
+            std::vector<std::shared_ptr<PdfDictionary>> dicts;
             for (const auto& kv : _objects)
             {
-                auto dict = std::dynamic_pointer_cast<PdfDictionary>(kv.second);
-                if (dict && isPageObject(dict))
+                if (auto dict = pdfCast<PdfDictionary>(kv.second))
+                    dicts.push_back(dict);
+            }
+            for (auto& dict : dicts)
+            {
+                if (isPageObject(dict))
                     pages.push_back(dict);
             }
         }
 
-        if (pageIndex < 0 || pageIndex >= (int)pages.size())
+        self->_pageIndex.resize(pages.size());
+        for (size_t i = 0; i < pages.size(); i++)
+        {
+            self->_pageIndex[i] = std::make_shared<PageIndexEntry>();
+            self->_pageIndex[i]->dict = pages[i];
+            self->_pageIndexByDict.emplace(pages[i].get(), (int)i);
+        }
+
+        LogDebug("PageIndex: %zu pages", pages.size());
+    }
+
+    // Lazy index: pageIndex'e giden yolu iner; yoldaki /Page kardeşleri de
+    // doldurulur. Yol üstündeki her düğümde Kids'lerin sayfa sayıları
+    // düğümün /Count'unu tutmalı ve yapraklar ghost page olmamalı; yoksa
+    // tam yürüyüşe düşülür (indexler kayabileceği için display list'ler de
+    // atılır).
+    void PdfDocument::resolvePageIndexEntry(int pageIndex) const
+    {
+        auto* self = const_cast<PdfDocument*>(this);
+
+        std::set<const PdfDictionary*> visited;
+        std::shared_ptr<PdfDictionary> node = _pages;
+        int base = 0;
+        int limit = (int)_pageIndex.size();    // node's pages are [base, limit)
+
+        for (int depth = 0; node && depth < 64; depth++)
+        {
+            if (!visited.insert(node.get()).second)
+                break;
+
+            auto kids = pageTreeKids(node);
+            if (!kids)
+                break;
+
+            std::shared_ptr<PdfDictionary> next;
+            int nextBase = 0, nextLimit = 0;
+            bool found = false;
+            int offset = base;
+            for (size_t k = 0; k < kids->items.size() && offset <= limit; k++)
+            {
+                PdfVisitedRefs v;
+                auto kid = pdfCast<PdfDictionary>(resolveIndirect(kids->items[k], v));
+                if (!kid) continue;
+
+                const int type = pageTreeNodeType(kid);
+                if (type == 1 && !isPageObject(kid))
+                {
+                    // The full walk drops ghost pages; /Count counts them
+                    offset = limit + 1;
+                    break;
+                }
+                if (type == 1)
+                {
+                    if (offset < limit && !_pageIndex[offset])
+                    {
+                        auto e = std::make_shared<PageIndexEntry>();
+                        e->dict = kid;
+                        self->_pageIndex[offset] = e;
+                        self->_pageIndexByDict.emplace(kid.get(), offset);
+                    }
+                    found |= (offset == pageIndex);
+                    offset++;
+                }
+                else if (type == 2)
+                {
+                    const int n = pageTreeNodeCount(kid);
+                    if (n < 0)
+                    {
+                        offset = limit + 1;
+                        break;
+                    }
+                    if (!next && pageIndex >= offset && pageIndex < offset + n)
+                    {
+                        next = kid;
+                        nextBase = offset;
+                        nextLimit = offset + n;
+                    }
+                    offset += n;
+                }
+            }
+
+            if (offset != limit)
+                break;
+            if (found)
+                return;
+
+            node = next;
+            base = nextBase;
+            limit = nextLimit;
+        }
+
+        LogDebug("PageIndex: /Count mismatch or ghost page looking up page %d, walking the whole tree", pageIndex);
+        self->clearDisplayLists();
+        buildFullPageIndex();
+    }
+
+    std::shared_ptr<PdfDocument::PageIndexEntry> PdfDocument::pageIndexSlot(int pageIndex) const
+    {
+        buildPageIndex();
+        if (pageIndex < 0 || pageIndex >= (int)_pageIndex.size())
+            return nullptr;
+        if (!_pageIndex[pageIndex] && _pageIndexLazy)
+            resolvePageIndexEntry(pageIndex);
+        if (pageIndex >= (int)_pageIndex.size())
+            return nullptr;
+        return _pageIndex[pageIndex];
+    }
+
+    void PdfDocument::invalidatePageIndex()
+    {
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        _pageIndexReady = false;
+        _pageIndexLazy = false;
+        _pageIndex.clear();
+        _pageIndexByDict.clear();
+        clearDisplayLists();
+        clearFormCache();
+        clearImageCache();
+    }
+
+    // Kalıtılan öznitelikler (Rotate, CropBox/MediaBox, Resources zinciri)
+    // sayfa başına ilk erişimde bir kez çözülür. Entry kilit altında
+    // doldurulur ve ancak ondan sonra paylaşılır; sonra değişmez.
+    std::shared_ptr<const PdfDocument::PageIndexEntry> PdfDocument::getPageIndexEntry(int pageIndex) const
+    {
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        const std::shared_ptr<PageIndexEntry> entry = pageIndexSlot(pageIndex);
+        if (!entry)
             return nullptr;
 
-        return pages[pageIndex];
+        PageIndexEntry& e = *entry;
+        if (e.attrsReady)
+            return entry;
+
+        e.rotate = getPageRotate(e.dict);
+
+        double x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+        if (extractBox(e.dict, "/CropBox", x1, y1, x2, y2))
+        {
+            e.hasCropBox = true;
+            e.cropBox[0] = x1; e.cropBox[1] = y1; e.cropBox[2] = x2; e.cropBox[3] = y2;
+        }
+        if (extractBox(e.dict, "/MediaBox", x1, y1, x2, y2))
+        {
+            e.hasMediaBox = true;
+            e.mediaBox[0] = x1; e.mediaBox[1] = y1; e.mediaBox[2] = x2; e.mediaBox[3] = y2;
+        }
+
+        // Resources: önce sayfa, sonra parent'lar
+        std::shared_ptr<PdfDictionary> cur = e.dict;
+        int depth = 0;
+        while (cur && depth++ < 32)
+        {
+            PdfVisitedRefs v;
+            auto res = pdfCast<PdfDictionary>(
+                resolveIndirect(dictGet(cur, PdfKeys::Resources), v));
+            if (res)
+                e.resources.push_back(res);
+
+            v.clear();
+            cur = pdfCast<PdfDictionary>(
+                resolveIndirect(dictGet(cur, PdfKeys::Parent), v));
+        }
+
+        e.attrsReady = true;
+        return entry;
+    }
+
+    int PdfDocument::getPageIndexOf(const std::shared_ptr<PdfDictionary>& pageDict) const
+    {
+        if (!pageDict) return -1;
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        buildPageIndex();
+        auto it = _pageIndexByDict.find(pageDict.get());
+        if (it != _pageIndexByDict.end())
+            return it->second;
+        if (!_pageIndexLazy)
+            return -1;
+
+        // Henüz çözülmemiş sayfa: /Parent zincirinde yukarı çıkıp önceki
+        // kardeşlerin sayfa sayılarını topla, sonra o slotu çöz ve doğrula
+        int index = 0;
+        std::set<const PdfDictionary*> visited;
+        std::shared_ptr<PdfDictionary> cur = pageDict;
+        while (cur != _pages)
+        {
+            if (!visited.insert(cur.get()).second)
+                return -1;
+
+            PdfVisitedRefs v;
+            auto parent = pdfCast<PdfDictionary>(resolveIndirect(dictGet(cur, PdfKeys::Parent), v));
+            auto kids = parent ? pageTreeKids(parent) : nullptr;
+            if (!kids)
+                return -1;
+
+            bool found = false;
+            for (size_t k = 0; k < kids->items.size() && !found; k++)
+            {
+                v.clear();
+                auto kid = pdfCast<PdfDictionary>(resolveIndirect(kids->items[k], v));
+                if (!kid) continue;
+                if (kid == cur) { found = true; break; }
+
+                const int type = pageTreeNodeType(kid);
+                if (type == 1) index++;
+                else if (type == 2) index += std::max(pageTreeNodeCount(kid), 0);
+            }
+            if (!found)
+                return -1;
+            cur = parent;
+        }
+
+        auto entry = pageIndexSlot(index);
+        if (entry && entry->dict == pageDict)
+            return index;
+
+        it = _pageIndexByDict.find(pageDict.get());
+        return (it != _pageIndexByDict.end()) ? it->second : -1;
+    }
+
+    // =====================================================
+    // Page Dictionary – 0 based
+    // =====================================================
+
+    std::shared_ptr<PdfDictionary> PdfDocument::getPageDictionary(int pageIndex) const
+    {
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        auto entry = pageIndexSlot(pageIndex);
+        return entry ? entry->dict : nullptr;
     }
 
     // =====================================================
@@ -4523,9 +4885,9 @@ namespace pdf
 
         while (current && depth++ < MAX_DEPTH)
         {
-            std::set<int> v;
-            auto rotObj = resolveIndirect(current->get("/Rotate"), v);
-            auto rotNum = std::dynamic_pointer_cast<PdfNumber>(rotObj);
+            PdfVisitedRefs v;
+            auto rotObj = resolveIndirect(current->get(PdfKeys::Rotate), v);
+            auto rotNum = pdfCast<PdfNumber>(rotObj);
 
             if (rotNum)
             {
@@ -4539,8 +4901,8 @@ namespace pdf
             }
 
             v.clear();
-            auto parentObj = resolveIndirect(current->get("/Parent"), v);
-            current = std::dynamic_pointer_cast<PdfDictionary>(parentObj);
+            auto parentObj = resolveIndirect(current->get(PdfKeys::Parent), v);
+            current = pdfCast<PdfDictionary>(parentObj);
         }
 
         return 0;
@@ -4552,11 +4914,8 @@ namespace pdf
 
     int PdfDocument::getPageRotate(int pageIndex) const
     {
-        auto page = getPageDictionary(pageIndex);
-        if (!page)
-            return 0;
-
-        return getPageRotate(page);
+        auto e = getPageIndexEntry(pageIndex);
+        return e ? e->rotate : 0;
     }
 
     // =====================================================
@@ -4575,26 +4934,20 @@ namespace pdf
 
         while (cur && depth++ < 32)
         {
-            std::set<int> v;
+            PdfVisitedRefs v;
             auto obj = resolveIndirect(cur->get(key), v);
-            if (!obj)
-            {
-                v.clear();
-                if (!key.empty() && key[0] == '/')
-                    obj = resolveIndirect(cur->get(key.substr(1)), v);
-            }
 
-            auto arr = std::dynamic_pointer_cast<PdfArray>(obj);
+            auto arr = pdfCast<PdfArray>(obj);
             if (arr && arr->items.size() >= 4)
             {
                 v.clear();
-                auto n1 = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(arr->items[0], v));
+                auto n1 = pdfCast<PdfNumber>(resolveIndirect(arr->items[0], v));
                 v.clear();
-                auto n2 = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(arr->items[1], v));
+                auto n2 = pdfCast<PdfNumber>(resolveIndirect(arr->items[1], v));
                 v.clear();
-                auto n3 = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(arr->items[2], v));
+                auto n3 = pdfCast<PdfNumber>(resolveIndirect(arr->items[2], v));
                 v.clear();
-                auto n4 = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(arr->items[3], v));
+                auto n4 = pdfCast<PdfNumber>(resolveIndirect(arr->items[3], v));
 
                 if (n1 && n2 && n3 && n4)
                 {
@@ -4607,9 +4960,9 @@ namespace pdf
             }
 
             // Parent'a tırman
-            std::set<int> vv;
-            auto parent = resolveIndirect(cur->get("/Parent"), vv);
-            cur = std::dynamic_pointer_cast<PdfDictionary>(parent);
+            PdfVisitedRefs vv;
+            auto parent = resolveIndirect(cur->get(PdfKeys::Parent), vv);
+            cur = pdfCast<PdfDictionary>(parent);
         }
 
         return false;
@@ -4622,8 +4975,8 @@ namespace pdf
     // Raw page size (MediaBox without rotation)
     bool PdfDocument::getRawPageSize(int pageIndex, double& wPt, double& hPt) const
     {
-        auto page = getPageDictionary(pageIndex);
-        if (!page)
+        auto e = getPageIndexEntry(pageIndex);
+        if (!e)
         {
             // Page dictionary bulunamadı - default A4 döndür
             // Bu durum parsing hatası olabilir ama render'ı kırmayalım
@@ -4633,21 +4986,13 @@ namespace pdf
             return true;  // true döndür ki render devam etsin
         }
 
-        double x1 = 0, y1 = 0, x2 = 0, y2 = 0;
-
         // ✅ FIX: Önce CropBox kontrol edilmeli (PDF Spec)
         // CropBox, görüntülenecek/basılacak alanı belirler.
-        if (extractBox(page, "/CropBox", x1, y1, x2, y2))
-        {
-            wPt = std::abs(x2 - x1);
-            hPt = std::abs(y2 - y1);
-            return true;
-        }
-
-        if (extractBox(page, "/MediaBox", x1, y1, x2, y2))
+        const double* box = e->hasCropBox ? e->cropBox : (e->hasMediaBox ? e->mediaBox : nullptr);
+        if (box)
         {
-            wPt = std::abs(x2 - x1);
-            hPt = std::abs(y2 - y1);
+            wPt = std::abs(box[2] - box[0]);
+            hPt = std::abs(box[3] - box[1]);
             return true;
         }
 
@@ -4662,27 +5007,16 @@ namespace pdf
         originX = 0;
         originY = 0;
 
-        auto page = getPageDictionary(pageIndex);
-        if (!page) return false;
-
-        double x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+        auto e = getPageIndexEntry(pageIndex);
+        if (!e) return false;
 
         // CropBox öncelikli (PDF Spec)
-        if (extractBox(page, "/CropBox", x1, y1, x2, y2))
-        {
-            originX = std::min(x1, x2);
-            originY = std::min(y1, y2);
-            return true;
-        }
-
-        if (extractBox(page, "/MediaBox", x1, y1, x2, y2))
-        {
-            originX = std::min(x1, x2);
-            originY = std::min(y1, y2);
-            return true;
-        }
+        const double* box = e->hasCropBox ? e->cropBox : (e->hasMediaBox ? e->mediaBox : nullptr);
+        if (!box) return false;
 
-        return false;
+        originX = std::min(box[0], box[2]);
+        originY = std::min(box[1], box[3]);
+        return true;
     }
 
     // Display page size (rotation-aware) - for UI and painter
@@ -4722,14 +5056,14 @@ namespace pdf
             return false;
         }
 
-        auto contObj = dictGetAny(page, "/Contents", "Contents");
+        auto contObj = dictGet(page, PdfKeys::Contents);
         if (!contObj)
         {
             LogDebug("Page %d has no contents", index);
             return false;
         }
 
-        std::set<int> visited;
+        PdfVisitedRefs visited;
         auto resolved = resolveIndirect(contObj, visited);
         if (!resolved)
         {
@@ -4740,7 +5074,7 @@ namespace pdf
         // ✅ EKSİK OLAN KOD - BURASI ÖNEMLİ!
 
         // Contents tek stream ise
-        if (auto st = std::dynamic_pointer_cast<PdfStream>(resolved))
+        if (auto st = pdfCast<PdfStream>(resolved))
         {
             appendStreamData(st, out);
             LogDebug("Page %d contents size: %zu bytes (single stream)", index, out.size());
@@ -4748,13 +5082,13 @@ namespace pdf
         }
 
         // Contents array ise
-        if (auto arr = std::dynamic_pointer_cast<PdfArray>(resolved))
+        if (auto arr = pdfCast<PdfArray>(resolved))
         {
             for (auto& item : arr->items)
             {
                 visited.clear();
                 auto itemResolved = resolveIndirect(item, visited);
-                auto st = std::dynamic_pointer_cast<PdfStream>(itemResolved);
+                auto st = pdfCast<PdfStream>(itemResolved);
                 if (st)
                 {
                     appendStreamData(st, out);
@@ -4802,7 +5136,7 @@ namespace pdf
     // =====================================================
 
     bool PdfDocument::decompressFlate(
-        const std::vector<uint8_t>& input,
+        PdfByteView input,
         std::vector<uint8_t>& output
     ) const
     {
@@ -4878,40 +5212,10 @@ namespace pdf
     {
         outStack.clear();
 
-        auto page = getPageDictionary(pageIndex);
-        if (!page) return false;
+        auto e = getPageIndexEntry(pageIndex);
+        if (!e) return false;
 
-        // DEBUG: Page dictionary keys
-        {
-            std::string keys;
-            for (auto& kv : page->entries) {
-                keys += kv.first + " ";
-            }
-            LogDebug("getPageResources: page %d dict has %zu entries. Keys: %s",
-                pageIndex, page->entries.size(), keys.c_str());
-        }
-
-        std::shared_ptr<PdfDictionary> cur = page;
-        int depth = 0;
-
-        while (cur && depth++ < 32)
-        {
-            std::set<int> v;
-            auto resObj = resolveIndirect(dictGetAny(cur, "/Resources", "Resources"), v);
-            auto res = std::dynamic_pointer_cast<PdfDictionary>(resObj);
-
-            LogDebug("getPageResources: depth=%d, resObj=%s, res=%s",
-                depth - 1,
-                resObj ? "FOUND" : "NULL",
-                res ? "DICT" : "NULL");
-
-            if (res)
-                outStack.push_back(res);
-
-            v.clear();
-            auto parentObj = resolveIndirect(dictGetAny(cur, "/Parent", "Parent"), v);
-            cur = std::dynamic_pointer_cast<PdfDictionary>(parentObj);
-        }
+        outStack = e->resources;
 
         LogDebug("getPageResources: outStack.size=%zu", outStack.size());
         return !outStack.empty();
@@ -4924,6 +5228,44 @@ namespace pdf
         int pageIndex,
         PdfPainter& painter)
     {
+        PDF_TRACE_SCOPE(Page, "renderPage", "page %d", pageIndex);
+
+        // 0) Already interpreted: replay the recorded calls at this painter's scale
+        if (auto list = findDisplayList(pageIndex))
+        {
+            list->replay(painter);
+            return true;
+        }
+
+        if (_displayListBudget == 0 || !isPageReplayable(pageIndex))
+            return interpretPage(pageIndex, painter, nullptr);
+
+        // Paint and record in the same pass
+        return recordPage(pageIndex, painter) != nullptr;
+    }
+
+    std::shared_ptr<PdfDisplayList> PdfDocument::recordPage(int pageIndex, IPdfPainter& painter,
+        double minY, double maxY)
+    {
+        // The list keeps the fonts its glyph runs point to
+        PdfDisplayListRecorder recorder(painter);
+        recorder.setTargetRange(minY, maxY);
+        std::map<std::string, PdfFontInfo> fonts;
+        if (!interpretPage(pageIndex, recorder, &fonts))
+            return nullptr;
+
+        auto list = recorder.finish(std::move(fonts));
+        storeDisplayList(pageIndex, list);
+        return list;
+    }
+
+    bool PdfDocument::interpretPage(
+        int pageIndex,
+        IPdfPainter& painter,
+        std::map<std::string, PdfFontInfo>* keepFonts)
+    {
+        PDF_TRACE_SCOPE(Page, "interpretPage", "page %d", pageIndex);
+
         // 1) Page dictionary
         auto page = getPageDictionary(pageIndex);
         if (!page)
@@ -5020,17 +5362,22 @@ namespace pdf
         std::reverse(resStack.begin(), resStack.end());
 
         // 10) Parse content
-        PdfContentParser parser(
-            content,
-            &painter,
-            this,
-            pageIndex,
-            &fonts,
-            gs,
-            resStack
-        );
+        {
+            PdfContentParser parser(
+                content,
+                &painter,
+                this,
+                pageIndex,
+                &fonts,
+                gs,
+                resStack
+            );
 
-        parser.parse();
+            parser.parse();
+        }
+
+        if (keepFonts)
+            *keepFonts = std::move(fonts);
         return true;
     }
 
@@ -5046,25 +5393,25 @@ namespace pdf
         auto page = getPageDictionary(pageIndex);
         if (!page) return false;
 
-        std::set<int> v;
+        PdfVisitedRefs v;
 
-        auto resObj = resolveIndirect(dictGetAny(page, "/Resources", "Resources"), v);
-        auto res = std::dynamic_pointer_cast<PdfDictionary>(resObj);
+        auto resObj = resolveIndirect(dictGet(page, PdfKeys::Resources), v);
+        auto res = pdfCast<PdfDictionary>(resObj);
         if (!res) return false;
 
         v.clear();
-        auto xoObj = resolveIndirect(dictGetAny(res, "/XObject", "XObject"), v);
-        auto xo = std::dynamic_pointer_cast<PdfDictionary>(xoObj);
+        auto xoObj = resolveIndirect(dictGet(res, PdfKeys::XObject), v);
+        auto xo = pdfCast<PdfDictionary>(xoObj);
         if (!xo) return false;
 
         for (auto& kv : xo->entries)
         {
-            std::set<int> v2;
+            PdfVisitedRefs v2;
             auto stObj = resolveIndirect(kv.second, v2);
-            auto st = std::dynamic_pointer_cast<PdfStream>(stObj);
+            auto st = pdfCast<PdfStream>(stObj);
             if (!st) continue;
 
-            std::string key = kv.first;
+            std::string key = kv.first.str();
             if (!key.empty() && key[0] == '/') key = key.substr(1);
 
             out[key] = st;
@@ -5073,6 +5420,7 @@ namespace pdf
         return !out.empty();
     }
 
+#ifndef PDFCORE_HEADLESS
     // =====================================================
 // GPU RENDERING (PdfPainterGPU) - Direct2D Hardware Acceleration
 // =====================================================
@@ -5153,6 +5501,7 @@ namespace pdf
 
         return true;
     }
+#endif
 
     // IPdfPainter interface version (generic)
     bool PdfDocument::renderPageToPainter(
@@ -5236,7 +5585,7 @@ namespace pdf
 
     std::shared_ptr<PdfObject> PdfDocument::loadObjectAtOffset(size_t offset)
     {
-        PdfParser parser(_data);
+        PdfParser parser(_data, _dataOwner);
         return parser.parseObjectAt(offset);
     }
 
@@ -5496,9 +5845,165 @@ namespace pdf
             }
         }
 
-        // Keep old function as wrapper
-        static void aes128DecryptBlock(const uint8_t input[16], uint8_t output[16], const uint8_t roundKeys[176]) {
-            aesDecryptBlock(input, output, roundKeys, 10);
+
+        // =====================================================
+        // Fast AES-CBC decrypt (bulk stream data)
+        // Table-driven equivalent inverse cipher: InvSubBytes +
+        // InvMixColumns folded into four 1 KB tables, InvMixColumns
+        // pre-applied to the round keys. On x86/x64 CPUs with AES-NI
+        // the hardware path decrypts 4 independent blocks per step
+        // (CBC decryption has no chaining dependency).
+        // =====================================================
+        struct AesInvTables {
+            uint32_t Td[4][256];
+            AesInvTables() {
+                for (int x = 0; x < 256; x++) {
+                    uint8_t s = AES_INV_SBOX[x];
+                    uint32_t w = ((uint32_t)gmul(s, 0x0e) << 24) | ((uint32_t)gmul(s, 0x09) << 16) |
+                        ((uint32_t)gmul(s, 0x0d) << 8) | (uint32_t)gmul(s, 0x0b);
+                    Td[0][x] = w;
+                    Td[1][x] = (w >> 8) | (w << 24);
+                    Td[2][x] = (w >> 16) | (w << 16);
+                    Td[3][x] = (w >> 24) | (w << 8);
+                }
+            }
+        };
+
+        static const AesInvTables& aesInvTables() {
+            static const AesInvTables tables;
+            return tables;
+        }
+
+        static inline uint32_t loadBE32(const uint8_t* p) {
+            return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+        }
+
+        static inline void storeBE32(uint8_t* p, uint32_t v) {
+            p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16); p[2] = (uint8_t)(v >> 8); p[3] = (uint8_t)v;
+        }
+
+        // Encryption round keys (bytes) -> decryption schedule for the table path
+        static void aesInvKeySchedule(const uint8_t* roundKeys, int numRounds, uint32_t* dk) {
+            const auto& T = aesInvTables();
+            for (int r = 0; r <= numRounds; r++) {
+                for (int c = 0; c < 4; c++) {
+                    uint32_t w = loadBE32(roundKeys + (numRounds - r) * 16 + c * 4);
+                    if (r > 0 && r < numRounds) {
+                        // InvMixColumns(w) = Td[InvSbox^-1(b)] = Td[Sbox(b)]
+                        w = T.Td[0][AES_SBOX[w >> 24]] ^ T.Td[1][AES_SBOX[(w >> 16) & 0xff]] ^
+                            T.Td[2][AES_SBOX[(w >> 8) & 0xff]] ^ T.Td[3][AES_SBOX[w & 0xff]];
+                    }
+                    dk[r * 4 + c] = w;
+                }
+            }
+        }
+
+        static void aesDecryptBlockTable(const uint8_t in[16], uint8_t out[16],
+            const uint32_t* dk, int numRounds) {
+            const auto& T = aesInvTables();
+            uint32_t s0 = loadBE32(in) ^ dk[0];
+            uint32_t s1 = loadBE32(in + 4) ^ dk[1];
+            uint32_t s2 = loadBE32(in + 8) ^ dk[2];
+            uint32_t s3 = loadBE32(in + 12) ^ dk[3];
+
+            for (int r = 1; r < numRounds; r++) {
+                const uint32_t* k = dk + r * 4;
+                uint32_t t0 = T.Td[0][s0 >> 24] ^ T.Td[1][(s3 >> 16) & 0xff] ^ T.Td[2][(s2 >> 8) & 0xff] ^ T.Td[3][s1 & 0xff] ^ k[0];
+                uint32_t t1 = T.Td[0][s1 >> 24] ^ T.Td[1][(s0 >> 16) & 0xff] ^ T.Td[2][(s3 >> 8) & 0xff] ^ T.Td[3][s2 & 0xff] ^ k[1];
+                uint32_t t2 = T.Td[0][s2 >> 24] ^ T.Td[1][(s1 >> 16) & 0xff] ^ T.Td[2][(s0 >> 8) & 0xff] ^ T.Td[3][s3 & 0xff] ^ k[2];
+                uint32_t t3 = T.Td[0][s3 >> 24] ^ T.Td[1][(s2 >> 16) & 0xff] ^ T.Td[2][(s1 >> 8) & 0xff] ^ T.Td[3][s0 & 0xff] ^ k[3];
+                s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+            }
+
+            // Last round: InvShiftRows + InvSubBytes + AddRoundKey
+            const uint32_t* k = dk + numRounds * 4;
+            const uint8_t* is = AES_INV_SBOX;
+            storeBE32(out, ((uint32_t)is[s0 >> 24] << 24) ^ ((uint32_t)is[(s3 >> 16) & 0xff] << 16) ^
+                ((uint32_t)is[(s2 >> 8) & 0xff] << 8) ^ (uint32_t)is[s1 & 0xff] ^ k[0]);
+            storeBE32(out + 4, ((uint32_t)is[s1 >> 24] << 24) ^ ((uint32_t)is[(s0 >> 16) & 0xff] << 16) ^
+                ((uint32_t)is[(s3 >> 8) & 0xff] << 8) ^ (uint32_t)is[s2 & 0xff] ^ k[1]);
+            storeBE32(out + 8, ((uint32_t)is[s2 >> 24] << 24) ^ ((uint32_t)is[(s1 >> 16) & 0xff] << 16) ^
+                ((uint32_t)is[(s0 >> 8) & 0xff] << 8) ^ (uint32_t)is[s3 & 0xff] ^ k[2]);
+            storeBE32(out + 12, ((uint32_t)is[s3 >> 24] << 24) ^ ((uint32_t)is[(s2 >> 16) & 0xff] << 16) ^
+                ((uint32_t)is[(s1 >> 8) & 0xff] << 8) ^ (uint32_t)is[s0 & 0xff] ^ k[3]);
+        }
+
+#if PDF_AES_NI
+        static bool cpuHasAesNi() {
+#if defined(_MSC_VER)
+            int info[4] = { 0 };
+            __cpuid(info, 1);
+            return (info[2] & (1 << 25)) != 0;
+#else
+            return __builtin_cpu_supports("aes") != 0;
+#endif
+        }
+
+        PDF_AES_NI_TARGET
+        static void aesCbcDecryptNi(const uint8_t* roundKeys, int numRounds, const uint8_t* iv,
+            const uint8_t* in, size_t numBlocks, uint8_t* out) {
+            __m128i dk[15];
+            dk[0] = _mm_loadu_si128((const __m128i*)(roundKeys + numRounds * 16));
+            for (int r = 1; r < numRounds; r++)
+                dk[r] = _mm_aesimc_si128(_mm_loadu_si128((const __m128i*)(roundKeys + (numRounds - r) * 16)));
+            dk[numRounds] = _mm_loadu_si128((const __m128i*)roundKeys);
+
+            __m128i prev = _mm_loadu_si128((const __m128i*)iv);
+            size_t b = 0;
+            for (; b + 4 <= numBlocks; b += 4) {
+                const __m128i* src = (const __m128i*)(in + b * 16);
+                __m128i c0 = _mm_loadu_si128(src), c1 = _mm_loadu_si128(src + 1);
+                __m128i c2 = _mm_loadu_si128(src + 2), c3 = _mm_loadu_si128(src + 3);
+                __m128i x0 = _mm_xor_si128(c0, dk[0]), x1 = _mm_xor_si128(c1, dk[0]);
+                __m128i x2 = _mm_xor_si128(c2, dk[0]), x3 = _mm_xor_si128(c3, dk[0]);
+                for (int r = 1; r < numRounds; r++) {
+                    x0 = _mm_aesdec_si128(x0, dk[r]); x1 = _mm_aesdec_si128(x1, dk[r]);
+                    x2 = _mm_aesdec_si128(x2, dk[r]); x3 = _mm_aesdec_si128(x3, dk[r]);
+                }
+                x0 = _mm_aesdeclast_si128(x0, dk[numRounds]); x1 = _mm_aesdeclast_si128(x1, dk[numRounds]);
+                x2 = _mm_aesdeclast_si128(x2, dk[numRounds]); x3 = _mm_aesdeclast_si128(x3, dk[numRounds]);
+
+                __m128i* dst = (__m128i*)(out + b * 16);
+                _mm_storeu_si128(dst, _mm_xor_si128(x0, prev));
+                _mm_storeu_si128(dst + 1, _mm_xor_si128(x1, c0));
+                _mm_storeu_si128(dst + 2, _mm_xor_si128(x2, c1));
+                _mm_storeu_si128(dst + 3, _mm_xor_si128(x3, c2));
+                prev = c3;
+            }
+            for (; b < numBlocks; b++) {
+                __m128i c = _mm_loadu_si128((const __m128i*)(in + b * 16));
+                __m128i x = _mm_xor_si128(c, dk[0]);
+                for (int r = 1; r < numRounds; r++)
+                    x = _mm_aesdec_si128(x, dk[r]);
+                x = _mm_aesdeclast_si128(x, dk[numRounds]);
+                _mm_storeu_si128((__m128i*)(out + b * 16), _mm_xor_si128(x, prev));
+                prev = c;
+            }
+        }
+#endif
+
+        // CBC decrypt numBlocks blocks; roundKeys = encryption key schedule
+        static void aesCbcDecrypt(const uint8_t* roundKeys, int numRounds, const uint8_t* iv,
+            const uint8_t* in, size_t numBlocks, uint8_t* out) {
+#if PDF_AES_NI
+            static const bool hasAesNi = cpuHasAesNi();
+            if (hasAesNi) {
+                aesCbcDecryptNi(roundKeys, numRounds, iv, in, numBlocks, out);
+                return;
+            }
+#endif
+            uint32_t dk[60];
+            aesInvKeySchedule(roundKeys, numRounds, dk);
+
+            const uint8_t* prev = iv;
+            uint8_t block[16];
+            for (size_t b = 0; b < numBlocks; b++) {
+                const uint8_t* c = in + b * 16;
+                aesDecryptBlockTable(c, block, dk, numRounds);
+                for (int i = 0; i < 16; i++)
+                    out[b * 16 + i] = block[i] ^ prev[i];
+                prev = c;
+            }
         }
 
         // =====================================================
@@ -6348,16 +6853,7 @@ namespace pdf
             uint8_t roundKeys[240];
             aes256KeyExpansion(aesKey, roundKeys);
 
-            const uint8_t* prevBlock = iv;
-            for (size_t b = 0; b < numBlocks; b++)
-            {
-                const uint8_t* encBlock = ciphertext + b * 16;
-                uint8_t decBlock[16];
-                aesDecryptBlock(encBlock, decBlock, roundKeys, 14);
-                for (int i = 0; i < 16; i++)
-                    output[b * 16 + i] = decBlock[i] ^ prevBlock[i];
-                prevBlock = encBlock;
-            }
+            aesCbcDecrypt(roundKeys, 14, iv, ciphertext, numBlocks, output.data());
         }
         else
         {
@@ -6370,16 +6866,7 @@ namespace pdf
             uint8_t roundKeys[176];
             aes128KeyExpansion(aesKey, roundKeys);
 
-            const uint8_t* prevBlock = iv;
-            for (size_t b = 0; b < numBlocks; b++)
-            {
-                const uint8_t* encBlock = ciphertext + b * 16;
-                uint8_t decBlock[16];
-                aes128DecryptBlock(encBlock, decBlock, roundKeys);
-                for (int i = 0; i < 16; i++)
-                    output[b * 16 + i] = decBlock[i] ^ prevBlock[i];
-                prevBlock = encBlock;
-            }
+            aesCbcDecrypt(roundKeys, 10, iv, ciphertext, numBlocks, output.data());
         }
 
         // Remove PKCS#7 padding
@@ -6489,11 +6976,10 @@ namespace pdf
         // because the parser may not handle binary strings in /O and /U correctly.
 
         // Find the Encrypt dictionary object number
-        auto encryptRef = _trailer->get("/Encrypt");
-        if (!encryptRef) encryptRef = _trailer->get("Encrypt");
+        auto encryptRef = _trailer->get(PdfKeys::Encrypt);
         if (!encryptRef) return false;
 
-        auto ref = std::dynamic_pointer_cast<PdfIndirectRef>(encryptRef);
+        auto ref = pdfCast<PdfIndirectRef>(encryptRef);
         int encryptObjNum = -1;
         if (ref) encryptObjNum = ref->objNum;
 
@@ -6532,16 +7018,16 @@ namespace pdf
         size_t encLen = encObjEnd - encObjPos;
 
         // Parse /V, /R, /Length from the encrypt dict (use parsed objects for these)
-        std::set<int> visited;
+        PdfVisitedRefs visited;
         auto encryptObj = resolveIndirect(encryptRef, visited);
-        auto encryptDict = std::dynamic_pointer_cast<PdfDictionary>(encryptObj);
+        auto encryptDict = pdfCast<PdfDictionary>(encryptObj);
 
         if (encryptDict)
         {
             // ===== Check /Filter to determine encryption handler =====
             visited.clear();
-            auto filterObj = resolveIndirect(encryptDict->get("/Filter"), visited);
-            auto filterName = std::dynamic_pointer_cast<PdfName>(filterObj);
+            auto filterObj = resolveIndirect(encryptDict->get(PdfKeys::Filter), visited);
+            auto filterName = pdfCast<PdfName>(filterObj);
             std::string filter = filterName ? filterName->value : "/Standard";
 
             if (filter == "/Adobe.PubSec" || filter == "Adobe.PubSec")
@@ -6553,13 +7039,13 @@ namespace pdf
             }
 
             visited.clear();
-            auto vObj = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(encryptDict->get("/V"), visited));
+            auto vObj = pdfCast<PdfNumber>(resolveIndirect(encryptDict->get(PdfKeys::V), visited));
             visited.clear();
-            auto rObj = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(encryptDict->get("/R"), visited));
+            auto rObj = pdfCast<PdfNumber>(resolveIndirect(encryptDict->get(PdfKeys::R), visited));
             visited.clear();
-            auto lenObj = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(encryptDict->get("/Length"), visited));
+            auto lenObj = pdfCast<PdfNumber>(resolveIndirect(encryptDict->get(PdfKeys::Length), visited));
             visited.clear();
-            auto pObj = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(encryptDict->get("/P"), visited));
+            auto pObj = pdfCast<PdfNumber>(resolveIndirect(encryptDict->get(PdfKeys::P), visited));
 
             if (vObj) _encryptV = (int)vObj->value;
             if (rObj) _encryptR = (int)rObj->value;
@@ -6602,14 +7088,14 @@ namespace pdf
             _useAES = false; // default to RC4 unless CF says AESV2
 
             // Get /CF dictionary
-            std::set<int> vcf;
-            auto cfObj = resolveIndirect(encryptDict->get("/CF"), vcf);
-            auto cfDict = std::dynamic_pointer_cast<PdfDictionary>(cfObj);
+            PdfVisitedRefs vcf;
+            auto cfObj = resolveIndirect(encryptDict->get(PdfKeys::CF), vcf);
+            auto cfDict = pdfCast<PdfDictionary>(cfObj);
 
             // Get /StmF (stream filter name, usually /StdCF)
             vcf.clear();
-            auto stmfObj = resolveIndirect(encryptDict->get("/StmF"), vcf);
-            auto stmfName = std::dynamic_pointer_cast<PdfName>(stmfObj);
+            auto stmfObj = resolveIndirect(encryptDict->get(PdfKeys::StmF), vcf);
+            auto stmfName = pdfCast<PdfName>(stmfObj);
             std::string stmfFilter = stmfName ? stmfName->value : "/StdCF";
 
             LogDebug("PDF Encrypt: V=4, StmF=%s", stmfFilter.c_str());
@@ -6619,24 +7105,18 @@ namespace pdf
                 // Look up the crypt filter by name (e.g. /StdCF)
                 vcf.clear();
                 auto filterObj = resolveIndirect(cfDict->get(stmfFilter), vcf);
-                if (!filterObj) {
-                    // Try without leading /
-                    vcf.clear();
-                    std::string noSlash = stmfFilter.size() > 1 && stmfFilter[0] == '/' ? stmfFilter.substr(1) : stmfFilter;
-                    filterObj = resolveIndirect(cfDict->get(noSlash), vcf);
-                }
-                auto filterDict = std::dynamic_pointer_cast<PdfDictionary>(filterObj);
+                auto filterDict = pdfCast<PdfDictionary>(filterObj);
 
                 if (filterDict)
                 {
                     vcf.clear();
-                    auto cfmObj = resolveIndirect(filterDict->get("/CFM"), vcf);
-                    auto cfmName = std::dynamic_pointer_cast<PdfName>(cfmObj);
+                    auto cfmObj = resolveIndirect(filterDict->get(PdfKeys::CFM), vcf);
+                    auto cfmName = pdfCast<PdfName>(cfmObj);
                     std::string cfm = cfmName ? cfmName->value : "";
 
                     LogDebug("PDF Encrypt: CF filter CFM=%s", cfm.c_str());
 
-                    if (cfm == "/AESV2" || cfm == "AESV2")
+                    if (cfm == "/AESV2")
                     {
                         _useAES = true;
                         LogDebug("PDF Encrypt: Using AES-128-CBC encryption");
@@ -6729,10 +7209,10 @@ namespace pdf
             {
                 auto getStringBytesV5 = [&](const char* key) -> std::vector<uint8_t>
                     {
-                        std::set<int> v;
+                        PdfVisitedRefs v;
                         auto obj = resolveIndirect(encryptDict->get(key), v);
                         if (!obj) return {};
-                        auto str = std::dynamic_pointer_cast<PdfString>(obj);
+                        auto str = pdfCast<PdfString>(obj);
                         if (str) return std::vector<uint8_t>(str->value.begin(), str->value.end());
                         return {};
                     };
@@ -6785,10 +7265,10 @@ namespace pdf
             LogDebug("PDF Encrypt: Raw O/U parse failed (O=%zu, U=%zu), trying parsed dict", _encryptO.size(), _encryptU.size());
             auto getStringBytes = [&](const char* key) -> std::vector<uint8_t>
                 {
-                    std::set<int> v;
+                    PdfVisitedRefs v;
                     auto obj = resolveIndirect(encryptDict->get(key), v);
                     if (!obj) return {};
-                    auto str = std::dynamic_pointer_cast<PdfString>(obj);
+                    auto str = pdfCast<PdfString>(obj);
                     if (str) return std::vector<uint8_t>(str->value.begin(), str->value.end());
                     return {};
                 };
@@ -6849,12 +7329,11 @@ namespace pdf
         // Also check if /ID is in XRef stream trailer (not raw trailer)
         if (_fileId.empty() && _trailer)
         {
-            auto idObj = _trailer->get("/ID");
-            if (!idObj) idObj = _trailer->get("ID");
-            auto idArr = std::dynamic_pointer_cast<PdfArray>(idObj);
+            auto idObj = _trailer->get(PdfKeys::ID);
+            auto idArr = pdfCast<PdfArray>(idObj);
             if (idArr && !idArr->items.empty())
             {
-                auto firstId = std::dynamic_pointer_cast<PdfString>(idArr->items[0]);
+                auto firstId = pdfCast<PdfString>(idArr->items[0]);
                 if (firstId)
                 {
                     _fileId.assign(firstId->value.begin(), firstId->value.end());
@@ -7492,30 +7971,33 @@ namespace pdf
         return std::vector<uint8_t>(hash, hash + objKeyLen);
     }
 
-    // Decrypt a stream in-place
-    void PdfDocument::decryptStream(const std::shared_ptr<PdfStream>& stream) const
+    // Mark a freshly parsed stream as still encrypted. The ciphertext stays a
+    // slice of the document until decryptStream() runs on first use, so
+    // opening an encrypted file no longer decrypts every stream up front.
+    void PdfDocument::markStreamEncrypted(const std::shared_ptr<PdfObject>& obj, int objNum, int genNum) const
     {
-        if (!_encryptionReady || !stream || stream->data.empty()) return;
+        if (!_isEncrypted) return;
+        auto stream = pdfCast<PdfStream>(obj);
+        if (!stream || stream->encrypted) return;
 
-        // Find object number for this stream
-        int objNum = -1;
-        int genNum = 0;
-        for (const auto& kv : _objects)
-        {
-            if (kv.second.get() == stream.get())
-            {
-                objNum = kv.first;
-                break;
-            }
-        }
+        // XRef streams are never encrypted (PDF 32000-1, 7.5.8.2)
+        if (stream->dict && hasTypeName(stream->dict, "XRef")) return;
 
-        if (objNum < 0)
-        {
-            LogDebug("PDF Encrypt: Cannot find object number for stream, skipping");
-            return;
-        }
+        stream->encrypted = true;
+        stream->objNum = objNum;
+        stream->genNum = genNum;
+    }
 
-        auto objKey = computeObjectKey(objNum, genNum);
+    // Decrypt a pending stream in-place (once)
+    void PdfDocument::decryptStream(const std::shared_ptr<PdfStream>& stream) const
+    {
+        if (!_encryptionReady || !stream) return;
+        std::lock_guard<std::recursive_mutex> lock(_stateMutex);
+        if (!stream->encrypted) return;
+        stream->encrypted = false;
+        if (stream->data.empty()) return;
+
+        auto objKey = computeObjectKey(stream->objNum, stream->genNum);
 
         if (_useAES)
         {
@@ -7526,7 +8008,7 @@ namespace pdf
             }
             else
             {
-                LogDebug("PDF Encrypt: AES decrypt failed for obj %d (%zu bytes)", objNum, stream->data.size());
+                LogDebug("PDF Encrypt: AES decrypt failed for obj %d (%zu bytes)", stream->objNum, stream->data.size());
             }
         }
         else
@@ -7541,7 +8023,7 @@ namespace pdf
     void PdfDocument::decryptString(std::shared_ptr<PdfObject>& obj, int objNum, int genNum) const
     {
         if (!_encryptionReady) return;
-        auto str = std::dynamic_pointer_cast<PdfString>(obj);
+        auto str = pdfCast<PdfString>(obj);
         if (!str || str->value.empty()) return;
 
         auto objKey = computeObjectKey(objNum, genNum);
@@ -7569,12 +8051,12 @@ namespace pdf
     bool PdfDocument::initCertEncryption(const std::shared_ptr<PdfDictionary>& encryptDict,
         const uint8_t* encData, size_t encLen)
     {
-        std::set<int> visited;
+        PdfVisitedRefs visited;
 
         // Parse /SubFilter
         visited.clear();
-        auto subFilterObj = resolveIndirect(encryptDict->get("/SubFilter"), visited);
-        auto subFilterName = std::dynamic_pointer_cast<PdfName>(subFilterObj);
+        auto subFilterObj = resolveIndirect(encryptDict->get(PdfKeys::SubFilter), visited);
+        auto subFilterName = pdfCast<PdfName>(subFilterObj);
         _certSubFilter = subFilterName ? subFilterName->value : "";
         if (!_certSubFilter.empty() && _certSubFilter[0] == '/')
             _certSubFilter = _certSubFilter.substr(1);
@@ -7583,13 +8065,13 @@ namespace pdf
 
         // Parse /V, /R, /Length, /P
         visited.clear();
-        auto vObj = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(encryptDict->get("/V"), visited));
+        auto vObj = pdfCast<PdfNumber>(resolveIndirect(encryptDict->get(PdfKeys::V), visited));
         visited.clear();
-        auto rObj = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(encryptDict->get("/R"), visited));
+        auto rObj = pdfCast<PdfNumber>(resolveIndirect(encryptDict->get(PdfKeys::R), visited));
         visited.clear();
-        auto lenObj = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(encryptDict->get("/Length"), visited));
+        auto lenObj = pdfCast<PdfNumber>(resolveIndirect(encryptDict->get(PdfKeys::Length), visited));
         visited.clear();
-        auto pObj = std::dynamic_pointer_cast<PdfNumber>(resolveIndirect(encryptDict->get("/P"), visited));
+        auto pObj = pdfCast<PdfNumber>(resolveIndirect(encryptDict->get(PdfKeys::P), visited));
 
         if (vObj) _encryptV = (int)vObj->value;
         if (rObj) _encryptR = (int)rObj->value;
@@ -7612,13 +8094,13 @@ namespace pdf
 
         // Parse /EncryptMetadata
         visited.clear();
-        auto emObj = resolveIndirect(encryptDict->get("/EncryptMetadata"), visited);
+        auto emObj = resolveIndirect(encryptDict->get(PdfKeys::EncryptMetadata), visited);
         if (emObj) {
-            auto emBool = std::dynamic_pointer_cast<PdfBoolean>(emObj);
+            auto emBool = pdfCast<PdfBoolean>(emObj);
             if (emBool) _encryptMetadata = emBool->value;
             if (!emBool) {
-                auto emName = std::dynamic_pointer_cast<PdfName>(emObj);
-                if (emName && (emName->value == "false" || emName->value == "/false"))
+                auto emName = pdfCast<PdfName>(emObj);
+                if (emName && (emName->value == "/false"))
                     _encryptMetadata = false;
             }
         }
@@ -7663,23 +8145,23 @@ namespace pdf
         {
             // Parse CF → crypt filter → Recipients
             visited.clear();
-            auto cfObj = resolveIndirect(encryptDict->get("/CF"), visited);
-            auto cfDict = std::dynamic_pointer_cast<PdfDictionary>(cfObj);
+            auto cfObj = resolveIndirect(encryptDict->get(PdfKeys::CF), visited);
+            auto cfDict = pdfCast<PdfDictionary>(cfObj);
             if (cfDict) {
                 // Try DefaultCryptFilter, StdCF, etc.
                 for (const auto& cfName : { "/DefaultCryptFilter", "/StdCF" }) {
                     visited.clear();
                     auto filterObj = resolveIndirect(cfDict->get(cfName), visited);
-                    auto filterDict = std::dynamic_pointer_cast<PdfDictionary>(filterObj);
+                    auto filterDict = pdfCast<PdfDictionary>(filterObj);
                     if (!filterDict) continue;
 
                     // Check /CFM for AES mode
                     visited.clear();
-                    auto cfmObj = resolveIndirect(filterDict->get("/CFM"), visited);
-                    auto cfmName = std::dynamic_pointer_cast<PdfName>(cfmObj);
+                    auto cfmObj = resolveIndirect(filterDict->get(PdfKeys::CFM), visited);
+                    auto cfmName = pdfCast<PdfName>(cfmObj);
                     if (cfmName) {
-                        if (cfmName->value == "/AESV2" || cfmName->value == "AESV2") { _useAES = true; _encryptKeyLength = 16; }
-                        else if (cfmName->value == "/AESV3" || cfmName->value == "AESV3") { _useAES = true; _encryptKeyLength = 32; }
+                        if (cfmName->value == "/AESV2") { _useAES = true; _encryptKeyLength = 16; }
+                        else if (cfmName->value == "/AESV3") { _useAES = true; _encryptKeyLength = 32; }
                     }
 
                     // Parse /Recipients from raw bytes (binary data, need raw parse)
@@ -7857,37 +8339,31 @@ namespace pdf
         }
         _encryptionReady = true;
 
-        // Decrypt all streams with the new key
-        for (auto& kv : _objects) {
-            auto stream = std::dynamic_pointer_cast<PdfStream>(kv.second);
-            if (stream && !stream->data.empty()) {
-                auto itX = _xrefTable.find(kv.first);
-                if (itX != _xrefTable.end()) {
-                    auto reloaded = loadObjectAtOffset(itX->second);
-                    auto reloadedStream = std::dynamic_pointer_cast<PdfStream>(reloaded);
-                    if (reloadedStream && !reloadedStream->data.empty()) {
-                        int objNum = kv.first;
-                        int genNum = 0;
-                        auto objKey = computeObjectKey(objNum, genNum);
-                        if (_useAES) {
-                            std::vector<uint8_t> decrypted;
-                            if (aesDecryptCBC(objKey, reloadedStream->data.data(),
-                                reloadedStream->data.size(), decrypted))
-                                stream->data = std::move(decrypted);
-                        }
-                        else {
-                            std::vector<uint8_t> decrypted;
-                            rc4Crypt(objKey, reloadedStream->data.data(),
-                                reloadedStream->data.size(), decrypted);
-                            stream->data = std::move(decrypted);
-                        }
-                        if (reloadedStream->dict && !stream->dict)
-                            stream->dict = reloadedStream->dict;
-                    }
-                }
+        // Streams decrypt lazily with the new key. Re-slice the raw bytes in
+        // case a stream was decrypted with an earlier key.
+        for (const auto& kv : _objects) {
+            auto stream = pdfCast<PdfStream>(kv.second);
+            if (!stream) continue;
+            const size_t* offset = _xrefTable.find(kv.first);
+            if (stream->encrypted || !offset) {
+                markStreamEncrypted(stream, kv.first, 0);
+                continue;
+            }
+            auto reloadedStream = pdfCast<PdfStream>(loadObjectAtOffset(*offset));
+            if (reloadedStream) {
+                stream->data = reloadedStream->data;
+                if (reloadedStream->dict && !stream->dict)
+                    stream->dict = reloadedStream->dict;
+                markStreamEncrypted(stream, kv.first, 0);
             }
         }
 
+        // Anahtar yokken ObjStm içinden yüklenmiş objeler çöp olabilir; tekrar lazy yüklensin
+        for (const auto& kv : _objStmEntries)
+            _objects.erase(kv.first);
+        clearObjStmCache();
+        loadRootAndPages();
+
         return true;
     }
 
@@ -7961,48 +8437,34 @@ namespace pdf
         LogDebug("PDF Encrypt: Password accepted, decrypting streams...");
         _encryptionReady = true;
 
-        // Re-decrypt all streams with the new key
-        for (auto& kv : _objects)
+        // Streams decrypt lazily with the new key. Re-slice the raw bytes in
+        // case a stream was decrypted with an earlier key.
+        for (const auto& kv : _objects)
         {
-            auto stream = std::dynamic_pointer_cast<PdfStream>(kv.second);
-            if (stream && !stream->data.empty())
+            auto stream = pdfCast<PdfStream>(kv.second);
+            if (!stream) continue;
+            const size_t* offset = _xrefTable.find(kv.first);
+            if (stream->encrypted || !offset)
             {
-                // We need to re-parse from raw data since existing stream data
-                // may have been corrupted by previous failed decrypt attempt.
-                // Reload from file offset
-                auto itX = _xrefTable.find(kv.first);
-                if (itX != _xrefTable.end())
-                {
-                    auto reloaded = loadObjectAtOffset(itX->second);
-                    auto reloadedStream = std::dynamic_pointer_cast<PdfStream>(reloaded);
-                    if (reloadedStream && !reloadedStream->data.empty())
-                    {
-                        // Now decrypt the fresh copy
-                        int objNum = kv.first;
-                        int genNum = 0;
-                        auto objKey = computeObjectKey(objNum, genNum);
-
-                        if (_useAES)
-                        {
-                            std::vector<uint8_t> decrypted;
-                            if (aesDecryptCBC(objKey, reloadedStream->data.data(), reloadedStream->data.size(), decrypted))
-                                stream->data = std::move(decrypted);
-                        }
-                        else
-                        {
-                            std::vector<uint8_t> decrypted;
-                            rc4Crypt(objKey, reloadedStream->data.data(), reloadedStream->data.size(), decrypted);
-                            stream->data = std::move(decrypted);
-                        }
-
-                        // Keep the dictionary from original parsed object
-                        if (reloadedStream->dict && !stream->dict)
-                            stream->dict = reloadedStream->dict;
-                    }
-                }
+                markStreamEncrypted(stream, kv.first, 0);
+                continue;
+            }
+            auto reloadedStream = pdfCast<PdfStream>(loadObjectAtOffset(*offset));
+            if (reloadedStream)
+            {
+                stream->data = reloadedStream->data;
+                if (reloadedStream->dict && !stream->dict)
+                    stream->dict = reloadedStream->dict;
+                markStreamEncrypted(stream, kv.first, 0);
             }
         }
 
+        // Anahtar yokken ObjStm içinden yüklenmiş objeler çöp olabilir; tekrar lazy yüklensin
+        for (const auto& kv : _objStmEntries)
+            _objects.erase(kv.first);
+        clearObjStmCache();
+        loadRootAndPages();
+
         return true;
     }
 
@@ -8016,38 +8478,14 @@ namespace pdf
     {
         if (!destArr || destArr->items.empty()) return -1;
 
-        std::set<int> visited;
+        PdfVisitedRefs visited;
 
         // İlk eleman sayfa referansı
         visited.clear();
         auto pageRef = resolveIndirect(destArr->items[0], visited);
-        auto pageRefDict = std::dynamic_pointer_cast<PdfDictionary>(pageRef);
+        auto pageRefDict = pdfCast<PdfDictionary>(pageRef);
         if (pageRefDict)
-        {
-            for (int pi = 0; pi < getPageCountFromPageTree(); pi++)
-            {
-                if (getPageDictionary(pi).get() == pageRefDict.get())
-                    return pi;
-            }
-        }
-
-        // Indirect reference olarak dene
-        auto indRef = std::dynamic_pointer_cast<PdfIndirectRef>(destArr->items[0]);
-        if (indRef)
-        {
-            for (int pi = 0; pi < getPageCountFromPageTree(); pi++)
-            {
-                auto pd = getPageDictionary(pi);
-                auto objIt = _objects.find(indRef->objNum);
-                if (objIt != _objects.end())
-                {
-                    visited.clear();
-                    auto resolvedPage = resolveIndirect(objIt->second, visited);
-                    if (resolvedPage.get() == pd.get())
-                        return pi;
-                }
-            }
-        }
+            return getPageIndexOf(pageRefDict);
 
         return -1;
     }
@@ -8058,18 +8496,18 @@ namespace pdf
     {
         if (!_root || name.empty()) return nullptr;
 
-        std::set<int> visited;
+        PdfVisitedRefs visited;
 
         // Catalog -> /Names
         visited.clear();
-        auto namesObj = resolveIndirect(dictGetAny(_root, "/Names", "Names"), visited);
-        auto namesDict = std::dynamic_pointer_cast<PdfDictionary>(namesObj);
+        auto namesObj = resolveIndirect(dictGet(_root, PdfKeys::Names), visited);
+        auto namesDict = pdfCast<PdfDictionary>(namesObj);
         if (!namesDict) return nullptr;
 
         // /Names -> /Dests
         visited.clear();
-        auto destsObj = resolveIndirect(dictGetAny(namesDict, "/Dests", "Dests"), visited);
-        auto destsDict = std::dynamic_pointer_cast<PdfDictionary>(destsObj);
+        auto destsObj = resolveIndirect(dictGet(namesDict, PdfKeys::Dests), visited);
+        auto destsDict = pdfCast<PdfDictionary>(destsObj);
         if (!destsDict) return nullptr;
 
         // Recursive name tree search (flat /Names array veya /Kids hiyerarşisi)
@@ -8080,44 +8518,44 @@ namespace pdf
             if (!node) return nullptr;
 
             // Leaf node: /Names array [(key1) value1 (key2) value2 ...]
-            std::set<int> v;
-            auto namesArrObj = resolveIndirect(dictGetAny(node, "/Names", "Names"), v);
-            auto namesArr = std::dynamic_pointer_cast<PdfArray>(namesArrObj);
+            PdfVisitedRefs v;
+            auto namesArrObj = resolveIndirect(dictGet(node, PdfKeys::Names), v);
+            auto namesArr = pdfCast<PdfArray>(namesArrObj);
             if (namesArr)
             {
                 for (size_t i = 0; i + 1 < namesArr->items.size(); i += 2)
                 {
-                    auto keyStr = std::dynamic_pointer_cast<PdfString>(namesArr->items[i]);
+                    auto keyStr = pdfCast<PdfString>(namesArr->items[i]);
                     if (keyStr && keyStr->value == name)
                     {
                         v.clear();
                         auto val = resolveIndirect(namesArr->items[i + 1], v);
-                        return std::dynamic_pointer_cast<PdfArray>(val);
+                        return pdfCast<PdfArray>(val);
                     }
                 }
             }
 
             // Intermediate node: /Kids array [childRef1, childRef2, ...]
             v.clear();
-            auto kidsObj = resolveIndirect(dictGetAny(node, "/Kids", "Kids"), v);
-            auto kidsArr = std::dynamic_pointer_cast<PdfArray>(kidsObj);
+            auto kidsObj = resolveIndirect(dictGet(node, PdfKeys::Kids), v);
+            auto kidsArr = pdfCast<PdfArray>(kidsObj);
             if (kidsArr)
             {
                 for (const auto& kidRef : kidsArr->items)
                 {
                     v.clear();
                     auto kidObj = resolveIndirect(kidRef, v);
-                    auto kidDict = std::dynamic_pointer_cast<PdfDictionary>(kidObj);
+                    auto kidDict = pdfCast<PdfDictionary>(kidObj);
                     if (kidDict)
                     {
                         // /Limits kontrolü: [minKey, maxKey] - aralık dışındaysa atla
                         v.clear();
-                        auto limitsObj = resolveIndirect(dictGetAny(kidDict, "/Limits", "Limits"), v);
-                        auto limitsArr = std::dynamic_pointer_cast<PdfArray>(limitsObj);
+                        auto limitsObj = resolveIndirect(dictGet(kidDict, PdfKeys::Limits), v);
+                        auto limitsArr = pdfCast<PdfArray>(limitsObj);
                         if (limitsArr && limitsArr->items.size() >= 2)
                         {
-                            auto minStr = std::dynamic_pointer_cast<PdfString>(limitsArr->items[0]);
-                            auto maxStr = std::dynamic_pointer_cast<PdfString>(limitsArr->items[1]);
+                            auto minStr = pdfCast<PdfString>(limitsArr->items[0]);
+                            auto maxStr = pdfCast<PdfString>(limitsArr->items[1]);
                             if (minStr && maxStr)
                             {
                                 if (name < minStr->value || name > maxStr->value)
@@ -8149,9 +8587,9 @@ namespace pdf
         if (!pageDict) return false;
 
         // Get /Annots array from page
-        std::set<int> visited;
-        auto annotsObj = resolveIndirect(dictGetAny(pageDict, "/Annots", "Annots"), visited);
-        auto annotsArr = std::dynamic_pointer_cast<PdfArray>(annotsObj);
+        PdfVisitedRefs visited;
+        auto annotsObj = resolveIndirect(dictGet(pageDict, PdfKeys::Annots), visited);
+        auto annotsArr = pdfCast<PdfArray>(annotsObj);
         if (!annotsArr) return true; // No annotations - not an error
 
         for (size_t ai = 0; ai < annotsArr->items.size(); ai++)
@@ -8159,28 +8597,26 @@ namespace pdf
             const auto& annotRef = annotsArr->items[ai];
             visited.clear();
             auto annotObj = resolveIndirect(annotRef, visited);
-            auto annotDict = std::dynamic_pointer_cast<PdfDictionary>(annotObj);
+            auto annotDict = pdfCast<PdfDictionary>(annotObj);
             if (!annotDict) continue;
 
             // Check if this is a Link annotation
             visited.clear();
-            auto subtypeObj = resolveIndirect(dictGetAny(annotDict, "/Subtype", "Subtype"), visited);
-            auto subtypeName = std::dynamic_pointer_cast<PdfName>(subtypeObj);
+            auto subtypeObj = resolveIndirect(dictGet(annotDict, PdfKeys::Subtype), visited);
+            auto subtypeName = pdfCast<PdfName>(subtypeObj);
             if (!subtypeName) continue;
 
-            std::string subtype = subtypeName->value;
-            if (!subtype.empty() && subtype[0] == '/') subtype = subtype.substr(1);
-            if (subtype != "Link") continue;
+            if (subtypeName->value != "/Link") continue;
 
             // Get the Rect (bounding box)
             visited.clear();
-            auto rectObj = resolveIndirect(dictGetAny(annotDict, "/Rect", "Rect"), visited);
-            auto rectArr = std::dynamic_pointer_cast<PdfArray>(rectObj);
+            auto rectObj = resolveIndirect(dictGet(annotDict, PdfKeys::Rect), visited);
+            auto rectArr = pdfCast<PdfArray>(rectObj);
             if (!rectArr || rectArr->items.size() < 4) continue;
 
             PdfLinkInfo link;
             auto getNumber = [](const PdfObjectPtr& obj) -> double {
-                if (auto num = std::dynamic_pointer_cast<PdfNumber>(obj))
+                if (auto num = pdfCast<PdfNumber>(obj))
                     return num->value;
                 return 0.0;
             };
@@ -8196,41 +8632,37 @@ namespace pdf
 
             // Check for /A (action) dictionary
             visited.clear();
-            auto actionObj = resolveIndirect(dictGetAny(annotDict, "/A", "A"), visited);
-            auto actionDict = std::dynamic_pointer_cast<PdfDictionary>(actionObj);
+            auto actionObj = resolveIndirect(dictGet(annotDict, PdfKeys::A), visited);
+            auto actionDict = pdfCast<PdfDictionary>(actionObj);
 
             if (actionDict)
             {
                 // Get action type /S
                 visited.clear();
-                auto sObj = resolveIndirect(dictGetAny(actionDict, "/S", "S"), visited);
-                auto sName = std::dynamic_pointer_cast<PdfName>(sObj);
-                std::string actionType;
-                if (sName) {
-                    actionType = sName->value;
-                    if (!actionType.empty() && actionType[0] == '/') actionType = actionType.substr(1);
-                }
+                auto sObj = resolveIndirect(dictGet(actionDict, PdfKeys::S), visited);
+                auto sName = pdfCast<PdfName>(sObj);
+                std::string actionType = sName ? sName->value : "";
 
-                if (actionType == "URI")
+                if (actionType == "/URI")
                 {
                     // External URI link
                     visited.clear();
-                    auto uriObj = resolveIndirect(dictGetAny(actionDict, "/URI", "URI"), visited);
-                    if (auto uriStr = std::dynamic_pointer_cast<PdfString>(uriObj))
+                    auto uriObj = resolveIndirect(dictGet(actionDict, PdfKeys::URI), visited);
+                    if (auto uriStr = pdfCast<PdfString>(uriObj))
                     {
                         link.uri = uriStr->value;
                         link.destPage = -1;
                         outLinks.push_back(link);
                     }
                 }
-                else if (actionType == "GoTo")
+                else if (actionType == "/GoTo")
                 {
                     // Internal page link
                     visited.clear();
-                    auto destObj = resolveIndirect(dictGetAny(actionDict, "/D", "D"), visited);
+                    auto destObj = resolveIndirect(dictGet(actionDict, PdfKeys::D), visited);
 
                     // Case 1: Direct array destination [pageRef, /XYZ, ...]
-                    auto destArr = std::dynamic_pointer_cast<PdfArray>(destObj);
+                    auto destArr = pdfCast<PdfArray>(destObj);
                     if (destArr && !destArr->items.empty())
                     {
                         link.destPage = resolvePageFromDestArray(destArr);
@@ -8241,7 +8673,7 @@ namespace pdf
                     // Case 2: Named destination (string) - Names tree'den çöz
                     if (link.destPage < 0)
                     {
-                        auto destStr = std::dynamic_pointer_cast<PdfString>(destObj);
+                        auto destStr = pdfCast<PdfString>(destObj);
                         if (destStr && !destStr->value.empty())
                         {
                             auto resolvedArr = resolveNamedDestination(destStr->value);
@@ -8260,10 +8692,10 @@ namespace pdf
             if (link.uri.empty() && link.destPage < 0)
             {
                 visited.clear();
-                auto destObj = resolveIndirect(dictGetAny(annotDict, "/Dest", "Dest"), visited);
+                auto destObj = resolveIndirect(dictGet(annotDict, PdfKeys::Dest), visited);
 
                 // Array destination [pageRef, /XYZ, ...]
-                auto destArr = std::dynamic_pointer_cast<PdfArray>(destObj);
+                auto destArr = pdfCast<PdfArray>(destObj);
                 if (destArr && !destArr->items.empty())
                 {
                     link.destPage = resolvePageFromDestArray(destArr);
@@ -8274,7 +8706,7 @@ namespace pdf
                 // Named destination (string)
                 if (link.destPage < 0)
                 {
-                    auto destStr = std::dynamic_pointer_cast<PdfString>(destObj);
+                    auto destStr = pdfCast<PdfString>(destObj);
                     if (destStr && !destStr->value.empty())
                     {
                         auto resolvedArr = resolveNamedDestination(destStr->value);
@@ -1,13 +1,18 @@
 #pragma once
 
 #include <cstdint>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "PdfLruCache.h"
 #include "PdfObject.h"
+#include "PdfObjTable.h"
 #include "PdfParser.h"
 #include "PdfGraphicsState.h"
 #include <ft2build.h>
@@ -18,6 +23,9 @@ namespace pdf
     class IPdfPainter;
     class PdfPainter;
     class PdfPainterGPU;
+    class PdfDisplayList;
+    struct PdfCompiledForm;
+    struct CachedFont;
 
     // Link annotation info
     struct PdfLinkInfo
@@ -61,6 +69,7 @@ namespace pdf
         std::string fontProgramSubtype;
 
         FT_Face ftFace = nullptr;
+        std::shared_ptr<CachedFont> ftFont;     // owns ftFace (FontCache)
         bool ftReady = false;
         size_t fontHash = 0;
 
@@ -169,6 +178,9 @@ namespace pdf
 
     // =======================================================================
     // PdfDocument
+    // Rendering (renderPageToPainter and what it calls) may run on several
+    // threads at once; lazily built state is guarded by _stateMutex.
+    // Loading, decryption setup and budget changes must not overlap renders.
     // =======================================================================
     class PdfDocument
     {
@@ -177,12 +189,16 @@ namespace pdf
         ~PdfDocument();
 
         bool loadFromBytes(const std::vector<uint8_t>& data);
-        const std::map<int, PdfObjectPtr>& getObjects() const { return _objects; }
+        bool loadFromBytes(std::vector<uint8_t>&& data);
+        // Shared storage (e.g. platform::mapFile). Not copied: stream
+        // bodies are slices of it and keep it alive after the document closes.
+        bool loadFromMemory(std::shared_ptr<const uint8_t> data, size_t size);
+        const PdfObjTable<PdfObjectPtr>& getObjects() const { return _objects; }
         std::shared_ptr<PdfDictionary> getPagesNode() const { return _pages; }
 
         std::shared_ptr<PdfObject> resolve(
             const std::shared_ptr<PdfObject>& obj,
-            std::set<int>& visited
+            PdfVisitedRefs& visited
         ) const {
             return resolveIndirect(obj, visited);
         }
@@ -195,6 +211,8 @@ namespace pdf
         bool loadFallbackFont(PdfFontInfo& fi);
         int getPageCountFromPageTree() const;
         std::shared_ptr<PdfDictionary> getPageDictionary(int pageIndex) const;
+        // 0-based index of a page dictionary, -1 if it is not a page of this document
+        int getPageIndexOf(const std::shared_ptr<PdfDictionary>& pageDict) const;
 
         int getPageRotate(std::shared_ptr<PdfDictionary> pageDict) const;
         bool getPageSize(int pageIndex, double& wPt, double& hPt) const;
@@ -207,6 +225,41 @@ namespace pdf
         bool renderPageToPainter(int pageIndex, PdfPainter& painter);
         bool renderPageToPainter(int pageIndex, PdfPainterGPU& painter);
 
+        // CPU renders record each page's painter calls once and replay them
+        // on later renders (e.g. at a new zoom). 0 disables recording.
+        void setDisplayListBudget(size_t bytes);
+        size_t displayListBytes() const { return _displayLists.bytes(); }
+        void clearDisplayLists();
+        std::shared_ptr<PdfDisplayList> findDisplayList(int pageIndex);
+        // False once a recording of the page used something replay cannot
+        // reproduce (soft masks); such pages are always interpreted whole.
+        bool isPageReplayable(int pageIndex) const;
+
+        // Interprets the page into painter and returns what it recorded,
+        // also when the budget keeps the list out of the cache. Band
+        // painters pass their page-space y range; paths outside it are
+        // recorded without being drawn.
+        std::shared_ptr<PdfDisplayList> recordPage(int pageIndex, IPdfPainter& painter,
+            double minY = -1e30, double maxY = 1e30);
+
+        // Form XObjects compiled by the content parser, keyed by object
+        // number and shared by all pages. Hits/misses count lookups.
+        std::shared_ptr<PdfCompiledForm> findCompiledForm(int objNum);
+        void storeCompiledForm(int objNum, std::shared_ptr<PdfCompiledForm> form);
+        void getFormCacheStats(size_t& hits, size_t& misses, size_t& entries, size_t& bytes) const;
+        void clearFormCache();
+
+        // Decoded image XObjects (ARGB), keyed by object number and shared
+        // by every painter and page. Returns the cached buffer or decodes
+        // and stores it; images larger than the budget are not kept.
+        bool getDecodedImage(
+            int objNum,
+            const std::shared_ptr<PdfStream>& st,
+            std::shared_ptr<const std::vector<uint8_t>>& argb, int& w, int& h);
+        void setImageCacheBudget(size_t bytes);
+        void getImageCacheStats(size_t& hits, size_t& misses, size_t& entries, size_t& bytes) const;
+        void clearImageCache();
+
         bool getPageContentsBytes(int pageIndex, std::vector<uint8_t>& out) const;
 
         bool getPageXObjects(
@@ -261,16 +314,70 @@ namespace pdf
 
 
     private:
-        std::vector<uint8_t> _data;
-        std::map<int, PdfObjectPtr> _objects;
+        // Object table, ObjStm/display list/Form/image caches, page index
+        // and in-place stream decryption. Recursive: object loading nests.
+        mutable std::recursive_mutex _stateMutex;
 
-        std::map<int, size_t> _xrefTable;
+        PdfByteView _data;
+        std::shared_ptr<const uint8_t> _dataOwner;
+        PdfObjTable<PdfObjectPtr> _objects;
+
+        PdfObjTable<size_t> _xrefTable;
 
         // Object Stream (ObjStm) desteği — XRef type 2 girdileri
         struct ObjStmEntry { int objStmNum; int indexInStream; };
-        std::map<int, ObjStmEntry> _objStmEntries;
+        PdfObjTable<ObjStmEntry> _objStmEntries;
         std::shared_ptr<PdfObject> loadFromObjStm(int objNum, int objStmNum, int indexInStream);
 
+        // Decoded ObjStm buffers, LRU-bounded by OBJSTM_CACHE_BUDGET bytes
+        struct DecodedObjStm
+        {
+            std::vector<uint8_t> data;
+            int first = 0;
+            std::vector<std::pair<int, int>> entries; // (objNum, offset relative to /First)
+        };
+        static constexpr size_t OBJSTM_CACHE_BUDGET = 16 * 1024 * 1024;
+        static constexpr size_t OBJSTM_CACHE_MAX = 64;
+        PdfLruCache<int, std::shared_ptr<DecodedObjStm>> _objStmCache;
+        std::shared_ptr<DecodedObjStm> getDecodedObjStm(int objStmNum);
+        void clearObjStmCache();
+
+        // Recorded page display lists, LRU-bounded by _displayListBudget bytes
+        static constexpr size_t DISPLAY_LIST_BUDGET = 64 * 1024 * 1024;
+        size_t _displayListBudget = DISPLAY_LIST_BUDGET;
+        PdfLruCache<int, std::shared_ptr<PdfDisplayList>> _displayLists;
+        std::set<int> _nonReplayablePages;
+        void storeDisplayList(int pageIndex, std::shared_ptr<PdfDisplayList> list);
+
+        // Parses the page content into painter; fonts move to keepFonts if given
+        bool interpretPage(int pageIndex, IPdfPainter& painter,
+            std::map<std::string, PdfFontInfo>* keepFonts);
+
+        // Compiled Form XObjects, LRU-bounded by FORM_CACHE_BUDGET bytes
+        static constexpr size_t FORM_CACHE_BUDGET = 32 * 1024 * 1024;
+        PdfLruCache<int, std::shared_ptr<PdfCompiledForm>> _formCache;
+        size_t _formCacheHits = 0;
+        size_t _formCacheMisses = 0;
+
+        // Decoded images, LRU-bounded by _imageCacheBudget bytes
+        struct DecodedImage
+        {
+            std::shared_ptr<const std::vector<uint8_t>> argb;
+            int w = 0, h = 0;
+        };
+        static constexpr size_t IMAGE_CACHE_BUDGET = 128 * 1024 * 1024;
+        size_t _imageCacheBudget = IMAGE_CACHE_BUDGET;
+        PdfLruCache<int, DecodedImage> _imageCache;
+        size_t _imageCacheHits = 0;
+        size_t _imageCacheMisses = 0;
+
+        // Lazy loading: objects are materialized from the xref on first use.
+        // The linear scan (PdfParser::parse) is only a repair fallback for a
+        // missing/damaged xref and runs at most once per document.
+        bool _repairScanned = false;
+        std::shared_ptr<PdfObject> loadIndirectObject(int objNum, int genNum) const;
+        void repairScan() const;
+
         std::shared_ptr<PdfDictionary> _trailer;
         std::shared_ptr<PdfDictionary> _root;
         std::shared_ptr<PdfDictionary> _pages;
@@ -315,6 +422,7 @@ namespace pdf
             const uint8_t* input, size_t inputLen,
             std::vector<uint8_t>& output);
         void decryptStream(const std::shared_ptr<PdfStream>& stream) const;
+        void markStreamEncrypted(const std::shared_ptr<PdfObject>& obj, int objNum, int genNum) const;
         void decryptString(std::shared_ptr<PdfObject>& obj, int objNum, int genNum) const;
         std::vector<uint8_t> parsePdfLiteralString(const uint8_t* data, size_t len,
             size_t startAfterParen, size_t& endPos) const;
@@ -330,19 +438,47 @@ namespace pdf
         // ---- General internal methods ----
         std::shared_ptr<PdfObject> resolveIndirect(
             const std::shared_ptr<PdfObject>& obj,
-            std::set<int>& visitedIds) const;
+            PdfVisitedRefs& visitedIds) const;
 
         bool isPageObject(const std::shared_ptr<PdfDictionary>& dict) const;
         bool loadXRefTable();
         bool loadTrailer();
         bool loadRootAndPages();
-        bool parseXRefTableAt(size_t offset, std::map<int, size_t>& xrefEntries);
-        bool parseXRefStreamAt(size_t offset, std::map<int, size_t>& xrefEntries);
+        bool parseXRefTableAt(size_t offset, PdfObjTable<size_t>& xrefEntries);
+        bool parseXRefStreamAt(size_t offset, PdfObjTable<size_t>& xrefEntries);
         std::shared_ptr<PdfDictionary> parseTrailerAt(size_t xrefOffset);
         int  getPageCountByScan() const;
-        int  countPagesRecursive(
-            const std::shared_ptr<PdfDictionary>& node,
-            std::set<const PdfDictionary*>& visited) const;
+
+        // ---- Page index (flattened page tree, built once per document) ----
+        // Entries are handed out as shared snapshots: a render thread keeps
+        // its entry even if a password or repair invalidates the index.
+        struct PageIndexEntry
+        {
+            std::shared_ptr<PdfDictionary> dict;
+
+            // Inherited attributes, resolved on first access
+            bool attrsReady = false;
+            int  rotate = 0;
+            bool hasCropBox = false;
+            bool hasMediaBox = false;
+            double cropBox[4] = { 0, 0, 0, 0 };
+            double mediaBox[4] = { 0, 0, 0, 0 };
+            std::vector<std::shared_ptr<PdfDictionary>> resources; // page first, then parents
+        };
+        std::vector<std::shared_ptr<PageIndexEntry>> _pageIndex;  // null = not looked up yet (lazy)
+        std::unordered_map<const PdfDictionary*, int> _pageIndexByDict;
+        bool _pageIndexReady = false;
+        bool _pageIndexLazy = false;    // sized from the root /Count, filled per lookup
+
+        void buildPageIndex() const;
+        void buildFullPageIndex() const;
+        void resolvePageIndexEntry(int pageIndex) const;
+        std::shared_ptr<PageIndexEntry> pageIndexSlot(int pageIndex) const;
+        int pageTreeNodeType(const std::shared_ptr<PdfDictionary>& node) const;
+        int pageTreeNodeCount(const std::shared_ptr<PdfDictionary>& node) const;
+        std::shared_ptr<PdfArray> pageTreeKids(const std::shared_ptr<PdfDictionary>& node) const;
+        void invalidatePageIndex();
+        std::shared_ptr<const PageIndexEntry> getPageIndexEntry(int pageIndex) const;
 
         bool getPageContentsBytesInternal(
             int pageIndex, std::vector<uint8_t>& out) const;
@@ -352,7 +488,7 @@ namespace pdf
             std::vector<uint8_t>& out) const;
 
         bool decompressFlate(
-            const std::vector<uint8_t>& input,
+            PdfByteView input,
             std::vector<uint8_t>& output) const;
 
         bool extractBox(
@@ -0,0 +1,236 @@
+// =====================================================
+// PdfDownsample.cpp - Separable SSAA downsampler
+// =====================================================
+
+#include "pch.h"
+#include "PdfDownsample.h"
+#include "PdfPlatform.h"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// SSE2 row kernels and an AVX2 column pass (runtime-detected, x86/x64 only)
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PDF_DOWNSAMPLE_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define PDF_SSE2_TARGET
+#define PDF_AVX2_TARGET
+#else
+#define PDF_SSE2_TARGET __attribute__((target("sse2")))
+#define PDF_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#else
+#define PDF_DOWNSAMPLE_SIMD 0
+#endif
+
+namespace pdf
+{
+    // Per-axis weights sum to 1 << WEIGHT_BITS. A column sum is then at
+    // most 255 * 128 and still fits int16 for the row pass multiplies.
+    static constexpr int WEIGHT_BITS = 7;
+    static constexpr int WEIGHT_ONE = 1 << WEIGHT_BITS;
+    static constexpr int RESULT_SHIFT = 2 * WEIGHT_BITS;
+
+    // One spare zero weight so odd factors can be taken in pairs
+    using KernelWeights = std::array<int16_t, DOWNSAMPLE_MAX_SSAA + 1>;
+
+    static const KernelWeights& kernelWeights(int ssaa)
+    {
+        static const auto table = []()
+            {
+                std::array<KernelWeights, DOWNSAMPLE_MAX_SSAA + 1> t{};
+                for (int s = 1; s <= DOWNSAMPLE_MAX_SSAA; s++)
+                {
+                    // exp(-(dx² + dy²) / 2σ²) = exp(-dx² / 2σ²) * exp(-dy² / 2σ²)
+                    const double sigma = s * 0.5;
+                    double f[DOWNSAMPLE_MAX_SSAA];
+                    double sum = 0;
+                    for (int d = 0; d < s; d++)
+                    {
+                        const double dist = (d + 0.5) - s * 0.5;
+                        f[d] = std::exp(-dist * dist / (2.0 * sigma * sigma));
+                        sum += f[d];
+                    }
+
+                    // Rounding leftovers go to the largest weight, so a
+                    // flat cell comes back unchanged
+                    int total = 0, largest = 0;
+                    for (int d = 0; d < s; d++)
+                    {
+                        t[s][d] = (int16_t)std::lround(f[d] / sum * WEIGHT_ONE);
+                        total += t[s][d];
+                        if (t[s][d] > t[s][largest]) largest = d;
+                    }
+                    t[s][largest] = (int16_t)(t[s][largest] + WEIGHT_ONE - total);
+                }
+                return t;
+            }();
+        return table[ssaa];
+    }
+
+    // =====================================================
+    // Scalar kernels
+    // =====================================================
+
+    // col[i] = sum over ssaa rows of w[dy] * src[dy][i]
+    static void columnPassScalar(const uint8_t* src, size_t stride, int ssaa,
+        const int16_t* w, int16_t* col, size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            int sum = 0;
+            for (int dy = 0; dy < ssaa; dy++)
+                sum += w[dy] * src[dy * stride + i];
+            col[i] = (int16_t)sum;
+        }
+    }
+
+#if !PDF_DOWNSAMPLE_SIMD
+    // dst pixel x = sum over its cell of w[dx] * col pixel, rounded
+    static void rowPassScalar(const int16_t* col, int ssaa, const int16_t* w,
+        uint8_t* dst, int dstW)
+    {
+        for (int x = 0; x < dstW; x++)
+        {
+            const int16_t* cell = col + (size_t)x * ssaa * 4;
+            for (int c = 0; c < 4; c++)
+            {
+                int sum = 0;
+                for (int dx = 0; dx < ssaa; dx++)
+                    sum += w[dx] * cell[dx * 4 + c];
+                dst[x * 4 + c] = (uint8_t)((sum + (1 << (RESULT_SHIFT - 1))) >> RESULT_SHIFT);
+            }
+        }
+    }
+#endif
+
+#if PDF_DOWNSAMPLE_SIMD
+    // =====================================================
+    // SSE2 kernels
+    // =====================================================
+
+    PDF_SSE2_TARGET
+    static void columnPassSse2(const uint8_t* src, size_t stride, int ssaa,
+        const int16_t* w, int16_t* col, size_t n)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            __m128i lo = _mm_setzero_si128();
+            __m128i hi = _mm_setzero_si128();
+            for (int dy = 0; dy < ssaa; dy++)
+            {
+                const __m128i px = _mm_loadu_si128((const __m128i*)(src + dy * stride + i));
+                const __m128i wv = _mm_set1_epi16(w[dy]);
+                lo = _mm_add_epi16(lo, _mm_mullo_epi16(_mm_unpacklo_epi8(px, zero), wv));
+                hi = _mm_add_epi16(hi, _mm_mullo_epi16(_mm_unpackhi_epi8(px, zero), wv));
+            }
+            _mm_storeu_si128((__m128i*)(col + i), lo);
+            _mm_storeu_si128((__m128i*)(col + i + 8), hi);
+        }
+        columnPassScalar(src + i, stride, ssaa, w, col + i, n - i);
+    }
+
+    // Neighbouring pixels of a cell are interleaved per channel
+    // (B0 B1 G0 G1 ...) so one madd applies both of their weights
+    PDF_SSE2_TARGET
+    static void rowPassSse2(const int16_t* col, int ssaa, const int16_t* w,
+        uint8_t* dst, int dstW)
+    {
+        __m128i pairs[(DOWNSAMPLE_MAX_SSAA + 1) / 2];
+        const int pairCount = (ssaa + 1) / 2;
+        for (int p = 0; p < pairCount; p++)
+            pairs[p] = _mm_set1_epi32((int)((uint16_t)w[2 * p] | ((uint32_t)(uint16_t)w[2 * p + 1] << 16)));
+
+        const __m128i round = _mm_set1_epi32(1 << (RESULT_SHIFT - 1));
+        for (int x = 0; x < dstW; x++)
+        {
+            const int16_t* cell = col + (size_t)x * ssaa * 4;
+            __m128i sum = _mm_setzero_si128();
+            for (int p = 0; p < pairCount; p++)
+            {
+                const __m128i a = _mm_loadl_epi64((const __m128i*)(cell + p * 8));
+                const __m128i b = _mm_loadl_epi64((const __m128i*)(cell + p * 8 + 4));
+                sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), pairs[p]));
+            }
+            sum = _mm_srai_epi32(_mm_add_epi32(sum, round), RESULT_SHIFT);
+            const __m128i words = _mm_packs_epi32(sum, sum);
+            const __m128i packed = _mm_packus_epi16(words, words);
+            const int bgra = _mm_cvtsi128_si32(packed);
+            std::memcpy(dst + x * 4, &bgra, 4);
+        }
+    }
+
+    // =====================================================
+    // AVX2 column pass (the row pass touches ssaa times less data)
+    // =====================================================
+    PDF_AVX2_TARGET
+    static void columnPassAvx2(const uint8_t* src, size_t stride, int ssaa,
+        const int16_t* w, int16_t* col, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            __m256i sum = _mm256_setzero_si256();
+            for (int dy = 0; dy < ssaa; dy++)
+            {
+                const __m256i px = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(src + dy * stride + i)));
+                sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(px, _mm256_set1_epi16(w[dy])));
+            }
+            _mm256_storeu_si256((__m256i*)(col + i), sum);
+        }
+        columnPassScalar(src + i, stride, ssaa, w, col + i, n - i);
+    }
+#endif
+
+    // =====================================================
+    // downsampleSsaa
+    // =====================================================
+    bool downsampleSsaa(
+        const uint8_t* src, size_t srcStride,
+        int ssaa,
+        uint8_t* dst, size_t dstStride,
+        int dstW, int dstH)
+    {
+        if (ssaa < 1 || ssaa > DOWNSAMPLE_MAX_SSAA || !src || !dst)
+            return false;
+        if (dstW <= 0 || dstH <= 0)
+            return true;
+
+        if (ssaa == 1)
+        {
+            for (int y = 0; y < dstH; y++)
+                std::memcpy(dst + y * dstStride, src + y * srcStride, (size_t)dstW * 4);
+            return true;
+        }
+
+        using ColumnPass = void(*)(const uint8_t*, size_t, int, const int16_t*, int16_t*, size_t);
+        using RowPass = void(*)(const int16_t*, int, const int16_t*, uint8_t*, int);
+#if PDF_DOWNSAMPLE_SIMD
+        const bool avx2 = platform::cpuHasAvx2();
+        const ColumnPass columnPass = avx2 ? columnPassAvx2 : columnPassSse2;
+        const RowPass rowPass = rowPassSse2;
+#else
+        const ColumnPass columnPass = columnPassScalar;
+        const RowPass rowPass = rowPassScalar;
+#endif
+
+        const int16_t* w = kernelWeights(ssaa).data();
+
+        // Odd factors read one pixel past the last cell (zero weight)
+        const size_t n = (size_t)dstW * ssaa * 4;
+        std::vector<int16_t> col(n + 4, 0);
+
+        for (int y = 0; y < dstH; y++)
+        {
+            columnPass(src + (size_t)y * ssaa * srcStride, srcStride, ssaa, w, col.data(), n);
+            rowPass(col.data(), ssaa, w, dst + y * dstStride, dstW);
+        }
+        return true;
+    }
+
+} // namespace pdf
@@ -0,0 +1,32 @@
+#pragma once
+// =====================================================
+// PdfDownsample.h - SSAA buffer to output pixels
+// =====================================================
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pdf
+{
+    // Largest supersampling factor the downsampler has a kernel for
+    static constexpr int DOWNSAMPLE_MAX_SSAA = 16;
+
+    // =====================================================
+    // downsampleSsaa
+    // Reduces a BGRA buffer supersampled ssaa times on both axes to
+    // dstW x dstH pixels. Each output pixel is the Gaussian-weighted
+    // (sigma = ssaa / 2) average of its ssaa x ssaa cell; the kernel is
+    // separable, so a row of cells is first summed down its ssaa source
+    // rows, then across each cell. Weights are fixed point, built once
+    // per factor, and every code path (scalar, SSE2, AVX2) gives the
+    // same bytes.
+    // Rows are srcStride / dstStride bytes apart. Returns false for a
+    // factor outside 1..DOWNSAMPLE_MAX_SSAA.
+    // =====================================================
+    bool downsampleSsaa(
+        const uint8_t* src, size_t srcStride,
+        int ssaa,
+        uint8_t* dst, size_t dstStride,
+        int dstW, int dstH);
+
+} // namespace pdf
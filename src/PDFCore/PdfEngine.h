@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <string>
 #include <map>
@@ -9,19 +10,27 @@
 
 #include "PdfDocument.h"
 #include "PdfPainter.h"
+#ifndef PDFCORE_HEADLESS
 #include "PdfPainterGPU.h"
+#endif
 #include "PdfContentParser.h"
 #include "PdfObject.h"
 #include "PdfTextExtractor.h"
 
-#ifdef PDFCORE_EXPORTS
+#if !defined(_WIN32)
+#define PDF_API extern "C" __attribute__((visibility("default")))
+#elif defined(PDFCORE_EXPORTS)
 #define PDF_API extern "C" __declspec(dllexport)
 #else
 #define PDF_API extern "C" __declspec(dllimport)
 #endif
 
 #ifndef PDF_CALL
+#ifdef _WIN32
 #define PDF_CALL __cdecl
+#else
+#define PDF_CALL
+#endif
 #endif
 
 typedef void* PDF_DOCUMENT;
@@ -29,10 +38,13 @@ typedef void* PDF_DOCUMENT;
 namespace pdf
 {
     // Zoom state için yardımcı struct
+    // UI thread'i yazar, render thread'leri okur
     struct RenderQuality
     {
-        bool isZooming = false;
-        int ssaa = 1;  // 🚀 CHANGED: Default SSAA=1 for speed (was 2)
+        std::atomic<bool> isZooming{ false };
+        std::atomic<int> ssaa{ 1 };  // 🚀 CHANGED: Default SSAA=1 for speed (was 2)
+        std::atomic<int> bandThreads{ 1 };  // >1: large pages render in parallel bands
+        std::atomic<bool> antiAlias{ true };  // exact-area edges on fills and strokes
 
         void startZoom()
         {
@@ -154,6 +166,19 @@ namespace pdf
 // Zoom state management
 PDF_API void Pdf_SetZoomState(PDF_DOCUMENT doc, int isZooming);
 
+// Threads for one large CPU page (rendered as parallel bands); 1 = off
+PDF_API void Pdf_SetRenderThreads(int threads);
+
+// Anti-aliased fill and stroke edges on the CPU renderer; 0 = aliased
+PDF_API void Pdf_SetAntiAlias(int enabled);
+
+// Render tracing (builds configured with PDFCORE_TRACE): mask of
+// pdf::trace::Category bits to record, 0 = off. Pdf_WriteTrace saves
+// the recorded events as Chrome trace JSON; returns 0 on failure. Call
+// it only when no page is rendering (all Pdf_RenderPage calls returned).
+PDF_API void Pdf_SetTraceCategories(unsigned int mask);
+PDF_API int Pdf_WriteTrace(const char* path);
+
 // 🚀 Cache management
 PDF_API void Pdf_ClearCache(PDF_DOCUMENT doc);
 
@@ -166,6 +191,9 @@ PDF_API int Pdf_GetRealPageCountFromFile(const wchar_t* path);
 
 // Document management
 PDF_API PDF_DOCUMENT Pdf_OpenDocument(const wchar_t* path);
+// Same as Pdf_OpenDocument but maps the file read-only instead of copying it.
+// The file must not be modified/truncated while the document is open.
+PDF_API PDF_DOCUMENT Pdf_OpenDocumentMapped(const wchar_t* path);
 PDF_API void Pdf_CloseDocument(PDF_DOCUMENT doc);
 
 // Page info
@@ -245,6 +273,22 @@ PDF_API void PDF_CALL Pdf_GetCacheStats(
     size_t* outCacheSize,
     size_t* outMemoryMB);
 
+// Compiled Form XObject cache of one document (shared across its pages)
+PDF_API void PDF_CALL Pdf_GetFormCacheStats(
+    PDF_DOCUMENT doc,
+    size_t* outHits,
+    size_t* outMisses,
+    size_t* outForms,
+    size_t* outMemoryKB);
+
+// Decoded image cache of one document (shared across its pages and painters)
+PDF_API void PDF_CALL Pdf_GetImageCacheStats(
+    PDF_DOCUMENT doc,
+    size_t* outHits,
+    size_t* outMisses,
+    size_t* outImages,
+    size_t* outMemoryKB);
+
 // =============================================
 // ENCRYPTION API
 // =============================================
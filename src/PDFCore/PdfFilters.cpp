@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "PdfFilters.h"
+#include "PdfTrace.h"
 #include <zlib.h>
 #include <cstring>
 #include <stdexcept>
@@ -58,7 +59,7 @@ namespace pdf
         return false;
     }
 
-    bool PdfFilters::FlateDecode(const std::vector<uint8_t>& input,
+    bool PdfFilters::FlateDecode(PdfByteView input,
         std::vector<uint8_t>& output)
     {
         if (input.empty())
@@ -103,7 +104,7 @@ namespace pdf
     // ---------------------------------------------------------
     // ASCII85Decode
     // ---------------------------------------------------------
-    bool PdfFilters::ASCII85Decode(const std::vector<uint8_t>& input,
+    bool PdfFilters::ASCII85Decode(PdfByteView input,
         std::vector<uint8_t>& output)
     {
         output.clear();
@@ -155,7 +156,7 @@ namespace pdf
     // ---------------------------------------------------------
     // RunLengthDecode
     // ---------------------------------------------------------
-    bool PdfFilters::RunLengthDecode(const std::vector<uint8_t>& input,
+    bool PdfFilters::RunLengthDecode(PdfByteView input,
         std::vector<uint8_t>& output)
     {
         output.clear();
@@ -200,7 +201,7 @@ namespace pdf
     class LZWDecoder
     {
     public:
-        std::vector<uint8_t> decode(const std::vector<uint8_t>& input)
+        std::vector<uint8_t> decode(PdfByteView input)
         {
             std::vector<uint8_t> result;
 
@@ -303,14 +304,14 @@ namespace pdf
             return _bytePos >= _data->size();
         }
 
-        const std::vector<uint8_t>* _data = nullptr;
+        const PdfByteView* _data = nullptr;
         size_t _bytePos = 0;
         int _bitPos = 0;
         int _bits = 9;
         std::vector<std::vector<uint8_t>> _table;
     };
 
-    bool PdfFilters::LZWDecode(const std::vector<uint8_t>& input,
+    bool PdfFilters::LZWDecode(PdfByteView input,
         std::vector<uint8_t>& output)
     {
         LZWDecoder dec;
@@ -321,7 +322,7 @@ namespace pdf
     // ---------------------------------------------------------
     // JPEGDecode (DCTDecode)
     // ---------------------------------------------------------
-    bool PdfFilters::JPEGDecode(const std::vector<uint8_t>& input,
+    bool PdfFilters::JPEGDecode(PdfByteView input,
         std::vector<uint8_t>& argbOut,
         int& width,
         int& height)
@@ -439,29 +440,15 @@ namespace pdf
     }
 #endif
 
-    bool PdfFilters::JPEG2000Decode(const std::vector<uint8_t>& input,
+    bool PdfFilters::JPEG2000Decode(PdfByteView input,
         std::vector<uint8_t>& argbOut,
         int& width,
         int& height)
     {
         if (input.empty()) return false;
+        PDF_TRACE_SCOPE(Filter, "JPXDecode", "%zu bytes", input.size());
 
 #ifdef USE_OPENJPEG
-        // Debug log
-        static FILE* jp2Debug = nullptr;
-        if (!jp2Debug) {
-            char tempPath[MAX_PATH];
-            GetTempPathA(MAX_PATH, tempPath);
-            strcat_s(tempPath, MAX_PATH, "jpeg2000_debug.txt");
-            fopen_s(&jp2Debug, tempPath, "w");
-        }
-
-        if (jp2Debug) {
-            fprintf(jp2Debug, "=== JPEG2000Decode (OpenJPEG) ===\n");
-            fprintf(jp2Debug, "Input size: %zu bytes\n", input.size());
-            fflush(jp2Debug);
-        }
-
         // Determine codec format from signature
         OPJ_CODEC_FORMAT codecFormat = OPJ_CODEC_JP2;  // Default to JP2
 
@@ -517,10 +504,7 @@ namespace pdf
 
         // Decode image
         if (!opj_decode(codec, stream, image)) {
-            if (jp2Debug) {
-                fprintf(jp2Debug, "ERROR: opj_decode failed\n");
-                fflush(jp2Debug);
-            }
+            PDF_TRACE(Filter, "JPXDecode", "opj_decode failed");
             opj_image_destroy(image);
             opj_stream_destroy(stream);
             opj_destroy_codec(codec);
@@ -531,25 +515,8 @@ namespace pdf
         width = image->x1 - image->x0;
         height = image->y1 - image->y0;
 
-        if (jp2Debug) {
-            fprintf(jp2Debug, "Decoded: %dx%d, numcomps=%d, color_space=%d\n",
-                width, height, image->numcomps, image->color_space);
-            for (int c = 0; c < image->numcomps && c < 4; c++) {
-                fprintf(jp2Debug, "  Comp[%d]: w=%d h=%d prec=%d sgnd=%d dx=%d dy=%d\n",
-                    c, image->comps[c].w, image->comps[c].h,
-                    image->comps[c].prec, image->comps[c].sgnd,
-                    image->comps[c].dx, image->comps[c].dy);
-            }
-            // Sample some pixel values
-            if (image->numcomps >= 3 && image->comps[0].data) {
-                int midIdx = (height / 2) * width + (width / 2);
-                fprintf(jp2Debug, "  Center pixel raw: R=%d G=%d B=%d\n",
-                    image->comps[0].data[midIdx],
-                    image->comps[1].data[midIdx],
-                    image->comps[2].data[midIdx]);
-            }
-            fflush(jp2Debug);
-        }
+        PDF_TRACE(Filter, "JPXDecode", "%dx%d, %u components, color space %d",
+            width, height, image->numcomps, (int)image->color_space);
 
         if (width <= 0 || height <= 0 || image->numcomps < 1) {
             opj_image_destroy(image);
@@ -568,12 +535,6 @@ namespace pdf
         bool isYCC = (image->color_space == OPJ_CLRSPC_SYCC ||
             image->color_space == OPJ_CLRSPC_EYCC);
 
-        if (jp2Debug) {
-            fprintf(jp2Debug, "Processing as %s, hasAlpha=%d\n",
-                isYCC ? "YCbCr" : "RGB", hasAlpha ? 1 : 0);
-            fflush(jp2Debug);
-        }
-
         for (int y = 0; y < height; y++) {
             for (int x = 0; x < width; x++) {
                 int dstIdx = (y * width + x) * 4;
@@ -648,21 +609,6 @@ namespace pdf
             }
         }
 
-        // Debug: log some output pixel values
-        if (jp2Debug) {
-            int midIdx = ((height / 2) * width + (width / 2)) * 4;
-            fprintf(jp2Debug, "Output center pixel: R=%d G=%d B=%d A=%d\n",
-                argbOut[midIdx + 0], argbOut[midIdx + 1],
-                argbOut[midIdx + 2], argbOut[midIdx + 3]);
-
-            // Check a few more pixels
-            int cornerIdx = 0;
-            fprintf(jp2Debug, "Output top-left pixel: R=%d G=%d B=%d A=%d\n",
-                argbOut[cornerIdx + 0], argbOut[cornerIdx + 1],
-                argbOut[cornerIdx + 2], argbOut[cornerIdx + 3]);
-            fflush(jp2Debug);
-        }
-
         opj_image_destroy(image);
         opj_stream_destroy(stream);
         opj_destroy_codec(codec);
@@ -670,24 +616,7 @@ namespace pdf
         return true;
 #else
         // OpenJPEG not available - JPEG 2000 not supported
-        // Log error for debugging
-#ifdef _WIN32
-        static FILE* jp2Debug = nullptr;
-        if (!jp2Debug) {
-            char tempPath[MAX_PATH];
-            GetTempPathA(MAX_PATH, tempPath);
-            strcat_s(tempPath, MAX_PATH, "jpeg2000_debug.txt");
-            fopen_s(&jp2Debug, tempPath, "w");
-        }
-        if (jp2Debug) {
-            fprintf(jp2Debug, "JPEG 2000 decode failed: OpenJPEG not compiled in.\n");
-            fprintf(jp2Debug, "To enable JPEG 2000 support:\n");
-            fprintf(jp2Debug, "1. Install OpenJPEG: vcpkg install openjpeg:x64-windows\n");
-            fprintf(jp2Debug, "2. Add USE_OPENJPEG to preprocessor definitions\n");
-            fprintf(jp2Debug, "3. Link against openjp2.lib\n");
-            fflush(jp2Debug);
-        }
-#endif
+        PDF_TRACE(Filter, "JPXDecode", "OpenJPEG not compiled in (define USE_OPENJPEG)");
         return false;
 #endif
     }
@@ -899,7 +828,7 @@ namespace pdf
     }
 
     bool PdfFilters::CCITTFaxDecode(
-        const std::vector<uint8_t>& input,
+        PdfByteView input,
         std::vector<uint8_t>& output,
         int columns,
         int rows,
@@ -1214,15 +1143,17 @@ namespace pdf
 
 
     bool PdfFilters::Decode(
-        const std::vector<uint8_t>& input,
+        PdfByteView input,
         const std::vector<std::string>& filters,
         const std::vector<std::map<std::string, int>>& params,
         std::vector<uint8_t>& output)
     {
-        std::vector<uint8_t> data = input;
+        // First filter reads the input (stream slice) directly; intermediates live in data
+        std::vector<uint8_t> data;
 
         for (size_t i = 0; i < filters.size(); i++)
         {
+            PdfByteView src = (i == 0) ? input : PdfByteView(data);
             std::string f = NormalizeFilterName(filters[i]);
             const auto& p = (i < params.size()) ? params[i] : std::map<std::string, int>();
 
@@ -1230,7 +1161,7 @@ namespace pdf
 
             if (f == "/FlateDecode")
             {
-                if (!FlateDecode(data, temp))
+                if (!FlateDecode(src, temp))
                     return false;
 
                 if (HasParam(p, "Predictor"))
@@ -1244,7 +1175,7 @@ namespace pdf
             }
             else if (f == "/LZWDecode")
             {
-                LZWDecode(data, temp);
+                LZWDecode(src, temp);
 
                 if (HasParam(p, "Predictor"))
                 {
@@ -1257,46 +1188,49 @@ namespace pdf
             }
             else if (f == "/DCTDecode")
             {
-                temp = data;
+                temp.assign(src.begin(), src.end());
             }
             else if (f == "/JPXDecode")
             {
-                temp = data;
+                temp.assign(src.begin(), src.end());
             }
             else if (f == "/CCITTFaxDecode")
             {
-                temp = data;
+                temp.assign(src.begin(), src.end());
             }
-            else if (f == "/JBIG2Decode" || f == "JBIG2Decode")
+            else if (f == "/JBIG2Decode")
             {
-                temp = data;  // Pass through - decoded in decodeImageXObject()
+                temp.assign(src.begin(), src.end());  // Pass through - decoded in decodeImageXObject()
             }
             else if (f == "/ASCII85Decode")
             {
-                ASCII85Decode(data, temp);
+                ASCII85Decode(src, temp);
             }
             else if (f == "/RunLengthDecode")
             {
-                RunLengthDecode(data, temp);
+                RunLengthDecode(src, temp);
             }
             else if (f == "/ASCIIHexDecode")
             {
                 temp.clear();
-                for (size_t j = 0; j + 1 < data.size(); j += 2)
+                for (size_t j = 0; j + 1 < src.size(); j += 2)
                 {
-                    char hex[3] = { (char)data[j], (char)data[j + 1], 0 };
+                    char hex[3] = { (char)src[j], (char)src[j + 1], 0 };
                     temp.push_back((uint8_t)strtol(hex, nullptr, 16));
                 }
             }
             else
             {
-                temp = data;
+                temp.assign(src.begin(), src.end());
             }
 
             data.swap(temp);
         }
 
-        output = data;
+        if (filters.empty())
+            output.assign(input.begin(), input.end());
+        else
+            output.swap(data);
         return true;
     }
 
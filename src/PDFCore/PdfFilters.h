@@ -3,6 +3,7 @@
 #include <string>
 #include <cstdint>
 #include <map>
+#include "PdfBytes.h"
 
 namespace pdf
 {
@@ -11,29 +12,29 @@ namespace pdf
     public:
 
         // --- Flate Decode (ZIP / zlib) ---
-        static bool FlateDecode(const std::vector<uint8_t>& input,
+        static bool FlateDecode(PdfByteView input,
             std::vector<uint8_t>& output);
 
         // --- ASCII85 Decode ---
-        static bool ASCII85Decode(const std::vector<uint8_t>& input,
+        static bool ASCII85Decode(PdfByteView input,
             std::vector<uint8_t>& output);
 
         // --- RunLength Decode ---
-        static bool RunLengthDecode(const std::vector<uint8_t>& input,
+        static bool RunLengthDecode(PdfByteView input,
             std::vector<uint8_t>& output);
 
         // --- LZW Decode ---
-        static bool LZWDecode(const std::vector<uint8_t>& input,
+        static bool LZWDecode(PdfByteView input,
             std::vector<uint8_t>& output);
 
         // --- JPEG Decode (DCTDecode) ---
-        static bool JPEGDecode(const std::vector<uint8_t>& input,
+        static bool JPEGDecode(PdfByteView input,
             std::vector<uint8_t>& argbOut,
             int& width,
             int& height);
 
         // --- JPEG2000 Decode (JPXDecode) ---
-        static bool JPEG2000Decode(const std::vector<uint8_t>& input,
+        static bool JPEG2000Decode(PdfByteView input,
             std::vector<uint8_t>& argbOut,
             int& width,
             int& height);
@@ -47,7 +48,7 @@ namespace pdf
 
         // --- CCITT Fax Decode (Group 3 / Group 4) ---
         static bool CCITTFaxDecode(
-            const std::vector<uint8_t>& input,
+            PdfByteView input,
             std::vector<uint8_t>& output,
             int columns,
             int rows,
@@ -62,7 +63,7 @@ namespace pdf
         // This is a pass-through marker in the filter chain.
 
         // --- Filter Chain Processing ---
-        static bool Decode(const std::vector<uint8_t>& input,
+        static bool Decode(PdfByteView input,
             const std::vector<std::string>& filters,
             const std::vector<std::map<std::string, int>>& params,
             std::vector<uint8_t>& output);
@@ -13,7 +13,6 @@
 #include "PdfDebug.h"
 #include <algorithm>
 #include <cmath>
-#include <set>
 
 namespace pdf
 {
@@ -331,7 +330,7 @@ namespace pdf
     {
         if (!funcObj || !doc) return false;
 
-        std::set<int> visited;
+        PdfVisitedRefs visited;
         auto resolved = doc->resolve(funcObj, visited);
 
         if (!resolved) return false;
@@ -339,12 +338,12 @@ namespace pdf
         std::shared_ptr<PdfDictionary> funcDict;
         std::shared_ptr<PdfStream> funcStream;
 
-        if (auto stream = std::dynamic_pointer_cast<PdfStream>(resolved))
+        if (auto stream = pdfCast<PdfStream>(resolved))
         {
             funcStream = stream;
             funcDict = stream->dict;
         }
-        else if (auto dict = std::dynamic_pointer_cast<PdfDictionary>(resolved))
+        else if (auto dict = pdfCast<PdfDictionary>(resolved))
         {
             funcDict = dict;
         }
@@ -352,8 +351,8 @@ namespace pdf
         if (!funcDict) return false;
 
         visited.clear();
-        auto typeObj = std::dynamic_pointer_cast<PdfNumber>(
-            doc->resolve(funcDict->get("/FunctionType"), visited));
+        auto typeObj = pdfCast<PdfNumber>(
+            doc->resolve(funcDict->get(PdfKeys::FunctionType), visited));
 
         if (!typeObj) return false;
 
@@ -400,33 +399,33 @@ namespace pdf
     {
         if (!funcStream) return false;
 
-        std::set<int> visited;
+        PdfVisitedRefs visited;
 
         LogDebug("--- parseFunctionType0 (LUT MODE) ---");
 
         // Size
         visited.clear();
-        auto sizeArr = std::dynamic_pointer_cast<PdfArray>(
-            doc->resolve(funcDict->get("/Size"), visited));
+        auto sizeArr = pdfCast<PdfArray>(
+            doc->resolve(funcDict->get(PdfKeys::Size), visited));
         if (!sizeArr || sizeArr->items.empty()) return false;
 
         visited.clear();
-        auto sizeNum = std::dynamic_pointer_cast<PdfNumber>(
+        auto sizeNum = pdfCast<PdfNumber>(
             doc->resolve(sizeArr->items[0], visited));
         int numSamples = sizeNum ? (int)sizeNum->value : 2;
 
         // BitsPerSample
         visited.clear();
-        auto bpsObj = std::dynamic_pointer_cast<PdfNumber>(
-            doc->resolve(funcDict->get("/BitsPerSample"), visited));
+        auto bpsObj = pdfCast<PdfNumber>(
+            doc->resolve(funcDict->get(PdfKeys::BitsPerSample), visited));
         int bitsPerSample = bpsObj ? (int)bpsObj->value : 8;
 
         LogDebug("Samples: %d, BitsPerSample: %d", numSamples, bitsPerSample);
 
         // Range
         visited.clear();
-        auto rangeArr = std::dynamic_pointer_cast<PdfArray>(
-            doc->resolve(funcDict->get("/Range"), visited));
+        auto rangeArr = pdfCast<PdfArray>(
+            doc->resolve(funcDict->get(PdfKeys::Range), visited));
 
         std::vector<double> rangeMin, rangeMax;
         int outputComponents = numComponents;
@@ -437,10 +436,10 @@ namespace pdf
             for (int i = 0; i < outputComponents; ++i)
             {
                 visited.clear();
-                auto rmin = std::dynamic_pointer_cast<PdfNumber>(
+                auto rmin = pdfCast<PdfNumber>(
                     doc->resolve(rangeArr->items[i * 2], visited));
                 visited.clear();
-                auto rmax = std::dynamic_pointer_cast<PdfNumber>(
+                auto rmax = pdfCast<PdfNumber>(
                     doc->resolve(rangeArr->items[i * 2 + 1], visited));
                 rangeMin.push_back(rmin ? rmin->value : 0.0);
                 rangeMax.push_back(rmax ? rmax->value : 1.0);
@@ -457,8 +456,8 @@ namespace pdf
 
         // Decode
         visited.clear();
-        auto decodeArr = std::dynamic_pointer_cast<PdfArray>(
-            doc->resolve(funcDict->get("/Decode"), visited));
+        auto decodeArr = pdfCast<PdfArray>(
+            doc->resolve(funcDict->get(PdfKeys::Decode), visited));
 
         std::vector<double> decodeMin, decodeMax;
         if (decodeArr && decodeArr->items.size() >= (size_t)(outputComponents * 2))
@@ -466,10 +465,10 @@ namespace pdf
             for (int i = 0; i < outputComponents; ++i)
             {
                 visited.clear();
-                auto dmin = std::dynamic_pointer_cast<PdfNumber>(
+                auto dmin = pdfCast<PdfNumber>(
                     doc->resolve(decodeArr->items[i * 2], visited));
                 visited.clear();
-                auto dmax = std::dynamic_pointer_cast<PdfNumber>(
+                auto dmax = pdfCast<PdfNumber>(
                     doc->resolve(decodeArr->items[i * 2 + 1], visited));
                 decodeMin.push_back(dmin ? dmin->value : rangeMin[i]);
                 decodeMax.push_back(dmax ? dmax->value : rangeMax[i]);
@@ -484,7 +483,7 @@ namespace pdf
         // Stream decode
         std::vector<uint8_t> data;
         if (!doc->decodeStream(funcStream, data) || data.empty())
-            data = funcStream->data;
+            data = funcStream->data.toVector();
 
         if (data.empty()) return false;
 
@@ -564,26 +563,26 @@ namespace pdf
         std::vector<GradientStop>& outStops,
         int numComponents)
     {
-        std::set<int> visited;
+        PdfVisitedRefs visited;
 
         // Exponent N
         double N = 1.0;
-        auto nObj = std::dynamic_pointer_cast<PdfNumber>(
-            doc->resolve(funcDict->get("/N"), visited));
+        auto nObj = pdfCast<PdfNumber>(
+            doc->resolve(funcDict->get(PdfKeys::N), visited));
         if (nObj) N = nObj->value;
 
         // C0
         std::vector<double> c0(numComponents, 0.0);
         visited.clear();
-        auto c0Arr = std::dynamic_pointer_cast<PdfArray>(
-            doc->resolve(funcDict->get("/C0"), visited));
+        auto c0Arr = pdfCast<PdfArray>(
+            doc->resolve(funcDict->get(PdfKeys::C0), visited));
         if (c0Arr)
         {
             c0.resize(c0Arr->items.size());
             for (size_t i = 0; i < c0Arr->items.size(); ++i)
             {
                 visited.clear();
-                if (auto n = std::dynamic_pointer_cast<PdfNumber>(
+                if (auto n = pdfCast<PdfNumber>(
                     doc->resolve(c0Arr->items[i], visited)))
                     c0[i] = n->value;
             }
@@ -592,15 +591,15 @@ namespace pdf
         // C1
         std::vector<double> c1(numComponents, 1.0);
         visited.clear();
-        auto c1Arr = std::dynamic_pointer_cast<PdfArray>(
-            doc->resolve(funcDict->get("/C1"), visited));
+        auto c1Arr = pdfCast<PdfArray>(
+            doc->resolve(funcDict->get(PdfKeys::C1), visited));
         if (c1Arr)
         {
             c1.resize(c1Arr->items.size());
             for (size_t i = 0; i < c1Arr->items.size(); ++i)
             {
                 visited.clear();
-                if (auto n = std::dynamic_pointer_cast<PdfNumber>(
+                if (auto n = pdfCast<PdfNumber>(
                     doc->resolve(c1Arr->items[i], visited)))
                     c1[i] = n->value;
             }
@@ -647,15 +646,15 @@ namespace pdf
         PdfGradient& gradient,
         int numComponents)
     {
-        std::set<int> visited;
+        PdfVisitedRefs visited;
 
-        auto funcsArr = std::dynamic_pointer_cast<PdfArray>(
-            doc->resolve(funcDict->get("/Functions"), visited));
+        auto funcsArr = pdfCast<PdfArray>(
+            doc->resolve(funcDict->get(PdfKeys::Functions), visited));
         if (!funcsArr || funcsArr->items.empty()) return false;
 
         visited.clear();
-        auto boundsArr = std::dynamic_pointer_cast<PdfArray>(
-            doc->resolve(funcDict->get("/Bounds"), visited));
+        auto boundsArr = pdfCast<PdfArray>(
+            doc->resolve(funcDict->get(PdfKeys::Bounds), visited));
 
         std::vector<double> bounds;
         if (boundsArr)
@@ -663,7 +662,7 @@ namespace pdf
             for (auto& item : boundsArr->items)
             {
                 visited.clear();
-                if (auto n = std::dynamic_pointer_cast<PdfNumber>(
+                if (auto n = pdfCast<PdfNumber>(
                     doc->resolve(item, visited)))
                     bounds.push_back(n->value);
             }
@@ -671,8 +670,8 @@ namespace pdf
 
         // Encode array - sub-function domain mapping
         visited.clear();
-        auto encodeArr = std::dynamic_pointer_cast<PdfArray>(
-            doc->resolve(funcDict->get("/Encode"), visited));
+        auto encodeArr = pdfCast<PdfArray>(
+            doc->resolve(funcDict->get(PdfKeys::Encode), visited));
 
         std::vector<double> encode;
         if (encodeArr)
@@ -680,25 +679,25 @@ namespace pdf
             for (auto& item : encodeArr->items)
             {
                 visited.clear();
-                if (auto n = std::dynamic_pointer_cast<PdfNumber>(
+                if (auto n = pdfCast<PdfNumber>(
                     doc->resolve(item, visited)))
                     encode.push_back(n->value);
             }
         }
 
         visited.clear();
-        auto domainArr = std::dynamic_pointer_cast<PdfArray>(
-            doc->resolve(funcDict->get("/Domain"), visited));
+        auto domainArr = pdfCast<PdfArray>(
+            doc->resolve(funcDict->get(PdfKeys::Domain), visited));
 
         double domainMin = 0.0, domainMax = 1.0;
         if (domainArr && domainArr->items.size() >= 2)
         {
             visited.clear();
-            if (auto d0 = std::dynamic_pointer_cast<PdfNumber>(
+            if (auto d0 = pdfCast<PdfNumber>(
                 doc->resolve(domainArr->items[0], visited)))
                 domainMin = d0->value;
             visited.clear();
-            if (auto d1 = std::dynamic_pointer_cast<PdfNumber>(
+            if (auto d1 = pdfCast<PdfNumber>(
                 doc->resolve(domainArr->items[1], visited)))
                 domainMax = d1->value;
         }
@@ -811,20 +810,17 @@ namespace pdf
         // Map each DeviceN component to appropriate CMYK channel
         for (size_t i = 0; i < deviceNNames.size(); ++i)
         {
-            std::string name = deviceNNames[i];
-            // Normalize name (remove leading /)
-            if (!name.empty() && name[0] == '/')
-                name = name.substr(1);
-
+            // Colorant names come from PdfName, so they keep their '/'
+            const std::string& name = deviceNNames[i];
             double val = deviceNValues[i];
 
-            if (name == "Cyan" || name == "C")
+            if (name == "/Cyan" || name == "/C")
                 cmyk[0] = val;
-            else if (name == "Magenta" || name == "M")
+            else if (name == "/Magenta" || name == "/M")
                 cmyk[1] = val;
-            else if (name == "Yellow" || name == "Y")
+            else if (name == "/Yellow" || name == "/Y")
                 cmyk[2] = val;
-            else if (name == "Black" || name == "K")
+            else if (name == "/Black" || name == "/K")
                 cmyk[3] = val;
             else
             {
@@ -857,19 +853,19 @@ namespace pdf
         int numComponents = (int)deviceNNames.size();
         LogDebug("parseFunctionToGradientDeviceN: %d components", numComponents);
 
-        std::set<int> visited;
+        PdfVisitedRefs visited;
         auto resolved = doc->resolve(funcObj, visited);
         if (!resolved) return false;
 
         std::shared_ptr<PdfDictionary> funcDict;
         std::shared_ptr<PdfStream> funcStream;
 
-        if (auto stream = std::dynamic_pointer_cast<PdfStream>(resolved))
+        if (auto stream = pdfCast<PdfStream>(resolved))
         {
             funcStream = stream;
             funcDict = stream->dict;
         }
-        else if (auto dict = std::dynamic_pointer_cast<PdfDictionary>(resolved))
+        else if (auto dict = pdfCast<PdfDictionary>(resolved))
         {
             funcDict = dict;
         }
@@ -877,8 +873,8 @@ namespace pdf
         if (!funcDict) return false;
 
         visited.clear();
-        auto typeObj = std::dynamic_pointer_cast<PdfNumber>(
-            doc->resolve(funcDict->get("/FunctionType"), visited));
+        auto typeObj = pdfCast<PdfNumber>(
+            doc->resolve(funcDict->get(PdfKeys::FunctionType), visited));
         if (!typeObj) return false;
 
         int funcType = (int)typeObj->value;
@@ -892,21 +888,21 @@ namespace pdf
             // Get N (exponent)
             double N = 1.0;
             visited.clear();
-            auto nObj = std::dynamic_pointer_cast<PdfNumber>(
-                doc->resolve(funcDict->get("/N"), visited));
+            auto nObj = pdfCast<PdfNumber>(
+                doc->resolve(funcDict->get(PdfKeys::N), visited));
             if (nObj) N = nObj->value;
 
             // Get C0 (start color in DeviceN space)
             std::vector<double> c0(numComponents, 0.0);
             visited.clear();
-            auto c0Arr = std::dynamic_pointer_cast<PdfArray>(
-                doc->resolve(funcDict->get("/C0"), visited));
+            auto c0Arr = pdfCast<PdfArray>(
+                doc->resolve(funcDict->get(PdfKeys::C0), visited));
             if (c0Arr)
             {
                 for (size_t i = 0; i < c0Arr->items.size() && i < (size_t)numComponents; ++i)
                 {
                     visited.clear();
-                    if (auto n = std::dynamic_pointer_cast<PdfNumber>(
+                    if (auto n = pdfCast<PdfNumber>(
                         doc->resolve(c0Arr->items[i], visited)))
                         c0[i] = n->value;
                 }
@@ -915,14 +911,14 @@ namespace pdf
             // Get C1 (end color in DeviceN space)
             std::vector<double> c1(numComponents, 1.0);
             visited.clear();
-            auto c1Arr = std::dynamic_pointer_cast<PdfArray>(
-                doc->resolve(funcDict->get("/C1"), visited));
+            auto c1Arr = pdfCast<PdfArray>(
+                doc->resolve(funcDict->get(PdfKeys::C1), visited));
             if (c1Arr)
             {
                 for (size_t i = 0; i < c1Arr->items.size() && i < (size_t)numComponents; ++i)
                 {
                     visited.clear();
-                    if (auto n = std::dynamic_pointer_cast<PdfNumber>(
+                    if (auto n = pdfCast<PdfNumber>(
                         doc->resolve(c1Arr->items[i], visited)))
                         c1[i] = n->value;
                 }
@@ -983,21 +979,21 @@ namespace pdf
         if (funcType == 3)
         {
             visited.clear();
-            auto funcsArr = std::dynamic_pointer_cast<PdfArray>(
-                doc->resolve(funcDict->get("/Functions"), visited));
+            auto funcsArr = pdfCast<PdfArray>(
+                doc->resolve(funcDict->get(PdfKeys::Functions), visited));
             if (!funcsArr || funcsArr->items.empty()) return false;
 
             // Get Bounds
             visited.clear();
-            auto boundsArr = std::dynamic_pointer_cast<PdfArray>(
-                doc->resolve(funcDict->get("/Bounds"), visited));
+            auto boundsArr = pdfCast<PdfArray>(
+                doc->resolve(funcDict->get(PdfKeys::Bounds), visited));
             std::vector<double> bounds;
             if (boundsArr)
             {
                 for (auto& item : boundsArr->items)
                 {
                     visited.clear();
-                    if (auto n = std::dynamic_pointer_cast<PdfNumber>(
+                    if (auto n = pdfCast<PdfNumber>(
                         doc->resolve(item, visited)))
                         bounds.push_back(n->value);
                 }
@@ -1005,15 +1001,15 @@ namespace pdf
 
             // Get Encode
             visited.clear();
-            auto encodeArr = std::dynamic_pointer_cast<PdfArray>(
-                doc->resolve(funcDict->get("/Encode"), visited));
+            auto encodeArr = pdfCast<PdfArray>(
+                doc->resolve(funcDict->get(PdfKeys::Encode), visited));
             std::vector<double> encode;
             if (encodeArr)
             {
                 for (auto& item : encodeArr->items)
                 {
                     visited.clear();
-                    if (auto n = std::dynamic_pointer_cast<PdfNumber>(
+                    if (auto n = pdfCast<PdfNumber>(
                         doc->resolve(item, visited)))
                         encode.push_back(n->value);
                 }
@@ -1021,17 +1017,17 @@ namespace pdf
 
             // Get Domain
             visited.clear();
-            auto domainArr = std::dynamic_pointer_cast<PdfArray>(
-                doc->resolve(funcDict->get("/Domain"), visited));
+            auto domainArr = pdfCast<PdfArray>(
+                doc->resolve(funcDict->get(PdfKeys::Domain), visited));
             double domainMin = 0.0, domainMax = 1.0;
             if (domainArr && domainArr->items.size() >= 2)
             {
                 visited.clear();
-                if (auto d0 = std::dynamic_pointer_cast<PdfNumber>(
+                if (auto d0 = pdfCast<PdfNumber>(
                     doc->resolve(domainArr->items[0], visited)))
                     domainMin = d0->value;
                 visited.clear();
-                if (auto d1 = std::dynamic_pointer_cast<PdfNumber>(
+                if (auto d1 = pdfCast<PdfNumber>(
                     doc->resolve(domainArr->items[1], visited)))
                     domainMax = d1->value;
             }
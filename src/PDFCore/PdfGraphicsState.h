@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include <cmath>
 #include <string>
+#include "PdfBlend.h"
 
 namespace pdf
 {
@@ -64,7 +65,7 @@ namespace pdf
         // ===== TRANSPARENCY & BLEND MODE =====
         double fillAlpha = 1.0;      // ca - fill alpha
         double strokeAlpha = 1.0;    // CA - stroke alpha
-        std::string blendMode = "/Normal";  // BM - blend mode
+        PdfBlendMode blendMode = PdfBlendMode::Normal;  // BM - blend mode
 
         // ===== SOFT MASK (SMask) =====
         bool hasSMask = false;       // true when SMask is active in this graphics state
@@ -0,0 +1,351 @@
+// =====================================================
+// PdfImagePyramid.cpp - Mip levels, trilinear sampler, cache
+// =====================================================
+
+#include "pch.h"
+#include "PdfImagePyramid.h"
+#include "PdfDebug.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// SSE2 sampler on x86/x64
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PDF_MIP_SIMD 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#define PDF_SSE2_TARGET
+#else
+#define PDF_SSE2_TARGET __attribute__((target("sse2")))
+#endif
+#else
+#define PDF_MIP_SIMD 0
+#endif
+
+namespace pdf
+{
+    // =====================================================
+    // sRGB <-> linear light, 16-bit linear
+    // =====================================================
+    static const uint16_t* srgbToLinearTable()
+    {
+        static const auto table = []()
+            {
+                std::vector<uint16_t> t(256);
+                for (int i = 0; i < 256; i++)
+                {
+                    const double c = i / 255.0;
+                    const double l = (c <= 0.04045) ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+                    t[i] = (uint16_t)std::lround(l * 65535.0);
+                }
+                return t;
+            }();
+        return table.data();
+    }
+
+    static const uint8_t* linearToSrgbTable()
+    {
+        static const auto table = []()
+            {
+                std::vector<uint8_t> t(65536);
+                for (int i = 0; i < 65536; i++)
+                {
+                    const double l = i / 65535.0;
+                    const double c = (l <= 0.0031308) ? l * 12.92 : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055;
+                    t[i] = (uint8_t)std::lround(std::clamp(c, 0.0, 1.0) * 255.0);
+                }
+                return t;
+            }();
+        return table.data();
+    }
+
+    // =====================================================
+    // Levels
+    // =====================================================
+
+    // One level from its parent: 2x2 blocks, the last row / column
+    // repeated when the parent size is odd
+    static void halveLevel(const uint8_t* src, int sw, int sh, uint8_t* dst, int dw, int dh)
+    {
+        const uint16_t* toLinear = srgbToLinearTable();
+        const uint8_t* toSrgb = linearToSrgbTable();
+
+        for (int y = 0; y < dh; y++)
+        {
+            const uint8_t* r0 = src + (size_t)std::min(2 * y, sh - 1) * sw * 4;
+            const uint8_t* r1 = src + (size_t)std::min(2 * y + 1, sh - 1) * sw * 4;
+            uint8_t* out = dst + (size_t)y * dw * 4;
+
+            for (int x = 0; x < dw; x++, out += 4)
+            {
+                const int x0 = 2 * x * 4;
+                const int x1 = std::min(2 * x + 1, sw - 1) * 4;
+                const uint8_t* p[4] = { r0 + x0, r0 + x1, r1 + x0, r1 + x1 };
+
+                const uint32_t sa = p[0][3] + p[1][3] + p[2][3] + p[3][3];
+                if (sa == 4 * 255 || sa == 0)
+                {
+                    // Opaque (or fully transparent): plain mean
+                    for (int c = 0; c < 3; c++)
+                    {
+                        const uint32_t sum = toLinear[p[0][c]] + toLinear[p[1][c]] + toLinear[p[2][c]] + toLinear[p[3][c]];
+                        out[c] = toSrgb[(sum + 2) >> 2];
+                    }
+                }
+                else
+                {
+                    // Colour weighted by alpha, so transparent pixels do not bleed
+                    for (int c = 0; c < 3; c++)
+                    {
+                        uint32_t sum = 0;
+                        for (int i = 0; i < 4; i++)
+                            sum += toLinear[p[i][c]] * p[i][3];
+                        out[c] = toSrgb[(sum + sa / 2) / sa];
+                    }
+                }
+                out[3] = (uint8_t)((sa + 2) >> 2);
+            }
+        }
+    }
+
+    PdfImagePyramid::PdfImagePyramid(const uint8_t* image, int w, int h)
+        : _w(std::max(w, 1)), _h(std::max(h, 1))
+    {
+        const uint8_t* parent = image;
+        int pw = _w, ph = _h;
+        while (image && (pw > 1 || ph > 1))
+        {
+            Level l;
+            l.w = (pw + 1) / 2;
+            l.h = (ph + 1) / 2;
+            l.pixels.resize((size_t)l.w * l.h * 4);
+            halveLevel(parent, pw, ph, l.pixels.data(), l.w, l.h);
+
+            _bytes += l.pixels.size();
+            _levels.push_back(std::move(l));
+            parent = _levels.back().pixels.data();
+            pw = _levels.back().w;
+            ph = _levels.back().h;
+        }
+    }
+
+    // =====================================================
+    // Sampler
+    // =====================================================
+    PdfMipSampler::PdfMipSampler(const PdfImagePyramid& pyramid, const uint8_t* image, double lod)
+    {
+        const int top = pyramid.levelCount() - 1;
+        lod = std::clamp(std::isfinite(lod) ? lod : 0.0, 0.0, (double)top);
+        const int fine = std::min((int)lod, top);
+        const int coarse = std::min(fine + 1, top);
+
+        auto ref = [&](int level) -> LevelRef
+            {
+                if (level == 0)
+                    return LevelRef{ image, pyramid._w, pyramid._h, 1.0 };
+                const auto& l = pyramid._levels[level - 1];
+                return LevelRef{ l.pixels.data(), l.w, l.h, std::ldexp(1.0, level) };
+            };
+        _fine = ref(fine);
+        _coarse = ref(coarse);
+        _levelWeight = (coarse == fine) ? 0 : (int)std::lround((lod - fine) * 256.0);
+    }
+
+    // The four texels around a level position and their weights /256
+    struct MipTaps
+    {
+        const uint8_t* p00;
+        const uint8_t* p01;
+        const uint8_t* p10;
+        const uint8_t* p11;
+        int wx, wy;
+    };
+
+    static inline int clampTexel(int v, int n)
+    {
+        return v < 0 ? 0 : (v >= n ? n - 1 : v);
+    }
+
+    template <typename LevelRef>
+    static inline MipTaps mipTaps(const LevelRef& l, double fx, double fy)
+    {
+        // Level-0 pixel centres -> this level's: (f + 0.5) / scale - 0.5
+        const double lx = std::clamp((fx + 0.5) / l.scale - 0.5, -1.0, (double)l.w);
+        const double ly = std::clamp((fy + 0.5) / l.scale - 0.5, -1.0, (double)l.h);
+        const int ix = (int)std::floor(lx);
+        const int iy = (int)std::floor(ly);
+
+        MipTaps t;
+        const int x0 = clampTexel(ix, l.w) * 4;
+        const int x1 = clampTexel(ix + 1, l.w) * 4;
+        const uint8_t* r0 = l.pixels + (size_t)clampTexel(iy, l.h) * l.w * 4;
+        const uint8_t* r1 = l.pixels + (size_t)clampTexel(iy + 1, l.h) * l.w * 4;
+        t.p00 = r0 + x0; t.p01 = r0 + x1;
+        t.p10 = r1 + x0; t.p11 = r1 + x1;
+        t.wx = (int)std::lround((lx - ix) * 256.0);
+        t.wy = (int)std::lround((ly - iy) * 256.0);
+        return t;
+    }
+
+    // lerp(a, b, w / 256), rounded; a, b <= 255 keep every step in 16 bits
+    static inline uint32_t lerp256(uint32_t a, uint32_t b, int w)
+    {
+        return (a * (256 - w) + b * w + 128) >> 8;
+    }
+
+    static inline void bilinearScalar(const MipTaps& t, uint32_t out[4])
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            const uint32_t left = lerp256(t.p00[c], t.p10[c], t.wy);
+            const uint32_t right = lerp256(t.p01[c], t.p11[c], t.wy);
+            out[c] = lerp256(left, right, t.wx);
+        }
+    }
+
+#if PDF_MIP_SIMD
+    PDF_SSE2_TARGET
+    static inline __m128i loadTexelPair(const uint8_t* a, const uint8_t* b)
+    {
+        uint32_t va, vb;
+        std::memcpy(&va, a, 4);
+        std::memcpy(&vb, b, 4);
+        return _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128((int)va), _mm_cvtsi32_si128((int)vb)),
+            _mm_setzero_si128());
+    }
+
+    // lanes 0..3 = lo * (256 - w) + hi * w for the halves of v, rounded /256
+    PDF_SSE2_TARGET
+    static inline __m128i lerpHalvesSse2(__m128i v, int w)
+    {
+        const __m128i weights = _mm_set_epi16((short)w, (short)w, (short)w, (short)w,
+            (short)(256 - w), (short)(256 - w), (short)(256 - w), (short)(256 - w));
+        __m128i m = _mm_mullo_epi16(v, weights);
+        m = _mm_add_epi16(m, _mm_srli_si128(m, 8));
+        return _mm_srli_epi16(_mm_add_epi16(m, _mm_set1_epi16(128)), 8);
+    }
+
+    // Four channels in the low 16-bit lanes
+    PDF_SSE2_TARGET
+    static inline __m128i bilinearSse2(const MipTaps& t)
+    {
+        const __m128i top = loadTexelPair(t.p00, t.p01);
+        const __m128i bottom = loadTexelPair(t.p10, t.p11);
+        const __m128i v = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(
+            _mm_mullo_epi16(top, _mm_set1_epi16((short)(256 - t.wy))),
+            _mm_mullo_epi16(bottom, _mm_set1_epi16((short)t.wy))),
+            _mm_set1_epi16(128)), 8);
+        return lerpHalvesSse2(v, t.wx);
+    }
+#endif
+
+    void PdfMipSampler::sample(double fx, double fy, uint8_t out[4]) const
+    {
+        const MipTaps a = mipTaps(_fine, fx, fy);
+#if PDF_MIP_SIMD
+        const __m128i va = bilinearSse2(a);
+        __m128i v = va;
+        if (_levelWeight != 0)
+        {
+            const __m128i vb = bilinearSse2(mipTaps(_coarse, fx, fy));
+            v = lerpHalvesSse2(_mm_unpacklo_epi64(va, vb), _levelWeight);
+        }
+        const uint32_t px = (uint32_t)_mm_cvtsi128_si32(_mm_packus_epi16(v, v));
+        std::memcpy(out, &px, 4);
+#else
+        uint32_t ca[4];
+        bilinearScalar(a, ca);
+        if (_levelWeight != 0)
+        {
+            uint32_t cb[4];
+            bilinearScalar(mipTaps(_coarse, fx, fy), cb);
+            for (int c = 0; c < 4; c++)
+                ca[c] = lerp256(ca[c], cb[c], _levelWeight);
+        }
+        for (int c = 0; c < 4; c++)
+            out[c] = (uint8_t)ca[c];
+#endif
+    }
+
+    // =====================================================
+    // Cache
+    // =====================================================
+    std::shared_ptr<const PdfImagePyramid> PdfImagePyramidCache::get(
+        const std::shared_ptr<const std::vector<uint8_t>>& image, int w, int h)
+    {
+        if (!image || w <= 0 || h <= 0 || image->size() < (size_t)w * h * 4)
+            return nullptr;
+
+        const void* key = image.get();
+        auto matches = [&](const Entry& e)
+            {
+                return e.image.lock() == image && e.pyramid->width() == w && e.pyramid->height() == h;
+            };
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (auto* e = _entries.find(key))
+            {
+                if (matches(*e))
+                {
+                    _hits++;
+                    return e->pyramid;
+                }
+                // The buffer was freed and its address reused
+                _entries.erase(key);
+            }
+            _misses++;
+        }
+
+        // Build without the lock: other pages keep rendering meanwhile
+        auto pyramid = std::make_shared<const PdfImagePyramid>(image->data(), w, h);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (auto* e = _entries.peek(key))
+        {
+            if (matches(*e))
+                return e->pyramid;  // another thread stored it first
+            _entries.erase(key);
+        }
+        if (pyramid->byteSize() > _budget)
+            return pyramid;
+
+        _entries.put(key, { image, pyramid }, pyramid->byteSize());
+        trim();
+
+        LogDebug("[PyramidCache] %dx%d, %d levels, %zu bytes (cache %zu pyramids, %zu bytes)",
+            w, h, pyramid->levelCount(), pyramid->byteSize(), _entries.size(), _entries.bytes());
+        return pyramid;
+    }
+
+    // Oldest first; entries of images that are gone cost bytes for nothing
+    void PdfImagePyramidCache::trim()
+    {
+        _entries.eraseIf([](const void*, const Entry& e) { return e.image.expired(); });
+        _entries.trim(_budget);
+    }
+
+    void PdfImagePyramidCache::setBudget(size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _budget = bytes;
+        trim();
+    }
+
+    void PdfImagePyramidCache::getStats(size_t& hits, size_t& misses, size_t& entries, size_t& bytes) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        hits = _hits;
+        misses = _misses;
+        entries = _entries.size();
+        bytes = _entries.bytes();
+    }
+
+    void PdfImagePyramidCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.clear();
+    }
+
+} // namespace pdf
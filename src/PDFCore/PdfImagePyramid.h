@@ -0,0 +1,128 @@
+#pragma once
+// =====================================================
+// PdfImagePyramid.h - Mip levels for downscaled image drawing
+// =====================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "PdfLruCache.h"
+
+namespace pdf
+{
+    // =====================================================
+    // PdfImagePyramid
+    // 2x box-filtered levels of one decoded image (4 bytes per pixel,
+    // colour in bytes 0..2, alpha in byte 3, not premultiplied). Level
+    // n is ceil(w / 2^n) x ceil(h / 2^n), down to 1x1; each pixel is the
+    // alpha-weighted mean of its 2x2 parent block in linear light.
+    // Level 0 is the image itself and is not copied: the caller passes
+    // it to the sampler, so a cached pyramid never keeps a decoded
+    // image alive.
+    // =====================================================
+    class PdfImagePyramid
+    {
+    public:
+        PdfImagePyramid(const uint8_t* image, int w, int h);
+
+        int width() const { return _w; }
+        int height() const { return _h; }
+
+        // Levels including level 0
+        int levelCount() const { return (int)_levels.size() + 1; }
+
+        // Bytes held (levels 1 and up)
+        size_t byteSize() const { return _bytes; }
+
+    private:
+        friend class PdfMipSampler;
+
+        struct Level
+        {
+            std::vector<uint8_t> pixels;
+            int w = 0, h = 0;
+        };
+
+        int _w, _h;
+        std::vector<Level> _levels;     // level 1 first
+        size_t _bytes = 0;
+    };
+
+    // =====================================================
+    // PdfMipSampler
+    // Trilinear lookup for one draw. lod = log2 of the level-0 pixels
+    // one device pixel spans; it is fixed for an affine draw, so the
+    // two levels and their blend weight are chosen once. Each level is
+    // sampled bilinearly and the two are blended, in 8-bit fixed point
+    // (weights /256, rounded); SSE2 on x86, scalar elsewhere, same
+    // bytes on both.
+    // =====================================================
+    class PdfMipSampler
+    {
+    public:
+        PdfMipSampler(const PdfImagePyramid& pyramid, const uint8_t* image, double lod);
+
+        // Pixel at level-0 position (fx, fy), pixel centres on integers
+        // (fx = s * (w - 1) as the image drawers compute it)
+        void sample(double fx, double fy, uint8_t out[4]) const;
+
+    private:
+        struct LevelRef
+        {
+            const uint8_t* pixels;
+            int w, h;
+            double scale;   // level-0 pixels per level pixel
+        };
+        LevelRef _fine, _coarse;
+        int _levelWeight;   // 0..256, share of _coarse
+    };
+
+    // =====================================================
+    // PdfImagePyramidCache
+    // Pyramids of decoded images, keyed by the shared pixel buffer the
+    // document's image cache and display lists hand out. An entry only
+    // holds a weak reference to that buffer, so it goes stale (and is
+    // rebuilt on the next lookup) once the image itself is dropped.
+    // LRU-bounded by bytes; safe to call from render threads.
+    // =====================================================
+    class PdfImagePyramidCache
+    {
+    public:
+        static PdfImagePyramidCache& instance()
+        {
+            static PdfImagePyramidCache inst;
+            return inst;
+        }
+
+        // Pyramid of image (w x h), built on the first lookup
+        std::shared_ptr<const PdfImagePyramid> get(
+            const std::shared_ptr<const std::vector<uint8_t>>& image, int w, int h);
+
+        void setBudget(size_t bytes);
+        void getStats(size_t& hits, size_t& misses, size_t& entries, size_t& bytes) const;
+        void clear();
+
+    private:
+        PdfImagePyramidCache() = default;
+
+        struct Entry
+        {
+            std::weak_ptr<const std::vector<uint8_t>> image;
+            std::shared_ptr<const PdfImagePyramid> pyramid;
+        };
+
+        static constexpr size_t PYRAMID_CACHE_BUDGET = 96 * 1024 * 1024;
+
+        void trim();
+
+        mutable std::mutex _mutex;
+        size_t _budget = PYRAMID_CACHE_BUDGET;
+        PdfLruCache<const void*, Entry> _entries;
+        size_t _hits = 0;
+        size_t _misses = 0;
+    };
+
+} // namespace pdf
@@ -0,0 +1,50 @@
+#include "pch.h"
+#include "PdfKeys.h"
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace pdf
+{
+    namespace
+    {
+        struct KeyTable
+        {
+            std::vector<std::string> names;                       // atom -> "/Key"
+            std::unordered_map<std::string_view, PdfAtom> atoms;  // "Key" -> atom
+
+            KeyTable()
+            {
+                names.resize(PdfKeys::Count_);
+#define PDF_KEY_NAME(k) names[PdfKeys::k] = "/" #k;
+                PDF_KEY_LIST(PDF_KEY_NAME)
+#undef PDF_KEY_NAME
+                atoms.reserve(PdfKeys::Count_);
+                for (PdfAtom a = 1; a < PdfKeys::Count_; a++)
+                    atoms.emplace(std::string_view(names[a]).substr(1), a);
+            }
+        };
+
+        const KeyTable& keyTable()
+        {
+            static const KeyTable table;
+            return table;
+        }
+    }
+
+    PdfAtom pdfKeyAtom(const char* key, size_t len)
+    {
+        if (len > 0 && key[0] == '/') { key++; len--; }
+        if (len == 0) return PdfNoAtom;
+
+        const auto& t = keyTable();
+        auto it = t.atoms.find(std::string_view(key, len));
+        return (it != t.atoms.end()) ? it->second : PdfNoAtom;
+    }
+
+    const std::string& pdfKeyName(PdfAtom atom)
+    {
+        const auto& t = keyTable();
+        return (atom < t.names.size()) ? t.names[atom] : t.names[PdfNoAtom];
+    }
+}
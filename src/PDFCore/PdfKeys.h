@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace pdf
+{
+    // ============================================
+    // DICTIONARY KEY ATOMS
+    // Keys the engine looks up by name have a fixed integer id. They are
+    // normalized once when a dictionary is built ("/Type" and "Type" are
+    // the same atom), so lookups compare integers instead of hashing
+    // strings and no longer need a second "no slash" probe.
+    // Keys outside this list (resource names like /F1, glyph names) keep
+    // their text. The table is static: no per-document state, no locking,
+    // and it cannot grow with untrusted input.
+    // ============================================
+    using PdfAtom = uint16_t;
+    static const PdfAtom PdfNoAtom = 0;
+
+#define PDF_KEY_LIST(X) \
+    X(A) X(Alternate) X(Annots) X(BaseEncoding) X(BaseFont) X(BBox) X(BitsPerComponent) \
+    X(BitsPerSample) X(BlackIs1) X(BM) X(Bounds) X(C0) X(C1) X(CA) X(ca) X(CF) \
+    X(CFM) X(CharProcs) X(CIDToGIDMap) X(Colors) X(ColorSpace) X(Columns) X(Contents) \
+    X(Coords) X(Count) X(CropBox) X(D) X(Decode) X(DecodeParms) X(DescendantFonts) \
+    X(Dest) X(Dests) X(Differences) X(Domain) X(DW) X(EarlyChange) X(Encode) \
+    X(EncodedByteAlign) X(Encoding) X(Encrypt) X(EncryptMetadata) X(EndOfLine) \
+    X(ExtGState) X(Filter) X(First) X(FirstChar) X(Font) X(FontDescriptor) X(FontFile) \
+    X(FontFile2) X(FontFile3) X(FontMatrix) X(Function) X(Functions) X(FunctionType) \
+    X(G) X(Group) X(Height) X(ID) X(ImageMask) X(Index) X(Info) X(Interpolate) \
+    X(JBIG2Globals) X(K) X(Kids) X(Lang) X(LC) X(Length) X(Limits) X(LJ) X(LW) \
+    X(Mask) X(Matrix) X(MediaBox) X(Metadata) X(MissingWidth) X(ML) X(N) X(Name) \
+    X(Names) X(O) X(OE) X(P) X(Pages) X(PaintType) X(Parent) X(Pattern) X(PatternType) \
+    X(Perms) X(Predictor) X(Prev) X(R) X(Range) X(Recipients) X(Rect) X(Resources) \
+    X(Root) X(Rotate) X(Rows) X(S) X(Shading) X(ShadingType) X(Size) X(SMask) \
+    X(StmF) X(SubFilter) X(Subtype) X(TilingType) X(ToUnicode) X(Type) X(U) \
+    X(UE) X(URI) X(V) X(W) X(Width) X(Widths) X(XObject) X(XRefStm) X(XStep) \
+    X(YStep)
+
+    namespace PdfKeys
+    {
+        enum : PdfAtom
+        {
+            None_ = PdfNoAtom,
+#define PDF_KEY_ENUM(k) k,
+            PDF_KEY_LIST(PDF_KEY_ENUM)
+#undef PDF_KEY_ENUM
+            Count_
+        };
+    }
+
+    // Atom for a key spelled with or without the leading '/', or PdfNoAtom
+    PdfAtom pdfKeyAtom(const char* key, size_t len);
+    inline PdfAtom pdfKeyAtom(const std::string& key) { return pdfKeyAtom(key.data(), key.size()); }
+
+    // Canonical spelling ("/Type") of a well-known key
+    const std::string& pdfKeyName(PdfAtom atom);
+}
@@ -2,10 +2,99 @@
 #include "PdfLexer.h"
 #include "PdfDebug.h"
 #include <cctype>
+#include <climits>
+#include <cstdlib>
 
 namespace pdf
 {
-    PdfLexer::PdfLexer(const std::vector<uint8_t>& data)
+    namespace
+    {
+        // Byte classes: C-locale isspace() and the delimiters that end a
+        // number, name or keyword. A table lookup instead of <cctype> calls.
+        enum : uint8_t { CC_SPACE = 1, CC_DELIM = 2, CC_DIGIT = 4, CC_HEX = 8 };
+
+        struct CharClass
+        {
+            uint8_t t[256] = {};
+            CharClass()
+            {
+                for (int c : { ' ', '\t', '\n', '\v', '\f', '\r' }) t[c] |= CC_SPACE;
+                for (int c : { '/', '(', ')', '<', '>', '[', ']' }) t[c] |= CC_DELIM;
+                for (int c = '0'; c <= '9'; c++) t[c] |= CC_DIGIT | CC_HEX;
+                for (int c = 'a'; c <= 'f'; c++) t[c] |= CC_HEX;
+                for (int c = 'A'; c <= 'F'; c++) t[c] |= CC_HEX;
+            }
+        };
+
+        const CharClass kCharClass;
+
+        inline bool isSpace(uint8_t c) { return (kCharClass.t[c] & CC_SPACE) != 0; }
+        inline bool isDigit(uint8_t c) { return (kCharClass.t[c] & CC_DIGIT) != 0; }
+        inline bool isHex(uint8_t c) { return (kCharClass.t[c] & CC_HEX) != 0; }
+        inline bool endsToken(uint8_t c) { return (kCharClass.t[c] & (CC_SPACE | CC_DELIM)) != 0; }
+
+        inline int hexVal(uint8_t ch)
+        {
+            if (ch >= '0' && ch <= '9') return ch - '0';
+            if (ch >= 'A' && ch <= 'F') return 10 + ch - 'A';
+            return 10 + ch - 'a';
+        }
+    }
+
+    // atof() of a lexed number without building a string. A mantissa up
+    // to 2^53 divided by an exact power of ten (<= 1e22) rounds the same
+    // way strtod does; anything longer falls back to strtod.
+    double pdfParseNumber(const char* p, size_t n)
+    {
+        static const double POW10[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        const uint64_t MAX_EXACT = (uint64_t)1 << 53;
+
+        size_t i = 0;
+        bool neg = false;
+        if (i < n && (p[i] == '+' || p[i] == '-')) { neg = (p[i] == '-'); i++; }
+
+        uint64_t mant = 0;
+        int fracDigits = 0;
+        bool any = false, exact = true, inFrac = false;
+        for (; i < n; i++)
+        {
+            uint8_t c = (uint8_t)p[i];
+            if (c == '.')
+            {
+                if (inFrac) break;      // atof stops at a second '.'
+                inFrac = true;
+                continue;
+            }
+            any = true;
+            if (mant > (MAX_EXACT - 9) / 10) { exact = false; break; }
+            mant = mant * 10 + (c - '0');
+            if (inFrac) fracDigits++;
+        }
+
+        if (!any) return 0.0;
+        if (!exact || fracDigits > 22)
+            return std::strtod(std::string(p, n).c_str(), nullptr);
+
+        double v = (double)mant;
+        if (fracDigits) v /= POW10[fracDigits];
+        return neg ? -v : v;
+    }
+
+    int Token::intValue() const
+    {
+        // std::atoi semantics: sign + leading digits
+        size_t i = 0;
+        bool neg = false;
+        if (i < text.size() && (text[i] == '+' || text[i] == '-')) { neg = (text[i] == '-'); i++; }
+        long long v = 0;
+        for (; i < text.size() && isDigit((uint8_t)text[i]); i++)
+            if (v <= INT_MAX) v = v * 10 + (text[i] - '0');
+        if (v > INT_MAX) v = INT_MAX;
+        return (int)(neg ? -v : v);
+    }
+    PdfLexer::PdfLexer(PdfByteView data)
         : _data(data)
         , _pos(0)
         , _hasPeek(false)
@@ -31,7 +120,7 @@ namespace pdf
                 while (_pos < _data.size() && _data[_pos] != '\n' && _data[_pos] != '\r')
                     ++_pos;
             }
-            else if (std::isspace(c))
+            else if (isSpace(c))
             {
                 ++_pos;
             }
@@ -42,7 +131,29 @@ namespace pdf
         }
     }
 
-    Token PdfLexer::peekToken()
+    bool PdfLexer::mayBeRefTail() const
+    {
+        if (_hasPeek)
+            return true;
+
+        size_t p = _pos;
+        auto skipSpaces = [&]() -> bool {
+            while (p < _data.size() && isSpace(_data[p])) ++p;
+            return p >= _data.size() || _data[p] != '%';   // yorum: kesin karar verme
+        };
+
+        if (!skipSpaces()) return true;
+        if (p >= _data.size()) return false;
+        unsigned char c = _data[p];
+        if (!(isDigit(c) || c == '+' || c == '-' || c == '.')) return false;
+        for (++p; p < _data.size() && (isDigit(_data[p]) || _data[p] == '.'); ++p) {}
+
+        if (!skipSpaces()) return true;
+        return p < _data.size() && _data[p] == 'R' &&
+            (p + 1 >= _data.size() || endsToken(_data[p + 1]));
+    }
+
+    const Token& PdfLexer::peekToken()
     {
         if (_hasPeek)
             return _peekToken;
@@ -57,21 +168,17 @@ namespace pdf
         if (_hasPeek)
         {
             _hasPeek = false;
-            return _peekToken;
+            return std::move(_peekToken);
         }
 
         skipWhitespace();
 
-        Token tok{};
-        tok.type = TokenType::EndOfFile;
-        tok.text.clear();
-
         if (_pos >= _data.size())
-            return tok;
+            return Token{};
 
         unsigned char c = _data[_pos];
 
-        if (std::isdigit(c) || c == '+' || c == '-' || c == '.')
+        if (isDigit(c) || c == '+' || c == '-' || c == '.')
             return readNumber();
 
         if (c == '/')
@@ -88,33 +195,26 @@ namespace pdf
     {
         Token tok;
         tok.type = TokenType::Number;
-        std::string s;
+        const size_t start = _pos;
 
         // GÜVENLİK: Sayılar aşırı uzun olamaz (Max 255 karakter)
         size_t limit = 0;
 
         unsigned char c = _data[_pos];
         if (c == '+' || c == '-' || c == '.')
-        {
-            s.push_back(c);
             ++_pos;
-        }
 
         while (_pos < _data.size() && limit++ < 255)
         {
             c = _data[_pos];
-            if (std::isdigit(c) || c == '.')
-            {
-                s.push_back(c);
+            if (isDigit(c) || c == '.')
                 ++_pos;
-            }
             else
-            {
                 break;
-            }
         }
 
-        tok.text = s;
+        tok.text = view(start, _pos);
+        tok.number = pdfParseNumber(tok.text.data(), tok.text.size());
         return tok;
     }
 
@@ -122,10 +222,9 @@ namespace pdf
     {
         Token tok;
         tok.type = TokenType::Name;
-        std::string s;
+        const size_t start = _pos;
 
         // Leading '/'
-        s.push_back('/');
         ++_pos;
 
         // GÜVENLİK: Binary veri okuyorsak sonsuz döngüye girmemeli (Max 1024 karakter)
@@ -133,17 +232,12 @@ namespace pdf
 
         while (_pos < _data.size() && limit++ < 1024)
         {
-            unsigned char c = _data[_pos];
-            if (std::isspace(c) || c == '/' || c == '(' || c == ')' ||
-                c == '<' || c == '>' || c == '[' || c == ']')
-            {
+            if (endsToken(_data[_pos]))
                 break;
-            }
-            s.push_back(static_cast<char>(c));
             ++_pos;
         }
 
-        tok.text = s;
+        tok.text = view(start, _pos);
         return tok;
     }
 
@@ -155,7 +249,7 @@ namespace pdf
     {
         Token tok;
         tok.type = TokenType::String;
-        std::string s;
+        std::string& s = tok.value;
 
         ++_pos;
         int depth = 1;
@@ -253,7 +347,6 @@ namespace pdf
             }
         }
 
-        tok.text = s;
         return tok;
     }
 
@@ -265,58 +358,36 @@ namespace pdf
     {
         Token tok;
         tok.type = TokenType::HexString;
-        std::string hexChars;
+        std::string& result = tok.value;
 
         ++_pos; // '<' karakterini atla
 
         size_t limit = 0;
         const size_t MAX_HEX_LEN = 131072; // 128KB hex = 64KB binary
 
+        int hi = -1;
         while (_pos < _data.size() && limit++ < MAX_HEX_LEN)
         {
-            unsigned char c = _data[_pos];
+            unsigned char c = _data[_pos++];
             if (c == '>')
-            {
-                ++_pos;
                 break;
-            }
-            if (std::isspace(c))
-            {
-                ++_pos;
-                continue; // whitespace ignored in hex strings
-            }
-            if (std::isxdigit(c))
-            {
-                hexChars.push_back(static_cast<char>(c));
-                ++_pos;
-            }
+            if (!isHex(c))
+                continue; // whitespace ignored, invalid hex char skipped
+
+            // Hex → binary bytes
+            if (hi < 0)
+                hi = hexVal(c);
             else
             {
-                // Invalid hex char — skip
-                ++_pos;
+                result.push_back(static_cast<char>((hi << 4) | hexVal(c)));
+                hi = -1;
             }
         }
 
         // Tek sayıda hex digit varsa sonuna 0 ekle (PDF spec)
-        if (hexChars.size() % 2 != 0)
-            hexChars.push_back('0');
-
-        // Hex → binary bytes
-        std::string result;
-        for (size_t i = 0; i + 1 < hexChars.size(); i += 2)
-        {
-            char hi = hexChars[i];
-            char lo = hexChars[i + 1];
-            auto hexVal = [](char ch) -> int {
-                if (ch >= '0' && ch <= '9') return ch - '0';
-                if (ch >= 'A' && ch <= 'F') return 10 + ch - 'A';
-                if (ch >= 'a' && ch <= 'f') return 10 + ch - 'a';
-                return 0;
-            };
-            result.push_back(static_cast<char>((hexVal(hi) << 4) | hexVal(lo)));
-        }
+        if (hi >= 0)
+            result.push_back(static_cast<char>(hi << 4));
 
-        tok.text = result;
         return tok;
     }
 
@@ -364,30 +435,25 @@ namespace pdf
         if (c == '[' || c == ']')
         {
             tok.type = TokenType::Delimiter;
-            tok.text = std::string(1, static_cast<char>(c));
+            tok.text = view(_pos, _pos + 1);
             ++_pos;
             return tok;
         }
 
         // Diğer her şey: Keyword
         tok.type = TokenType::Keyword;
-        std::string s;
+        const size_t start = _pos;
 
         // Keyword'ler genelde kısadır
         size_t limit = 0;
         while (_pos < _data.size() && limit++ < 255)
         {
-            c = _data[_pos];
-            if (std::isspace(c) || c == '/' || c == '(' || c == ')' ||
-                c == '<' || c == '>' || c == '[' || c == ']')
-            {
+            if (endsToken(_data[_pos]))
                 break;
-            }
-            s.push_back(static_cast<char>(c));
             ++_pos;
         }
 
-        tok.text = s;
+        tok.text = view(start, _pos);
         return tok;
     }
 }
\ No newline at end of file
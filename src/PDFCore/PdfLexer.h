@@ -2,7 +2,9 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <cstdint>
+#include "PdfBytes.h"
 
 namespace pdf
 {
@@ -17,30 +19,51 @@ namespace pdf
         Delimiter
     };
 
+    // Number text ([+-]digits[.digits], as lexed) to double without building
+    // a string; same result as atof. Shared with the content stream parser.
+    double pdfParseNumber(const char* p, size_t n);
+
+    // Tokens do not own their bytes: text is a view into the lexer input
+    // (valid as long as the document data). Only String/HexString tokens,
+    // whose bytes must be unescaped, carry an owned copy in value.
     struct Token
     {
         TokenType type{ TokenType::EndOfFile };
-        std::string text;
+        std::string_view text;      // raw token (number, name with '/', keyword, delimiter)
+        std::string value;          // decoded String / HexString bytes
+        double number = 0.0;        // Number: parsed while lexing
+
+        int intValue() const;       // Number as int (atoi semantics)
     };
 
     class PdfLexer
     {
     public:
-        PdfLexer(const std::vector<uint8_t>& data);
+        PdfLexer(PdfByteView data);
 
         Token nextToken();
-        Token peekToken();
+        const Token& peekToken();
+
+        // Cheap byte-level check for a "G R" tail after a number. false means
+        // the next tokens are certainly not an indirect reference, so the
+        // parser can skip lexing them and rewinding.
+        bool mayBeRefTail() const;
 
         void setPosition(size_t pos);
         size_t getPosition() const { return _pos; }
 
     private:
-        const std::vector<uint8_t>& _data;
+        PdfByteView _data;
         size_t _pos{ 0 };
 
         bool _hasPeek{ false };
         Token _peekToken;
 
+        std::string_view view(size_t from, size_t to) const
+        {
+            return std::string_view(reinterpret_cast<const char*>(_data.data()) + from, to - from);
+        }
+
         void skipWhitespace();
         Token readNumber();
         Token readName();
@@ -0,0 +1,121 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <utility>
+
+namespace pdf
+{
+    // ============================================
+    // LRU CACHE
+    // Map + recency list shared by the engine's byte-budgeted caches
+    // (ObjStm buffers, display lists, compiled forms, decoded images,
+    // image pyramids). Each entry keeps its position in the list, so a
+    // hit moves it to the front with splice in O(1) instead of searching
+    // the list. Entries carry their byte size; the owner decides the
+    // budget and when to trim. Not thread-safe: callers hold their lock.
+    // ============================================
+    template<class K, class V>
+    class PdfLruCache
+    {
+    public:
+        // Entry for key, marked most recently used; nullptr if absent
+        V* find(const K& key)
+        {
+            auto it = _map.find(key);
+            if (it == _map.end()) return nullptr;
+            _order.splice(_order.begin(), _order, it->second.pos);
+            return &it->second.value;
+        }
+
+        // Same, without touching the recency order
+        V* peek(const K& key)
+        {
+            auto it = _map.find(key);
+            return (it != _map.end()) ? &it->second.value : nullptr;
+        }
+
+        bool contains(const K& key) const { return _map.count(key) != 0; }
+
+        // Adds or replaces the entry for key as the most recently used
+        V& put(const K& key, V value, size_t bytes)
+        {
+            auto it = _map.find(key);
+            if (it != _map.end())
+            {
+                _bytes -= it->second.bytes;
+                it->second.value = std::move(value);
+                it->second.bytes = bytes;
+                _order.splice(_order.begin(), _order, it->second.pos);
+            }
+            else
+            {
+                _order.push_front(key);
+                it = _map.emplace(key, Entry{ std::move(value), bytes, _order.begin() }).first;
+            }
+            _bytes += bytes;
+            return it->second.value;
+        }
+
+        bool erase(const K& key)
+        {
+            auto it = _map.find(key);
+            if (it == _map.end()) return false;
+            erase(it);
+            return true;
+        }
+
+        // Drops every entry for which pred(key, value) holds
+        template<class Pred>
+        void eraseIf(Pred pred)
+        {
+            for (auto it = _map.begin(); it != _map.end();)
+            {
+                auto next = std::next(it);
+                if (pred(it->first, it->second.value))
+                    erase(it);
+                it = next;
+            }
+        }
+
+        // Drops least recently used entries while over budget or over
+        // maxEntries, but never below keep entries
+        void trim(size_t budget, size_t maxEntries = SIZE_MAX, size_t keep = 0)
+        {
+            while (_map.size() > keep && (_bytes > budget || _map.size() > maxEntries))
+                erase(_map.find(_order.back()));
+        }
+
+        void clear()
+        {
+            _map.clear();
+            _order.clear();
+            _bytes = 0;
+        }
+
+        size_t size() const { return _map.size(); }
+        bool empty() const { return _map.empty(); }
+        size_t bytes() const { return _bytes; }
+
+    private:
+        struct Entry
+        {
+            V value;
+            size_t bytes;
+            typename std::list<K>::iterator pos;
+        };
+
+        void erase(typename std::map<K, Entry>::iterator it)
+        {
+            _bytes -= it->second.bytes;
+            _order.erase(it->second.pos);
+            _map.erase(it);
+        }
+
+        std::map<K, Entry> _map;
+        std::list<K> _order;    // front = most recently used
+        size_t _bytes = 0;
+    };
+
+} // namespace pdf
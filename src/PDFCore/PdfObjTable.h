@@ -0,0 +1,219 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pdf
+{
+    // ============================================
+    // OBJECT TABLE
+    // Map keyed by PDF object number. Object numbers are dense in practice
+    // (1..trailer /Size), so entries live in a vector indexed by number;
+    // numbers far beyond the populated range (pathological sparse files)
+    // spill into an ordered map instead of growing the vector.
+    // Iteration is in ascending object number, like the std::map it replaces,
+    // but inserting during iteration is not safe: a new entry can grow the
+    // dense part, which moves sparse entries and reallocates the slots.
+    // Do not add entries (e.g. resolve an indirect object) inside a loop
+    // over the table; collect what you need first.
+    // Object numbers are >= 0; a negative one (corrupt xref subsection
+    // or ObjStm header, "-3 0 obj" in a repair scan) is not stored, so
+    // the sparse map only holds numbers past the dense part and iteration
+    // stays ascending.
+    // ============================================
+    template<class T>
+    class PdfObjTable
+    {
+    public:
+        // Hard cap on the dense part (slots, not entries)
+        static constexpr int MAX_DENSE = 1 << 23;
+
+        // Expected highest object number + 1 (trailer /Size)
+        void reserve(int size)
+        {
+            _sizeHint = std::max(_sizeHint, std::min(size, MAX_DENSE));
+        }
+
+        T* find(int objNum)
+        {
+            if (objNum < 0)
+                return nullptr;
+            if (objNum < (int)_dense.size())
+                return _dense[objNum].used ? &_dense[objNum].value : nullptr;
+            auto it = _sparse.find(objNum);
+            return (it != _sparse.end()) ? &it->second : nullptr;
+        }
+
+        const T* find(int objNum) const { return const_cast<PdfObjTable*>(this)->find(objNum); }
+        size_t count(int objNum) const { return find(objNum) ? 1 : 0; }
+
+        // For objNum < 0 the reference is to a scratch value that is not
+        // part of the table: the write is dropped and find() stays null
+        T& operator[](int objNum)
+        {
+            if (objNum < 0)
+            {
+                _rejected = T();
+                return _rejected;
+            }
+            if (T* v = find(objNum)) return *v;
+
+            _size++;
+            if (objNum < denseLimit())
+            {
+                if (objNum >= (int)_dense.size())
+                    growDense(objNum + 1);
+                Slot& s = _dense[objNum];
+                s.used = true;
+                return s.value;
+            }
+            return _sparse[objNum];
+        }
+
+        bool erase(int objNum)
+        {
+            if (objNum < 0)
+                return false;
+            if (objNum < (int)_dense.size())
+            {
+                Slot& s = _dense[objNum];
+                if (!s.used) return false;
+                s.used = false;
+                s.value = T();
+                _size--;
+                return true;
+            }
+            if (!_sparse.erase(objNum)) return false;
+            _size--;
+            return true;
+        }
+
+        void clear()
+        {
+            _dense.clear();
+            _dense.shrink_to_fit();
+            _sparse.clear();
+            _size = 0;
+            _sizeHint = 0;
+        }
+
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+        // ---- ascending iteration: dense slots, then the sparse tail ----
+        template<bool Const>
+        class Iter
+        {
+        public:
+            using Table = typename std::conditional<Const, const PdfObjTable, PdfObjTable>::type;
+            using Ref = typename std::conditional<Const, const T&, T&>::type;
+            struct Value { int first; Ref second; };
+
+            Iter(Table* t, size_t i, typename std::conditional<Const,
+                typename std::map<int, T>::const_iterator, typename std::map<int, T>::iterator>::type s)
+                : _t(t), _i(i), _s(s) { skip(); }
+
+            Value operator*() const
+            {
+                if (_i < _t->_dense.size()) return { (int)_i, _t->_dense[_i].value };
+                return { _s->first, _s->second };
+            }
+
+            Iter& operator++()
+            {
+                if (_i < _t->_dense.size()) { _i++; skip(); }
+                else ++_s;
+                return *this;
+            }
+
+            bool operator!=(const Iter& o) const { return _i != o._i || _s != o._s; }
+
+        private:
+            void skip() { while (_i < _t->_dense.size() && !_t->_dense[_i].used) _i++; }
+
+            Table* _t;
+            size_t _i;
+            typename std::conditional<Const,
+                typename std::map<int, T>::const_iterator, typename std::map<int, T>::iterator>::type _s;
+        };
+
+        Iter<false> begin() { return Iter<false>(this, 0, _sparse.begin()); }
+        Iter<false> end() { return Iter<false>(this, _dense.size(), _sparse.end()); }
+        Iter<true> begin() const { return Iter<true>(this, 0, _sparse.begin()); }
+        Iter<true> end() const { return Iter<true>(this, _dense.size(), _sparse.end()); }
+
+    private:
+        struct Slot
+        {
+            T value{};
+            bool used = false;
+        };
+
+        // Numbers up to the trailer /Size, or twice the entry count when the
+        // file lied about /Size (repair scan), stay dense
+        int denseLimit() const
+        {
+            size_t byCount = 2 * _size + 1024;
+            return std::min(MAX_DENSE, std::max(_sizeHint, (int)std::min<size_t>(byCount, MAX_DENSE)));
+        }
+
+        void growDense(int n)
+        {
+            size_t newSize = std::max<size_t>((size_t)n, _dense.size() + _dense.size() / 2);
+            newSize = std::min<size_t>(newSize, (size_t)denseLimit());
+            _dense.resize(newSize);
+
+            // Sparse entries now covered by the vector move over, so the
+            // sparse map only ever holds numbers >= _dense.size()
+            auto it = _sparse.begin();
+            while (it != _sparse.end() && it->first < (int)newSize)
+            {
+                Slot& s = _dense[it->first];
+                s.value = std::move(it->second);
+                s.used = true;
+                it = _sparse.erase(it);
+            }
+        }
+
+        std::vector<Slot> _dense;
+        std::map<int, T> _sparse;
+        T _rejected{};                  // operator[] target for objNum < 0
+        size_t _size = 0;
+        int _sizeHint = 0;
+    };
+
+    // ============================================
+    // VISITED REFS
+    // Cycle guard for resolveIndirect. Reference chains are a link or two
+    // long and resolveIndirect gives up past 100, so a fixed array on the
+    // caller's stack replaces the std::set it used to allocate per call.
+    // ============================================
+    class PdfVisitedRefs
+    {
+    public:
+        static constexpr int CAPACITY = 128;
+
+        size_t count(int objNum) const
+        {
+            for (int i = 0; i < _n; i++)
+                if (_ids[i] == objNum) return 1;
+            return 0;
+        }
+
+        void insert(int objNum)
+        {
+            if (_n < CAPACITY && !count(objNum))
+                _ids[_n++] = objNum;
+        }
+
+        size_t size() const { return (size_t)_n; }
+        void clear() { _n = 0; }
+
+    private:
+        int _ids[CAPACITY];
+        int _n = 0;
+    };
+}
@@ -1,13 +1,18 @@
 #pragma once
+#include <algorithm>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 #include <memory>
-#include <unordered_map>
+#include "PdfBytes.h"
+#include "PdfKeys.h"
 
 namespace pdf
 {
     // PDF objesi trleri
-    enum class PdfObjectType
+    enum class PdfObjectType : uint8_t
     {
         Null,
         Boolean,
@@ -25,67 +30,221 @@ namespace pdf
     {
     public:
         virtual ~PdfObject() = default;
-        virtual PdfObjectType type() const = 0;
+
+        // The tag lives in the object itself: type() and pdfCast<> need
+        // neither a virtual call nor RTTI.
+        PdfObjectType type() const { return _type; }
+
+    protected:
+        explicit PdfObject(PdfObjectType t) : _type(t) {}
+
+    private:
+        PdfObjectType _type;
     };
 
     // ---- Null ----
     class PdfNull : public PdfObject
     {
     public:
-        PdfObjectType type() const override { return PdfObjectType::Null; }
+        static constexpr PdfObjectType Type = PdfObjectType::Null;
+        PdfNull() : PdfObject(Type) {}
     };
 
     // ---- Boolean ----
     class PdfBoolean : public PdfObject
     {
     public:
+        static constexpr PdfObjectType Type = PdfObjectType::Boolean;
         bool value;
-        PdfBoolean(bool v) : value(v) {}
-        PdfObjectType type() const override { return PdfObjectType::Boolean; }
+        PdfBoolean(bool v) : PdfObject(Type), value(v) {}
     };
 
     // ---- Number ----
     class PdfNumber : public PdfObject
     {
     public:
+        static constexpr PdfObjectType Type = PdfObjectType::Number;
         double value;
-        PdfNumber(double v) : value(v) {}
-        PdfObjectType type() const override { return PdfObjectType::Number; }
+        PdfNumber(double v) : PdfObject(Type), value(v) {}
     };
 
     // ---- String ----
     class PdfString : public PdfObject
     {
     public:
+        static constexpr PdfObjectType Type = PdfObjectType::String;
         std::string value;
-        PdfString(const std::string& v) : value(v) {}
-        PdfObjectType type() const override { return PdfObjectType::String; }
+        PdfString(const std::string& v) : PdfObject(Type), value(v) {}
+        PdfString(std::string&& v) : PdfObject(Type), value(std::move(v)) {}
     };
 
     // ---- Name ----  (r: /Type, /Catalog)
     class PdfName : public PdfObject
     {
     public:
-        std::string value;
-        PdfName(const std::string& v) : value(v) {}
-        PdfObjectType type() const override { return PdfObjectType::Name; }
+        static constexpr PdfObjectType Type = PdfObjectType::Name;
+        std::string value;   // always spelled with the leading '/'
+        PdfName(const std::string& v) : PdfObject(Type), value(v) { normalize(); }
+        PdfName(std::string&& v) : PdfObject(Type), value(std::move(v)) { normalize(); }
+
+    private:
+        void normalize() { if (value.empty() || value[0] != '/') value.insert(value.begin(), '/'); }
     };
 
     // ---- Array ----
     class PdfArray : public PdfObject
     {
     public:
+        static constexpr PdfObjectType Type = PdfObjectType::Array;
         std::vector<std::shared_ptr<PdfObject>> items;
-        PdfObjectType type() const override { return PdfObjectType::Array; }
+        PdfArray() : PdfObject(Type) {}
+    };
+
+    // ---- Dictionary key ----
+    // Well-known keys are stored as an atom (see PdfKeys.h); anything else
+    // keeps its text, always with the leading '/'.
+    class PdfKey
+    {
+    public:
+        PdfKey() = default;
+        PdfKey(PdfAtom atom) : _atom(atom) {}
+        explicit PdfKey(std::string_view key) : _atom(pdfKeyAtom(key.data(), key.size()))
+        {
+            if (_atom == PdfNoAtom)
+            {
+                if (key.empty() || key[0] != '/') _text = "/";
+                _text.append(key.data(), key.size());
+            }
+        }
+
+        PdfAtom atom() const { return _atom; }
+        const std::string& str() const { return _atom != PdfNoAtom ? pdfKeyName(_atom) : _text; }
+        const char* c_str() const { return str().c_str(); }
+
+        // Atoms first (by id), then text keys (by text)
+        int compare(PdfAtom atom, const std::string* text) const
+        {
+            if (_atom != atom) return (_atom == PdfNoAtom) ? 1 : (atom == PdfNoAtom ? -1 : (_atom < atom ? -1 : 1));
+            return (atom != PdfNoAtom || !text) ? 0 : _text.compare(*text);
+        }
+
+        bool operator==(const PdfKey& o) const { return compare(o._atom, &o._text) == 0; }
+        bool operator!=(const PdfKey& o) const { return !(*this == o); }
+        bool operator<(const PdfKey& o) const { return compare(o._atom, &o._text) < 0; }
+
+    private:
+        std::string _text;
+        PdfAtom _atom = PdfNoAtom;
+    };
+
+    // ---- Dictionary entries ----
+    // Flat vector sorted by key instead of a node-based hash map. Typical
+    // PDF dictionaries hold a handful of keys, so one contiguous block is
+    // both smaller and faster to search than buckets + one node per key.
+    // Keeps the subset of the std::map interface the code base uses;
+    // string lookups accept keys with or without the leading '/'.
+    class PdfDictEntries
+    {
+    public:
+        using value_type = std::pair<PdfKey, std::shared_ptr<PdfObject>>;
+        using iterator = std::vector<value_type>::iterator;
+        using const_iterator = std::vector<value_type>::const_iterator;
+
+        iterator begin() { return _items.begin(); }
+        iterator end() { return _items.end(); }
+        const_iterator begin() const { return _items.begin(); }
+        const_iterator end() const { return _items.end(); }
+        size_t size() const { return _items.size(); }
+        bool empty() const { return _items.empty(); }
+        void clear() { _items.clear(); }
+
+        iterator find(PdfAtom atom) { return atom != PdfNoAtom ? findKey(atom, nullptr) : _items.end(); }
+        const_iterator find(PdfAtom atom) const { return const_cast<PdfDictEntries*>(this)->find(atom); }
+
+        iterator find(const std::string& key)
+        {
+            PdfAtom atom = pdfKeyAtom(key);
+            if (atom != PdfNoAtom) return findKey(atom, nullptr);
+            if (!key.empty() && key[0] == '/') return findKey(PdfNoAtom, &key);
+            std::string slashed = "/" + key;
+            return findKey(PdfNoAtom, &slashed);
+        }
+
+        const_iterator find(const std::string& key) const
+        {
+            return const_cast<PdfDictEntries*>(this)->find(key);
+        }
+
+        template <class K>
+        size_t count(const K& key) const { return find(key) != end() ? 1 : 0; }
+
+        std::shared_ptr<PdfObject>& operator[](const PdfKey& key)
+        {
+            auto it = std::lower_bound(_items.begin(), _items.end(), key,
+                [](const value_type& a, const PdfKey& k) { return a.first < k; });
+            if (it == _items.end() || it->first != key)
+                it = _items.insert(it, value_type(key, nullptr));
+            return it->second;
+        }
+
+        std::shared_ptr<PdfObject>& operator[](const std::string& key) { return (*this)[PdfKey(key)]; }
+        std::shared_ptr<PdfObject>& operator[](PdfAtom atom) { return (*this)[PdfKey(atom)]; }
+
+        template <class K>
+        size_t erase(const K& key)
+        {
+            auto it = find(key);
+            if (it == _items.end()) return 0;
+            _items.erase(it);
+            return 1;
+        }
+
+        // Bulk load in file order (parser): one sort instead of N inserts.
+        // Duplicate keys keep the last value, like repeated operator[].
+        void assign(std::vector<value_type>&& items)
+        {
+            _items = std::move(items);
+            std::stable_sort(_items.begin(), _items.end(),
+                [](const value_type& a, const value_type& b) { return a.first < b.first; });
+            auto out = _items.begin();
+            for (auto it = _items.begin(); it != _items.end(); ++it)
+            {
+                auto next = it + 1;
+                if (next != _items.end() && next->first == it->first)
+                    continue;
+                if (out != it) *out = std::move(*it);
+                ++out;
+            }
+            _items.erase(out, _items.end());
+            _items.shrink_to_fit();
+        }
+
+    private:
+        iterator findKey(PdfAtom atom, const std::string* text)
+        {
+            // Small dictionaries: a linear scan beats binary search
+            if (_items.size() <= 8)
+            {
+                for (auto it = _items.begin(); it != _items.end(); ++it)
+                    if (it->first.compare(atom, text) == 0) return it;
+                return _items.end();
+            }
+            auto it = std::lower_bound(_items.begin(), _items.end(), 0,
+                [&](const value_type& a, int) { return a.first.compare(atom, text) < 0; });
+            return (it != _items.end() && it->first.compare(atom, text) == 0) ? it : _items.end();
+        }
+
+        std::vector<value_type> _items;
     };
 
     // ---- Dictionary ----
     class PdfDictionary : public PdfObject
     {
     public:
-        std::unordered_map<std::string, std::shared_ptr<PdfObject>> entries;
+        static constexpr PdfObjectType Type = PdfObjectType::Dictionary;
+        PdfDictEntries entries;
 
-        PdfObjectType type() const override { return PdfObjectType::Dictionary; }
+        PdfDictionary() : PdfObject(Type) {}
 
         std::shared_ptr<PdfObject> get(const std::string& key) const
         {
@@ -94,32 +253,62 @@ namespace pdf
                 return it->second;
             return nullptr;
         }
+
+        std::shared_ptr<PdfObject> get(PdfAtom key) const
+        {
+            auto it = entries.find(key);
+            if (it != entries.end())
+                return it->second;
+            return nullptr;
+        }
     };
 
     // ---- Stream ----
     class PdfStream : public PdfObject
     {
     public:
+        static constexpr PdfObjectType Type = PdfObjectType::Stream;
         std::shared_ptr<PdfDictionary> dict;
-        std::vector<uint8_t> data; // raw stream bytes
+        PdfBytes data; // raw stream bytes (slice of the document or owned)
 
-        PdfStream(std::shared_ptr<PdfDictionary> d, std::vector<uint8_t> bytes)
-            : dict(std::move(d)), data(std::move(bytes)) {
-        }
+        // Encrypted documents: data still holds ciphertext until the
+        // document decrypts it on first use with the (objNum, genNum) key
+        bool encrypted = false;
+        int objNum = 0;
+        int genNum = 0;
 
-        PdfObjectType type() const override { return PdfObjectType::Stream; }
+        PdfStream(std::shared_ptr<PdfDictionary> d, PdfBytes bytes)
+            : PdfObject(Type), dict(std::move(d)), data(std::move(bytes)) {
+        }
     };
 
     // ---- Indirect Reference ----
     class PdfIndirectRef : public PdfObject
     {
     public:
+        static constexpr PdfObjectType Type = PdfObjectType::IndirectRef;
         int objNum;
         int genNum;
 
-        PdfIndirectRef(int o, int g) : objNum(o), genNum(g) {}
-        PdfObjectType type() const override { return PdfObjectType::IndirectRef; }
+        PdfIndirectRef(int o, int g) : PdfObject(Type), objNum(o), genNum(g) {}
     };
 
     using PdfObjectPtr = std::shared_ptr<PdfObject>;
+
+    // Tag-checked downcast; drop-in for std::dynamic_pointer_cast on PDF
+    // objects (nullptr on null input or type mismatch) without RTTI.
+    template <class T, class U>
+    inline std::shared_ptr<T> pdfCast(const std::shared_ptr<U>& obj)
+    {
+        if (!obj || obj->type() != T::Type)
+            return nullptr;
+        return std::static_pointer_cast<T>(std::static_pointer_cast<PdfObject>(obj));
+    }
+
+    // Shared immutable scalars. null/true/false and small integers are the
+    // most common values in a document; the parser hands out one object per
+    // value instead of allocating each occurrence. Never modify them.
+    const PdfObjectPtr& pdfNullObject();
+    const PdfObjectPtr& pdfBooleanObject(bool v);
+    PdfObjectPtr pdfNumberObject(double v);
 }
@@ -6,16 +6,20 @@
 #endif
 
 #include "PdfPainter.h"
+#include "PdfDownsample.h"
+#include "PdfSpan.h"
 #include "PdfPath.h"
 #include "PdfDebug.h"
+#include "PdfTrace.h"
 #include "PdfGraphicsState.h"
 #include "PdfContentParser.h"
 #include "GlyphCache.h"
 #include "FontCache.h"
-#include <windows.h>
+#include "PdfPlatform.h"
 #include <algorithm>
 #include <cstring>
 #include <cmath>
+#include <mutex>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
@@ -35,54 +39,37 @@ namespace pdf
     static FT_Library g_fallbackFTLib = nullptr;
     static FT_Face g_fallbackFace = nullptr;
     static bool g_fallbackInitialized = false;
+    static std::mutex g_fallbackMutex;
 
     static FT_Face getFallbackFace()
     {
+        std::lock_guard<std::mutex> lock(g_fallbackMutex);
         if (!g_fallbackInitialized)
         {
             g_fallbackInitialized = true;
 
-            // DEBUG LOG
-            FILE* dbgFile = nullptr; // fopen("C:\\temp\\fallback_debug.txt", "w");
-            if (dbgFile) {
-                fprintf(dbgFile, "=== Initializing fallback font ===\n");
-                fflush(dbgFile);
-            }
-
             if (FT_Init_FreeType(&g_fallbackFTLib) == 0)
             {
-                if (dbgFile) {
-                    fprintf(dbgFile, "FreeType initialized OK\n");
-                    fflush(dbgFile);
-                }
-
-                // Windows sistem fontlarını dene
+                // Sistem fontlarını dene
                 const char* fallbackFonts[] = {
-                    "C:\\Windows\\Fonts\\arial.ttf",
-                    "C:\\Windows\\Fonts\\segoeui.ttf",
-                    "C:\\Windows\\Fonts\\tahoma.ttf",
-                    "C:\\Windows\\Fonts\\calibri.ttf",
+                    "arial.ttf",
+                    "segoeui.ttf",
+                    "tahoma.ttf",
+                    "calibri.ttf",
                     nullptr
                 };
 
                 for (int i = 0; fallbackFonts[i] != nullptr; ++i)
                 {
-                    if (dbgFile) {
-                        fprintf(dbgFile, "Trying: %s\n", fallbackFonts[i]);
-                        fflush(dbgFile);
-                    }
+                    std::string fontPath = platform::systemFontPath(fallbackFonts[i]);
+                    if (fontPath.empty()) continue;
 
-                    FT_Error err = FT_New_Face(g_fallbackFTLib, fallbackFonts[i], 0, &g_fallbackFace);
+                    FT_Error err = FT_New_Face(g_fallbackFTLib, fontPath.c_str(), 0, &g_fallbackFace);
                     if (err == 0)
                     {
-                        if (dbgFile) {
-                            fprintf(dbgFile, "SUCCESS! Loaded: %s\n", fallbackFonts[i]);
-                            fprintf(dbgFile, "Face family: %s, style: %s\n",
-                                g_fallbackFace->family_name ? g_fallbackFace->family_name : "(null)",
-                                g_fallbackFace->style_name ? g_fallbackFace->style_name : "(null)");
-                            fprintf(dbgFile, "num_charmaps: %d\n", g_fallbackFace->num_charmaps);
-                            fflush(dbgFile);
-                        }
+                        PDF_TRACE(Text, "fallbackFace", "%s (%s %s)", fontPath.c_str(),
+                            g_fallbackFace->family_name ? g_fallbackFace->family_name : "?",
+                            g_fallbackFace->style_name ? g_fallbackFace->style_name : "?");
 
                         // Başarılı - Unicode charmap seç
                         for (int cm = 0; cm < g_fallbackFace->num_charmaps; ++cm)
@@ -90,36 +77,14 @@ namespace pdf
                             if (g_fallbackFace->charmaps[cm]->encoding == FT_ENCODING_UNICODE)
                             {
                                 FT_Set_Charmap(g_fallbackFace, g_fallbackFace->charmaps[cm]);
-                                if (dbgFile) {
-                                    fprintf(dbgFile, "Unicode charmap selected (index %d)\n", cm);
-                                    fflush(dbgFile);
-                                }
                                 break;
                             }
                         }
                         break;
                     }
-                    else
-                    {
-                        if (dbgFile) {
-                            fprintf(dbgFile, "FAILED with error: %d\n", err);
-                            fflush(dbgFile);
-                        }
-                    }
-                }
-            }
-            else
-            {
-                if (dbgFile) {
-                    fprintf(dbgFile, "FreeType init FAILED\n");
-                    fflush(dbgFile);
+                    PDF_TRACE(Text, "fallbackFace", "%s failed, FT error %d", fontPath.c_str(), err);
                 }
             }
-
-            if (dbgFile) {
-                fprintf(dbgFile, "Final g_fallbackFace: %p\n", (void*)g_fallbackFace);
-                fclose(dbgFile);
-            }
         }
         return g_fallbackFace;
     }
@@ -280,122 +245,23 @@ namespace pdf
         if (_ssaa <= 1)
             return _buffer;
 
-        std::vector<uint8_t> output(_finalW * _finalH * 4);
-
-        // ✅ Bilinear downsampling (daha pürüzsüz)
-        for (int y = 0; y < _finalH; ++y)
-        {
-            for (int x = 0; x < _finalW; ++x)
-            {
-                // SSAA grid'deki merkez pozisyon
-                float centerX = (x + 0.5f) * _ssaa;
-                float centerY = (y + 0.5f) * _ssaa;
-
-                // Bilinear filter kernel (gaussian-like)
-                float rSum = 0, gSum = 0, bSum = 0, aSum = 0;
-                float weightSum = 0;
-
-                // SSAA grid üzerinde weighted sampling
-                for (int dy = 0; dy < _ssaa; ++dy)
-                {
-                    for (int dx = 0; dx < _ssaa; ++dx)
-                    {
-                        int sx = x * _ssaa + dx;
-                        int sy = y * _ssaa + dy;
-
-                        if (sx >= _w || sy >= _h) continue;
-
-                        // Mesafeye göre weight (Gaussian-like)
-                        float distX = (sx + 0.5f) - centerX;
-                        float distY = (sy + 0.5f) - centerY;
-                        float distSq = distX * distX + distY * distY;
-
-                        // Gaussian kernel (sigma = _ssaa/2)
-                        float sigma = _ssaa * 0.5f;
-                        float weight = std::exp(-distSq / (2.0f * sigma * sigma));
-
-                        size_t si = (size_t(sy) * _w + sx) * 4;
-
-                        bSum += _buffer[si + 0] * weight;
-                        gSum += _buffer[si + 1] * weight;
-                        rSum += _buffer[si + 2] * weight;
-                        aSum += _buffer[si + 3] * weight;
-                        weightSum += weight;
-                    }
-                }
-
-                if (weightSum > 0)
-                {
-                    size_t di = (size_t(y) * _finalW + x) * 4;
-                    output[di + 0] = (uint8_t)std::clamp((int)(bSum / weightSum), 0, 255);
-                    output[di + 1] = (uint8_t)std::clamp((int)(gSum / weightSum), 0, 255);
-                    output[di + 2] = (uint8_t)std::clamp((int)(rSum / weightSum), 0, 255);
-                    output[di + 3] = (uint8_t)std::clamp((int)(aSum / weightSum), 0, 255);
-                }
-            }
-        }
-
+        std::vector<uint8_t> output((size_t)_finalW * _finalH * 4);
+        getDownsampledBufferDirect(output.data(), (int)output.size());
         return output;
     }
 
-    bool PdfPainter::getDownsampledBufferDirect(uint8_t* outBuffer, int outBufferSize) const
+    // Gaussian-weighted SSAA downsample (ayrılabilir çekirdek, PdfDownsample)
+    bool PdfPainter::getDownsampledBufferDirect(uint8_t* outBuffer, int outBufferSize, int outStride) const
     {
-        const int required = _finalW * _finalH * 4;
-        if (!outBuffer || outBufferSize < required) return false;
-
-        if (_ssaa <= 1)
-        {
-            if ((int)_buffer.size() < required) return false;
-            std::memcpy(outBuffer, _buffer.data(), required);
-            return true;
-        }
-
-        // Bilinear downsampling directly into outBuffer
-        for (int y = 0; y < _finalH; ++y)
-        {
-            for (int x = 0; x < _finalW; ++x)
-            {
-                float centerX = (x + 0.5f) * _ssaa;
-                float centerY = (y + 0.5f) * _ssaa;
-
-                float rSum = 0, gSum = 0, bSum = 0, aSum = 0;
-                float weightSum = 0;
-
-                for (int dy = 0; dy < _ssaa; ++dy)
-                {
-                    for (int dx = 0; dx < _ssaa; ++dx)
-                    {
-                        int sx = x * _ssaa + dx;
-                        int sy = y * _ssaa + dy;
-                        if (sx >= _w || sy >= _h) continue;
-
-                        float distX = (sx + 0.5f) - centerX;
-                        float distY = (sy + 0.5f) - centerY;
-                        float distSq = distX * distX + distY * distY;
-                        float sigma = _ssaa * 0.5f;
-                        float weight = std::exp(-distSq / (2.0f * sigma * sigma));
-
-                        size_t si = (size_t(sy) * _w + sx) * 4;
-                        bSum += _buffer[si + 0] * weight;
-                        gSum += _buffer[si + 1] * weight;
-                        rSum += _buffer[si + 2] * weight;
-                        aSum += _buffer[si + 3] * weight;
-                        weightSum += weight;
-                    }
-                }
+        const size_t rowBytes = (size_t)_finalW * 4;
+        const size_t stride = outStride > 0 ? (size_t)outStride : rowBytes;
+        if (!outBuffer || _finalW <= 0 || _finalH <= 0 || stride < rowBytes) return false;
 
-                if (weightSum > 0)
-                {
-                    size_t di = (size_t(y) * _finalW + x) * 4;
-                    outBuffer[di + 0] = (uint8_t)std::clamp((int)(bSum / weightSum), 0, 255);
-                    outBuffer[di + 1] = (uint8_t)std::clamp((int)(gSum / weightSum), 0, 255);
-                    outBuffer[di + 2] = (uint8_t)std::clamp((int)(rSum / weightSum), 0, 255);
-                    outBuffer[di + 3] = (uint8_t)std::clamp((int)(aSum / weightSum), 0, 255);
-                }
-            }
-        }
+        const size_t required = stride * (_finalH - 1) + rowBytes;
+        if (outBufferSize < 0 || (size_t)outBufferSize < required) return false;
+        if (_buffer.size() < (size_t)_w * _h * 4 || _w < _finalW * _ssaa || _h < _finalH * _ssaa) return false;
 
-        return true;
+        return downsampleSsaa(_buffer.data(), (size_t)_w * 4, _ssaa, outBuffer, stride, _finalW, _finalH);
     }
 
 
@@ -661,31 +527,8 @@ namespace pdf
         double textAngle
     )
     {
-        // DEBUG: Her text çağrısını logla
-        {
-            static FILE* dbgFile = nullptr;
-            if (!dbgFile) {
-                dbgFile = fopen("C:\\temp\\text_debug.txt", "w");
-            }
-            if (dbgFile) {
-                fprintf(dbgFile, "=== drawTextFreeTypeRaw ===\n");
-                fprintf(dbgFile, "Font: %s, encoding: %s\n",
-                    font ? font->baseFont.c_str() : "(null)",
-                    font ? font->encoding.c_str() : "(null)");
-                fprintf(dbgFile, "isCidFont: %d, hasSimpleMap: %d\n",
-                    (font && font->isCidFont) ? 1 : 0,
-                    (font && font->hasSimpleMap) ? 1 : 0);
-                fprintf(dbgFile, "ftReady: %d, ftFace: %p\n",
-                    (font && font->ftReady) ? 1 : 0,
-                    font ? (void*)font->ftFace : nullptr);
-                fprintf(dbgFile, "Raw bytes (%zu): ", raw.size());
-                for (size_t i = 0; i < raw.size() && i < 50; i++) {
-                    fprintf(dbgFile, "%02X ", (unsigned char)raw[i]);
-                }
-                fprintf(dbgFile, "\n");
-                fflush(dbgFile);
-            }
-        }
+        PDF_TRACE_SCOPE(Text, "drawTextFreeTypeRaw", "%s, %zu bytes, cid=%d",
+            font ? font->baseFont.c_str() : "(null)", raw.size(), (font && font->isCidFont) ? 1 : 0);
 
         // Type3 font: use width table only for advance, skip FreeType rendering
         // (CPU painter renders Type3 glyphs via CharProc content streams when called from GPU path)
@@ -726,6 +569,10 @@ namespace pdf
 
         FT_Face face = font->ftFace;
 
+        // The face is shared through FontCache; the run owns it until return
+        std::lock_guard<std::recursive_mutex> faceLock(freeTypeFaceMutex(face));
+        std::unique_lock<std::recursive_mutex> fallbackLock;
+
         // Font size -> px
         double pxSize = fontSizePt * _scaleY;
         FT_Set_Char_Size(face, 0, (FT_F26Dot6)std::llround(pxSize * 64.0), 72, 72);
@@ -788,64 +635,12 @@ namespace pdf
 
         const bool cidMode = isCidFontActivePainter(font);
 
-        // DEBUG: cidMode kontrolü
-        {
-            static FILE* dbgFile = nullptr;
-            if (!dbgFile) dbgFile = nullptr; // fopen("C:\\temp\\text_debug.txt", "a");
-            if (dbgFile) {
-                fprintf(dbgFile, "=== FONT DEBUG ===\n");
-                fprintf(dbgFile, "baseFont='%s'\n", font->baseFont.c_str());
-                fprintf(dbgFile, "encoding='%s'\n", font->encoding.c_str());
-                fprintf(dbgFile, "isCidFont=%d\n", font->isCidFont ? 1 : 0);
-                fprintf(dbgFile, "cidMode=%d\n", cidMode ? 1 : 0);
-                fprintf(dbgFile, "fontProgram.size=%zu\n", font->fontProgram.size());
-                fprintf(dbgFile, "cidToUnicode.size=%zu\n", font->cidToUnicode.size());
-                fprintf(dbgFile, "hasCidToGidMap=%d, cidToGidIdentity=%d\n",
-                    font->hasCidToGidMap ? 1 : 0, font->cidToGidIdentity ? 1 : 0);
-                fprintf(dbgFile, "raw.size=%zu, raw(hex): ", raw.size());
-                for (size_t ii = 0; ii < raw.size() && ii < 40; ii++) {
-                    fprintf(dbgFile, "%02X ", (unsigned char)raw[ii]);
-                }
-                fprintf(dbgFile, "\n");
-                fflush(dbgFile);
-                fprintf(dbgFile, "cidMode=%d, fontProgram.size=%zu, encoding='%s'\n",
-                    cidMode ? 1 : 0, font->fontProgram.size(), font->encoding.c_str());
-                fprintf(dbgFile, "Entering loop, raw.size=%zu\n", raw.size());
-                fflush(dbgFile);
-            }
-        }
-
         if (cidMode)
         {
-            // DEBUG: CID branch'a girdik
-            {
-                static FILE* dbgFile = nullptr;
-                if (!dbgFile) dbgFile = nullptr; // fopen("C:\\temp\\text_debug.txt", "a");
-                if (dbgFile) {
-                    fprintf(dbgFile, "CID branch entered\n");
-                    fflush(dbgFile);
-                }
-            }
-
-            // DEBUG: CID font bilgilerini logla
-            {
-                static FILE* cidDbg = nullptr;
-                static bool firstTime = true;
-                if (firstTime) {
-                    cidDbg = fopen("C:\\temp\\cid_debug.txt", "w");
-                    firstTime = false;
-                }
-                if (cidDbg) {
-                    fprintf(cidDbg, "=== CID Font Debug ===\n");
-                    fprintf(cidDbg, "fontName: %s\n", font->baseFont.c_str());
-                    fprintf(cidDbg, "fontProgram.empty: %d\n", font->fontProgram.empty() ? 1 : 0);
-                    fprintf(cidDbg, "cidToUnicode.size: %zu\n", font->cidToUnicode.size());
-                    fprintf(cidDbg, "hasCidToGidMap: %d\n", font->hasCidToGidMap ? 1 : 0);
-                    fprintf(cidDbg, "cidToGidIdentity: %d\n", font->cidToGidIdentity ? 1 : 0);
-                    fprintf(cidDbg, "raw.size: %zu\n", raw.size());
-                    fflush(cidDbg);
-                }
-            }
+            PDF_TRACE(Text, "cidRun", "%s: %zu codes, embedded=%d, toUnicode=%zu, cidToGid=%s",
+                font->baseFont.c_str(), raw.size() / 2, font->fontProgram.empty() ? 0 : 1,
+                font->cidToUnicode.size(),
+                !font->hasCidToGidMap ? "none" : (font->cidToGidIdentity ? "identity" : "table"));
 
             for (size_t i = 0; i + 1 < raw.size(); i += 2)
             {
@@ -886,16 +681,8 @@ namespace pdf
                     }
                 }
 
-                // DEBUG: Her karakter icin log
-                {
-                    static FILE* cidDbg = fopen("C:\\temp\\cid_debug.txt", "a");
-                    if (cidDbg) {
-                        char ch = (unicodeVal >= 32 && unicodeVal < 127) ? (char)unicodeVal : '?';
-                        fprintf(cidDbg, "CID=0x%04X -> unicode=0x%04X ('%c') -> GID=%u, usedToUnicode=%d\n",
-                            cid, unicodeVal, ch, gid, usedToUnicode ? 1 : 0);
-                        fflush(cidDbg);
-                    }
-                }
+                PDF_TRACE(Text, "cidGlyph", "cid=0x%04X unicode=0x%04X gid=%u viaToUnicode=%d",
+                    cid, unicodeVal, gid, usedToUnicode ? 1 : 0);
 
                 auto [penX, penY] = setPenSubpixelTransform(penX26, penY26);
 
@@ -908,7 +695,7 @@ namespace pdf
                     double scaleCorrection = pxSize / (double)pixelSize;
                     // Use fontHash for cache key (stable across font reloads)
                     size_t fontHash = font->fontHash > 0 ? font->fontHash : reinterpret_cast<size_t>(face);
-                    const CachedGlyph* cached = GlyphCache::instance().getOrRender(face, fontHash, gid, pixelSize);
+                    std::shared_ptr<const CachedGlyph> cached = GlyphCache::instance().getOrRender(face, fontHash, gid, pixelSize);
 
                     if (cached && !cached->bitmap.empty())
                     {
@@ -980,16 +767,6 @@ namespace pdf
         }
         else
         {
-            // DEBUG: else branch'a girdik
-            {
-                static FILE* dbgFile = nullptr;
-                if (!dbgFile) dbgFile = nullptr; // fopen("C:\\temp\\text_debug.txt", "a");
-                if (dbgFile) {
-                    fprintf(dbgFile, "ELSE branch entered (non-CID mode)\n");
-                    fflush(dbgFile);
-                }
-            }
-
             for (unsigned char c : raw)
             {
                 int code = (int)c;
@@ -1070,16 +847,6 @@ namespace pdf
                     }
                 }
 
-                // DEBUG: gi sonucunu logla
-                {
-                    static FILE* dbgFile = nullptr;
-                    if (!dbgFile) dbgFile = nullptr; // fopen("C:\\temp\\text_debug.txt", "a");
-                    if (dbgFile) {
-                        fprintf(dbgFile, ", gi=%u\n", gi);
-                        fflush(dbgFile);
-                    }
-                }
-
                 auto [penX, penY] = setPenSubpixelTransform(penX26, penY26);
 
                 // Glyph'i render et - bulunamazsa fallback font dene
@@ -1089,28 +856,8 @@ namespace pdf
                 // Embedded fontta glyph bulunamadıysa fallback font dene
                 if (gi == 0)
                 {
-                    // DEBUG LOG
-                    {
-                        static FILE* dbgFile = nullptr;
-                        if (!dbgFile) dbgFile = nullptr; // fopen("C:\\temp\\fallback_debug.txt", "w");
-                        if (dbgFile) {
-                            fprintf(dbgFile, "Glyph not found: code=%d (0x%02X), char='%c'\n", code, code, (code >= 32 && code < 127) ? code : '?');
-                            fflush(dbgFile);
-                        }
-                    }
-
                     FT_Face fallback = getFallbackFace();
 
-                    // DEBUG LOG
-                    {
-                        static FILE* dbgFile = nullptr;
-                        if (!dbgFile) dbgFile = nullptr; // fopen("C:\\temp\\fallback_debug.txt", "a");
-                        if (dbgFile) {
-                            fprintf(dbgFile, "  Fallback face: %p\n", (void*)fallback);
-                            fflush(dbgFile);
-                        }
-                    }
-
                     if (fallback)
                     {
                         // Unicode değerini hesapla (fallback için)
@@ -1123,33 +870,19 @@ namespace pdf
                         }
                         fallbackUni = FixTurkish(fallbackUni);
 
-                        // DEBUG LOG
-                        {
-                            static FILE* dbgFile = nullptr;
-                            if (!dbgFile) dbgFile = nullptr; // fopen("C:\\temp\\fallback_debug.txt", "a");
-                            if (dbgFile) {
-                                fprintf(dbgFile, "  fallbackUni=0x%04X, hasSimpleMap=%d\n", fallbackUni, font->hasSimpleMap ? 1 : 0);
-                                fflush(dbgFile);
-                            }
-                        }
-
                         if (fallbackUni != 0)
                         {
+                            if (!fallbackLock.owns_lock())
+                                fallbackLock = std::unique_lock<std::recursive_mutex>(freeTypeFaceMutex(fallback));
+
                             // Fallback font'un boyutunu ayarla
                             FT_Set_Char_Size(fallback, 0, (FT_F26Dot6)std::llround(pxSize * 64.0), 72, 72);
                             FT_Set_Transform(fallback, &ftm, nullptr);
 
                             renderGi = FT_Get_Char_Index(fallback, (FT_ULong)fallbackUni);
 
-                            // DEBUG LOG
-                            {
-                                static FILE* dbgFile = nullptr;
-                                if (!dbgFile) dbgFile = nullptr; // fopen("C:\\temp\\fallback_debug.txt", "a");
-                                if (dbgFile) {
-                                    fprintf(dbgFile, "  renderGi from fallback=%u\n", renderGi);
-                                    fflush(dbgFile);
-                                }
-                            }
+                            PDF_TRACE(Text, "fallbackGlyph", "code=0x%02X unicode=0x%04X gid=%u",
+                                code, fallbackUni, renderGi);
 
                             if (renderGi != 0)
                             {
@@ -1161,18 +894,6 @@ namespace pdf
 
                 double advPx = getAdvancePx(code);  // default: PDF width'ten
 
-                // ========== RENDER DEBUG ==========
-                static FILE* renderDebug = nullptr;
-                if (!renderDebug) {
-                    renderDebug = nullptr; // fopen("C:\\temp\\render_debug.txt", "w");
-                    if (renderDebug) {
-                        fprintf(renderDebug, "=== CHARACTER RENDER DEBUG ===\n");
-                        fprintf(renderDebug, "Format: code(hex) -> gid -> penX,penY -> char\n\n");
-                        fflush(renderDebug);
-                    }
-                }
-                // ========== END DEBUG ==========
-
                 // 🚀 GLYPH CACHE - Massive performance boost!
                 if (renderGi != 0)
                 {
@@ -1183,7 +904,7 @@ namespace pdf
                     size_t fontHash = (renderFace == face && font->fontHash > 0)
                         ? font->fontHash
                         : reinterpret_cast<size_t>(renderFace);
-                    const CachedGlyph* cached = GlyphCache::instance().getOrRender(renderFace, fontHash, renderGi, pixelSize);
+                    std::shared_ptr<const CachedGlyph> cached = GlyphCache::instance().getOrRender(renderFace, fontHash, renderGi, pixelSize);
 
                     if (cached && !cached->bitmap.empty())
                     {
@@ -1215,27 +936,8 @@ namespace pdf
                             gy = penY - (int)std::round(scaledBearingY);
                         }
 
-                        // ========== RENDER DEBUG ==========
-                        if (renderDebug) {
-                            uint32_t uniForLog = 0;
-                            if (font->hasSimpleMap && font->codeToUnicode[c] != 0) {
-                                uniForLog = font->codeToUnicode[c];
-                            }
-                            else {
-                                uniForLog = WinAnsi[c];
-                            }
-                            char displayChar = '?';
-                            if (uniForLog >= 32 && uniForLog < 127) {
-                                displayChar = (char)uniForLog;
-                            }
-                            else if (code >= 32 && code < 127) {
-                                displayChar = (char)code;
-                            }
-                            fprintf(renderDebug, "DRAW: code=%3d(0x%02X) gid=%3u pos=(%4d,%4d) adv=%.1f uni=0x%04X char='%c'\n",
-                                code, code, renderGi, gx, gy, advPx, uniForLog, displayChar);
-                            fflush(renderDebug);
-                        }
-                        // ========== END DEBUG ==========
+                        PDF_TRACE(Text, "glyph", "code=0x%02X gid=%u at (%d,%d) adv=%.1f",
+                            code, renderGi, gx, gy, advPx);
 
                         double scaleCorrX = scaleCorrection * horzCompress;  // X: with compression
                         double scaleCorrY = scaleCorrection;                 // Y: no compression
@@ -1257,18 +959,8 @@ namespace pdf
                         }
                     }
                 }
-                else if (renderDebug) {
-                    // Glyph bulunamadı
-                    uint32_t uniForLog = 0;
-                    if (font->hasSimpleMap && font->codeToUnicode[c] != 0) {
-                        uniForLog = font->codeToUnicode[c];
-                    }
-                    else {
-                        uniForLog = WinAnsi[c];
-                    }
-                    fprintf(renderDebug, "SKIP: code=%3d(0x%02X) gid=%3u (glyph not found or load failed) uni=0x%04X\n",
-                        code, code, renderGi, uniForLog);
-                    fflush(renderDebug);
+                else {
+                    PDF_TRACE(Text, "missingGlyph", "code=0x%02X gid=%u", code, renderGi);
                 }
 
                 if (hasTextRotation) {
@@ -1304,39 +996,9 @@ namespace pdf
     {
         if (!src) return;
 
-        uint8_t cr = (color >> 16) & 0xFF;
-        uint8_t cg = (color >> 8) & 0xFF;
-        uint8_t cb = (color) & 0xFF;
-
+        // Glyph coverage rows; colour alpha is the fill alpha
         for (int y = 0; y < h; ++y)
-        {
-            int py = dstY + y;
-            if (py < 0 || py >= _h) continue;
-
-            const uint8_t* row = src + y * srcPitch;
-
-            for (int x = 0; x < w; ++x)
-            {
-                int px = dstX + x;
-                if (px < 0 || px >= _w) continue;
-
-                uint8_t a = row[x];
-                if (a == 0) continue;
-
-                size_t di = (size_t(py) * _w + px) * 4;
-
-                uint8_t db = _buffer[di + 0];
-                uint8_t dg = _buffer[di + 1];
-                uint8_t dr = _buffer[di + 2];
-
-                int ia = 255 - a;
-
-                _buffer[di + 0] = (uint8_t)((cb * a + db * ia) / 255);
-                _buffer[di + 1] = (uint8_t)((cg * a + dg * ia) / 255);
-                _buffer[di + 2] = (uint8_t)((cr * a + dr * ia) / 255);
-                _buffer[di + 3] = 255;
-            }
-        }
+            fillSpan(dstY + y, dstX, dstX + w, color, src + y * srcPitch);
     }
 
     static inline int clampi(int v, int lo, int hi)
@@ -1346,6 +1008,38 @@ namespace pdf
         return v;
     }
 
+    // ExtGState alpha (0..1) as compositor opacity
+    static inline uint8_t alphaByte(float alpha)
+    {
+        return (uint8_t)std::lround(std::clamp(alpha, 0.0f, 1.0f) * 255.0f);
+    }
+
+    // One sampled pixel into a compositeRow source row: BGRA, colour
+    // premultiplied by a (all channels 0..255, truncated as before)
+    static inline void storeSourcePixel(uint8_t* p, double r, double g, double b, double a)
+    {
+        const uint32_t ia = (uint32_t)a;
+        if (ia == 0) return;
+        auto mul = [ia](double c) -> uint8_t
+            {
+                const uint32_t t = (uint32_t)c * ia + 128;
+                return (uint8_t)((t + (t >> 8)) >> 8);
+            };
+        p[0] = mul(b);
+        p[1] = mul(g);
+        p[2] = mul(r);
+        p[3] = (uint8_t)ia;
+    }
+
+    // Scratch row for compositeRow sources, at least count pixels
+    uint8_t* PdfPainter::sourceRow(int count)
+    {
+        const size_t bytes = (size_t)std::max(count, 1) * 4;
+        if (_sourceRow.size() < bytes)
+            _sourceRow.resize(bytes);
+        return _sourceRow.data();
+    }
+
     static inline uint8_t clampu8(int v)
     {
         if (v < 0) return 0;
@@ -1402,6 +1096,7 @@ namespace pdf
         if (_scaleY <= 0.0) _scaleY = 1.0;
 
         _buffer.resize((size_t)_w * (size_t)_h * 4, 255);
+        _pageH = _h;
 
         _hasRotate = false;
         _rotA = _rotD = 1.0;
@@ -1413,6 +1108,38 @@ namespace pdf
     // ---------------------------------------------------------
     // IMAGE DRAW
     // ---------------------------------------------------------
+
+    // Image pixels one device pixel spans, as a mip level: log2 of the
+    // longer of the two device steps mapped into the image (inv = page
+    // -> unit square; fx = s * (imgW - 1) as the drawers sample)
+    static double imageLod(const PdfMatrix& inv, int imgW, int imgH, double scaleX, double scaleY)
+    {
+        const double sx = (double)(imgW - 1), sy = (double)(imgH - 1);
+        const double stepX = std::hypot(inv.a / scaleX * sx, inv.b / scaleX * sy);
+        const double stepY = std::hypot(inv.c / scaleY * sx, inv.d / scaleY * sy);
+        const double footprint = std::max(stepX, stepY);
+        return footprint > 0.0 ? std::log2(footprint) : 0.0;
+    }
+
+    std::unique_ptr<PdfMipSampler> PdfPainter::mipSampler(const std::vector<uint8_t>& rgba, int imgW, int imgH,
+        const PdfMatrix& inv, std::shared_ptr<const PdfImagePyramid>& pyramid)
+    {
+        // The announcement covers this draw only
+        const std::shared_ptr<const std::vector<uint8_t>> shared = std::move(_sharedImage);
+
+        const double lod = imageLod(inv, imgW, imgH, _scaleX, _scaleY);
+        if (!(lod > 0.0) || imgW < 2 || imgH < 2)
+            return nullptr;
+
+        if (shared && shared.get() == &rgba)
+            pyramid = PdfImagePyramidCache::instance().get(shared, imgW, imgH);
+        if (!pyramid)
+            pyramid = std::make_shared<const PdfImagePyramid>(rgba.data(), imgW, imgH);
+
+        PDF_TRACE(Image, "mip", "%dx%d lod %.2f, %d levels", imgW, imgH, lod, pyramid->levelCount());
+        return std::make_unique<PdfMipSampler>(*pyramid, rgba.data(), lod);
+    }
+
     void PdfPainter::drawImage(
         const std::vector<uint8_t>& rgba,
         int imgW,
@@ -1468,6 +1195,9 @@ namespace pdf
             return;
         }
 
+        std::shared_ptr<const PdfImagePyramid> pyramid;
+        const std::unique_ptr<PdfMipSampler> mip = mipSampler(rgba, imgW, imgH, useInv, pyramid);
+
         // Compute bounding box in page space (4 koseyi transform et)
         double ux0, uy0, ux1, uy1, ux2, uy2, ux3, uy3;
         ApplyMatrix(useCTM, 0, 0, ux0, uy0);
@@ -1483,8 +1213,8 @@ namespace pdf
         // Convert to device coordinates
         int minDx = clampi((int)std::floor(minUx * _scaleX), 0, _w - 1);
         int maxDx = clampi((int)std::ceil(maxUx * _scaleX), 0, _w - 1);
-        int minDy = clampi((int)std::floor(_h - maxUy * _scaleY), 0, _h - 1);
-        int maxDy = clampi((int)std::ceil(_h - minUy * _scaleY), 0, _h - 1);
+        int minDy = clampi((int)std::floor(mapY(maxUy * _scaleY)), _originY, _originY + _h - 1);
+        int maxDy = clampi((int)std::ceil(mapY(minUy * _scaleY)), _originY, _originY + _h - 1);
 
         LogDebug("drawImage: page bounds (%.1f,%.1f)-(%.1f,%.1f) -> device (%d,%d)-(%d,%d)",
             minUx, minUy, maxUx, maxUy, minDx, minDy, maxDx, maxDy);
@@ -1502,14 +1232,18 @@ namespace pdf
                 : ((1.055 * std::pow(c, 1.0 / 2.4) - 0.055) * 255.0);
             };
 
+        const uint8_t imageAlpha = alphaByte(alpha);
+        uint8_t* row = sourceRow(maxDx - minDx + 1);
+
         // Sample each device pixel
         for (int py = minDy; py <= maxDy; ++py)
         {
+            std::memset(row, 0, (size_t)(maxDx - minDx + 1) * 4);
             for (int px = minDx; px <= maxDx; ++px)
             {
                 // Device -> page coordinates
                 double ux = (double)px / _scaleX;
-                double uy = ((double)_h - py) / _scaleY;
+                double uy = ((double)_pageH - py) / _scaleY;
 
                 // Page -> unit square (inverse CTM)
                 double s, t;
@@ -1525,6 +1259,14 @@ namespace pdf
                 double fx = s * (imgW - 1);
                 double fy = t * (imgH - 1);
 
+                // Küçültülmüş image: mip pyramid'den trilinear
+                if (mip) {
+                    uint8_t texel[4];
+                    mip->sample(fx, fy, texel);
+                    storeSourcePixel(row + (size_t)(px - minDx) * 4, texel[0], texel[1], texel[2], texel[3]);
+                    continue;
+                }
+
                 // =====================================================
                 // BICUBIC INTERPOLATION (Catmull-Rom spline)
                 // Daha keskin sonuç verir, özellikle text içeren imagelarda
@@ -1584,43 +1326,13 @@ namespace pdf
                 int nearestY = std::clamp((int)std::round(fy), 0, imgH - 1);
                 out[3] = rgba[(nearestY * imgW + nearestX) * 4 + 3] / 255.0;
 
-                // Output pixel
-                size_t di = (size_t(py) * _w + px) * 4;
-
-                uint8_t srcR = (uint8_t)linearToSrgb(out[0]);
-                uint8_t srcG = (uint8_t)linearToSrgb(out[1]);
-                uint8_t srcB = (uint8_t)linearToSrgb(out[2]);
-                uint8_t srcA = (uint8_t)(out[3] * 255.0);
-
-                // Apply ExtGState alpha (ca parameter)
-                if (alpha < 1.0f)
-                    srcA = (uint8_t)(srcA * alpha);
-
-                // Tamamen şeffaf pikselleri atla
-                if (srcA == 0)
-                    continue;
-
-                // Alpha blending uygula
-                if (srcA < 255)
-                {
-                    uint8_t dstB = _buffer[di + 0];
-                    uint8_t dstG = _buffer[di + 1];
-                    uint8_t dstR = _buffer[di + 2];
-
-                    int a = srcA;
-                    int invA = 255 - a;
-
-                    srcR = (uint8_t)((srcR * a + dstR * invA) / 255);
-                    srcG = (uint8_t)((srcG * a + dstG * invA) / 255);
-                    srcB = (uint8_t)((srcB * a + dstB * invA) / 255);
-                }
-
-                // Write BGRA
-                _buffer[di + 0] = srcB;
-                _buffer[di + 1] = srcG;
-                _buffer[di + 2] = srcR;
-                _buffer[di + 3] = 255;
+                // Output pixel (premultiplied)
+                storeSourcePixel(row + (size_t)(px - minDx) * 4,
+                    linearToSrgb(out[0]), linearToSrgb(out[1]), linearToSrgb(out[2]), out[3] * 255.0);
             }
+
+            // ExtGState alpha (ca) ve blend mode compositor'da
+            compositeRow(py, minDx, maxDx + 1, row, imageAlpha);
         }
     }
 
@@ -1663,8 +1375,8 @@ namespace pdf
         // Convert to device coordinates
         int minDx = clampi((int)std::floor(minUx * _scaleX), 0, _w - 1);
         int maxDx = clampi((int)std::ceil(maxUx * _scaleX), 0, _w - 1);
-        int minDy = clampi((int)std::floor(_h - maxUy * _scaleY), 0, _h - 1);
-        int maxDy = clampi((int)std::ceil(_h - minUy * _scaleY), 0, _h - 1);
+        int minDy = clampi((int)std::floor(mapY(maxUy * _scaleY)), _originY, _originY + _h - 1);
+        int maxDy = clampi((int)std::ceil(mapY(minUy * _scaleY)), _originY, _originY + _h - 1);
 
         // Clipping rect ile kesişim al
         minDx = std::max(minDx, clipMinX);
@@ -1679,6 +1391,9 @@ namespace pdf
 
         LogDebug("drawImageWithClipRect: rendering [%d,%d]-[%d,%d]", minDx, minDy, maxDx, maxDy);
 
+        std::shared_ptr<const PdfImagePyramid> pyramid;
+        const std::unique_ptr<PdfMipSampler> mip = mipSampler(rgba, imgW, imgH, inv, pyramid);
+
         // sRGB conversion functions
         auto srgbToLinear = [](double c) {
             c /= 255.0;
@@ -1692,14 +1407,18 @@ namespace pdf
                 : ((1.055 * std::pow(c, 1.0 / 2.4) - 0.055) * 255.0);
             };
 
+        const uint8_t imageAlpha = alphaByte(alpha);
+        uint8_t* row = sourceRow(maxDx - minDx + 1);
+
         // Sample each device pixel (only within clipped area)
         for (int py = minDy; py <= maxDy; ++py)
         {
+            std::memset(row, 0, (size_t)(maxDx - minDx + 1) * 4);
             for (int px = minDx; px <= maxDx; ++px)
             {
                 // Device -> page coordinates
                 double ux = (double)px / _scaleX;
-                double uy = ((double)_h - py) / _scaleY;
+                double uy = ((double)_pageH - py) / _scaleY;
 
                 // Page -> unit square (inverse CTM)
                 double s, t;
@@ -1711,6 +1430,13 @@ namespace pdf
                 double fx = s * (imgW - 1);
                 double fy = t * (imgH - 1);
 
+                if (mip) {
+                    uint8_t texel[4];
+                    mip->sample(fx, fy, texel);
+                    storeSourcePixel(row + (size_t)(px - minDx) * 4, texel[0], texel[1], texel[2], texel[3]);
+                    continue;
+                }
+
                 // BICUBIC INTERPOLATION (Catmull-Rom)
                 auto sample = [&](int x, int y, int c) -> double {
                     x = std::clamp(x, 0, imgW - 1);
@@ -1756,46 +1482,34 @@ namespace pdf
                 int nearestX = std::clamp((int)std::round(fx), 0, imgW - 1);
                 int nearestY = std::clamp((int)std::round(fy), 0, imgH - 1);
                 out[3] = rgba[(nearestY * imgW + nearestX) * 4 + 3] / 255.0;
-                // Output pixel
-                size_t di = (size_t(py) * _w + px) * 4;
-
-                uint8_t srcR = (uint8_t)linearToSrgb(out[0]);
-                uint8_t srcG = (uint8_t)linearToSrgb(out[1]);
-                uint8_t srcB = (uint8_t)linearToSrgb(out[2]);
-                uint8_t srcA = (uint8_t)(out[3] * 255.0);
-
-                // Apply ExtGState alpha (ca parameter)
-                if (alpha < 1.0f)
-                    srcA = (uint8_t)(srcA * alpha);
-
-                // Tamamen şeffaf pikselleri atla
-                if (srcA == 0)
-                    continue;
-
-                // Alpha blending uygula
-                if (srcA < 255)
-                {
-                    uint8_t dstB = _buffer[di + 0];
-                    uint8_t dstG = _buffer[di + 1];
-                    uint8_t dstR = _buffer[di + 2];
-
-                    int a = srcA;
-                    int invA = 255 - a;
-
-                    srcR = (uint8_t)((srcR * a + dstR * invA) / 255);
-                    srcG = (uint8_t)((srcG * a + dstG * invA) / 255);
-                    srcB = (uint8_t)((srcB * a + dstB * invA) / 255);
-                }
-
-                // Write BGRA
-                _buffer[di + 0] = srcB;
-                _buffer[di + 1] = srcG;
-                _buffer[di + 2] = srcR;
-                _buffer[di + 3] = 255;
+                // Output pixel (premultiplied)
+                storeSourcePixel(row + (size_t)(px - minDx) * 4,
+                    linearToSrgb(out[0]), linearToSrgb(out[1]), linearToSrgb(out[2]), out[3] * 255.0);
             }
+
+            // ExtGState alpha (ca) ve blend mode compositor'da
+            compositeRow(py, minDx, maxDx + 1, row, imageAlpha);
         }
     }
 
+    // Page-space clip rect -> device rect over the full page height (as
+    // IPdfPainter does it), so band painters clip exactly like one painter
+    void PdfPainter::drawImageWithPageClipRect(
+        const std::vector<uint8_t>& argb,
+        int imgW, int imgH,
+        const PdfMatrix& ctm,
+        double clipMinX, double clipMinY,
+        double clipMaxX, double clipMaxY,
+        float alpha)
+    {
+        const int minX = (int)(clipMinX * _scaleX);
+        const int maxX = (int)(clipMaxX * _scaleX);
+        const int minY = (int)((double)_pageH - clipMaxY * _scaleY);
+        const int maxY = (int)((double)_pageH - clipMinY * _scaleY);
+        drawImageWithClipRect(argb, imgW, imgH, ctm, minX, minY, maxX, maxY, alpha);
+    }
+
+
     // =====================================================
     // Clipping path destekli image çizme
     // =====================================================
@@ -1854,7 +1568,7 @@ namespace pdf
             if (seg.type == PdfPathSegment::MoveTo) {
                 ApplyMatrix(clipCTM, seg.x, seg.y, px, py);
                 double dx = px * _scaleX;
-                double dy = _h - py * _scaleY;
+                double dy = mapY(py * _scaleY);
                 clipPoly.push_back({ dx, dy });
                 clipCpX = seg.x;
                 clipCpY = seg.y;
@@ -1862,7 +1576,7 @@ namespace pdf
             else if (seg.type == PdfPathSegment::LineTo) {
                 ApplyMatrix(clipCTM, seg.x, seg.y, px, py);
                 double dx = px * _scaleX;
-                double dy = _h - py * _scaleY;
+                double dy = mapY(py * _scaleY);
                 clipPoly.push_back({ dx, dy });
                 clipCpX = seg.x;
                 clipCpY = seg.y;
@@ -1872,19 +1586,19 @@ namespace pdf
 
                 ApplyMatrix(clipCTM, clipCpX, clipCpY, px, py);
                 x0d = px * _scaleX;
-                y0d = _h - py * _scaleY;
+                y0d = mapY(py * _scaleY);
 
                 ApplyMatrix(clipCTM, seg.x1, seg.y1, px, py);
                 x1d = px * _scaleX;
-                y1d = _h - py * _scaleY;
+                y1d = mapY(py * _scaleY);
 
                 ApplyMatrix(clipCTM, seg.x2, seg.y2, px, py);
                 x2d = px * _scaleX;
-                y2d = _h - py * _scaleY;
+                y2d = mapY(py * _scaleY);
 
                 ApplyMatrix(clipCTM, seg.x3, seg.y3, px, py);
                 x3d = px * _scaleX;
-                y3d = _h - py * _scaleY;
+                y3d = mapY(py * _scaleY);
 
                 flattenCubicBezierDeviceD(
                     x0d, y0d,
@@ -1963,8 +1677,8 @@ namespace pdf
 
         int minDx = clampi((int)std::floor(minUx * _scaleX), 0, _w - 1);
         int maxDx = clampi((int)std::ceil(maxUx * _scaleX), 0, _w - 1);
-        int minDy = clampi((int)std::floor(_h - maxUy * _scaleY), 0, _h - 1);
-        int maxDy = clampi((int)std::ceil(_h - minUy * _scaleY), 0, _h - 1);
+        int minDy = clampi((int)std::floor(mapY(maxUy * _scaleY)), _originY, _originY + _h - 1);
+        int maxDy = clampi((int)std::ceil(mapY(minUy * _scaleY)), _originY, _originY + _h - 1);
 
         // Clip bbox ile kesişim
         minDx = std::max(minDx, (int)std::floor(finalClipMinX));
@@ -1998,14 +1712,23 @@ namespace pdf
                 : ((1.055 * std::pow(c, 1.0 / 2.4) - 0.055) * 255.0);
             };
 
+        if (minDx > maxDx || minDy > maxDy) return;
+
+        std::shared_ptr<const PdfImagePyramid> pyramid;
+        const std::unique_ptr<PdfMipSampler> mip = mipSampler(rgba, imgW, imgH, inv, pyramid);
+
+        const uint8_t imageAlpha = alphaByte(alpha);
+        uint8_t* row = sourceRow(maxDx - minDx + 1);
+
         for (int py = minDy; py <= maxDy; ++py) {
+            std::memset(row, 0, (size_t)(maxDx - minDx + 1) * 4);
             for (int px = minDx; px <= maxDx; ++px) {
                 // Clipping test
                 if (!pointInPolygon((double)px, (double)py))
                     continue;
 
                 double ux = (double)px / _scaleX;
-                double uy = ((double)_h - py) / _scaleY;
+                double uy = ((double)_pageH - py) / _scaleY;
 
                 double s, t;
                 ApplyMatrix(inv, ux, uy, s, t);
@@ -2034,6 +1757,17 @@ namespace pdf
                 double fx = imgS * (imgW - 1);
                 double fy = imgT * (imgH - 1);
 
+                const uint8_t WHITE_THRESHOLD = 220;
+
+                if (mip) {
+                    uint8_t texel[4];
+                    mip->sample(fx, fy, texel);
+                    if (texel[0] >= WHITE_THRESHOLD && texel[1] >= WHITE_THRESHOLD && texel[2] >= WHITE_THRESHOLD)
+                        continue;
+                    storeSourcePixel(row + (size_t)(px - minDx) * 4, texel[0], texel[1], texel[2], 255.0);
+                    continue;
+                }
+
                 // BICUBIC INTERPOLATION (Catmull-Rom)
                 auto sample = [&](int x, int y, int c) -> double {
                     x = std::clamp(x, 0, imgW - 1);
@@ -2074,8 +1808,6 @@ namespace pdf
                 for (int c = 0; c < 3; c++)
                     out[c] = std::clamp(out[c], 0.0, 1.0);
 
-                size_t di = (size_t(py) * _w + px) * 4;
-
                 uint8_t srcR = (uint8_t)linearToSrgb(out[0]);
                 uint8_t srcG = (uint8_t)linearToSrgb(out[1]);
                 uint8_t srcB = (uint8_t)linearToSrgb(out[2]);
@@ -2083,33 +1815,15 @@ namespace pdf
                 // =====================================================
                 // BEYAZ PİKSELLERİ SAYDAM YAP (Adobe uyumluluğu)
                 // =====================================================
-                const uint8_t WHITE_THRESHOLD = 220;
-
                 if (srcR >= WHITE_THRESHOLD && srcG >= WHITE_THRESHOLD && srcB >= WHITE_THRESHOLD) {
                     continue;
                 }
 
-                // Apply ExtGState alpha (ca parameter)
-                if (alpha < 1.0f)
-                {
-                    uint8_t srcA = (uint8_t)(alpha * 255.0f);
-                    uint8_t dstB = _buffer[di + 0];
-                    uint8_t dstG = _buffer[di + 1];
-                    uint8_t dstR = _buffer[di + 2];
-
-                    int a = srcA;
-                    int invA = 255 - a;
-
-                    srcR = (uint8_t)((srcR * a + dstR * invA) / 255);
-                    srcG = (uint8_t)((srcG * a + dstG * invA) / 255);
-                    srcB = (uint8_t)((srcB * a + dstB * invA) / 255);
-                }
-
-                _buffer[di + 0] = srcB;
-                _buffer[di + 1] = srcG;
-                _buffer[di + 2] = srcR;
-                _buffer[di + 3] = 255;
+                storeSourcePixel(row + (size_t)(px - minDx) * 4, srcR, srcG, srcB, 255.0);
             }
+
+            // ExtGState alpha (ca) ve blend mode compositor'da
+            compositeRow(py, minDx, maxDx + 1, row, imageAlpha);
         }
     }
 
@@ -2117,68 +1831,128 @@ namespace pdf
     void PdfPainter::clear(uint32_t bgraColor)
     {
         const int N = _w * _h;
+        if ((bgraColor >> 24) == 0xFF)
+        {
+            fillSpanSolid(_buffer.data(), N, bgraColor, 255);
+            return;
+        }
         for (int i = 0; i < N; i++) std::memcpy(&_buffer[i * 4], &bgraColor, 4);
     }
 
+    PdfPainter::Surface PdfPainter::surface(size_t depth)
+    {
+        if (depth == 0)
+            return Surface{ _buffer.data(), 0, 0, _w, _h };
+        Layer& l = _layers[depth - 1];
+        return Surface{ l.pixels.data(), l.x, l.y, l.w, l.h };
+    }
+
+    inline uint8_t* PdfPainter::targetSpan(int y, int& x0, int& x1)
+    {
+        if (_layers.empty())
+        {
+            if ((unsigned)y >= (unsigned)_h) return nullptr;
+            x0 = std::max(x0, 0);
+            x1 = std::min(x1, _w);
+            if (x0 >= x1) return nullptr;
+            return &_buffer[((size_t)y * _w + x0) * 4];
+        }
+
+        Layer& l = _layers.back();
+        if (y < l.y || y >= l.y + l.h) return nullptr;
+        x0 = std::max(x0, l.x);
+        x1 = std::min(x1, l.x + l.w);
+        if (x0 >= x1) return nullptr;
+        return &l.pixels[((size_t)(y - l.y) * l.w + (x0 - l.x)) * 4];
+    }
+
     inline void PdfPainter::putPixel(int x, int y, uint32_t argb)
     {
-        if ((unsigned)x >= (unsigned)_w || (unsigned)y >= (unsigned)_h)
-            return;
+        // Tek piksellik span
+        int x1 = x + 1;
+        if (uint8_t* p = targetSpan(y - _originY, x, x1))
+            _composite->solid(p, 1, argb, 255);
+    }
 
-        // DEBUG: Log pixels in right edge middle area - detect overwrites
-        static FILE* pixelDebug = nullptr;
-        static int pixelLogCount = 0;
-        static bool pixelDebugInit = false;
-        if (!pixelDebugInit) {
-            char tempPath[MAX_PATH];
-            GetTempPathA(MAX_PATH, tempPath);
-            strcat_s(tempPath, "pixel_debug.txt");
-            pixelDebug = fopen(tempPath, "w");
-            pixelDebugInit = true;
-        }
+    void PdfPainter::setBlendMode(PdfBlendMode mode)
+    {
+        _blendMode = mode;
+        _composite = &compositor(mode);
+    }
+
+    void PdfPainter::fillSpan(int y, int x0, int x1, uint32_t argb, uint8_t coverage)
+    {
+        if (uint8_t* p = targetSpan(y - _originY, x0, x1))
+            _composite->solid(p, x1 - x0, argb, coverage);
+    }
 
-        uint8_t* p = &_buffer[(y * _w + x) * 4];
+    void PdfPainter::fillSpan(int y, int x0, int x1, uint32_t argb, const uint8_t* coverage)
+    {
+        int from = x0, to = x1;
+        if (uint8_t* p = targetSpan(y - _originY, from, to))
+            _composite->coverage(p, to - from, argb, coverage + (from - x0));
+    }
+
+    void PdfPainter::compositeRow(int y, int x0, int x1, const uint8_t* src, uint8_t alpha)
+    {
+        int from = x0, to = x1;
+        if (uint8_t* p = targetSpan(y - _originY, from, to))
+            _composite->row(p, src + (size_t)(from - x0) * 4, to - from, alpha);
+    }
+
+    // _coverage'daki poligonları (clipped ise _coverageClip ile kesişimini)
+    // kapsama oranıyla boyar
+    void PdfPainter::fillCoverage(uint32_t color, bool evenOdd, bool clipped, bool clipEvenOdd)
+    {
+        if (_coverage.empty() || (clipped && _coverageClip.empty()))
+            return;
 
-        // Log only specific area
-        bool isRightEdge = (x > 1100 && x < 1200);
-        bool isMiddleY = (y > 400 && y < 500);
+        _coverage.begin(_originY, _originY + _h, _w, evenOdd);
+        if (clipped)
+            _coverageClip.begin(_originY, _originY + _h, _w, clipEvenOdd);
 
-        // Check current pixel color before writing
-        bool oldIsWhite = (p[0] == 255 && p[1] == 255 && p[2] == 255);
-        bool newIsWhite = ((argb & 0x00FFFFFF) == 0x00FFFFFF);
+        int cy = INT_MIN, cx0 = 0, cx1 = 0;
+        const uint8_t* clipCov = nullptr;
 
-        if (pixelDebug && isRightEdge && isMiddleY) {
-            // Log if overwriting colored pixel with white
-            if (!oldIsWhite && newIsWhite && pixelLogCount < 200) {
-                uint32_t oldColor = (p[3] << 24) | (p[2] << 16) | (p[1] << 8) | p[0];
-                fprintf(pixelDebug, "*** OVERWRITE *** (%d, %d): 0x%08X -> 0x%08X (colored -> white!)\n",
-                    x, y, oldColor, argb);
-                pixelLogCount++;
-                fflush(pixelDebug);
+        int y, x0, x1;
+        const uint8_t* cov;
+        while (_coverage.nextRow(y, cov, x0, x1))
+        {
+            if (x0 >= x1) continue;
+
+            if (!clipped)
+            {
+                fillSpan(y, x0, x1, color, cov + x0);
+                continue;
             }
-            // Log first few colored pixels
-            else if (!newIsWhite && pixelLogCount < 50) {
-                fprintf(pixelDebug, "putPixel(%d, %d, 0x%08X)\n", x, y, argb);
-                pixelLogCount++;
-                fflush(pixelDebug);
+
+            // Clip satırını dolgu satırına yetiştir
+            bool clipDone = false;
+            while (cy < y)
+            {
+                if (!_coverageClip.nextRow(cy, clipCov, cx0, cx1))
+                {
+                    clipDone = true;
+                    break;
+                }
             }
-        }
+            if (clipDone) break;
+            if (cy > y) continue;
 
-        // argb = 0xAARRGGBB
-        uint8_t a = (argb >> 24) & 0xFF;
-        uint8_t r = (argb >> 16) & 0xFF;
-        uint8_t g = (argb >> 8) & 0xFF;
-        uint8_t b = (argb) & 0xFF;
-
-        // BGRA yaz
-        p[0] = b;
-        p[1] = g;
-        p[2] = r;
-        p[3] = a;
+            const int from = std::max(x0, cx0);
+            const int to = std::min(x1, cx1);
+            if (from >= to) continue;
+
+            if ((int)_coverageRow.size() < to - from)
+                _coverageRow.resize(to - from);
+            for (int x = from; x < to; x++)
+                _coverageRow[x - from] = (uint8_t)((cov[x] * clipCov[x] + 127) / 255);
+            fillSpan(y, from, to, color, _coverageRow.data());
+        }
     }
 
 
-    double PdfPainter::mapY(double y) const { return (double)_h - y; }
+    double PdfPainter::mapY(double y) const { return (double)_pageH - y; }
 
     void PdfPainter::applyRotate(double& x, double& y) const
     {
@@ -2188,6 +1962,12 @@ namespace pdf
         x = rx; y = ry;
     }
 
+    void PdfPainter::setBandOrigin(int top, int pageHeight)
+    {
+        _originY = top * _ssaa;
+        _pageH = pageHeight * _ssaa;
+    }
+
     void PdfPainter::setPageRotation(int degrees, double pageWPt, double pageHPt)
     {
         _hasRotate = false;
@@ -2226,6 +2006,13 @@ namespace pdf
         if (ix1 > ix2) std::swap(ix1, ix2);
         if (iy1 > iy2) std::swap(iy1, iy2);
 
+        if (!_hasRotate)
+        {
+            for (int yy = iy1; yy < iy2; yy++)
+                fillSpan(yy, ix1, ix2, color);
+            return;
+        }
+
         for (int yy = iy1; yy < iy2; yy++)
         {
             for (int xx = ix1; xx < ix2; xx++)
@@ -2281,6 +2068,7 @@ namespace pdf
         int height = fontSize + 8;
         if (width < 1 || height < 1) return;
 
+#ifdef _WIN32
         HDC hdc = CreateCompatibleDC(NULL);
         if (!hdc) return;
 
@@ -2325,6 +2113,10 @@ namespace pdf
         DeleteObject(font);
         DeleteObject(bmp);
         DeleteDC(hdc);
+#else
+        // No GDI here; page text is drawn through drawTextFreeTypeRaw
+        (void)px; (void)py; (void)color;
+#endif
     }
 
     void PdfPainter::drawGlyph(double x, double y, double w, double h, uint32_t c)
@@ -2332,12 +2124,12 @@ namespace pdf
         fillRect(x, y, w, h, c);
     }
 
-    // === YARDIMCI: Path'i polygon'a dönüştür ===
-    static void pathToPolygons(
+    // === YARDIMCI: Path'i polygon'a dönüştür (device, double) ===
+    static void pathToDevicePolygons(
         const PdfPath& path,
         const PdfMatrix& ctm,
         double scaleX, double scaleY, int h,
-        std::vector<std::vector<IPoint>>& outPolys,
+        std::vector<std::vector<DPoint>>& outPolys,
         double tolPxSq = 0.0025)
     {
         std::vector<DPoint> cur;
@@ -2359,13 +2151,7 @@ namespace pdf
                 if (std::abs(a.x - b.x) > 1e-6 || std::abs(a.y - b.y) > 1e-6)
                     cur.push_back(a);
 
-                std::vector<IPoint> ip;
-                ip.reserve(cur.size());
-                for (auto& p : cur) {
-                    ip.push_back({ (int)std::lround(p.x), (int)std::lround(p.y) });
-                }
-                if (ip.size() >= 3)
-                    outPolys.push_back(std::move(ip));
+                outPolys.push_back(cur);
             }
             cur.clear();
             hasSubpath = false;
@@ -2441,71 +2227,51 @@ namespace pdf
         flush();
     }
 
-    // === YARDIMCI: Scanline için clipping X span'lerini hesapla ===
+    // === YARDIMCI: Path'i polygon'a dönüştür (aliased fill için tam sayı) ===
+    static void pathToPolygons(
+        const PdfPath& path,
+        const PdfMatrix& ctm,
+        double scaleX, double scaleY, int h,
+        std::vector<std::vector<IPoint>>& outPolys,
+        double tolPxSq = 0.0025)
+    {
+        std::vector<std::vector<DPoint>> polys;
+        pathToDevicePolygons(path, ctm, scaleX, scaleY, h, polys, tolPxSq);
+
+        for (const auto& poly : polys) {
+            std::vector<IPoint> ip;
+            ip.reserve(poly.size());
+            for (auto& p : poly) {
+                ip.push_back({ (int)std::lround(p.x), (int)std::lround(p.y) });
+            }
+            outPolys.push_back(std::move(ip));
+        }
+    }
+
+    // === YARDIMCI: Scanline için clipping X span'lerini hesapla ===
     static void getClipSpansForScanline(
         int y,
-        const std::vector<std::vector<IPoint>>& clipPolys,
+        ScanlineEdgeTable& clipEdges,
         bool clipEvenOdd,
         std::vector<std::pair<int, int>>& outSpans)
     {
         outSpans.clear();
 
-        if (clipEvenOdd) {
-            // Even-odd: kesişim noktalarını topla
-            std::vector<int> xs;
-            xs.reserve(64);
-
-            for (const auto& poly : clipPolys) {
-                for (size_t i = 0, j = poly.size() - 1; i < poly.size(); j = i++) {
-                    const IPoint& p1 = poly[j];
-                    const IPoint& p2 = poly[i];
-                    if (p1.y == p2.y) continue;
-
-                    int yMin = std::min(p1.y, p2.y);
-                    int yMax = std::max(p1.y, p2.y);
-                    if (y < yMin || y >= yMax) continue;
-
-                    double t = (double)(y - p1.y) / (double)(p2.y - p1.y);
-                    int x = (int)std::lround(p1.x + t * (p2.x - p1.x));
-                    xs.push_back(x);
-                }
-            }
+        const auto& xs = clipEdges.row(y);
 
-            std::sort(xs.begin(), xs.end());
+        if (clipEvenOdd) {
+            // Even-odd: kesişim noktaları çiftler halinde
             for (size_t i = 0; i + 1 < xs.size(); i += 2) {
-                outSpans.emplace_back(xs[i], xs[i + 1]);
+                outSpans.emplace_back((int)std::lround(xs[i].x), (int)std::lround(xs[i + 1].x));
             }
         }
         else {
             // Non-zero winding
-            std::vector<std::pair<int, int>> edges;
-            edges.reserve(64);
-
-            for (const auto& poly : clipPolys) {
-                for (size_t i = 0, j = poly.size() - 1; i < poly.size(); j = i++) {
-                    const IPoint& p1 = poly[j];
-                    const IPoint& p2 = poly[i];
-                    if (p1.y == p2.y) continue;
-
-                    int yMin = std::min(p1.y, p2.y);
-                    int yMax = std::max(p1.y, p2.y);
-                    if (y < yMin || y >= yMax) continue;
-
-                    double t = (double)(y - p1.y) / (double)(p2.y - p1.y);
-                    int x = (int)std::lround(p1.x + t * (p2.x - p1.x));
-                    int w = (p2.y > p1.y) ? +1 : -1;
-                    edges.emplace_back(x, w);
-                }
-            }
-
-            std::sort(edges.begin(), edges.end(),
-                [](const auto& a, const auto& b) { return a.first < b.first; });
-
             int wsum = 0;
-            for (size_t i = 0; i + 1 < edges.size(); ++i) {
-                wsum += edges[i].second;
+            for (size_t i = 0; i + 1 < xs.size(); ++i) {
+                wsum += xs[i].winding;
                 if (wsum != 0) {
-                    outSpans.emplace_back(edges[i].first, edges[i + 1].first);
+                    outSpans.emplace_back((int)std::lround(xs[i].x), (int)std::lround(xs[i + 1].x));
                 }
             }
         }
@@ -2539,61 +2305,8 @@ namespace pdf
         const PdfMatrix* clipCTM,
         bool clipEvenOdd)
     {
-        // ========== DEBUG LOG ==========
-        static FILE* debugFile = nullptr;
-        static int callCount = 0;
-        if (!debugFile) {
-            // TEMP klasörüne yaz (C:\ yerine)
-            char tempPath[MAX_PATH];
-            GetTempPathA(MAX_PATH, tempPath);
-            strcat_s(tempPath, "bezier_debug.txt");
-            debugFile = fopen(tempPath, "w");
-            if (debugFile) {
-                fprintf(debugFile, "=== BEZIER DEBUG LOG ===\n");
-                fprintf(debugFile, "Log file: %s\n", tempPath);
-                fflush(debugFile);
-            }
-        }
-        callCount++;
-
-        int curveCount = 0;
-        int lineCount = 0;
-        int moveCount = 0;
-        for (const auto& seg : path) {
-            if (seg.type == PdfPathSegment::CurveTo) curveCount++;
-            else if (seg.type == PdfPathSegment::LineTo) lineCount++;
-            else if (seg.type == PdfPathSegment::MoveTo) moveCount++;
-        }
-
-        if (debugFile) {
-            fprintf(debugFile, "\n[fillPath #%d] path.size=%zu, moves=%d, lines=%d, CURVES=%d\n",
-                callCount, path.size(), moveCount, lineCount, curveCount);
-            fprintf(debugFile, "  CTM=[%.4f %.4f %.4f %.4f %.4f %.4f]\n",
-                ctm.a, ctm.b, ctm.c, ctm.d, ctm.e, ctm.f);
-            fprintf(debugFile, "  color=0x%08X, evenOdd=%d\n", color, evenOdd ? 1 : 0);
-            fprintf(debugFile, "  _scaleX=%.4f, _scaleY=%.4f, _w=%d, _h=%d\n", _scaleX, _scaleY, _w, _h);
-
-            // PATH KOORDİNATLARI (ilk 10 segment)
-            int segIdx = 0;
-            for (const auto& seg : path) {
-                if (segIdx >= 10) {
-                    fprintf(debugFile, "  ... (%zu more segments)\n", path.size() - 10);
-                    break;
-                }
-                if (seg.type == PdfPathSegment::MoveTo)
-                    fprintf(debugFile, "  [%d] MOVE (%.4f, %.4f)\n", segIdx, seg.x, seg.y);
-                else if (seg.type == PdfPathSegment::LineTo)
-                    fprintf(debugFile, "  [%d] LINE (%.4f, %.4f)\n", segIdx, seg.x, seg.y);
-                else if (seg.type == PdfPathSegment::CurveTo)
-                    fprintf(debugFile, "  [%d] CURVE c1(%.2f,%.2f) c2(%.2f,%.2f) end(%.2f,%.2f)\n",
-                        segIdx, seg.x1, seg.y1, seg.x2, seg.y2, seg.x3, seg.y3);
-                else if (seg.type == PdfPathSegment::Close)
-                    fprintf(debugFile, "  [%d] CLOSE\n", segIdx);
-                segIdx++;
-            }
-            fflush(debugFile);
-        }
-        // ========== END DEBUG ==========
+        PDF_TRACE_SCOPE(Fill, "fillPath", "%zu segments, evenOdd=%d, clip=%d, aa=%d",
+            path.size(), evenOdd ? 1 : 0, clipPath ? 1 : 0, _antiAlias ? 1 : 0);
 
         // === POLYGONLARI DOUBLE OLARAK TUT ===
         std::vector<std::vector<DPoint>> polys;
@@ -2615,22 +2328,6 @@ namespace pdf
                 applyRotate(dx, dy);
             };
 
-        // DEBUG: Transform sonuçlarını logla (sadece ilk birkaç fill için)
-        auto userToDeviceDebug = [&](double ux, double uy, double& dx, double& dy, bool logIt)
-            {
-                double afterCTM_x, afterCTM_y;
-                ApplyMatrix(ctm, ux, uy, afterCTM_x, afterCTM_y);
-                dx = afterCTM_x * _scaleX;
-                double beforeMapY = afterCTM_y * _scaleY;
-                dy = mapY(beforeMapY);
-                applyRotate(dx, dy);
-
-                if (logIt && debugFile && callCount <= 20) {
-                    fprintf(debugFile, "    TRANSFORM: user(%.2f,%.2f) -> ctm(%.2f,%.2f) -> scale(%.2f,%.2f) -> mapY(%.2f) -> device(%.2f,%.2f)\n",
-                        ux, uy, afterCTM_x, afterCTM_y, dx, beforeMapY, dy, dx, dy);
-                }
-            };
-
         auto flush = [&]()
             {
                 if (cur.size() >= 3)
@@ -2691,10 +2388,6 @@ namespace pdf
                 userToDevice(seg.x2, seg.y2, x2d, y2d);
                 userToDevice(seg.x3, seg.y3, x3d, y3d);
 
-                // ========== DEBUG: Bezier bilgisi ==========
-                size_t beforeSize = cur.size();
-                // ========== END DEBUG ==========
-
                 // Başlangıç noktası (duplicate olmasın)
                 addPointUniqueD(cur, x0d, y0d);
 
@@ -2708,18 +2401,6 @@ namespace pdf
                     tolPxSq
                 );
 
-                // ========== DEBUG: Flatten sonucu ==========
-                if (debugFile && curveCount > 0 && curveCount <= 20) {
-                    fprintf(debugFile, "  CURVE: user(%.2f,%.2f)->(%.2f,%.2f)->(%.2f,%.2f)->(%.2f,%.2f)\n",
-                        curUx, curUy, seg.x1, seg.y1, seg.x2, seg.y2, seg.x3, seg.y3);
-                    fprintf(debugFile, "         dev (%.2f,%.2f)->(%.2f,%.2f)->(%.2f,%.2f)->(%.2f,%.2f)\n",
-                        x0d, y0d, x1d, y1d, x2d, y2d, x3d, y3d);
-                    fprintf(debugFile, "         flatten: %zu -> %zu points (+%zu)\n",
-                        beforeSize, cur.size(), cur.size() - beforeSize);
-                    fflush(debugFile);
-                }
-                // ========== END DEBUG ==========
-
                 curUx = seg.x3;
                 curUy = seg.y3;
             }
@@ -2738,20 +2419,28 @@ namespace pdf
         flush();
         if (polys.empty()) return;
 
-        // ========== DEBUG: POLYGON KOORDİNATLARI ==========
-        if (debugFile && callCount >= 2160 && callCount <= 2170) {
-            fprintf(debugFile, "  POLYGONS (count=%zu):\n", polys.size());
-            for (size_t pi = 0; pi < polys.size(); pi++) {
-                fprintf(debugFile, "    poly[%zu] (%zu pts): ", pi, polys[pi].size());
-                for (size_t vi = 0; vi < polys[pi].size() && vi < 6; vi++) {
-                    fprintf(debugFile, "(%.2f,%.2f) ", polys[pi][vi].x, polys[pi][vi].y);
-                }
-                if (polys[pi].size() > 6) fprintf(debugFile, "...");
-                fprintf(debugFile, "\n");
+        PDF_TRACE(Fill, "flatten", "%zu polygons", polys.size());
+
+        // === ANTI-ALIAS: kenarları alan kapsamasıyla doldur ===
+        if (_antiAlias)
+        {
+            _coverage.clear();
+            for (const auto& poly : polys)
+                _coverage.addPolygon(poly);
+
+            bool clipped = (clipPath != nullptr && clipCTM != nullptr && !clipPath->empty());
+            if (clipped)
+            {
+                std::vector<std::vector<DPoint>> clipPolys;
+                pathToDevicePolygons(*clipPath, *clipCTM, _scaleX, _scaleY, _pageH, clipPolys);
+                _coverageClip.clear();
+                for (const auto& poly : clipPolys)
+                    _coverageClip.addPolygon(poly);
             }
-            fflush(debugFile);
+
+            fillCoverage(color, evenOdd, clipped, clipEvenOdd);
+            return;
         }
-        // ========== END DEBUG ==========
 
         // === DOUBLE → INT POLYGON DÖNÜŞÜMÜ ===
         std::vector<std::vector<IPoint>> ipolys;
@@ -2785,21 +2474,21 @@ namespace pdf
         bool hasClip = (clipPath != nullptr && clipCTM != nullptr && !clipPath->empty());
 
         if (hasClip) {
-            pathToPolygons(*clipPath, *clipCTM, _scaleX, _scaleY, _h, clipPolys);
+            pathToPolygons(*clipPath, *clipCTM, _scaleX, _scaleY, _pageH, clipPolys);
 
-            if (debugFile && callCount >= 2160 && callCount <= 2170) {
-                fprintf(debugFile, "  CLIPPING: %zu polygons\n", clipPolys.size());
-                for (size_t i = 0; i < clipPolys.size() && i < 3; i++) {
-                    fprintf(debugFile, "    clip[%zu]: %zu points\n", i, clipPolys[i].size());
-                }
-                fflush(debugFile);
-            }
+            _scanClip.clear();
+            for (const auto& poly : clipPolys)
+                _scanClip.addPolygon(poly);
         }
 
-        minY = clampi(minY, 0, _h - 1);
-        maxY = clampi(maxY, 0, _h - 1);
+        minY = clampi(minY, _originY, _originY + _h - 1);
+        maxY = clampi(maxY, _originY, _originY + _h - 1);
+
+        // === SCANLINE DOLDURMA (aktif kenar tablosu) ===
+        _scanEdges.clear();
+        for (const auto& poly : ipolys)
+            _scanEdges.addPolygon(poly);
 
-        // === SCANLINE DOLDURMA ===
         std::vector<std::pair<int, int>> clipSpans;
         std::vector<std::pair<int, int>> fillSpans;
         std::vector<std::pair<int, int>> finalSpans;
@@ -2808,78 +2497,33 @@ namespace pdf
         {
             // Clipping span'lerini bu satır için hesapla (eğer clip varsa)
             if (hasClip) {
-                getClipSpansForScanline(y, clipPolys, clipEvenOdd, clipSpans);
+                getClipSpansForScanline(y, _scanClip, clipEvenOdd, clipSpans);
                 if (clipSpans.empty()) continue; // Bu satırda clip yok, atla
             }
 
             fillSpans.clear();
 
+            const auto& xs = _scanEdges.row(y);
+
             if (evenOdd)
             {
-                std::vector<int> xs;
-                xs.reserve(128);
-
-                for (const auto& poly : ipolys)
-                {
-                    for (size_t i = 0, j = poly.size() - 1; i < poly.size(); j = i++)
-                    {
-                        const IPoint& p1 = poly[j];
-                        const IPoint& p2 = poly[i];
-                        if (p1.y == p2.y) continue;
-
-                        int yMin = std::min(p1.y, p2.y);
-                        int yMax = std::max(p1.y, p2.y);
-                        if (y < yMin || y >= yMax) continue;
-
-                        double t = (double)(y - p1.y) / (double)(p2.y - p1.y);
-                        int x = (int)std::lround(p1.x + t * (p2.x - p1.x));
-                        xs.push_back(x);
-                    }
-                }
-
-                std::sort(xs.begin(), xs.end());
                 for (size_t i = 0; i + 1 < xs.size(); i += 2)
                 {
-                    int x1 = clampi(xs[i], 0, _w - 1);
-                    int x2 = clampi(xs[i + 1], 0, _w - 1);
+                    int x1 = clampi((int)std::lround(xs[i].x), 0, _w - 1);
+                    int x2 = clampi((int)std::lround(xs[i + 1].x), 0, _w - 1);
                     if (x2 > x1) fillSpans.emplace_back(x1, x2);
                 }
             }
             else
             {
-                std::vector<std::pair<int, int>> edges;
-                edges.reserve(128);
-
-                for (const auto& poly : ipolys)
-                {
-                    for (size_t i = 0, j = poly.size() - 1; i < poly.size(); j = i++)
-                    {
-                        const IPoint& p1 = poly[j];
-                        const IPoint& p2 = poly[i];
-                        if (p1.y == p2.y) continue;
-
-                        int yMin = std::min(p1.y, p2.y);
-                        int yMax = std::max(p1.y, p2.y);
-                        if (y < yMin || y >= yMax) continue;
-
-                        double t = (double)(y - p1.y) / (double)(p2.y - p1.y);
-                        int x = (int)std::lround(p1.x + t * (p2.x - p1.x));
-                        int w = (p2.y > p1.y) ? +1 : -1;
-                        edges.emplace_back(x, w);
-                    }
-                }
-
-                std::sort(edges.begin(), edges.end(),
-                    [](const auto& a, const auto& b) { return a.first < b.first; });
-
                 int wsum = 0;
-                for (size_t i = 0; i + 1 < edges.size(); ++i)
+                for (size_t i = 0; i + 1 < xs.size(); ++i)
                 {
-                    wsum += edges[i].second;
+                    wsum += xs[i].winding;
                     if (wsum != 0)
                     {
-                        int x1 = clampi(edges[i].first, 0, _w - 1);
-                        int x2 = clampi(edges[i + 1].first, 0, _w - 1);
+                        int x1 = clampi((int)std::lround(xs[i].x), 0, _w - 1);
+                        int x2 = clampi((int)std::lround(xs[i + 1].x), 0, _w - 1);
                         if (x2 > x1) fillSpans.emplace_back(x1, x2);
                     }
                 }
@@ -2888,18 +2532,12 @@ namespace pdf
             // === CLIPPING İLE KESİŞİM AL VE BOYA ===
             if (hasClip) {
                 intersectSpans(fillSpans, clipSpans, finalSpans);
-                for (const auto& span : finalSpans) {
-                    for (int x = span.first; x < span.second; ++x) {
-                        putPixel(x, y, color);
-                    }
-                }
+                for (const auto& span : finalSpans)
+                    fillSpan(y, span.first, span.second, color);
             }
             else {
-                for (const auto& span : fillSpans) {
-                    for (int x = span.first; x < span.second; ++x) {
-                        putPixel(x, y, color);
-                    }
-                }
+                for (const auto& span : fillSpans)
+                    fillSpan(y, span.first, span.second, color);
             }
         }
     }
@@ -2940,22 +2578,21 @@ namespace pdf
 
         // Helper: Path'i polygon'a çevir (mevcut static pathToPolygons fonksiyonunu kullanmak için)
         // pathToPolygons static olduğu için çağırabiliriz.
-        pathToPolygons(path, ctm, _scaleX, _scaleY, _h, polys);
+        pathToPolygons(path, ctm, _scaleX, _scaleY, _pageH, polys);
 
         if (polys.empty()) return;
 
-        // 2. Rasterize Patterns (Tüm polygonlar için)
-        // Çoklu polygonları flatten etmek yerine tek tek çizelim (Scanline birleştirmesi daha doğru olurdu ama bu da çalışır)
-        // Ancak delikler için tüm polygonları birlikte işlemek gerekir.
-        // Burada basitçe rasterFillPolygonPattern'e "polys" listesini verecek şekilde overload yapmadık.
-        // Bu yüzden tüm IPoint polygonlarını tek bir listede toplayıp rasterizer'a gönderemeyiz (bu yanlıştır).
-        // Doğrusu: rasterFillPolygonPattern fonksiyonunu vector<vector<IPoint>> alacak şekilde güncellemek.
-        // Ama Header değiştirmek istemiyoruz.
-        // O yüzden burada rasterFillPolygonPattern'in içeriğini (scanline loop) buraya alıyoruz (Inline Implementation).
-
-        // A. Tüm polygonları hazırla (IPoint formatında zaten polys var)
-        std::vector<std::vector<IPoint>> ipolys = polys;
+        // 2. Rasterize: tüm polygonlar birlikte (delikler için gerekli)
+        rasterFillPolygonPattern(polys, pattern, ctm, evenOdd, alpha);
+    }
 
+    void PdfPainter::rasterFillPolygonPattern(
+        const std::vector<std::vector<IPoint>>& ipolys,
+        const PdfPattern& pattern,
+        const PdfMatrix& ctm,
+        bool evenOdd,
+        float alpha)
+    {
         // B. Min/Max Y bul
         int minY = INT_MAX, maxY = INT_MIN;
         for (const auto& poly : ipolys) {
@@ -2965,8 +2602,8 @@ namespace pdf
             }
         }
 
-        minY = std::max(0, minY);
-        maxY = std::min(_h - 1, maxY);
+        minY = std::max(_originY, minY);
+        maxY = std::min(_originY + _h - 1, maxY);
 
         // C. Matris Terslerini Hazırla
         // CTM Inverse: Device -> User
@@ -2983,22 +2620,31 @@ namespace pdf
         double pDet = pattern.matrix.a * pattern.matrix.d - pattern.matrix.b * pattern.matrix.c;
         double pInvDet = (std::abs(pDet) > 1e-9) ? 1.0 / pDet : 0.0; // Fallback?
 
+        _scanEdges.clear();
+        for (const auto& poly : ipolys)
+            _scanEdges.addPolygon(poly);
+
         std::vector<std::pair<int, int>> spans;
+        const uint8_t patternAlpha = alphaByte(alpha);
 
         for (int y = minY; y <= maxY; y++)
         {
             // Scanline span'lerini al
-            getClipSpansForScanline(y, ipolys, evenOdd, spans);
+            getClipSpansForScanline(y, _scanEdges, evenOdd, spans);
 
             for (const auto& span : spans)
             {
                 int xStart = std::max(0, span.first);
                 int xEnd = std::min(_w, span.second);
+                if (xStart >= xEnd) continue;
+
+                uint8_t* row = sourceRow(xEnd - xStart);
+                std::memset(row, 0, (size_t)(xEnd - xStart) * 4);
 
                 for (int x = xStart; x < xEnd; x++) {
                     // 1. Device (x,y) to User (ux, uy)
                     double dx = (double)x / _scaleX;
-                    double dy = (double)(_h - y) / _scaleY; // MapY tersi
+                    double dy = (double)(_pageH - y) / _scaleY; // MapY tersi
 
                     // CTM^-1 * (dx - e, dy - f) -> ux, uy
                     double tx = dx - ctm.e;
@@ -3069,75 +2715,30 @@ namespace pdf
                     int bufIdx = v * pattern.width + u;
                     if (bufIdx < 0 || bufIdx >= pattern.buffer.size()) continue;
 
+                    // Tile pixels are premultiplied BGRA (the tile painter's buffer)
                     uint32_t srcColor = pattern.buffer[bufIdx];
 
-                    // Uncolored Pattern Masking
+                    // Uncolored Pattern Masking: tile alpha x base colour
                     if (pattern.isUncolored) {
                         uint8_t maskA = (srcColor >> 24) & 0xFF;
-
                         uint8_t baseA = (pattern.baseColor >> 24) & 0xFF;
-                        uint8_t baseR = (pattern.baseColor >> 16) & 0xFF;
-                        uint8_t baseG = (pattern.baseColor >> 8) & 0xFF;
-                        uint8_t baseB = (pattern.baseColor) & 0xFF;
-
-                        uint8_t finalA = (uint8_t)((maskA * baseA) / 255);
-                        srcColor = (finalA << 24) | (baseR << 16) | (baseG << 8) | baseB;
-                    }
-
-                    // Apply ExtGState alpha (ca parameter)
-                    if (alpha < 1.0f) {
-                        uint8_t sa = (srcColor >> 24) & 0xFF;
-                        sa = (uint8_t)(sa * alpha);
-                        srcColor = (sa << 24) | (srcColor & 0x00FFFFFF);
+                        double finalA = (double)(maskA * baseA / 255);
+                        storeSourcePixel(row + (size_t)(x - xStart) * 4,
+                            (pattern.baseColor >> 16) & 0xFF,
+                            (pattern.baseColor >> 8) & 0xFF,
+                            pattern.baseColor & 0xFF, finalA);
+                        continue;
                     }
 
-                    // Blend process
-                    if ((srcColor & 0xFF000000) == 0) continue;
-
-                    // Simple Alpha Blend inline (since putPixel is overwrite)
-                    // putPixel(x, y, srcColor); // Overwrite (basit)
-                    // Doğrusu blend, ama şimdilik overwrite yeterli olabilir.
-
-                    // Blend Implementation:
-                    int dstIdx = y * _w * 4 + x * 4;
-                    if (dstIdx >= 0 && dstIdx + 3 < _buffer.size()) {
-                        uint8_t db = _buffer[dstIdx + 0];
-                        uint8_t dg = _buffer[dstIdx + 1];
-                        uint8_t dr = _buffer[dstIdx + 2];
-
-                        uint8_t sa = (srcColor >> 24) & 0xFF;
-                        uint8_t sr = (srcColor >> 16) & 0xFF;
-                        uint8_t sg = (srcColor >> 8) & 0xFF;
-                        uint8_t sb = (srcColor >> 0) & 0xFF;
-
-                        if (sa == 255) {
-                            _buffer[dstIdx + 0] = sb;
-                            _buffer[dstIdx + 1] = sg;
-                            _buffer[dstIdx + 2] = sr;
-                            _buffer[dstIdx + 3] = 255;
-                        }
-                        else {
-                            int invA = 255 - sa;
-                            _buffer[dstIdx + 0] = (sb * sa + db * invA) / 255;
-                            _buffer[dstIdx + 1] = (sg * sa + dg * invA) / 255;
-                            _buffer[dstIdx + 2] = (sr * sa + dr * invA) / 255;
-                            _buffer[dstIdx + 3] = 255;
-                        }
-                    }
+                    std::memcpy(row + (size_t)(x - xStart) * 4, &srcColor, 4);
                 }
+
+                // ExtGState alpha (ca) ve blend mode compositor'da
+                compositeRow(y, xStart, xEnd, row, patternAlpha);
             }
         }
     }
 
-    void PdfPainter::rasterFillPolygonPattern(
-        const std::vector<IPoint>& poly,
-        const PdfPattern& pattern,
-        bool evenOdd)
-    {
-        // Redundant - implementation moved to fillPathWithPattern
-    }
-
-
 
     void PdfPainter::drawLineDevice(int x1, int y1, int x2, int y2, uint32_t color)
     {
@@ -3163,91 +2764,25 @@ namespace pdf
         if (poly.size() < 3) return;
 
         int ymin = poly[0].y, ymax = poly[0].y;
-        int xmin = poly[0].x, xmax = poly[0].x;
         for (auto& p : poly)
         {
             ymin = std::min(ymin, p.y);
             ymax = std::max(ymax, p.y);
-            xmin = std::min(xmin, p.x);
-            xmax = std::max(xmax, p.x);
         }
 
-        // DEBUG FILE
-        static FILE* fillDebug = nullptr;
-        static bool fillDebugInit = false;
-        static int fillCallCount = 0;
-        if (!fillDebugInit) {
-            char tempPath[MAX_PATH];
-            GetTempPathA(MAX_PATH, tempPath);
-            strcat_s(tempPath, "fill_debug.txt");
-            fillDebug = fopen(tempPath, "w");
-            fillDebugInit = true;
-        }
-        fillCallCount++;
+        PDF_TRACE_SCOPE(Fill, "rasterFillPolygon", "%zu points, rows %d..%d, evenOdd=%d",
+            poly.size(), ymin, ymax, evenOdd ? 1 : 0);
 
-        struct Edge
-        {
-            int y0, y1;
-            double x;
-            double dx;
-            int winding;
-        };
+        _scanEdges.clear();
+        _scanEdges.addPolygon(poly, false);
 
-        std::vector<Edge> edges;
-
-        for (size_t i = 0; i + 1 < poly.size(); ++i)
-        {
-            IPoint p0 = poly[i];
-            IPoint p1 = poly[i + 1];
-            if (p0.y == p1.y) continue;
-
-            bool up = p0.y < p1.y;
-            Edge e;
-            e.y0 = up ? p0.y : p1.y;
-            e.y1 = up ? p1.y : p0.y;
-            e.x = up ? p0.x : p1.x;
-            e.dx = (double)(p1.x - p0.x) / (double)(p1.y - p0.y);
-            e.winding = up ? +1 : -1;
-            edges.push_back(e);
-        }
-
-        // DEBUG: Log edges with X > 1200 (right side)
-        if (fillDebug) {
-            fprintf(fillDebug, "\n=== rasterFillPolygon #%d ===\n", fillCallCount);
-            fprintf(fillDebug, "Bounds: (%d,%d)-(%d,%d), color=0x%08X\n", xmin, ymin, xmax, ymax, color);
-            fprintf(fillDebug, "Total edges: %zu\n", edges.size());
-
-            // Count and log right-side edges
-            int rightEdgeCount = 0;
-            for (size_t i = 0; i < edges.size(); i++) {
-                double edgeMaxX = std::max(edges[i].x, edges[i].x + edges[i].dx * (edges[i].y1 - edges[i].y0));
-                if (edgeMaxX > 1200) {
-                    fprintf(fillDebug, "  Edge[%zu]: y=%d-%d, x=%.1f, dx=%.4f, w=%d (RIGHT SIDE)\n",
-                        i, edges[i].y0, edges[i].y1, edges[i].x, edges[i].dx, edges[i].winding);
-                    rightEdgeCount++;
-                }
-            }
-            fprintf(fillDebug, "Right-side edges (X>1200): %d\n", rightEdgeCount);
-            fflush(fillDebug);
-        }
-
-        int rightPixelCount = 0;
+        // Rows outside the buffer (or the band) are never written
+        ymin = std::max(ymin, _originY);
+        ymax = std::min(ymax, _originY + _h);
 
         for (int y = ymin; y < ymax; ++y)
         {
-            struct Hit { double x; int w; };
-            std::vector<Hit> hits;
-
-            for (auto& e : edges)
-            {
-                if (y >= e.y0 && y < e.y1)
-                {
-                    hits.push_back({ e.x + e.dx * (y - e.y0), e.winding });
-                }
-            }
-
-            std::sort(hits.begin(), hits.end(),
-                [](const Hit& a, const Hit& b) { return a.x < b.x; });
+            const auto& hits = _scanEdges.row(y);
 
             if (evenOdd)
             {
@@ -3255,10 +2790,7 @@ namespace pdf
                 {
                     int x0 = (int)std::ceil(hits[i].x);
                     int x1 = (int)std::floor(hits[i + 1].x);
-                    for (int x = x0; x <= x1; ++x) {
-                        putPixel(x, y, color);
-                        if (x > 1200) rightPixelCount++;
-                    }
+                    fillSpan(y, x0, x1 + 1, color);
                 }
             }
             else
@@ -3268,27 +2800,18 @@ namespace pdf
                 for (auto& h : hits)
                 {
                     int prev = wsum;
-                    wsum += h.w;
+                    wsum += h.winding;
                     if (prev == 0 && wsum != 0)
                         xstart = h.x;
                     else if (prev != 0 && wsum == 0)
                     {
                         int x0 = (int)std::ceil(xstart);
                         int x1 = (int)std::floor(h.x);
-                        for (int x = x0; x <= x1; ++x) {
-                            putPixel(x, y, color);
-                            if (x > 1200) rightPixelCount++;
+                        fillSpan(y, x0, x1 + 1, color);
                         }
-                    }
                 }
             }
         }
-
-        // DEBUG: Log right pixel count
-        if (fillDebug) {
-            fprintf(fillDebug, "Pixels drawn with X > 1200: %d\n", rightPixelCount);
-            fflush(fillDebug);
-        }
     }
     // ---------------------------------------------------------
     // STROKE SUBPATH (PROFESSIONAL - ROUND JOINS & CAPS)
@@ -3302,66 +2825,14 @@ namespace pdf
         int lineCap,
         double miterLimit)
     {
-        // DEBUG: Comprehensive subpath logging
-        static FILE* subpathDebug = nullptr;
-        static int subpathCount = 0;
-        if (!subpathDebug) {
-            char tempPath[MAX_PATH];
-            GetTempPathA(MAX_PATH, tempPath);
-            strcat_s(tempPath, "subpath_debug.txt");
-            subpathDebug = fopen(tempPath, "w");
-        }
-        subpathCount++;
-
-        // Log input
-        if (subpathDebug) {
-            fprintf(subpathDebug, "\n=== strokeSubpath #%d ===\n", subpathCount);
-            fprintf(subpathDebug, "Input: pts.size=%zu, closed=%d, color=0x%08X, lw=%.2f\n",
-                pts.size(), closed ? 1 : 0, color, lineWidthPx);
-
-            // Find right edge points in input (X > 1200)
-            fprintf(subpathDebug, "Input pts with X > 1200:\n");
-            for (size_t i = 0; i < pts.size(); i++) {
-                if (pts[i].x > 1200) {
-                    fprintf(subpathDebug, "  pts[%zu] = (%.2f, %.2f)\n", i, pts[i].x, pts[i].y);
-                }
-            }
-            fflush(subpathDebug);
-        }
+        PDF_TRACE_SCOPE(Stroke, "strokeSubpath", "%zu points, closed=%d, lw=%.2fpx, join=%d, cap=%d",
+            pts.size(), closed ? 1 : 0, lineWidthPx, lineJoin, lineCap);
 
-        // Check bounds for right edge middle
-        bool isRightEdge = false;
-        bool isMiddleY = false;
-        if (pts.size() >= 1) {
-            double minX = pts[0].x, maxX = pts[0].x;
-            double minY = pts[0].y, maxY = pts[0].y;
-            for (const auto& p : pts) {
-                if (p.x < minX) minX = p.x;
-                if (p.x > maxX) maxX = p.x;
-                if (p.y < minY) minY = p.y;
-                if (p.y > maxY) maxY = p.y;
-            }
-            isRightEdge = (maxX > 1100);
-            isMiddleY = (minY > 300 && maxY < 600);
-        }
-
-        if (pts.size() < 2) {
-            if (subpathDebug && isRightEdge && isMiddleY) {
-                fprintf(subpathDebug, "[Subpath #%d] SKIPPED: pts.size()=%zu < 2\n", subpathCount, pts.size());
-                fflush(subpathDebug);
-            }
-            return;
-        }
+        if (pts.size() < 2) return;
         if (miterLimit <= 0) miterLimit = 10.0;
 
         const double hw = lineWidthPx * 0.5;
-        if (hw <= 0.0) {
-            if (subpathDebug && isRightEdge && isMiddleY) {
-                fprintf(subpathDebug, "[Subpath #%d] SKIPPED: hw=%.4f <= 0\n", subpathCount, hw);
-                fflush(subpathDebug);
-            }
-            return;
-        }
+        if (hw <= 0.0) return;
 
         // ✅ DÜZELTME 1: Kapalı path kontrolü düzeltildi
         std::vector<DPoint> P = pts;
@@ -3411,22 +2882,6 @@ namespace pdf
             segs[i] = { {dx, dy}, {nx, ny}, L };
         }
 
-        // DEBUG: Log segments with endpoints on right edge (X > 1200)
-        if (subpathDebug) {
-            fprintf(subpathDebug, "P.size=%zu, segN=%zu\n", P.size(), segN);
-            fprintf(subpathDebug, "Segments with right edge endpoints (X > 1200):\n");
-            for (size_t i = 0; i < segN; ++i) {
-                bool p0Right = (P[i].x > 1200);
-                bool p1Right = (P[i + 1].x > 1200);
-                if (p0Right || p1Right) {
-                    fprintf(subpathDebug, "  seg[%zu]: (%.1f,%.1f)->(%.1f,%.1f), len=%.1f, d=(%.3f,%.3f), n=(%.3f,%.3f)\n",
-                        i, P[i].x, P[i].y, P[i + 1].x, P[i + 1].y, segs[i].len,
-                        segs[i].d.x, segs[i].d.y, segs[i].n.x, segs[i].n.y);
-                }
-            }
-            fflush(subpathDebug);
-        }
-
         std::vector<DPoint> leftC;
         std::vector<DPoint> rightC;
         leftC.reserve(P.size() * 2);
@@ -3629,37 +3084,6 @@ namespace pdf
             }
         }
 
-        // DEBUG: Log leftC and rightC right edge points
-        if (subpathDebug) {
-            fprintf(subpathDebug, "leftC.size=%zu, rightC.size=%zu\n", leftC.size(), rightC.size());
-
-            // Find consecutive right edge points in leftC
-            fprintf(subpathDebug, "leftC points with X > 1200:\n");
-            for (size_t i = 0; i < leftC.size(); i++) {
-                if (leftC[i].x > 1200) {
-                    fprintf(subpathDebug, "  leftC[%zu] = (%.1f, %.1f)\n", i, leftC[i].x, leftC[i].y);
-                }
-            }
-
-            // Check for missing right edge segment
-            fprintf(subpathDebug, "Checking for right edge vertical segment in leftC:\n");
-            bool foundRightVertical = false;
-            for (size_t i = 0; i + 1 < leftC.size(); i++) {
-                if (leftC[i].x > 1200 && leftC[i + 1].x > 1200) {
-                    double dy = std::abs(leftC[i + 1].y - leftC[i].y);
-                    if (dy > 100) {  // Long vertical segment
-                        fprintf(subpathDebug, "  FOUND: leftC[%zu]->[%zu]: (%.1f,%.1f)->(%.1f,%.1f), dy=%.1f\n",
-                            i, i + 1, leftC[i].x, leftC[i].y, leftC[i + 1].x, leftC[i + 1].y, dy);
-                        foundRightVertical = true;
-                    }
-                }
-            }
-            if (!foundRightVertical) {
-                fprintf(subpathDebug, "  *** NO LONG VERTICAL SEGMENT ON RIGHT EDGE! ***\n");
-            }
-            fflush(subpathDebug);
-        }
-
         // Final outline
         std::vector<DPoint> outline;
         outline.reserve(leftC.size() + rightC.size() + capEnd.size() + capStart.size() + 8);
@@ -3678,12 +3102,15 @@ namespace pdf
                 outline.push_back(outline.front());
         }
 
-        if (outline.size() < 3) {
-            if (subpathDebug && isRightEdge && isMiddleY) {
-                fprintf(subpathDebug, "[Subpath #%d] SKIPPED: outline.size()=%zu < 3, pts.size()=%zu\n",
-                    subpathCount, outline.size(), pts.size());
-                fflush(subpathDebug);
-            }
+        PDF_TRACE(Stroke, "outline", "%zu points", outline.size());
+        if (outline.size() < 3) return;
+
+        // Anti-alias: outline'ı yuvarlamadan kapsama ile doldur
+        if (_antiAlias)
+        {
+            _coverage.clear();
+            _coverage.addPolygon(outline);
+            fillCoverage(color, false, false, false);
             return;
         }
 
@@ -3693,62 +3120,7 @@ namespace pdf
         for (auto& p : outline)
             poly.push_back({ (int)std::lround(p.x), (int)std::lround(p.y) });
 
-        // DEBUG: Check if this is right edge middle area
-        static FILE* rasterDebug = nullptr;
-        static int rasterCount = 0;
-        if (!rasterDebug) {
-            char tempPath[MAX_PATH];
-            GetTempPathA(MAX_PATH, tempPath);
-            strcat_s(tempPath, "raster_debug.txt");
-            rasterDebug = fopen(tempPath, "w");
-        }
-        rasterCount++;
-
-        // Find bounds
-        int minX = poly[0].x, maxX = poly[0].x;
-        int minY = poly[0].y, maxY = poly[0].y;
-        for (const auto& p : poly) {
-            if (p.x < minX) minX = p.x;
-            if (p.x > maxX) maxX = p.x;
-            if (p.y < minY) minY = p.y;
-            if (p.y > maxY) maxY = p.y;
-        }
-
-        // Log ALL polygons for debugging
-        if (rasterDebug) {
-            fprintf(rasterDebug, "[Polygon #%d] size=%zu, bounds=(%d,%d)-(%d,%d), color=0x%08X\n",
-                rasterCount, poly.size(), minX, minY, maxX, maxY, color);
-            fprintf(rasterDebug, "  Buffer: _w=%d, _h=%d\n", _w, _h);
-            fprintf(rasterDebug, "  leftC.size=%zu, rightC.size=%zu\n", leftC.size(), rightC.size());
-
-            // Log RIGHT EDGE points (X > 1200)
-            fprintf(rasterDebug, "  RIGHT EDGE POINTS (X > 1200):\n");
-            int rightCount = 0;
-            for (size_t i = 0; i < poly.size(); i++) {
-                if (poly[i].x > 1200) {
-                    fprintf(rasterDebug, "    poly[%zu] = (%d, %d)\n", i, poly[i].x, poly[i].y);
-                    rightCount++;
-                }
-            }
-            fprintf(rasterDebug, "  Total right edge points: %d\n", rightCount);
-
-            // Check if right edge has full Y range
-            int rightMinY = 99999, rightMaxY = -99999;
-            for (size_t i = 0; i < poly.size(); i++) {
-                if (poly[i].x > 1200) {
-                    if (poly[i].y < rightMinY) rightMinY = poly[i].y;
-                    if (poly[i].y > rightMaxY) rightMaxY = poly[i].y;
-                }
-            }
-            fprintf(rasterDebug, "  Right edge Y range: %d - %d (expected ~88 - ~832)\n", rightMinY, rightMaxY);
-
-            fprintf(rasterDebug, "\n");
-            fflush(rasterDebug);
-        }
-
         this->rasterFillPolygon(poly, color, false);
-
-
     }
 
 
@@ -3767,38 +3139,7 @@ namespace pdf
         LogDebug("PdfPainter::strokePath called - %zu segments, lw=%.2f, color=0x%08X",
             path.size(), lineWidth, color);
 
-        // ========== STROKE DEBUG ==========
-        static FILE* strokeDebug = nullptr;
-        static int strokeCount = 0;
-        if (!strokeDebug) {
-            char tempPath[MAX_PATH];
-            GetTempPathA(MAX_PATH, tempPath);
-            strcat_s(tempPath, "stroke_debug.txt");
-            strokeDebug = fopen(tempPath, "w");
-            if (strokeDebug) {
-                fprintf(strokeDebug, "=== STROKE PATH DEBUG ===\n");
-                fprintf(strokeDebug, "_w=%d, _h=%d, _scaleX=%.4f, _scaleY=%.4f, _hasRotate=%d\n\n",
-                    _w, _h, _scaleX, _scaleY, _hasRotate ? 1 : 0);
-                fflush(strokeDebug);
-            }
-        }
-        strokeCount++;
-
-        // Log CTM for first strokes
-        if (strokeDebug && strokeCount <= 20) {
-            fprintf(strokeDebug, "\n=== Stroke #%d ===\n", strokeCount);
-            fprintf(strokeDebug, "CTM=[%.4f %.4f %.4f %.4f %.4f %.4f]\n",
-                ctm.a, ctm.b, ctm.c, ctm.d, ctm.e, ctm.f);
-            fprintf(strokeDebug, "lineWidth=%.2f, color=0x%08X, segments=%zu\n",
-                lineWidth, color, path.size());
-
-            // Log first point
-            if (!path.empty()) {
-                fprintf(strokeDebug, "First point: (%.2f, %.2f)\n", path[0].x, path[0].y);
-            }
-            fflush(strokeDebug);
-        }
-
+        PDF_TRACE_SCOPE(Stroke, "strokePath", "%zu segments, lw=%.2f", path.size(), lineWidth);
 
         // ✅ Eğer path boşsa
         if (path.empty())
@@ -3810,6 +3151,11 @@ namespace pdf
 
         double lwPx = lineWidthToDevicePx(lineWidth, ctm, _scaleX, _scaleY);
 
+        // Anti-alias'ta ince çizgiler kapsamayla soluklaşır; en az bir
+        // çıktı pikseli genişliğinde çiz (SSAA'da bir hücre değil)
+        if (_antiAlias && lwPx < (double)_ssaa)
+            lwPx = (double)_ssaa;
+
         const double tolPx = 0.05;
         const double tolPxSq = tolPx * tolPx;
 
@@ -3833,48 +3179,6 @@ namespace pdf
         auto flush = [&]()
             {
                 if (pts.size() >= 2) {
-                    // DEBUG: Log path bounds
-                    if (strokeDebug) {
-                        double minX = pts[0].x, maxX = pts[0].x;
-                        double minY = pts[0].y, maxY = pts[0].y;
-                        for (const auto& p : pts) {
-                            if (p.x < minX) minX = p.x;
-                            if (p.x > maxX) maxX = p.x;
-                            if (p.y < minY) minY = p.y;
-                            if (p.y > maxY) maxY = p.y;
-                        }
-
-                        // HER STROKE ICIN DETAYLI LOG
-                        fprintf(strokeDebug, "[Stroke #%d] pts=%zu, color=0x%08X, lw=%.2f\n",
-                            strokeCount, pts.size(), color, lwPx);
-                        fprintf(strokeDebug, "  Device bounds: (%.1f,%.1f)-(%.1f,%.1f)\n",
-                            minX, minY, maxX, maxY);
-                        fprintf(strokeDebug, "  Buffer size: _w=%d, _h=%d\n", _w, _h);
-
-                        // Check if any part is out of bounds
-                        bool partiallyOut = (minX < 0 || maxX >= _w || minY < 0 || maxY >= _h);
-                        bool completelyOut = (maxX < 0 || minX >= _w || maxY < 0 || minY >= _h);
-
-                        if (completelyOut) {
-                            fprintf(strokeDebug, "  *** COMPLETELY OUT OF BOUNDS! ***\n");
-                        }
-                        else if (partiallyOut) {
-                            fprintf(strokeDebug, "  ! Partially out of bounds (will be clipped)\n");
-                        }
-
-                        // Log first few points
-                        size_t logCount = (pts.size() < 5) ? pts.size() : 5;
-                        for (size_t i = 0; i < logCount; i++) {
-                            fprintf(strokeDebug, "    pt[%zu] = (%.2f, %.2f)\n", i, pts[i].x, pts[i].y);
-                        }
-                        if (pts.size() > 5) {
-                            fprintf(strokeDebug, "    ... (%zu more points)\n", pts.size() - 5);
-                            fprintf(strokeDebug, "    pt[%zu] = (%.2f, %.2f) (last)\n",
-                                pts.size() - 1, pts.back().x, pts.back().y);
-                        }
-                        fprintf(strokeDebug, "\n");
-                        fflush(strokeDebug);
-                    }
                     strokeSubpath(pts, closed, color, lwPx, lineJoin, lineCap, miterLimit);
                 }
 
@@ -3972,43 +3276,8 @@ namespace pdf
         bool evenOdd,
         float alpha)
     {
-        // ========== DEBUG LOG ==========
-        static FILE* gradDebugFile = nullptr;
-        static int gradCallCount = 0;
-        if (!gradDebugFile) {
-            char tempPath[MAX_PATH];
-            GetTempPathA(MAX_PATH, tempPath);
-            strcat_s(tempPath, "gradient_debug.txt");
-            gradDebugFile = fopen(tempPath, "w");
-            if (gradDebugFile) {
-                fprintf(gradDebugFile, "=== GRADIENT DEBUG LOG ===\n");
-                fprintf(gradDebugFile, "Log file: %s\n", tempPath);
-                fflush(gradDebugFile);
-            }
-        }
-        gradCallCount++;
-
-        int curveCount = 0;
-        int lineCount = 0;
-        int moveCount = 0;
-        for (const auto& seg : clipPath) {
-            if (seg.type == PdfPathSegment::CurveTo) curveCount++;
-            else if (seg.type == PdfPathSegment::LineTo) lineCount++;
-            else if (seg.type == PdfPathSegment::MoveTo) moveCount++;
-        }
-
-        if (gradDebugFile) {
-            fprintf(gradDebugFile, "\n[fillPathWithGradient #%d] path.size=%zu, moves=%d, lines=%d, CURVES=%d\n",
-                gradCallCount, clipPath.size(), moveCount, lineCount, curveCount);
-            fprintf(gradDebugFile, "  clipCTM=[%.4f %.4f %.4f %.4f %.4f %.4f]\n",
-                clipCTM.a, clipCTM.b, clipCTM.c, clipCTM.d, clipCTM.e, clipCTM.f);
-            fprintf(gradDebugFile, "  gradientCTM=[%.4f %.4f %.4f %.4f %.4f %.4f]\n",
-                gradientCTM.a, gradientCTM.b, gradientCTM.c, gradientCTM.d, gradientCTM.e, gradientCTM.f);
-            fprintf(gradDebugFile, "  gradient: (%.2f,%.2f) -> (%.2f,%.2f), %zu stops\n",
-                gradient.x0, gradient.y0, gradient.x1, gradient.y1, gradient.stops.size());
-            fflush(gradDebugFile);
-        }
-        // ========== END DEBUG ==========
+        PDF_TRACE_SCOPE(Shading, "fillPathWithGradient", "%zu segments, %zu stops, alpha=%.2f",
+            clipPath.size(), gradient.stops.size(), alpha);
 
         if (clipPath.empty() || gradient.stops.empty())
         {
@@ -4043,7 +3312,7 @@ namespace pdf
         {
             double rgb[3];
             gradient.evaluateColor(0.5, rgb);
-            uint32_t color = 0xFF000000u |
+            uint32_t color = ((uint32_t)alphaByte(alpha) << 24) |
                 ((int)(rgb[0] * 255) << 16) |
                 ((int)(rgb[1] * 255) << 8) |
                 (int)(rgb[2] * 255);
@@ -4097,8 +3366,8 @@ namespace pdf
 
         int startX = std::max(0, (int)std::floor(devMinX));
         int endX = std::min(_w, (int)std::ceil(devMaxX));
-        int startY = std::max(0, (int)std::floor(devMinY));
-        int endY = std::min(_h, (int)std::ceil(devMaxY));
+        int startY = std::max(_originY, (int)std::floor(devMinY));
+        int endY = std::min(_originY + _h, (int)std::ceil(devMaxY));
 
         if (startX >= endX || startY >= endY) return;
 
@@ -4112,25 +3381,6 @@ namespace pdf
         double subStartX = 0, subStartY = 0;
         bool inSubpath = false;
 
-        // ========== DEBUG: Bezier flatten tracking ==========
-        static FILE* bezierDebugFile = nullptr;
-        static int bezierDebugCallCount = 0;
-        if (!bezierDebugFile) {
-            char tempPath[MAX_PATH];
-            GetTempPathA(MAX_PATH, tempPath);
-            strcat_s(tempPath, "bezier_flatten_debug.txt");
-            bezierDebugFile = fopen(tempPath, "w");
-            if (bezierDebugFile) {
-                fprintf(bezierDebugFile, "=== BEZIER FLATTEN DEBUG ===\n");
-                fflush(bezierDebugFile);
-            }
-        }
-        bezierDebugCallCount++;
-
-        int totalCurves = 0;
-        int totalFlattenedPoints = 0;
-        // ========== END DEBUG SETUP ==========
-
         auto flushPoly = [&]() {
             if (currentPoly.size() >= 3)
             {
@@ -4198,7 +3448,6 @@ namespace pdf
                 const double tolPxSq = tolPx * tolPx;
 
                 // Başlangıç noktasını ekle (duplicate olmasın)
-                size_t pointsBefore = currentPoly.size();
                 if (currentPoly.empty() ||
                     std::abs(currentPoly.back().x - x0d) > 0.1 ||
                     std::abs(currentPoly.back().y - y0d) > 0.1)
@@ -4216,23 +3465,6 @@ namespace pdf
                     tolPxSq
                 );
 
-                // ========== DEBUG: Bezier flatten result ==========
-                totalCurves++;
-                size_t pointsAfter = currentPoly.size();
-                int pointsAdded = (int)(pointsAfter - pointsBefore);
-                totalFlattenedPoints += pointsAdded;
-
-                if (bezierDebugFile && bezierDebugCallCount <= 20 && totalCurves <= 10) {
-                    fprintf(bezierDebugFile, "  Curve #%d: user(%.2f,%.2f)->(%.2f,%.2f)->(%.2f,%.2f)->(%.2f,%.2f)\n",
-                        totalCurves, cpx, cpy, seg.x1, seg.y1, seg.x2, seg.y2, seg.x3, seg.y3);
-                    fprintf(bezierDebugFile, "            device(%.2f,%.2f)->(%.2f,%.2f)->(%.2f,%.2f)->(%.2f,%.2f)\n",
-                        x0d, y0d, x1d, y1d, x2d, y2d, x3d, y3d);
-                    fprintf(bezierDebugFile, "            points: %zu -> %zu (+%d)\n",
-                        pointsBefore, pointsAfter, pointsAdded);
-                    fflush(bezierDebugFile);
-                }
-                // ========== END DEBUG ==========
-
                 cpx = seg.x3; cpy = seg.y3;
             }
             else if (seg.type == PdfPathSegment::Close)
@@ -4253,85 +3485,7 @@ namespace pdf
         }
         flushPoly();
 
-        // ========== DEBUG: Özet bilgi ==========
-        if (bezierDebugFile && bezierDebugCallCount <= 50) {
-            int totalPolyPoints = 0;
-            for (const auto& poly : polygons) {
-                totalPolyPoints += (int)poly.size();
-            }
-            fprintf(bezierDebugFile, "\n[fillPathWithGradient #%d] SUMMARY:\n", bezierDebugCallCount);
-            fprintf(bezierDebugFile, "  Input: %zu path segments\n", clipPath.size());
-            fprintf(bezierDebugFile, "  Curves processed: %d\n", totalCurves);
-            fprintf(bezierDebugFile, "  Flattened points from curves: %d\n", totalFlattenedPoints);
-            fprintf(bezierDebugFile, "  Output polygons: %zu\n", polygons.size());
-            fprintf(bezierDebugFile, "  Total polygon points: %d\n", totalPolyPoints);
-            fprintf(bezierDebugFile, "  clipCTM: [%.4f %.4f %.4f %.4f %.4f %.4f]\n",
-                clipCTM.a, clipCTM.b, clipCTM.c, clipCTM.d, clipCTM.e, clipCTM.f);
-            fflush(bezierDebugFile);
-        }
-
-        // ========== DEBUG: İlk 4 polygon'u SVG olarak kaydet ==========
-        static int svgSaveCount = 0;
-        if (svgSaveCount < 4 && !polygons.empty() && totalCurves > 0) {
-            char svgPath[MAX_PATH];
-            GetTempPathA(MAX_PATH, svgPath);
-            char svgFilename[64];
-            sprintf(svgFilename, "polygon_debug_%d.svg", svgSaveCount);
-            strcat(svgPath, svgFilename);
-
-            FILE* svgFile = fopen(svgPath, "w");
-            if (svgFile) {
-                // SVG bounds hesapla
-                double minX = 1e30, maxX = -1e30, minY = 1e30, maxY = -1e30;
-                for (const auto& poly : polygons) {
-                    for (const auto& pt : poly) {
-                        minX = std::min(minX, pt.x);
-                        maxX = std::max(maxX, pt.x);
-                        minY = std::min(minY, pt.y);
-                        maxY = std::max(maxY, pt.y);
-                    }
-                }
-
-                double width = maxX - minX + 20;
-                double height = maxY - minY + 20;
-
-                fprintf(svgFile, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
-                fprintf(svgFile, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%.0f\" height=\"%.0f\" viewBox=\"%.0f %.0f %.0f %.0f\">\n",
-                    width, height, minX - 10, minY - 10, width, height);
-                fprintf(svgFile, "  <rect x=\"%.0f\" y=\"%.0f\" width=\"%.0f\" height=\"%.0f\" fill=\"white\"/>\n",
-                    minX - 10, minY - 10, width, height);
-
-                // Her polygon'u çiz
-                int polyIdx = 0;
-                const char* colors[] = { "red", "green", "blue", "purple", "orange" };
-                for (const auto& poly : polygons) {
-                    if (poly.size() < 3) continue;
-
-                    fprintf(svgFile, "  <polygon points=\"");
-                    for (size_t i = 0; i < poly.size(); i++) {
-                        fprintf(svgFile, "%.2f,%.2f ", poly[i].x, poly[i].y);
-                    }
-                    fprintf(svgFile, "\" fill=\"none\" stroke=\"%s\" stroke-width=\"1\"/>\n",
-                        colors[polyIdx % 5]);
-
-                    // İlk ve son noktayı işaretle
-                    fprintf(svgFile, "  <circle cx=\"%.2f\" cy=\"%.2f\" r=\"3\" fill=\"%s\"/>\n",
-                        poly[0].x, poly[0].y, colors[polyIdx % 5]);
-
-                    polyIdx++;
-                }
-
-                fprintf(svgFile, "</svg>\n");
-                fclose(svgFile);
-
-                if (bezierDebugFile) {
-                    fprintf(bezierDebugFile, "  SVG saved to: %s\n", svgPath);
-                    fflush(bezierDebugFile);
-                }
-            }
-            svgSaveCount++;
-        }
-        // ========== END DEBUG ==========
+        PDF_TRACE(Shading, "flatten", "%zu polygons", polygons.size());
 
         if (polygons.empty()) return;
 
@@ -4352,78 +3506,50 @@ namespace pdf
         // =====================================================
         // 6. SCANLINE FILL WITH GRADIENT + CORRECT DITHERING
         // =====================================================
-        for (int y = startY; y < endY; ++y)
-        {
-            std::vector<std::pair<double, int>> intersections;
-
-            for (const auto& poly : polygons)
+        _scanEdges.clear();
+        for (const auto& poly : polygons)
+            _scanEdges.addPolygon(poly);
+
+        // Span [x1, x2] of row y: gradient colours into the source row,
+        // then one compositeRow (ExtGState alpha and blend mode there)
+        const uint8_t gradAlpha = alphaByte(alpha);
+        auto paintSpan = [&](int y, int x1, int x2)
             {
-                for (size_t i = 0; i < poly.size(); ++i)
+                if (x1 > x2) return;
+                uint8_t* row = sourceRow(x2 - x1 + 1);
+                for (int x = x1; x <= x2; ++x)
                 {
-                    size_t j = (i + 1) % poly.size();
-
-                    double y0 = poly[i].y;
-                    double y1 = poly[j].y;
-                    double x0 = poly[i].x;
-                    double x1 = poly[j].x;
-
-                    if (std::abs(y1 - y0) < 0.001) continue;
-
-                    double yMin = std::min(y0, y1);
-                    double yMax = std::max(y0, y1);
-
-                    if (y < yMin || y >= yMax) continue;
-
-                    double t = (y - y0) / (y1 - y0);
-                    double ix = x0 + t * (x1 - x0);
-                    int winding = (y1 > y0) ? 1 : -1;
-
-                    intersections.push_back({ ix, winding });
-                }
-            }
+                    // Gradient t parametresi
+                    double px = x - gx0_dev;
+                    double py = y - gy0_dev;
+                    double t = (px * gndx + py * gndy) / gradLen;
+                    t = std::clamp(t, 0.0, 1.0);
+
+                    // Renk hesapla - temiz, dithering yok
+                    double rgb[3];
+                    gradient.evaluateColor(t, rgb);
+
+                    uint8_t* p = row + (size_t)(x - x1) * 4;
+                    p[0] = (uint8_t)std::clamp((int)(rgb[2] * 255.0 + 0.5), 0, 255);
+                    p[1] = (uint8_t)std::clamp((int)(rgb[1] * 255.0 + 0.5), 0, 255);
+                    p[2] = (uint8_t)std::clamp((int)(rgb[0] * 255.0 + 0.5), 0, 255);
+                    p[3] = 255;
+                }
+                compositeRow(y, x1, x2 + 1, row, gradAlpha);
+            };
 
+        for (int y = startY; y < endY; ++y)
+        {
+            const auto& intersections = _scanEdges.row(y);
             if (intersections.empty()) continue;
 
-            std::sort(intersections.begin(), intersections.end(),
-                [](const auto& a, const auto& b) { return a.first < b.first; });
-
             if (evenOdd)
             {
                 for (size_t i = 0; i + 1 < intersections.size(); i += 2)
                 {
-                    int x1 = std::max(startX, (int)std::ceil(intersections[i].first));
-                    int x2 = std::min(endX - 1, (int)std::floor(intersections[i + 1].first));
-
-                    for (int x = x1; x <= x2; ++x)
-                    {
-                        // Gradient t parametresi
-                        double px = x - gx0_dev;
-                        double py = y - gy0_dev;
-                        double t = (px * gndx + py * gndy) / gradLen;
-                        t = std::clamp(t, 0.0, 1.0);
-
-                        // Renk hesapla
-                        double rgb[3];
-                        gradient.evaluateColor(t, rgb);
-
-                        // Temiz render - dithering yok
-                        uint8_t rb = (uint8_t)std::clamp((int)(rgb[0] * 255.0 + 0.5), 0, 255);
-                        uint8_t gb = (uint8_t)std::clamp((int)(rgb[1] * 255.0 + 0.5), 0, 255);
-                        uint8_t bb = (uint8_t)std::clamp((int)(rgb[2] * 255.0 + 0.5), 0, 255);
-
-                        if (alpha < 1.0f && (unsigned)x < (unsigned)_w && (unsigned)y < (unsigned)_h) {
-                            uint8_t sa = (uint8_t)(alpha * 255.0f);
-                            int invA = 255 - sa;
-                            size_t di = (size_t(y) * _w + x) * 4;
-                            _buffer[di + 0] = (uint8_t)((bb * sa + _buffer[di + 0] * invA) / 255);
-                            _buffer[di + 1] = (uint8_t)((gb * sa + _buffer[di + 1] * invA) / 255);
-                            _buffer[di + 2] = (uint8_t)((rb * sa + _buffer[di + 2] * invA) / 255);
-                            _buffer[di + 3] = 255;
-                        } else {
-                            uint32_t color = 0xFF000000u | (rb << 16) | (gb << 8) | bb;
-                            putPixel(x, y, color);
-                        }
-                    }
+                    int x1 = std::max(startX, (int)std::ceil(intersections[i].x));
+                    int x2 = std::min(endX - 1, (int)std::floor(intersections[i + 1].x));
+                    paintSpan(y, x1, x2);
                 }
             }
             else
@@ -4432,42 +3558,13 @@ namespace pdf
 
                 for (size_t i = 0; i + 1 < intersections.size(); ++i)
                 {
-                    winding += intersections[i].second;
+                    winding += intersections[i].winding;
 
                     if (winding != 0)
                     {
-                        int x1 = std::max(startX, (int)std::ceil(intersections[i].first));
-                        int x2 = std::min(endX - 1, (int)std::floor(intersections[i + 1].first));
-
-                        for (int x = x1; x <= x2; ++x)
-                        {
-                            // Gradient t parametresi
-                            double px = x - gx0_dev;
-                            double py = y - gy0_dev;
-                            double t = (px * gndx + py * gndy) / gradLen;
-                            t = std::clamp(t, 0.0, 1.0);
-
-                            // Renk hesapla - temiz, dithering yok
-                            double rgb[3];
-                            gradient.evaluateColor(t, rgb);
-
-                            uint8_t rb = (uint8_t)std::clamp((int)(rgb[0] * 255.0 + 0.5), 0, 255);
-                            uint8_t gb = (uint8_t)std::clamp((int)(rgb[1] * 255.0 + 0.5), 0, 255);
-                            uint8_t bb = (uint8_t)std::clamp((int)(rgb[2] * 255.0 + 0.5), 0, 255);
-
-                            if (alpha < 1.0f && (unsigned)x < (unsigned)_w && (unsigned)y < (unsigned)_h) {
-                                uint8_t sa = (uint8_t)(alpha * 255.0f);
-                                int invA = 255 - sa;
-                                size_t di = (size_t(y) * _w + x) * 4;
-                                _buffer[di + 0] = (uint8_t)((bb * sa + _buffer[di + 0] * invA) / 255);
-                                _buffer[di + 1] = (uint8_t)((gb * sa + _buffer[di + 1] * invA) / 255);
-                                _buffer[di + 2] = (uint8_t)((rb * sa + _buffer[di + 2] * invA) / 255);
-                                _buffer[di + 3] = 255;
-                            } else {
-                                uint32_t color = 0xFF000000u | (rb << 16) | (gb << 8) | bb;
-                                putPixel(x, y, color);
-                            }
-                        }
+                        int x1 = std::max(startX, (int)std::ceil(intersections[i].x));
+                        int x2 = std::min(endX - 1, (int)std::floor(intersections[i + 1].x));
+                        paintSpan(y, x1, x2);
                     }
                 }
             }
@@ -4487,62 +3584,120 @@ namespace pdf
     }
 
 
-    // ==================== SMask Support ====================
-    void PdfPainter::pushSoftMask(const std::vector<uint8_t>& maskAlpha, int maskW, int maskH)
+    // ==================== SMask / Transparency Groups ====================
+    PdfPainter::Layer& PdfPainter::pushLayer(int x0, int y0, int x1, int y1, bool group)
     {
-        if (maskAlpha.empty() || maskW <= 0 || maskH <= 0) return;
-
-        // Mevcut buffer'ı kaydet (SMask öncesi durum)
-        _smaskSavedBuffer = _buffer;
-        _smaskAlpha = maskAlpha;
-        _smaskW = maskW;
-        _smaskH = maskH;
-        _hasSmask = true;
+        const Surface below = surface(_layers.size());
+        x0 = std::max(x0, below.x);
+        y0 = std::max(y0, below.y);
+        x1 = std::min(x1, below.x + below.w);
+        y1 = std::min(y1, below.y + below.h);
+
+        Layer l;
+        l.group = group;
+        if (x0 < x1 && y0 < y1)
+        {
+            l.x = x0; l.y = y0;
+            l.w = x1 - x0; l.h = y1 - y0;
+        }
+        l.pixels.resize((size_t)l.w * l.h * 4);
+
+        // Maske katmanı arka planın kopyasıyla başlar, grup şeffaf
+        if (!group)
+        {
+            for (int y = 0; y < l.h; y++)
+                std::memcpy(&l.pixels[(size_t)y * l.w * 4], below.at(l.x, l.y + y), (size_t)l.w * 4);
+        }
+
+        _layers.push_back(std::move(l));
+        return _layers.back();
     }
 
-    void PdfPainter::popSoftMask()
+    void PdfPainter::pushSoftMask(const std::vector<uint8_t>& maskAlpha, int maskX, int maskY, int maskW, int maskH)
     {
-        if (!_hasSmask) return;
+        // Bozuk maske: boş katman, pop yine eşleşir
+        const bool valid = maskW >= 0 && maskH >= 0 && maskAlpha.size() >= (size_t)maskW * maskH;
+        if (!valid)
+        {
+            LogDebug("pushSoftMask: invalid mask %dx%d (%zu bytes)", maskW, maskH, maskAlpha.size());
+            maskW = maskH = 0;
+        }
 
-        // push ile pop arası çizilen her şeyi mask alpha ile modüle et:
-        // result = saved + (current - saved) * maskAlpha / 255
-        int bufW = _w;
-        int bufH = _h;
+        // Page rows -> buffer rows
+        const int top = maskY - _originY;
+        Layer& l = pushLayer(maskX, top, maskX + maskW, top + maskH, false);
 
-        for (int y = 0; y < bufH; y++) {
-            // Buffer y → mask y (ölçekle, çünkü boyutlar farklı olabilir)
-            int my = (int)((double)y / bufH * _smaskH);
-            if (my >= _smaskH) my = _smaskH - 1;
+        l.mask.resize((size_t)l.w * l.h);
+        for (int y = 0; y < l.h; y++)
+        {
+            std::memcpy(&l.mask[(size_t)y * l.w],
+                &maskAlpha[(size_t)(l.y + y - top) * maskW + (l.x - maskX)], l.w);
+        }
 
-            for (int x = 0; x < bufW; x++) {
-                int mx = (int)((double)x / bufW * _smaskW);
-                if (mx >= _smaskW) mx = _smaskW - 1;
+        PDF_TRACE(Fill, "pushSoftMask", "%dx%d at %d,%d, depth %zu", l.w, l.h, l.x, l.y, _layers.size());
+    }
 
-                uint8_t mA = _smaskAlpha[(size_t)my * _smaskW + mx];
+    void PdfPainter::popSoftMask()
+    {
+        if (_layers.empty() || _layers.back().group)
+        {
+            LogDebug("popSoftMask: no soft mask on top of the layer stack");
+            return;
+        }
+
+        // push ile pop arası çizilenler maskeyle arka plana karışır:
+        // result = saved + (current - saved) * mask / 255
+        Layer l = std::move(_layers.back());
+        _layers.pop_back();
+
+        const Surface below = surface(_layers.size());
+        for (int y = 0; y < l.h; y++)
+        {
+            maskSpanRow(below.at(l.x, l.y + y), &l.pixels[(size_t)y * l.w * 4],
+                &l.mask[(size_t)y * l.w], l.w);
+        }
+    }
 
-                size_t idx = ((size_t)y * bufW + x) * 4;
+    void PdfPainter::beginTransparencyGroup(double minX, double minY, double maxX, double maxY, float alpha)
+    {
+        // Page space -> buffer pixels (rotated pages: the whole target)
+        int x0 = INT_MIN / 2, y0 = INT_MIN / 2, x1 = INT_MAX / 2, y1 = INT_MAX / 2;
+        if (!_hasRotate && minX <= maxX && minY <= maxY)
+        {
+            auto toInt = [](double v) { return (int)std::max(-1e9, std::min(1e9, v)); };
+            x0 = toInt(std::floor(minX * _scaleX));
+            x1 = toInt(std::ceil(maxX * _scaleX));
+            y0 = toInt(std::floor(mapY(maxY * _scaleY))) - _originY;
+            y1 = toInt(std::ceil(mapY(minY * _scaleY))) - _originY;
+        }
 
-                uint8_t sB = _smaskSavedBuffer[idx + 0];
-                uint8_t sG = _smaskSavedBuffer[idx + 1];
-                uint8_t sR = _smaskSavedBuffer[idx + 2];
-                uint8_t sA = _smaskSavedBuffer[idx + 3];
+        Layer& l = pushLayer(x0, y0, x1, y1, true);
+        l.alpha = alphaByte(alpha);
+        l.blendMode = _blendMode;
 
-                uint8_t cB = _buffer[idx + 0];
-                uint8_t cG = _buffer[idx + 1];
-                uint8_t cR = _buffer[idx + 2];
-                uint8_t cA = _buffer[idx + 3];
+        PDF_TRACE(Fill, "beginGroup", "%dx%d at %d,%d, alpha %d, depth %zu",
+            l.w, l.h, l.x, l.y, l.alpha, _layers.size());
+    }
 
-                // Blend: result = saved + (current - saved) * mask / 255
-                _buffer[idx + 0] = (uint8_t)(sB + ((int)(cB - sB) * mA) / 255);
-                _buffer[idx + 1] = (uint8_t)(sG + ((int)(cG - sG) * mA) / 255);
-                _buffer[idx + 2] = (uint8_t)(sR + ((int)(cR - sR) * mA) / 255);
-                _buffer[idx + 3] = (uint8_t)(sA + ((int)(cA - sA) * mA) / 255);
-            }
+    void PdfPainter::endTransparencyGroup()
+    {
+        if (_layers.empty() || !_layers.back().group)
+        {
+            LogDebug("endTransparencyGroup: no group on top of the layer stack");
+            return;
         }
 
-        _smaskSavedBuffer.clear();
-        _smaskAlpha.clear();
-        _hasSmask = false;
+        // Non-isolated groups are treated as isolated ones (the layer
+        // starts transparent); the same result unless the group's own
+        // content uses a blend mode
+        Layer l = std::move(_layers.back());
+        _layers.pop_back();
+        if (l.alpha == 0) return;
+
+        const PdfCompositor& c = compositor(l.blendMode);
+        const Surface below = surface(_layers.size());
+        for (int y = 0; y < l.h; y++)
+            c.row(below.at(l.x, l.y + y), &l.pixels[(size_t)y * l.w * 4], l.w, l.alpha);
     }
 
 } // namespace pdf
\ No newline at end of file
@@ -4,17 +4,18 @@
 #include <string>
 #include <cmath>
 #include <functional>
+#include <memory>
 #include "PdfPath.h"
 #include "PdfGraphicsState.h"
 #include "PdfGradient.h"
 #include "PdfDocument.h"
 #include "IPdfPainter.h"
+#include "PdfScanline.h"
+#include "PdfBlend.h"
+#include "PdfImagePyramid.h"
 
 namespace pdf
 {
-    struct DPoint { double x, y; };
-    struct IPoint { int x, y; };
-
     // Tiling Pattern Structure
     struct PdfPattern {
         std::vector<uint32_t> buffer;
@@ -45,6 +46,7 @@ namespace pdf
         int height() const override { return _h; }
         double scaleX() const override { return _scaleX; }
         double scaleY() const override { return _scaleY; }
+        int pageHeight() const override { return _pageH; }
 
         void clear(uint32_t bgraColor) override;
 
@@ -107,6 +109,14 @@ namespace pdf
             int clipMaxX, int clipMaxY,
             float alpha = 1.0f) override;
 
+        void drawImageWithPageClipRect(
+            const std::vector<uint8_t>& argb,
+            int imgW, int imgH,
+            const PdfMatrix& ctm,
+            double clipMinX, double clipMinY,
+            double clipMaxX, double clipMaxY,
+            float alpha = 1.0f) override;
+
         void drawImageClipped(
             const std::vector<uint8_t>& argb,
             int imgW, int imgH,
@@ -118,6 +128,9 @@ namespace pdf
             double rectMaxX = 0, double rectMaxY = 0,
             float alpha = 1.0f) override;
 
+        // Minified draws of this buffer use its cached mip pyramid
+        void shareImage(const std::shared_ptr<const std::vector<uint8_t>>& argb) override { _sharedImage = argb; }
+
         void setPageRotation(int degrees, double pageWPt, double pageHPt) override;
 
         std::vector<uint8_t> getBuffer() override { return getDownsampledBuffer(); }
@@ -126,9 +139,36 @@ namespace pdf
 
         // ==================== CPU-specific methods ====================
         std::vector<uint8_t> getDownsampledBuffer() const;
-        bool getDownsampledBufferDirect(uint8_t* outBuffer, int outBufferSize) const;
+        // outStride: bytes between output rows (0 = _finalW * 4)
+        bool getDownsampledBufferDirect(uint8_t* outBuffer, int outBufferSize, int outStride = 0) const;
         const std::vector<uint8_t>& getRawBuffer() const { return _buffer; }
 
+        // The painter holds output rows [top, top + height) of a page
+        // pageHeight rows tall (final pixels); drawing uses page
+        // coordinates as usual and lands in the band
+        void setBandOrigin(int top, int pageHeight);
+
+        // Solid fills, strokes and their clips are drawn with exact-area
+        // coverage (anti-aliased at 1x); off = the aliased scanline
+        // filler, one sample per pixel center. Default on.
+        void setAntiAlias(bool on) { _antiAlias = on; }
+        bool antiAlias() const { return _antiAlias; }
+
+        // The buffer is premultiplied BGRA. Every write goes through the
+        // compositor of the current blend mode (PdfBlend), looked up
+        // once in setBlendMode.
+        void setBlendMode(PdfBlendMode mode) override;
+
+        // Solid span [x0, x1) of buffer row y (SSAA pixels, page rows),
+        // composited with the colour's alpha times coverage; clipped to
+        // the buffer. Every solid CPU fill ends up here.
+        void fillSpan(int y, int x0, int x1, uint32_t argb, uint8_t coverage = 255);
+        // Per-pixel coverage: coverage[x] for x in [x0, x1)
+        void fillSpan(int y, int x0, int x1, uint32_t argb, const uint8_t* coverage);
+        // Premultiplied BGRA source pixels for [x0, x1) at opacity alpha
+        // (images, shadings, pattern tiles)
+        void compositeRow(int y, int x0, int x1, const uint8_t* src, uint8_t alpha);
+
         // Single CTM gradient overload (backwards compatibility)
         void fillPathWithGradient(
             const std::vector<PdfPathSegment>& path,
@@ -149,6 +189,33 @@ namespace pdf
         double _scaleX, _scaleY;
         std::vector<uint8_t> _buffer;
 
+        // Band painters: full page height and first row (SSAA pixels)
+        int _pageH = 0;
+        int _originY = 0;
+
+        // Scanline edge tables reused by every fill (path and clip)
+        ScanlineEdgeTable _scanEdges;
+        ScanlineEdgeTable _scanClip;
+
+        bool _antiAlias = true;
+        CoverageRasterizer _coverage;
+        CoverageRasterizer _coverageClip;
+        std::vector<uint8_t> _coverageRow;     // fill x clip coverage of one row
+
+        const PdfCompositor* _composite = &compositor(PdfBlendMode::Normal);
+        std::vector<uint8_t> _sourceRow;       // premultiplied BGRA, see compositeRow
+        uint8_t* sourceRow(int count);
+
+        // Images drawn smaller than their own resolution are sampled from
+        // a mip pyramid (PdfImagePyramid) instead of the bicubic filter.
+        // mipSampler returns null for magnified draws; otherwise pyramid
+        // holds the levels the sampler reads. The pyramid comes from
+        // PdfImagePyramidCache when rgba is the buffer announced through
+        // shareImage, else it is built for this draw only.
+        std::shared_ptr<const std::vector<uint8_t>> _sharedImage;
+        std::unique_ptr<PdfMipSampler> mipSampler(const std::vector<uint8_t>& rgba, int imgW, int imgH,
+            const PdfMatrix& inv, std::shared_ptr<const PdfImagePyramid>& pyramid);
+
         bool _hasRotate = false;
         double _rotA = 1, _rotB = 0, _rotC = 0, _rotD = 1;
         double _rotTx = 0, _rotTy = 0;
@@ -157,8 +224,16 @@ namespace pdf
         void applyRotate(double& x, double& y) const;
         void putPixel(int x, int y, uint32_t bgra);
 
+        // Draws color through _coverage, masked by _coverageClip when clipped
+        void fillCoverage(uint32_t color, bool evenOdd, bool clipped, bool clipEvenOdd);
+
         void rasterFillPolygon(const std::vector<IPoint>& poly, uint32_t color, bool evenOdd);
-        void rasterFillPolygonPattern(const std::vector<IPoint>& poly, const PdfPattern& pattern, bool evenOdd);
+        void rasterFillPolygonPattern(
+            const std::vector<std::vector<IPoint>>& polys,
+            const PdfPattern& pattern,
+            const PdfMatrix& ctm,
+            bool evenOdd,
+            float alpha);
 
         void strokeSubpath(
             const std::vector<DPoint>& pts,
@@ -172,17 +247,50 @@ namespace pdf
         void drawLineDevice(int x1, int y1, int x2, int y2, uint32_t color);
         void blendGray8ToBuffer(int dstX, int dstY, int w, int h, const uint8_t* src, int srcPitch, uint32_t color);
 
-        // ==================== SMask Support ====================
+        // ==================== SMask / Transparency Groups ====================
     public:
-        void pushSoftMask(const std::vector<uint8_t>& maskAlpha, int maskW, int maskH) override;
+        void pushSoftMask(const std::vector<uint8_t>& maskAlpha,
+            int maskX, int maskY, int maskW, int maskH) override;
         void popSoftMask() override;
 
+        void beginTransparencyGroup(double minX, double minY, double maxX, double maxY, float alpha) override;
+        void endTransparencyGroup() override;
+
     private:
-        std::vector<uint8_t> _smaskSavedBuffer;
-        std::vector<uint8_t> _smaskAlpha;
-        int _smaskW = 0;
-        int _smaskH = 0;
-        bool _hasSmask = false;
+        // Offscreen layer of a soft mask or a group. Its rect (buffer
+        // pixels) is clipped to the layer below, so a small masked icon
+        // costs its own size, not the page's. Drawing goes to the top
+        // layer; whatever falls outside its rect is dropped.
+        //   soft mask: starts as a copy of the backdrop; pop moves the
+        //              backdrop toward it by the mask (maskSpanRow)
+        //   group:     starts transparent; end composites it with the
+        //              blend mode and opacity it was begun with
+        struct Layer
+        {
+            bool group = false;
+            int x = 0, y = 0, w = 0, h = 0;
+            std::vector<uint8_t> pixels;       // premultiplied BGRA, w x h
+            std::vector<uint8_t> mask;         // soft mask, w x h
+            uint8_t alpha = 255;               // group opacity
+            PdfBlendMode blendMode = PdfBlendMode::Normal;
+        };
+        std::vector<Layer> _layers;
+
+        // depth 0 = the page buffer, n = _layers[n - 1]
+        struct Surface
+        {
+            uint8_t* pixels;
+            int x, y, w, h;
+
+            uint8_t* at(int px, int py) const { return pixels + ((size_t)(py - y) * w + (px - x)) * 4; }
+        };
+        Surface surface(size_t depth);
+
+        // Buffer row y of the drawing target with [x0, x1) clipped to it;
+        // nullptr when none of the span is inside
+        uint8_t* targetSpan(int y, int& x0, int& x1);
+
+        Layer& pushLayer(int x0, int y0, int x1, int y1, bool group);
     };
 
 } // namespace pdf
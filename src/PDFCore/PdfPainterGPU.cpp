@@ -4,6 +4,7 @@
 #include "PdfPainter.h"  // PdfPattern
 #include "PdfContentParser.h"  // Type3 CharProc rendering
 #include "GlyphCache.h"  // CPU GlyphCache - shared with GPU
+#include "FontCache.h"   // FreeType face locks
 #include "PdfDebug.h"    // LogDebug
 #include <algorithm>
 #include <cmath>
@@ -169,11 +170,12 @@ namespace pdf
         }
 
         // Pop ALL remaining soft mask layers from D2D render target
+        // (empty entries stand for pushes that failed and hold no layer)
         while (!_softMaskLayerStack.empty() && _renderTarget)
         {
-            _renderTarget->PopLayer();
             SoftMaskLayerInfo smInfo = _softMaskLayerStack.top();
             _softMaskLayerStack.pop();
+            if (smInfo.layer) _renderTarget->PopLayer();
             if (smInfo.layer) smInfo.layer->Release();
             if (smInfo.maskBrush) smInfo.maskBrush->Release();
             if (smInfo.maskBitmap) smInfo.maskBitmap->Release();
@@ -183,13 +185,22 @@ namespace pdf
         // This is critical - D2D crashes if EndDraw is called with layers still pushed
         while (!_clipLayerStack.empty() && _renderTarget)
         {
-            _renderTarget->PopLayer();
             ClipLayerInfo info = _clipLayerStack.top();
             _clipLayerStack.pop();
+            if (info.layer) _renderTarget->PopLayer();
             if (info.layer) info.layer->Release();
             if (info.geometry) info.geometry->Release();
         }
 
+        // Transparency groups left open by an aborted page
+        while (!_groupLayerStack.empty() && _renderTarget)
+        {
+            ID2D1Layer* layer = _groupLayerStack.top();
+            _groupLayerStack.pop();
+            if (layer) _renderTarget->PopLayer();
+            if (layer) layer->Release();
+        }
+
         // End any active draw session
         if (_inDraw && _renderTarget)
         {
@@ -1490,6 +1501,9 @@ namespace pdf
 
         FT_Face face = font->ftFace;
 
+        // Shared with CPU renders on other threads (FontCache)
+        std::lock_guard<std::recursive_mutex> faceLock(freeTypeFaceMutex(face));
+
         // Font size in pixels (Y-scale for glyph height)
         double pxSize = fontSizePt * _scaleY;
 
@@ -1594,7 +1608,7 @@ namespace pdf
 
                 // Use CPU GlyphCache for glyph rendering
                 if (gid != 0) {
-                    const CachedGlyph* cached = GlyphCache::instance().getOrRender(face, fontHash, gid, pixelSize);
+                    std::shared_ptr<const CachedGlyph> cached = GlyphCache::instance().getOrRender(face, fontHash, gid, pixelSize);
 
                     if (cached && !cached->bitmap.empty()) {
                         bool useFreeTypeWidth = font->cidWidths.empty();
@@ -1682,7 +1696,7 @@ namespace pdf
 
                 // Use CPU GlyphCache
                 if (gid != 0) {
-                    const CachedGlyph* cached = GlyphCache::instance().getOrRender(face, fontHash, gid, pixelSize);
+                    std::shared_ptr<const CachedGlyph> cached = GlyphCache::instance().getOrRender(face, fontHash, gid, pixelSize);
 
                     if (cached && !cached->bitmap.empty()) {
                         bool useFreeTypeWidth = !font->hasWidths;
@@ -2743,7 +2757,7 @@ namespace pdf
 
     void PdfPainterGPU::pushClipPath(const std::vector<PdfPathSegment>& clipPath, const PdfMatrix& clipCTM, bool evenOdd)
     {
-        if (!_renderTarget || clipPath.empty()) return;
+        if (!_renderTarget) return;
 
         // Flush any pending operations before changing clip state
         flushFillBatch();
@@ -2753,14 +2767,19 @@ namespace pdf
         if (!_inDraw) beginDraw();
 
         // Create geometry from clip path (implicitClose=true: clips use filled region)
-        ID2D1PathGeometry* geometry = createPathGeometry(clipPath, clipCTM, evenOdd, true);
-        if (!geometry) return;
+        // Nothing pushed: an empty entry keeps the matching pop balanced
+        ID2D1PathGeometry* geometry = clipPath.empty() ? nullptr : createPathGeometry(clipPath, clipCTM, evenOdd, true);
+        if (!geometry) {
+            _clipLayerStack.push(ClipLayerInfo());
+            return;
+        }
 
         // Create and push layer
         ID2D1Layer* layer = nullptr;
         HRESULT hr = _renderTarget->CreateLayer(&layer);
         if (FAILED(hr) || !layer) {
             geometry->Release();
+            _clipLayerStack.push(ClipLayerInfo());
             return;
         }
 
@@ -2784,12 +2803,10 @@ namespace pdf
         flushFillBatch();
         flushGlyphBatch();
 
-        // Pop the layer
-        _renderTarget->PopLayer();
-
-        // Release resources
+        // Release resources; an empty entry never pushed a layer
         ClipLayerInfo info = _clipLayerStack.top();
         _clipLayerStack.pop();
+        if (info.layer) _renderTarget->PopLayer();
 
         if (info.layer) info.layer->Release();
         if (info.geometry) info.geometry->Release();
@@ -2799,9 +2816,10 @@ namespace pdf
     // SOFT MASK (SMask) - D2D Layer with Opacity Bitmap
     // ============================================
 
-    void PdfPainterGPU::pushSoftMask(const std::vector<uint8_t>& maskAlpha, int maskW, int maskH)
+    void PdfPainterGPU::pushSoftMask(const std::vector<uint8_t>& maskAlpha,
+        int maskX, int maskY, int maskW, int maskH)
     {
-        if (!_renderTarget || maskAlpha.empty() || maskW <= 0 || maskH <= 0) return;
+        if (!_renderTarget) return;
 
         // Flush any pending operations before changing mask state
         flushFillBatch();
@@ -2810,6 +2828,17 @@ namespace pdf
         bool wasInDraw = _inDraw;
         if (!_inDraw) beginDraw();
 
+        // Mask entirely off the page: a layer that clips everything, so
+        // the matching pop still finds it
+        if (maskW <= 0 || maskH <= 0 || maskAlpha.size() < (size_t)maskW * maskH)
+        {
+            SoftMaskLayerInfo info;
+            if (SUCCEEDED(_renderTarget->CreateLayer(&info.layer)) && info.layer)
+                _renderTarget->PushLayer(D2D1::LayerParameters(D2D1::RectF(0, 0, 0, 0)), info.layer);
+            _softMaskLayerStack.push(info);
+            return;
+        }
+
         // Convert grayscale alpha mask to BGRA premultiplied bitmap
         // Each pixel: (R,G,B) = (alpha, alpha, alpha), A = alpha
         // This creates a luminosity-based opacity mask
@@ -2842,6 +2871,7 @@ namespace pdf
         if (FAILED(hr) || !maskBitmap)
         {
             LogDebug("pushSoftMask: Failed to create mask bitmap (hr=0x%08x)", hr);
+            _softMaskLayerStack.push(SoftMaskLayerInfo());
             return;
         }
 
@@ -2855,10 +2885,13 @@ namespace pdf
             ),
             &maskBrush
         );
+        if (SUCCEEDED(hr) && maskBrush)
+            maskBrush->SetTransform(D2D1::Matrix3x2F::Translation((float)maskX, (float)maskY));
         if (FAILED(hr) || !maskBrush)
         {
             LogDebug("pushSoftMask: Failed to create bitmap brush (hr=0x%08x)", hr);
             maskBitmap->Release();
+            _softMaskLayerStack.push(SoftMaskLayerInfo());
             return;
         }
 
@@ -2870,14 +2903,16 @@ namespace pdf
             LogDebug("pushSoftMask: Failed to create layer (hr=0x%08x)", hr);
             maskBrush->Release();
             maskBitmap->Release();
+            _softMaskLayerStack.push(SoftMaskLayerInfo());
             return;
         }
 
         // Push layer with opacity mask brush
-        // The mask brush acts as per-pixel opacity for everything drawn within this layer
+        // The mask brush acts as per-pixel opacity for everything drawn within this layer;
+        // outside the mask rect nothing shows
         _renderTarget->PushLayer(
             D2D1::LayerParameters(
-                D2D1::InfiniteRect(),    // content bounds
+                D2D1::RectF((float)maskX, (float)maskY, (float)(maskX + maskW), (float)(maskY + maskH)),
                 nullptr,                  // no geometric clip
                 D2D1_ANTIALIAS_MODE_PER_PRIMITIVE,
                 D2D1::IdentityMatrix(),  // mask transform
@@ -2906,12 +2941,10 @@ namespace pdf
         flushFillBatch();
         flushGlyphBatch();
 
-        // Pop the layer
-        _renderTarget->PopLayer();
-
-        // Release resources
+        // Release resources; an empty entry never pushed a layer
         SoftMaskLayerInfo info = _softMaskLayerStack.top();
         _softMaskLayerStack.pop();
+        if (info.layer) _renderTarget->PopLayer();
 
         if (info.layer) info.layer->Release();
         if (info.maskBrush) info.maskBrush->Release();
@@ -2920,6 +2953,48 @@ namespace pdf
         LogDebug("popSoftMask: Popped (stack depth: %zu)", _softMaskLayerStack.size());
     }
 
+    void PdfPainterGPU::beginTransparencyGroup(double minX, double minY, double maxX, double maxY, float alpha)
+    {
+        if (!_renderTarget) return;
+
+        flushFillBatch();
+        flushGlyphBatch();
+        if (!_inDraw) beginDraw();
+
+        ID2D1Layer* layer = nullptr;
+        if (FAILED(_renderTarget->CreateLayer(&layer)) || !layer)
+        {
+            LogDebug("beginTransparencyGroup: Failed to create layer");
+            _groupLayerStack.push(nullptr); // keeps endTransparencyGroup balanced
+            return;
+        }
+
+        // Page space -> device: y grows downward
+        const D2D1_RECT_F bounds = D2D1::RectF(
+            (float)(std::max(minX, -1e7) * _scaleX), (float)(_h - std::min(maxY, 1e7) * _scaleY),
+            (float)(std::min(maxX, 1e7) * _scaleX), (float)(_h - std::max(minY, -1e7) * _scaleY));
+
+        _renderTarget->PushLayer(
+            D2D1::LayerParameters(bounds, nullptr, D2D1_ANTIALIAS_MODE_PER_PRIMITIVE,
+                D2D1::IdentityMatrix(), alpha, nullptr, D2D1_LAYER_OPTIONS_NONE),
+            layer);
+        _groupLayerStack.push(layer);
+    }
+
+    void PdfPainterGPU::endTransparencyGroup()
+    {
+        if (!_renderTarget || _groupLayerStack.empty()) return;
+
+        flushFillBatch();
+        flushGlyphBatch();
+
+        ID2D1Layer* layer = _groupLayerStack.top();
+        _groupLayerStack.pop();
+        if (!layer) return; // begin failed and pushed nothing
+        _renderTarget->PopLayer();
+        layer->Release();
+    }
+
     // ============================================
     // PAGE RENDERING LIFECYCLE - BATCHING
     // ============================================
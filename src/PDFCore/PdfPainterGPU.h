@@ -140,9 +140,15 @@ namespace pdf
         void popClipPath() override;
 
         // ==================== SOFT MASK (SMask) ====================
-        void pushSoftMask(const std::vector<uint8_t>& maskAlpha, int maskW, int maskH) override;
+        void pushSoftMask(const std::vector<uint8_t>& maskAlpha,
+            int maskX, int maskY, int maskW, int maskH) override;
         void popSoftMask() override;
 
+        // ==================== TRANSPARENCY GROUP ====================
+        // D2D layer at the group opacity; blend modes are not supported
+        void beginTransparencyGroup(double minX, double minY, double maxX, double maxY, float alpha) override;
+        void endTransparencyGroup() override;
+
     private:
         int _w, _h;
         double _scaleX, _scaleY;
@@ -225,6 +231,7 @@ namespace pdf
             ID2D1BitmapBrush* maskBrush = nullptr;
         };
         std::stack<SoftMaskLayerInfo> _softMaskLayerStack;
+        std::stack<ID2D1Layer*> _groupLayerStack;
 
         // Direct2D objects - factories are STATIC (shared across all instances)
         static ID2D1Factory1* s_d2dFactory;
@@ -2,14 +2,53 @@
 #include "PdfParser.h"
 #include "PdfDebug.h"
 #include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <iostream>
 #include <chrono>
 
 namespace pdf
 {
-    PdfParser::PdfParser(const std::vector<uint8_t>& data)
-        : _data(data), _lexer(data)
+    // ============================================
+    // SHARED SCALARS (see PdfObject.h)
+    // ============================================
+    const PdfObjectPtr& pdfNullObject()
+    {
+        static const PdfObjectPtr obj = std::make_shared<PdfNull>();
+        return obj;
+    }
+
+    const PdfObjectPtr& pdfBooleanObject(bool v)
+    {
+        static const PdfObjectPtr objTrue = std::make_shared<PdfBoolean>(true);
+        static const PdfObjectPtr objFalse = std::make_shared<PdfBoolean>(false);
+        return v ? objTrue : objFalse;
+    }
+
+    PdfObjectPtr pdfNumberObject(double v)
+    {
+        // Küçük tamsayılar (genişlikler, kutular, gen numaraları) paylaşılır
+        static const int POOL_MIN = -128;
+        static const int POOL_MAX = 1023;
+        static const std::vector<PdfObjectPtr> pool = [] {
+            std::vector<PdfObjectPtr> p;
+            p.reserve(POOL_MAX - POOL_MIN + 1);
+            for (int i = POOL_MIN; i <= POOL_MAX; i++)
+                p.push_back(std::make_shared<PdfNumber>((double)i));
+            return p;
+        }();
+
+        if (v >= POOL_MIN && v <= POOL_MAX)
+        {
+            int i = (int)v;
+            if ((double)i == v && !(v == 0 && std::signbit(v)))
+                return pool[i - POOL_MIN];
+        }
+        return std::make_shared<PdfNumber>(v);
+    }
+
+    PdfParser::PdfParser(PdfByteView data, std::shared_ptr<const uint8_t> owner)
+        : _data(data), _owner(std::move(owner)), _lexer(data)
     {
     }
 
@@ -45,10 +84,6 @@ namespace pdf
                     safetyCounter, _objects.size());
             }
 
-            Token t = _lexer.peekToken();
-            if (t.type == TokenType::EndOfFile)
-                break;
-
             Token t1 = _lexer.nextToken();
             if (t1.type == TokenType::EndOfFile)
                 break;
@@ -63,7 +98,7 @@ namespace pdf
             if (t3.type != TokenType::Keyword || t3.text != "obj")
                 continue;
 
-            int objNum = std::atoi(t1.text.c_str());
+            int objNum = t1.intValue();
 
             LogDebug("Parsing object %d at position %zu", objNum, _lexer.getPosition());
 
@@ -99,7 +134,7 @@ namespace pdf
         if (tok.type == TokenType::Delimiter && tok.text == "<<")
         {
             auto dict = parseDictionary();
-            Token next = _lexer.peekToken();
+            const Token& next = _lexer.peekToken();
             if (next.type == TokenType::Keyword && next.text == "stream")
             {
                 _lexer.nextToken();
@@ -119,17 +154,17 @@ namespace pdf
         switch (tok.type)
         {
         case TokenType::Number:
-            return std::make_shared<PdfNumber>(std::atof(tok.text.c_str()));
+            return pdfNumberObject(tok.number);
         case TokenType::String:
-            return std::make_shared<PdfString>(tok.text);
+            return std::make_shared<PdfString>(tok.value);
         case TokenType::HexString:
-            return std::make_shared<PdfString>(tok.text);
+            return std::make_shared<PdfString>(tok.value);
         case TokenType::Name:
-            return std::make_shared<PdfName>(tok.text);
+            return std::make_shared<PdfName>(std::string(tok.text));
         case TokenType::Keyword:
-            if (tok.text == "null")  return std::make_shared<PdfNull>();
-            if (tok.text == "true")  return std::make_shared<PdfBoolean>(true);
-            if (tok.text == "false") return std::make_shared<PdfBoolean>(false);
+            if (tok.text == "null")  return pdfNullObject();
+            if (tok.text == "true")  return pdfBooleanObject(true);
+            if (tok.text == "false") return pdfBooleanObject(false);
             break;
         default: break;
         }
@@ -147,7 +182,7 @@ namespace pdf
 
         while (safety++ < MAX_ITEMS)
         {
-            Token t = _lexer.peekToken();
+            const Token& t = _lexer.peekToken();
             if (t.type == TokenType::Delimiter && t.text == "]")
             {
                 _lexer.nextToken();
@@ -170,7 +205,7 @@ namespace pdf
                 continue;
             }
 
-            if (tok.type == TokenType::Number)
+            if (tok.type == TokenType::Number && _lexer.mayBeRefTail())
             {
                 size_t savePos = _lexer.getPosition();
 
@@ -182,8 +217,8 @@ namespace pdf
                     {
                         arr->items.push_back(
                             std::make_shared<PdfIndirectRef>(
-                                std::atoi(tok.text.c_str()),
-                                std::atoi(t2.text.c_str())
+                                tok.intValue(),
+                                t2.intValue()
                             )
                         );
                         continue;
@@ -208,6 +243,7 @@ namespace pdf
     std::shared_ptr<PdfDictionary> PdfParser::parseDictionary()
     {
         auto dict = std::make_shared<PdfDictionary>();
+        std::vector<PdfDictEntries::value_type> items;
         int safety = 0;
 
         while (safety++ < 10000)
@@ -223,17 +259,17 @@ namespace pdf
 
             if (val.type == TokenType::Delimiter && val.text == "<<")
             {
-                dict->entries[key.text] = parseDictionary();
+                items.emplace_back(key.text, parseDictionary());
                 continue;
             }
 
             if (val.type == TokenType::Delimiter && val.text == "[")
             {
-                dict->entries[key.text] = parseArray();
+                items.emplace_back(key.text, parseArray());
                 continue;
             }
 
-            if (val.type == TokenType::Number)
+            if (val.type == TokenType::Number && _lexer.mayBeRefTail())
             {
                 size_t savePos = _lexer.getPosition();
 
@@ -243,24 +279,25 @@ namespace pdf
                     Token t3 = _lexer.nextToken();
                     if (t3.type == TokenType::Keyword && t3.text == "R")
                     {
-                        dict->entries[key.text] =
+                        items.emplace_back(key.text,
                             std::make_shared<PdfIndirectRef>(
-                                std::atoi(val.text.c_str()),
-                                std::atoi(t2.text.c_str())
-                            );
+                                val.intValue(),
+                                t2.intValue()
+                            ));
                         continue;
                     }
                 }
 
                 // ❗ Referans değil → geri sar
                 _lexer.setPosition(savePos);
-                dict->entries[key.text] = parseAtomicObject(val);
+                items.emplace_back(key.text, parseAtomicObject(val));
                 continue;
             }
 
-            dict->entries[key.text] = parseAtomicObject(val);
+            items.emplace_back(key.text, parseAtomicObject(val));
         }
 
+        dict->entries.assign(std::move(items));
         return dict;
     }
 
@@ -282,13 +319,11 @@ namespace pdf
         size_t length = 0;
 
         // /Length veya Length anahtarından uzunluğu almaya çalış
-        auto lenObj = dict->get("/Length");
-        if (!lenObj)
-            lenObj = dict->get("Length");
+        auto lenObj = dict->get(PdfKeys::Length);
 
         if (lenObj)
         {
-            auto num = std::dynamic_pointer_cast<PdfNumber>(lenObj);
+            auto num = pdfCast<PdfNumber>(lenObj);
             if (num && num->value > 0)
                 length = static_cast<size_t>(num->value);
         }
@@ -312,18 +347,21 @@ namespace pdf
                 newPos = _data.size(); // dosya bozuksa sonuna kadar
         }
 
-        // *** ÖNEMLİ: Artık stream ham baytlarını gerçekten okuyalım ***
-        std::vector<uint8_t> bytes;
+        // Stream ham baytları: paylaşılan depolama varsa kopyasız dilim, yoksa kopya
+        PdfBytes bytes;
         if (newPos > pos && newPos <= _data.size())
         {
-            bytes.assign(_data.begin() + pos, _data.begin() + newPos);
+            if (_owner)
+                bytes = PdfBytes::slice(_owner, _data.data() + pos, newPos - pos);
+            else
+                bytes = std::vector<uint8_t>(_data.begin() + pos, _data.begin() + newPos);
         }
 
         // Lexer konumunu endstream'in başına taşı
         _lexer.setPosition(newPos);
 
         // Eski koddaki "dummy" vektör yerine gerçek veriyi veriyoruz
-        return std::make_shared<PdfStream>(dict, bytes);
+        return std::make_shared<PdfStream>(dict, std::move(bytes));
     }
 
 
@@ -332,8 +370,10 @@ namespace pdf
         return _objects;
     }
 
-    PdfObjectPtr PdfParser::parseObjectAt(size_t offset)
+    PdfObjectPtr PdfParser::parseObjectAt(size_t offset, int* headerObjNum)
     {
+        if (headerObjNum) *headerObjNum = -1;
+
         _lexer.setPosition(offset);
         Token t1 = _lexer.peekToken();
         if (t1.type == TokenType::Number)
@@ -347,6 +387,7 @@ namespace pdf
                 if (t3.type == TokenType::Keyword && t3.text == "obj")
                 {
                     _lexer.nextToken();
+                    if (headerObjNum) *headerObjNum = t1.intValue();
                 }
             }
         }
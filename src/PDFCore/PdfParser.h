@@ -11,15 +11,19 @@ namespace pdf
     class PdfParser
     {
     public:
-        PdfParser(const std::vector<uint8_t>& data);
+        // owner: shared storage behind data. When set, stream bodies are
+        // slices of it instead of copies (mapped / shared document bytes).
+        PdfParser(PdfByteView data, std::shared_ptr<const uint8_t> owner = nullptr);
 
         bool parse();  // PDF iindeki tm indirect object'leri okumaya alr
         const std::map<int, PdfObjectPtr>& objects() const;
-        PdfObjectPtr parseObjectAt(size_t offset);
+        // headerObjNum (optional): receives N from an "N G obj" header at offset, or -1
+        PdfObjectPtr parseObjectAt(size_t offset, int* headerObjNum = nullptr);
         
 
     private:
-        const std::vector<uint8_t>& _data;
+        PdfByteView _data;
+        std::shared_ptr<const uint8_t> _owner;
         PdfLexer _lexer;
         std::map<int, PdfObjectPtr> _objects;
 
@@ -0,0 +1,263 @@
+#include "pch.h"
+#include "PdfPlatform.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pdf
+{
+    namespace platform
+    {
+#ifdef _WIN32
+
+        std::string systemFontPath(const char* fileName)
+        {
+            char winDir[MAX_PATH];
+            UINT len = GetWindowsDirectoryA(winDir, MAX_PATH);
+            std::string dir = (len > 0 && len < MAX_PATH) ? std::string(winDir) : std::string("C:\\Windows");
+            return dir + "\\Fonts\\" + fileName;
+        }
+
+        static std::shared_ptr<const uint8_t> mapHandle(HANDLE file, size_t& size)
+        {
+            size = 0;
+            if (file == INVALID_HANDLE_VALUE)
+                return nullptr;
+
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0 ||
+                (unsigned long long)fileSize.QuadPart > (unsigned long long)SIZE_MAX)
+            {
+                CloseHandle(file);
+                return nullptr;
+            }
+
+            HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(file);
+            if (!mapping)
+                return nullptr;
+
+            // The view stays valid after the mapping handle is closed
+            const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+            if (!view)
+                return nullptr;
+
+            size = (size_t)fileSize.QuadPart;
+            return std::shared_ptr<const uint8_t>((const uint8_t*)view,
+                [](const uint8_t* p) { UnmapViewOfFile(p); });
+        }
+
+        std::shared_ptr<const uint8_t> mapFile(const wchar_t* path, size_t& size)
+        {
+            return mapHandle(CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr), size);
+        }
+
+        std::shared_ptr<const uint8_t> mapFile(const char* path, size_t& size)
+        {
+            return mapHandle(CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr), size);
+        }
+
+#else
+
+        std::string narrowPath(const wchar_t* path)
+        {
+            std::string out;
+            if (!path) return out;
+
+            // wchar_t is UTF-32 here
+            for (; *path; ++path)
+            {
+                uint32_t cp = (uint32_t)*path;
+                if (cp < 0x80) {
+                    out.push_back((char)cp);
+                }
+                else if (cp < 0x800) {
+                    out.push_back((char)(0xC0 | (cp >> 6)));
+                    out.push_back((char)(0x80 | (cp & 0x3F)));
+                }
+                else if (cp < 0x10000) {
+                    out.push_back((char)(0xE0 | (cp >> 12)));
+                    out.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+                    out.push_back((char)(0x80 | (cp & 0x3F)));
+                }
+                else {
+                    out.push_back((char)(0xF0 | (cp >> 18)));
+                    out.push_back((char)(0x80 | ((cp >> 12) & 0x3F)));
+                    out.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+                    out.push_back((char)(0x80 | (cp & 0x3F)));
+                }
+            }
+            return out;
+        }
+
+        std::shared_ptr<const uint8_t> mapFile(const char* path, size_t& size)
+        {
+            size = 0;
+            int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                return nullptr;
+
+            struct stat st;
+            if (::fstat(fd, &st) != 0 || st.st_size <= 0)
+            {
+                ::close(fd);
+                return nullptr;
+            }
+
+            size_t len = (size_t)st.st_size;
+            void* addr = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (addr == MAP_FAILED)
+                return nullptr;
+
+            size = len;
+            return std::shared_ptr<const uint8_t>((const uint8_t*)addr,
+                [len](const uint8_t* p) { ::munmap((void*)p, len); });
+        }
+
+        std::shared_ptr<const uint8_t> mapFile(const wchar_t* path, size_t& size)
+        {
+            return mapFile(narrowPath(path).c_str(), size);
+        }
+
+        static bool fileExists(const std::string& path)
+        {
+            FILE* f = std::fopen(path.c_str(), "rb");
+            if (!f) return false;
+            std::fclose(f);
+            return true;
+        }
+
+        // Windows font file -> metric-compatible substitutes, best first
+        struct FontSubstitute
+        {
+            const char* windowsName;
+            const char* liberation;
+            const char* dejavu;
+        };
+
+        static const FontSubstitute kFontSubstitutes[] = {
+            { "times.ttf",    "LiberationSerif-Regular.ttf",    "DejaVuSerif.ttf" },
+            { "timesbd.ttf",  "LiberationSerif-Bold.ttf",       "DejaVuSerif-Bold.ttf" },
+            { "timesi.ttf",   "LiberationSerif-Italic.ttf",     "DejaVuSerif-Italic.ttf" },
+            { "timesbi.ttf",  "LiberationSerif-BoldItalic.ttf", "DejaVuSerif-BoldItalic.ttf" },
+            { "georgia.ttf",  "LiberationSerif-Regular.ttf",    "DejaVuSerif.ttf" },
+            { "georgiab.ttf", "LiberationSerif-Bold.ttf",       "DejaVuSerif-Bold.ttf" },
+            { "georgiai.ttf", "LiberationSerif-Italic.ttf",     "DejaVuSerif-Italic.ttf" },
+            { "georgiaz.ttf", "LiberationSerif-BoldItalic.ttf", "DejaVuSerif-BoldItalic.ttf" },
+            { "arial.ttf",    "LiberationSans-Regular.ttf",     "DejaVuSans.ttf" },
+            { "arialbd.ttf",  "LiberationSans-Bold.ttf",        "DejaVuSans-Bold.ttf" },
+            { "ariali.ttf",   "LiberationSans-Italic.ttf",      "DejaVuSans-Oblique.ttf" },
+            { "arialbi.ttf",  "LiberationSans-BoldItalic.ttf",  "DejaVuSans-BoldOblique.ttf" },
+            { "verdana.ttf",  "LiberationSans-Regular.ttf",     "DejaVuSans.ttf" },
+            { "verdanab.ttf", "LiberationSans-Bold.ttf",        "DejaVuSans-Bold.ttf" },
+            { "verdanai.ttf", "LiberationSans-Italic.ttf",      "DejaVuSans-Oblique.ttf" },
+            { "verdanaz.ttf", "LiberationSans-BoldItalic.ttf",  "DejaVuSans-BoldOblique.ttf" },
+            { "calibri.ttf",  "LiberationSans-Regular.ttf",     "DejaVuSans.ttf" },
+            { "calibrib.ttf", "LiberationSans-Bold.ttf",        "DejaVuSans-Bold.ttf" },
+            { "calibrii.ttf", "LiberationSans-Italic.ttf",      "DejaVuSans-Oblique.ttf" },
+            { "calibriz.ttf", "LiberationSans-BoldItalic.ttf",  "DejaVuSans-BoldOblique.ttf" },
+            { "segoeui.ttf",  "LiberationSans-Regular.ttf",     "DejaVuSans.ttf" },
+            { "tahoma.ttf",   "LiberationSans-Regular.ttf",     "DejaVuSans.ttf" },
+            { "cour.ttf",     "LiberationMono-Regular.ttf",     "DejaVuSansMono.ttf" },
+            { "courbd.ttf",   "LiberationMono-Bold.ttf",        "DejaVuSansMono-Bold.ttf" },
+            { "couri.ttf",    "LiberationMono-Italic.ttf",      "DejaVuSansMono-Oblique.ttf" },
+            { "courbi.ttf",   "LiberationMono-BoldItalic.ttf",  "DejaVuSansMono-BoldOblique.ttf" },
+            { "symbol.ttf",   "LiberationSans-Regular.ttf",     "DejaVuSans.ttf" },
+            { "wingding.ttf", "LiberationSans-Regular.ttf",     "DejaVuSans.ttf" },
+        };
+
+        static const char* kFontDirs[] = {
+            "/usr/share/fonts/truetype/liberation",
+            "/usr/share/fonts/truetype/liberation2",
+            "/usr/share/fonts/liberation",
+            "/usr/share/fonts/liberation-sans",
+            "/usr/share/fonts/liberation-serif",
+            "/usr/share/fonts/liberation-mono",
+            "/usr/share/fonts/truetype/dejavu",
+            "/usr/share/fonts/dejavu",
+            "/usr/local/share/fonts",
+        };
+
+        static std::string findInFontDirs(const char* fileName)
+        {
+            for (const char* dir : kFontDirs)
+            {
+                std::string path = std::string(dir) + "/" + fileName;
+                if (fileExists(path))
+                    return path;
+            }
+            return std::string();
+        }
+
+        std::string systemFontPath(const char* fileName)
+        {
+            // Deployments can ship the original Windows fonts
+            const char* userDir = std::getenv("MANASPDF_FONT_DIR");
+            if (userDir && *userDir)
+            {
+                std::string path = std::string(userDir) + "/" + fileName;
+                if (fileExists(path))
+                    return path;
+            }
+
+            const FontSubstitute* sub = &kFontSubstitutes[8]; // arial.ttf
+            for (const auto& s : kFontSubstitutes)
+            {
+                if (std::strcmp(s.windowsName, fileName) == 0)
+                {
+                    sub = &s;
+                    break;
+                }
+            }
+
+            std::string path = findInFontDirs(sub->liberation);
+            if (path.empty())
+                path = findInFontDirs(sub->dejavu);
+            if (path.empty())
+                path = findInFontDirs("DejaVuSans.ttf");
+            return path;
+        }
+
+#endif
+
+        bool cpuHasAvx2()
+        {
+            static const bool has = []()
+                {
+#if defined(_M_X64) || defined(_M_IX86)
+                    int info[4] = { 0 };
+                    __cpuid(info, 0);
+                    if (info[0] < 7) return false;
+                    __cpuid(info, 1);
+                    // OSXSAVE: the OS saves the AVX registers
+                    if ((info[2] & (1 << 27)) == 0) return false;
+                    if ((_xgetbv(0) & 6) != 6) return false;
+                    __cpuidex(info, 7, 0);
+                    return (info[1] & (1 << 5)) != 0;
+#elif defined(__x86_64__) || defined(__i386__)
+                    return __builtin_cpu_supports("avx2") != 0;
+#else
+                    return false;
+#endif
+                }();
+            return has;
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace pdf
+{
+    // ============================================
+    // PLATFORM HELPERS
+    // Keeps Win32 calls out of the parser/CPU painter so the
+    // same sources build as the headless (Linux) library.
+    // ============================================
+    namespace platform
+    {
+#ifndef _WIN32
+        // UTF-8 form of a wide path for fopen/ifstream on platforms
+        // without wide-character file APIs
+        std::string narrowPath(const wchar_t* path);
+#endif
+
+        // Full path of a system font given its Windows file name
+        // (e.g. "arial.ttf", "timesbd.ttf").
+        // Windows: %WINDIR%\Fonts\<fileName>
+        // Elsewhere: $MANASPDF_FONT_DIR/<fileName> if present, otherwise a
+        // metric-compatible substitute (Liberation, then DejaVu).
+        // Returns an empty string if nothing usable is installed.
+        std::string systemFontPath(const char* fileName);
+
+        // Read-only mapping of a whole file (MapViewOfFile / mmap).
+        // The view is released when the last shared_ptr copy goes away.
+        // Returns nullptr for missing/empty files. The file must not be
+        // truncated while mapped.
+        std::shared_ptr<const uint8_t> mapFile(const wchar_t* path, size_t& size);
+        std::shared_ptr<const uint8_t> mapFile(const char* path, size_t& size);
+
+        // True on x86/x64 CPUs (and OSes) that run AVX2 code; checked once
+        bool cpuHasAvx2();
+    }
+}
@@ -0,0 +1,453 @@
+// =====================================================
+// PdfScanline.cpp - Scanline edge table and coverage rasterizer
+// =====================================================
+
+#include "pch.h"
+#include "PdfScanline.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+namespace pdf
+{
+    void ScanlineEdgeTable::clear()
+    {
+        _edges.clear();
+        _active.clear();
+        _next = 0;
+        _sorted = true;
+        _walking = false;
+        _firstRow = 0;
+        _endRow = 0;
+    }
+
+    void ScanlineEdgeTable::addEdge(double ax, double ay, double bx, double by, int y0, int y1)
+    {
+        if (y0 >= y1) return;
+
+        if (_edges.empty())
+        {
+            _firstRow = y0;
+            _endRow = y1;
+        }
+        else
+        {
+            _firstRow = std::min(_firstRow, y0);
+            _endRow = std::max(_endRow, y1);
+            if (y0 < _edges.back().y0)
+                _sorted = false;
+        }
+
+        _edges.push_back({ ax, ay, bx, by, y0, y1, (by > ay) ? +1 : -1 });
+        _walking = false;
+    }
+
+    void ScanlineEdgeTable::addPolygon(const std::vector<IPoint>& poly, bool closed)
+    {
+        const size_t n = poly.size();
+        if (n < 2) return;
+
+        const size_t count = closed ? n : n - 1;
+        for (size_t i = 0; i < count; i++)
+        {
+            const IPoint& a = poly[i];
+            const IPoint& b = poly[(i + 1 == n) ? 0 : i + 1];
+            if (a.y == b.y) continue;
+
+            addEdge(a.x, a.y, b.x, b.y, std::min(a.y, b.y), std::max(a.y, b.y));
+        }
+    }
+
+    void ScanlineEdgeTable::addPolygon(const std::vector<DPoint>& poly, bool closed)
+    {
+        const size_t n = poly.size();
+        if (n < 2) return;
+
+        // Rows y with yMin <= y < yMax; far-off coordinates are clamped
+        // so the row numbers stay in int range
+        auto firstRowAtOrAbove = [](double v)
+            {
+                return (int)std::ceil(std::max(-1e9, std::min(1e9, v)));
+            };
+
+        const size_t count = closed ? n : n - 1;
+        for (size_t i = 0; i < count; i++)
+        {
+            const DPoint& a = poly[i];
+            const DPoint& b = poly[(i + 1 == n) ? 0 : i + 1];
+            if (std::abs(b.y - a.y) < 0.001) continue;
+
+            addEdge(a.x, a.y, b.x, b.y,
+                firstRowAtOrAbove(std::min(a.y, b.y)),
+                firstRowAtOrAbove(std::max(a.y, b.y)));
+        }
+    }
+
+    const std::vector<ScanlineEdgeTable::Crossing>& ScanlineEdgeTable::row(int y)
+    {
+        if (!_sorted)
+        {
+            std::stable_sort(_edges.begin(), _edges.end(),
+                [](const Edge& a, const Edge& b) { return a.y0 < b.y0; });
+            _sorted = true;
+        }
+
+        if (!_walking || y < _lastRow)
+        {
+            _active.clear();
+            _next = 0;
+            _walking = true;
+        }
+        _lastRow = y;
+
+        // Retire edges that ended above this row
+        size_t kept = 0;
+        for (const Crossing& c : _active)
+        {
+            if (_edges[c.edge].y1 > y)
+                _active[kept++] = c;
+        }
+        _active.resize(kept);
+
+        auto xAt = [y](const Edge& e)
+            {
+                double t = (y - e.ay) / (e.by - e.ay);
+                return e.ax + t * (e.bx - e.ax);
+            };
+        auto byX = [](const Crossing& a, const Crossing& b) { return a.x < b.x; };
+
+        for (Crossing& c : _active)
+            c.x = xAt(_edges[c.edge]);
+
+        // Insertion sort: the previous row's order is almost always
+        // still right, so this is close to one pass
+        for (size_t i = 1; i < _active.size(); i++)
+        {
+            Crossing c = _active[i];
+            size_t j = i;
+            while (j > 0 && _active[j - 1].x > c.x)
+            {
+                _active[j] = _active[j - 1];
+                j--;
+            }
+            _active[j] = c;
+        }
+
+        // Activate edges starting at or above it; a row can open many
+        // edges at once, so they are sorted apart and merged in
+        while (_next < _edges.size() && _edges[_next].y0 <= y)
+        {
+            const Edge& e = _edges[_next];
+            if (e.y1 > y)
+                _active.push_back({ xAt(e), e.winding, (int)_next });
+            _next++;
+        }
+
+        if (_active.size() > kept)
+        {
+            std::sort(_active.begin() + kept, _active.end(), byX);
+            std::inplace_merge(_active.begin(), _active.begin() + kept, _active.end(), byX);
+        }
+
+        return _active;
+    }
+
+    // =====================================================
+    // CoverageRasterizer
+    // =====================================================
+
+    // Rows accumulated per pass; the strip buffer is this many rows of
+    // the path's clipped width
+    static constexpr int COVERAGE_STRIP_ROWS = 32;
+
+    static int rowIndex(double v)
+    {
+        return (int)std::max(-1e9, std::min(1e9, v));
+    }
+
+    void CoverageRasterizer::clear()
+    {
+        _edges.clear();
+        _sorted = true;
+    }
+
+    void CoverageRasterizer::addPolygon(const std::vector<DPoint>& poly, bool closed)
+    {
+        const size_t n = poly.size();
+        if (n < 2) return;
+
+        const size_t count = closed ? n : n - 1;
+        for (size_t i = 0; i < count; i++)
+        {
+            const DPoint& a = poly[i];
+            const DPoint& b = poly[(i + 1 == n) ? 0 : i + 1];
+            if (a.y == b.y) continue;
+            if (!std::isfinite(a.x) || !std::isfinite(a.y) || !std::isfinite(b.x) || !std::isfinite(b.y))
+                continue;
+
+            Edge e;
+            if (a.y < b.y) e = { a.x, a.y, b.x, b.y, +1.0 };
+            else           e = { b.x, b.y, a.x, a.y, -1.0 };
+
+            if (_edges.empty())
+            {
+                _minX = std::min(e.x0, e.x1);
+                _maxX = std::max(e.x0, e.x1);
+                _minY = e.y0;
+                _maxY = e.y1;
+            }
+            else
+            {
+                _minX = std::min(_minX, std::min(e.x0, e.x1));
+                _maxX = std::max(_maxX, std::max(e.x0, e.x1));
+                _minY = std::min(_minY, e.y0);
+                _maxY = std::max(_maxY, e.y1);
+                if (e.y0 < _edges.back().y0)
+                    _sorted = false;
+            }
+            _edges.push_back(e);
+        }
+    }
+
+    int CoverageRasterizer::firstRow() const
+    {
+        return _edges.empty() ? 0 : rowIndex(std::floor(_minY));
+    }
+
+    int CoverageRasterizer::endRow() const
+    {
+        return _edges.empty() ? 0 : rowIndex(std::ceil(_maxY));
+    }
+
+    void CoverageRasterizer::begin(int rowFrom, int rowTo, int width, bool evenOdd)
+    {
+        if (!_sorted)
+        {
+            std::sort(_edges.begin(), _edges.end(),
+                [](const Edge& a, const Edge& b) { return a.y0 < b.y0; });
+            _sorted = true;
+        }
+
+        _evenOdd = evenOdd;
+        _width = width;
+        _row = std::max(rowFrom, firstRow());
+        _rowTo = std::min(rowTo, endRow());
+
+        // Columns the path can cover. Edges left of the first column
+        // still count: they are moved onto it, which keeps the winding
+        // of everything to their right.
+        _colFrom = std::max(0, std::min(width, rowIndex(std::floor(_minX))));
+        int colTo = std::max(0, std::min(width, rowIndex(std::ceil(_maxX)) + 1));
+        _cols = colTo - _colFrom;
+        if (_edges.empty() || _cols <= 0 || _row >= _rowTo)
+        {
+            _cols = 0;
+            return;
+        }
+
+        _acc.assign((size_t)COVERAGE_STRIP_ROWS * (_cols + 2), 0.0f);
+        _touchMin.assign(COVERAGE_STRIP_ROWS, INT_MAX);
+        _touchMax.assign(COVERAGE_STRIP_ROWS, -1);
+        if ((int)_coverage.size() < width)
+            _coverage.resize(width);
+
+        _active.clear();
+        _next = 0;
+        _stripTop = _row;
+        _stripRows = 0;
+    }
+
+    void CoverageRasterizer::fillStrip()
+    {
+        _stripTop = _row;
+        _stripRows = std::min(COVERAGE_STRIP_ROWS, _rowTo - _row);
+        const double top = _stripTop;
+        const double bottom = _stripTop + _stripRows;
+
+        size_t kept = 0;
+        for (int i : _active)
+        {
+            if (_edges[i].y1 > top)
+                _active[kept++] = i;
+        }
+        _active.resize(kept);
+
+        while (_next < _edges.size() && _edges[_next].y0 < bottom)
+        {
+            if (_edges[_next].y1 > top)
+                _active.push_back((int)_next);
+            _next++;
+        }
+
+        for (int i : _active)
+            accumulate(_edges[i], top, bottom);
+    }
+
+    // Clips the edge to the strip rows and the accumulated columns and
+    // adds it in strip-local coordinates
+    void CoverageRasterizer::accumulate(const Edge& e, double top, double bottom)
+    {
+        const double ya = std::max(e.y0, top);
+        const double yb = std::min(e.y1, bottom);
+        if (ya >= yb) return;
+
+        const double slope = (e.x1 - e.x0) / (e.y1 - e.y0);
+        double xa = e.x0 + (ya - e.y0) * slope - _colFrom;
+        double xb = e.x0 + (yb - e.y0) * slope - _colFrom;
+        const double right = _cols;
+
+        // Split where the edge crosses the first or last column boundary;
+        // pieces outside are pinned to that boundary
+        double ys[4] = { ya, 0, 0, yb };
+        double xs[4] = { xa, 0, 0, xb };
+        int n = 1;
+        for (double bound : { 0.0, right })
+        {
+            if ((xa < bound) != (xb < bound) && xa != xb)
+            {
+                double t = (bound - xa) / (xb - xa);
+                ys[n] = ya + t * (yb - ya);
+                xs[n] = bound;
+                n++;
+            }
+        }
+        ys[n] = yb;
+        xs[n] = xb;
+        if (n == 3 && ys[1] > ys[2])
+        {
+            std::swap(ys[1], ys[2]);
+            std::swap(xs[1], xs[2]);
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            double x0 = std::max(0.0, std::min(right, xs[i]));
+            double x1 = std::max(0.0, std::min(right, xs[i + 1]));
+            addLine(x0, ys[i] - top, x1, ys[i + 1] - top, e.dir);
+        }
+    }
+
+    void CoverageRasterizer::addLine(double x0, double y0, double x1, double y1, double dir)
+    {
+        if (y0 >= y1) return;
+
+        const int stride = _cols + 2;
+        const double dxdy = (x1 - x0) / (y1 - y0);
+        double x = x0;
+
+        const int rowEnd = std::min(_stripRows, (int)std::ceil(y1));
+        for (int y = std::max(0, (int)std::floor(y0)); y < rowEnd; y++)
+        {
+            float* row = &_acc[(size_t)y * stride];
+            const double dy = std::min((double)y + 1.0, y1) - std::max((double)y, y0);
+            const double xnext = x + dxdy * dy;
+            const double d = dy * dir;
+
+            const double xa = std::min(x, xnext);
+            const double xb = std::max(x, xnext);
+            const double xaFloor = std::floor(xa);
+            const int xai = (int)xaFloor;
+            const double xbCeil = std::ceil(xb);
+            const int xbi = (int)xbCeil;
+
+            if (xbi <= xai + 1)
+            {
+                // Stays inside one cell: area right of the mean x
+                const double xmf = 0.5 * (x + xnext) - xaFloor;
+                row[xai] += (float)(d - d * xmf);
+                row[xai + 1] += (float)(d * xmf);
+                _touchMin[y] = std::min(_touchMin[y], xai);
+                _touchMax[y] = std::max(_touchMax[y], xai + 1);
+            }
+            else
+            {
+                // Crosses several cells: triangle in the first and last,
+                // equal slices in between
+                const double s = 1.0 / (xb - xa);
+                const double x0f = xa - xaFloor;
+                const double a0 = 0.5 * s * (1.0 - x0f) * (1.0 - x0f);
+                const double x1f = xb - xbCeil + 1.0;
+                const double am = 0.5 * s * x1f * x1f;
+
+                row[xai] += (float)(d * a0);
+                if (xbi == xai + 2)
+                {
+                    row[xai + 1] += (float)(d * (1.0 - a0 - am));
+                }
+                else
+                {
+                    const double a1 = s * (1.5 - x0f);
+                    row[xai + 1] += (float)(d * (a1 - a0));
+                    for (int xi = xai + 2; xi < xbi - 1; xi++)
+                        row[xi] += (float)(d * s);
+                    const double a2 = a1 + (xbi - xai - 3) * s;
+                    row[xbi - 1] += (float)(d * (1.0 - a2 - am));
+                }
+                row[xbi] += (float)(d * am);
+                _touchMin[y] = std::min(_touchMin[y], xai);
+                _touchMax[y] = std::max(_touchMax[y], xbi);
+            }
+            x = xnext;
+        }
+    }
+
+    bool CoverageRasterizer::nextRow(int& y, const uint8_t*& coverage, int& x0, int& x1)
+    {
+        if (_cols <= 0 || _row >= _rowTo)
+            return false;
+
+        if (_row >= _stripTop + _stripRows)
+            fillStrip();
+
+        const int r = _row - _stripTop;
+        y = _row++;
+        coverage = _coverage.data();
+        x0 = x1 = _colFrom;
+
+        const int tmin = _touchMin[r];
+        const int tmax = _touchMax[r];
+        if (tmin > tmax)
+            return true;
+
+        // Past the last touched cell the running sum is back to zero
+        float* row = &_acc[(size_t)r * (_cols + 2)];
+        const int end = std::min(_cols, tmax + 1);
+        uint8_t* out = _coverage.data() + _colFrom;
+        float sum = 0.0f;
+        int c = tmin;
+        while (c < end)
+        {
+            sum += row[c];
+            float v = std::abs(sum);
+            if (_evenOdd)
+            {
+                v = std::fmod(v, 2.0f);
+                if (v > 1.0f) v = 2.0f - v;
+            }
+            else if (v > 1.0f)
+            {
+                v = 1.0f;
+            }
+            const uint8_t value = (uint8_t)(v * 255.0f + 0.5f);
+            out[c++] = value;
+
+            // Cells no edge touched repeat the running coverage
+            int run = c;
+            while (run < end && row[run] == 0.0f)
+                run++;
+            std::memset(out + c, value, run - c);
+            c = run;
+        }
+
+        std::fill(row + tmin, row + tmax + 1, 0.0f);
+        _touchMin[r] = INT_MAX;
+        _touchMax[r] = -1;
+
+        x0 = _colFrom + std::min(tmin, end);
+        x1 = _colFrom + end;
+        return true;
+    }
+
+} // namespace pdf
@@ -0,0 +1,135 @@
+#pragma once
+// =====================================================
+// PdfScanline.h - Device-space polygons, scanline edge table and
+// the anti-aliasing coverage rasterizer
+// =====================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pdf
+{
+    struct DPoint { double x, y; };
+    struct IPoint { int x, y; };
+
+    // =====================================================
+    // ScanlineEdgeTable
+    // Edge list of one or more polygons, sorted by first row, walked
+    // top to bottom with an active edge table: a row only touches the
+    // edges that cross it. Crossings come back sorted by x with their
+    // winding (+1 downward edge, -1 upward). Edge i of a polygon joins
+    // point i to i+1; x at row y is interpolated from the edge's first
+    // point, the same arithmetic the painter used per row before.
+    // All buffers are kept between paths, so a painter reuses one table.
+    // =====================================================
+    class ScanlineEdgeTable
+    {
+    public:
+        struct Crossing
+        {
+            double x;
+            int winding;
+            int edge;
+        };
+
+        void clear();
+
+        // closed: also add the edge from the last point back to the first
+        void addPolygon(const std::vector<IPoint>& poly, bool closed = true);
+        void addPolygon(const std::vector<DPoint>& poly, bool closed = true);
+
+        bool empty() const { return _edges.empty(); }
+
+        // Rows [firstRow, endRow) that have at least one crossing
+        int firstRow() const { return _firstRow; }
+        int endRow() const { return _endRow; }
+
+        // Crossings of row y, sorted by x. Rows must be requested in
+        // increasing order (gaps are fine); a lower y restarts the walk.
+        const std::vector<Crossing>& row(int y);
+
+    private:
+        struct Edge
+        {
+            double ax, ay;      // first point
+            double bx, by;      // second point
+            int y0, y1;         // rows [y0, y1) crossed
+            int winding;
+        };
+
+        void addEdge(double ax, double ay, double bx, double by, int y0, int y1);
+
+        std::vector<Edge> _edges;
+        std::vector<Crossing> _active;  // doubles as the row result
+        size_t _next = 0;               // first edge not yet activated
+        int _lastRow = 0;
+        bool _sorted = true;
+        bool _walking = false;
+        int _firstRow = 0;
+        int _endRow = 0;
+    };
+
+    // =====================================================
+    // CoverageRasterizer
+    // Exact-area anti-aliasing at device resolution. Every edge adds
+    // its signed area and cover to the cells it crosses (the scheme
+    // font rasterizers use); a running sum along each row then gives
+    // the fraction of every pixel inside the polygons, as 0..255.
+    // Rows are accumulated a strip at a time, so memory is a strip of
+    // the path's width whatever its height.
+    // Non-zero coverage is |winding| clamped to 1; even-odd folds it
+    // into 0..1.
+    // =====================================================
+    class CoverageRasterizer
+    {
+    public:
+        void clear();
+
+        // closed: also add the edge from the last point back to the first
+        void addPolygon(const std::vector<DPoint>& poly, bool closed = true);
+
+        bool empty() const { return _edges.empty(); }
+
+        // Pixel rows that can have coverage: [firstRow, endRow)
+        int firstRow() const;
+        int endRow() const;
+
+        // Starts a sweep over rows [rowFrom, rowTo) and columns [0, width)
+        void begin(int rowFrom, int rowTo, int width, bool evenOdd);
+
+        // Next row of the sweep: coverage[x] for x in [x0, x1), other
+        // columns are zero. Returns false when the sweep is done.
+        bool nextRow(int& y, const uint8_t*& coverage, int& x0, int& x1);
+
+    private:
+        struct Edge
+        {
+            double x0, y0;      // upper end (smaller y)
+            double x1, y1;
+            double dir;         // +1 edge went down, -1 up
+        };
+
+        void fillStrip();
+        void accumulate(const Edge& e, double top, double bottom);
+        void addLine(double x0, double y0, double x1, double y1, double dir);
+
+        std::vector<Edge> _edges;
+        bool _sorted = true;
+        double _minX = 0, _maxX = 0, _minY = 0, _maxY = 0;
+
+        // Sweep state
+        bool _evenOdd = false;
+        int _rowTo = 0;
+        int _colFrom = 0, _cols = 0;    // accumulated columns [colFrom, colFrom + cols)
+        int _stripTop = 0, _stripRows = 0;
+        int _row = 0;                   // next row to return
+        size_t _next = 0;               // first edge not yet activated
+        std::vector<int> _active;
+        std::vector<float> _acc;        // strip rows x (cols + 2) cells
+        std::vector<int> _touchMin, _touchMax;
+        std::vector<uint8_t> _coverage; // one row, indexed by column
+        int _width = 0;
+    };
+
+} // namespace pdf
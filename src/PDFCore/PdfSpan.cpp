@@ -0,0 +1,525 @@
+// =====================================================
+// PdfSpan.cpp - Source-over span kernels
+// =====================================================
+
+#include "pch.h"
+#include "PdfSpan.h"
+#include "PdfPlatform.h"
+
+#include <cstring>
+
+// SSE2 kernels, AVX2 when the CPU has it (x86/x64 only)
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PDF_SPAN_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define PDF_SSE2_TARGET
+#define PDF_AVX2_TARGET
+#else
+#define PDF_SSE2_TARGET __attribute__((target("sse2")))
+#define PDF_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#else
+#define PDF_SPAN_SIMD 0
+#endif
+
+namespace pdf
+{
+    // round(t / 255) for t in [0, 255 * 255]
+    static inline uint32_t div255(uint32_t t)
+    {
+        t += 128;
+        return (t + (t >> 8)) >> 8;
+    }
+
+    // Source pixel in BGRA order; the alpha channel blends toward 255
+    struct SpanSource
+    {
+        uint8_t bgra[4];
+        uint32_t opaque;    // the pixel as stored when a == 255
+    };
+
+    static SpanSource spanSource(uint32_t argb)
+    {
+        SpanSource s;
+        s.bgra[0] = (uint8_t)(argb & 0xFF);
+        s.bgra[1] = (uint8_t)((argb >> 8) & 0xFF);
+        s.bgra[2] = (uint8_t)((argb >> 16) & 0xFF);
+        s.bgra[3] = 255;
+        std::memcpy(&s.opaque, s.bgra, 4);
+        return s;
+    }
+
+    // =====================================================
+    // Scalar kernels (tails and non-x86 targets)
+    // =====================================================
+    static void storeScalar(uint8_t* dst, int count, const SpanSource& src)
+    {
+        for (int i = 0; i < count; i++)
+            std::memcpy(dst + i * 4, &src.opaque, 4);
+    }
+
+    static void blendScalar(uint8_t* dst, int count, const SpanSource& src, uint32_t a)
+    {
+        const uint32_t inv = 255 - a;
+        for (int i = 0; i < count; i++, dst += 4)
+        {
+            for (int c = 0; c < 4; c++)
+                dst[c] = (uint8_t)div255(src.bgra[c] * a + dst[c] * inv);
+        }
+    }
+
+    static void coverageScalar(uint8_t* dst, int count, const SpanSource& src, uint32_t alpha, const uint8_t* coverage)
+    {
+        for (int i = 0; i < count; i++, dst += 4)
+        {
+            const uint32_t a = div255(alpha * coverage[i]);
+            if (a == 0) continue;
+            const uint32_t inv = 255 - a;
+            for (int c = 0; c < 4; c++)
+                dst[c] = (uint8_t)div255(src.bgra[c] * a + dst[c] * inv);
+        }
+    }
+
+    static void rowScalar(uint8_t* dst, const uint8_t* src, int count, uint32_t alpha)
+    {
+        for (int i = 0; i < count; i++, dst += 4, src += 4)
+        {
+            uint32_t s[4] = { src[0], src[1], src[2], src[3] };
+            if (alpha != 255)
+                for (int c = 0; c < 4; c++)
+                    s[c] = div255(s[c] * alpha);
+            if (s[3] == 0) continue;
+            const uint32_t inv = 255 - s[3];
+            for (int c = 0; c < 4; c++)
+            {
+                const uint32_t v = s[c] + div255(dst[c] * inv);
+                dst[c] = (uint8_t)(v > 255 ? 255 : v);
+            }
+        }
+    }
+
+    static void maskScalar(uint8_t* dst, const uint8_t* src, const uint8_t* mask, int count)
+    {
+        for (int i = 0; i < count; i++, dst += 4, src += 4)
+        {
+            const uint32_t m = mask[i];
+            if (m == 0) continue;
+            const uint32_t inv = 255 - m;
+            for (int c = 0; c < 4; c++)
+                dst[c] = (uint8_t)div255(src[c] * m + dst[c] * inv);
+        }
+    }
+
+#if PDF_SPAN_SIMD
+    // =====================================================
+    // SSE2 kernels, 4 pixels per step in 16-bit lanes
+    // =====================================================
+    PDF_SSE2_TARGET
+    static inline __m128i div255Sse2(__m128i t)
+    {
+        t = _mm_add_epi16(t, _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    }
+
+    PDF_SSE2_TARGET
+    static __m128i sourceSse2(const SpanSource& src)
+    {
+        return _mm_set_epi16(src.bgra[3], src.bgra[2], src.bgra[1], src.bgra[0],
+            src.bgra[3], src.bgra[2], src.bgra[1], src.bgra[0]);
+    }
+
+    PDF_SSE2_TARGET
+    static void storeSse2(uint8_t* dst, int count, const SpanSource& src)
+    {
+        const __m128i px = _mm_set1_epi32((int)src.opaque);
+        int i = 0;
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_si128((__m128i*)(dst + i * 4), px);
+        storeScalar(dst + i * 4, count - i, src);
+    }
+
+    PDF_SSE2_TARGET
+    static void blendSse2(uint8_t* dst, int count, const SpanSource& src, uint32_t a)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i srcA = _mm_mullo_epi16(sourceSse2(src), _mm_set1_epi16((short)a));
+        const __m128i inv = _mm_set1_epi16((short)(255 - a));
+
+        int i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128i d = _mm_loadu_si128((const __m128i*)(dst + i * 4));
+            __m128i lo = _mm_unpacklo_epi8(d, zero);
+            __m128i hi = _mm_unpackhi_epi8(d, zero);
+            lo = div255Sse2(_mm_add_epi16(_mm_mullo_epi16(lo, inv), srcA));
+            hi = div255Sse2(_mm_add_epi16(_mm_mullo_epi16(hi, inv), srcA));
+            _mm_storeu_si128((__m128i*)(dst + i * 4), _mm_packus_epi16(lo, hi));
+        }
+        blendScalar(dst + i * 4, count - i, src, a);
+    }
+
+    // a = alpha * coverage per pixel, spread over the pixel's 4 channels
+    PDF_SSE2_TARGET
+    static inline __m128i blendCoverageSse2(__m128i d, __m128i cov, __m128i srcv, __m128i alpha)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i full = _mm_set1_epi16(255);
+
+        __m128i aLo = div255Sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(cov, zero), alpha));
+        __m128i aHi = div255Sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(cov, zero), alpha));
+
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(srcv, aLo),
+            _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(full, aLo)));
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(srcv, aHi),
+            _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(full, aHi)));
+        return _mm_packus_epi16(div255Sse2(lo), div255Sse2(hi));
+    }
+
+    // c0 c1 c2 c3 -> c0 x4, c1 x4, c2 x4, c3 x4
+    PDF_SSE2_TARGET
+    static inline __m128i spreadCoverage4(uint32_t cov4)
+    {
+        __m128i c = _mm_cvtsi32_si128((int)cov4);
+        c = _mm_unpacklo_epi8(c, c);
+        return _mm_unpacklo_epi16(c, c);
+    }
+
+    PDF_SSE2_TARGET
+    static void coverageSse2(uint8_t* dst, int count, const SpanSource& src, uint32_t alpha, const uint8_t* coverage)
+    {
+        const __m128i srcv = sourceSse2(src);
+        const __m128i av = _mm_set1_epi16((short)alpha);
+
+        int i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            uint32_t cov4;
+            std::memcpy(&cov4, coverage + i, 4);
+            if (cov4 == 0) continue;
+            if (cov4 == 0xFFFFFFFFu && alpha == 255)
+            {
+                _mm_storeu_si128((__m128i*)(dst + i * 4), _mm_set1_epi32((int)src.opaque));
+                continue;
+            }
+
+            const __m128i d = _mm_loadu_si128((const __m128i*)(dst + i * 4));
+            _mm_storeu_si128((__m128i*)(dst + i * 4), blendCoverageSse2(d, spreadCoverage4(cov4), srcv, av));
+        }
+        coverageScalar(dst + i * 4, count - i, src, alpha, coverage + i);
+    }
+
+    // Each pixel's alpha copied to its 4 lanes
+    PDF_SSE2_TARGET
+    static inline __m128i spreadAlphaSse2(__m128i px)
+    {
+        return _mm_shufflehi_epi16(_mm_shufflelo_epi16(px, 0xFF), 0xFF);
+    }
+
+    PDF_SSE2_TARGET
+    static inline __m128i overSse2(__m128i s, __m128i d)
+    {
+        const __m128i inv = _mm_sub_epi16(_mm_set1_epi16(255), spreadAlphaSse2(s));
+        return _mm_add_epi16(s, div255Sse2(_mm_mullo_epi16(d, inv)));
+    }
+
+    PDF_SSE2_TARGET
+    static void rowSse2(uint8_t* dst, const uint8_t* src, int count, uint32_t alpha)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i alphaBytes = _mm_set1_epi32((int)0xFF000000u);
+        const __m128i av = _mm_set1_epi16((short)alpha);
+
+        int i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128i s = _mm_loadu_si128((const __m128i*)(src + i * 4));
+            const __m128i sa = _mm_and_si128(s, alphaBytes);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(sa, zero)) == 0xFFFF) continue;
+            if (alpha == 255 && _mm_movemask_epi8(_mm_cmpeq_epi32(sa, alphaBytes)) == 0xFFFF)
+            {
+                _mm_storeu_si128((__m128i*)(dst + i * 4), s);
+                continue;
+            }
+
+            __m128i sLo = _mm_unpacklo_epi8(s, zero);
+            __m128i sHi = _mm_unpackhi_epi8(s, zero);
+            if (alpha != 255)
+            {
+                sLo = div255Sse2(_mm_mullo_epi16(sLo, av));
+                sHi = div255Sse2(_mm_mullo_epi16(sHi, av));
+            }
+            const __m128i d = _mm_loadu_si128((const __m128i*)(dst + i * 4));
+            const __m128i lo = overSse2(sLo, _mm_unpacklo_epi8(d, zero));
+            const __m128i hi = overSse2(sHi, _mm_unpackhi_epi8(d, zero));
+            _mm_storeu_si128((__m128i*)(dst + i * 4), _mm_packus_epi16(lo, hi));
+        }
+        rowScalar(dst + i * 4, src + i * 4, count - i, alpha);
+    }
+
+    PDF_SSE2_TARGET
+    static void maskSse2(uint8_t* dst, const uint8_t* src, const uint8_t* mask, int count)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i full = _mm_set1_epi16(255);
+
+        int i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            uint32_t m4;
+            std::memcpy(&m4, mask + i, 4);
+            if (m4 == 0) continue;
+            const __m128i s = _mm_loadu_si128((const __m128i*)(src + i * 4));
+            if (m4 == 0xFFFFFFFFu)
+            {
+                _mm_storeu_si128((__m128i*)(dst + i * 4), s);
+                continue;
+            }
+
+            const __m128i m = spreadCoverage4(m4);
+            const __m128i mLo = _mm_unpacklo_epi8(m, zero);
+            const __m128i mHi = _mm_unpackhi_epi8(m, zero);
+            const __m128i d = _mm_loadu_si128((const __m128i*)(dst + i * 4));
+            const __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), mLo),
+                _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(full, mLo)));
+            const __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), mHi),
+                _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(full, mHi)));
+            _mm_storeu_si128((__m128i*)(dst + i * 4), _mm_packus_epi16(div255Sse2(lo), div255Sse2(hi)));
+        }
+        maskScalar(dst + i * 4, src + i * 4, mask + i, count - i);
+    }
+
+    // =====================================================
+    // AVX2 kernels, 8 pixels per step. unpack/pack work inside each
+    // 128-bit lane, so pixels come back in order.
+    // =====================================================
+    PDF_AVX2_TARGET
+    static inline __m256i div255Avx2(__m256i t)
+    {
+        t = _mm256_add_epi16(t, _mm256_set1_epi16(128));
+        return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+    }
+
+    PDF_AVX2_TARGET
+    static void storeAvx2(uint8_t* dst, int count, const SpanSource& src)
+    {
+        const __m256i px = _mm256_set1_epi32((int)src.opaque);
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_si256((__m256i*)(dst + i * 4), px);
+        storeSse2(dst + i * 4, count - i, src);
+    }
+
+    PDF_AVX2_TARGET
+    static void blendAvx2(uint8_t* dst, int count, const SpanSource& src, uint32_t a)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i srcv = _mm256_set_epi16(
+            src.bgra[3], src.bgra[2], src.bgra[1], src.bgra[0], src.bgra[3], src.bgra[2], src.bgra[1], src.bgra[0],
+            src.bgra[3], src.bgra[2], src.bgra[1], src.bgra[0], src.bgra[3], src.bgra[2], src.bgra[1], src.bgra[0]);
+        const __m256i srcA = _mm256_mullo_epi16(srcv, _mm256_set1_epi16((short)a));
+        const __m256i inv = _mm256_set1_epi16((short)(255 - a));
+
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i * 4));
+            __m256i lo = _mm256_unpacklo_epi8(d, zero);
+            __m256i hi = _mm256_unpackhi_epi8(d, zero);
+            lo = div255Avx2(_mm256_add_epi16(_mm256_mullo_epi16(lo, inv), srcA));
+            hi = div255Avx2(_mm256_add_epi16(_mm256_mullo_epi16(hi, inv), srcA));
+            _mm256_storeu_si256((__m256i*)(dst + i * 4), _mm256_packus_epi16(lo, hi));
+        }
+        blendSse2(dst + i * 4, count - i, src, a);
+    }
+
+    PDF_AVX2_TARGET
+    static void coverageAvx2(uint8_t* dst, int count, const SpanSource& src, uint32_t alpha, const uint8_t* coverage)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i full = _mm256_set1_epi16(255);
+        const __m256i srcv = _mm256_set_epi16(
+            src.bgra[3], src.bgra[2], src.bgra[1], src.bgra[0], src.bgra[3], src.bgra[2], src.bgra[1], src.bgra[0],
+            src.bgra[3], src.bgra[2], src.bgra[1], src.bgra[0], src.bgra[3], src.bgra[2], src.bgra[1], src.bgra[0]);
+        const __m256i av = _mm256_set1_epi16((short)alpha);
+
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            uint64_t cov8;
+            std::memcpy(&cov8, coverage + i, 8);
+            if (cov8 == 0) continue;
+            if (cov8 == ~0ull && alpha == 255)
+            {
+                _mm256_storeu_si256((__m256i*)(dst + i * 4), _mm256_set1_epi32((int)src.opaque));
+                continue;
+            }
+
+            __m128i c = _mm_loadl_epi64((const __m128i*)(coverage + i));
+            c = _mm_unpacklo_epi8(c, c);
+            const __m256i cov = _mm256_set_m128i(_mm_unpackhi_epi16(c, c), _mm_unpacklo_epi16(c, c));
+
+            const __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i * 4));
+            __m256i aLo = div255Avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(cov, zero), av));
+            __m256i aHi = div255Avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(cov, zero), av));
+            __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(srcv, aLo),
+                _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_sub_epi16(full, aLo)));
+            __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(srcv, aHi),
+                _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_sub_epi16(full, aHi)));
+            _mm256_storeu_si256((__m256i*)(dst + i * 4), _mm256_packus_epi16(div255Avx2(lo), div255Avx2(hi)));
+        }
+        coverageSse2(dst + i * 4, count - i, src, alpha, coverage + i);
+    }
+
+    PDF_AVX2_TARGET
+    static inline __m256i overAvx2(__m256i s, __m256i d)
+    {
+        const __m256i sa = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, 0xFF), 0xFF);
+        const __m256i inv = _mm256_sub_epi16(_mm256_set1_epi16(255), sa);
+        return _mm256_add_epi16(s, div255Avx2(_mm256_mullo_epi16(d, inv)));
+    }
+
+    PDF_AVX2_TARGET
+    static void rowAvx2(uint8_t* dst, const uint8_t* src, int count, uint32_t alpha)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i alphaBytes = _mm256_set1_epi32((int)0xFF000000u);
+        const __m256i av = _mm256_set1_epi16((short)alpha);
+
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256i s = _mm256_loadu_si256((const __m256i*)(src + i * 4));
+            const __m256i sa = _mm256_and_si256(s, alphaBytes);
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(sa, zero)) == -1) continue;
+            if (alpha == 255 && _mm256_movemask_epi8(_mm256_cmpeq_epi32(sa, alphaBytes)) == -1)
+            {
+                _mm256_storeu_si256((__m256i*)(dst + i * 4), s);
+                continue;
+            }
+
+            __m256i sLo = _mm256_unpacklo_epi8(s, zero);
+            __m256i sHi = _mm256_unpackhi_epi8(s, zero);
+            if (alpha != 255)
+            {
+                sLo = div255Avx2(_mm256_mullo_epi16(sLo, av));
+                sHi = div255Avx2(_mm256_mullo_epi16(sHi, av));
+            }
+            const __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i * 4));
+            const __m256i lo = overAvx2(sLo, _mm256_unpacklo_epi8(d, zero));
+            const __m256i hi = overAvx2(sHi, _mm256_unpackhi_epi8(d, zero));
+            _mm256_storeu_si256((__m256i*)(dst + i * 4), _mm256_packus_epi16(lo, hi));
+        }
+        rowSse2(dst + i * 4, src + i * 4, count - i, alpha);
+    }
+
+    PDF_AVX2_TARGET
+    static void maskAvx2(uint8_t* dst, const uint8_t* src, const uint8_t* mask, int count)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i full = _mm256_set1_epi16(255);
+
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            uint64_t m8;
+            std::memcpy(&m8, mask + i, 8);
+            if (m8 == 0) continue;
+            const __m256i s = _mm256_loadu_si256((const __m256i*)(src + i * 4));
+            if (m8 == ~0ull)
+            {
+                _mm256_storeu_si256((__m256i*)(dst + i * 4), s);
+                continue;
+            }
+
+            __m128i c = _mm_loadl_epi64((const __m128i*)(mask + i));
+            c = _mm_unpacklo_epi8(c, c);
+            const __m256i m = _mm256_set_m128i(_mm_unpackhi_epi16(c, c), _mm_unpacklo_epi16(c, c));
+            const __m256i mLo = _mm256_unpacklo_epi8(m, zero);
+            const __m256i mHi = _mm256_unpackhi_epi8(m, zero);
+            const __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i * 4));
+            const __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), mLo),
+                _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_sub_epi16(full, mLo)));
+            const __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), mHi),
+                _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_sub_epi16(full, mHi)));
+            _mm256_storeu_si256((__m256i*)(dst + i * 4), _mm256_packus_epi16(div255Avx2(lo), div255Avx2(hi)));
+        }
+        maskSse2(dst + i * 4, src + i * 4, mask + i, count - i);
+    }
+#endif
+
+    // =====================================================
+    // Dispatch
+    // =====================================================
+    struct SpanKernels
+    {
+        void (*store)(uint8_t*, int, const SpanSource&);
+        void (*blend)(uint8_t*, int, const SpanSource&, uint32_t);
+        void (*coverage)(uint8_t*, int, const SpanSource&, uint32_t, const uint8_t*);
+        void (*row)(uint8_t*, const uint8_t*, int, uint32_t);
+        void (*mask)(uint8_t*, const uint8_t*, const uint8_t*, int);
+    };
+
+    // Spans shorter than this stay on SSE2 even with AVX2 around: a few
+    // 256-bit ops between long stretches of scalar work (the strokes of
+    // a vector drawing, glyph-sized fills) cost more to start than they
+    // save
+    static constexpr int WIDE_SPAN_PIXELS = 64;
+
+    static const SpanKernels& spanKernels(int count)
+    {
+        struct Dispatch { SpanKernels narrow, wide; };
+        static const Dispatch dispatch = []()
+            {
+#if PDF_SPAN_SIMD
+                const SpanKernels sse2{ storeSse2, blendSse2, coverageSse2, rowSse2, maskSse2 };
+                if (platform::cpuHasAvx2())
+                    return Dispatch{ sse2, SpanKernels{ storeAvx2, blendAvx2, coverageAvx2, rowAvx2, maskAvx2 } };
+                return Dispatch{ sse2, sse2 };
+#else
+                const SpanKernels scalar{ storeScalar, blendScalar, coverageScalar, rowScalar, maskScalar };
+                return Dispatch{ scalar, scalar };
+#endif
+            }();
+        return count >= WIDE_SPAN_PIXELS ? dispatch.wide : dispatch.narrow;
+    }
+
+    void fillSpanSolid(uint8_t* dst, int count, uint32_t argb, uint8_t alpha)
+    {
+        if (count <= 0) return;
+
+        const uint32_t a = div255(((argb >> 24) & 0xFF) * alpha);
+        if (a == 0) return;
+
+        const SpanSource src = spanSource(argb);
+        if (a == 255)
+            spanKernels(count).store(dst, count, src);
+        else
+            spanKernels(count).blend(dst, count, src, a);
+    }
+
+    void fillSpanCoverage(uint8_t* dst, int count, uint32_t argb, const uint8_t* coverage)
+    {
+        if (count <= 0) return;
+
+        const uint32_t alpha = (argb >> 24) & 0xFF;
+        if (alpha == 0) return;
+
+        spanKernels(count).coverage(dst, count, spanSource(argb), alpha, coverage);
+    }
+
+    void fillSpanRow(uint8_t* dst, const uint8_t* src, int count, uint8_t alpha)
+    {
+        if (count <= 0 || alpha == 0) return;
+
+        spanKernels(count).row(dst, src, count, alpha);
+    }
+
+    void maskSpanRow(uint8_t* dst, const uint8_t* src, const uint8_t* mask, int count)
+    {
+        if (count <= 0) return;
+
+        spanKernels(count).mask(dst, src, mask, count);
+    }
+
+} // namespace pdf
@@ -0,0 +1,37 @@
+#pragma once
+// =====================================================
+// PdfSpan.h - Source-over span kernels for BGRA rows
+// =====================================================
+
+#include <cstdint>
+
+namespace pdf
+{
+    // =====================================================
+    // Span kernels
+    // Write count pixels of one BGRA row, source-over with the colour
+    // (0xAARRGGBB) at its alpha times the extra opacity: opaque spans
+    // are plain stores, the rest blend
+    //     dst = (src * a + dst * (255 - a)) / 255   (rounded)
+    // on all four channels, with 255 as the source alpha channel.
+    // SSE2 on x86, AVX2 when the CPU has it (detected once); every
+    // path gives the same bytes.
+    // =====================================================
+
+    // One opacity for the whole span
+    void fillSpanSolid(uint8_t* dst, int count, uint32_t argb, uint8_t alpha);
+
+    // Opacity per pixel: coverage[i] for dst pixel i
+    void fillSpanCoverage(uint8_t* dst, int count, uint32_t argb, const uint8_t* coverage);
+
+    // Premultiplied BGRA source row (images, shadings, pattern tiles)
+    // at the extra opacity alpha, source-over:
+    //     s = src * alpha / 255,  dst = s + dst * (255 - s.a) / 255
+    void fillSpanRow(uint8_t* dst, const uint8_t* src, int count, uint8_t alpha);
+
+    // Soft mask: dst moves toward the source row by mask[i]
+    //     dst = (src * m + dst * (255 - m)) / 255   (rounded)
+    // on all four channels; m = 0 keeps dst, 255 copies src
+    void maskSpanRow(uint8_t* dst, const uint8_t* src, const uint8_t* mask, int count);
+
+} // namespace pdf
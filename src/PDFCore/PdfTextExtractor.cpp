@@ -203,7 +203,7 @@ namespace pdf
             return 0.0;
 
         // DEBUG: Font bilgilerini logla
-        static int debugCount = 0;
+        static thread_local int debugCount = 0;
         if (debugCount < 5) {
             LogDebug("[TextExtract] Font: name='%s' encoding='%s' hasSimpleMap=%d isCidFont=%d cidToUnicode.size=%zu",
                 font->baseFont.c_str(),
@@ -268,7 +268,7 @@ namespace pdf
             _glyphs.push_back(g);
 
             // DEBUG: İlk birkaç glyph'i logla
-            static int glyphDebugCount = 0;
+            static thread_local int glyphDebugCount = 0;
             if (glyphDebugCount < 20) {
                 LogDebug("[TextExtract] glyph U+%04X '%c': pageX=%.1f y=%.1f -> bitmapPos=(%.1f,%.1f) fontPx=%.1f",
                     uni, (uni >= 32 && uni < 127) ? (char)uni : '?',
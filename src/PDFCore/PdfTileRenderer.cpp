@@ -0,0 +1,201 @@
+// =====================================================
+// PdfTileRenderer.cpp - Band-parallel rendering of one page
+// =====================================================
+
+#include "pch.h"
+#include "PdfTileRenderer.h"
+#include "PdfDisplayList.h"
+#include "PdfDocument.h"
+#include "PdfPainter.h"
+#include "PdfDebug.h"
+#include "PdfTrace.h"
+
+#include <algorithm>
+
+namespace pdf
+{
+    // =====================================================
+    // Render pool
+    // =====================================================
+    static constexpr int MAX_POOL_WORKERS = 64;
+
+    PdfRenderPool::~PdfRenderPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto& t : _workers)
+            t.join();
+    }
+
+    void PdfRenderPool::work(Job& job, std::unique_lock<std::mutex>& lock)
+    {
+        while (job.next < job.count)
+        {
+            const int index = job.next++;
+            lock.unlock();
+            (*job.task)(index);
+            lock.lock();
+            if (++job.done == job.count)
+                _finished.notify_all();
+        }
+    }
+
+    void PdfRenderPool::workerLoop()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        for (;;)
+        {
+            // Oldest job that still has unclaimed indices and room for a helper
+            std::shared_ptr<Job> job;
+            for (const auto& j : _jobs)
+            {
+                if (j->next < j->count && j->helpers < j->maxHelpers)
+                {
+                    job = j;
+                    break;
+                }
+            }
+
+            if (!job)
+            {
+                if (_stop) return;
+                _wake.wait(lock);
+                continue;
+            }
+
+            job->helpers++;
+            work(*job, lock);
+            job->helpers--;
+        }
+    }
+
+    void PdfRenderPool::run(int count, int threads, const std::function<void(int)>& task)
+    {
+        if (count <= 0) return;
+
+        if (threads <= 1 || count == 1)
+        {
+            for (int i = 0; i < count; i++)
+                task(i);
+            return;
+        }
+
+        auto job = std::make_shared<Job>();
+        job->task = &task;
+        job->count = count;
+        job->maxHelpers = std::min(threads, count) - 1;
+
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        const int wanted = std::min(job->maxHelpers, MAX_POOL_WORKERS);
+        while ((int)_workers.size() < wanted)
+            _workers.emplace_back([this]() { workerLoop(); });
+
+        _jobs.push_back(job);
+        _wake.notify_all();
+
+        work(*job, lock);
+        _finished.wait(lock, [&]() { return job->done == job->count; });
+
+        _jobs.erase(std::find(_jobs.begin(), _jobs.end(), job));
+    }
+
+    // =====================================================
+    // Banded page render
+    // =====================================================
+
+    // Bands below this height cost more in per-band replay than they save
+    static constexpr int MIN_BAND_ROWS = 64;
+
+    // More bands than threads, so a band full of text or images does
+    // not leave the others idle
+    static constexpr int BANDS_PER_THREAD = 4;
+
+    // Commands are culled by their page-space extent plus this many
+    // device pixels (anti-aliased edges, hairlines widened to 0.25 px)
+    static constexpr double BAND_CULL_MARGIN_PX = 4.0;
+
+    bool renderPageBanded(
+        PdfDocument& doc,
+        int pageIndex,
+        int wPx, int hPx,
+        double scale,
+        int ssaa,
+        int threads,
+        uint8_t* outBgra,
+        bool antiAlias)
+    {
+        if (threads <= 1 || wPx <= 0 || hPx <= 0 || !outBgra || !(scale > 0))
+            return false;
+
+        // A page known not to replay would interpret into the bottom band
+        // only to be thrown away and rendered whole again
+        if (!doc.isPageReplayable(pageIndex))
+            return false;
+
+        const int split = threads * BANDS_PER_THREAD;
+        const int bandRows = std::max(MIN_BAND_ROWS, (hPx + split - 1) / split);
+        const int bands = (hPx + bandRows - 1) / bandRows;
+        if (bands < 2)
+            return false;
+
+        const size_t rowBytes = (size_t)wPx * 4;
+        auto bandTop = [&](int i) { return i * bandRows; };
+        auto bandHeight = [&](int i) { return std::min(bandRows, hPx - i * bandRows); };
+
+        // Output row = hPx - y * scale: page y range of rows [top, top + rows)
+        const double margin = BAND_CULL_MARGIN_PX / scale;
+        auto bandMinY = [&](int i) { return (double)(hPx - bandTop(i) - bandHeight(i)) / scale - margin; };
+        auto bandMaxY = [&](int i) { return (double)(hPx - bandTop(i)) / scale + margin; };
+
+        int replayBands = bands;
+        auto list = doc.findDisplayList(pageIndex);
+        if (!list)
+        {
+            // First render of the page: interpret it into the bottom band
+            // while recording, then replay the list for the other bands
+            const int last = bands - 1;
+            const int rows = bandHeight(last);
+
+            PdfPainter painter(wPx, rows, scale, scale, ssaa);
+            painter.setBandOrigin(bandTop(last), hPx);
+            painter.setAntiAlias(antiAlias);
+            painter.clear(0xFFFFFFFF);
+
+            list = doc.recordPage(pageIndex, painter, bandMinY(last), bandMaxY(last));
+            if (!list || !list->replayable())
+            {
+                LogDebug("renderPageBanded: page %d not replayable, rendering whole", pageIndex);
+                return false;
+            }
+
+            painter.getDownsampledBufferDirect(outBgra + bandTop(last) * rowBytes, (int)(rows * rowBytes));
+            replayBands = last;
+        }
+
+        LogDebug("renderPageBanded: page %d, %dx%d, %d bands of %d rows, %d threads",
+            pageIndex, wPx, hPx, bands, bandRows, threads);
+
+        PdfRenderPool::instance().run(replayBands, threads, [&](int i)
+            {
+                const int top = bandTop(i);
+                const int rows = bandHeight(i);
+                PDF_TRACE_SCOPE(Page, "band", "page %d, rows %d..%d", pageIndex, top, top + rows);
+
+                PdfPainter painter(wPx, rows, scale, scale, ssaa);
+                painter.setBandOrigin(top, hPx);
+                painter.setAntiAlias(antiAlias);
+                painter.clear(0xFFFFFFFF);
+
+                list->replay(painter, bandMinY(i), bandMaxY(i));
+
+                painter.getDownsampledBufferDirect(outBgra + top * rowBytes, (int)(rows * rowBytes));
+            });
+
+        return true;
+    }
+
+} // namespace pdf
@@ -0,0 +1,86 @@
+#pragma once
+// =====================================================
+// PdfTileRenderer.h - Band-parallel rendering of one page
+// =====================================================
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pdf
+{
+    class PdfDocument;
+
+    // =====================================================
+    // PdfRenderPool
+    // Worker threads shared by every banded render. A job is a range of
+    // task indices; the submitting thread works on its own job and idle
+    // workers take the next unclaimed index of any queued job, so a
+    // slow band never leaves the other threads waiting on a fixed split.
+    // =====================================================
+    class PdfRenderPool
+    {
+    public:
+        static PdfRenderPool& instance()
+        {
+            static PdfRenderPool inst;
+            return inst;
+        }
+
+        // Runs task(0..count-1) on the caller plus up to threads-1 workers;
+        // returns when every index has finished
+        void run(int count, int threads, const std::function<void(int)>& task);
+
+        ~PdfRenderPool();
+
+    private:
+        PdfRenderPool() = default;
+
+        struct Job
+        {
+            const std::function<void(int)>* task = nullptr;
+            int count = 0;
+            int next = 0;       // next unclaimed index
+            int done = 0;       // finished indices
+            int helpers = 0;    // workers currently on this job
+            int maxHelpers = 0;
+        };
+
+        // Claims and runs indices of job until none are left (lock held on entry/exit)
+        void work(Job& job, std::unique_lock<std::mutex>& lock);
+        void workerLoop();
+
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::condition_variable _finished;
+        std::deque<std::shared_ptr<Job>> _jobs;
+        std::vector<std::thread> _workers;
+        bool _stop = false;
+    };
+
+    // =====================================================
+    // Banded page render
+    // Splits the page into full-width bands, replays the page's display
+    // list into one band PdfPainter each (commands outside the band are
+    // skipped) and downsamples every band straight into its rows of
+    // outBgra (wPx * hPx * 4). A page without a list is interpreted once
+    // into the bottom band while recording.
+    // Returns false when the page is too small to split or drew something
+    // tied to the painter size (soft masks); render it whole then.
+    // =====================================================
+    bool renderPageBanded(
+        PdfDocument& doc,
+        int pageIndex,
+        int wPx, int hPx,
+        double scale,
+        int ssaa,
+        int threads,
+        uint8_t* outBgra,
+        bool antiAlias = true);
+
+} // namespace pdf
@@ -0,0 +1,357 @@
+// =====================================================
+// PdfTrace.cpp - Per-thread trace rings, Chrome JSON export
+// =====================================================
+
+#include "pch.h"
+#include "PdfTrace.h"
+
+#include <cstdio>
+#include <cstring>
+
+#if PDF_TRACE_ENABLED
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <memory>
+#include <mutex>
+#include <vector>
+#endif
+
+namespace pdf
+{
+    namespace trace
+    {
+        uint32_t categoryFromName(const char* name)
+        {
+            static const struct { const char* name; uint32_t bit; } names[] = {
+                { "page", Page }, { "parse", Parse }, { "fill", Fill },
+                { "stroke", Stroke }, { "text", Text }, { "image", Image },
+                { "shading", Shading }, { "filter", Filter }, { "all", All },
+            };
+            for (const auto& n : names)
+                if (name && std::strcmp(name, n.name) == 0)
+                    return n.bit;
+            return 0;
+        }
+
+#if PDF_TRACE_ENABLED
+        std::atomic<uint32_t> g_categories{ 0 };
+
+        // =====================================================
+        // Ring buffers
+        // Each recording thread owns one buffer and is its only writer:
+        // an event is filled in, then published by bumping head
+        // (release). When full, the oldest events are overwritten.
+        // clear() never touches head or the events; it moves tail up
+        // to head, and the export skips everything below tail.
+        // The export copies events with plain reads, so it must not
+        // overlap recording (see writeChromeTrace in PdfTrace.h).
+        // Buffers of exited threads go back to a free list and are
+        // handed to the next new thread, so a pool that restarts its
+        // workers does not keep allocating.
+        // =====================================================
+        static constexpr size_t RING_EVENTS = 1u << 14;    // per thread, power of two
+        static constexpr size_t ARG_CHARS = 96;
+
+        struct Event
+        {
+            uint64_t ts;        // ns since trace start
+            uint64_t dur;       // ns, complete events only
+            const char* name;   // string literal at the trace site
+            uint32_t category;
+            uint32_t tid;
+            char phase;         // 'X' complete, 'i' instant
+            char args[ARG_CHARS];
+        };
+
+        struct ThreadBuffer
+        {
+            std::atomic<uint64_t> head{ 0 };   // written by the owner only
+            std::atomic<uint64_t> tail{ 0 };   // first event after the last clear()
+            std::unique_ptr<Event[]> events{ new Event[RING_EVENTS] };
+        };
+
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+            std::vector<ThreadBuffer*> freeBuffers;
+            uint32_t nextTid = 1;
+        };
+
+        // Never destroyed: worker threads may still exit after static
+        // destructors have run
+        static Registry& registry()
+        {
+            static Registry* r = new Registry();
+            return *r;
+        }
+
+        struct ThreadSlot
+        {
+            ThreadBuffer* buffer = nullptr;
+            uint32_t tid = 0;
+
+            ThreadBuffer* get()
+            {
+                if (buffer)
+                    return buffer;
+                Registry& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                tid = r.nextTid++;
+                if (!r.freeBuffers.empty())
+                {
+                    buffer = r.freeBuffers.back();
+                    r.freeBuffers.pop_back();
+                }
+                else
+                {
+                    r.buffers.push_back(std::make_unique<ThreadBuffer>());
+                    buffer = r.buffers.back().get();
+                }
+                return buffer;
+            }
+
+            ~ThreadSlot()
+            {
+                if (!buffer)
+                    return;
+                Registry& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                r.freeBuffers.push_back(buffer);
+            }
+        };
+
+        static thread_local ThreadSlot t_slot;
+
+        static const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+        uint64_t nowNs()
+        {
+            return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - g_epoch).count();
+        }
+
+        static void record(char phase, uint32_t category, const char* name,
+            uint64_t ts, uint64_t dur, const char* args)
+        {
+            ThreadBuffer* b = t_slot.get();
+            const uint64_t h = b->head.load(std::memory_order_relaxed);
+            Event& e = b->events[h & (RING_EVENTS - 1)];
+            e.ts = ts;
+            e.dur = dur;
+            e.name = name;
+            e.category = category;
+            e.tid = t_slot.tid;
+            e.phase = phase;
+            std::strncpy(e.args, args ? args : "", ARG_CHARS - 1);
+            e.args[ARG_CHARS - 1] = 0;
+            b->head.store(h + 1, std::memory_order_release);
+        }
+
+        void instant(uint32_t category, const char* name, const char* fmt, ...)
+        {
+            char args[ARG_CHARS];
+            va_list ap;
+            va_start(ap, fmt);
+            std::vsnprintf(args, sizeof(args), fmt, ap);
+            va_end(ap);
+            record('i', category, name, nowNs(), 0, args);
+        }
+
+        void complete(uint32_t category, const char* name, uint64_t startNs, const char* args)
+        {
+            const uint64_t now = nowNs();
+            record('X', category, name, startNs, now > startNs ? now - startNs : 0, args);
+        }
+
+        Scope::Scope(uint32_t category, const char* name)
+            : _name(name), _category(category)
+        {
+            _args[0] = 0;
+            if (enabled(category))
+                _start = nowNs() | 1;  // never 0 while active
+        }
+
+        Scope::Scope(uint32_t category, const char* name, const char* fmt, ...)
+            : _name(name), _category(category)
+        {
+            _args[0] = 0;
+            if (!enabled(category))
+                return;
+            va_list ap;
+            va_start(ap, fmt);
+            std::vsnprintf(_args, sizeof(_args), fmt, ap);
+            va_end(ap);
+            _start = nowNs() | 1;
+        }
+
+        Scope::~Scope()
+        {
+            if (_start)
+                complete(_category, _name, _start, _args);
+        }
+
+        void setCategories(uint32_t mask)
+        {
+            g_categories.store(mask, std::memory_order_relaxed);
+        }
+
+        uint32_t categories()
+        {
+            return g_categories.load(std::memory_order_relaxed);
+        }
+
+        bool compiledIn()
+        {
+            return true;
+        }
+
+        static const char* categoryName(uint32_t category)
+        {
+            switch (category)
+            {
+            case Page: return "page";
+            case Parse: return "parse";
+            case Fill: return "fill";
+            case Stroke: return "stroke";
+            case Text: return "text";
+            case Image: return "image";
+            case Shading: return "shading";
+            case Filter: return "filter";
+            default: return "other";
+            }
+        }
+
+        // Length of the well-formed UTF-8 sequence at s, 0 if there is none
+        // (stray continuation byte, overlong form, surrogate, cut short)
+        static int utf8SequenceLength(const unsigned char* s)
+        {
+            const unsigned char c = s[0];
+            int len;
+            uint32_t cp;
+            if (c >= 0xC2 && c <= 0xDF) { len = 2; cp = c & 0x1F; }
+            else if (c >= 0xE0 && c <= 0xEF) { len = 3; cp = c & 0x0F; }
+            else if (c >= 0xF0 && c <= 0xF4) { len = 4; cp = c & 0x07; }
+            else return 0;
+
+            for (int i = 1; i < len; i++)
+            {
+                if ((s[i] & 0xC0) != 0x80)  // also stops at the terminator
+                    return 0;
+                cp = (cp << 6) | (s[i] & 0x3F);
+            }
+            if ((len == 3 && (cp < 0x800 || (cp >= 0xD800 && cp <= 0xDFFF))) ||
+                (len == 4 && (cp < 0x10000 || cp > 0x10FFFF)))
+                return 0;
+            return len;
+        }
+
+        // Args come from PDF names and font names, in no particular
+        // encoding: valid UTF-8 passes through, any other byte >= 0x80
+        // becomes U+FFFD so the file stays loadable in Chrome / Perfetto
+        static void writeJsonString(FILE* f, const char* str)
+        {
+            const unsigned char* s = (const unsigned char*)str;
+            std::fputc('"', f);
+            while (*s)
+            {
+                const unsigned char c = *s;
+                if (c == '"' || c == '\\')
+                    std::fprintf(f, "\\%c", c);
+                else if (c < 0x20)
+                    std::fprintf(f, "\\u%04x", c);
+                else if (c >= 0x80)
+                {
+                    const int len = utf8SequenceLength(s);
+                    if (len == 0)
+                        std::fputs("\\ufffd", f);
+                    else
+                    {
+                        std::fwrite(s, 1, (size_t)len, f);
+                        s += len;
+                        continue;
+                    }
+                }
+                else
+                    std::fputc(c, f);
+                s++;
+            }
+            std::fputc('"', f);
+        }
+
+        bool writeChromeTrace(const char* path)
+        {
+            FILE* f = std::fopen(path, "wb");
+            if (!f)
+                return false;
+
+            // Oldest first within each buffer; viewers sort by ts anyway
+            std::vector<Event> events;
+            {
+                Registry& r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                for (const auto& b : r.buffers)
+                {
+                    const uint64_t head = b->head.load(std::memory_order_acquire);
+                    const uint64_t tail = std::min(b->tail.load(std::memory_order_relaxed), head);
+                    const uint64_t count = std::min<uint64_t>(head - tail, RING_EVENTS);
+                    for (uint64_t i = head - count; i < head; i++)
+                        events.push_back(b->events[i & (RING_EVENTS - 1)]);
+                }
+            }
+
+            std::fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+            bool first = true;
+            for (const Event& e : events)
+            {
+                std::fprintf(f, "%s\n{\"name\":", first ? "" : ",");
+                first = false;
+                writeJsonString(f, e.name ? e.name : "");
+                std::fprintf(f, ",\"cat\":\"%s\",\"ph\":\"%c\",\"pid\":1,\"tid\":%u,\"ts\":%.3f",
+                    categoryName(e.category), e.phase, e.tid, e.ts / 1000.0);
+                if (e.phase == 'X')
+                    std::fprintf(f, ",\"dur\":%.3f", e.dur / 1000.0);
+                else
+                    std::fprintf(f, ",\"s\":\"t\"");
+                if (e.args[0])
+                {
+                    std::fprintf(f, ",\"args\":{\"detail\":");
+                    writeJsonString(f, e.args);
+                    std::fputc('}', f);
+                }
+                std::fputc('}', f);
+            }
+            std::fprintf(f, "\n]}\n");
+            return std::fclose(f) == 0;
+        }
+
+        void clear()
+        {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            for (const auto& b : r.buffers)
+                b->tail.store(b->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+        }
+
+#else
+        // =====================================================
+        // Built without tracing: nothing is recorded, the export
+        // still writes a valid (empty) trace
+        // =====================================================
+        void setCategories(uint32_t) {}
+        uint32_t categories() { return 0; }
+        bool compiledIn() { return false; }
+        void clear() {}
+
+        bool writeChromeTrace(const char* path)
+        {
+            FILE* f = std::fopen(path, "wb");
+            if (!f)
+                return false;
+            std::fprintf(f, "{\"traceEvents\":[]}\n");
+            return std::fclose(f) == 0;
+        }
+#endif
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+// =====================================================
+// PdfTrace.h - Render tracing (Chrome trace JSON)
+// =====================================================
+//
+// Compiled in only with PDF_TRACE_ENABLED=1 (CMake: -DPDFCORE_TRACE=ON).
+// Without it PDF_TRACE / PDF_TRACE_SCOPE expand to nothing and their
+// arguments are never evaluated, so trace sites cost nothing in
+// release builds.
+//
+// With it, events of the categories switched on by setCategories()
+// go into a fixed-size ring buffer owned by the recording thread (no
+// locks, no I/O while rendering). writeChromeTrace() dumps every
+// buffer as JSON for chrome://tracing or Perfetto.
+//
+//     PDF_TRACE_SCOPE(Fill, "fillPath", "%zu points", n);   // duration
+//     PDF_TRACE(Image, "decode", "%dx%d bpc=%d", w, h, bpc); // instant
+
+#include <cstdint>
+
+#ifndef PDF_TRACE_ENABLED
+#define PDF_TRACE_ENABLED 0
+#endif
+
+#if PDF_TRACE_ENABLED
+#include <atomic>
+#endif
+
+namespace pdf
+{
+    namespace trace
+    {
+        enum Category : uint32_t
+        {
+            Page    = 1u << 0,  // page render / display list replay
+            Parse   = 1u << 1,  // content stream operators
+            Fill    = 1u << 2,  // path fills, scanline rasterizer
+            Stroke  = 1u << 3,
+            Text    = 1u << 4,  // glyph drawing, font lookups
+            Image   = 1u << 5,  // XObject images, decoding
+            Shading = 1u << 6,  // sh operator, gradients
+            Filter  = 1u << 7,  // stream filters (JPX, ...)
+            All     = 0xFFFFFFFFu
+        };
+
+        // Category bit for a name ("fill", "text", "all", ...); 0 if unknown
+        uint32_t categoryFromName(const char* name);
+
+        // Categories recorded from now on (0 = off, the default)
+        void setCategories(uint32_t mask);
+        uint32_t categories();
+
+        // False when built without PDF_TRACE_ENABLED (nothing is recorded)
+        bool compiledIn();
+
+        // Writes the buffered events of all threads. The rings are read
+        // without any handshake with their owners, so this may only run
+        // while no thread is recording: after every render call has
+        // returned and band / pool workers are idle (setCategories(0)
+        // alone is not enough, scopes already open still complete).
+        // False if the file cannot be written.
+        bool writeChromeTrace(const char* path);
+
+        // Drops all buffered events. Safe while rendering (each ring's
+        // owner stays its only writer); events recorded meanwhile may or
+        // may not survive.
+        void clear();
+
+#if PDF_TRACE_ENABLED
+        extern std::atomic<uint32_t> g_categories;
+
+        inline bool enabled(uint32_t category)
+        {
+            return (g_categories.load(std::memory_order_relaxed) & category) != 0;
+        }
+
+        uint64_t nowNs();
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PDF_TRACE_PRINTF(f, a) __attribute__((format(printf, f, a)))
+#else
+#define PDF_TRACE_PRINTF(f, a)
+#endif
+
+        void instant(uint32_t category, const char* name, const char* fmt, ...) PDF_TRACE_PRINTF(3, 4);
+
+        // Complete ("X") event from startNs to now
+        void complete(uint32_t category, const char* name, uint64_t startNs, const char* args);
+
+        // Duration event for the enclosing block
+        class Scope
+        {
+        public:
+            Scope(uint32_t category, const char* name);
+            Scope(uint32_t category, const char* name, const char* fmt, ...) PDF_TRACE_PRINTF(4, 5);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            const char* _name;
+            uint32_t _category;
+            uint64_t _start = 0;
+            char _args[96];
+        };
+#endif
+    }
+}
+
+#if PDF_TRACE_ENABLED
+#define PDF_TRACE_CONCAT2(a, b) a##b
+#define PDF_TRACE_CONCAT(a, b) PDF_TRACE_CONCAT2(a, b)
+
+// PDF_TRACE(Category, "name", "printf format", args...)
+#define PDF_TRACE(cat, name, ...) \
+    do { \
+        if (::pdf::trace::enabled(::pdf::trace::cat)) \
+            ::pdf::trace::instant(::pdf::trace::cat, name, __VA_ARGS__); \
+    } while (0)
+
+// PDF_TRACE_SCOPE(Category, "name" [, "printf format", args...])
+#define PDF_TRACE_SCOPE(cat, ...) \
+    ::pdf::trace::Scope PDF_TRACE_CONCAT(pdfTraceScope_, __LINE__)(::pdf::trace::cat, __VA_ARGS__)
+#else
+#define PDF_TRACE(cat, name, ...) ((void)0)
+#define PDF_TRACE_SCOPE(cat, ...) ((void)0)
+#endif
@@ -2,6 +2,8 @@
 #ifndef NOMINMAX
 #define NOMINMAX
 #endif
+#ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN             // Nadiren kullanılan verileri Windows üst bilgilerinden dışla
 // Windows Üst Bilgi Dosyaları
 #include <windows.h>
+#endif
@@ -0,0 +1,677 @@
+// =====================================================
+// manaspdf-render - Headless command-line rasterizer
+//
+// Renders a page range through the CPU pipeline
+// (PdfDocument + PdfPainter) and writes PPM or PNG files.
+// Also prints open/render timings, so it doubles as the
+// throughput benchmark for server deployments. -x runs only
+// the content stream interpreter (text extraction pass) to
+// measure tokenizing and operator dispatch in isolation.
+// -Z renders the range again at a second zoom, which replays
+// the page display lists recorded by the first pass.
+// -j renders pages on several threads sharing one document;
+// -S stress-renders the range concurrently on a freshly opened
+// copy and checks every page against a single-threaded render.
+// -b splits each page into bands rasterized on several threads
+// (single-page latency for large drawings).
+// -F times the scanline filler on a synthetic edge-dense path;
+// it needs no input file.
+// -T records the run as a Chrome trace (builds configured with
+// -DPDFCORE_TRACE=ON; others write an empty trace).
+// =====================================================
+
+#include "PdfDocument.h"
+#include "PdfPainter.h"
+#include "PdfPlatform.h"
+#include "PdfTileRenderer.h"
+#include "PdfTextExtractor.h"
+#include "PdfTrace.h"
+#include "zlib.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        std::string input;
+        std::string outPrefix;
+        std::string format = "png";
+        int firstPage = 1;
+        int lastPage = 0;       // 0 = last page of the document
+        double zoom = 1.0;      // 1.0 = 96 DPI, same as Pdf_RenderPageToRgba
+        int ssaa = 1;
+        bool writeFiles = true;
+        bool quiet = false;
+        bool mapped = false;    // mmap the file instead of reading it
+        int interpretRuns = 0;  // -x: interpret content N times, no raster
+        double rezoom = 0;      // -Z: second pass at this zoom (0 = none)
+        bool displayLists = true;
+        bool imageCache = true;
+        int threads = 1;        // -j: worker threads sharing the document
+        int stressRounds = 0;   // -S: concurrent re-renders checked against pass 1
+        int bandThreads = 1;    // -b: threads per page (banded render)
+        int fillEdges = 0;      // -F: fill benchmark path size (0 = off)
+        bool antiAlias = true;  // -A: aliased fills and strokes
+        std::string tracePath;  // -T: Chrome trace output
+        uint32_t traceCategories = pdf::trace::All;  // -C
+    };
+
+    void printUsage()
+    {
+        std::fprintf(stderr,
+            "usage: manaspdf-render [options] input.pdf\n"
+            "  -f N        first page, 1-based (default 1)\n"
+            "  -l N        last page (default: last page of the document)\n"
+            "  -r DPI      output resolution (default 96)\n"
+            "  -z ZOOM     zoom factor, 1.0 = 96 DPI (alternative to -r)\n"
+            "  -s N        supersampling factor 1/2/4 (default 1)\n"
+            "  -t FORMAT   ppm or png (default png)\n"
+            "  -o PREFIX   output prefix (default: input name without .pdf)\n"
+            "  -n          render only, do not write files (benchmark)\n"
+            "  -m          memory-map the input instead of reading it\n"
+            "  -x N        interpret each page's content N times without\n"
+            "              rasterizing (content parser benchmark)\n"
+            "  -Z ZOOM     render the range again at ZOOM, replaying the\n"
+            "              display lists recorded by the first pass\n"
+            "  -D          no display lists: -Z re-interprets every page\n"
+            "  -I          no decoded-image cache: every Do decodes again\n"
+            "  -j N        render pages on N threads (one document, default 1)\n"
+            "  -S N        stress: render the range N more times on the -j threads\n"
+            "              from a freshly opened document, compare every page\n"
+            "              with the single-threaded first pass\n"
+            "  -b N        render each page as horizontal bands on N threads\n"
+            "  -F EDGES    fill benchmark: fill and stroke a star path with\n"
+            "              EDGES edges on a letter page at -z/-s (no input)\n"
+            "  -A          aliased fills and strokes (no edge coverage)\n"
+            "  -T FILE     write a Chrome trace (chrome://tracing, Perfetto) of the run\n"
+            "  -C LIST     trace categories, comma-separated: page, parse, fill,\n"
+            "              stroke, text, image, shading, filter (default all)\n"
+            "  -q          only print the summary line\n");
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string a = argv[i];
+            auto next = [&](const char*& v) -> bool {
+                if (i + 1 >= argc) return false;
+                v = argv[++i];
+                return true;
+            };
+            const char* v = nullptr;
+
+            if (a == "-f" && next(v)) opt.firstPage = std::atoi(v);
+            else if (a == "-l" && next(v)) opt.lastPage = std::atoi(v);
+            else if (a == "-r" && next(v)) opt.zoom = std::atof(v) / 96.0;
+            else if (a == "-z" && next(v)) opt.zoom = std::atof(v);
+            else if (a == "-s" && next(v)) opt.ssaa = std::atoi(v);
+            else if (a == "-t" && next(v)) opt.format = v;
+            else if (a == "-o" && next(v)) opt.outPrefix = v;
+            else if (a == "-n") opt.writeFiles = false;
+            else if (a == "-q") opt.quiet = true;
+            else if (a == "-m") opt.mapped = true;
+            else if (a == "-x" && next(v)) opt.interpretRuns = std::atoi(v);
+            else if (a == "-Z" && next(v)) opt.rezoom = std::atof(v);
+            else if (a == "-D") opt.displayLists = false;
+            else if (a == "-I") opt.imageCache = false;
+            else if (a == "-j" && next(v)) opt.threads = std::atoi(v);
+            else if (a == "-S" && next(v)) opt.stressRounds = std::atoi(v);
+            else if (a == "-b" && next(v)) opt.bandThreads = std::atoi(v);
+            else if (a == "-F" && next(v)) opt.fillEdges = std::atoi(v);
+            else if (a == "-A") opt.antiAlias = false;
+            else if (a == "-T" && next(v)) opt.tracePath = v;
+            else if (a == "-C" && next(v))
+            {
+                opt.traceCategories = 0;
+                std::string list = v;
+                size_t pos = 0;
+                while (pos <= list.size())
+                {
+                    size_t comma = list.find(',', pos);
+                    if (comma == std::string::npos) comma = list.size();
+                    const uint32_t bit = pdf::trace::categoryFromName(list.substr(pos, comma - pos).c_str());
+                    if (!bit) return false;
+                    opt.traceCategories |= bit;
+                    pos = comma + 1;
+                }
+            }
+            else if (!a.empty() && a[0] != '-' && opt.input.empty()) opt.input = a;
+            else return false;
+        }
+
+        if (opt.fillEdges < 0) return false;
+        if (opt.input.empty() && opt.fillEdges == 0) return false;
+        if (opt.format != "ppm" && opt.format != "png") return false;
+        if (!(opt.zoom > 0)) return false;
+        if (opt.ssaa != 1 && opt.ssaa != 2 && opt.ssaa != 4) return false;
+        if (opt.interpretRuns < 0) return false;
+        if (opt.rezoom < 0) return false;
+        if (opt.threads < 1 || opt.stressRounds < 0) return false;
+        if (opt.bandThreads < 1) return false;
+
+        if (opt.outPrefix.empty() && !opt.input.empty())
+        {
+            opt.outPrefix = opt.input;
+            size_t dot = opt.outPrefix.rfind('.');
+            size_t slash = opt.outPrefix.find_last_of("/\\");
+            if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+                opt.outPrefix.resize(dot);
+        }
+        return true;
+    }
+
+    double msSince(std::chrono::steady_clock::time_point t0)
+    {
+        return std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - t0).count();
+    }
+
+    // BGRA (painter output) -> packed RGB
+    void bgraToRgb(const std::vector<uint8_t>& bgra, int w, int h, std::vector<uint8_t>& rgb)
+    {
+        rgb.resize((size_t)w * h * 3);
+        const uint8_t* s = bgra.data();
+        uint8_t* d = rgb.data();
+        for (size_t i = 0, n = (size_t)w * h; i < n; i++, s += 4, d += 3)
+        {
+            d[0] = s[2];
+            d[1] = s[1];
+            d[2] = s[0];
+        }
+    }
+
+    bool writePpm(const std::string& path, const std::vector<uint8_t>& rgb, int w, int h)
+    {
+        FILE* f = std::fopen(path.c_str(), "wb");
+        if (!f) return false;
+        std::fprintf(f, "P6\n%d %d\n255\n", w, h);
+        bool ok = std::fwrite(rgb.data(), 1, rgb.size(), f) == rgb.size();
+        return (std::fclose(f) == 0) && ok;
+    }
+
+    void putBE32(std::vector<uint8_t>& v, uint32_t x)
+    {
+        v.push_back((uint8_t)(x >> 24));
+        v.push_back((uint8_t)(x >> 16));
+        v.push_back((uint8_t)(x >> 8));
+        v.push_back((uint8_t)x);
+    }
+
+    void putChunk(std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& data)
+    {
+        putBE32(png, (uint32_t)data.size());
+        size_t typePos = png.size();
+        png.insert(png.end(), type, type + 4);
+        png.insert(png.end(), data.begin(), data.end());
+        uLong crc = crc32(0L, Z_NULL, 0);
+        crc = crc32(crc, png.data() + typePos, (uInt)(4 + data.size()));
+        putBE32(png, (uint32_t)crc);
+    }
+
+    // Minimal PNG encoder (8-bit RGB, filter 0) on top of the bundled zlib
+    bool writePng(const std::string& path, const std::vector<uint8_t>& rgb, int w, int h)
+    {
+        const size_t stride = (size_t)w * 3;
+        std::vector<uint8_t> raw;
+        raw.reserve((stride + 1) * h);
+        for (int y = 0; y < h; y++)
+        {
+            raw.push_back(0);
+            raw.insert(raw.end(), rgb.begin() + y * stride, rgb.begin() + (y + 1) * stride);
+        }
+
+        uLongf zlen = compressBound((uLong)raw.size());
+        std::vector<uint8_t> idat(zlen);
+        if (compress2(idat.data(), &zlen, raw.data(), (uLong)raw.size(), 6) != Z_OK)
+            return false;
+        idat.resize(zlen);
+
+        std::vector<uint8_t> ihdr;
+        putBE32(ihdr, (uint32_t)w);
+        putBE32(ihdr, (uint32_t)h);
+        ihdr.push_back(8);  // bit depth
+        ihdr.push_back(2);  // color type: RGB
+        ihdr.push_back(0);  // compression
+        ihdr.push_back(0);  // filter
+        ihdr.push_back(0);  // interlace
+
+        static const uint8_t sig[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        std::vector<uint8_t> png(sig, sig + 8);
+        putChunk(png, "IHDR", ihdr);
+        putChunk(png, "IDAT", idat);
+        putChunk(png, "IEND", std::vector<uint8_t>());
+
+        FILE* f = std::fopen(path.c_str(), "wb");
+        if (!f) return false;
+        bool ok = std::fwrite(png.data(), 1, png.size(), f) == png.size();
+        return (std::fclose(f) == 0) && ok;
+    }
+
+    // ---------------------------------------------
+    // Fill benchmark: a star whose points alternate between two
+    // radii, so every scanline crosses a few of many short edges -
+    // the shape of map outlines and dense CAD hatching. Times the
+    // non-zero and even-odd fills and a hairline stroke of the
+    // outline, then the fill rate: twenty page-sized rectangles,
+    // opaque and at 50% alpha (best of three runs each).
+    // ---------------------------------------------
+    int runFillBenchmark(const Options& opt)
+    {
+        const double pageW = 612.0, pageH = 792.0;
+        const double scale = 96.0 / 72.0 * opt.zoom;
+        const int wPx = (int)std::llround(pageW * scale);
+        const int hPx = (int)std::llround(pageH * scale);
+
+        const int n = std::max(3, opt.fillEdges);
+        const double cx = pageW / 2, cy = pageH / 2;
+        const double outer = 0.48 * pageW, inner = 0.36 * pageW;
+        const double step = 2.0 * 3.14159265358979323846 / n;
+
+        std::vector<pdf::PdfPathSegment> star;
+        star.reserve(n + 1);
+        for (int i = 0; i < n; i++)
+        {
+            double r = (i & 1) ? inner : outer;
+            star.emplace_back(i == 0 ? pdf::PdfPathSegment::MoveTo : pdf::PdfPathSegment::LineTo,
+                cx + r * std::cos(i * step), cy + r * std::sin(i * step));
+        }
+        star.emplace_back();
+
+        const pdf::PdfMatrix identity;
+        auto best = [&](const std::function<void(pdf::PdfPainter&)>& draw)
+        {
+            double bestMs = 1e30;
+            for (int run = 0; run < 3; run++)
+            {
+                pdf::PdfPainter painter(wPx, hPx, scale, scale, opt.ssaa);
+                painter.setAntiAlias(opt.antiAlias);
+                painter.clear(0xFFFFFFFF);
+                auto t0 = std::chrono::steady_clock::now();
+                draw(painter);
+                bestMs = std::min(bestMs, msSince(t0));
+            }
+            return bestMs;
+        };
+
+        double nonZeroMs = best([&](pdf::PdfPainter& p) { p.fillPath(star, 0xFF204080, identity, false); });
+        double evenOddMs = best([&](pdf::PdfPainter& p) { p.fillPath(star, 0xFF204080, identity, true); });
+        double strokeMs = best([&](pdf::PdfPainter& p) { p.strokePath(star, 0xFF000000, 0.25, identity); });
+
+        std::vector<pdf::PdfPathSegment> rect;
+        rect.emplace_back(pdf::PdfPathSegment::MoveTo, 0.0, 0.0);
+        rect.emplace_back(pdf::PdfPathSegment::LineTo, pageW, 0.0);
+        rect.emplace_back(pdf::PdfPathSegment::LineTo, pageW, pageH);
+        rect.emplace_back(pdf::PdfPathSegment::LineTo, 0.0, pageH);
+        rect.emplace_back();
+        const int rectFills = 20;
+        double rectMs = best([&](pdf::PdfPainter& p)
+            {
+                for (int i = 0; i < rectFills; i++) p.fillPath(rect, 0xFF000000u | (i * 0x0A0B0C), identity, false);
+            });
+        double rectAlphaMs = best([&](pdf::PdfPainter& p)
+            {
+                for (int i = 0; i < rectFills; i++) p.fillPath(rect, 0x80000000u | (i * 0x0A0B0C), identity, false);
+            });
+
+        std::printf("fill benchmark: %d edges, %dx%d px (ssaa %d, %s): non-zero %.1f ms, even-odd %.1f ms, stroke %.1f ms\n",
+            n, wPx * opt.ssaa, hPx * opt.ssaa, opt.ssaa, opt.antiAlias ? "anti-aliased" : "aliased", nonZeroMs, evenOddMs, strokeMs);
+        std::printf("fill rate: %d page rects, opaque %.1f ms (%.0f Mpx/s), 50%% alpha %.1f ms (%.0f Mpx/s)\n",
+            rectFills, rectMs, rectFills * (double)wPx * hPx * opt.ssaa * opt.ssaa / (rectMs * 1000.0),
+            rectAlphaMs, rectFills * (double)wPx * hPx * opt.ssaa * opt.ssaa / (rectAlphaMs * 1000.0));
+        return 0;
+    }
+}
+
+static int renderDocument(Options& opt)
+{
+    // ---------------------------------------------
+    // Open
+    // ---------------------------------------------
+    auto tOpen = std::chrono::steady_clock::now();
+
+    auto openDocument = [&](pdf::PdfDocument& target) -> bool
+    {
+        if (opt.mapped)
+        {
+            size_t size = 0;
+            auto mapped = pdf::platform::mapFile(opt.input.c_str(), size);
+            if (!mapped)
+            {
+                std::fprintf(stderr, "manaspdf-render: cannot map %s\n", opt.input.c_str());
+                return false;
+            }
+            return target.loadFromMemory(std::move(mapped), size);
+        }
+
+        std::vector<uint8_t> data;
+        std::ifstream ifs(opt.input, std::ios::binary);
+        if (!ifs)
+        {
+            std::fprintf(stderr, "manaspdf-render: cannot read %s\n", opt.input.c_str());
+            return false;
+        }
+        ifs.seekg(0, std::ios::end);
+        data.resize((size_t)std::max<std::streamoff>(0, ifs.tellg()));
+        ifs.seekg(0, std::ios::beg);
+        ifs.read(reinterpret_cast<char*>(data.data()), (std::streamsize)data.size());
+        return target.loadFromBytes(std::move(data));
+    };
+
+    pdf::PdfDocument doc;
+    if (!openDocument(doc))
+    {
+        std::fprintf(stderr, "manaspdf-render: failed to parse %s\n", opt.input.c_str());
+        return 1;
+    }
+
+    const int pageCount = doc.getPageCountFromPageTree();
+    const double openMs = msSince(tOpen);
+
+    int first = std::max(1, opt.firstPage);
+    int last = (opt.lastPage > 0) ? std::min(opt.lastPage, pageCount) : pageCount;
+    if (first > last)
+    {
+        std::fprintf(stderr, "manaspdf-render: empty page range %d-%d (document has %d pages)\n",
+            opt.firstPage, opt.lastPage, pageCount);
+        return 1;
+    }
+
+    if (!opt.quiet)
+        std::printf("%s: %d pages, opened in %.1f ms\n", opt.input.c_str(), pageCount, openMs);
+
+    // ---------------------------------------------
+    // Interpret only: content parser + text collector painter,
+    // no rasterization. Fonts are loaded by the first run.
+    // ---------------------------------------------
+    if (opt.interpretRuns > 0)
+    {
+        double interpMs = 0;
+        long long glyphs = 0;
+        for (int page = first; page <= last; page++)
+        {
+            for (int run = 0; run < opt.interpretRuns; run++)
+            {
+                pdf::PdfTextExtractor extractor;
+                auto t0 = std::chrono::steady_clock::now();
+                int n = extractor.extractPage(doc, page - 1);
+                double ms = msSince(t0);
+                if (run > 0 || opt.interpretRuns == 1)
+                    interpMs += ms;
+                if (run == 0 && n > 0)
+                    glyphs += n;
+            }
+        }
+
+        const int pages = last - first + 1;
+        const int timedRuns = std::max(1, opt.interpretRuns - 1);
+        std::printf("interpreted %d pages x %d runs in %.1f ms (%.3f ms/page, %lld glyphs, open %.1f ms)\n",
+            pages, timedRuns, interpMs, interpMs / ((double)pages * timedRuns), glyphs, openMs);
+        return 0;
+    }
+
+    // ---------------------------------------------
+    // Render (same setup as the CPU path of RenderImpl)
+    // ---------------------------------------------
+    const double DPI = 96.0;
+    const int MAX_BITMAP_DIM = 16384;
+
+    // Display lists only pay off when pages are rendered again
+    if (opt.rezoom <= 0 || !opt.displayLists)
+        doc.setDisplayListBudget(0);
+    if (!opt.imageCache)
+        doc.setImageCacheBudget(0);
+
+    std::atomic<int> failures{ 0 };
+
+    // Renders one page; returns its time in ms, or -1 on failure.
+    // checksum receives the CRC-32 of the BGRA output.
+    auto renderPage = [&](pdf::PdfDocument& src, int page, double zoom, const char* tag,
+        bool writeFile, uLong& checksum) -> double
+    {
+        const double scale = DPI / 72.0 * zoom;
+        const int pageIndex = page - 1;
+
+        double wPt = 0, hPt = 0;
+        if (!src.getPageSize(pageIndex, wPt, hPt))
+        {
+            std::fprintf(stderr, "page %d: no page size\n", page);
+            return -1;
+        }
+
+        const int wPx = (int)std::llround(wPt * scale);
+        const int hPx = (int)std::llround(hPt * scale);
+        if (wPx <= 0 || hPx <= 0 || wPx > MAX_BITMAP_DIM || hPx > MAX_BITMAP_DIM)
+        {
+            std::fprintf(stderr, "page %d: invalid pixel size %dx%d\n", page, wPx, hPx);
+            return -1;
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+
+        std::vector<uint8_t> bgra;
+        if (opt.bandThreads > 1)
+        {
+            bgra.resize((size_t)wPx * hPx * 4);
+            if (!pdf::renderPageBanded(src, pageIndex, wPx, hPx, scale, opt.ssaa, opt.bandThreads, bgra.data(), opt.antiAlias))
+                bgra.clear();
+        }
+
+        if (bgra.empty())
+        {
+            pdf::PdfPainter painter(wPx, hPx, scale, scale, opt.ssaa);
+            painter.setPageRotation(0, wPt, hPt);
+            painter.setAntiAlias(opt.antiAlias);
+            painter.clear(0xFFFFFFFF);
+            src.renderPageToPainter(pageIndex, painter);
+            bgra = painter.getDownsampledBuffer();
+        }
+
+        const double pageMs = msSince(t0);
+
+        if ((int)bgra.size() < wPx * hPx * 4)
+        {
+            std::fprintf(stderr, "page %d: buffer size mismatch\n", page);
+            return -1;
+        }
+        checksum = crc32(crc32(0L, Z_NULL, 0), bgra.data(), (uInt)((size_t)wPx * hPx * 4));
+
+        if (writeFile)
+        {
+            char suffix[48];
+            std::snprintf(suffix, sizeof(suffix), "-%d%s.%s", page, tag, opt.format.c_str());
+            std::string path = opt.outPrefix + suffix;
+
+            std::vector<uint8_t> rgb;
+            bgraToRgb(bgra, wPx, hPx, rgb);
+            bool ok = (opt.format == "png") ? writePng(path, rgb, wPx, hPx)
+                                             : writePpm(path, rgb, wPx, hPx);
+            if (!ok)
+            {
+                std::fprintf(stderr, "page %d: cannot write %s\n", page, path.c_str());
+                return -1;
+            }
+        }
+
+        if (!opt.quiet)
+            std::printf("page %d%s: %dx%d in %.1f ms\n", page, tag, wPx, hPx, pageMs);
+        return pageMs;
+    };
+
+    // Runs task(i) for i in [0, count) on opt.threads workers
+    auto runParallel = [&](int count, const std::function<void(int)>& task)
+    {
+        std::atomic<int> nextTask{ 0 };
+        auto worker = [&]()
+        {
+            for (int i = nextTask++; i < count; i = nextTask++)
+                task(i);
+        };
+
+        std::vector<std::thread> pool;
+        for (int t = 1; t < opt.threads; t++)
+            pool.emplace_back(worker);
+        worker();
+        for (auto& th : pool)
+            th.join();
+    };
+
+    const int rendered = last - first + 1;
+    std::vector<uLong> checksums(rendered, 0);
+
+    // One pass over the page range at the given zoom; returns total ms
+    // (sum of page times on one thread, wall clock with -j)
+    auto renderPass = [&](double zoom, const char* tag) -> double
+    {
+        if (opt.threads == 1)
+        {
+            double passMs = 0;
+            for (int page = first; page <= last; page++)
+            {
+                double ms = renderPage(doc, page, zoom, tag, opt.writeFiles, checksums[page - first]);
+                if (ms < 0) failures++;
+                else passMs += ms;
+            }
+            return passMs;
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+        runParallel(rendered, [&](int i) {
+            if (renderPage(doc, first + i, zoom, tag, opt.writeFiles, checksums[i]) < 0)
+                failures++;
+        });
+        return msSince(t0);
+    };
+
+    const double renderMs = renderPass(opt.zoom, "");
+    const std::vector<uLong> firstPass = checksums;
+    std::printf("rendered %d pages in %.1f ms (%.2f pages/s, open %.1f ms)\n",
+        rendered, renderMs, renderMs > 0 ? rendered * 1000.0 / renderMs : 0.0, openMs);
+
+    size_t formHits = 0, formMisses = 0, forms = 0, formBytes = 0;
+    doc.getFormCacheStats(formHits, formMisses, forms, formBytes);
+    if (!opt.quiet && formHits + formMisses > 0)
+        std::printf("form cache: %zu hits, %zu misses, %zu forms, %.1f KB\n",
+            formHits, formMisses, forms, formBytes / 1024.0);
+
+    size_t imageHits = 0, imageMisses = 0, images = 0, imageBytes = 0;
+    doc.getImageCacheStats(imageHits, imageMisses, images, imageBytes);
+    if (!opt.quiet && imageHits + imageMisses > 0)
+        std::printf("image cache: %zu hits, %zu misses, %zu images, %.1f MB\n",
+            imageHits, imageMisses, images, imageBytes / (1024.0 * 1024.0));
+
+    size_t mipHits = 0, mipMisses = 0, pyramids = 0, mipBytes = 0;
+    pdf::PdfImagePyramidCache::instance().getStats(mipHits, mipMisses, pyramids, mipBytes);
+    if (!opt.quiet && mipHits + mipMisses > 0)
+        std::printf("pyramid cache: %zu hits, %zu misses, %zu images, %.1f MB\n",
+            mipHits, mipMisses, pyramids, mipBytes / (1024.0 * 1024.0));
+
+    if (opt.rezoom > 0)
+    {
+        const size_t listBytes = doc.displayListBytes();
+        const double rezoomMs = renderPass(opt.rezoom, "-rezoom");
+        std::printf("re-rendered %d pages at zoom %.2f in %.1f ms (%.2f pages/s, display lists %.1f MB)\n",
+            rendered, opt.rezoom, rezoomMs, rezoomMs > 0 ? rendered * 1000.0 / rezoomMs : 0.0,
+            listBytes / (1024.0 * 1024.0));
+    }
+
+    // ---------------------------------------------
+    // Stress: every page rendered stressRounds times, all threads
+    // hitting the same fresh document (lazy object loading, page index,
+    // fonts and caches are built concurrently), output compared with
+    // the first pass. Page order is interleaved so threads collide on
+    // the same pages.
+    // ---------------------------------------------
+    if (opt.stressRounds > 0)
+    {
+        std::vector<uLong> reference = firstPass;
+        if (opt.threads > 1)
+        {
+            // The first pass was already parallel; take the reference serially
+            for (int page = first; page <= last; page++)
+                if (renderPage(doc, page, opt.zoom, "", false, reference[page - first]) < 0)
+                    failures++;
+        }
+
+        pdf::PdfDocument fresh;
+        if (!openDocument(fresh))
+        {
+            std::fprintf(stderr, "manaspdf-render: failed to reopen %s\n", opt.input.c_str());
+            return 1;
+        }
+        if (opt.rezoom <= 0 || !opt.displayLists)
+            fresh.setDisplayListBudget(0);
+        if (!opt.imageCache)
+            fresh.setImageCacheBudget(0);
+
+        const bool quiet = opt.quiet;
+        opt.quiet = true;
+        std::atomic<int> mismatches{ 0 };
+        const int total = rendered * opt.stressRounds;
+
+        auto t0 = std::chrono::steady_clock::now();
+        runParallel(total, [&](int i) {
+            const int pageOffset = (i / opt.threads) % rendered;
+            uLong sum = 0;
+            if (renderPage(fresh, first + pageOffset, opt.zoom, "", false, sum) < 0)
+                failures++;
+            else if (sum != reference[pageOffset])
+            {
+                std::fprintf(stderr, "stress: page %d differs from the single-threaded render\n",
+                    first + pageOffset);
+                mismatches++;
+            }
+        });
+        const double stressMs = msSince(t0);
+        opt.quiet = quiet;
+
+        std::printf("stress: %d renders on %d threads in %.1f ms (%.2f pages/s), %d mismatches\n",
+            total, opt.threads, stressMs, stressMs > 0 ? total * 1000.0 / stressMs : 0.0,
+            mismatches.load());
+        if (mismatches > 0)
+            return 1;
+    }
+
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        printUsage();
+        return 2;
+    }
+
+    if (!opt.tracePath.empty())
+    {
+        if (!pdf::trace::compiledIn())
+            std::fprintf(stderr, "manaspdf-render: tracing not compiled in (configure with -DPDFCORE_TRACE=ON)\n");
+        pdf::trace::setCategories(opt.traceCategories);
+    }
+
+    const int rc = (opt.fillEdges > 0) ? runFillBenchmark(opt) : renderDocument(opt);
+
+    if (!opt.tracePath.empty())
+    {
+        pdf::trace::setCategories(0);
+        if (!pdf::trace::writeChromeTrace(opt.tracePath.c_str()))
+        {
+            std::fprintf(stderr, "manaspdf-render: cannot write %s\n", opt.tracePath.c_str());
+            return 1;
+        }
+    }
+    return rc;
+}